@@ -0,0 +1,467 @@
+/*****************************************************************************\
+ *  sload.c - generate an RPC load against slurmctld
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * sload drives a configurable mix of client RPCs against slurmctld from many
+ * threads at a target aggregate rate and reports the latency percentiles of
+ * each RPC type. It is meant for capacity planning and for comparing
+ * slurmctld builds, e.g. before and after a locking change.
+ *
+ * Build against an installed Slurm with:
+ *
+ *   gcc -o sload sload.c -I$PREFIX/include -L$PREFIX/lib -lslurm -lpthread
+ *
+ * Jobs are submitted held (priority 0) so they never start, and are
+ * cancelled by the "cancel" operation or when the run ends. To exercise
+ * node registration and job completion traffic at scale, point sload at a
+ * controller whose nodes are faked with --enable-multiple-slurmd or a
+ * FrontEnd configuration.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <slurm/slurm.h>
+#include <slurm/slurm_errno.h>
+
+typedef enum {
+	OP_SUBMIT,
+	OP_CANCEL,
+	OP_LOAD_JOBS,
+	OP_LOAD_JOB,
+	OP_LOAD_NODES,
+	OP_LOAD_PARTS,
+	OP_PING,
+	OP_COUNT
+} op_t;
+
+static const char *op_names[OP_COUNT] = {
+	"submit",
+	"cancel",
+	"load_jobs",
+	"load_job",
+	"load_nodes",
+	"load_parts",
+	"ping",
+};
+
+/* default mix roughly follows a busy cluster: mostly squeue/sinfo polling */
+static int op_weight[OP_COUNT] = { 2, 1, 10, 4, 4, 1, 1 };
+
+typedef struct {
+	uint32_t *lat;		/* latencies in usec */
+	int lat_cnt;
+	int lat_size;
+	int errors;
+} op_stats_t;
+
+typedef struct {
+	int id;
+	pthread_t tid;
+	unsigned int seed;
+	uint32_t *jobs;		/* held jobs submitted by this thread */
+	int job_cnt;
+	int job_size;
+	op_stats_t stats[OP_COUNT];
+} worker_t;
+
+static int thread_cnt = 8;
+static int duration = 60;
+static double rate = 0;		/* total RPCs per second, 0 = unlimited */
+static char *partition = NULL;
+static int weight_total = 0;
+static struct timespec end_time;
+
+static uint64_t _usec_diff(struct timespec *a, struct timespec *b)
+{
+	return ((b->tv_sec - a->tv_sec) * 1000000) +
+	       ((b->tv_nsec - a->tv_nsec) / 1000);
+}
+
+static void _add_usec(struct timespec *ts, uint64_t usec)
+{
+	ts->tv_sec += usec / 1000000;
+	ts->tv_nsec += (usec % 1000000) * 1000;
+	if (ts->tv_nsec >= 1000000000) {
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000;
+	}
+}
+
+static void _record(op_stats_t *stats, uint32_t usec, int rc)
+{
+	if (rc) {
+		stats->errors++;
+		return;
+	}
+	if (stats->lat_cnt >= stats->lat_size) {
+		stats->lat_size = stats->lat_size ? (stats->lat_size * 2) : 1024;
+		stats->lat = realloc(stats->lat,
+				     stats->lat_size * sizeof(*stats->lat));
+		if (!stats->lat) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	stats->lat[stats->lat_cnt++] = usec;
+}
+
+static void _add_job(worker_t *w, uint32_t job_id)
+{
+	if (w->job_cnt >= w->job_size) {
+		w->job_size = w->job_size ? (w->job_size * 2) : 64;
+		w->jobs = realloc(w->jobs, w->job_size * sizeof(*w->jobs));
+		if (!w->jobs) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	w->jobs[w->job_cnt++] = job_id;
+}
+
+static int _submit(worker_t *w)
+{
+	job_desc_msg_t desc;
+	submit_response_msg_t *resp = NULL;
+	char *env[] = { "SLURM_LOAD=1", NULL };
+	char name[32];
+	int rc;
+
+	slurm_init_job_desc_msg(&desc);
+	snprintf(name, sizeof(name), "sload_%d", (int) getpid());
+	desc.name = name;
+	desc.script = "#!/bin/sh\ntrue\n";
+	desc.environment = env;
+	desc.env_size = 1;
+	desc.work_dir = "/tmp";
+	desc.std_out = "/dev/null";
+	desc.user_id = getuid();
+	desc.group_id = getgid();
+	desc.partition = partition;
+	desc.priority = 0;	/* held, never starts */
+	desc.time_limit = 1;
+
+	if (!(rc = slurm_submit_batch_job(&desc, &resp))) {
+		_add_job(w, resp->job_id);
+		slurm_free_submit_response_response_msg(resp);
+	}
+	return rc;
+}
+
+static int _run_op(worker_t *w, op_t op)
+{
+	job_info_msg_t *jobs = NULL;
+	node_info_msg_t *nodes = NULL;
+	partition_info_msg_t *parts = NULL;
+	int rc = SLURM_SUCCESS;
+
+	switch (op) {
+	case OP_SUBMIT:
+		rc = _submit(w);
+		break;
+	case OP_CANCEL:
+		if (!w->job_cnt)
+			return -1;	/* nothing to cancel, not an RPC */
+		rc = slurm_kill_job(w->jobs[--w->job_cnt], SIGKILL, 0);
+		break;
+	case OP_LOAD_JOBS:
+		if (!(rc = slurm_load_jobs(0, &jobs, SHOW_ALL)))
+			slurm_free_job_info_msg(jobs);
+		break;
+	case OP_LOAD_JOB:
+		if (!w->job_cnt)
+			return -1;
+		if (!(rc = slurm_load_job(&jobs,
+					  w->jobs[rand_r(&w->seed) % w->job_cnt],
+					  SHOW_ALL)))
+			slurm_free_job_info_msg(jobs);
+		break;
+	case OP_LOAD_NODES:
+		if (!(rc = slurm_load_node(0, &nodes, SHOW_ALL)))
+			slurm_free_node_info_msg(nodes);
+		break;
+	case OP_LOAD_PARTS:
+		if (!(rc = slurm_load_partitions(0, &parts, SHOW_ALL)))
+			slurm_free_partition_info_msg(parts);
+		break;
+	case OP_PING:
+		rc = slurm_ping(0);
+		break;
+	default:
+		break;
+	}
+
+	return rc ? 1 : 0;
+}
+
+static op_t _pick_op(worker_t *w)
+{
+	int r = rand_r(&w->seed) % weight_total;
+
+	for (int i = 0; i < OP_COUNT; i++) {
+		if (r < op_weight[i])
+			return i;
+		r -= op_weight[i];
+	}
+	return OP_PING;
+}
+
+static void *_worker(void *arg)
+{
+	worker_t *w = arg;
+	struct timespec next, start, end;
+	uint64_t interval = rate ? (1000000.0 * thread_cnt / rate) : 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	/* spread the first request of each thread over one interval */
+	_add_usec(&next, (interval * w->id) / thread_cnt);
+
+	while (1) {
+		op_t op = _pick_op(w);
+		int rc;
+
+		if (interval) {
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+					NULL);
+			_add_usec(&next, interval);
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if ((start.tv_sec > end_time.tv_sec) ||
+		    ((start.tv_sec == end_time.tv_sec) &&
+		     (start.tv_nsec >= end_time.tv_nsec)))
+			break;
+
+		if ((rc = _run_op(w, op)) < 0)
+			continue;
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		_record(&w->stats[op], _usec_diff(&start, &end), rc);
+	}
+
+	/* do not leave held jobs behind */
+	while (w->job_cnt)
+		(void) slurm_kill_job(w->jobs[--w->job_cnt], SIGKILL, 0);
+
+	return NULL;
+}
+
+static int _cmp_uint32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t _pct(uint32_t *lat, int cnt, double pct)
+{
+	int i = (int) (cnt * pct);
+
+	if (i >= cnt)
+		i = cnt - 1;
+	return lat[i];
+}
+
+static void _report(worker_t *workers, int parsable)
+{
+	if (parsable)
+		printf("rpc|count|errors|rate|min|p50|p90|p99|max\n");
+	else
+		printf("%-11s %9s %7s %9s %8s %8s %8s %8s %8s  (usec)\n",
+		       "RPC", "COUNT", "ERRORS", "RATE/S", "MIN", "P50", "P90",
+		       "P99", "MAX");
+
+	for (int op = 0; op < OP_COUNT; op++) {
+		op_stats_t all = { 0 };
+
+		for (int t = 0; t < thread_cnt; t++) {
+			op_stats_t *s = &workers[t].stats[op];
+
+			all.errors += s->errors;
+			for (int i = 0; i < s->lat_cnt; i++)
+				_record(&all, s->lat[i], 0);
+			free(s->lat);
+		}
+		if (!all.lat_cnt && !all.errors)
+			continue;
+
+		qsort(all.lat, all.lat_cnt, sizeof(*all.lat), _cmp_uint32);
+
+		printf(parsable ? "%s|%d|%d|%.1f|%u|%u|%u|%u|%u\n" :
+		       "%-11s %9d %7d %9.1f %8u %8u %8u %8u %8u\n",
+		       op_names[op], all.lat_cnt, all.errors,
+		       (double) all.lat_cnt / duration,
+		       all.lat_cnt ? all.lat[0] : 0,
+		       all.lat_cnt ? _pct(all.lat, all.lat_cnt, 0.50) : 0,
+		       all.lat_cnt ? _pct(all.lat, all.lat_cnt, 0.90) : 0,
+		       all.lat_cnt ? _pct(all.lat, all.lat_cnt, 0.99) : 0,
+		       all.lat_cnt ? all.lat[all.lat_cnt - 1] : 0);
+		free(all.lat);
+	}
+}
+
+static int _parse_mix(char *mix)
+{
+	char *tmp = strdup(mix), *save_ptr = NULL, *tok;
+	int rc = 0;
+
+	memset(op_weight, 0, sizeof(op_weight));
+	for (tok = strtok_r(tmp, ",", &save_ptr); tok;
+	     tok = strtok_r(NULL, ",", &save_ptr)) {
+		char *eq = strchr(tok, '=');
+		int i;
+
+		if (eq)
+			*eq++ = '\0';
+		for (i = 0; i < OP_COUNT; i++)
+			if (!strcmp(tok, op_names[i]))
+				break;
+		if (i == OP_COUNT) {
+			fprintf(stderr, "sload: unknown RPC type %s\n", tok);
+			rc = -1;
+			break;
+		}
+		op_weight[i] = eq ? atoi(eq) : 1;
+	}
+	free(tmp);
+	return rc;
+}
+
+static void _usage(void)
+{
+	printf("Usage: sload [OPTIONS]\n"
+	       "  -d, --duration=secs    length of the run (default: %d)\n"
+	       "  -m, --mix=rpc=weight[,rpc=weight...]\n"
+	       "                         relative frequency of each RPC type\n"
+	       "  -P, --parsable         print results delimited by '|'\n"
+	       "  -p, --partition=name   partition to submit jobs to\n"
+	       "  -r, --rate=num         total RPCs per second (default: "
+	       "unlimited)\n"
+	       "  -t, --threads=num      number of client threads "
+	       "(default: %d)\n"
+	       "  -h, --help             show this help message\n\n"
+	       "RPC types: ", duration, thread_cnt);
+	for (int i = 0; i < OP_COUNT; i++)
+		printf("%s%s=%d", (i ? "," : ""), op_names[i], op_weight[i]);
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	static struct option long_options[] = {
+		{"duration", required_argument, 0, 'd'},
+		{"help", no_argument, 0, 'h'},
+		{"mix", required_argument, 0, 'm'},
+		{"parsable", no_argument, 0, 'P'},
+		{"partition", required_argument, 0, 'p'},
+		{"rate", required_argument, 0, 'r'},
+		{"threads", required_argument, 0, 't'},
+		{NULL, 0, 0, 0}
+	};
+	worker_t *workers;
+	int c, parsable = 0;
+
+	while ((c = getopt_long(argc, argv, "d:hm:Pp:r:t:", long_options,
+				NULL)) != -1) {
+		switch (c) {
+		case 'd':
+			duration = atoi(optarg);
+			break;
+		case 'h':
+			_usage();
+			exit(0);
+		case 'm':
+			if (_parse_mix(optarg))
+				exit(1);
+			break;
+		case 'P':
+			parsable = 1;
+			break;
+		case 'p':
+			partition = optarg;
+			break;
+		case 'r':
+			rate = atof(optarg);
+			break;
+		case 't':
+			thread_cnt = atoi(optarg);
+			break;
+		default:
+			_usage();
+			exit(1);
+		}
+	}
+
+	for (int i = 0; i < OP_COUNT; i++)
+		weight_total += op_weight[i];
+	if ((duration < 1) || (thread_cnt < 1) || (rate < 0) ||
+	    (weight_total < 1)) {
+		_usage();
+		exit(1);
+	}
+
+	slurm_init(NULL);
+
+	workers = calloc(thread_cnt, sizeof(*workers));
+	clock_gettime(CLOCK_MONOTONIC, &end_time);
+	end_time.tv_sec += duration;
+
+	for (int t = 0; t < thread_cnt; t++) {
+		workers[t].id = t;
+		workers[t].seed = getpid() ^ (t * 2654435761U);
+		if ((errno = pthread_create(&workers[t].tid, NULL, _worker,
+					    &workers[t]))) {
+			perror("pthread_create");
+			exit(1);
+		}
+	}
+	for (int t = 0; t < thread_cnt; t++) {
+		pthread_join(workers[t].tid, NULL);
+		free(workers[t].jobs);
+	}
+
+	_report(workers, parsable);
+
+	free(workers);
+	slurm_fini();
+	return 0;
+}
@@ -1972,6 +1972,30 @@ typedef struct {
 	job_state_response_job_t *jobs;
 } job_state_response_msg_t;
 
+typedef struct {
+	char *account;		/* only jobs charged to this account */
+	uint16_t flags;		/* see KILL_* flags */
+	char *job_name;		/* only jobs with this name */
+	char *nodelist;		/* only jobs allocated any of these nodes */
+	char *partition;	/* only jobs in this partition */
+	char *qos;		/* only jobs with this QOS */
+	char *reservation;	/* only jobs in this reservation */
+	uint16_t signal;	/* signal to send */
+	uint32_t state;		/* only jobs in this base state, or JOB_END */
+	uint32_t user_id;	/* only jobs of this user, or NO_VAL */
+	char *wckey;		/* only jobs with this wckey */
+} kill_jobs_msg_t;
+
+typedef struct {
+	uint32_t error_code;	/* result of signaling this job */
+	char *job_id_str;	/* job signaled, "#", "#_#" or "#_[expr]" */
+} kill_jobs_resp_job_t;
+
+typedef struct {
+	uint32_t jobs_cnt;
+	kill_jobs_resp_job_t *job_responses;
+} kill_jobs_resp_msg_t;
+
 typedef struct step_update_request_msg {
 	uint32_t job_id;
 	uint32_t step_id;
@@ -2825,6 +2849,8 @@ typedef struct reservation_name_msg {
 #define PROLOG_FLAG_X11		0x0010 /* enable slurm x11 forwarding support */
 #define PROLOG_FLAG_DEFER_BATCH	0x0020 /* defer REQUEST_BATCH_JOB_LAUNCH until prolog end on all nodes */
 #define PROLOG_FLAG_FORCE_REQUEUE_ON_FAIL 0x0040 /* always requeue job on prolog failure */
+#define PROLOG_FLAG_PARALLEL_SCRIPTS 0x0080 /* run a job's prolog/epilog scripts
+					      * concurrently */
 
 #define CTL_CONF_OR             SLURM_BIT(0) /*SlurmdParameters=config_overrides*/
 #define CTL_CONF_SJC            SLURM_BIT(1) /* AccountingStoreFlags=job_comment*/
@@ -3274,6 +3300,44 @@ typedef struct stats_info_response_msg {
 	uint32_t rpc_dump_count;
 	uint32_t *rpc_dump_types;
 	char **rpc_dump_hostlist;
+
+	uint32_t lock_stats_count;	/* entries per lock_stats_* array */
+	char **lock_stats_name;		/* e.g. "job_write" */
+	uint64_t *lock_stats_acquired;
+	uint64_t *lock_stats_wait_time;	/* usec waiting for the lock */
+	uint64_t *lock_stats_wait_max;
+	uint64_t *lock_stats_hold_time;	/* usec held, write locks only */
+	uint64_t *lock_stats_hold_max;
+	/*
+	 * Histograms hold lock_stats_hist_count buckets per entry. Bucket i
+	 * counts durations below 10^(i+1) usec, the last one is unbounded.
+	 */
+	uint32_t lock_stats_hist_count;
+	uint64_t *lock_stats_wait_hist;
+	uint64_t *lock_stats_hold_hist;
+
+	uint32_t rpcq_count;		/* entries per rpcq_* array */
+	uint16_t *rpcq_type;
+	uint32_t *rpcq_depth_limit; /* NO_VAL if not adaptive */
+	uint32_t *rpcq_depth;
+	uint64_t *rpcq_rejected;
+
+	/* usec of CPU and lock wait, and reply bytes, per RPC type and user */
+	uint32_t rpc_cost_type_size;	/* entries per rpc_cost_type_* array */
+	uint16_t *rpc_cost_type_id;
+	uint64_t *rpc_cost_type_cpu_time;
+	uint64_t *rpc_cost_type_lock_wait;
+	uint64_t *rpc_cost_type_bytes;
+	uint32_t rpc_cost_user_size;	/* entries per rpc_cost_user_* array */
+	uint32_t *rpc_cost_user_id;
+	uint64_t *rpc_cost_user_cpu_time;
+	uint64_t *rpc_cost_user_lock_wait;
+	uint64_t *rpc_cost_user_bytes;
+
+	/* main scheduler pacing chosen with sched_adaptive, 0 if not set */
+	uint32_t schedule_adapt_interval;	/* usec between cycles */
+	uint32_t schedule_adapt_depth;
+	uint32_t schedule_adapt_pressure;	/* percent */
 } stats_info_response_msg_t;
 
 #define TRIGGER_FLAG_PERM		0x0001
@@ -3550,6 +3614,17 @@ extern int slurm_submit_batch_job(job_desc_msg_t *job_desc_msg,
 extern int slurm_submit_batch_het_job(list_t *job_req_list,
 				      submit_response_msg_t **slurm_alloc_msg);
 
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit several independent batch
+ *			     jobs in one request
+ * NOTE: free the response using slurm_list_destroy()
+ * IN job_req_list - list of job requests, type job_desc_msg_t
+ * OUT resp_list - one submit_response_msg_t per request, in the same order.
+ *		   Rejected requests have a job_id of zero and error_code set.
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list, list_t **resp_list);
+
 /*
  * slurm_free_submit_response_response_msg - free slurm
  *	job submit response message
@@ -3693,6 +3768,17 @@ extern int slurm_kill_job_step(uint32_t job_id, uint32_t step_id,
 extern int slurm_kill_job2(const char *job_id, uint16_t signal, uint16_t flags,
 			   const char *sibling);
 
+/*
+ * slurm_kill_jobs - send REQUEST_KILL_JOBS msg to signal every active job
+ *	matching all of the filters set in kill_msg in a single request
+ * IN kill_msg - filters, signal and KILL_* flags
+ * OUT kill_msg_resp - one entry per job signaled with its result, free with
+ *	slurm_free_kill_jobs_response_msg()
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_kill_jobs(kill_jobs_msg_t *kill_msg,
+			   kill_jobs_resp_msg_t **kill_msg_resp);
+
 /*
  * slurm_signal_job - send the specified signal to all steps of an existing job
  * IN job_id     - the job's id
@@ -3983,6 +4069,9 @@ extern void slurm_free_job_info_msg(job_info_msg_t *job_buffer_ptr);
 /* Free jobs states response message */
 extern void slurm_free_job_state_response_msg(job_state_response_msg_t *msg);
 
+/* Free slurm_kill_jobs() response message */
+extern void slurm_free_kill_jobs_response_msg(kill_jobs_resp_msg_t *msg);
+
 /*
  * slurm_free_priority_factors_response_msg - free the job priority factor
  *	information response message
@@ -4045,6 +4134,20 @@ extern int slurm_load_job(job_info_msg_t **resp,
 extern int slurm_load_job_prio(priority_factors_response_msg_t **factors_resp,
 			       uint16_t show_flags);
 
+/*
+ * slurm_load_job_list - issue RPC to get job information for a set of job IDs
+ * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
+ * IN job_id_count - number of job IDs in job_ids
+ * IN job_ids - array of job IDs, a job array or heterogeneous job leader ID
+ *	returns all of its records as with slurm_load_job()
+ * IN show_flags - job filtering options
+ * RET 0 or -1 on error
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_job_list(job_info_msg_t **job_info_msg_pptr,
+			       int job_id_count, uint32_t *job_ids,
+			       uint16_t show_flags);
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -4263,6 +4366,23 @@ extern int slurm_job_step_stat(slurm_step_id_t *step_id,
 			       uint16_t use_protocol_ver,
 			       job_step_stat_response_msg_t **resp);
 
+/*
+ * slurm_job_step_stat_reduced - status a current step, like
+ *	slurm_job_step_stat(), but each slurmd folds the replies of the nodes it
+ *	forwarded the request to into its own. stats_list then holds a few
+ *	aggregated records instead of one per node; their node_name is a
+ *	hostlist expression and pid lists are concatenated.
+ *
+ * IN step_id
+ * IN node_list, optional, if NULL then all nodes in step are returned.
+ * OUT resp
+ * RET SLURM_SUCCESS on success SLURM_ERROR else
+ */
+extern int slurm_job_step_stat_reduced(slurm_step_id_t *step_id,
+				       char *node_list,
+				       uint16_t use_protocol_ver,
+				       job_step_stat_response_msg_t **resp);
+
 /*
  * slurm_job_step_get_pids - get the complete list of pids for a given
  *      job step
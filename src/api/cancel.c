@@ -143,3 +143,37 @@ extern int slurm_kill_job2(const char *job_id, uint16_t signal, uint16_t flags,
 {
 	return _slurm_kill_job_internal(0, job_id, sibling, signal, flags);
 }
+
+extern int slurm_kill_jobs(kill_jobs_msg_t *kill_msg,
+			   kill_jobs_resp_msg_t **kill_msg_resp)
+{
+	int rc = SLURM_SUCCESS;
+	slurm_msg_t req_msg, resp_msg;
+
+	*kill_msg_resp = NULL;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	req_msg.msg_type = REQUEST_KILL_JOBS;
+	req_msg.data = kill_msg;
+
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					   working_cluster_rec) < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_KILL_JOBS:
+		*kill_msg_resp = resp_msg.data;
+		break;
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return rc;
+}
@@ -1477,6 +1477,69 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	return rc;
 }
 
+/*
+ * slurm_load_job_list - issue RPC to get job information for a set of job IDs
+ * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
+ * IN job_id_count - number of job IDs in job_ids
+ * IN job_ids - array of job IDs, a job array or heterogeneous job leader ID
+ *	returns all of its records as with slurm_load_job()
+ * IN show_flags - job filtering options
+ * RET 0 or -1 on error
+ * NOTE: free the response using slurm_free_job_info_msg
+ */
+extern int slurm_load_job_list(job_info_msg_t **job_info_msg_pptr,
+			       int job_id_count, uint32_t *job_ids,
+			       uint16_t show_flags)
+{
+	slurm_msg_t req_msg;
+	job_info_request_msg_t req;
+	char *cluster_name = NULL;
+	void *ptr = NULL;
+	slurmdb_federation_rec_t *fed;
+	int rc;
+
+	if (working_cluster_rec)
+		cluster_name = working_cluster_rec->name;
+	else
+		cluster_name = slurm_conf.cluster_name;
+
+	if ((show_flags & SHOW_FEDERATION) && !(show_flags & SHOW_LOCAL) &&
+	    (slurm_load_federation(&ptr) == SLURM_SUCCESS) &&
+	    cluster_in_federation(ptr, cluster_name)) {
+		show_flags &= (~SHOW_LOCAL);
+	} else {
+		show_flags |= SHOW_LOCAL;
+		show_flags &= (~SHOW_FEDERATION);
+	}
+
+	slurm_msg_t_init(&req_msg);
+	memset(&req, 0, sizeof(req));
+	req.show_flags   = show_flags;
+	req.job_ids      = list_create(xfree_ptr);
+	for (int i = 0; i < job_id_count; i++) {
+		uint32_t *job_id = xmalloc(sizeof(*job_id));
+		*job_id = job_ids[i];
+		list_append(req.job_ids, job_id);
+	}
+	req_msg.msg_type = REQUEST_JOB_INFO;
+	req_msg.data     = &req;
+
+	if (show_flags & SHOW_FEDERATION) {
+		fed = (slurmdb_federation_rec_t *) ptr;
+		rc = _load_fed_jobs(&req_msg, job_info_msg_pptr, show_flags,
+				    cluster_name, fed);
+	} else {
+		rc = _load_cluster_jobs(&req_msg, job_info_msg_pptr,
+					working_cluster_rec);
+	}
+
+	FREE_NULL_LIST(req.job_ids);
+	if (ptr)
+		slurm_destroy_federation_rec(ptr);
+
+	return rc;
+}
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -586,19 +586,9 @@ extern slurm_step_layout_t *slurm_job_step_layout_get(slurm_step_id_t *step_id)
 	}
 }
 
-/*
- * slurm_job_step_stat - status a current step
- *
- * IN step_id
- * IN node_list, optional, if NULL then all nodes in step are returned.
- * IN use_protocol_ver protocol version to use.
- * OUT resp
- * RET SLURM_SUCCESS on success SLURM_ERROR else
- */
-extern int slurm_job_step_stat(slurm_step_id_t *step_id,
-			       char *node_list,
-			       uint16_t use_protocol_ver,
-			       job_step_stat_response_msg_t **resp)
+static int _job_step_stat(slurm_step_id_t *step_id, char *node_list,
+			  uint16_t use_protocol_ver, bool reduced,
+			  job_step_stat_response_msg_t **resp)
 {
 	slurm_msg_t req_msg;
 	list_itr_t *itr;
@@ -645,6 +635,10 @@ extern int slurm_job_step_stat(slurm_step_id_t *step_id,
 	req_msg.msg_type = REQUEST_JOB_STEP_STAT;
 	req_msg.data = &req;
 
+	/* Older slurmds don't know how to reduce the replies */
+	if (reduced && (use_protocol_ver >= SLURM_PROTOCOL_VERSION))
+		req_msg.msg_type = REQUEST_JOB_STEP_STAT_REDUCED;
+
 	if (!(ret_list = slurm_send_recv_msgs(node_list, &req_msg, 0))) {
 		error("%s: got an error no list returned", __func__);
 		rc = SLURM_ERROR;
@@ -698,6 +692,43 @@ cleanup:
 	return rc;
 }
 
+/*
+ * slurm_job_step_stat - status a current step
+ *
+ * IN step_id
+ * IN node_list, optional, if NULL then all nodes in step are returned.
+ * IN use_protocol_ver protocol version to use.
+ * OUT resp
+ * RET SLURM_SUCCESS on success SLURM_ERROR else
+ */
+extern int slurm_job_step_stat(slurm_step_id_t *step_id,
+			       char *node_list,
+			       uint16_t use_protocol_ver,
+			       job_step_stat_response_msg_t **resp)
+{
+	return _job_step_stat(step_id, node_list, use_protocol_ver, false,
+			      resp);
+}
+
+/*
+ * slurm_job_step_stat_reduced - status a current step, with the replies
+ *	combined by the slurmds along the forwarding tree
+ *
+ * IN step_id
+ * IN node_list, optional, if NULL then all nodes in step are returned.
+ * IN use_protocol_ver protocol version to use.
+ * OUT resp
+ * RET SLURM_SUCCESS on success SLURM_ERROR else
+ */
+extern int slurm_job_step_stat_reduced(slurm_step_id_t *step_id,
+				       char *node_list,
+				       uint16_t use_protocol_ver,
+				       job_step_stat_response_msg_t **resp)
+{
+	return _job_step_stat(step_id, node_list, use_protocol_ver, true,
+			      resp);
+}
+
 /*
  * slurm_job_step_get_pids - get the complete list of pids for a given
  *      job step
@@ -60,6 +60,8 @@
 #include "src/api/step_launch.h"
 
 #define STDIO_MAX_FREE_BUF 1024
+#define SERVER_READ_MSGS 64	/* Messages read per server wakeup */
+#define IO_ACCEPT_CNT 64	/* Connections accepted per wakeup */
 
 struct io_buf {
 	int ref_count;
@@ -96,6 +98,7 @@ struct io_operations listening_socket_ops = {
 /**********************************************************************
  * IO server socket declarations
  **********************************************************************/
+static bool _is_fd_ready(int fd, int timeout);
 static bool _server_readable(eio_obj_t *obj);
 static int _server_read(eio_obj_t *obj, List objs);
 static bool _server_writable(eio_obj_t *obj);
@@ -282,14 +285,13 @@ _server_readable(eio_obj_t *obj)
 	return false;
 }
 
-static int
-_server_read(eio_obj_t *obj, List objs)
+static int _server_read_msg(eio_obj_t *obj)
 {
 	struct server_io_info *s = (struct server_io_info *) obj->arg;
 	void *buf;
 	int n;
 
-	debug4("Entering _server_read");
+	debug4("Entering %s", __func__);
 	if (s->in_msg == NULL) {
 		if (_outgoing_buf_free(s->cio)) {
 			s->in_msg = list_dequeue(s->cio->free_outgoing);
@@ -435,6 +437,31 @@ _server_read(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * With many slurmstepds connected every eio wakeup polls all of the sockets,
+ * so drain the messages already waiting on this one instead of returning to
+ * poll() after each of them.
+ */
+static int
+_server_read(eio_obj_t *obj, List objs)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+	int rc;
+
+	for (int i = 0; i < SERVER_READ_MSGS; i++) {
+		if ((rc = _server_read_msg(obj)) != SLURM_SUCCESS)
+			return rc;
+
+		/* Stop on a partial message, eof or shutdown */
+		if (s->in_msg || s->in_eof || (obj->fd < 0) || obj->shutdown)
+			break;
+		if (!_outgoing_buf_free(s->cio) || !_is_fd_ready(obj->fd, 0))
+			break;
+	}
+
+	return SLURM_SUCCESS;
+}
+
 static bool
 _server_writable(eio_obj_t *obj)
 {
@@ -888,7 +915,7 @@ static int _read_io_init_msg(int fd, client_io_t *cio, slurm_addr_t *host)
 
 
 static bool
-_is_fd_ready(int fd)
+_is_fd_ready(int fd, int timeout)
 {
 	struct pollfd pfd[1];
 	int    rc;
@@ -896,7 +923,7 @@ _is_fd_ready(int fd)
 	pfd[0].fd     = fd;
 	pfd[0].events = POLLIN;
 
-	rc = poll(pfd, 1, 10);
+	rc = poll(pfd, 1, timeout);
 
 	return ((rc == 1) && (pfd[0].revents & POLLIN));
 }
@@ -908,14 +935,14 @@ _handle_io_init_msg(int fd, client_io_t *cio)
 	int j;
 	debug2("Activity on IO listening socket %d", fd);
 
-	for (j = 0; j < 15; j++) {
+	for (j = 0; j < IO_ACCEPT_CNT; j++) {
 		int sd;
 		slurm_addr_t addr;
 
 		/*
 		 * Return early if fd is not now ready
 		 */
-		if (!_is_fd_ready(fd))
+		if (!_is_fd_ready(fd, 10))
 			return;
 
 		while ((sd = slurm_accept_msg_conn(fd, &addr)) < 0) {
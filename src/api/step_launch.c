@@ -1741,16 +1741,17 @@ static void _print_launch_msg(launch_tasks_request_msg_t *msg,
 			      char *hostname, int nodeid)
 {
 	int i;
-	char *tmp_str = NULL, *task_list = NULL;
-	hostlist_t *hl = hostlist_create(NULL);
-
-	for (i=0; i<msg->tasks_to_launch[nodeid]; i++) {
-		xstrfmtcat(tmp_str, "%u", msg->global_task_ids[nodeid][i]);
-		hostlist_push_host(hl, tmp_str);
-		xfree(tmp_str);
-	}
-	task_list = hostlist_ranged_string_xmalloc(hl);
-	hostlist_destroy(hl);
+	uint32_t max_tid = 0;
+	char *task_list = NULL;
+	bitstr_t *task_bitmap;
+
+	for (i = 0; i < msg->tasks_to_launch[nodeid]; i++)
+		max_tid = MAX(max_tid, msg->global_task_ids[nodeid][i]);
+	task_bitmap = bit_alloc(max_tid + 1);
+	for (i = 0; i < msg->tasks_to_launch[nodeid]; i++)
+		bit_set(task_bitmap, msg->global_task_ids[nodeid][i]);
+	task_list = bit_fmt_full(task_bitmap);
+	FREE_NULL_BITMAP(task_bitmap);
 
 	info("launching %ps on host %s, %u tasks: %s",
 	     &msg->step_id, hostname, msg->tasks_to_launch[nodeid], task_list);
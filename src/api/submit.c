@@ -155,3 +155,57 @@ extern int slurm_submit_batch_het_job(List job_req_list,
 
 	return SLURM_SUCCESS;
 }
+
+/*
+ * slurm_submit_batch_jobs - issue RPC to submit several independent batch
+ *			     jobs in one request
+ * NOTE: free the response using slurm_list_destroy()
+ * IN job_req_list - List of job requests, type job_desc_msg_t
+ * OUT resp_list - List of submit_response_msg_t, one per request
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_submit_batch_jobs(list_t *job_req_list, list_t **resp_list)
+{
+	int rc;
+	job_desc_msg_t *req;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	list_itr_t *iter;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	/*
+	 * set session id for this request
+	 */
+	iter = list_iterator_create(job_req_list);
+	while ((req = (job_desc_msg_t *) list_next(iter))) {
+		if (req->alloc_sid == NO_VAL)
+			req->alloc_sid = getsid(0);
+	}
+	list_iterator_destroy(iter);
+
+	req_msg.msg_type = REQUEST_SUBMIT_BATCH_JOB_LIST;
+	req_msg.data     = job_req_list;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					    working_cluster_rec);
+	if (rc == SLURM_ERROR)
+		return SLURM_ERROR;
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		*resp_list = NULL;
+		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_LIST:
+		*resp_list = (list_t *) resp_msg.data;
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return SLURM_SUCCESS;
+}
@@ -81,6 +81,12 @@
 #define DEFAULT_THREADS 8
 #define MAX_THREADS     64	/* These can be huge messages, so
 				 * only run MAX_THREADS at one time */
+#define MAX_PIPELINE    16	/* Blocks of a file in flight at once */
+
+typedef struct {
+	struct bcast_parameters *params;
+	file_bcast_msg_t msg;
+} bcast_block_t;
 
 int block_len;				/* block size */
 int fd;					/* source file descriptor */
@@ -88,6 +94,14 @@ void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
+static char *send_nodes = NULL;		/* nodes still lacking the file,
+					 * NULL for the whole allocation */
+
+static pthread_mutex_t pipeline_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pipeline_cond = PTHREAD_COND_INITIALIZER;
+static int pipeline_active = 0;		/* blocks in flight */
+static int pipeline_rc = SLURM_SUCCESS;	/* first failure of a block */
+
 static int   _bcast_file(struct bcast_parameters *params);
 static int   _file_bcast(struct bcast_parameters *params,
 			 file_bcast_msg_t *bcast_msg,
@@ -181,8 +195,9 @@ static int _file_bcast(struct bcast_parameters *params,
 	msg.forward.tree_width = params->tree_width;
 	msg.msg_type = REQUEST_FILE_BCAST;
 
-	ret_list = slurm_send_recv_msgs(sbcast_cred->node_list, &msg,
-					params->timeout);
+	ret_list = slurm_send_recv_msgs(send_nodes ? send_nodes :
+					sbcast_cred->node_list,
+					&msg, params->timeout);
 	if (ret_list == NULL) {
 		error("slurm_send_recv_msgs: %m");
 		exit(1);
@@ -206,6 +221,70 @@ static int _file_bcast(struct bcast_parameters *params,
 	return rc;
 }
 
+static void *_file_bcast_block(void *arg)
+{
+	bcast_block_t *block = arg;
+	int rc;
+
+	rc = _file_bcast(block->params, &block->msg, sbcast_cred);
+
+	slurm_mutex_lock(&pipeline_mutex);
+	if ((rc != SLURM_SUCCESS) && (pipeline_rc == SLURM_SUCCESS))
+		pipeline_rc = rc;
+	pipeline_active--;
+	slurm_cond_broadcast(&pipeline_cond);
+	slurm_mutex_unlock(&pipeline_mutex);
+
+	xfree(block->msg.block);
+	xfree(block);
+
+	return NULL;
+}
+
+/*
+ * Wait until at most max_active blocks are in flight.
+ * RET the first error of a pipelined block or SLURM_SUCCESS
+ */
+static int _pipeline_wait(int max_active)
+{
+	int rc;
+
+	slurm_mutex_lock(&pipeline_mutex);
+	while (pipeline_active > max_active)
+		slurm_cond_wait(&pipeline_cond, &pipeline_mutex);
+	rc = pipeline_rc;
+	slurm_mutex_unlock(&pipeline_mutex);
+
+	return rc;
+}
+
+/*
+ * Send a middle block of the file without waiting for its reply. The slurmd
+ * writes each block at its own offset, only the first block (which opens the
+ * file) and the last one (which closes it) need to be sent in order.
+ */
+static int _file_bcast_pipelined(struct bcast_parameters *params,
+				 file_bcast_msg_t *bcast_msg)
+{
+	bcast_block_t *block;
+	int rc;
+
+	if ((rc = _pipeline_wait(params->pipeline - 1)) != SLURM_SUCCESS)
+		return rc;
+
+	block = xmalloc(sizeof(*block));
+	block->params = params;
+	memcpy(&block->msg, bcast_msg, sizeof(block->msg));
+
+	slurm_mutex_lock(&pipeline_mutex);
+	pipeline_active++;
+	slurm_mutex_unlock(&pipeline_mutex);
+
+	slurm_thread_create_detached(_file_bcast_block, block);
+
+	return SLURM_SUCCESS;
+}
+
 /* load a buffer with data from the file to broadcast,
  * return number of bytes read, zero on end of file */
 static int _get_block_none(char **buffer, int *orig_len, bool *more,
@@ -221,10 +300,11 @@ static int _get_block_none(char **buffer, int *orig_len, bool *more,
 	}
 
 	if (remaining < 0) {
-		*buffer = xmalloc(block_len);
 		remaining = f_stat.st_size;
 		position = src;
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	size = MIN(block_len, remaining);
 	memcpy(*buffer, position, size);
@@ -260,8 +340,9 @@ static int _get_block_lz4(struct bcast_parameters *params,
 	if (remaining < 0) {
 		position = src;
 		remaining = f_stat.st_size;
-		*buffer = xmalloc(block_len);
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	/* intentionally limit decompressed size to 10x compressed
 	 * to avoid problems on receive size when decompressed */
@@ -339,7 +420,11 @@ static int _bcast_file(struct bcast_parameters *params)
 	bcast_msg.file_size	= f_stat.st_size;
 	bcast_msg.cred          = sbcast_cred->sbcast_cred;
 
-	if (params->flags & BCAST_FLAG_PRESERVE) {
+	/*
+	 * Shared objects always keep their times, the slurmd matches copies
+	 * already received on size and modification time.
+	 */
+	if (params->flags & (BCAST_FLAG_PRESERVE | BCAST_FLAG_SHARED_OBJECT)) {
 		bcast_msg.atime     = f_stat.st_atime;
 		bcast_msg.mtime     = f_stat.st_mtime;
 	}
@@ -349,6 +434,9 @@ static int _bcast_file(struct bcast_parameters *params)
 	else if (params->tree_width != 0xfffd)
 		params->tree_width = MIN(MAX_THREADS, params->tree_width);
 
+	params->pipeline = MIN(MAX_PIPELINE, params->pipeline);
+	pipeline_rc = SLURM_SUCCESS;
+
 	while (more) {
 		START_TIMER;
 		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
@@ -366,7 +454,14 @@ static int _bcast_file(struct bcast_parameters *params)
 		if (!more)
 			bcast_msg.flags |= FILE_BCAST_LAST_BLOCK;
 
-		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
+		if ((params->pipeline > 1) && more &&
+		    (bcast_msg.block_no > 1)) {
+			rc = _file_bcast_pipelined(params, &bcast_msg);
+			if (rc == SLURM_SUCCESS)
+				buffer = NULL; /* owned by the block's thread */
+		} else if ((rc = _pipeline_wait(0)) == SLURM_SUCCESS) {
+			rc = _file_bcast(params, &bcast_msg, sbcast_cred);
+		}
 		if (rc != SLURM_SUCCESS)
 			break;
 		if (bcast_msg.flags & FILE_BCAST_LAST_BLOCK)
@@ -374,6 +469,8 @@ static int _bcast_file(struct bcast_parameters *params)
 		bcast_msg.block_no++;
 		bcast_msg.block_offset += orig_len;
 	}
+	/* Blocks still in flight reference bcast_msg fields */
+	(void) _pipeline_wait(0);
 	xfree(bcast_msg.user_name);
 	xfree(buffer);
 
@@ -506,14 +603,81 @@ static int _find_subpath(void *x, void *key)
 	return subpath(so_path, exclude_path);
 }
 
+/*
+ * Ask every node whether this job already has an identical copy of the shared
+ * object (e.g. sent along with another executable) and set send_nodes to the
+ * nodes that still need it.
+ *
+ * RET the number of nodes the shared object has to be sent to, -1 if unknown
+ */
+static int _probe_library(struct bcast_parameters *params)
+{
+	file_bcast_msg_t bcast_msg;
+	slurm_msg_t msg;
+	List ret_list;
+	list_itr_t *itr;
+	ret_data_info_t *ret_data_info;
+	hostlist_t *missing;
+	int node_cnt, missing_cnt;
+
+	xfree(send_nodes);
+
+	memset(&bcast_msg, 0, sizeof(bcast_msg));
+	bcast_msg.fname = params->dst_fname;
+	bcast_msg.exe_fname = params->exe_fname;
+	bcast_msg.flags = FILE_BCAST_SO | FILE_BCAST_PROBE;
+	bcast_msg.modes = f_stat.st_mode;
+	bcast_msg.uid = f_stat.st_uid;
+	bcast_msg.gid = f_stat.st_gid;
+	bcast_msg.file_size = f_stat.st_size;
+	bcast_msg.atime = f_stat.st_atime;
+	bcast_msg.mtime = f_stat.st_mtime;
+	bcast_msg.cred = sbcast_cred->sbcast_cred;
+
+	slurm_msg_t_init(&msg);
+	slurm_msg_set_r_uid(&msg, SLURM_AUTH_UID_ANY);
+	msg.data = &bcast_msg;
+	msg.flags = USE_BCAST_NETWORK;
+	msg.forward.tree_width = params->tree_width;
+	msg.msg_type = REQUEST_FILE_BCAST;
+
+	if (!(ret_list = slurm_send_recv_msgs(sbcast_cred->node_list, &msg,
+					      params->timeout)))
+		return -1;	/* send to all nodes */
+	node_cnt = list_count(ret_list);
+
+	/* Anything but success (e.g. an older slurmd) gets the file sent */
+	missing = hostlist_create(NULL);
+	itr = list_iterator_create(ret_list);
+	while ((ret_data_info = list_next(itr))) {
+		if (slurm_get_return_code(ret_data_info->type,
+					  ret_data_info->data) != SLURM_SUCCESS)
+			hostlist_push_host(missing, ret_data_info->node_name);
+	}
+	list_iterator_destroy(itr);
+	FREE_NULL_LIST(ret_list);
+
+	if ((missing_cnt = hostlist_count(missing)) &&
+	    (missing_cnt < node_cnt))
+		send_nodes = hostlist_ranged_string_xmalloc(missing);
+	hostlist_destroy(missing);
+
+	return missing_cnt;
+}
+
 static int _bcast_library(struct bcast_parameters *params)
 {
 	int rc;
 
 	if ((rc = _file_state(params)) != SLURM_SUCCESS)
 		return rc;
-	if ((rc = _bcast_file(params)) != SLURM_SUCCESS)
+	if (!_probe_library(params)) {
+		verbose("Shared object '%s' already present on all nodes",
+			params->src_fname);
 		return rc;
+	}
+	rc = _bcast_file(params);
+	xfree(send_nodes);
 
 	return rc;
 }
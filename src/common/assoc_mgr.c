@@ -45,13 +45,17 @@
 #include <ctype.h>
 
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/priority.h"
 #include "src/common/slurmdbd_pack.h"
 #include "src/slurmdbd/read_config.h"
 
 #define ASSOC_HASH_SIZE 1000
-#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % ASSOC_HASH_SIZE)
+#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % assoc_hash_size)
+
+/* Max number of parsed TRES strings kept in tres_str_cache */
+#define TRES_STR_CACHE_SIZE 4096
 
 typedef struct {
 	char *req;
@@ -65,6 +69,18 @@ typedef struct {
 	uint64_t **tres_cnt;
 } foreach_tres_pos_t;
 
+/*
+ * A TRES string resolved against assoc_mgr_tres_array. Only valid for the
+ * current array, so the cache is emptied whenever the array is rebuilt.
+ */
+typedef struct {
+	char *tres_str;
+	int rec_cnt;		/* records in tres_str, -1 if none parsed */
+	int pos_cnt;		/* records found in assoc_mgr_tres_array */
+	int *pos;		/* position in assoc_mgr_tres_array */
+	uint64_t *count;	/* count of the record, indexed like pos */
+} tres_str_cache_t;
+
 slurmdb_assoc_rec_t *assoc_mgr_root_assoc = NULL;
 uint32_t g_qos_max_priority = 0;
 uint32_t g_assoc_max_priority = 0;
@@ -89,7 +105,11 @@ static pthread_mutex_t assoc_lock_init = PTHREAD_MUTEX_INITIALIZER;
 static assoc_init_args_t init_setup;
 static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
+static uint32_t assoc_hash_size = 0;	/* buckets in assoc_hash[_id] */
+static uint32_t assoc_hash_cnt = 0;	/* records in assoc_hash[_id] */
 static int *assoc_mgr_tres_old_pos = NULL;
+static xhash_t *tres_str_cache = NULL;
+static pthread_mutex_t tres_str_cache_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static bool _running_cache(void)
 {
@@ -115,7 +135,7 @@ static int _get_str_inx(char *name)
 
 static int _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
 {
-	int index;
+	uint32_t index;
 
 	xassert(assoc);
 
@@ -135,31 +155,79 @@ static int _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
 	if (assoc->partition)
 		index += _get_str_inx(assoc->partition);
 
-	index %= ASSOC_HASH_SIZE;
-	if (index < 0)
-		index += ASSOC_HASH_SIZE;
+	/* Spread neighbouring uid/name sums over the table */
+	index *= 2654435761U;
 
-	return index;
+	return (index % assoc_hash_size);
+
+}
+
+static void _free_assoc_hash(void)
+{
+	xfree(assoc_hash_id);
+	xfree(assoc_hash);
+	assoc_hash_size = 0;
+	assoc_hash_cnt = 0;
+}
+
+/*
+ * Grow the association hash tables so chains stay short as associations are
+ * added. Every record is on exactly one assoc_hash_id chain, so walk those and
+ * relink each record into both new tables.
+ */
+static void _grow_assoc_hash(void)
+{
+	slurmdb_assoc_rec_t **old_hash_id = assoc_hash_id;
+	uint32_t old_size = assoc_hash_size;
+
+	xfree(assoc_hash);
+	assoc_hash_size *= 4;
+	assoc_hash_id = xcalloc(assoc_hash_size, sizeof(*assoc_hash_id));
+	assoc_hash = xcalloc(assoc_hash_size, sizeof(*assoc_hash));
 
+	for (uint32_t i = 0; i < old_size; i++) {
+		slurmdb_assoc_rec_t *assoc = old_hash_id[i], *next;
+
+		for (; assoc; assoc = next) {
+			int inx = ASSOC_HASH_ID_INX(assoc->id);
+
+			next = assoc->assoc_next_id;
+			assoc->assoc_next_id = assoc_hash_id[inx];
+			assoc_hash_id[inx] = assoc;
+
+			inx = _assoc_hash_index(assoc);
+			assoc->assoc_next = assoc_hash[inx];
+			assoc_hash[inx] = assoc;
+		}
+	}
+	xfree(old_hash_id);
+
+	debug2("%s: association hash resized to %u buckets for %u records",
+	       __func__, assoc_hash_size, assoc_hash_cnt);
 }
 
 static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
 {
-	int inx = ASSOC_HASH_ID_INX(assoc->id);
+	int inx;
 
-	if (!assoc_hash_id)
-		assoc_hash_id = xcalloc(ASSOC_HASH_SIZE,
+	if (!assoc_hash_id) {
+		assoc_hash_size = ASSOC_HASH_SIZE;
+		assoc_hash_id = xcalloc(assoc_hash_size,
 					sizeof(slurmdb_assoc_rec_t *));
-	if (!assoc_hash)
-		assoc_hash = xcalloc(ASSOC_HASH_SIZE,
+		assoc_hash = xcalloc(assoc_hash_size,
 				     sizeof(slurmdb_assoc_rec_t *));
+	} else if (assoc_hash_cnt >= (assoc_hash_size * 2)) {
+		_grow_assoc_hash();
+	}
 
+	inx = ASSOC_HASH_ID_INX(assoc->id);
 	assoc->assoc_next_id = assoc_hash_id[inx];
 	assoc_hash_id[inx] = assoc;
 
 	inx = _assoc_hash_index(assoc);
 	assoc->assoc_next = assoc_hash[inx];
 	assoc_hash[inx] = assoc;
+	assoc_hash_cnt++;
 }
 
 static slurmdb_assoc_rec_t *_find_assoc_rec_id(uint32_t assoc_id,
@@ -330,6 +398,8 @@ static void _delete_assoc_hash(slurmdb_assoc_rec_t *assoc)
 		return;	/* Fix CLANG false positive error */
 	} else
 		*assoc_pptr = assoc_ptr->assoc_next;
+
+	assoc_hash_cnt--;
 }
 
 
@@ -1100,8 +1170,7 @@ static int _post_assoc_list(void)
 	if (!assoc_mgr_assoc_list)
 		return SLURM_ERROR;
 
-	xfree(assoc_hash_id);
-	xfree(assoc_hash);
+	_free_assoc_hash();
 
 	itr = list_iterator_create(assoc_mgr_assoc_list);
 
@@ -1403,6 +1472,11 @@ extern int assoc_mgr_post_tres_list(List new_list)
 
 	g_tres_count = new_cnt;
 
+	slurm_mutex_lock(&tres_str_cache_lock);
+	if (tres_str_cache)
+		xhash_clear(tres_str_cache);
+	slurm_mutex_unlock(&tres_str_cache_lock);
+
 	if ((changed_size || changed_pos) &&
 	    assoc_mgr_assoc_list && assoc_mgr_qos_list) {
 		uint64_t grp_used_tres[new_cnt],
@@ -2166,6 +2240,9 @@ extern int assoc_mgr_fini(bool save_state)
 	}
 	xfree(assoc_mgr_tres_array);
 	xfree(assoc_mgr_tres_old_pos);
+	slurm_mutex_lock(&tres_str_cache_lock);
+	xhash_free(tres_str_cache);
+	slurm_mutex_unlock(&tres_str_cache_lock);
 	assoc_mgr_assoc_list = NULL;
 	assoc_mgr_res_list = NULL;
 	assoc_mgr_qos_list = NULL;
@@ -2177,8 +2254,7 @@ extern int assoc_mgr_fini(bool save_state)
 	if (_running_cache())
 		*init_setup.running_cache = RUNNING_CACHE_STATE_NOTRUNNING;
 
-	xfree(assoc_hash_id);
-	xfree(assoc_hash);
+	_free_assoc_hash();
 
 	assoc_mgr_unlock(&locks);
 
@@ -6848,6 +6924,79 @@ extern int assoc_mgr_set_tres_cnt_array_from_list(
 	return 0;
 }
 
+static void _tres_str_cache_key(void *item, const char **key,
+				uint32_t *key_len)
+{
+	tres_str_cache_t *entry = item;
+
+	*key = entry->tres_str;
+	*key_len = strlen(entry->tres_str);
+}
+
+static void _tres_str_cache_free(void *item)
+{
+	tres_str_cache_t *entry = item;
+
+	xfree(entry->tres_str);
+	xfree(entry->pos);
+	xfree(entry->count);
+	xfree(entry);
+}
+
+static int _foreach_tres_str_cache_add(void *x, void *arg)
+{
+	slurmdb_tres_rec_t *tres_rec = x;
+	tres_str_cache_t *entry = arg;
+	int pos = assoc_mgr_find_tres_pos(tres_rec, true);
+
+	if (pos == -1) {
+		debug2("%s: no tres of id %u found in the array",
+		       __func__, tres_rec->id);
+		return 0;
+	}
+
+	entry->pos[entry->pos_cnt] = pos;
+	entry->count[entry->pos_cnt] = tres_rec->count;
+	entry->pos_cnt++;
+
+	return 0;
+}
+
+/*
+ * Return the parsed form of tres_str, parsing it on first use.
+ * TRES read lock and tres_str_cache_lock must be locked before calling this.
+ */
+static tres_str_cache_t *_tres_str_cache_get(char *tres_str)
+{
+	tres_str_cache_t *entry;
+	list_t *tmp_list = NULL;
+
+	if (!tres_str_cache)
+		tres_str_cache = xhash_init(_tres_str_cache_key,
+					    _tres_str_cache_free);
+	else if ((entry = xhash_get_str(tres_str_cache, tres_str)))
+		return entry;
+	else if (xhash_count(tres_str_cache) >= TRES_STR_CACHE_SIZE)
+		xhash_clear(tres_str_cache);
+
+	slurmdb_tres_list_from_string(&tmp_list, tres_str, TRES_STR_FLAG_NONE);
+
+	entry = xmalloc(sizeof(*entry));
+	entry->tres_str = xstrdup(tres_str);
+	entry->rec_cnt = -1;
+	if (tmp_list && (entry->rec_cnt = list_count(tmp_list))) {
+		entry->pos = xcalloc(entry->rec_cnt, sizeof(*entry->pos));
+		entry->count = xcalloc(entry->rec_cnt, sizeof(*entry->count));
+		(void) list_for_each(tmp_list, _foreach_tres_str_cache_add,
+				     entry);
+	}
+	FREE_NULL_LIST(tmp_list);
+
+	xhash_add(tres_str_cache, entry);
+
+	return entry;
+}
+
 extern int assoc_mgr_set_tres_cnt_array(uint64_t **tres_cnt, char *tres_str,
 					uint64_t init_val, bool locked,
 					bool relative,
@@ -6875,14 +7024,37 @@ extern int assoc_mgr_set_tres_cnt_array(uint64_t **tres_cnt, char *tres_str,
 	}
 
 	if (tres_str) {
-		List tmp_list = NULL;
+		assoc_mgr_lock_t locks = { .tres = READ_LOCK };
+		tres_str_cache_t *entry;
+		uint64_t count;
+
+		if (!locked)
+			assoc_mgr_lock(&locks);
+		slurm_mutex_lock(&tres_str_cache_lock);
 		/* info("got %s", tres_str); */
-		slurmdb_tres_list_from_string(
-			&tmp_list, tres_str, TRES_STR_FLAG_NONE);
-		diff_cnt = assoc_mgr_set_tres_cnt_array_from_list(
-			tres_cnt, tmp_list, locked,
-			relative, relative_tres_cnt);
-		FREE_NULL_LIST(tmp_list);
+		entry = _tres_str_cache_get(tres_str);
+		for (i = 0; i < entry->pos_cnt; i++) {
+			count = entry->count[i];
+			/*
+			 * If Relative make the number absolute based on
+			 * the relative_tres_cnt[pos]
+			 */
+			if (relative && relative_tres_cnt &&
+			    (count != INFINITE64)) {
+				/* Sanity check for max possible. */
+				if (count > 100)
+					count = 100;
+				count *= relative_tres_cnt[entry->pos[i]];
+				/* This will truncate/round down */
+				count /= 100;
+			}
+			(*tres_cnt)[entry->pos[i]] = count;
+		}
+		if ((entry->rec_cnt != -1) && (g_tres_count != entry->rec_cnt))
+			diff_cnt = 1;
+		slurm_mutex_unlock(&tres_str_cache_lock);
+		if (!locked)
+			assoc_mgr_unlock(&locks);
 	}
 	return diff_cnt;
 }
@@ -7049,7 +7221,7 @@ extern char *assoc_mgr_make_tres_str_from_array(
 	uint64_t *tres_cnt, uint32_t flags, bool locked)
 {
 	int i;
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 	assoc_mgr_lock_t locks = { .tres = READ_LOCK };
 	uint64_t count;
 
@@ -7077,9 +7249,9 @@ extern char *assoc_mgr_make_tres_str_from_array(
 			count = 0;
 
 		if (flags & TRES_STR_FLAG_SIMPLE) {
-			xstrfmtcat(tres_str, "%s%u=%"PRIu64,
-				   tres_str ? "," : "",
-				   assoc_mgr_tres_array[i]->id, count);
+			xstrfmtcatat(tres_str, &pos, "%s%u=%"PRIu64,
+				     tres_str ? "," : "",
+				     assoc_mgr_tres_array[i]->id, count);
 		} else {
 			/* Always skip these when printing out named TRES */
 			if ((count == NO_VAL64) ||
@@ -7093,10 +7265,10 @@ extern char *assoc_mgr_make_tres_str_from_array(
 						 sizeof(outbuf), UNIT_MEGA,
 						 NO_VAL,
 						 CONVERT_NUM_UNIT_EXACT);
-				xstrfmtcat(tres_str, "%s%s=%s",
-					   tres_str ? "," : "",
-					   assoc_mgr_tres_name_array[i],
-					   outbuf);
+				xstrfmtcatat(tres_str, &pos, "%s%s=%s",
+					     tres_str ? "," : "",
+					     assoc_mgr_tres_name_array[i],
+					     outbuf);
 			} else if (!xstrcasecmp(assoc_mgr_tres_array[i]->type,
 						"fs") ||
 				   !xstrcasecmp(assoc_mgr_tres_array[i]->type,
@@ -7106,15 +7278,15 @@ extern char *assoc_mgr_make_tres_str_from_array(
 						 sizeof(outbuf), UNIT_NONE,
 						 NO_VAL,
 						 CONVERT_NUM_UNIT_EXACT);
-				xstrfmtcat(tres_str, "%s%s=%s",
-					   tres_str ? "," : "",
-					   assoc_mgr_tres_name_array[i],
-					   outbuf);
+				xstrfmtcatat(tres_str, &pos, "%s%s=%s",
+					     tres_str ? "," : "",
+					     assoc_mgr_tres_name_array[i],
+					     outbuf);
 			} else {
-				xstrfmtcat(tres_str, "%s%s=%"PRIu64,
-					   tres_str ? "," : "",
-					   assoc_mgr_tres_name_array[i],
-					   count);
+				xstrfmtcatat(tres_str, &pos, "%s%s=%"PRIu64,
+					     tres_str ? "," : "",
+					     assoc_mgr_tres_name_array[i],
+					     count);
 			}
 		}
 	}
@@ -145,6 +145,8 @@ strong_alias(bit_fill_gaps,	slurm_bit_fill_gaps);
 strong_alias(bit_super_set,	slurm_bit_super_set);
 strong_alias(bit_overlap,	slurm_bit_overlap);
 strong_alias(bit_overlap_any,	slurm_bit_overlap_any);
+strong_alias(bit_overlap_ffs,	slurm_bit_overlap_ffs);
+strong_alias(bit_overlap_and_not, slurm_bit_overlap_and_not);
 strong_alias(bit_equal,		slurm_bit_equal);
 strong_alias(bit_copy,		slurm_bit_copy);
 strong_alias(bit_pick_cnt,	slurm_bit_pick_cnt);
@@ -762,19 +764,20 @@ bit_equal(bitstr_t *b1, bitstr_t *b2)
 void
 bit_and(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit_cnt, word, full_words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] &= b2[_bit_word(bit)];
+	/* Plain word loop, simple enough for the compiler to vectorize */
+	full_words = _bit_word(bit_cnt);
+	for (word = BITSTR_OVERHEAD; word < full_words; word++)
+		b1[word] &= b2[word];
 
-	if (bit < bit_cnt) {
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = ~(_bit_nmask(bit_cnt));
-		b1[_bit_word(bit)] &= (b2[_bit_word(bit)] | mask);
+		b1[word] &= (b2[word] | mask);
 	}
 }
 
@@ -785,19 +788,20 @@ bit_and(bitstr_t *b1, bitstr_t *b2)
  */
 void bit_and_not(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit_cnt, word, full_words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] &= ~b2[_bit_word(bit)];
+	/* Plain word loop, simple enough for the compiler to vectorize */
+	full_words = _bit_word(bit_cnt);
+	for (word = BITSTR_OVERHEAD; word < full_words; word++)
+		b1[word] &= ~b2[word];
 
-	if (bit < bit_cnt) {
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = _bit_nmask(bit_cnt);
-		b1[_bit_word(bit)] &= ~(b2[_bit_word(bit)] & mask);
+		b1[word] &= ~(b2[word] & mask);
 	}
 }
 
@@ -824,19 +828,20 @@ bit_not(bitstr_t *b)
 void
 bit_or(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit_cnt, word, full_words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] |= b2[_bit_word(bit)];
+	/* Plain word loop, simple enough for the compiler to vectorize */
+	full_words = _bit_word(bit_cnt);
+	for (word = BITSTR_OVERHEAD; word < full_words; word++)
+		b1[word] |= b2[word];
 
-	if (bit < bit_cnt) {
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = _bit_nmask(bit_cnt);
-		b1[_bit_word(bit)] |= (b2[_bit_word(bit)] & mask);
+		b1[word] |= (b2[word] & mask);
 	}
 }
 
@@ -847,19 +852,20 @@ bit_or(bitstr_t *b1, bitstr_t *b2)
  */
 void bit_or_not(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit_cnt, word, full_words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 
 	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE)
-		b1[_bit_word(bit)] |= ~b2[_bit_word(bit)];
+	/* Plain word loop, simple enough for the compiler to vectorize */
+	full_words = _bit_word(bit_cnt);
+	for (word = BITSTR_OVERHEAD; word < full_words; word++)
+		b1[word] |= ~b2[word];
 
-	if (bit < bit_cnt) {
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = ~(_bit_nmask(bit_cnt));
-		b1[_bit_word(bit)] |= ~(b2[_bit_word(bit)] | mask);
+		b1[word] |= ~(b2[word] | mask);
 	}
 }
 
@@ -914,6 +920,77 @@ hweight(uint64_t w)
 }
 #endif
 
+/*
+ * Without -mpopcnt the popcount builtin is a library call on x86_64. Build an
+ * additional popcnt variant of the counting loops there, selected at load
+ * time based on the CPU (this relies upon ifunc support from glibc).
+ */
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define BIT_COUNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#endif
+#endif
+#ifndef BIT_COUNT_CLONES
+#define BIT_COUNT_CLONES
+#endif
+
+/* Count the bits set in cnt words, using independent sums for throughput */
+BIT_COUNT_CLONES
+static int32_t _count_words(const bitstr_t *words, bitoff_t cnt)
+{
+	uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	bitoff_t i;
+
+	for (i = 0; (i + 4) <= cnt; i += 4) {
+		c0 += hweight(words[i]);
+		c1 += hweight(words[i + 1]);
+		c2 += hweight(words[i + 2]);
+		c3 += hweight(words[i + 3]);
+	}
+	for (; i < cnt; i++)
+		c0 += hweight(words[i]);
+
+	return (c0 + c1 + c2 + c3);
+}
+
+/* Count the bits set in both w1 and w2 over cnt words */
+BIT_COUNT_CLONES
+static int32_t _count_and_words(const bitstr_t *w1, const bitstr_t *w2,
+				bitoff_t cnt)
+{
+	uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	bitoff_t i;
+
+	for (i = 0; (i + 4) <= cnt; i += 4) {
+		c0 += hweight(w1[i] & w2[i]);
+		c1 += hweight(w1[i + 1] & w2[i + 1]);
+		c2 += hweight(w1[i + 2] & w2[i + 2]);
+		c3 += hweight(w1[i + 3] & w2[i + 3]);
+	}
+	for (; i < cnt; i++)
+		c0 += hweight(w1[i] & w2[i]);
+
+	return (c0 + c1 + c2 + c3);
+}
+
+/* Count the bits set in w1 and w2 but not in w3 over cnt words */
+BIT_COUNT_CLONES
+static int32_t _count_and_not_words(const bitstr_t *w1, const bitstr_t *w2,
+				    const bitstr_t *w3, bitoff_t cnt)
+{
+	uint64_t c0 = 0, c1 = 0;
+	bitoff_t i;
+
+	for (i = 0; (i + 2) <= cnt; i += 2) {
+		c0 += hweight(w1[i] & w2[i] & ~w3[i]);
+		c1 += hweight(w1[i + 1] & w2[i + 1] & ~w3[i + 1]);
+	}
+	for (; i < cnt; i++)
+		c0 += hweight(w1[i] & w2[i] & ~w3[i]);
+
+	return (c0 + c1);
+}
+
 /*
  * Count the number of bits set in bitstring.
  *   b (IN)		bitstring to check
@@ -922,19 +999,17 @@ hweight(uint64_t w)
 int32_t
 bit_set_count(bitstr_t *b)
 {
-	int32_t count = 0;
-	bitoff_t bit, bit_cnt;
+	int32_t count;
+	bitoff_t bit_cnt, full_words;
 
 	_assert_bitstr_valid(b);
 
 	bit_cnt = _bitstr_bits(b);
-	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
-	     bit += BITSTR_WORD_SIZE) {
-		count += hweight(b[_bit_word(bit)]);
-	}
-	if (bit < bit_cnt) {
+	full_words = bit_cnt >> BITSTR_SHIFT;
+	count = _count_words(&b[BITSTR_OVERHEAD], full_words);
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = _bit_nmask(bit_cnt);
-		count += hweight(b[_bit_word(bit)] & mask);
+		count += hweight(b[BITSTR_OVERHEAD + full_words] & mask);
 	}
 	return count;
 }
@@ -970,8 +1045,11 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 		count += hweight(b[_bit_word(bit)] & mask);
 		bit = eow;
 	}
-	for (; (bit + BITSTR_WORD_SIZE) <= end ; bit += BITSTR_WORD_SIZE) {
-		count += hweight(b[_bit_word(bit)]);
+	if ((bit + BITSTR_WORD_SIZE) <= end) {
+		bitoff_t full_words = (end - bit) >> BITSTR_SHIFT;
+
+		count += _count_words(&b[_bit_word(bit)], full_words);
+		bit += full_words * BITSTR_WORD_SIZE;
 	}
 	if (bit < end) {
 		uint64_t mask = _bit_nmask(end);
@@ -985,26 +1063,28 @@ static int32_t _bit_overlap_internal(bitstr_t *b1, bitstr_t *b2, bool count_it)
 {
 	int32_t count = 0;
 	int64_t anded;
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit_cnt, word, full_words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
 	bit_cnt = _bitstr_bits(b1);
-	for (bit = 0; bit < bit_cnt; bit += BITSTR_WORD_SIZE) {
-		if ((bit + BITSTR_WORD_SIZE - 1) >= bit_cnt)
-			break;
-		anded = b1[_bit_word(bit)] & b2[_bit_word(bit)];
-		if (count_it)
-			count += hweight(anded);
-		else if (anded)
-			return 1;
+	full_words = _bit_word(bit_cnt);
+	if (count_it) {
+		count = _count_and_words(&b1[BITSTR_OVERHEAD],
+					 &b2[BITSTR_OVERHEAD],
+					 (full_words - BITSTR_OVERHEAD));
+	} else {
+		for (word = BITSTR_OVERHEAD; word < full_words; word++) {
+			if (b1[word] & b2[word])
+				return 1;
+		}
 	}
 
-	if (bit < bit_cnt) {
+	if (bit_cnt & BITSTR_MAXPOS) {
 		uint64_t mask = _bit_nmask(bit_cnt);
-		anded = b1[_bit_word(bit)] & b2[_bit_word(bit)] & mask;
+		anded = b1[full_words] & b2[full_words] & mask;
 		if (count_it)
 			count += hweight(anded);
 		else if (anded)
@@ -1031,6 +1111,72 @@ extern int32_t bit_overlap_any(bitstr_t *b1, bitstr_t *b2)
 	return _bit_overlap_internal(b1, b2, 0);
 }
 
+/*
+ * return the first bit set in both b1 and b2, -1 if no overlap
+ * Same as bit_ffs() of (b1 & b2) without a temporary bitmap.
+ */
+extern bitoff_t bit_overlap_ffs(bitstr_t *b1, bitstr_t *b2)
+{
+	bitoff_t bit_cnt, bit, word, words;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
+
+	bit_cnt = _bitstr_bits(b1);
+	words = _bitstr_words(bit_cnt);
+	for (word = BITSTR_OVERHEAD; word < words; word++) {
+		bitstr_t anded = b1[word] & b2[word];
+
+		if ((word == (words - 1)) && (bit_cnt & BITSTR_MAXPOS))
+			anded &= _bit_nmask(bit_cnt);
+		if (!anded)
+			continue;
+
+		bit = (word - BITSTR_OVERHEAD) << BITSTR_SHIFT;
+#if HAVE___BUILTIN_CLZLL && (defined SLURM_BIGENDIAN)
+		return bit + __builtin_clzll(anded);
+#elif HAVE___BUILTIN_CTZLL && (!defined SLURM_BIGENDIAN)
+		return bit + __builtin_ctzll(anded);
+#else
+		while (!(anded & _bit_mask(bit)))
+			bit++;
+		return bit;
+#endif
+	}
+
+	return -1;
+}
+
+/*
+ * return number of bits set in both b1 and b2 but not in b3
+ * Same as bit_set_count() of (b1 & b2 & ~b3) without a temporary bitmap.
+ */
+extern int32_t bit_overlap_and_not(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3)
+{
+	int32_t count;
+	bitoff_t bit_cnt, full_words;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	_assert_bitstr_valid(b3);
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b3));
+
+	bit_cnt = _bitstr_bits(b1);
+	full_words = _bit_word(bit_cnt);
+	count = _count_and_not_words(&b1[BITSTR_OVERHEAD], &b2[BITSTR_OVERHEAD],
+				     &b3[BITSTR_OVERHEAD],
+				     (full_words - BITSTR_OVERHEAD));
+	if (bit_cnt & BITSTR_MAXPOS) {
+		uint64_t mask = _bit_nmask(bit_cnt);
+		count += hweight(b1[full_words] & b2[full_words] &
+				 ~b3[full_words] & mask);
+	}
+
+	return count;
+}
+
 /*
  * Count the number of bits clear in bitstring.
  *   b (IN)		bitstring to check
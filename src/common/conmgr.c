@@ -333,6 +333,7 @@ struct {
 typedef struct {
 	int magic; /* MAGIC_POLL_ARGS */
 	struct pollfd *fds;
+	conmgr_fd_t **cons; /* connection polled by matching entry in fds */
 	int nfds;
 } poll_args_t;
 
@@ -1820,8 +1821,7 @@ static void _on_signal_alarm(conmgr_fd_t *con, conmgr_work_type_t type,
  *
  * NOTE: mgr mutex must not be locked but will be locked upon return
  */
-static void _poll(poll_args_t *args, list_t *fds, on_poll_event_t on_poll,
-		  const char *tag)
+static void _poll(poll_args_t *args, on_poll_event_t on_poll, const char *tag)
 {
 	int rc = SLURM_SUCCESS;
 	struct pollfd *fds_ptr = NULL;
@@ -1869,8 +1869,19 @@ again:
 			_handle_event_pipe(fds_ptr, tag, "CAUGHT_SIGNAL");
 		} else if (fds_ptr->fd == event_fd)
 			_handle_event_pipe(fds_ptr, tag, "CHANGE_EVENT");
-		else if ((con = list_find_first(fds, _find_by_fd,
-						&fds_ptr->fd))) {
+		else if ((con = args->cons[i])) {
+			/*
+			 * Connections are only freed while no poll() is
+			 * active, but the fd may have been closed since.
+			 */
+			slurm_mutex_lock(&mgr.mutex);
+			if (!_find_by_fd(con, &fds_ptr->fd)) {
+				slurm_mutex_unlock(&mgr.mutex);
+				log_flag(NET, "%s: [%s] unable to find connection for fd=%u",
+					 __func__, tag, fds_ptr->fd);
+				continue;
+			}
+
 			if (slurm_conf.debug_flags & DEBUG_FLAG_NET) {
 				char *flags = poll_revents_to_str(
 					fds_ptr->revents);
@@ -1878,7 +1889,6 @@ again:
 					 __func__, tag, con->name, flags);
 				xfree(flags);
 			}
-			slurm_mutex_lock(&mgr.mutex);
 			on_poll(fds_ptr->fd, con, fds_ptr->revents);
 			/*
 			 * signal that something might have happened and to
@@ -1927,6 +1937,7 @@ static void _poll_connections(void *x)
 	}
 
 	xrecalloc(args->fds, ((count * 2) + 2), sizeof(*args->fds));
+	xrecalloc(args->cons, ((count * 2) + 2), sizeof(*args->cons));
 
 	args->nfds = 0;
 	fds_ptr = args->fds;
@@ -1934,12 +1945,14 @@ static void _poll_connections(void *x)
 	/* Add signal fd */
 	fds_ptr->fd = mgr.signal_fd[0];
 	fds_ptr->events = POLLIN;
+	args->cons[args->nfds] = NULL;
 	fds_ptr++;
 	args->nfds++;
 
 	/* Add event fd */
 	fds_ptr->fd = mgr.event_fd[0];
 	fds_ptr->events = POLLIN;
+	args->cons[args->nfds] = NULL;
 	fds_ptr++;
 	args->nfds++;
 
@@ -1966,6 +1979,7 @@ static void _poll_connections(void *x)
 			if (!list_is_empty(con->out))
 				fds_ptr->events |= POLLOUT;
 
+			args->cons[args->nfds] = con;
 			fds_ptr++;
 			args->nfds++;
 		} else {
@@ -1976,6 +1990,7 @@ static void _poll_connections(void *x)
 			if (con->input_fd != -1) {
 				fds_ptr->fd = con->input_fd;
 				fds_ptr->events = POLLIN;
+				args->cons[args->nfds] = con;
 				fds_ptr++;
 				args->nfds++;
 			}
@@ -1983,6 +1998,7 @@ static void _poll_connections(void *x)
 			if (!list_is_empty(con->out)) {
 				fds_ptr->fd = con->output_fd;
 				fds_ptr->events = POLLOUT;
+				args->cons[args->nfds] = con;
 				fds_ptr++;
 				args->nfds++;
 			}
@@ -2001,7 +2017,7 @@ static void _poll_connections(void *x)
 	log_flag(NET, "%s: polling %u file descriptors for %u connections",
 		 __func__, args->nfds, count);
 
-	_poll(args, mgr.connections, _handle_poll_event, __func__);
+	_poll(args, _handle_poll_event, __func__);
 
 	slurm_mutex_lock(&mgr.mutex);
 done:
@@ -2059,18 +2075,21 @@ static void _listen(void *x)
 	}
 
 	xrecalloc(args->fds, (count + 2), sizeof(*args->fds));
+	xrecalloc(args->cons, (count + 2), sizeof(*args->cons));
 	fds_ptr = args->fds;
 	args->nfds = 0;
 
 	/* Add signal fd */
 	fds_ptr->fd = mgr.signal_fd[0];
 	fds_ptr->events = POLLIN;
+	args->cons[args->nfds] = NULL;
 	fds_ptr++;
 	args->nfds++;
 
 	/* Add event fd */
 	fds_ptr->fd = mgr.event_fd[0];
 	fds_ptr->events = POLLIN;
+	args->cons[args->nfds] = NULL;
 	fds_ptr++;
 	args->nfds++;
 
@@ -2083,6 +2102,7 @@ static void _listen(void *x)
 
 		fds_ptr->fd = con->input_fd;
 		fds_ptr->events = POLLIN;
+		args->cons[args->nfds] = con;
 
 		log_flag(NET, "%s: [%s] listening", __func__, con->name);
 
@@ -2103,7 +2123,7 @@ static void _listen(void *x)
 		 __func__, args->nfds, (count + 2));
 
 	/* _poll() will lock mgr.mutex */
-	_poll(args, mgr.listen, _handle_listen_event, __func__);
+	_poll(args, _handle_listen_event, __func__);
 
 	slurm_mutex_lock(&mgr.mutex);
 cleanup:
@@ -2326,6 +2346,7 @@ quiesced:
 		xassert(poll_args->magic == MAGIC_POLL_ARGS);
 		poll_args->magic = ~MAGIC_POLL_ARGS;
 		xfree(poll_args->fds);
+		xfree(poll_args->cons);
 		xfree(poll_args);
 	}
 
@@ -2333,6 +2354,7 @@ quiesced:
 		xassert(listen_args->magic == MAGIC_POLL_ARGS);
 		listen_args->magic = ~MAGIC_POLL_ARGS;
 		xfree(listen_args->fds);
+		xfree(listen_args->cons);
 		xfree(listen_args);
 	}
 }
@@ -51,6 +51,8 @@
 #define DATA_MAGIC 0x1992189F
 #define DATA_LIST_MAGIC 0x1992F89F
 #define DATA_LIST_NODE_MAGIC 0x1921F89F
+/* Dictionaries with at least this many entries get a hashed key index */
+#define DATA_DICT_INDEX_MIN 32
 
 typedef struct data_list_s data_list_t;
 typedef struct data_list_node_s data_list_node_t;
@@ -93,7 +95,9 @@ typedef struct data_list_node_s {
 	data_list_node_t *next;
 
 	data_t *data;
-	char *key; /* key for dictionary (only) */
+	char *key; /* key for dictionary (only) - points to key_buf */
+	uint32_t hash; /* hash of key */
+	char key_buf[]; /* key stored with node to avoid extra allocation */
 } data_list_node_t;
 
 /* Single linked list for list_u and dict_u */
@@ -103,6 +107,13 @@ typedef struct data_list_s {
 
 	data_list_node_t *begin;
 	data_list_node_t *end;
+
+	/*
+	 * Open addressed hash index of dictionary nodes by key.
+	 * Only built once a dictionary reaches DATA_DICT_INDEX_MIN entries.
+	 */
+	data_list_node_t **index;
+	size_t index_size; /* always power of 2 */
 } data_list_t;
 
 /*
@@ -145,6 +156,7 @@ typedef struct {
 } convert_args_t;
 
 static void _check_magic(const data_t *data);
+static void _check_data_list_node_magic(const data_list_node_t *dn);
 static void _release(data_t *data);
 static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn);
 static size_t _convert_tree(data_t *data, const type_t match);
@@ -161,6 +173,87 @@ static data_list_t *_data_list_new(void)
 	return dl;
 }
 
+/* FNV-1a */
+static uint32_t _key_hash(const char *key)
+{
+	uint32_t hash = 2166136261U;
+
+	for (; *key; key++) {
+		hash ^= (unsigned char) *key;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static void _index_insert(data_list_t *dl, data_list_node_t *dn)
+{
+	size_t mask = dl->index_size - 1;
+	size_t i = dn->hash & mask;
+
+	while (dl->index[i])
+		i = (i + 1) & mask;
+
+	dl->index[i] = dn;
+}
+
+/* (Re)build index to keep load factor under 1/2 */
+static void _index_build(data_list_t *dl)
+{
+	size_t size = DATA_DICT_INDEX_MIN * 2;
+
+	while (size < (dl->count * 2))
+		size *= 2;
+
+	xfree(dl->index);
+	dl->index = xcalloc(size, sizeof(*dl->index));
+	dl->index_size = size;
+
+	for (data_list_node_t *i = dl->begin; i; i = i->next)
+		_index_insert(dl, i);
+}
+
+static void _index_add(data_list_t *dl, data_list_node_t *dn)
+{
+	if (!dn->key)
+		return;
+
+	if (!dl->index) {
+		if (dl->count >= DATA_DICT_INDEX_MIN)
+			_index_build(dl);
+	} else if ((dl->count * 2) > dl->index_size) {
+		_index_build(dl);
+	} else {
+		_index_insert(dl, dn);
+	}
+}
+
+/* Find dictionary node by key */
+static data_list_node_t *_dict_find(const data_list_t *dl, const char *key)
+{
+	uint32_t hash = _key_hash(key);
+
+	if (dl->index) {
+		size_t mask = dl->index_size - 1;
+
+		for (size_t i = hash & mask; dl->index[i]; i = (i + 1) & mask)
+			if ((dl->index[i]->hash == hash) &&
+			    !xstrcmp(key, dl->index[i]->key))
+				return dl->index[i];
+
+		return NULL;
+	}
+
+	for (data_list_node_t *i = dl->begin; i; i = i->next) {
+		_check_data_list_node_magic(i);
+
+		if ((i->hash == hash) && !xstrcmp(key, i->key))
+			return i;
+	}
+
+	return NULL;
+}
+
 static void _check_data_list_node_magic(const data_list_node_t *dn)
 {
 	xassert(dn);
@@ -226,7 +319,8 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 		 __func__, (uintptr_t) dl, dl->count);
 
 	/* walk list to find new previous */
-	for (prev = dl->begin; prev && prev->next != dn; ) {
+	for (prev = ((dn == dl->begin) ? NULL : dl->begin);
+	     prev && prev->next != dn; ) {
 		_check_data_list_node_magic(prev);
 		prev = prev->next;
 		if (prev)
@@ -260,7 +354,18 @@ static void _release_data_list_node(data_list_t *dl, data_list_node_t *dn)
 
 	dl->count--;
 	FREE_NULL_DATA(dn->data);
-	xfree(dn->key);
+
+	/*
+	 * Removing from an open addressed table requires rehashing the rest of
+	 * the cluster. Removal is rare so just drop the index and let it be
+	 * rebuilt if the dictionary grows again.
+	 */
+	if (dl->index) {
+		xfree(dl->index);
+		dl->index_size = 0;
+		if (dl->count >= DATA_DICT_INDEX_MIN)
+			_index_build(dl);
+	}
 
 	dn->magic = ~DATA_LIST_NODE_MAGIC;
 	xfree(dn);
@@ -284,6 +389,10 @@ static void _release_data_list(data_list_t *dl)
 
 	xassert(dl->end);
 
+	/* avoid rebuilding index while removing every node */
+	xfree(dl->index);
+	dl->index_size = 0;
+
 	while((i = n)) {
 		n = i->next;
 		_release_data_list_node(dl, i);
@@ -310,14 +419,17 @@ finish:
  */
 static data_list_node_t *_new_data_list_node(data_t *d, const char *key)
 {
-	data_list_node_t *dn = xmalloc(sizeof(*dn));
+	size_t key_len = (key ? (strlen(key) + 1) : 0);
+	data_list_node_t *dn = xmalloc(sizeof(*dn) + key_len);
 	dn->magic = DATA_LIST_NODE_MAGIC;
 
 	_check_magic(d);
 
 	dn->data = d;
 	if (key) {
-		dn->key = xstrdup(key);
+		memcpy(dn->key_buf, key, key_len);
+		dn->key = dn->key_buf;
+		dn->hash = _key_hash(key);
 
 		log_flag(DATA, "%s: new dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
 			 __func__, (uintptr_t) dn, dn->key, dn->data);
@@ -349,6 +461,7 @@ static void _data_list_append(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_index_add(dl, n);
 
 	if (n->key)
 		log_flag(DATA, "%s: append dictionary entry data-list-node(0x%"PRIxPTR")[%s]=%pD",
@@ -375,6 +488,7 @@ static void _data_list_prepend(data_list_t *dl, data_t *d, const char *key)
 	}
 
 	dl->count++;
+	_index_add(dl, n);
 
 	log_flag(DATA, "%s: prepend %pD[%s]->data-list-node(0x%"PRIxPTR")[%s]=%pD",
 		 __func__, d, key, (uintptr_t) n, n->key, n->data);
@@ -765,31 +879,15 @@ extern const data_t *data_key_get_const(const data_t *data, const char *key)
 		return NULL;
 
 	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
-
-	if (i)
+	if ((i = _dict_find(data->data.dict_u, key)))
 		return i->data;
 	else
 		return NULL;
 }
 
-static bool _match_string(const char *key, data_t *data, void *needle_ptr)
-{
-	const char *needle = needle_ptr;
-	return !xstrcmp(key, needle);
-}
-
 extern data_t *data_key_get(data_t *data, const char *key)
 {
-	return data_dict_find_first(data, _match_string, (void *) key);
+	return (data_t *) data_key_get_const(data, key);
 }
 
 extern data_t *data_key_get_int(data_t *data, int64_t key)
@@ -926,15 +1024,7 @@ extern bool data_key_unset(data_t *data, const char *key)
 		return NULL;
 
 	_check_data_list_magic(data->data.dict_u);
-	i = data->data.dict_u->begin;
-	while (i) {
-		_check_data_list_node_magic(i);
-
-		if (!xstrcmp(key, i->key))
-			break;
-
-		i = i->next;
-	}
+	i = _dict_find(data->data.dict_u, key);
 
 	if (!i) {
 		log_flag(DATA, "%s: remove non-existent key in %pD[%s]",
@@ -44,6 +44,10 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
 #ifndef POLLRDHUP
 #define POLLRDHUP POLLHUP
 #endif
@@ -81,6 +85,22 @@ strong_alias(eio_signal_wakeup,		slurm_eio_signal_wakeup);
  * it wakes up.
  */
 #define EIO_MAGIC 0xe1e10
+
+/* fd_table[].events of an fd epoll refused (e.g. regular file) */
+#define EIO_NO_EPOLL 0xffffffff
+
+/*
+ * Objects stay registered with epoll across mainloop iterations, so only the
+ * objects whose readable()/writable() answer changed cost a system call and
+ * only the ready ones are dispatched. fd_table is indexed by fd.
+ */
+typedef struct {
+	eio_obj_t *obj;		/* object owning the registration */
+	uint32_t events;	/* registered poll events, 0 if none */
+	uint32_t gen;		/* iteration the object last claimed the fd */
+	bool listed;		/* fd is in reg_fds */
+} eio_fd_t;
+
 struct eio_handle_components {
 	int  magic;
 	int  fds[2];
@@ -89,19 +109,27 @@ struct eio_handle_components {
 	uint16_t shutdown_wait;
 	List obj_list;
 	List new_objs;
+	int epoll_fd;		/* -1 if every object is poll()ed */
+	eio_fd_t *fd_table;
+	int fd_table_size;
+	int *reg_fds;		/* fds with a fd_table entry in use */
+	int reg_cnt;
+	uint32_t gen;
 };
 
 typedef struct {
-	eio_obj_t **map;
-	unsigned int *nfds_ptr;
+	eio_handle_t *eio;
+	unsigned int active;	/* objects waiting for any event */
+	unsigned int nfds;	/* objects to poll() */
+	unsigned int max_nfds;
 	struct pollfd *pfds;
-} foreach_pollfd_t;
+	eio_obj_t **map;
+} foreach_setup_t;
 
 /* Function prototypes */
 
 static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
-				   time_t shutdown_time);
-static unsigned int _poll_setup_pollfds(struct pollfd *, eio_obj_t **, List);
+				   int timeout);
 static void         _poll_dispatch(struct pollfd *, unsigned int, eio_obj_t **,
 		                   List objList);
 static void         _poll_handle_event(short revents, eio_obj_t *obj,
@@ -121,6 +149,27 @@ eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
 
 	fd_set_nonblocking(eio->fds[0]);
 
+	eio->epoll_fd = -1;
+#if defined(__linux__)
+	if ((eio->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		debug("%s: epoll_create1: %m, falling back to poll",
+		      __func__);
+	} else {
+		struct epoll_event ev = {
+			.events = EPOLLIN,
+			.data.fd = eio->fds[0],
+		};
+
+		if (epoll_ctl(eio->epoll_fd, EPOLL_CTL_ADD, eio->fds[0],
+			      &ev) < 0) {
+			debug("%s: epoll_ctl: %m, falling back to poll",
+			      __func__);
+			close(eio->epoll_fd);
+			eio->epoll_fd = -1;
+		}
+	}
+#endif
+
 	eio->obj_list = list_create(eio_obj_destroy);
 	eio->new_objs = list_create(eio_obj_destroy);
 
@@ -138,6 +187,10 @@ void eio_handle_destroy(eio_handle_t *eio)
 	xassert(eio->magic == EIO_MAGIC);
 	close(eio->fds[0]);
 	close(eio->fds[1]);
+	if (eio->epoll_fd >= 0)
+		close(eio->epoll_fd);
+	xfree(eio->fd_table);
+	xfree(eio->reg_fds);
 	FREE_NULL_LIST(eio->obj_list);
 	FREE_NULL_LIST(eio->new_objs);
 	slurm_mutex_destroy(&eio->shutdown_mutex);
@@ -268,59 +321,324 @@ static int _eio_wakeup_handler(eio_handle_t *eio)
 	return 0;
 }
 
+static bool _is_writable(eio_obj_t *obj)
+{
+	return (obj->ops->writable && (*obj->ops->writable)(obj));
+}
+
+static bool _is_readable(eio_obj_t *obj)
+{
+	return (obj->ops->readable && (*obj->ops->readable)(obj));
+}
+
+#if defined(__linux__)
+static uint32_t _epoll_events(short events)
+{
+	uint32_t ev = 0;
+
+	if (events & POLLIN)
+		ev |= EPOLLIN;
+	if (events & POLLOUT)
+		ev |= EPOLLOUT;
+	if (events & POLLRDHUP)
+		ev |= EPOLLRDHUP;
+
+	return ev;
+}
+
+static short _poll_revents(uint32_t ev)
+{
+	short revents = 0;
+
+	if (ev & EPOLLIN)
+		revents |= POLLIN;
+	if (ev & EPOLLOUT)
+		revents |= POLLOUT;
+	if (ev & EPOLLRDHUP)
+		revents |= POLLRDHUP;
+	if (ev & EPOLLHUP)
+		revents |= POLLHUP;
+	if (ev & EPOLLERR)
+		revents |= POLLERR;
+
+	return revents;
+}
+#endif
+
+/* Drop the epoll registration of fd, the fd may already be closed */
+static void _epoll_del(eio_handle_t *eio, int fd)
+{
+	eio_fd_t *e = &eio->fd_table[fd];
+
+#if defined(__linux__)
+	if (e->events && (e->events != EIO_NO_EPOLL))
+		(void) epoll_ctl(eio->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+#endif
+	e->obj = NULL;
+	e->events = 0;
+}
+
+static void _unregister(eio_handle_t *eio, eio_obj_t *obj)
+{
+	if (obj->reg_fd < 0)
+		return;
+
+	if ((obj->reg_fd < eio->fd_table_size) &&
+	    (eio->fd_table[obj->reg_fd].obj == obj))
+		_epoll_del(eio, obj->reg_fd);
+
+	obj->reg_fd = -1;
+}
+
+/*
+ * Register obj with epoll for events, reusing the registration left by the
+ * previous iteration when nothing changed.
+ * RET true if registered or false if obj must be poll()ed instead
+ */
+static bool _register(eio_handle_t *eio, eio_obj_t *obj, short events)
+{
+#if defined(__linux__)
+	struct epoll_event ev;
+	eio_fd_t *e;
+	int rc;
+
+	if (eio->epoll_fd < 0)
+		return false;
+
+	if (obj->reg_fd != obj->fd)
+		_unregister(eio, obj);
+
+	if (obj->fd >= eio->fd_table_size) {
+		int size = MAX(obj->fd + 1, eio->fd_table_size * 2);
+
+		xrecalloc(eio->fd_table, size, sizeof(*eio->fd_table));
+		xrecalloc(eio->reg_fds, size, sizeof(*eio->reg_fds));
+		eio->fd_table_size = size;
+	}
+	e = &eio->fd_table[obj->fd];
+
+	/* Another object already waits on this fd in this iteration */
+	if ((e->gen == eio->gen) && e->obj && (e->obj != obj))
+		return false;
+
+	if ((e->obj == obj) && (obj->reg_fd == obj->fd)) {
+		e->gen = eio->gen;
+		if (e->events == EIO_NO_EPOLL)
+			return false;
+		if (e->events == events)
+			return true;
+	}
+
+	ev.events = _epoll_events(events);
+	ev.data.fd = obj->fd;
+
+	/*
+	 * A registration left by another object may be gone if that object
+	 * closed the fd, and one may be left over if it did not.
+	 */
+	rc = epoll_ctl(eio->epoll_fd,
+		       ((e->events && (e->events != EIO_NO_EPOLL)) ?
+			EPOLL_CTL_MOD : EPOLL_CTL_ADD), obj->fd, &ev);
+	if (rc && (errno == ENOENT))
+		rc = epoll_ctl(eio->epoll_fd, EPOLL_CTL_ADD, obj->fd, &ev);
+	else if (rc && (errno == EEXIST))
+		rc = epoll_ctl(eio->epoll_fd, EPOLL_CTL_MOD, obj->fd, &ev);
+
+	if (!e->listed) {
+		eio->reg_fds[eio->reg_cnt++] = obj->fd;
+		e->listed = true;
+	}
+	e->obj = obj;
+	e->gen = eio->gen;
+	obj->reg_fd = obj->fd;
+
+	if (rc) {
+		/* EPERM for regular files, poll() reports them ready */
+		if (errno != EPERM)
+			debug("%s: epoll_ctl(%d): %m", __func__, obj->fd);
+		e->events = EIO_NO_EPOLL;
+		return false;
+	}
+
+	e->events = events;
+	return true;
+#else
+	return false;
+#endif
+}
+
+/* Drop the registrations of the objects which left the list */
+static void _purge_registrations(eio_handle_t *eio)
+{
+	for (int i = 0; i < eio->reg_cnt;) {
+		int fd = eio->reg_fds[i];
+		eio_fd_t *e = &eio->fd_table[fd];
+
+		if (e->obj && (e->gen == eio->gen)) {
+			i++;
+			continue;
+		}
+
+		if (e->obj)
+			_epoll_del(eio, fd);
+		e->listed = false;
+		eio->reg_fds[i] = eio->reg_fds[--eio->reg_cnt];
+	}
+}
+
+static int _foreach_setup(void *x, void *arg)
+{
+	eio_obj_t *obj = x;
+	foreach_setup_t *args = arg;
+	bool readable, writable;
+	short events = 0;
+
+	writable = _is_writable(obj);
+	readable = _is_readable(obj);
+	if (writable && readable)
+		events = POLLOUT | POLLIN | POLLHUP | POLLRDHUP;
+	else if (readable)
+		events = POLLIN | POLLRDHUP;
+	else if (writable)
+		events = POLLOUT | POLLHUP;
+
+	if (!events) {
+		_unregister(args->eio, obj);
+		return 0;
+	}
+
+	args->active++;
+
+	if ((obj->fd >= 0) && _register(args->eio, obj, events))
+		return 0;
+
+	if (args->nfds >= args->max_nfds) {
+		args->max_nfds = MAX(16, args->max_nfds * 2);
+		xrecalloc(args->pfds, args->max_nfds + 1,
+			  sizeof(*args->pfds));
+		xrecalloc(args->map, args->max_nfds + 1, sizeof(*args->map));
+	}
+
+	/* Slot 0 is for the epoll fd or the signaling fd */
+	args->nfds++;
+	args->pfds[args->nfds].fd = obj->fd;
+	args->pfds[args->nfds].events = events;
+	args->pfds[args->nfds].revents = 0;
+	args->map[args->nfds] = obj;
+
+	return 0;
+}
+
 int eio_handle_mainloop(eio_handle_t *eio)
 {
 	int            retval  = 0;
-	struct pollfd *pollfds = NULL;
-	eio_obj_t    **map     = NULL;
-	unsigned int   maxnfds = 0, nfds = 0;
-	unsigned int   n       = 0;
+	foreach_setup_t args = { 0 };
 	time_t shutdown_time;
+#if defined(__linux__)
+	struct epoll_event *events = NULL;
+	int max_events = 0;
+#endif
 
 	xassert (eio != NULL);
 	xassert (eio->magic == EIO_MAGIC);
 
+	args.eio = eio;
+	args.max_nfds = 16;
+	args.pfds = xcalloc(args.max_nfds + 1, sizeof(*args.pfds));
+	args.map = xcalloc(args.max_nfds + 1, sizeof(*args.map));
+
 	while (1) {
-		/* Alloc memory for pfds and map if needed */
-		n = list_count(eio->obj_list);
-		if (maxnfds < n) {
-			maxnfds = n;
-			xrealloc(pollfds, (maxnfds+1) * sizeof(struct pollfd));
-			xrealloc(map, maxnfds * sizeof(eio_obj_t *));
-			/*
-			 * Note: xrealloc() also handles initial malloc
-			 */
-		}
-		if (!pollfds)  /* Fix for CLANG false positive */
-			goto done;
+		bool wakeup = false;
+		int timeout;
+#if defined(__linux__)
+		int nevents = 0;
+#endif
 
 		debug4("eio: handling events for %d objects",
 		       list_count(eio->obj_list));
-		nfds = _poll_setup_pollfds(pollfds, map, eio->obj_list);
-		if (nfds <= 0)
-			goto done;
 
-		/*
-		 *  Setup eio handle signaling fd
-		 */
-		pollfds[nfds].fd     = eio->fds[0];
-		pollfds[nfds].events = POLLIN;
-		nfds++;
-
-		xassert(nfds <= maxnfds + 1);
+		eio->gen++;
+		args.active = 0;
+		args.nfds = 0;
+		list_for_each(eio->obj_list, _foreach_setup, &args);
+		_purge_registrations(eio);
+		if (!args.active)
+			goto done;
 
 		/* Get shutdown_time to pass to _poll_internal */
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
 		slurm_mutex_unlock(&eio->shutdown_mutex);
-		if (_poll_internal(pollfds, nfds, shutdown_time) < 0)
-			goto error;
+		if (shutdown_time)
+			timeout = 1000;	/* Return every 1000 msec */
+		else
+			timeout = -1;
+
+		/*
+		 * Objects epoll can not take are poll()ed along with the epoll
+		 * fd, which then only needs a non-blocking epoll_wait().
+		 */
+		if (eio->epoll_fd >= 0) {
+			args.pfds[0].fd = eio->epoll_fd;
+			args.pfds[0].events = POLLIN;
+		} else {
+			args.pfds[0].fd = eio->fds[0];
+			args.pfds[0].events = POLLIN;
+		}
+		args.pfds[0].revents = 0;
+
+		if (args.nfds || (eio->epoll_fd < 0)) {
+			if (_poll_internal(args.pfds, args.nfds + 1,
+					   timeout) < 0)
+				goto error;
+			timeout = 0;
+		}
+
+		if (eio->epoll_fd < 0)
+			wakeup = (args.pfds[0].revents & POLLIN);
+#if defined(__linux__)
+		else if (!args.nfds || (args.pfds[0].revents & POLLIN)) {
+			if (max_events < (args.active + 1)) {
+				max_events = args.active + 1;
+				xrecalloc(events, max_events, sizeof(*events));
+			}
+
+			while ((nevents = epoll_wait(eio->epoll_fd, events,
+						     max_events,
+						     timeout)) < 0) {
+				if (errno == EINTR) {
+					nevents = 0;
+					break;
+				}
+				error("epoll_wait: %m");
+				goto error;
+			}
+
+			for (int i = 0; i < nevents; i++) {
+				if (events[i].data.fd == eio->fds[0])
+					wakeup = true;
+			}
+		}
+#endif
 
 		/* See if we've been told to shut down by eio_signal_shutdown */
-		if (pollfds[nfds-1].revents & POLLIN)
+		if (wakeup)
 			_eio_wakeup_handler(eio);
 
-		_poll_dispatch(pollfds, nfds - 1, map, eio->obj_list);
+#if defined(__linux__)
+		for (int i = 0; i < nevents; i++) {
+			int fd = events[i].data.fd;
+			eio_obj_t *obj;
+
+			if ((fd == eio->fds[0]) || (fd >= eio->fd_table_size) ||
+			    !(obj = eio->fd_table[fd].obj))
+				continue;
+			_poll_handle_event(_poll_revents(events[i].events), obj,
+					   eio->obj_list);
+		}
+#endif
+		_poll_dispatch(&args.pfds[1], args.nfds, &args.map[1],
+			       eio->obj_list);
 
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
@@ -336,20 +654,19 @@ int eio_handle_mainloop(eio_handle_t *eio)
 error:
 	retval = -1;
 done:
-	xfree(pollfds);
-	xfree(map);
+	xfree(args.pfds);
+	xfree(args.map);
+#if defined(__linux__)
+	xfree(events);
+#endif
 	return retval;
 }
 
 static int _poll_internal(struct pollfd *pfds, unsigned int nfds,
-			  time_t shutdown_time)
+			  int timeout)
 {
-	int n, timeout;
+	int n;
 
-	if (shutdown_time)
-		timeout = 1000;	/* Return every 1000 msec during shutdown */
-	else
-		timeout = -1;
 	while ((n = poll(pfds, nfds, timeout)) < 0) {
 		switch (errno) {
 		case EINTR:
@@ -365,67 +682,6 @@ static int _poll_internal(struct pollfd *pfds, unsigned int nfds,
 	return n;
 }
 
-static bool _is_writable(eio_obj_t *obj)
-{
-	return (obj->ops->writable && (*obj->ops->writable)(obj));
-}
-
-static bool _is_readable(eio_obj_t *obj)
-{
-	return (obj->ops->readable && (*obj->ops->readable)(obj));
-}
-
-static int _foreach_helper_setup_pollfds(void *x, void *arg)
-{
-	eio_obj_t *obj = x;
-	foreach_pollfd_t *hargs = arg;
-	struct pollfd *pfds = hargs->pfds;
-	eio_obj_t **map = hargs->map;
-	unsigned int nfds = *hargs->nfds_ptr;
-	bool readable, writable;
-
-	writable = _is_writable(obj);
-	readable = _is_readable(obj);
-	if (writable && readable) {
-		pfds[nfds].fd     = obj->fd;
-		pfds[nfds].events = POLLOUT | POLLIN | POLLHUP | POLLRDHUP;
-		map[nfds]         = obj;
-	} else if (readable) {
-		pfds[nfds].fd     = obj->fd;
-		pfds[nfds].events = POLLIN | POLLRDHUP;
-		map[nfds]         = obj;
-	} else if (writable) {
-		pfds[nfds].fd     = obj->fd;
-		pfds[nfds].events = POLLOUT | POLLHUP;
-		map[nfds]         = obj;
-	}
-
-	if (writable || readable)
-		(*hargs->nfds_ptr)++;
-
-	return 0;
-}
-
-static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
-					List l)
-{
-	unsigned int  nfds = 0;
-	foreach_pollfd_t args = {
-		.pfds = pfds,
-		.map = map,
-		.nfds_ptr = &nfds
-	};
-
-	if (!pfds) {	/* Fix for CLANG false positive */
-		fatal("%s: pollfd data structure is null", __func__);
-		return nfds;
-	}
-
-	list_for_each(l, _foreach_helper_setup_pollfds, &args);
-
-	return nfds;
-}
-
 static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
 			   eio_obj_t *map[], List objList)
 {
@@ -516,6 +772,7 @@ eio_obj_t *eio_obj_create(int fd, struct io_operations *ops, void *arg)
 	obj->arg = arg;
 	obj->ops = _ops_copy(ops);
 	obj->shutdown = false;
+	obj->reg_fd = -1;
 	return obj;
 }
 
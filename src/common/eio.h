@@ -67,6 +67,8 @@ struct eio_obj {
 	void *arg;                        /* application-specific data       */
 	struct io_operations *ops;        /* pointer to ops struct for obj   */
 	bool shutdown;
+	int reg_fd;                       /* fd registered with epoll, private
+					   * to eio.c                        */
 };
 
 eio_handle_t *eio_handle_create(uint16_t);
@@ -137,27 +137,88 @@ _find_name_in_env(char **env, const char *name)
 }
 
 /*
- *  Extend memory allocation for env by 1 entry. Make last entry == NULL.
- *   return pointer to last env entry;
+ *  Make room for 1 more entry in env, keeping it NULL terminated.
+ *   return pointer to the (NULL) entry following the last one;
+ *
+ *  The allocation grows geometrically, so the array may have several
+ *   trailing NULL entries. Never rely on xsize() for the entry count.
  */
 static char **
 _extend_env(char ***envp)
 {
-	char **ep;
-	size_t newcnt = (xsize (*envp) / sizeof (char *)) + 1;
+	size_t cnt = envcount (*envp);
+	size_t size = xsize (*envp) / sizeof (char *);
 
-	*envp = xrealloc (*envp, newcnt * sizeof (char *));
+	if ((cnt + 2) > size)
+		xrecalloc (*envp, MAX(size * 2, cnt + 2), sizeof (char *));
 
-	(*envp)[newcnt - 1] = NULL;
-	ep = &((*envp)[newcnt - 2]);
+	return (&(*envp)[cnt]);
+}
 
-	/*
-	 *  Find last non-NULL entry
-	 */
-	while (*ep == NULL)
-		--ep;
+/*
+ *  Hash index of the variable names in an environment array, used to merge
+ *   large environments without searching the destination for each variable.
+ */
+typedef struct {
+	int *slot;	/* offset in env + 1, 0 if unused */
+	uint32_t mask;
+} env_index_t;
+
+static size_t _env_name_len(const char *entry)
+{
+	const char *eq = strchr(entry, '=');
+
+	return eq ? (eq - entry) : strlen(entry);
+}
+
+static uint32_t _env_name_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261U;	/* FNV-1a */
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (unsigned char) name[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Return the index slot for the variable named by the first len bytes of
+ * entry, which must include the '='. The slot is 0 if the name is not in env.
+ */
+static int *_env_index_find(env_index_t *index, char **env, const char *entry,
+			    size_t len)
+{
+	uint32_t i = _env_name_hash(entry, len - 1) & index->mask;
 
-	return (++ep);
+	while (index->slot[i] &&
+	       strncmp(env[index->slot[i] - 1], entry, len))
+		i = (i + 1) & index->mask;
+
+	return &index->slot[i];
+}
+
+/* Index the first cnt entries of env, with room for up to max entries */
+static void _env_index_init(env_index_t *index, char **env, int cnt, int max)
+{
+	uint32_t size = 16;
+
+	while (size < (2 * max))
+		size <<= 1;
+	index->slot = xcalloc(size, sizeof(int));
+	index->mask = size - 1;
+
+	for (int i = 0; i < cnt; i++) {
+		size_t len = _env_name_len(env[i]);
+		int *slot;
+
+		if (env[i][len] != '=')
+			continue;	/* Malformed, never matched */
+		/* Keep the first of duplicate names, as _find_name_in_env() */
+		if (!*(slot = _env_index_find(index, env, env[i], len + 1)))
+			*slot = i + 1;
+	}
 }
 
 /* return true if the environment variables should not be set for
@@ -1811,25 +1872,71 @@ void env_unset_environment(void)
 }
 
 /*
- * Merge all of the environment variables in src_array into the
- * array dest_array.  Any variables already found in dest_array
- * will be overwritten with the value from src_array.
+ * Merge src_array into dest_array, overwriting variables already found in
+ * dest_array. Entries are subject to the same name and value length limits
+ * as _env_array_entry_splitter(). The destination is sized once and indexed
+ * by name so that merging is linear in the size of both arrays.
  */
-void env_array_merge(char ***dest_array, const char **src_array)
+static void _env_array_merge(char ***dest_array, const char **src_array,
+			     bool slurm_spank_only)
 {
-	char **ptr;
-	char name[256], *value;
+	char **env;
+	int cnt, max, spank_len = strlen(SPANK_OPTION_ENV_PREFIX);
+	bool created = false;
+	env_index_t index;
 
-	if (src_array == NULL)
+	if (!src_array || !dest_array)
 		return;
 
-	value = xmalloc(ENV_BUFSIZE);
-	for (ptr = (char **)src_array; *ptr != NULL; ptr++) {
-		if (_env_array_entry_splitter(*ptr, name, sizeof(name),
-					      value, ENV_BUFSIZE))
-			env_array_overwrite(dest_array, name, value);
+	if (!*dest_array) {
+		*dest_array = env_array_create();
+		created = true;
 	}
-	xfree(value);
+
+	cnt = envcount(*dest_array);
+	max = cnt + envcount((char **) src_array);
+	if (xsize(*dest_array) < ((max + 1) * sizeof(char *)))
+		xrecalloc(*dest_array, max + 1, sizeof(char *));
+	env = *dest_array;
+	_env_index_init(&index, env, cnt, max);
+
+	for (const char **ptr = src_array; *ptr; ptr++) {
+		const char *eq = strchr(*ptr, '=');
+		int *slot;
+
+		if (!eq || ((eq - *ptr) >= 256) ||
+		    (strlen(eq + 1) >= ENV_BUFSIZE))
+			continue;
+		if (slurm_spank_only &&
+		    xstrncmp(*ptr, "SLURM", 5) &&
+		    xstrncmp(*ptr, SPANK_OPTION_ENV_PREFIX, spank_len))
+			continue;
+
+		slot = _env_index_find(&index, env, *ptr, (eq - *ptr) + 1);
+		if (*slot) {
+			xfree(env[*slot - 1]);
+			env[*slot - 1] = xstrdup(*ptr);
+		} else {
+			env[cnt] = xstrdup(*ptr);
+			*slot = ++cnt;
+		}
+	}
+
+	xfree(index.slot);
+
+	/* Nothing merged, leave dest_array NULL as it was */
+	if (created && !cnt)
+		xfree(*dest_array);
+}
+
+/*
+ * Merge all of the environment variables in src_array into the
+ * array dest_array.  Any variables already found in dest_array
+ * will be overwritten with the value from src_array.
+ */
+void env_array_merge(char ***dest_array, const char **src_array)
+{
+	_env_array_merge(dest_array, src_array, false);
 }
 
 /*
@@ -1839,23 +1946,7 @@ void env_array_merge(char ***dest_array, const char **src_array)
  */
 void env_array_merge_slurm_spank(char ***dest_array, const char **src_array)
 {
-	char **ptr;
-	char name[256], *value;
-	int spank_len;
-
-	if (src_array == NULL)
-		return;
-
-	spank_len = strlen(SPANK_OPTION_ENV_PREFIX);
-	value = xmalloc(ENV_BUFSIZE);
-	for (ptr = (char **)src_array; *ptr != NULL; ptr++) {
-		if (_env_array_entry_splitter(*ptr, name, sizeof(name),
-					      value, ENV_BUFSIZE) &&
-		    ((xstrncmp(name, "SLURM", 5) == 0) ||
-		     (xstrncmp(name, SPANK_OPTION_ENV_PREFIX, spank_len) == 0)))
-			env_array_overwrite(dest_array, name, value);
-	}
-	xfree(value);
+	_env_array_merge(dest_array, src_array, true);
 }
 
 /*
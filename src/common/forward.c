@@ -53,12 +53,28 @@
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_interface.h"
 #include "src/common/slurm_protocol_pack.h"
+#include "src/common/workq.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
 static slurm_node_alias_addrs_t *last_alias_addrs = NULL;
 static pthread_mutex_t alias_addrs_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Persistent workers reused for forwarding instead of one new thread per
+ * forwarded child. Work only goes to the pool while a worker is free, so a
+ * forward is never queued behind blocked ones and eats into its timeout.
+ */
+#define FWD_POOL_THREADS 32
+static workq_t *fwd_pool = NULL;
+static int fwd_pool_busy = 0;
+static pthread_mutex_t fwd_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+	void *(*func)(void *arg);
+	void *arg;
+} fwd_work_t;
+
 typedef struct {
 	pthread_cond_t *notify;
 	int            *p_thr_count;
@@ -95,6 +111,56 @@ void _destroy_tree_fwd(fwd_tree_t *fwd_tree)
 	}
 }
 
+static void _fwd_pool_atfork_child(void)
+{
+	/* The workers do not exist in the child, abandon the pool */
+	fwd_pool = NULL;
+	fwd_pool_busy = 0;
+	slurm_mutex_init(&fwd_pool_mutex);
+}
+
+static void _fwd_pool_work(void *arg)
+{
+	fwd_work_t *work = arg;
+
+	(void) work->func(work->arg);
+	xfree(work);
+
+	slurm_mutex_lock(&fwd_pool_mutex);
+	fwd_pool_busy--;
+	slurm_mutex_unlock(&fwd_pool_mutex);
+}
+
+/* Run func(arg) on an idle pool worker, or on a new thread if none is idle */
+static void _fwd_run(void *(*func)(void *arg), void *arg, const char *tag)
+{
+	fwd_work_t *work;
+
+	slurm_mutex_lock(&fwd_pool_mutex);
+	if (!fwd_pool) {
+		fwd_pool = new_workq(FWD_POOL_THREADS);
+		pthread_atfork(NULL, NULL, _fwd_pool_atfork_child);
+	}
+	if (fwd_pool_busy >= FWD_POOL_THREADS) {
+		slurm_mutex_unlock(&fwd_pool_mutex);
+		slurm_thread_create_detached(func, arg);
+		return;
+	}
+	fwd_pool_busy++;
+	slurm_mutex_unlock(&fwd_pool_mutex);
+
+	work = xmalloc(sizeof(*work));
+	work->func = func;
+	work->arg = arg;
+	if (workq_add_work(fwd_pool, _fwd_pool_work, work, tag)) {
+		xfree(work);
+		slurm_mutex_lock(&fwd_pool_mutex);
+		fwd_pool_busy--;
+		slurm_mutex_unlock(&fwd_pool_mutex);
+		slurm_thread_create_detached(func, arg);
+	}
+}
+
 static int _forward_get_addr(forward_struct_t *fwd_struct, char *name,
 			     slurm_addr_t *address)
 {
@@ -413,6 +479,7 @@ static void *_fwd_tree_thread(void *arg)
 	send_msg.flags = fwd_tree->orig_msg->flags;
 	send_msg.data = fwd_tree->orig_msg->data;
 	send_msg.protocol_version = fwd_tree->orig_msg->protocol_version;
+	send_msg.auth_share = fwd_tree->orig_msg->auth_share;
 	if (fwd_tree->orig_msg->restrict_uid_set)
 		slurm_msg_set_r_uid(&send_msg,
 				    fwd_tree->orig_msg->restrict_uid);
@@ -579,7 +646,7 @@ static void _start_msg_tree_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		(*fwd_tree->p_thr_count)++;
 		slurm_mutex_unlock(fwd_tree->tree_mutex);
 
-		slurm_thread_create_detached(_fwd_tree_thread, fwd_tree);
+		_fwd_run(_fwd_tree_thread, fwd_tree, "_fwd_tree_thread");
 	}
 }
 
@@ -626,7 +693,7 @@ static void _forward_msg_internal(hostlist_t *hl, hostlist_t **sp_hl,
 		forward_init(&fwd_msg->header.forward);
 		fwd_msg->header.forward.nodelist = buf;
 		fwd_msg->header.forward.tree_width = header->forward.tree_width;
-		slurm_thread_create_detached(_forward_thread, fwd_msg);
+		_fwd_run(_forward_thread, fwd_msg, "_forward_thread");
 	}
 }
 
@@ -103,15 +103,18 @@ static int _find_entry(void *x, void *key)
 }
 
 /*
- * This populates a new entry (or re-populates an old entry) using getpwuid_r()
- * to determine the primary group. getpwuid_r() should be used here instead of
- * the job's group to handle when the job was submited with a secondary group.
+ * Resolve the primary group and extended groups for needle->uid into a new,
+ * unlinked cache entry. This calls into NSS and must be called without
+ * gids_mutex held, so a slow name service only stalls the thread that asked
+ * for this user instead of every group lookup in the daemon.
  *
- * On failure of getpwuid_r(), we will fallback to the job's group since it is
- * the only "safe" group we can determine.
+ * getpwuid_r() should be used here instead of the job's group to handle when
+ * the job was submited with a secondary group.
+ *
+ * IN ngids_hint - expected number of groups or 0 for default
+ * RET new entry or NULL if getpwuid_r() failed
  */
-static void _init_or_reinit_entry(gids_cache_t **in,
-				  gids_cache_needle_t *needle)
+static gids_cache_t *_resolve_entry(gids_cache_needle_t *needle, int ngids_hint)
 {
 	char buffer[PW_BUF_SIZE];
 	gids_cache_t *entry;
@@ -128,41 +131,14 @@ static void _init_or_reinit_entry(gids_cache_t **in,
 		else
 			error("%s: getpwuid_r(%u): %s",
 			      __func__, needle->uid, strerror(rc));
-
-		if (*in) {
-			/* discard this now-invalid cache entry */
-			list_delete_ptr(gids_cache_list, *in);
-			*in = NULL;
-		}
-
-		return;
+		return NULL;
 	}
 
-	if (*in) {
-		/*
-		 * Reusing the existing cache record. Reset ngids to the
-		 * current buffer size to avoid needing to loop around
-		 * on getgrouplist() to determine the correct size.
-		 */
-		entry = *in;
-		entry->ngids = xsize(entry->gids) / sizeof(gid_t);
-
-		if (xstrcmp(entry->username, result->pw_name)) {
-			error("Cached username %s did not match queried username %s?",
-			      entry->username, result->pw_name);
-			xfree(entry->username);
-		}
-
-		if (entry->gid != result->pw_gid)
-			debug("Cached user=%s changed primary gid from %u to %u?",
-			      result->pw_name, entry->gid, result->pw_gid);
-	} else {
-		/* Brand new entry */
-		entry = xmalloc(sizeof(*entry));
-		entry->uid = needle->uid;
-		entry->ngids = NGROUPS_START;
-		entry->gids = xcalloc(NGROUPS_START, sizeof(gid_t));
-	}
+	entry = xmalloc(sizeof(*entry));
+	entry->uid = needle->uid;
+	entry->username = xstrdup(result->pw_name);
+	entry->ngids = MAX(ngids_hint, NGROUPS_START);
+	entry->gids = xcalloc(entry->ngids, sizeof(gid_t));
 
 	/*
 	 * Always use the primary gid as reported by getpwuid_r(). This may
@@ -174,16 +150,29 @@ static void _init_or_reinit_entry(gids_cache_t **in,
 	 */
 	entry->gid = result->pw_gid;
 
-	/* Reuse cached value if possible to skip an xstrdup() */
-	if (!entry->username)
-		entry->username = xstrdup(result->pw_name);
+#if defined(__APPLE__)
+	/*
+	 * macOS has (int *) for the third argument instead
+	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
+	 */
+	while (getgrouplist(entry->username, entry->gid,
+			    (int *)entry->gids, &entry->ngids) == -1) {
+#else
+	/*
+	 * entry->gid will be in the result. This is the users primary
+	 * group as determined from passwd.
+	 */
+	while (getgrouplist(entry->username, entry->gid,
+			    entry->gids, &entry->ngids) == -1) {
+#endif
+		/* group list larger than array, resize array to fit */
+		entry->gids = xrecalloc(entry->gids, entry->ngids,
+					sizeof(gid_t));
+	}
 
 	entry->expiration = time(NULL) + slurm_conf.group_time;
 
-	if (!*in) {
-		*in = entry;
-		list_prepend(gids_cache_list, entry);
-	}
+	return entry;
 }
 
 /*
@@ -194,8 +183,9 @@ static void _init_or_reinit_entry(gids_cache_t **in,
  */
 static int _group_cache_lookup_internal(gids_cache_needle_t *needle, gid_t **gids)
 {
-	gids_cache_t *entry;
+	gids_cache_t *entry, *resolved;
 	int ngids; /* need a copy to safely return outside the lock */
+	int ngids_hint = 0;
 	DEF_TIMERS;
 	START_TIMER;
 
@@ -215,51 +205,57 @@ static int _group_cache_lookup_internal(gids_cache_needle_t *needle, gid_t **gid
 		/* The timestamp is too old, need to replace the values. */
 		debug2("%s: found old entry for uid=%u, refreshing",
 		       __func__, entry->uid);
+		ngids_hint = entry->ngids;
 	} else {
 		debug2("%s: no entry found for uid=%u", __func__, needle->uid);
 	}
+	slurm_mutex_unlock(&gids_mutex);
 
-	_init_or_reinit_entry(&entry, needle);
+	/* Cache lookup failed or entry value was too old, fetch new value */
+	resolved = _resolve_entry(needle, ngids_hint);
 
-	if (!entry) {
+	slurm_mutex_lock(&gids_mutex);
+	if (!gids_cache_list)
+		gids_cache_list = list_create(_group_cache_list_delete);
+
+	/* Another thread may have changed the cache while unlocked */
+	entry = list_find_first(gids_cache_list, _find_entry, needle);
+
+	if (!resolved) {
 		error("failed to init group cache entry for uid=%u",
 		      needle->uid);
 
+		/* discard any now-invalid cache entry */
+		if (entry)
+			list_delete_ptr(gids_cache_list, entry);
+
 		/*
 		 * getgrouplist() does not have a way to signal failure, so
 		 * return the primary group as the single member of the
 		 * extended group list.
 		 */
+		xfree(*gids);
 		*gids = xmalloc(sizeof(gid_t));
 		*gids[0] = needle->gid;
 		slurm_mutex_unlock(&gids_mutex);
 		return 1;
 	}
 
-	/*
-	 * Cache lookup failed or entry value was too old, fetch new value and
-	 * insert it into cache.
-	 */
-#if defined(__APPLE__)
-	/*
-	 * macOS has (int *) for the third argument instead
-	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
-	 */
-	while (getgrouplist(entry->username, entry->gid,
-			    (int *)entry->gids, &entry->ngids) == -1) {
-#else
-	/*
-	 * entry->gid will be in the result. This is the users primary
-	 * group as determined from passwd.
-	 */
-	while (getgrouplist(entry->username, entry->gid,
-			    entry->gids, &entry->ngids) == -1) {
-#endif
-		/* group list larger than array, resize array to fit */
-		entry->gids = xrecalloc(entry->gids, entry->ngids,
-					sizeof(gid_t));
+	if (entry) {
+		if (xstrcmp(entry->username, resolved->username))
+			error("Cached username %s did not match queried username %s?",
+			      entry->username, resolved->username);
+
+		if (entry->gid != resolved->gid)
+			debug("Cached user=%s changed primary gid from %u to %u?",
+			      resolved->username, entry->gid, resolved->gid);
+
+		list_delete_ptr(gids_cache_list, entry);
 	}
 
+	entry = resolved;
+	list_prepend(gids_cache_list, entry);
+
 out:
 	ngids = entry->ngids;
 	xfree(*gids);
@@ -2151,6 +2151,72 @@ int hostlist_count(hostlist_t *hl)
 	return retval;
 }
 
+int hostlist_for_each_host(hostlist_t *hl, int dims, hostlist_for_each_f f,
+			   void *arg)
+{
+	int count = 0;
+
+	if (!hl)
+		return 0;
+
+	if (!dims)
+		dims = slurmdb_setup_cluster_dims();
+
+	LOCK_HOSTLIST(hl);
+
+	for (int i = 0; (count >= 0) && (i < hl->nranges); i++) {
+		hostrange_t *hr = hl->hr[i];
+		size_t size;
+		char *host;
+		int len;
+
+		if (hr->singlehost) {
+			if (f(hr->prefix, arg) < 0)
+				count = -1;
+			else
+				count++;
+			continue;
+		}
+
+		if (hr->hi < hr->lo)
+			continue;
+
+		/* Format the prefix once per range and only rewrite suffix */
+		size = strlen(hr->prefix) + hr->width + 16;
+		host = xmalloc(size);
+		len = snprintf(host, size, "%s", hr->prefix);
+
+		for (unsigned long n = hr->lo; ; n++) {
+			if ((dims > 1) && (hr->width == dims)) {
+				int coord[dims];
+
+				hostlist_parse_int_to_array(n, coord, dims, 0);
+				for (int i2 = 0; i2 < dims; i2++)
+					host[len + i2] = alpha_num[coord[i2]];
+				host[len + dims] = '\0';
+			} else {
+				snprintf(host + len, size - len, "%0*lu",
+					 hr->width, n);
+			}
+
+			if (f(host, arg) < 0) {
+				count = -1;
+				break;
+			}
+			count++;
+
+			if (n == hr->hi)
+				break;
+		}
+
+		xfree(host);
+	}
+
+	UNLOCK_HOSTLIST(hl);
+
+	return count;
+}
+
 int hostlist_find_dims(hostlist_t *hl, const char *hostname, int dims)
 {
 	int i, count, ret = -1;
@@ -361,6 +361,19 @@ char *hostlist_deranged_string_xmalloc(hostlist_t *hl);
  */
 int hostlist_nranges(hostlist_t *hl);
 
+/* hostlist_for_each_host():
+ *
+ * Call f() with the name of each host in hostlist hl in order, without
+ * removing hosts or allocating a string per host. The hostlist is locked
+ * while walking it, so f() must not modify hl.
+ *
+ * Returns the number of hosts visited or -1 if f() returned a negative
+ * value, which stops the walk.
+ */
+typedef int (*hostlist_for_each_f)(const char *host, void *arg);
+int hostlist_for_each_host(hostlist_t *hl, int dims, hostlist_for_each_f f,
+			   void *arg);
+
 
 /* ----[ hostlist iterator functions ]---- */
 
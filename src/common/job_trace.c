@@ -0,0 +1,82 @@
+/*****************************************************************************\
+ *  job_trace.c - timing spans across the job launch path
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/job_trace.h"
+#include "src/common/log.h"
+#include "src/common/read_config.h"
+#include "src/common/xstring.h"
+
+static uint32_t _sample_rate(void)
+{
+	char *tmp;
+	long rate;
+
+	if (!(tmp = xstrcasestr(slurm_conf.comm_params, "trace_sample=")))
+		return 1;
+
+	rate = strtol(tmp + strlen("trace_sample="), NULL, 10);
+	return (rate > 1) ? rate : 1;
+}
+
+extern void job_trace_start(job_trace_span_t *span)
+{
+	if (slurm_conf.debug_flags & DEBUG_FLAG_TRACE_JOBS)
+		gettimeofday(&span->start, NULL);
+	else
+		timerclear(&span->start);
+}
+
+extern void job_trace_end(job_trace_span_t *span, uint32_t job_id,
+			  const char *name)
+{
+	struct timeval now;
+	long delta_t;
+
+	if (!timerisset(&span->start) || !job_id ||
+	    !(slurm_conf.debug_flags & DEBUG_FLAG_TRACE_JOBS) ||
+	    (job_id % _sample_rate()))
+		return;
+
+	gettimeofday(&now, NULL);
+	delta_t = (now.tv_sec - span->start.tv_sec) * 1000000;
+	delta_t += now.tv_usec - span->start.tv_usec;
+
+	log_flag(TRACE_JOBS, "span JobId=%u name=%s start=%ld.%06ld usec=%ld",
+		 job_id, name, (long) span->start.tv_sec,
+		 (long) span->start.tv_usec, delta_t);
+}
@@ -0,0 +1,65 @@
+/*****************************************************************************\
+ *  job_trace.h - timing spans across the job launch path
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _JOB_TRACE_H
+#define _JOB_TRACE_H
+
+#include <stdint.h>
+#include <sys/time.h>
+
+/*
+ * Spans follow a job through slurmctld, slurmd and slurmstepd. The JobId is
+ * the trace id, so a job launch can be put together from the logs of every
+ * daemon involved without carrying any extra context in the messages.
+ *
+ * Spans are only emitted with DebugFlags=TraceJobs. With
+ * CommunicationParameters=trace_sample=<N> only the jobs whose JobId is a
+ * multiple of N are traced, which every daemon agrees on independently.
+ */
+typedef struct {
+	struct timeval start;	/* zero if tracing was off at start */
+} job_trace_span_t;
+
+/* Start a span, this is a no-op unless DebugFlags=TraceJobs is set */
+extern void job_trace_start(job_trace_span_t *span);
+
+/*
+ * End a span and log it if job_id is sampled:
+ *   TraceJobs: span JobId=<id> name=<name> start=<epoch.usec> usec=<duration>
+ */
+extern void job_trace_end(job_trace_span_t *span, uint32_t job_id,
+			  const char *name);
+
+#endif
@@ -1264,6 +1264,14 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 	char *eol = "\n";
 	int priority = LOG_INFO;
 
+	/*
+	 * Format the message before taking log_lock. Expanding the caller's
+	 * format can be expensive (%pD, %pA, etc.) and only touches the
+	 * arguments, so every other logging thread does not need to wait on
+	 * it. This also captures errno for %m before anything else runs.
+	 */
+	buf = vxstrfmt(fmt, args);
+
 	slurm_mutex_lock(&log_lock);
 
 	if (!LOG_INITIALIZED) {
@@ -1276,7 +1284,6 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 
 	if (SCHED_LOG_INITIALIZED && sched &&
 	    (highest_sched_log_level > LOG_LEVEL_QUIET)) {
-		buf = vxstrfmt(fmt, args);
 		xlogfmtcat(&msgbuf, "[%M] %s%s", sched_log->prefix, pfx);
 		_log_printf(sched_log, sched_log->fbuf, sched_log->logfp,
 			    "sched: %s%s\n", msgbuf, buf);
@@ -1343,12 +1350,6 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 
 	}
 
-	if (!buf) {
-		/* format the basic message,
-		 * if not already done for scheduling log */
-		buf = vxstrfmt(fmt, args);
-	}
-
 	if (level <= log->opt.stderr_level) {
 
 		fflush(stdout);
@@ -829,18 +829,23 @@ static void _init_node_record(node_record_t *node_ptr,
 
 extern void grow_node_record_table_ptr(void)
 {
-	node_record_table_size = node_record_count + 100;
+	/* Grow geometrically so large configs don't realloc per 100 nodes */
+	node_record_table_size = node_record_count +
+		MAX(100, (node_record_count / 2));
 	if (slurm_conf.max_node_cnt != NO_VAL)
 		node_record_table_size = MAX(node_record_count,
 					     slurm_conf.max_node_cnt);
 
 	xrealloc(node_record_table_ptr,
 		 node_record_table_size * sizeof(node_record_t *));
+
 	/*
-	 * You need to rehash the hash after we realloc or we will have
-	 * only bad memory references in the hash.
+	 * node_hash_table references the node records themselves, not the
+	 * slots of node_record_table_ptr, so it remains valid across the
+	 * realloc and only needs to exist.
 	 */
-	rehash_node();
+	if (!node_hash_table)
+		node_hash_table = xhash_init(_node_record_hash_identity, NULL);
 }
 
 /*
@@ -1174,11 +1179,54 @@ extern int node_name_get_inx(char *node_name)
  * RET 0 if no error, otherwise EINVAL
  * NOTE: call FREE_NULL_BITMAP() to free bitmap memory when no longer required
  */
+typedef struct {
+	bitstr_t *bitmap;
+	bool best_effort;
+	const char *caller;
+	int next_index;
+	int rc;
+} name2bitmap_args_t;
+
+static int _set_node_bit(const char *name, void *arg)
+{
+	name2bitmap_args_t *args = arg;
+	node_record_t *node_ptr = NULL;
+
+	/*
+	 * Ranges in a hostlist usually map to consecutive node records, so
+	 * check the record after the last match before hashing the name.
+	 */
+	if ((args->next_index < node_record_count) &&
+	    (node_ptr = node_record_table_ptr[args->next_index]) &&
+	    xstrcmp(node_ptr->name, name))
+		node_ptr = NULL;
+
+	if (!node_ptr)
+		node_ptr = _find_node_record((char *) name, args->best_effort,
+					     true);
+
+	if (node_ptr) {
+		bit_set(args->bitmap, node_ptr->index);
+		args->next_index = node_ptr->index + 1;
+	} else {
+		error("%s: invalid node specified: \"%s\"", args->caller,
+		      name);
+		if (!args->best_effort)
+			args->rc = EINVAL;
+	}
+
+	return 0;
+}
+
 extern int node_name2bitmap (char *node_names, bool best_effort,
 			     bitstr_t **bitmap)
 {
+	name2bitmap_args_t args = {
+		.best_effort = best_effort,
+		.caller = __func__,
+		.rc = SLURM_SUCCESS,
+	};
 	int rc = SLURM_SUCCESS;
-	char *this_node_name;
 	bitstr_t *my_bitmap;
 	hostlist_t *host_list;
 
@@ -1198,22 +1246,11 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 		return rc;
 	}
 
-	while ( (this_node_name = hostlist_shift (host_list)) ) {
-		node_record_t *node_ptr;
-		node_ptr = _find_node_record(this_node_name, best_effort, true);
-		if (node_ptr) {
-			bit_set(my_bitmap, node_ptr->index);
-		} else {
-			error("%s: invalid node specified: \"%s\"", __func__,
-			      this_node_name);
-			if (!best_effort)
-				rc = EINVAL;
-		}
-		free (this_node_name);
-	}
+	args.bitmap = my_bitmap;
+	(void) hostlist_for_each_host(host_list, 0, _set_node_bit, &args);
 	hostlist_destroy (host_list);
 
-	return rc;
+	return args.rc;
 }
 
 /*
@@ -1225,33 +1262,19 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
  */
 extern int hostlist2bitmap(hostlist_t *hl, bool best_effort, bitstr_t **bitmap)
 {
-	int rc = SLURM_SUCCESS;
-	bitstr_t *my_bitmap;
-	char *name;
-	hostlist_iterator_t *hi;
+	name2bitmap_args_t args = {
+		.best_effort = best_effort,
+		.caller = __func__,
+		.rc = SLURM_SUCCESS,
+	};
 
 	FREE_NULL_BITMAP(*bitmap);
-	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
-	*bitmap = my_bitmap;
-
-	hi = hostlist_iterator_create(hl);
-	while ((name = hostlist_next(hi))) {
-		node_record_t *node_ptr;
-		node_ptr = _find_node_record(name, best_effort, true);
-		if (node_ptr) {
-			bit_set(my_bitmap, node_ptr->index);
-		} else {
-			error ("hostlist2bitmap: invalid node specified %s",
-			       name);
-			if (!best_effort)
-				rc = EINVAL;
-		}
-		free (name);
-	}
+	args.bitmap = bit_alloc(node_record_count);
+	*bitmap = args.bitmap;
 
-	hostlist_iterator_destroy(hi);
-	return rc;
+	(void) hostlist_for_each_host(hl, 0, _set_node_bit, &args);
 
+	return args.rc;
 }
 
 /* Only delete config_ptr if isn't referenced by another node. */
@@ -122,6 +122,8 @@ struct node_record {
 					 * use for scheduling purposes */
 	List gres_list;			/* list of gres state info managed by
 					 * plugins */
+	slurm_hash_t gres_reg_hash;	/* fingerprint of last registered GRES
+					 * configuration validated */
 	uint32_t index;			/* Index into node_record_table_ptr */
 	char *instance_id;		/* cloud instance id */
 	char *instance_type;		/* cloud instance type */
@@ -0,0 +1,188 @@
+/*****************************************************************************\
+ *  openmetrics.c - OpenMetrics exporter endpoint
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "slurm/slurm_errno.h"
+
+#include "src/common/conmgr.h"
+#include "src/common/http.h"
+#include "src/common/log.h"
+#include "src/common/openmetrics.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#define CONTENT_TYPE "application/openmetrics-text; version=1.0.0; " \
+		     "charset=utf-8"
+#define MAX_REQUEST_SIZE 8192
+
+static openmetrics_dump_t dump_func = NULL;
+
+extern void openmetrics_family(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *help)
+{
+	xstrfmtcatat(*out, pos, "# TYPE %s %s\n# HELP %s %s\n", name,
+		     ((type == OPENMETRICS_COUNTER) ? "counter" : "gauge"),
+		     name, help);
+}
+
+extern void openmetrics_sample(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *labels,
+			       uint64_t value)
+{
+	xstrfmtcatat(*out, pos, "%s%s%s%s%s %"PRIu64"\n", name,
+		     ((type == OPENMETRICS_COUNTER) ? "_total" : ""),
+		     (labels ? "{" : ""), (labels ? labels : ""),
+		     (labels ? "}" : ""), value);
+}
+
+extern void openmetrics_metric(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *help,
+			       uint64_t value)
+{
+	openmetrics_family(out, pos, name, type, help);
+	openmetrics_sample(out, pos, name, type, NULL, value);
+}
+
+extern uint16_t openmetrics_parse_port(const char *params)
+{
+	char *tmp;
+	long port;
+
+	if (!(tmp = xstrcasestr(params, "metrics_port=")))
+		return 0;
+
+	port = strtol(tmp + strlen("metrics_port="), NULL, 10);
+	if ((port < 1) || (port > UINT16_MAX)) {
+		error("Invalid metrics_port=%ld, metrics disabled", port);
+		return 0;
+	}
+
+	return port;
+}
+
+static void _reply(conmgr_fd_t *con, http_status_code_t code,
+		   const char *body)
+{
+	char *reply = NULL;
+
+	xstrfmtcat(reply, "HTTP/1.1 %d %s\r\n"
+		   "Content-Type: %s\r\n"
+		   "Content-Length: %zu\r\n"
+		   "Connection: close\r\n\r\n%s",
+		   code, get_http_status_code_string(code),
+		   ((code == HTTP_STATUS_CODE_SUCCESS_OK) ?
+		    CONTENT_TYPE : "text/plain"),
+		   strlen(body), body);
+
+	if (conmgr_queue_write_fd(con, reply, strlen(reply)))
+		error("%s: [%s] unable to queue reply",
+		      __func__, conmgr_fd_get_name(con));
+	xfree(reply);
+}
+
+/*
+ * Only a minimal subset of HTTP/1.1 is needed for a scraper: read the request
+ * head, answer it and close the connection.
+ */
+static int _on_data(conmgr_fd_t *con, void *arg)
+{
+	const void *data = NULL;
+	size_t bytes = 0;
+	const char *eol;
+	char *line, *method, *path, *save_ptr = NULL;
+	char *body = NULL, *pos = NULL;
+
+	conmgr_fd_get_in_buffer(con, &data, &bytes);
+
+	if (!memmem(data, bytes, "\r\n\r\n", 4)) {
+		if (bytes < MAX_REQUEST_SIZE)
+			return SLURM_SUCCESS; /* wait for rest of request */
+
+		error("%s: [%s] request too large",
+		      __func__, conmgr_fd_get_name(con));
+		conmgr_fd_mark_consumed_in_buffer(con, bytes);
+		conmgr_queue_close_fd(con);
+		return SLURM_SUCCESS;
+	}
+
+	eol = memmem(data, bytes, "\r\n", 2);
+	line = xstrndup(data, (eol - (const char *) data));
+	conmgr_fd_mark_consumed_in_buffer(con, bytes);
+
+	method = strtok_r(line, " ", &save_ptr);
+	path = strtok_r(NULL, " ?", &save_ptr);
+
+	if (get_http_method(method) != HTTP_REQUEST_GET) {
+		_reply(con, HTTP_STATUS_CODE_ERROR_METHOD_NOT_ALLOWED,
+		       "Method not allowed\n");
+	} else if (xstrcmp(path, "/metrics")) {
+		_reply(con, HTTP_STATUS_CODE_ERROR_NOT_FOUND, "Not found\n");
+	} else {
+		dump_func(&body, &pos);
+		xstrcatat(body, &pos, "# EOF\n");
+		_reply(con, HTTP_STATUS_CODE_SUCCESS_OK, body);
+		xfree(body);
+	}
+
+	xfree(line);
+	conmgr_queue_close_fd(con);
+	return SLURM_SUCCESS;
+}
+
+extern int openmetrics_listen(int fd, openmetrics_dump_t dump)
+{
+	static const conmgr_events_t events = { .on_data = _on_data };
+	int rc;
+
+	xassert(fd >= 0);
+	xassert(dump);
+
+	dump_func = dump;
+	init_conmgr(0, 0, (conmgr_callbacks_t) { NULL, NULL });
+
+	if ((rc = conmgr_process_fd_listen(fd, CON_TYPE_RAW, events, NULL, 0,
+					   NULL))) {
+		error("%s: conmgr refused fd=%d: %s",
+		      __func__, fd, slurm_strerror(rc));
+		return rc;
+	}
+
+	return conmgr_run(false);
+}
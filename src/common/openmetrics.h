@@ -0,0 +1,94 @@
+/*****************************************************************************\
+ *  openmetrics.h - OpenMetrics exporter endpoint
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+
+#ifndef _OPENMETRICS_H
+#define _OPENMETRICS_H
+
+#include <stdint.h>
+
+/*
+ * A daemon serves its statistics in the OpenMetrics text format on
+ * "GET /metrics" of a dedicated TCP port, handled by conmgr. The dump
+ * callback only reads in-memory counters under their own mutexes, it must
+ * never take the daemon's global locks so a scrape can not stall (or be
+ * stalled by) the RPC and scheduling threads.
+ */
+
+typedef enum {
+	OPENMETRICS_COUNTER,
+	OPENMETRICS_GAUGE,
+} openmetrics_type_t;
+
+/*
+ * Append all metrics of the daemon to out
+ * IN/OUT out - xstring holding the response body
+ * IN/OUT pos - end of out for xstrfmtcatat()
+ */
+typedef void (*openmetrics_dump_t)(char **out, char **pos);
+
+/* Append the "# TYPE" and "# HELP" lines of a metric family */
+extern void openmetrics_family(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *help);
+
+/*
+ * Append one sample of a family, "_total" is appended to the name of counters
+ * IN labels - 'key="value",...' or NULL
+ */
+extern void openmetrics_sample(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *labels,
+			       uint64_t value);
+
+/* Append a family with a single sample without labels */
+extern void openmetrics_metric(char **out, char **pos, const char *name,
+			       openmetrics_type_t type, const char *help,
+			       uint64_t value);
+
+/*
+ * Parse "metrics_port=<port>" out of a comma separated parameter string
+ * RET port or 0 if not set
+ */
+extern uint16_t openmetrics_parse_port(const char *params);
+
+/*
+ * Start serving the metrics through conmgr
+ * IN fd - listening socket from slurm_init_msg_engine_port(), conmgr takes
+ *	ownership of it
+ * IN dump - callback generating the metrics
+ * RET SLURM_SUCCESS or error
+ */
+extern int openmetrics_listen(int fd, openmetrics_dump_t dump);
+
+#endif
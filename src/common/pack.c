@@ -52,6 +52,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "slurm/slurm_errno.h"
 #include "slurm/slurm.h"
@@ -160,6 +161,9 @@ buf_t *create_mmap_buf(const char *file)
 		return NULL;
 	}
 
+	/* Callers unpack front to back, let the kernel read ahead for us */
+	(void) madvise(data, f_stat.st_size, MADV_SEQUENTIAL);
+
 	my_buf = create_buf(data, f_stat.st_size);
 	if (my_buf)
 		my_buf->mmaped = true;
@@ -169,6 +173,25 @@ buf_t *create_mmap_buf(const char *file)
 	return my_buf;
 }
 
+/*
+ * Drop the already unpacked pages of an mmap()'d buffer from our resident
+ * set. The data stays in the page cache and is faulted back in if accessed.
+ */
+extern void release_mmap_buf_processed(buf_t *buffer)
+{
+	long page_size = sysconf(_SC_PAGESIZE);
+	size_t len;
+
+	xassert(buffer->magic == BUF_MAGIC);
+
+	if (!buffer->mmaped || (page_size <= 0))
+		return;
+
+	len = buffer->processed - (buffer->processed % page_size);
+	if (len)
+		(void) madvise(buffer->head, len, MADV_DONTNEED);
+}
+
 extern buf_t *create_shadow_buf(char *data, uint32_t size)
 {
 	buf_t *my_buf = create_buf(data, size);
@@ -239,8 +262,20 @@ extern int try_grow_buf_remaining(buf_t *buffer, uint32_t size)
 	xassert(buffer->magic == BUF_MAGIC);
 	xassert(size > 0);
 
-	if (remaining_buf(buffer) < size)
-		return try_grow_buf(buffer, size);
+	if (remaining_buf(buffer) < size) {
+		/*
+		 * Grow geometrically so that packing a large response (e.g.
+		 * RESPONSE_JOB_INFO on a big cluster) does not realloc() once
+		 * per packed field. Only insist on the bytes actually needed
+		 * when close to MAX_BUF_SIZE.
+		 */
+		uint64_t grow = MAX(size, MAX(BUF_SIZE, (buffer->size / 2)));
+
+		if ((grow + buffer->size) > MAX_BUF_SIZE)
+			grow = MAX(size, (MAX_BUF_SIZE - buffer->size));
+
+		return try_grow_buf(buffer, grow);
+	}
 
 	return SLURM_SUCCESS;
 }
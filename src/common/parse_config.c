@@ -40,7 +40,6 @@
 \*****************************************************************************/
 
 #include <ctype.h>
-#include <regex.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -62,7 +61,6 @@
 #include "src/common/slurm_protocol_interface.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
-#include "src/common/xregex.h"
 #include "src/common/xstring.h"
 
 #include "slurm/slurm.h"
@@ -90,14 +88,6 @@ strong_alias(transfer_s_p_options,	slurm_transfer_s_p_options);
 
 #define CONF_HASH_LEN 173
 
-static char *keyvalue_pattern =
-	"^[[:space:]]*"
-	"([[:alnum:]_.]+)" /* key */
-	"[[:space:]]*([-*+/]?)=[[:space:]]*"
-	"((\"([^\"]*)\")|([^[:space:]]+))" /* value: quoted with whitespace,
-					    * or unquoted and no whitespace */
-	"([[:space:]]|$)";
-
 struct s_p_values {
 	char *key;
 	int type;
@@ -112,7 +102,6 @@ struct s_p_values {
 };
 
 struct s_p_hashtbl {
-	regex_t keyvalue_re;
 	s_p_values_t *hash[CONF_HASH_LEN];
 };
 
@@ -200,9 +189,6 @@ s_p_hashtbl_t *s_p_hashtbl_create_cnt(const s_p_options_t options[], int *cnt)
 		_conf_hashtbl_insert(tbl, value);
 	}
 
-	if (regcomp(&tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return tbl;
 }
 
@@ -286,69 +272,94 @@ void s_p_hashtbl_destroy(s_p_hashtbl_t *tbl)
 		}
 	}
 
-	regfree(&tbl->keyvalue_re);
-
 	xfree(tbl);
 }
 
 /*
- * IN tbl - table to work off
+ * Scan for the next key=value pair. This is a hand-written equivalent of
+ * the extended regular expression
+ *
+ *	^[[:space:]]*([[:alnum:]_.]+)[[:space:]]*([-*+/]?)=[[:space:]]*
+ *	(("([^"]*)")|([^[:space:]]+))([[:space:]]|$)
+ *
+ * that used to be compiled into every s_p_hashtbl_t. Compiling and running
+ * it dominated parsing of configurations with many NodeName lines.
+ *
  * IN line - string to be search for a key=value pair
  * OUT key - pointer to the key string (caller must free with xfree())
  * OUT value - pointer to the value string (caller must free with xfree())
  * OUT remaining - pointer into the "line" string denoting the start
  *                 of the unsearched portion of the string
+ * OUT operator - operator preceding the '='
  * Return 0 when a key-value pair is found, and -1 otherwise.
  */
-static int _keyvalue_regex(s_p_hashtbl_t *tbl, const char *line,
-			   char **key, char **value, char **remaining,
-			   slurm_parser_operator_t *operator)
+static int _keyvalue_scan(const char *line, char **key, char **value,
+			  char **remaining, slurm_parser_operator_t *operator)
 {
-	size_t nmatch = 8;
-	regmatch_t pmatch[8];
-	char op;
-	int rc;
+	const char *p = line, *key_start, *key_end, *val, *q;
+	int quoted_len = -1, unquoted_len = 0;
 
 	*key = NULL;
 	*value = NULL;
-	*remaining = (char *)line;
+	*remaining = (char *) line;
 	*operator = S_P_OPERATOR_SET;
-	memset(pmatch, 0, sizeof(regmatch_t)*nmatch);
 
-	if ((rc = regexec(&tbl->keyvalue_re, line, nmatch, pmatch, 0))) {
-		if (rc != REG_NOMATCH)
-			dump_regex_error(rc, &tbl->keyvalue_re, "regexec(%s)",
-					 line);
+	while (isspace((unsigned char) *p))
+		p++;
+
+	key_start = p;
+	while (isalnum((unsigned char) *p) || (*p == '_') || (*p == '.'))
+		p++;
+	if ((key_end = p) == key_start)
+		return -1;
+
+	while (isspace((unsigned char) *p))
+		p++;
+
+	if (*p == '+')
+		*operator = S_P_OPERATOR_ADD;
+	else if (*p == '-')
+		*operator = S_P_OPERATOR_SUB;
+	else if (*p == '*')
+		*operator = S_P_OPERATOR_MUL;
+	else if (*p == '/')
+		*operator = S_P_OPERATOR_DIV;
+	if (*operator != S_P_OPERATOR_SET)
+		p++;
+
+	if (*p != '=') {
+		*operator = S_P_OPERATOR_SET;
 		return -1;
 	}
+	p++;
 
-	*key = (char *)(xstrndup(line + pmatch[1].rm_so,
-				 pmatch[1].rm_eo - pmatch[1].rm_so));
-	if (pmatch[2].rm_so != -1 &&
-	    (pmatch[2].rm_so != pmatch[2].rm_eo)) {
-		op = *(line + pmatch[2].rm_so);
-		if (op == '+') {
-			*operator = S_P_OPERATOR_ADD;
-		} else if (op == '-') {
-			*operator = S_P_OPERATOR_SUB;
-		} else if (op == '*') {
-			*operator = S_P_OPERATOR_MUL;
-		} else if (op == '/') {
-			*operator = S_P_OPERATOR_DIV;
-		}
+	while (isspace((unsigned char) *p))
+		p++;
+	val = p;
+
+	/* quoted value must be followed by whitespace or end of line */
+	if ((*val == '"') && (q = strchr(val + 1, '"')) &&
+	    (!q[1] || isspace((unsigned char) q[1])))
+		quoted_len = q - val + 1;
+
+	/* otherwise the value is everything up to the next whitespace */
+	while (val[unquoted_len] && !isspace((unsigned char) val[unquoted_len]))
+		unquoted_len++;
+
+	if ((quoted_len < 0) && !unquoted_len) {
+		*operator = S_P_OPERATOR_SET;
+		return -1;
 	}
-	if (pmatch[5].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[5].rm_so,
-					   pmatch[5].rm_eo - pmatch[5].rm_so));
-	} else if (pmatch[6].rm_so != -1) {
-		*value = (char *)(xstrndup(line + pmatch[6].rm_so,
-					   pmatch[6].rm_eo - pmatch[6].rm_so));
+
+	*key = xstrndup(key_start, key_end - key_start);
+	if (quoted_len >= unquoted_len) {
+		*value = xstrndup(val + 1, quoted_len - 2);
+		*remaining = (char *) (val + quoted_len);
 	} else {
-		*value = xstrdup("");
+		*value = xstrndup(val, unquoted_len);
+		*remaining = (char *) (val + unquoted_len);
 	}
 
-	*remaining = (char *)(line + pmatch[3].rm_eo);
-
 	return 0;
 }
 
@@ -517,13 +528,6 @@ s_p_hashtbl_t *_hashtbl_copy_keys(const s_p_hashtbl_t *from_tbl)
 		}
 	}
 
-	/*
-	 * We cannot copy a regex since a regfree() on either
-	 * the original or the copy can affect the other one.
-	 */
-	if (regcomp(&to_tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return to_tbl;
 }
 
@@ -990,7 +994,7 @@ int s_p_parse_line(s_p_hashtbl_t *hashtbl, const char *line, char **leftover)
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	while (_keyvalue_regex(hashtbl, ptr, &key, &value, &new_leftover, &op) == 0) {
+	while (_keyvalue_scan(ptr, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			if (_handle_keyvalue_match(p, value, new_leftover,
@@ -1027,7 +1031,7 @@ static int _parse_next_key(s_p_hashtbl_t *hashtbl,
 	char *new_leftover;
 	slurm_parser_operator_t op;
 
-	if (_keyvalue_regex(hashtbl, line, &key, &value, &new_leftover, &op) == 0) {
+	if (_keyvalue_scan(line, &key, &value, &new_leftover, &op) == 0) {
 		if ((p = _conf_hashtbl_lookup(hashtbl, key))) {
 			p->operator = op;
 			if (_handle_keyvalue_match(p, value, new_leftover,
@@ -1577,13 +1581,6 @@ static s_p_hashtbl_t *_parse_expline_adapt_table(const s_p_hashtbl_t *tbl)
 		}
 	}
 
-	/*
-	 * We cannot copy a regex since a regfree() on either
-	 * the original or the copy can affect the other one.
-	 */
-	if (regcomp(&to_tbl->keyvalue_re, keyvalue_pattern, REG_EXTENDED))
-		fatal("keyvalue regex compilation failed");
-
 	return to_tbl;
 }
 
@@ -128,7 +128,7 @@ static list_t *config_files = NULL;
 inline static void _normalize_debug_level(uint16_t *level);
 static int _init_slurm_conf(const char *file_name);
 
-#define NAME_HASH_LEN 512
+#define NAME_HASH_LEN 4096
 typedef struct names_ll_s {
 	char *alias;	/* NodeName */
 	char *hostname;	/* NodeHostname */
@@ -2177,23 +2177,23 @@ static void _free_name_hashtbl(void)
 
 static int _get_hash_idx(const char *name)
 {
-	int index = 0;
-	int j;
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
 
 	if (name == NULL)
 		return 0;	/* degenerate case */
 
-	/* Multiply each character by its numerical position in the
-	 * name string to add a bit of entropy, because host names such
-	 * as cluster[0001-1000] can cause excessive index collisions.
+	/*
+	 * Host names such as cluster[0001-1000] differ only in a few
+	 * trailing digits, so every character needs to affect every bit of
+	 * the index to avoid excessive index collisions.
 	 */
-	for (j = 1; *name; name++, j++)
-		index += (int)*name * j;
-	index %= NAME_HASH_LEN;
-	while (index < 0) /* Coverity thinks "index" could be negative with "if" */
-		index += NAME_HASH_LEN;
+	for (; *name; name++) {
+		hash ^= (unsigned char) *name;
+		hash *= 16777619U;
+	}
 
-	return index;
+	return hash % NAME_HASH_LEN;
 }
 
 static void _push_to_hashtbls(char *alias, char *hostname, char *address,
@@ -5581,6 +5581,12 @@ extern char * prolog_flags2str(uint16_t prolog_flags)
 		xstrcat(rc, "NoHold");
 	}
 
+	if (prolog_flags & PROLOG_FLAG_PARALLEL_SCRIPTS) {
+		if (rc)
+			xstrcat(rc, ",");
+		xstrcat(rc, "ParallelScripts");
+	}
+
 	if (prolog_flags & PROLOG_FLAG_FORCE_REQUEUE_ON_FAIL) {
 		if (rc)
 			xstrcat(rc, ",");
@@ -5626,6 +5632,8 @@ extern uint16_t prolog_str2flags(char *prolog_flags)
 			rc |= PROLOG_FLAG_DEFER_BATCH;
 		else if (xstrcasecmp(tok, "NoHold") == 0)
 			rc |= PROLOG_FLAG_NOHOLD;
+		else if (xstrcasecmp(tok, "ParallelScripts") == 0)
+			rc |= PROLOG_FLAG_PARALLEL_SCRIPTS;
 		else if (xstrcasecmp(tok, "ForceRequeueOnFail") == 0)
 			rc |= (PROLOG_FLAG_ALLOC |
 			       PROLOG_FLAG_FORCE_REQUEUE_ON_FAIL);
@@ -53,6 +53,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -66,6 +67,7 @@
 #include "src/common/net.h"
 #include "src/common/pack.h"
 #include "src/common/read_config.h"
+#include "src/common/run_in_daemon.h"
 #include "src/interfaces/accounting_storage.h"
 #include "src/interfaces/auth.h"
 #include "src/common/slurm_protocol_interface.h"
@@ -87,6 +89,15 @@ typedef struct {
 	slurm_addr_t vip_addr;
 } slurm_protocol_config_t;
 
+struct msg_auth_share {
+	pthread_mutex_t mutex;
+	buf_t *auth;		/* packed credential, NULL until first send */
+	time_t ctime;		/* when auth was created */
+	slurm_hash_t hash;	/* body hash the credential was created for */
+	int h_len;
+	uint16_t version;	/* protocol version auth was packed with */
+};
+
 strong_alias(convert_num_unit2, slurm_convert_num_unit2);
 strong_alias(convert_num_unit, slurm_convert_num_unit);
 strong_alias(revert_num_unit, slurm_revert_num_unit);
@@ -96,9 +107,12 @@ strong_alias(get_unit_type, slurm_get_unit_type);
 /* EXTERNAL VARIABLES */
 
 /* #DEFINES */
+/* Don't hand out a shared credential older than this (seconds) */
+#define AUTH_SHARE_MAX_AGE 10
 
 /* STATIC VARIABLES */
 static int message_timeout = -1;
+static __thread uint64_t thread_bytes_sent = 0;
 
 /* STATIC FUNCTIONS */
 static char *_global_auth_key(void);
@@ -1731,6 +1745,64 @@ total_return:
  * message packing routines
 \**********************************************************************/
 
+extern msg_auth_share_t *slurm_msg_auth_share_create(void)
+{
+	msg_auth_share_t *share = xmalloc(sizeof(*share));
+
+	slurm_mutex_init(&share->mutex);
+
+	return share;
+}
+
+extern void slurm_msg_auth_share_destroy(msg_auth_share_t *share)
+{
+	if (!share)
+		return;
+
+	FREE_NULL_BUFFER(share->auth);
+	slurm_mutex_destroy(&share->mutex);
+	xfree(share);
+}
+
+/* Return a copy of the shared credential if it is usable for this body */
+static buf_t *_auth_share_get(msg_auth_share_t *share, uint16_t version,
+			      slurm_hash_t *hash, int h_len)
+{
+	buf_t *auth = NULL;
+
+	slurm_mutex_lock(&share->mutex);
+	if (share->auth && (share->version == version) &&
+	    (share->h_len == h_len) &&
+	    !memcmp(&share->hash, hash, sizeof(*hash)) &&
+	    (difftime(time(NULL), share->ctime) < AUTH_SHARE_MAX_AGE)) {
+		uint32_t size = get_buf_offset(share->auth);
+
+		auth = init_buf(size);
+		memcpy(get_buf_data(auth), get_buf_data(share->auth), size);
+		set_buf_offset(auth, size);
+	}
+	slurm_mutex_unlock(&share->mutex);
+
+	return auth;
+}
+
+static void _auth_share_set(msg_auth_share_t *share, buf_t *auth,
+			    uint16_t version, slurm_hash_t *hash, int h_len)
+{
+	uint32_t size = get_buf_offset(auth);
+
+	slurm_mutex_lock(&share->mutex);
+	FREE_NULL_BUFFER(share->auth);
+	share->auth = init_buf(size);
+	memcpy(get_buf_data(share->auth), get_buf_data(auth), size);
+	set_buf_offset(share->auth, size);
+	share->ctime = time(NULL);
+	share->hash = *hash;
+	share->h_len = h_len;
+	share->version = version;
+	slurm_mutex_unlock(&share->mutex);
+}
+
 extern int slurm_buffers_pack_msg(slurm_msg_t *msg, msg_bufs_t *buffers,
 				  bool block_for_forwarding)
 {
@@ -1746,8 +1818,22 @@ extern int slurm_buffers_pack_msg(slurm_msg_t *msg, msg_bufs_t *buffers,
 	/*
 	 * Pack message into buffer
 	 */
-	buffers->body = init_buf(BUF_SIZE);
-	pack_msg(msg, buffers->body);
+	if (pack_msg_is_buf(msg->msg_type) && msg->data &&
+	    (msg->protocol_version >= SLURM_MIN_PROTOCOL_VERSION)) {
+		/*
+		 * Body is already packed (job/node/partition info, etc.) and
+		 * can be very large. Reference it directly instead of copying
+		 * it into a new buffer. msg->data outlives the send.
+		 */
+		buf_t *msg_buf = msg->data;
+
+		buffers->body = create_shadow_buf(get_buf_data(msg_buf),
+						  get_buf_offset(msg_buf));
+		set_buf_offset(buffers->body, get_buf_offset(msg_buf));
+	} else {
+		buffers->body = init_buf(BUF_SIZE);
+		pack_msg(msg, buffers->body);
+	}
 	log_flag_hex(NET_RAW, get_buf_data(buffers->body),
 		     get_buf_offset(buffers->body),
 		     "%s: packed body", __func__);
@@ -1771,7 +1857,12 @@ extern int slurm_buffers_pack_msg(slurm_msg_t *msg, msg_bufs_t *buffers,
 	}
 	log_flag_hex(NET_RAW, &hash, sizeof(hash),
 		     "%s: hash:", __func__);
-	if (msg->flags & SLURM_GLOBAL_AUTH_KEY) {
+	if (msg->auth_share &&
+	    (buffers->auth = _auth_share_get(msg->auth_share,
+					     msg->protocol_version, &hash,
+					     h_len))) {
+		/* credential of an earlier copy of this message is reused */
+	} else if (msg->flags & SLURM_GLOBAL_AUTH_KEY) {
 		auth_cred = auth_g_create(msg->auth_index, _global_auth_key(),
 					  msg->restrict_uid, &hash, h_len);
 	} else {
@@ -1794,7 +1885,7 @@ skip_auth1:
 
 	init_header(&header, msg, msg->flags);
 
-	if (msg->flags & SLURM_NO_AUTH_CRED)
+	if ((msg->flags & SLURM_NO_AUTH_CRED) || buffers->auth)
 		goto skip_auth2;
 
 	if (difftime(time(NULL), start_time) >= 60) {
@@ -1837,6 +1928,10 @@ skip_auth1:
 		     get_buf_offset(buffers->auth),
 		     "%s: packed auth_cred", __func__);
 
+	if (msg->auth_share)
+		_auth_share_set(msg->auth_share, buffers->auth,
+				msg->protocol_version, &hash, h_len);
+
 skip_auth2:
 
 	/*
@@ -1860,6 +1955,11 @@ skip_auth2:
  * Send a slurm message over an open file descriptor `fd'
  * Returns the size of the message sent in bytes, or -1 on failure.
  */
+extern uint64_t slurm_thread_bytes_sent(void)
+{
+	return thread_bytes_sent;
+}
+
 extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 {
 	msg_bufs_t buffers = { 0 };
@@ -1879,6 +1979,8 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 			return SLURM_ERROR;
 
 		rc = slurm_persist_send_msg(msg->conn, buffer);
+		if (rc >= 0)
+			thread_bytes_sent += get_buf_offset(buffer);
 		FREE_NULL_BUFFER(buffer);
 
 		if ((rc < 0) && (errno == ENOTCONN)) {
@@ -1907,6 +2009,7 @@ extern int slurm_send_node_msg(int fd, slurm_msg_t *msg)
 
 	if (rc >= 0) {
 		/* sent successfully */
+		thread_bytes_sent += rc;
 	} else if (errno == ENOTCONN) {
 		log_flag(NET, "%s: peer has disappeared for msg_type=%s",
 			 __func__, rpc_num2string(msg->msg_type));
@@ -2281,6 +2384,90 @@ _send_and_recv_msgs(int fd, slurm_msg_t *req, int timeout)
 	return ret_list;
 }
 
+/*
+ * Try to satisfy an info request from the sackd info cache on this host.
+ * IN req	- slurm_msg request
+ * OUT resp	- slurm_msg response, only valid on success
+ * RET SLURM_SUCCESS if answered by sackd, otherwise the caller should send
+ *     the request to the controller
+ */
+static int _send_recv_info_cache(slurm_msg_t *req, slurm_msg_t *resp)
+{
+	static bool no_cache = false;
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+		.sun_path = SACKD_INFO_SOCKET,
+	};
+	int fd, rc;
+
+	if (no_cache || running_in_daemon())
+		return SLURM_ERROR;
+
+	switch (req->msg_type) {
+	case REQUEST_JOB_INFO:
+	{
+		job_info_request_msg_t *job_req = req->data;
+		if (job_req->job_ids)
+			return SLURM_ERROR;
+		break;
+	}
+	case REQUEST_NODE_INFO:
+	case REQUEST_PARTITION_INFO:
+		break;
+	default:
+		return SLURM_ERROR;
+	}
+
+	if ((fd = socket(AF_UNIX, (SOCK_STREAM | SOCK_CLOEXEC), 0)) < 0)
+		return SLURM_ERROR;
+
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+		/* Don't retry for the rest of this process */
+		if ((errno == ENOENT) || (errno == ECONNREFUSED))
+			no_cache = true;
+		(void) close(fd);
+		return SLURM_ERROR;
+	}
+
+	rc = slurm_send_recv_msg(fd, req, resp, 0);
+	(void) close(fd);
+
+	if (rc) {
+		log_flag(NET, "%s: %s failed: %m",
+			 __func__, SACKD_INFO_SOCKET);
+		return SLURM_ERROR;
+	}
+
+	if (resp->auth_cred)
+		auth_g_destroy(resp->auth_cred);
+	resp->auth_cred = NULL;
+
+	if ((resp->auth_uid != slurm_conf.slurm_user_id) &&
+	    (resp->auth_uid != 0)) {
+		error("%s: rejecting response from %s sent by uid %u",
+		      __func__, SACKD_INFO_SOCKET, resp->auth_uid);
+		rc = SLURM_ERROR;
+	} else if (resp->msg_type == RESPONSE_SLURM_RC) {
+		/* sackd declined to answer, e.g. for private data */
+		rc = ((return_code_msg_t *) resp->data)->return_code;
+		if (rc == SLURM_NO_CHANGE_IN_DATA)
+			rc = SLURM_SUCCESS;
+		else
+			log_flag(NET, "%s: %s declined %s: %s",
+				 __func__, SACKD_INFO_SOCKET,
+				 rpc_num2string(req->msg_type),
+				 slurm_strerror(rc));
+	}
+
+	if (rc) {
+		slurm_free_msg_data(resp->msg_type, resp->data);
+		resp->data = NULL;
+		return SLURM_ERROR;
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * slurm_send_recv_controller_msg
  * opens a connection to the controller, sends the controller a message,
@@ -2315,6 +2502,10 @@ extern int slurm_send_recv_controller_msg(slurm_msg_t * request_msg,
 	request_msg->forward_struct = NULL;
 	slurm_msg_set_r_uid(request_msg, SLURM_AUTH_UID_ANY);
 
+	if (!comm_cluster_rec &&
+	    !_send_recv_info_cache(request_msg, response_msg))
+		return SLURM_SUCCESS;
+
 tryagain:
 	if (comm_cluster_rec)
 		request_msg->flags |= SLURM_GLOBAL_AUTH_KEY;
@@ -55,6 +55,12 @@
 #include "src/common/slurm_protocol_util.h"
 #include "src/common/slurm_protocol_interface.h"
 
+/*
+ * UNIX socket on which sackd serves cached job, node and partition info
+ * to local clients when started with --info-cache.
+ */
+#define SACKD_INFO_SOCKET "/run/slurm/info.socket"
+
 #define MIN_NOALLOC_JOBID ((uint32_t) 0xffff0000)
 #define MAX_NOALLOC_JOBID ((uint32_t) 0xfffffffd)
 
@@ -281,6 +287,12 @@ int slurm_receive_msg_and_forward(int fd, slurm_addr_t *orig_addr,
  */
 int slurm_send_node_msg(int open_fd, slurm_msg_t *msg);
 
+/*
+ * Total bytes sent by slurm_send_node_msg() from the calling thread, used to
+ * account the size of RPC replies
+ */
+extern uint64_t slurm_thread_bytes_sent(void);
+
 /**********************************************************************\
  * msg connection establishment functions used by msg clients
 \**********************************************************************/
@@ -395,6 +407,21 @@ extern int slurm_unpack_addr_array(slurm_addr_t **addr_array_ptr,
 extern int slurm_buffers_pack_msg(slurm_msg_t *msg, msg_bufs_t *buffers,
 				  bool block_for_forwarding);
 
+/*
+ * Create a credential share for a message broadcast to many nodes.
+ *
+ * Every slurm_msg_t with auth_share pointing at the share reuses the
+ * credential packed by the first send instead of creating a new one per
+ * connection, the same way forwarded copies reuse the original credential.
+ * Only use it for sends that each go to a distinct node, a node receiving
+ * the same credential twice rejects it as replayed.
+ *
+ * RET share to be freed with slurm_msg_auth_share_destroy()
+ */
+extern msg_auth_share_t *slurm_msg_auth_share_create(void);
+
+extern void slurm_msg_auth_share_destroy(msg_auth_share_t *share);
+
 /**********************************************************************\
  * simplified communication routines
  * They open a connection do work then close the connection all within
@@ -424,7 +451,9 @@ int slurm_send_rc_err_msg(slurm_msg_t *msg, int rc, char *err_msg);
 /*
  * slurm_send_recv_controller_msg
  * opens a connection to the controller, sends the controller a message,
- * listens for the response, then closes the connection
+ * listens for the response, then closes the connection.
+ * Job, node and partition info requests are answered by a local sackd info
+ * cache instead when one is running, see SACKD_INFO_SOCKET.
  * IN request_msg	- slurm_msg request
  * OUT response_msg	- slurm_msg response
  * IN comm_cluster_rec	- Communication record (host/port/version)/
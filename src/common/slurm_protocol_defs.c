@@ -1309,6 +1309,33 @@ extern void slurm_free_job_state_response_msg(job_state_response_msg_t *msg)
 	xfree(msg);
 }
 
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t *msg)
+{
+	if (!msg)
+		return;
+
+	xfree(msg->account);
+	xfree(msg->job_name);
+	xfree(msg->nodelist);
+	xfree(msg->partition);
+	xfree(msg->qos);
+	xfree(msg->reservation);
+	xfree(msg->wckey);
+	xfree(msg);
+}
+
+extern void slurm_free_kill_jobs_response_msg(kill_jobs_resp_msg_t *msg)
+{
+	if (!msg)
+		return;
+
+	for (int i = 0; i < msg->jobs_cnt; i++)
+		xfree(msg->job_responses[i].job_id_str);
+
+	xfree(msg->job_responses);
+	xfree(msg);
+}
+
 extern void slurm_free_job_step_info_request_msg(job_step_info_request_msg_t *msg)
 {
 	xfree(msg);
@@ -2069,6 +2096,28 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 			xfree(msg->rpc_dump_hostlist[i]);
 		}
 		xfree(msg->rpc_dump_hostlist);
+		for (i = 0; i < msg->lock_stats_count; i++)
+			xfree(msg->lock_stats_name[i]);
+		xfree(msg->lock_stats_name);
+		xfree(msg->lock_stats_acquired);
+		xfree(msg->lock_stats_wait_time);
+		xfree(msg->lock_stats_wait_max);
+		xfree(msg->lock_stats_hold_time);
+		xfree(msg->lock_stats_hold_max);
+		xfree(msg->lock_stats_wait_hist);
+		xfree(msg->lock_stats_hold_hist);
+		xfree(msg->rpcq_type);
+		xfree(msg->rpcq_depth_limit);
+		xfree(msg->rpcq_depth);
+		xfree(msg->rpcq_rejected);
+		xfree(msg->rpc_cost_type_id);
+		xfree(msg->rpc_cost_type_cpu_time);
+		xfree(msg->rpc_cost_type_lock_wait);
+		xfree(msg->rpc_cost_type_bytes);
+		xfree(msg->rpc_cost_user_id);
+		xfree(msg->rpc_cost_user_cpu_time);
+		xfree(msg->rpc_cost_user_lock_wait);
+		xfree(msg->rpc_cost_user_bytes);
 		xfree(msg);
 	}
 }
@@ -5484,6 +5533,12 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case RESPONSE_JOB_STATE:
 		slurm_free_job_state_response_msg(data);
 		break;
+	case REQUEST_KILL_JOBS:
+		slurm_free_kill_jobs_msg(data);
+		break;
+	case RESPONSE_KILL_JOBS:
+		slurm_free_kill_jobs_response_msg(data);
+		break;
 	case REQUEST_NODE_INFO:
 		slurm_free_node_info_request_msg(data);
 		break;
@@ -5653,6 +5708,7 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 		slurm_free_step_complete_msg(data);
 		break;
 	case REQUEST_JOB_STEP_STAT:
+	case REQUEST_JOB_STEP_STAT_REDUCED:
 	case REQUEST_JOB_STEP_PIDS:
 	case REQUEST_STEP_LAYOUT:
 		slurm_free_step_id(data);
@@ -5870,7 +5926,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOB_LIST:
 	case RESPONSE_HET_JOB_ALLOCATION:
+	case RESPONSE_SUBMIT_BATCH_JOB_LIST:
 		FREE_NULL_LIST(data);
 		break;
 	case REQUEST_SET_FS_DAMPENING_FACTOR:
@@ -6291,6 +6349,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_HET_JOB_ALLOC_INFO";
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
 		return "REQUEST_SUBMIT_BATCH_HET_JOB";
+	case REQUEST_SUBMIT_BATCH_JOB_LIST:
+		return "REQUEST_SUBMIT_BATCH_JOB_LIST";
+	case RESPONSE_SUBMIT_BATCH_JOB_LIST:			/* 4030 */
+		return "RESPONSE_SUBMIT_BATCH_JOB_LIST";
 
 	case REQUEST_JOB_STEP_CREATE:				/* 5001 */
 		return "REQUEST_JOB_STEP_CREATE";
@@ -6351,6 +6413,12 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_AUTH_TOKEN";
 	case RESPONSE_AUTH_TOKEN:
 		return "RESPONSE_AUTH_TOKEN";
+	case REQUEST_KILL_JOBS:
+		return "REQUEST_KILL_JOBS";
+	case RESPONSE_KILL_JOBS:
+		return "RESPONSE_KILL_JOBS";
+	case REQUEST_JOB_STEP_STAT_REDUCED:
+		return "REQUEST_JOB_STEP_STAT_REDUCED";
 
 	case REQUEST_LAUNCH_TASKS:				/* 6001 */
 		return "REQUEST_LAUNCH_TASKS";
@@ -371,6 +371,8 @@ typedef enum {
 	RESPONSE_HET_JOB_ALLOCATION,
 	REQUEST_HET_JOB_ALLOC_INFO,
 	REQUEST_SUBMIT_BATCH_HET_JOB,
+	REQUEST_SUBMIT_BATCH_JOB_LIST,
+	RESPONSE_SUBMIT_BATCH_JOB_LIST,		/* 4030 */
 
 	REQUEST_CTLD_MULT_MSG = 4500,
 	RESPONSE_CTLD_MULT_MSG,
@@ -420,6 +422,9 @@ typedef enum {
 	REQUEST_TOP_JOB,		/* 5038 */
 	REQUEST_AUTH_TOKEN,
 	RESPONSE_AUTH_TOKEN,
+	REQUEST_KILL_JOBS,
+	RESPONSE_KILL_JOBS,
+	REQUEST_JOB_STEP_STAT_REDUCED,
 
 	REQUEST_LAUNCH_TASKS = 6001,
 	RESPONSE_LAUNCH_TASKS,
@@ -512,6 +517,9 @@ typedef struct forward {
 	uint16_t   tree_width;  /* what the treewidth should be */
 } forward_t;
 
+/* Opaque, see slurm_msg_auth_share_create() */
+typedef struct msg_auth_share msg_auth_share_t;
+
 /*core api protocol message structures */
 typedef struct slurm_protocol_header {
 	uint16_t version;
@@ -581,6 +589,9 @@ typedef struct slurm_msg {
 				     */
 	int conn_fd; /* Only used when the message isn't on a persistent
 		      * connection. */
+	msg_auth_share_t *auth_share; /* DON'T PACK OR FREE! credential shared
+				       * by every copy of this message sent to
+				       * a distinct node. */
 	void *data;
 	uint16_t flags;
 	uint8_t hash_index;	/* DON'T PACK: zero for normal communication.
@@ -1227,6 +1238,8 @@ typedef enum {
 	FILE_BCAST_LAST_BLOCK = 1 << 1,	/* last file block */
 	FILE_BCAST_SO = 1 << 2, 	/* shared object */
 	FILE_BCAST_EXE = 1 << 3,	/* executable ahead of shared object */
+	FILE_BCAST_PROBE = 1 << 4,	/* no data, check for an existing copy
+					 * of the shared object */
 } file_bcast_flags_t;
 
 typedef struct file_bcast_msg {
@@ -1637,6 +1650,7 @@ extern void slurm_free_container_id_response_msg(
 	container_id_response_msg_t *msg);
 extern void slurm_free_job_info_request_msg(job_info_request_msg_t *msg);
 extern void slurm_free_job_state_request_msg(job_state_request_msg_t *msg);
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t *msg);
 extern void slurm_free_job_step_info_request_msg(
 		job_step_info_request_msg_t *msg);
 extern void slurm_free_front_end_info_request_msg(
@@ -663,10 +663,9 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
-static void
-_pack_priority_factors_response_msg(priority_factors_response_msg_t * msg,
-				    buf_t *buffer,
-				    uint16_t protocol_version)
+extern void
+pack_priority_factors_response_msg(priority_factors_response_msg_t *msg,
+				   buf_t *buffer, uint16_t protocol_version)
 {
 	list_itr_t *itr = NULL;
 	priority_factors_object_t *factors = NULL;
@@ -1491,6 +1490,59 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void _pack_submit_response_list_msg(const slurm_msg_t *smsg,
+					   buf_t *buffer)
+{
+	list_t *resp_list = smsg->data;
+	submit_response_msg_t *msg;
+	list_itr_t *iter;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		pack32(list_count(resp_list), buffer);
+
+		iter = list_iterator_create(resp_list);
+		while ((msg = list_next(iter))) {
+			pack32(msg->job_id, buffer);
+			pack32(msg->step_id, buffer);
+			pack32(msg->error_code, buffer);
+			packstr(msg->job_submit_user_msg, buffer);
+		}
+		list_iterator_destroy(iter);
+	}
+}
+
+static int _unpack_submit_response_list_msg(slurm_msg_t *smsg, buf_t *buffer)
+{
+	list_t *resp_list = list_create((ListDelF)
+		slurm_free_submit_response_response_msg);
+	submit_response_msg_t *msg;
+	uint32_t cnt;
+
+	smsg->data = resp_list;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		safe_unpack32(&cnt, buffer);
+		if (cnt > NO_VAL16)
+			goto unpack_error;
+
+		for (uint32_t i = 0; i < cnt; i++) {
+			msg = xmalloc(sizeof(*msg));
+			list_append(resp_list, msg);
+			safe_unpack32(&msg->job_id, buffer);
+			safe_unpack32(&msg->step_id, buffer);
+			safe_unpack32(&msg->error_code, buffer);
+			safe_unpackstr(&msg->job_submit_user_msg, buffer);
+		}
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	FREE_NULL_LIST(resp_list);
+	smsg->data = NULL;
+	return SLURM_ERROR;
+}
+
 static int _unpack_node_info_msg(node_info_msg_t **msg, buf_t *buffer,
 				 uint16_t protocol_version)
 {
@@ -2092,7 +2144,7 @@ extern int slurm_pack_list(List send_list,
 		void *object = NULL;
 		while ((object = list_next(itr))) {
 			(*(pack_function))(object, protocol_version, buffer);
-			if (size_buf(buffer) > REASONABLE_BUF_SIZE) {
+			if (get_buf_offset(buffer) > REASONABLE_BUF_SIZE) {
 				error("%s: size limit exceeded", __func__);
 				/*
 				 * rewind buffer, pack NO_VAL as count instead
@@ -2135,7 +2187,7 @@ extern int slurm_pack_list_until(List send_list, pack_function_t pack_function,
 		count = 0;
 		while ((object = list_next(itr))) {
 			(*(pack_function))(object, protocol_version, buffer);
-			if (size_buf(buffer) > max_buf_size) {
+			if (get_buf_offset(buffer) > max_buf_size) {
 				/*
 				 * rewind by one element to stay smaller than
 				 * max_buf_size
@@ -7123,6 +7175,100 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void _pack_kill_jobs_msg(const slurm_msg_t *smsg, buf_t *buffer)
+{
+	kill_jobs_msg_t *msg = smsg->data;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		packstr(msg->account, buffer);
+		pack16(msg->flags, buffer);
+		packstr(msg->job_name, buffer);
+		packstr(msg->nodelist, buffer);
+		packstr(msg->partition, buffer);
+		packstr(msg->qos, buffer);
+		packstr(msg->reservation, buffer);
+		pack16(msg->signal, buffer);
+		pack32(msg->state, buffer);
+		pack32(msg->user_id, buffer);
+		packstr(msg->wckey, buffer);
+	}
+}
+
+static int _unpack_kill_jobs_msg(slurm_msg_t *smsg, buf_t *buffer)
+{
+	kill_jobs_msg_t *msg = xmalloc(sizeof(*msg));
+	smsg->data = msg;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		safe_unpackstr(&msg->account, buffer);
+		safe_unpack16(&msg->flags, buffer);
+		safe_unpackstr(&msg->job_name, buffer);
+		safe_unpackstr(&msg->nodelist, buffer);
+		safe_unpackstr(&msg->partition, buffer);
+		safe_unpackstr(&msg->qos, buffer);
+		safe_unpackstr(&msg->reservation, buffer);
+		safe_unpack16(&msg->signal, buffer);
+		safe_unpack32(&msg->state, buffer);
+		safe_unpack32(&msg->user_id, buffer);
+		safe_unpackstr(&msg->wckey, buffer);
+	} else {
+		goto unpack_error;
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	smsg->data = NULL;
+	slurm_free_kill_jobs_msg(msg);
+	return SLURM_ERROR;
+}
+
+static void _pack_kill_jobs_resp_msg(const slurm_msg_t *smsg, buf_t *buffer)
+{
+	kill_jobs_resp_msg_t *msg = smsg->data;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		pack32(msg->jobs_cnt, buffer);
+		for (int i = 0; i < msg->jobs_cnt; i++) {
+			pack32(msg->job_responses[i].error_code, buffer);
+			packstr(msg->job_responses[i].job_id_str, buffer);
+		}
+	}
+}
+
+static int _unpack_kill_jobs_resp_msg(slurm_msg_t *smsg, buf_t *buffer)
+{
+	kill_jobs_resp_msg_t *msg = xmalloc(sizeof(*msg));
+	smsg->data = msg;
+
+	if (smsg->protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->jobs_cnt, buffer);
+
+		if (msg->jobs_cnt >= MAX_JOB_ID)
+			goto unpack_error;
+
+		if (msg->jobs_cnt &&
+		    !(msg->job_responses = try_xcalloc(
+			      msg->jobs_cnt, sizeof(*msg->job_responses))))
+			goto unpack_error;
+
+		for (int i = 0; i < msg->jobs_cnt; i++) {
+			kill_jobs_resp_job_t *job = &msg->job_responses[i];
+			safe_unpack32(&job->error_code, buffer);
+			safe_unpackstr(&job->job_id_str, buffer);
+		}
+	} else {
+		goto unpack_error;
+	}
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	smsg->data = NULL;
+	slurm_free_kill_jobs_response_msg(msg);
+	return SLURM_ERROR;
+}
+
 static int _unpack_burst_buffer_info_msg(
 	burst_buffer_info_msg_t **burst_buffer_info, buf_t *buffer,
 	uint16_t protocol_version)
@@ -9387,6 +9533,93 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 				     buffer);
 		if (uint32_tmp != msg->rpc_dump_count)
 			goto unpack_error;
+
+		if (protocol_version >= SLURM_24_08_PROTOCOL_VERSION) {
+			uint32_t hist_cnt;
+
+			safe_unpackstr_array(&msg->lock_stats_name,
+					     &msg->lock_stats_count, buffer);
+			safe_unpack64_array(&msg->lock_stats_acquired,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_stats_wait_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_stats_wait_max,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_stats_hold_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_stats_hold_max,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->lock_stats_count)
+				goto unpack_error;
+			safe_unpack32(&msg->lock_stats_hist_count, buffer);
+			hist_cnt = msg->lock_stats_count *
+				   msg->lock_stats_hist_count;
+			safe_unpack64_array(&msg->lock_stats_wait_hist,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != hist_cnt)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_stats_hold_hist,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != hist_cnt)
+				goto unpack_error;
+
+			safe_unpack16_array(&msg->rpcq_type,
+					    &msg->rpcq_count, buffer);
+			safe_unpack32_array(&msg->rpcq_depth_limit,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpcq_count)
+				goto unpack_error;
+			safe_unpack32_array(&msg->rpcq_depth,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpcq_count)
+				goto unpack_error;
+			safe_unpack64_array(&msg->rpcq_rejected,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpcq_count)
+				goto unpack_error;
+
+			safe_unpack16_array(&msg->rpc_cost_type_id,
+					    &msg->rpc_cost_type_size, buffer);
+			safe_unpack64_array(&msg->rpc_cost_type_cpu_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_type_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->rpc_cost_type_lock_wait,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_type_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->rpc_cost_type_bytes,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_type_size)
+				goto unpack_error;
+
+			safe_unpack32_array(&msg->rpc_cost_user_id,
+					    &msg->rpc_cost_user_size, buffer);
+			safe_unpack64_array(&msg->rpc_cost_user_cpu_time,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_user_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->rpc_cost_user_lock_wait,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_user_size)
+				goto unpack_error;
+			safe_unpack64_array(&msg->rpc_cost_user_bytes,
+					    &uint32_tmp, buffer);
+			if (uint32_tmp != msg->rpc_cost_user_size)
+				goto unpack_error;
+
+			safe_unpack32(&msg->schedule_adapt_interval, buffer);
+			safe_unpack32(&msg->schedule_adapt_depth, buffer);
+			safe_unpack32(&msg->schedule_adapt_pressure, buffer);
+		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->parts_packed,	buffer);
 		if (msg->parts_packed) {
@@ -10339,6 +10572,26 @@ unpack_error:
  *			automatically updated
  * RET 0 or error code
  */
+extern bool pack_msg_is_buf(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case RESPONSE_ASSOC_MGR_INFO:
+	case RESPONSE_BURST_BUFFER_INFO:
+	case RESPONSE_FRONT_END_INFO:
+	case RESPONSE_JOB_INFO:
+	case RESPONSE_JOB_STEP_INFO:
+	case RESPONSE_LICENSE_INFO:
+	case RESPONSE_NODE_INFO:
+	case RESPONSE_PARTITION_INFO:
+	case RESPONSE_PRIORITY_FACTORS:
+	case RESPONSE_RESERVATION_INFO:
+	case RESPONSE_STATS_INFO:
+		return true;
+	default:
+		return false;
+	}
+}
+
 int
 pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 {
@@ -10358,6 +10611,7 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case RESPONSE_LICENSE_INFO:
 	case RESPONSE_NODE_INFO:
 	case RESPONSE_PARTITION_INFO:
+	case RESPONSE_PRIORITY_FACTORS:
 	case RESPONSE_RESERVATION_INFO:
 	case RESPONSE_STATS_INFO:
 		_pack_buf_msg(msg, buffer);
@@ -10413,6 +10667,7 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOB_LIST:
 		_pack_job_desc_list_msg((List) msg->data, buffer,
 					msg->protocol_version);
 		break;
@@ -10501,6 +10756,9 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case RESPONSE_SUBMIT_BATCH_JOB:
 		_pack_submit_response_msg(msg, buffer);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_LIST:
+		_pack_submit_response_list_msg(msg, buffer);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		_pack_resource_allocation_response_msg(msg, buffer);
@@ -10591,6 +10849,12 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case RESPONSE_JOB_STATE:
 		_pack_job_state_response_msg(msg, buffer);
 		break;
+	case REQUEST_KILL_JOBS:
+		_pack_kill_jobs_msg(msg, buffer);
+		break;
+	case RESPONSE_KILL_JOBS:
+		_pack_kill_jobs_resp_msg(msg, buffer);
+		break;
 	case REQUEST_CANCEL_JOB_STEP:
 	case REQUEST_KILL_JOB:
 	case SRUN_STEP_SIGNAL:
@@ -10627,6 +10891,7 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 	case SRUN_JOB_COMPLETE:
 	case REQUEST_STEP_LAYOUT:
 	case REQUEST_JOB_STEP_STAT:
+	case REQUEST_JOB_STEP_STAT_REDUCED:
 	case REQUEST_JOB_STEP_PIDS:
 		pack_step_id((slurm_step_id_t *)msg->data, buffer,
 			     msg->protocol_version);
@@ -10785,12 +11050,6 @@ pack_msg(slurm_msg_t const *msg, buf_t *buffer)
 		break;
 	case REQUEST_PRIORITY_FACTORS:
 		break;
-	case RESPONSE_PRIORITY_FACTORS:
-		_pack_priority_factors_response_msg(
-			(priority_factors_response_msg_t*)msg->data,
-			buffer,
-			msg->protocol_version);
-		break;
 	case REQUEST_FILE_BCAST:
 		_pack_file_bcast((file_bcast_msg_t *) msg->data, buffer,
 				 msg->protocol_version);
@@ -11052,6 +11311,7 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 		break;
 	case REQUEST_HET_JOB_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_HET_JOB:
+	case REQUEST_SUBMIT_BATCH_JOB_LIST:
 		rc = _unpack_job_desc_list_msg((List *) &(msg->data),
 					       buffer, msg->protocol_version);
 		break;
@@ -11144,6 +11404,9 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 	case RESPONSE_SUBMIT_BATCH_JOB:
 		rc = _unpack_submit_response_msg(msg, buffer);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOB_LIST:
+		rc = _unpack_submit_response_list_msg(msg, buffer);
+		break;
 	case RESPONSE_JOB_ALLOCATION_INFO:
 	case RESPONSE_RESOURCE_ALLOCATION:
 		rc = _unpack_resource_allocation_response_msg(msg, buffer);
@@ -11240,6 +11503,12 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 	case RESPONSE_JOB_STATE:
 		rc = _unpack_job_state_response_msg(msg, buffer);
 		break;
+	case REQUEST_KILL_JOBS:
+		rc = _unpack_kill_jobs_msg(msg, buffer);
+		break;
+	case RESPONSE_KILL_JOBS:
+		rc = _unpack_kill_jobs_resp_msg(msg, buffer);
+		break;
 	case REQUEST_CANCEL_JOB_STEP:
 	case REQUEST_KILL_JOB:
 	case SRUN_STEP_SIGNAL:
@@ -11277,6 +11546,7 @@ unpack_msg(slurm_msg_t * msg, buf_t *buffer)
 	case SRUN_JOB_COMPLETE:
 	case REQUEST_STEP_LAYOUT:
 	case REQUEST_JOB_STEP_STAT:
+	case REQUEST_JOB_STEP_STAT_REDUCED:
 	case REQUEST_JOB_STEP_PIDS:
 		rc = unpack_step_id((slurm_step_id_t **)&msg->data,
 				    buffer, msg->protocol_version);
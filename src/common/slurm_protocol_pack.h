@@ -84,6 +84,14 @@ extern int unpack_header(header_t *header, buf_t *buffer);
  */
 extern int pack_msg(slurm_msg_t const *msg, buf_t *buffer);
 
+/*
+ * Check if a message body is carried as an already packed buf_t
+ * (e.g. RESPONSE_JOB_INFO), in which case pack_msg() is a plain copy.
+ * IN msg_type - message type
+ * RET true if msg->data is a pre-packed buf_t
+ */
+extern bool pack_msg_is_buf(uint16_t msg_type);
+
 /*
  * unpacks a generic slurm protocol message body
  * OUT msg - the body structure to unpack (note: includes message type)
@@ -127,6 +135,14 @@ extern void pack_config_response_msg(config_response_msg_t *msg,
 extern int unpack_config_response_msg(config_response_msg_t **msg_ptr,
 				      buf_t *buffer, uint16_t protocol_version);
 
+/*
+ * Pack the body of a RESPONSE_PRIORITY_FACTORS message. The message is sent
+ * as a pre-packed buffer so the caller can drop its locks before sending.
+ */
+extern void pack_priority_factors_response_msg(
+	priority_factors_response_msg_t *msg, buf_t *buffer,
+	uint16_t protocol_version);
+
 extern void pack_step_id(slurm_step_id_t *msg, buf_t *buffer,
 			 uint16_t protocol_version);
 extern int unpack_step_id_members(slurm_step_id_t *msg, buf_t *buffer,
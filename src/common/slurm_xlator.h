@@ -107,6 +107,8 @@
 #define	bit_super_set		slurm_bit_super_set
 #define	bit_overlap		slurm_bit_overlap
 #define	bit_overlap_any		slurm_bit_overlap_any
+#define	bit_overlap_ffs		slurm_bit_overlap_ffs
+#define	bit_overlap_and_not	slurm_bit_overlap_and_not
 #define	bit_copy		slurm_bit_copy
 #define	bit_equal		slurm_bit_equal
 #define	bit_pick_cnt		slurm_bit_pick_cnt
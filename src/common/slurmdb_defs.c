@@ -3548,7 +3548,7 @@ extern char *slurmdb_tres_string_combine_lists(
 {
 	slurmdb_tres_rec_t *tres_rec = NULL, *tres_rec_old;
 	list_itr_t *itr;
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 
 	if (!tres_list_new || !list_count(tres_list_new))
 		return NULL;
@@ -3560,10 +3560,9 @@ extern char *slurmdb_tres_string_combine_lists(
 						     &tres_rec->id))
 		    || (tres_rec_old->count == INFINITE64))
 			continue;
-		if (tres_str)
-			xstrcat(tres_str, ",");
-		xstrfmtcat(tres_str, "%u=%"PRIu64,
-			   tres_rec->id, tres_rec->count);
+		xstrfmtcatat(tres_str, &pos, "%s%u=%"PRIu64,
+			     tres_str ? "," : "",
+			     tres_rec->id, tres_rec->count);
 	}
 	list_iterator_destroy(itr);
 
@@ -3573,7 +3572,7 @@ extern char *slurmdb_tres_string_combine_lists(
 /* caller must xfree this char * returned */
 extern char *slurmdb_make_tres_string(List tres, uint32_t flags)
 {
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 	list_itr_t *itr;
 	slurmdb_tres_rec_t *tres_rec;
 
@@ -3587,19 +3586,19 @@ extern char *slurmdb_make_tres_string(List tres, uint32_t flags)
 			continue;
 
 		if ((flags & TRES_STR_FLAG_SIMPLE) || !tres_rec->type)
-			xstrfmtcat(tres_str, "%s%u=%"PRIu64,
-				   (tres_str ||
-				    (flags & TRES_STR_FLAG_COMMA1)) ? "," : "",
-				   tres_rec->id, tres_rec->count);
+			xstrfmtcatat(tres_str, &pos, "%s%u=%"PRIu64,
+				     (tres_str ||
+				      (flags & TRES_STR_FLAG_COMMA1)) ? "," : "",
+				     tres_rec->id, tres_rec->count);
 
 		else
-			xstrfmtcat(tres_str, "%s%s%s%s=%"PRIu64,
-				   (tres_str ||
-				    (flags & TRES_STR_FLAG_COMMA1)) ? "," : "",
-				   tres_rec->type,
-				   tres_rec->name ? "/" : "",
-				   tres_rec->name ? tres_rec->name : "",
-				   tres_rec->count);
+			xstrfmtcatat(tres_str, &pos, "%s%s%s%s=%"PRIu64,
+				     (tres_str ||
+				      (flags & TRES_STR_FLAG_COMMA1)) ? "," : "",
+				     tres_rec->type,
+				     tres_rec->name ? "/" : "",
+				     tres_rec->name ? tres_rec->name : "",
+				     tres_rec->count);
 	}
 	list_iterator_destroy(itr);
 
@@ -3611,7 +3610,7 @@ extern char *slurmdb_make_tres_string_from_arrays(char **tres_names,
 						  uint32_t tres_cnt,
 						  uint32_t flags)
 {
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 	int i;
 
 	if (!tres_names || !tres_cnts)
@@ -3621,8 +3620,8 @@ extern char *slurmdb_make_tres_string_from_arrays(char **tres_names,
 		if ((tres_cnts[i] == INFINITE64) &&
 		    (flags & TRES_STR_FLAG_REMOVE))
 			continue;
-		xstrfmtcat(tres_str, "%s%s=%"PRIu64,
-			   tres_str ? "," : "", tres_names[i], tres_cnts[i]);
+		xstrfmtcatat(tres_str, &pos, "%s%s=%"PRIu64,
+			     tres_str ? "," : "", tres_names[i], tres_cnts[i]);
 	}
 
 	return tres_str;
@@ -3632,7 +3631,7 @@ extern char *slurmdb_make_tres_string_from_simple(
 	char *tres_in, List full_tres_list, int spec_unit,
 	uint32_t convert_flags, uint32_t tres_str_flags, char *nodes)
 {
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 	char *tmp_str = tres_in;
 	int id;
 	uint64_t count;
@@ -3670,19 +3669,19 @@ extern char *slurmdb_make_tres_string_from_simple(
 			goto get_next;
 
 		if (tres_str)
-			xstrcat(tres_str, ",");
+			xstrcatat(tres_str, &pos, ",");
 		if (!tres_rec->type)
-			xstrfmtcat(tres_str, "%u=", tres_rec->id);
+			xstrfmtcatat(tres_str, &pos, "%u=", tres_rec->id);
 
 		else
-			xstrfmtcat(tres_str, "%s%s%s=",
-				   tres_rec->type,
-				   tres_rec->name ? "/" : "",
-				   tres_rec->name ? tres_rec->name : "");
+			xstrfmtcatat(tres_str, &pos, "%s%s%s=",
+				     tres_rec->type,
+				     tres_rec->name ? "/" : "",
+				     tres_rec->name ? tres_rec->name : "");
 		if (count != INFINITE64) {
 			if (nodes) {
 				node_name = find_hostname(count, nodes);
-				xstrfmtcat(tres_str, "%s", node_name);
+				xstrcatat(tres_str, &pos, node_name);
 				xfree(node_name);
 			} else if (tres_str_flags & TRES_STR_FLAG_BYTES) {
 				/* This mean usage */
@@ -3697,7 +3696,7 @@ extern char *slurmdb_make_tres_string_from_simple(
 							 UNIT_NONE,
 							 spec_unit,
 							 convert_flags);
-				xstrfmtcat(tres_str, "%s", outbuf);
+				xstrcatat(tres_str, &pos, outbuf);
 			} else if ((tres_rec->id == TRES_MEM) ||
 				   !xstrcasecmp(tres_rec->name, "gpumem") ||
 				   !xstrcasecmp(tres_rec->type, "bb")) {
@@ -3705,18 +3704,19 @@ extern char *slurmdb_make_tres_string_from_simple(
 				convert_num_unit((double)count, outbuf,
 						 sizeof(outbuf), UNIT_MEGA,
 						 spec_unit, convert_flags);
-				xstrfmtcat(tres_str, "%s", outbuf);
+				xstrcatat(tres_str, &pos, outbuf);
 			} else {
-				xstrfmtcat(tres_str, "%"PRIu64, count);
+				xstrfmtcatat(tres_str, &pos, "%"PRIu64, count);
 			}
 		} else
-			xstrfmtcat(tres_str, "NONE");
+			xstrcatat(tres_str, &pos, "NONE");
 
 		if (!(tres_str_flags & TRES_STR_FLAG_SORT_ID)) {
 			if (!char_list)
 				char_list = list_create(xfree_ptr);
 			list_append(char_list, tres_str);
 			tres_str = NULL;
+			pos = NULL;
 		}
 	get_next:
 		if (!(tmp_str = strchr(tmp_str, ',')))
@@ -3735,7 +3735,7 @@ extern char *slurmdb_make_tres_string_from_simple(
 extern char *slurmdb_format_tres_str(
 	char *tres_in, List full_tres_list, bool simple)
 {
-	char *tres_str = NULL;
+	char *tres_str = NULL, *pos = NULL;
 	char *val_unit = NULL;
 	char *tmp_str = tres_in;
 	uint64_t count;
@@ -3806,17 +3806,17 @@ extern char *slurmdb_format_tres_str(
 		}
 
 		if (tres_str)
-			xstrcat(tres_str, ",");
+			xstrcatat(tres_str, &pos, ",");
 		if (simple || !tres_rec->type)
-			xstrfmtcat(tres_str, "%u=%"PRIu64"",
-				   tres_rec->id, count);
+			xstrfmtcatat(tres_str, &pos, "%u=%"PRIu64"",
+				     tres_rec->id, count);
 
 		else
-			xstrfmtcat(tres_str, "%s%s%s=%"PRIu64"",
-				   tres_rec->type,
-				   tres_rec->name ? "/" : "",
-				   tres_rec->name ? tres_rec->name : "",
-				   count);
+			xstrfmtcatat(tres_str, &pos, "%s%s%s=%"PRIu64"",
+				     tres_rec->type,
+				     tres_rec->name ? "/" : "",
+				     tres_rec->name ? tres_rec->name : "",
+				     count);
 		if (!(tmp_str = strchr(tmp_str, ',')))
 			break;
 		tmp_str++;
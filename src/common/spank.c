@@ -158,6 +158,8 @@ typedef enum step_fn {
 	SPANK_EXIT
 } step_fn_t;
 
+#define SPANK_FN_CNT (SPANK_EXIT + 1)
+
 /*
  *  Job information in prolog/epilog context:
  */
@@ -187,6 +189,11 @@ struct spank_stack {
 	List option_cache;           /*  Cache of plugin options in this ctx */
 	int  spank_optval;           /*  optvalue for next plugin option     */
 	const char * plugin_path;    /*  default path to search for plugins  */
+	/*
+	 *  NULL terminated arrays of the plugins implementing each step_fn_t,
+	 *   in stack order. NULL if no plugin implements that callback.
+	 */
+	struct spank_plugin **dispatch[SPANK_FN_CNT];
 };
 
 /*
@@ -207,15 +214,48 @@ static void _spank_stack_get_remote_options_env(struct spank_stack *, char **);
 static void _spank_stack_set_remote_options_env(struct spank_stack *stack);
 static int dyn_spank_set_job_env (const char *var, const char *val, int ovwt);
 static char *_opt_env_name(struct spank_plugin_opt *p, char *buf, size_t siz);
+static spank_f *spank_plugin_get_fn (struct spank_plugin *sp, step_fn_t type);
 
 static void spank_stack_destroy (struct spank_stack *stack)
 {
+	for (int i = 0; i < SPANK_FN_CNT; i++)
+		xfree(stack->dispatch[i]);
 	FREE_NULL_LIST (stack->plugin_list);
 	FREE_NULL_LIST (stack->option_cache);
 	xfree (stack->plugin_path);
 	xfree (stack);
 }
 
+/*
+ *  Resolve once which plugins implement each callback so that calling the
+ *   stack (once per step, or once per task for the task callbacks) does not
+ *   walk every loaded plugin.
+ */
+static void _spank_stack_build_dispatch (struct spank_stack *stack)
+{
+	int cnt = list_count (stack->plugin_list);
+
+	for (step_fn_t type = SPANK_INIT; type < SPANK_FN_CNT; type++) {
+		struct spank_plugin *sp;
+		list_itr_t *i;
+		int n = 0;
+
+		if (type == 1)	/* Not a valid step_fn_t */
+			continue;
+
+		i = list_iterator_create (stack->plugin_list);
+		while ((sp = list_next (i))) {
+			if (!spank_plugin_get_fn (sp, type))
+				continue;
+			if (!stack->dispatch[type])
+				stack->dispatch[type] =
+					xcalloc (cnt + 1, sizeof (sp));
+			stack->dispatch[type][n++] = sp;
+		}
+		list_iterator_destroy (i);
+	}
+}
+
 static struct spank_stack *
 spank_stack_create (const char *file, enum spank_context_type type)
 {
@@ -238,6 +278,8 @@ spank_stack_create (const char *file, enum spank_context_type type)
 		return (NULL);
 	}
 
+	_spank_stack_build_dispatch (stack);
+
 	return (stack);
 }
 
@@ -729,29 +771,26 @@ static int _do_call_stack(struct spank_stack *stack,
 	step_fn_t type, void * job, int taskid)
 {
 	int rc = SLURM_SUCCESS;
-	list_itr_t *i;
-	struct spank_plugin *sp;
+	struct spank_plugin **plugins;
 	struct spank_handle spank[1];
 	const char *fn_name;
 
 	if (!stack)
 		return ESPANK_BAD_ARG;
 
+	if (!(plugins = stack->dispatch[type]))
+		return rc;	/* No plugin implements this callback */
+
 	_spank_handle_init(spank, stack, job, taskid, type);
 	fn_name = _step_fn_name(type);
 
-	i = list_iterator_create(stack->plugin_list);
-	while ((sp = list_next(i))) {
+	for (; *plugins; plugins++) {
+		struct spank_plugin *sp = *plugins;
 		const char *name = xbasename(sp->fq_path);
-		spank_f *spank_fn;
 
 		spank->plugin = sp;
 
-		spank_fn = spank_plugin_get_fn (sp, type);
-		if (!spank_fn)
-			continue;
-
-		rc = (*spank_fn) (spank, sp->ac, sp->argv);
+		rc = (*spank_plugin_get_fn(sp, type)) (spank, sp->ac, sp->argv);
 		debug2("spank: %s: %s = %d", name, fn_name, rc);
 
 		if (rc && sp->required) {
@@ -762,8 +801,6 @@ static int _do_call_stack(struct spank_stack *stack,
 			rc = SLURM_SUCCESS;
 	}
 
-	list_iterator_destroy(i);
-
 	return rc;
 }
 
@@ -1656,12 +1693,34 @@ static void _spank_stack_get_remote_options_env(struct spank_stack *stack,
 	struct spank_plugin_opt *option;
 	list_itr_t *i;
 	List option_cache = stack->option_cache;
+	int len = strlen (SPANK_OPTION_ENV_PREFIX);
+	char **ep;
 
-	if (!option_cache)
+	if (!option_cache || !env)
+		return;
+
+	/*
+	 *  Options are normally received in the launch message, the
+	 *   environment is only needed for steps without one (e.g. batch
+	 *   steps). Avoid searching env for every option if there are no
+	 *   option variables in it at all.
+	 */
+	for (ep = env; *ep; ep++) {
+		if (!xstrncmp (*ep, SPANK_OPTION_ENV_PREFIX, len))
+			break;
+	}
+	if (!*ep)
 		return;
 
 	i = list_iterator_create (option_cache);
 	while ((option = list_next (i))) {
+		/*
+		 *  Already processed from the launch message, the
+		 *   environment copy is cleared by the caller.
+		 */
+		if (option->found)
+			continue;
+
 		if (!(arg = getenvp (env, _opt_env_name (option, var, sizeof(var)))))
 			continue;
 
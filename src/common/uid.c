@@ -181,19 +181,6 @@ extern char *uid_to_string(uid_t uid)
 	return result;
 }
 
-static int _uid_compare(const void *a, const void *b)
-{
-	uid_t ua = *(const uid_t *)a;
-	uid_t ub = *(const uid_t *)b;
-
-	if (ua < ub)
-		return -1;
-	else if (ua > ub)
-		return 1;
-
-	return 0;
-}
-
 extern void uid_cache_clear(void)
 {
 	int i;
@@ -206,27 +193,61 @@ extern void uid_cache_clear(void)
 	slurm_mutex_unlock(&uid_lock);
 }
 
+/* Return index of first entry with uid >= target uid */
+static int _uid_cache_index(uid_t uid)
+{
+	int lo = 0, hi = uid_cache_used;
+
+	while (lo < hi) {
+		int mid = lo + ((hi - lo) / 2);
+
+		if (uid_cache[mid].uid < uid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
 extern char *uid_to_string_cached(uid_t uid)
 {
-	uid_cache_entry_t *entry;
-	uid_cache_entry_t target = {uid, NULL};
+	char *username;
+	int i;
 
 	slurm_mutex_lock(&uid_lock);
-	entry = bsearch(&target, uid_cache, uid_cache_used,
-			sizeof(uid_cache_entry_t), _uid_compare);
-	if (entry == NULL) {
-		uid_cache_entry_t new_entry = {uid, uid_to_string(uid)};
-		uid_cache_used++;
-		uid_cache = xrealloc(uid_cache,
-				     sizeof(uid_cache_entry_t)*uid_cache_used);
-		uid_cache[uid_cache_used-1] = new_entry;
-		qsort(uid_cache, uid_cache_used, sizeof(uid_cache_entry_t),
-		      _uid_compare);
+	i = _uid_cache_index(uid);
+	if ((i < uid_cache_used) && (uid_cache[i].uid == uid)) {
+		username = uid_cache[i].username;
 		slurm_mutex_unlock(&uid_lock);
-		return new_entry.username;
+		return username;
 	}
 	slurm_mutex_unlock(&uid_lock);
-	return entry->username;
+
+	/* Query the name service without blocking other cached lookups */
+	username = uid_to_string(uid);
+
+	slurm_mutex_lock(&uid_lock);
+	i = _uid_cache_index(uid);
+	if ((i < uid_cache_used) && (uid_cache[i].uid == uid)) {
+		/* Another thread added this uid while unlocked */
+		xfree(username);
+		username = uid_cache[i].username;
+		slurm_mutex_unlock(&uid_lock);
+		return username;
+	}
+
+	/* Insert in place to keep the cache sorted */
+	uid_cache = xrealloc(uid_cache,
+			     sizeof(uid_cache_entry_t) * (uid_cache_used + 1));
+	memmove(&uid_cache[i + 1], &uid_cache[i],
+		sizeof(uid_cache_entry_t) * (uid_cache_used - i));
+	uid_cache[i].uid = uid;
+	uid_cache[i].username = username;
+	uid_cache_used++;
+	slurm_mutex_unlock(&uid_lock);
+
+	return username;
 }
 
 extern char *uid_to_dir(uid_t uid)
@@ -65,7 +65,10 @@ struct workq_s {
 	int threads;
 
 	pthread_mutex_t mutex;
+	/* signaled when work is added or on shutdown */
 	pthread_cond_t cond;
+	/* signaled when active drops to 0 */
+	pthread_cond_t idle_cond;
 };
 
 typedef struct {
@@ -173,6 +176,7 @@ extern workq_t *new_workq(int count)
 
 	slurm_mutex_init(&workq->mutex);
 	slurm_cond_init(&workq->cond, NULL);
+	slurm_cond_init(&workq->idle_cond, NULL);
 
 	_check_magic_workq(workq);
 
@@ -203,7 +207,7 @@ static void _wait_workers_idle(workq_t *workq)
 		 __func__, list_count(workq->work));
 
 	while (workq->active)
-		slurm_cond_wait(&workq->cond, &workq->mutex);
+		slurm_cond_wait(&workq->idle_cond, &workq->mutex);
 
 	slurm_mutex_unlock(&workq->mutex);
 	log_flag(WORKQ, "%s: all workers are idle", __func__);
@@ -372,7 +376,13 @@ static void *_worker(void *arg)
 			 worker->workq->active, worker->workq->total,
 			 list_count(workq->work));
 
-		slurm_cond_broadcast(&workq->cond);
+		/*
+		 * Only wake threads waiting for the workq to go idle. Waking
+		 * the other workers here would just have them find the queue
+		 * empty (this worker already pops the next work itself).
+		 */
+		if (!workq->active)
+			slurm_cond_broadcast(&workq->idle_cond);
 		slurm_mutex_unlock(&workq->mutex);
 
 		_work_delete(work);
@@ -381,6 +391,81 @@ static void *_worker(void *arg)
 	return NULL;
 }
 
+typedef struct {
+	work_index_func_t func;
+	void *arg;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int pending; /* count of queued work not yet completed */
+} parallel_args_t;
+
+typedef struct {
+	parallel_args_t *args;
+	int index;
+} parallel_work_t;
+
+static void _parallel_work(void *arg)
+{
+	parallel_work_t *work = arg;
+	parallel_args_t *args = work->args;
+
+	args->func(args->arg, work->index);
+
+	slurm_mutex_lock(&args->mutex);
+	if (--args->pending == 0)
+		slurm_cond_signal(&args->cond);
+	slurm_mutex_unlock(&args->mutex);
+}
+
+extern void workq_run_parallel(workq_t *workq, int count,
+			       work_index_func_t func, void *arg,
+			       const char *tag)
+{
+	parallel_args_t args = {
+		.func = func,
+		.arg = arg,
+	};
+	parallel_work_t *work;
+
+	if (count <= 0)
+		return;
+
+	if (!workq || (count == 1)) {
+		for (int i = 0; i < count; i++)
+			func(arg, i);
+		return;
+	}
+
+	_check_magic_workq(workq);
+
+	work = xcalloc(count, sizeof(*work));
+	slurm_mutex_init(&args.mutex);
+	slurm_cond_init(&args.cond, NULL);
+	args.pending = count - 1;
+
+	for (int i = 1; i < count; i++) {
+		work[i].args = &args;
+		work[i].index = i;
+
+		if (workq_add_work(workq, _parallel_work, &work[i], tag)) {
+			/* Work queue shutting down, do it here */
+			_parallel_work(&work[i]);
+		}
+	}
+
+	func(arg, 0);
+
+	slurm_mutex_lock(&args.mutex);
+	while (args.pending)
+		slurm_cond_wait(&args.cond, &args.mutex);
+	slurm_mutex_unlock(&args.mutex);
+
+	slurm_mutex_destroy(&args.mutex);
+	slurm_cond_destroy(&args.cond);
+	xfree(work);
+}
+
 extern int workq_get_active(workq_t *workq)
 {
 	int active;
@@ -46,6 +46,14 @@
  */
 typedef void (*work_func_t)(void *arg);
 
+/*
+ * Call back for indexed work used by workq_run_parallel()
+ *
+ * IN arg pointer to data for function
+ * IN index index of this piece of work
+ */
+typedef void (*work_index_func_t)(void *arg, int index);
+
 /* Opaque struct */
 typedef struct workq_s workq_t;
 
@@ -81,6 +89,21 @@ extern void free_workq(workq_t *workq);
 extern int workq_add_work(workq_t *workq, work_func_t func, void *arg,
 			  const char *tag);
 
+/*
+ * Run func(arg, index) for every index in [0, count) and wait for all of them
+ * to complete (fork-join). Index 0 and any work the workq refuses (because it
+ * is shutting down) are run by the calling thread, so this always completes
+ * all of the work.
+ * IN workq - work queue to run work on
+ * IN count - number of pieces of work
+ * IN func - function pointer to run work
+ * IN arg - arg to hand to function pointer
+ * IN tag - tag used in logging this function
+ */
+extern void workq_run_parallel(workq_t *workq, int count,
+			       work_index_func_t func, void *arg,
+			       const char *tag);
+
 /*
  * Grab copy of the workq active count
  */
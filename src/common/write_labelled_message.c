@@ -45,13 +45,14 @@
 #include "src/common/write_labelled_message.h"
 #include "slurm/slurm_errno.h"
 #include "src/common/log.h"
+#include "src/common/macros.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
 static char *_build_label(int task_id, int task_id_width,
 			  uint32_t het_job_offset,
 			  uint32_t het_job_task_offset);
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len);
+static int _write_buf(int fd, void *buf, int len);
 
 /*
  * fd             is the file descriptor to write to
@@ -64,9 +65,9 @@ static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len);
  *                label for the task id
  * task_id_width  is the number of digits to use for the task id
  *
- * Write as many lines from the message as possible.  Return
- * the number of bytes from the message that have been written,
- * or -1 on error.  If len==0, -1 will be returned.
+ * Write the lines of the message with a single write.  Return the number
+ * of bytes from the message that have been written, or -1 on error.  If
+ * len==0, -1 will be returned.
  *
  * If the message ends in a partial line (line does not end
  * in a '\n'), then add a newline to the output file, but only
@@ -78,48 +79,54 @@ extern int write_labelled_message(int fd, void *buf, int len, int task_id,
 				  bool label, int task_id_width)
 {
 	void *start, *end;
-	char *prefix = NULL, *suffix = NULL;
+	char *prefix = NULL, *out = NULL;
 	int remaining = len;
-	int written = 0;
-	int line_len;
+	int line_len, out_len = 0, out_size = 0, pre_len;
 	int rc = -1;
 
-	if (label) {
-		prefix = _build_label(task_id, task_id_width, het_job_offset,
-				      het_job_task_offset);
-	}
+	if (len <= 0)
+		return rc;
+
+	if (!label)
+		return _write_buf(fd, buf, len);
+
+	prefix = _build_label(task_id, task_id_width, het_job_offset,
+			      het_job_task_offset);
+	pre_len = strlen(prefix);
 
+	/*
+	 * Label every line into one buffer so the file system sees a single
+	 * write per message rather than one per line.
+	 */
 	while (remaining > 0) {
-		start = buf + written;
+		start = buf + (len - remaining);
 		end = memchr(start, '\n', remaining);
-		if (end == NULL) { /* no newline found */
-			if (label)
-				suffix = "\n";
-			rc = _write_line(fd, prefix, suffix, start, remaining);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
-		} else {
+		if (end == NULL) /* no newline found */
+			line_len = remaining;
+		else
 			line_len = (int)(end - start) + 1;
-			rc = _write_line(fd, prefix, suffix, start, line_len);
-			if (rc <= 0) {
-				goto done;
-			} else {
-				remaining -= rc;
-				written += rc;
-			}
+
+		if ((out_len + pre_len + line_len + 1) > out_size) {
+			out_size = MAX(out_size * 2,
+				       out_len + pre_len + line_len + 1);
+			xrealloc(out, out_size);
 		}
+		memcpy(out + out_len, prefix, pre_len);
+		out_len += pre_len;
+		memcpy(out + out_len, start, line_len);
+		out_len += line_len;
+		if (end == NULL)
+			out[out_len++] = '\n';
 
+		remaining -= line_len;
 	}
-done:
+
+	if (_write_buf(fd, out, out_len) == out_len)
+		rc = len;
+
+	xfree(out);
 	xfree(prefix);
-	if (written > 0)
-		return written;
-	else
-		return rc;
+	return rc;
 }
 
 /*
@@ -149,32 +156,14 @@ static char *_build_label(int task_id, int task_id_width,
 /*
  * Blocks until write is complete, regardless of the file descriptor being in
  * non-blocking mode.
- * I/O from multiple hetjob components may be present, so add prefix/suffix to
- * buffer before issuing write to avoid interleaved output from multiple
- * components.
+ * I/O from multiple hetjob components may be present, so labels are added to
+ * the buffer before issuing the write to avoid interleaved output from
+ * multiple components.
  */
-static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len)
+static int _write_buf(int fd, void *buf, int len)
 {
-	int left, n, pre = 0, post = 0;
-	void *ptr, *tmp = NULL;
-
-	if (prefix || suffix) {
-		if (prefix)
-			pre = strlen(prefix);
-		if (suffix)
-			post = strlen(suffix);
-		tmp = xmalloc(pre + len + post);
-		if (prefix)
-			memcpy(tmp, prefix, pre);
-		memcpy(tmp + pre, buf, len);
-		if (suffix)
-			memcpy(tmp + pre + len, suffix, post);
-		ptr = tmp;
-		left = pre + len + post;
-	} else {
-		ptr = buf;
-		left = len;
-	}
+	int left = len, n;
+	void *ptr = buf;
 
 	while (left > 0) {
 	again:
@@ -182,7 +171,7 @@ static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len)
 			if (errno == EINTR)
 				goto again;
 			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-				debug3("  got EAGAIN in _write_line");
+				debug3("  got EAGAIN in _write_buf");
 				goto again;
 			}
 			len = -1;
@@ -191,7 +180,6 @@ static int _write_line(int fd, char *prefix, char *suffix, void *buf, int len)
 		left -= n;
 		ptr += n;
 	}
-	xfree(tmp);
 
 	return len;
 }
@@ -52,9 +52,9 @@
  *                label for the task id
  * task_id_width  is the number of digits to use for the task id
  *
- * Write as many lines from the message as possible.  Return
- * the number of bytes from the message that have been written,
- * or -1 on error.  If len==0, -1 will be returned.
+ * Write the lines of the message with a single write.  Return the number
+ * of bytes from the message that have been written, or -1 on error.  If
+ * len==0, -1 will be returned.
  *
  * If the message ends in a partial line (line does not end
  * in a '\n'), then add a newline to the output file, but only
@@ -135,11 +135,15 @@ static void _makespace(char **str, int str_len, int needed)
  */
 void _xstrcat(char **str1, const char *str2)
 {
+	size_t len1, len2;
+
 	if (str2 == NULL)
 		str2 = "(null)";
 
-	_makespace(str1, -1, strlen(str2));
-	strcat(*str1, str2);
+	len1 = *str1 ? strlen(*str1) : 0;
+	len2 = strlen(str2);
+	_makespace(str1, len1, len2);
+	memcpy(*str1 + len1, str2, len2 + 1);
 }
 
 /*
@@ -330,30 +334,54 @@ extern void _xrfc3339timecat(char **buf)
 	_xstrfmtcat(buf, "%s%s", p, z);
 }
 
+/*
+ * Format directly into the unused space at the end of str, which xmalloc()
+ * keeps around from the doubling in _makespace(), and only grow str when the
+ * result does not fit. str must not be one of the arguments.
+ * RET length of the appended string
+ */
+static size_t _xstrvfmtcat_tail(char **str, size_t len, const char *fmt,
+				va_list ap)
+{
+	va_list our_ap;
+	size_t avail = xsize(*str) - len;
+	int n;
+
+	xassert(xsize(*str) > len);
+
+	va_copy(our_ap, ap);
+	n = vsnprintf(*str + len, avail, fmt, our_ap);
+	va_end(our_ap);
+
+	if (n < 0) {
+		(*str)[len] = '\0';
+		return 0;
+	}
+
+	if (n >= avail) {
+		_makespace(str, len, n);
+		va_copy(our_ap, ap);
+		(void) vsnprintf(*str + len, n + 1, fmt, our_ap);
+		va_end(our_ap);
+	}
+
+	return n;
+}
+
 /*
  * append formatted string with printf-style args to buf, expanding
  * buf as needed
  */
 void _xstrfmtcat(char **str, const char *fmt, ...)
 {
-	char *p = NULL;
 	va_list ap;
 
 	va_start(ap, fmt);
-	_xstrdup_vprintf(&p, fmt, ap);
+	if (!*str)
+		_xstrdup_vprintf(str, fmt, ap);
+	else
+		_xstrvfmtcat_tail(str, strlen(*str), fmt, ap);
 	va_end(ap);
-
-	if (!p)
-		return;
-
-	/* If str does not exist yet, just give it back p directly */
-	if (!*str) {
-		*str = p;
-		return;
-	}
-
-	xstrcat(*str, p);
-	xfree(p);
 }
 
 /*
@@ -368,35 +396,27 @@ void _xstrfmtcat(char **str, const char *fmt, ...)
 void _xstrfmtcatat(char **str, char **pos, const char *fmt, ...)
 {
 	size_t orig_len, append_len;
-	char *p = NULL;
 	va_list ap;
 
 	va_start(ap, fmt);
-	append_len = _xstrdup_vprintf(&p, fmt, ap);
-	va_end(ap);
-
-	if (!p)
-		return;
 
-	/* No string yet to append to, so just return p. */
+	/* No string yet to append to, so just return the new one. */
 	if (!*str) {
-		*str = p;
-		*pos = p + append_len;
+		append_len = _xstrdup_vprintf(str, fmt, ap);
+		va_end(ap);
+		*pos = *str + append_len;
 		return;
 	}
 
 	if (!*pos) {
 		orig_len = strlen(*str);
-		*pos = *str + orig_len;
 	} else {
 		xassert(*pos >= *str);
 		orig_len = *pos - *str;
 	}
 
-	_makespace(str, orig_len, append_len);
-
-	memcpy(*str + orig_len, p, append_len);
-	xfree(p);
+	append_len = _xstrvfmtcat_tail(str, orig_len, fmt, ap);
+	va_end(ap);
 
 	/*
 	 * Update *pos. Cannot happen earlier as _makespace() may have
@@ -117,13 +117,16 @@ void _xrfc5424timecat(char **str, bool);
 void _xrfc3339timecat(char **str);
 
 /*
- * Concatenate printf-style formatted string onto str
+ * Concatenate printf-style formatted string onto str.
+ * The string is formatted in place into the spare capacity of str, so str
+ * itself must not be passed as one of the format arguments.
  */
 void _xstrfmtcat(char **str, const char *fmt, ...)
 	__attribute__((format(printf, 2, 3)));
 
 /*
  * Concatenate printf-style formatted string onto str at position pos.
+ * Same restriction on the format arguments as _xstrfmtcat().
  */
 void _xstrfmtcatat(char **str, char **pos, const char *fmt, ...)
 	__attribute__((format(printf, 3, 4)));
@@ -143,6 +143,34 @@ static MYSQL_RES *_get_last_result(MYSQL *db_conn)
 	return last_result;
 }
 
+/* NOTE: Ensure that mysql_conn->lock is set on function entry */
+static int _mysql_query_internal(MYSQL *db_conn, char *query);
+
+/*
+ * Send the queries queued by mysql_db_query_deferred() in one round trip.
+ * NOTE: Ensure that mysql_conn->lock is set on function entry
+ */
+static int _flush_deferred(mysql_conn_t *mysql_conn)
+{
+	int rc;
+
+	if (!mysql_conn->deferred_query)
+		return SLURM_SUCCESS;
+
+	if ((rc = _mysql_query_internal(mysql_conn->db_conn,
+					mysql_conn->deferred_query)) !=
+	    SLURM_ERROR)
+		rc = _clear_results(mysql_conn->db_conn);
+	if (rc != SLURM_SUCCESS)
+		error("%s: %d deferred queries failed",
+		      __func__, mysql_conn->deferred_cnt);
+
+	xfree(mysql_conn->deferred_query);
+	mysql_conn->deferred_cnt = 0;
+
+	return rc;
+}
+
 /* NOTE: Ensure that mysql_conn->lock is set on function entry */
 static int _mysql_query_internal(MYSQL *db_conn, char *query)
 {
@@ -718,6 +746,9 @@ void _set_mysql_ssl_opts(MYSQL *db_conn, const char *options)
 			key = val_str;
 		else if (!xstrcasecmp(opt_str, "SSL_CIPHER"))
 			cipher = val_str;
+		else if (!xstrcasecmp(opt_str, "REPLICA_HOST") ||
+			 !xstrcasecmp(opt_str, "REPLICA_MAX_LAG"))
+			; /* handled by the accounting_storage plugin */
 		else {
 			error("Invalid storage option '%s'", opt_str);
 			goto next;
@@ -813,8 +844,10 @@ extern int destroy_mysql_conn(mysql_conn_t *mysql_conn)
 {
 	if (mysql_conn) {
 		mysql_db_close_db_connection(mysql_conn);
+		destroy_mysql_conn(mysql_conn->replica_conn);
 		xfree(mysql_conn->pre_commit_query);
 		xfree(mysql_conn->cluster_name);
+		xfree(mysql_conn->deferred_query);
 		slurm_mutex_destroy(&mysql_conn->lock);
 		FREE_NULL_LIST(mysql_conn->update_list);
 		xfree(mysql_conn->wsrep_trx_fragment_unit_orig);
@@ -905,7 +938,7 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 			const char *err_str = NULL;
 			int err = mysql_errno(mysql_conn->db_conn);
 
-			if (err == ER_BAD_DB_ERROR) {
+			if ((err == ER_BAD_DB_ERROR) && !db_info->replica) {
 				debug("Database %s not created.  Creating",
 				      db_name);
 				rc = _create_db(db_name, db_info);
@@ -958,6 +991,9 @@ extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 		mysql_close(mysql_conn->db_conn);
 		mysql_conn->db_conn = NULL;
 	}
+	/* Never committed, so the server dropped them as well */
+	xfree(mysql_conn->deferred_query);
+	mysql_conn->deferred_cnt = 0;
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return SLURM_SUCCESS;
 }
@@ -984,11 +1020,39 @@ extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	rc = _mysql_query_internal(mysql_conn->db_conn, query);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
 }
 
+extern int mysql_db_query_deferred(mysql_conn_t *mysql_conn, char *query)
+{
+	int rc = SLURM_SUCCESS;
+	int len;
+
+	if (!mysql_conn || !mysql_conn->db_conn) {
+		fatal("You haven't inited this storage yet.");
+		return 0;	/* For CLANG false positive */
+	}
+	slurm_mutex_lock(&mysql_conn->lock);
+	/* Without a transaction nothing would flush on commit */
+	if (!(mysql_conn->flags & DB_CONN_FLAG_ROLLBACK)) {
+		_flush_deferred(mysql_conn);
+		rc = _mysql_query_internal(mysql_conn->db_conn, query);
+		slurm_mutex_unlock(&mysql_conn->lock);
+		return rc;
+	}
+	xstrcat(mysql_conn->deferred_query, query);
+	len = strlen(query);
+	if (!len || (query[len - 1] != ';'))
+		xstrcatchar(mysql_conn->deferred_query, ';');
+	if (++mysql_conn->deferred_cnt >= MYSQL_DEFERRED_MAX)
+		rc = _flush_deferred(mysql_conn);
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return rc;
+}
+
 /*
  * Executes a single delete sql query.
  * Returns the number of deleted rows, <0 for failure.
@@ -1002,6 +1066,7 @@ extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	if (!(rc = _mysql_query_internal(mysql_conn->db_conn, query)))
 		rc = mysql_affected_rows(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
@@ -1029,6 +1094,53 @@ extern int mysql_db_ping(mysql_conn_t *mysql_conn)
 	return rc;
 }
 
+extern int mysql_db_replica_lag(mysql_conn_t *mysql_conn)
+{
+	/* MySQL 8.4 dropped the old form, MariaDB before 10.5 lacks the new */
+	char *queries[] = { "SHOW REPLICA STATUS", "SHOW SLAVE STATUS" };
+	MYSQL_RES *result = NULL;
+	MYSQL_FIELD *fields;
+	MYSQL_ROW row;
+	int lag = -1;
+
+	if (!mysql_conn->db_conn)
+		return -1;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	_clear_results(mysql_conn->db_conn);
+	for (int i = 0; i < ARRAY_SIZE(queries); i++) {
+		if (!mysql_query(mysql_conn->db_conn, queries[i]) &&
+		    (result = mysql_store_result(mysql_conn->db_conn)))
+			break;
+		debug3("%s: %s failed: %s", __func__, queries[i],
+		       mysql_error(mysql_conn->db_conn));
+	}
+	if (!result)
+		goto end_it;
+
+	/* No row means the server is not a replica */
+	if (!(row = mysql_fetch_row(result)))
+		goto end_it;
+
+	fields = mysql_fetch_fields(result);
+	for (int i = 0; i < mysql_num_fields(result); i++) {
+		if (xstrcasecmp(fields[i].name, "Seconds_Behind_Master") &&
+		    xstrcasecmp(fields[i].name, "Seconds_Behind_Source"))
+			continue;
+		/* NULL means the replication threads are not running */
+		if (row[i])
+			lag = slurm_atoul(row[i]);
+		break;
+	}
+
+end_it:
+	if (result)
+		mysql_free_result(result);
+	errno = 0;
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return lag;
+}
+
 extern int mysql_db_commit(mysql_conn_t *mysql_conn)
 {
 	int rc = SLURM_SUCCESS;
@@ -1037,6 +1149,7 @@ extern int mysql_db_commit(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_commit(mysql_conn->db_conn)) {
@@ -1058,6 +1171,8 @@ extern int mysql_db_rollback(mysql_conn_t *mysql_conn)
 		return SLURM_ERROR;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	xfree(mysql_conn->deferred_query);
+	mysql_conn->deferred_cnt = 0;
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(mysql_conn->db_conn);
 	if (mysql_rollback(mysql_conn->db_conn)) {
@@ -1084,6 +1199,7 @@ extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
 		if (mysql_errno(mysql_conn->db_conn) == ER_NO_SUCH_TABLE)
 			goto fini;
@@ -1113,6 +1229,7 @@ extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 	int rc = SLURM_SUCCESS;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	if ((rc = _mysql_query_internal(
 		     mysql_conn->db_conn, query)) != SLURM_ERROR)
 		rc = _clear_results(mysql_conn->db_conn);
@@ -1125,6 +1242,7 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 	uint64_t new_id = 0;
 
 	slurm_mutex_lock(&mysql_conn->lock);
+	_flush_deferred(mysql_conn);
 	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
 		new_id = mysql_insert_id(mysql_conn->db_conn);
 		if (!new_id) {
@@ -52,18 +52,24 @@
 #include <mysql.h>
 #include <mysqld_error.h>
 
+/* Max queries mysql_db_query_deferred() queues before sending them */
+#define MYSQL_DEFERRED_MAX 64
+
 typedef enum {
 	SLURM_MYSQL_PLUGIN_NOTSET,
 	SLURM_MYSQL_PLUGIN_AS, /* accounting_storage */
 	SLURM_MYSQL_PLUGIN_JC, /* jobcomp */
 } slurm_mysql_plugin_type_t;
 
-typedef struct {
+typedef struct mysql_conn {
 	char *cluster_name;
 	MYSQL *db_conn;
 	uint32_t flags;
+	char *deferred_query;
+	int deferred_cnt;
 	pthread_mutex_t lock;
 	char *pre_commit_query;
+	struct mysql_conn *replica_conn; /* read-only queries, may be NULL */
 	List update_list;
 	int conn;
 	uint64_t wsrep_trx_fragment_size_orig;
@@ -77,6 +83,7 @@ typedef struct {
 	char *user;
 	char *params;
 	char *pass;
+	bool replica; /* never create the database on this host */
 } mysql_db_info_t;
 
 typedef struct {
@@ -95,8 +102,21 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn);
 extern int mysql_db_cleanup(void);
 extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query);
+/*
+ * Queue a query that returns no data and whose result the caller does not
+ * need to act on right away. Queued queries are sent together in one
+ * multi-statement round trip before the next query on this connection, on
+ * commit, or once MYSQL_DEFERRED_MAX have been queued. A rollback discards
+ * them. Errors are only logged.
+ */
+extern int mysql_db_query_deferred(mysql_conn_t *mysql_conn, char *query);
 extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query);
 extern int mysql_db_ping(mysql_conn_t *mysql_conn);
+/*
+ * Return how many seconds this connection's server is behind its replication
+ * source, or -1 if it is not replicating or the lag is unknown.
+ */
+extern int mysql_db_replica_lag(mysql_conn_t *mysql_conn);
 extern int mysql_db_commit(mysql_conn_t *mysql_conn);
 extern int mysql_db_rollback(mysql_conn_t *mysql_conn);
 
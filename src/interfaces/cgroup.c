@@ -58,6 +58,8 @@ typedef struct {
 	int	(*step_get_pids)	(pid_t **pids, int *npids);
 	int	(*step_suspend)		(void);
 	int	(*step_resume)		(void);
+	int	(*signal)		(int signal);
+	int	(*step_wait_empty)	(int timeout_ms);
 	int	(*step_destroy)		(cgroup_ctl_type_t sub);
 	bool	(*has_pid)		(pid_t pid);
 	cgroup_limits_t *(*constrain_get) (cgroup_ctl_type_t sub,
@@ -92,6 +94,8 @@ static const char *syms[] = {
 	"cgroup_p_step_get_pids",
 	"cgroup_p_step_suspend",
 	"cgroup_p_step_resume",
+	"cgroup_p_signal",
+	"cgroup_p_step_wait_empty",
 	"cgroup_p_step_destroy",
 	"cgroup_p_has_pid",
 	"cgroup_p_constrain_get",
@@ -839,6 +843,20 @@ extern int cgroup_g_step_resume(void)
 	return (*(ops.step_resume))();
 }
 
+extern int cgroup_g_signal(int signal)
+{
+	xassert(g_context);
+
+	return (*(ops.signal))(signal);
+}
+
+extern int cgroup_g_step_wait_empty(int timeout_ms)
+{
+	xassert(g_context);
+
+	return (*(ops.step_wait_empty))(timeout_ms);
+}
+
 extern int cgroup_g_step_destroy(cgroup_ctl_type_t sub)
 {
 	xassert(g_context);
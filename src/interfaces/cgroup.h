@@ -106,7 +106,8 @@ typedef enum {
 
 /* Current supported cgroup controller features */
 typedef enum {
-	CG_MEMCG_SWAP
+	CG_MEMCG_SWAP,
+	CG_KILL_BUTTON
 } cgroup_ctl_feature_t;
 
 typedef enum {
@@ -297,6 +298,25 @@ extern int cgroup_g_step_suspend(void);
  */
 extern int cgroup_g_step_resume(void);
 
+/*
+ * Send a signal to all the user processes of the step at once.
+ *
+ * IN signal - Signal to send, only SIGKILL is supported (CG_KILL_BUTTON).
+ * RET SLURM_SUCCESS if operation was successful, ESLURM_NOT_SUPPORTED if the
+ *     plugin can not do it, SLURM_ERROR otherwise.
+ */
+extern int cgroup_g_signal(int signal);
+
+/*
+ * Wait until the step has no user processes left.
+ *
+ * IN timeout_ms - Maximum time to wait in milliseconds.
+ * RET SLURM_SUCCESS if the step is empty, SLURM_ERROR if it is still not
+ *     empty after timeout_ms, ESLURM_NOT_SUPPORTED if the plugin can not wait
+ *     for it.
+ */
+extern int cgroup_g_step_wait_empty(int timeout_ms);
+
 /*
  * If the caller (typically from a plugin) is the only one using this step
  * object, rmdir the controller's step directories and destroy the associated
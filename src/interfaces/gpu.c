@@ -35,11 +35,22 @@
 \*****************************************************************************/
 
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "src/common/assoc_mgr.h"
+#include "src/common/fd.h"
+#include "src/common/pack.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_defs.h"
 #include "src/interfaces/gpu.h"
 #include "src/common/plugin.h"
 
+/* Autodetect results cache, in the slurmd spool directory */
+#define CACHE_FILE "gpu_autodetect_cache"
+#define BOOT_ID_FILE "/proc/sys/kernel/random/boot_id"
+
 /* Gres symbols provided by the plugin */
 typedef struct slurm_ops {
 	List	(*get_system_gpu_list) 	(node_config_load_t *node_conf);
@@ -72,6 +83,11 @@ static slurm_ops_t ops;
 static plugin_context_t *g_context = NULL;
 static pthread_mutex_t g_context_lock =	PTHREAD_MUTEX_INITIALIZER;
 
+/* Background autodetect after starting with cached results */
+static buf_t *reprobe_cache = NULL;
+static node_config_load_t reprobe_conf;
+static pthread_t reprobe_tid = 0;
+
 /*
  *  Common function to dlopen() the appropriate gpu libraries, and
  *   report back type needed.
@@ -168,6 +184,9 @@ extern int gpu_plugin_fini(void)
 	if (!g_context)
 		return SLURM_SUCCESS;
 
+	/* The re-probe uses the plugin, wait for it */
+	slurm_thread_join(reprobe_tid);
+
 	slurm_mutex_lock(&g_context_lock);
 	rc = plugin_context_destroy(g_context);
 	g_context = NULL;
@@ -200,10 +219,229 @@ extern void gpu_get_tres_pos(int *gpumem_pos, int *gpuutil_pos)
 		*gpuutil_pos = loc_gpuutil_pos;
 }
 
+static char *_cache_file(node_config_load_t *node_conf)
+{
+	char *file;
+
+	slurm_conf_lock();
+	file = slurm_conf_expand_slurmd_path(slurm_conf.slurmd_spooldir,
+					     node_conf->node_name, NULL);
+	slurm_conf_unlock();
+	xstrfmtcat(file, "/%s", CACHE_FILE);
+
+	return file;
+}
+
+/*
+ * Pack autodetect results along with what they are valid for: the boot of
+ * this node (so that GPUs added or removed with a reboot are always seen),
+ * the gpu plugin used to detect them and the node's CPU count.
+ * RET SLURM_ERROR if the boot could not be identified, nothing to cache
+ */
+static int _cache_pack(node_config_load_t *node_conf, List gres_list,
+		       buf_t *buffer)
+{
+	char boot_id[64] = "";
+	list_itr_t *itr;
+	gres_slurmd_conf_t *gres_conf;
+	FILE *fp;
+
+	if (!(fp = fopen(BOOT_ID_FILE, "r")))
+		return SLURM_ERROR;
+	if (!fgets(boot_id, sizeof(boot_id), fp) || !boot_id[0]) {
+		fclose(fp);
+		return SLURM_ERROR;
+	}
+	fclose(fp);
+
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	packstr(boot_id, buffer);
+	packstr(g_context->type, buffer);
+	pack32(node_conf->cpu_cnt, buffer);
+
+	if (!gres_list) {
+		pack32(NO_VAL, buffer);
+		return SLURM_SUCCESS;
+	}
+
+	pack32(list_count(gres_list), buffer);
+	itr = list_iterator_create(gres_list);
+	while ((gres_conf = list_next(itr))) {
+		pack32(gres_conf->config_flags, buffer);
+		pack64(gres_conf->count, buffer);
+		pack32(gres_conf->cpu_cnt, buffer);
+		packstr(gres_conf->cpus, buffer);
+		pack_bit_str_hex(gres_conf->cpus_bitmap, buffer);
+		packstr(gres_conf->file, buffer);
+		packstr(gres_conf->links, buffer);
+		packstr(gres_conf->name, buffer);
+		packstr(gres_conf->type_name, buffer);
+		packstr(gres_conf->unique_id, buffer);
+		pack32(gres_conf->plugin_id, buffer);
+	}
+	list_iterator_destroy(itr);
+
+	return SLURM_SUCCESS;
+}
+
+static void _cache_save(node_config_load_t *node_conf, buf_t *buffer)
+{
+	char *file = _cache_file(node_conf), *tmp_file = NULL;
+	int fd;
+
+	xstrfmtcat(tmp_file, "%s.new", file);
+	if ((fd = open(tmp_file, O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC,
+		       0600)) < 0) {
+		error("%s: Can't create %s: %m", __func__, tmp_file);
+		goto fini;
+	}
+	safe_write(fd, get_buf_data(buffer), get_buf_offset(buffer));
+	if (fsync_and_close(fd, "gpu autodetect cache"))
+		goto fini;
+	if (rename(tmp_file, file))
+		error("%s: Can't rename %s to %s: %m",
+		      __func__, tmp_file, file);
+	goto fini;
+
+rwfail:
+	error("%s: Can't write %s: %m", __func__, tmp_file);
+	(void) close(fd);
+fini:
+	xfree(file);
+	xfree(tmp_file);
+}
+
+/*
+ * Load cached autodetect results if valid for the current boot, plugin and
+ * CPU count, see _cache_pack().
+ * OUT gres_list - cached results, possibly NULL if nothing was detected
+ * OUT cache - on success, the cache file content
+ * RET SLURM_SUCCESS if the cache is valid
+ */
+static int _cache_load(node_config_load_t *node_conf, List *gres_list,
+		       buf_t **cache)
+{
+	char *file = _cache_file(node_conf);
+	buf_t *buffer = NULL, *current;
+	uint32_t cnt, header_len;
+	gres_slurmd_conf_t *gres_conf = NULL;
+
+	*gres_list = NULL;
+	*cache = NULL;
+
+	current = init_buf(BUF_SIZE);
+	if (_cache_pack(node_conf, NULL, current) ||
+	    !(buffer = create_mmap_buf(file)))
+		goto fail;
+
+	/* Compare everything up to the record count */
+	header_len = get_buf_offset(current) - sizeof(uint32_t);
+	if ((size_buf(buffer) < header_len) ||
+	    memcmp(get_buf_data(buffer), get_buf_data(current), header_len)) {
+		debug("%s: %s is stale, ignoring it", __func__, file);
+		goto fail;
+	}
+
+	set_buf_offset(buffer, header_len);
+	safe_unpack32(&cnt, buffer);
+	if (cnt != NO_VAL) {
+		*gres_list = list_create(destroy_gres_slurmd_conf);
+		for (int i = 0; i < cnt; i++) {
+			gres_conf = xmalloc(sizeof(*gres_conf));
+			safe_unpack32(&gres_conf->config_flags, buffer);
+			safe_unpack64(&gres_conf->count, buffer);
+			safe_unpack32(&gres_conf->cpu_cnt, buffer);
+			safe_unpackstr(&gres_conf->cpus, buffer);
+			unpack_bit_str_hex(&gres_conf->cpus_bitmap, buffer);
+			safe_unpackstr(&gres_conf->file, buffer);
+			safe_unpackstr(&gres_conf->links, buffer);
+			safe_unpackstr(&gres_conf->name, buffer);
+			safe_unpackstr(&gres_conf->type_name, buffer);
+			safe_unpackstr(&gres_conf->unique_id, buffer);
+			safe_unpack32(&gres_conf->plugin_id, buffer);
+			list_append(*gres_list, gres_conf);
+			gres_conf = NULL;
+		}
+	}
+
+	FREE_NULL_BUFFER(current);
+	xfree(file);
+	*cache = buffer;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("%s: Incomplete %s, ignoring it", __func__, file);
+	destroy_gres_slurmd_conf(gres_conf);
+	FREE_NULL_LIST(*gres_list);
+fail:
+	FREE_NULL_BUFFER(buffer);
+	FREE_NULL_BUFFER(current);
+	xfree(file);
+	return SLURM_ERROR;
+}
+
+/*
+ * Autodetect again in the background after starting with cached results.
+ * If the hardware differs, the cache is updated so that the next start (or
+ * reconfigure) uses the real configuration.
+ */
+static void *_reprobe(void *arg)
+{
+	List gres_list = (*(ops.get_system_gpu_list))(&reprobe_conf);
+	buf_t *buffer = init_buf(BUF_SIZE);
+
+	if (!_cache_pack(&reprobe_conf, gres_list, buffer) &&
+	    ((get_buf_offset(buffer) != size_buf(reprobe_cache)) ||
+	     memcmp(get_buf_data(buffer), get_buf_data(reprobe_cache),
+		    get_buf_offset(buffer)))) {
+		error("GPUs autodetected differ from the cached results used at startup, restart slurmd or reconfigure to use them");
+		_cache_save(&reprobe_conf, buffer);
+	} else {
+		log_flag(GRES, "GPU autodetect cache validated");
+	}
+
+	FREE_NULL_LIST(gres_list);
+	FREE_NULL_BUFFER(buffer);
+	FREE_NULL_BUFFER(reprobe_cache);
+	xfree(reprobe_conf.node_name);
+
+	return NULL;
+}
+
 extern List gpu_g_get_system_gpu_list(node_config_load_t *node_conf)
 {
+	List gres_list = NULL;
+	buf_t *buffer;
+
 	xassert(g_context);
-	return (*(ops.get_system_gpu_list))(node_conf);
+
+	/*
+	 * Autodetection may take seconds (e.g. NVML with many GPUs). If
+	 * requested, start from the results of the previous slurmd start on
+	 * the same boot and check them once the node is up.
+	 */
+	if (!node_conf->in_slurmd ||
+	    !xstrcasestr(slurm_conf.slurmd_params, "gpu_autodetect_cache"))
+		return (*(ops.get_system_gpu_list))(node_conf);
+
+	slurm_thread_join(reprobe_tid);
+
+	if (!_cache_load(node_conf, &gres_list, &reprobe_cache)) {
+		log_flag(GRES, "Using cached GPU autodetect results");
+		reprobe_conf = *node_conf;
+		reprobe_conf.gres_name = NULL;
+		reprobe_conf.node_name = xstrdup(node_conf->node_name);
+		slurm_thread_create(&reprobe_tid, _reprobe, NULL);
+		return gres_list;
+	}
+
+	gres_list = (*(ops.get_system_gpu_list))(node_conf);
+	buffer = init_buf(BUF_SIZE);
+	if (!_cache_pack(node_conf, gres_list, buffer))
+		_cache_save(node_conf, buffer);
+	FREE_NULL_BUFFER(buffer);
+
+	return gres_list;
 }
 
 extern void gpu_g_step_hardware_init(bitstr_t *usable_gpus, char *tres_freq)
@@ -2528,6 +2528,7 @@ extern int gres_g_node_config_load(uint32_t cpu_cnt, char *node_name,
 	node_config_load_t node_conf = {
 		.cpu_cnt = cpu_cnt,
 		.in_slurmd = in_slurmd,
+		.node_name = node_name,
 		.xcpuinfo_mac_to_abs = xcpuinfo_mac_to_abs
 	};
 
@@ -181,6 +181,8 @@ typedef struct {
 	char *gres_name;
 	/* True if called in the slurmd */
 	bool in_slurmd;
+	/* Name of this node */
+	char *node_name;
 	/* A pointer to the mac_to_abs function */
 	int (*xcpuinfo_mac_to_abs) (char *mac, char **abs);
 } node_config_load_t;
@@ -53,6 +53,9 @@ typedef struct slurm_ops {
 	char		(*plugin_type);
 	int (*compute)	(char *input, int len, char *custom_str, int cs_len,
 			 slurm_hash_t *hash);
+	int (*compute_multi) (int cnt, char **inputs, int *lens,
+			      char *custom_str, int cs_len,
+			      slurm_hash_t *hashes);
 } slurm_ops_t;
 
 /*
@@ -63,6 +66,7 @@ static const char *syms[] = {
 	"plugin_id",
 	"plugin_type",
 	"hash_p_compute",
+	"hash_p_compute_multi",
 };
 
 /* Local variables */
@@ -159,3 +163,25 @@ extern int hash_g_compute(char *input, int len, char *custom_str, int cs_len,
 
 	return (*(ops[index].compute))(input, len, custom_str, cs_len, hash);
 }
+
+extern int hash_g_compute_multi(int cnt, char **inputs, int *lens,
+				char *custom_str, int cs_len,
+				slurm_hash_t *hashes)
+{
+	int index;
+
+	xassert(g_context);
+
+	if (cnt <= 0)
+		return 0;
+
+	if ((hashes[0].type >= sizeof(hash_id_to_inx)) ||
+	    ((index = hash_id_to_inx[hashes[0].type]) == 0xff)) {
+		error("%s: hash plugin with id:%u not exist or is not loaded",
+		      __func__, hashes[0].type);
+		return -1;
+	}
+
+	return (*(ops[index].compute_multi))(cnt, inputs, lens, custom_str,
+					     cs_len, hashes);
+}
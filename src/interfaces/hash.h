@@ -51,4 +51,18 @@ extern int hash_g_fini(void);
 extern int hash_g_compute(char *input, int len, char *custom_str, int cs_len,
 			  slurm_hash_t *hash);
 
+/*
+ * Hash cnt independent messages at once, all with the same customization
+ * string. Gives the same result as calling hash_g_compute() on each of them
+ * but lets the plugin interleave short messages through SIMD, which makes
+ * hashing many small messages (e.g. batches of credentials) much cheaper.
+ *
+ * The plugin is selected by hashes[0].type, all entries must use the same.
+ *
+ * RET - cnt on success, -1 on error
+ */
+extern int hash_g_compute_multi(int cnt, char **inputs, int *lens,
+				char *custom_str, int cs_len,
+				slurm_hash_t *hashes);
+
 #endif
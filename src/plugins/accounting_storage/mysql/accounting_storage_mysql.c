@@ -121,6 +121,16 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 static mysql_db_info_t *mysql_db_info = NULL;
 static char *mysql_db_name = NULL;
 
+/*
+ * Optional read replica for heavy read-only queries, set with
+ * StorageParameters=REPLICA_HOST=host[:port],REPLICA_MAX_LAG=#
+ */
+#define DEFAULT_REPLICA_MAX_LAG 30
+#define REPLICA_RETRY_DELAY 60
+static mysql_db_info_t *replica_db_info = NULL;
+static int replica_max_lag = DEFAULT_REPLICA_MAX_LAG;
+static time_t replica_retry_time = 0;
+
 #define DELETE_SEC_BACK 86400
 
 char *acct_coord_table = "acct_coord_table";
@@ -2843,6 +2853,98 @@ static int _send_ctld_update(void *x, void *arg)
 	return 0;
 }
 
+/* Set up replica_db_info if StorageParameters names a read replica */
+static void _init_replica_db_info(void)
+{
+	char *tmp_opts, *token, *save_ptr = NULL;
+
+	if (!slurm_conf.accounting_storage_params)
+		return;
+
+	tmp_opts = xstrdup(slurm_conf.accounting_storage_params);
+	token = strtok_r(tmp_opts, ",", &save_ptr);
+	while (token) {
+		char *val_str = NULL, *port_str;
+		char *opt_str = strtok_r(token, "=", &val_str);
+
+		if (!opt_str || !val_str || !val_str[0]) {
+			;
+		} else if (!xstrcasecmp(opt_str, "REPLICA_HOST")) {
+			if (!replica_db_info) {
+				replica_db_info = create_mysql_db_info(
+					SLURM_MYSQL_PLUGIN_AS);
+				replica_db_info->replica = true;
+				xfree(replica_db_info->backup);
+			}
+			if ((port_str = strchr(val_str, ':'))) {
+				*port_str++ = '\0';
+				replica_db_info->port = slurm_atoul(port_str);
+			}
+			xfree(replica_db_info->host);
+			replica_db_info->host = xstrdup(val_str);
+		} else if (!xstrcasecmp(opt_str, "REPLICA_MAX_LAG")) {
+			replica_max_lag = slurm_atoul(val_str);
+		}
+		token = strtok_r(NULL, ",", &save_ptr);
+	}
+	xfree(tmp_opts);
+
+	if (replica_db_info)
+		verbose("%s: routing job and usage queries to read replica %s:%u when it is at most %d seconds behind",
+			plugin_type, replica_db_info->host,
+			replica_db_info->port, replica_max_lag);
+}
+
+/*
+ * Return the connection a read-only query from this client should use: its
+ * read replica connection if one is configured, reachable and within
+ * REPLICA_MAX_LAG of the primary, otherwise the primary connection itself.
+ */
+static mysql_conn_t *_get_read_conn(mysql_conn_t *mysql_conn)
+{
+	mysql_conn_t *replica_conn;
+	int lag;
+
+	if (!replica_db_info || !mysql_conn ||
+	    (mysql_conn->flags & DB_CONN_FLAG_CLUSTER_DEL))
+		return mysql_conn;
+
+	if ((replica_conn = mysql_conn->replica_conn) &&
+	    mysql_db_ping(replica_conn)) {
+		destroy_mysql_conn(replica_conn);
+		replica_conn = mysql_conn->replica_conn = NULL;
+	}
+
+	if (!replica_conn) {
+		/* Don't stall every query on a replica that is down */
+		if (replica_retry_time > time(NULL))
+			return mysql_conn;
+
+		replica_conn = create_mysql_conn(mysql_conn->conn, false,
+						 mysql_conn->cluster_name);
+		if (mysql_db_get_db_connection(replica_conn, mysql_db_name,
+					       replica_db_info) !=
+		    SLURM_SUCCESS) {
+			error("%s: unable to connect to read replica %s, using primary for the next %d seconds",
+			      plugin_type, replica_db_info->host,
+			      REPLICA_RETRY_DELAY);
+			destroy_mysql_conn(replica_conn);
+			replica_retry_time = time(NULL) + REPLICA_RETRY_DELAY;
+			return mysql_conn;
+		}
+		mysql_conn->replica_conn = replica_conn;
+	}
+
+	if (((lag = mysql_db_replica_lag(replica_conn)) < 0) ||
+	    (lag > replica_max_lag)) {
+		debug("%s: read replica lag %d outside bound of %d seconds, using primary",
+		      plugin_type, lag, replica_max_lag);
+		return mysql_conn;
+	}
+
+	return replica_conn;
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
@@ -2867,6 +2969,7 @@ extern int init(void)
 
 	mysql_db_info = create_mysql_db_info(SLURM_MYSQL_PLUGIN_AS);
 	mysql_db_name = acct_get_db_name();
+	_init_replica_db_info();
 
 	debug2("mysql_connect() called for db %s", mysql_db_name);
 	mysql_conn = create_mysql_conn(0, 1, NULL);
@@ -2911,7 +3014,9 @@ extern int fini ( void )
 	slurm_rwlock_unlock(&as_mysql_cluster_list_lock);
 	slurm_rwlock_destroy(&as_mysql_cluster_list_lock);
 	destroy_mysql_db_info(mysql_db_info);
+	destroy_mysql_db_info(replica_db_info);
 	xfree(mysql_db_name);
+	as_mysql_usage_cache_fini();
 	xfree(default_qos_str);
 
 	mysql_db_cleanup();
@@ -3323,7 +3428,12 @@ extern List acct_storage_p_remove_clusters(mysql_conn_t *mysql_conn,
 					   uint32_t uid,
 					   slurmdb_cluster_cond_t *cluster_cond)
 {
-	return as_mysql_remove_clusters(mysql_conn, uid, cluster_cond);
+	List ret_list = as_mysql_remove_clusters(mysql_conn, uid, cluster_cond);
+
+	if (ret_list)
+		as_mysql_usage_cache_invalidate(NULL, 0);
+
+	return ret_list;
 }
 
 extern List acct_storage_p_remove_assocs(
@@ -3492,7 +3602,11 @@ extern int acct_storage_p_get_usage(mysql_conn_t *mysql_conn, uid_t uid,
 				    void *in, slurmdbd_msg_type_t type,
 				    time_t start, time_t end)
 {
-	return as_mysql_get_usage(mysql_conn, uid, in, type, start, end);
+	if (check_connection(mysql_conn) != SLURM_SUCCESS)
+		return ESLURM_DB_CONNECTION;
+
+	return as_mysql_get_usage(_get_read_conn(mysql_conn), uid, in, type,
+				  start, end);
 }
 
 extern int acct_storage_p_roll_usage(mysql_conn_t *mysql_conn,
@@ -3697,6 +3811,13 @@ extern List jobacct_storage_p_get_jobs_cond(mysql_conn_t *mysql_conn,
 	if (check_connection(mysql_conn) != SLURM_SUCCESS) {
 		return NULL;
 	}
+	/*
+	 * Runaway job lookups feed straight into fixing those jobs, so they
+	 * must see the primary's current view.
+	 */
+	if (!job_cond || !(job_cond->flags & JOBCOND_FLAG_RUNAWAY))
+		mysql_conn = _get_read_conn(mysql_conn);
+
 	job_list = as_mysql_jobacct_process_get_jobs(mysql_conn, uid, job_cond);
 
 	return job_list;
@@ -3718,6 +3839,9 @@ extern int jobacct_storage_p_archive(mysql_conn_t *mysql_conn,
 	rc = as_mysql_jobacct_process_archive(mysql_conn, arch_cond);
 	slurm_mutex_unlock(&usage_rollup_lock);
 
+	/* Purged usage must not be served from the cache */
+	as_mysql_usage_cache_invalidate(NULL, 0);
+
 	return rc;
 }
 
@@ -3727,10 +3851,15 @@ extern int jobacct_storage_p_archive(mysql_conn_t *mysql_conn,
 extern int jobacct_storage_p_archive_load(mysql_conn_t *mysql_conn,
 					  slurmdb_archive_rec_t *arch_rec)
 {
+	int rc;
+
 	if (check_connection(mysql_conn) != SLURM_SUCCESS)
 		return ESLURM_DB_CONNECTION;
 
-	return as_mysql_jobacct_process_archive_load(mysql_conn, arch_rec);
+	rc = as_mysql_jobacct_process_archive_load(mysql_conn, arch_rec);
+	as_mysql_usage_cache_invalidate(NULL, 0);
+
+	return rc;
 }
 
 extern int acct_storage_p_update_shares_used(mysql_conn_t *mysql_conn,
@@ -73,6 +73,12 @@
 					       this then archive by month to
 					       handle large datasets. */
 
+#ifndef MAX_PURGE_DELETE
+#define MAX_PURGE_DELETE 5000 /* Records removed per delete statement, each
+				 delete is committed on its own so row locks
+				 are only held briefly. */
+#endif /* MAX_PURGE_DELETE */
+
 #ifndef RECORDS_PER_PASS
 #define RECORDS_PER_PASS 1000	/* Records per single sql statement. */
 #endif /* RECORDS_PER_PASS */
@@ -4996,6 +5002,52 @@ static int _purge_hash_table(mysql_conn_t *mysql_conn, char *cluster_name,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Delete up to limit of the oldest records before period_end.
+ * The where clause and order must match the archive query in _archive_table()
+ * so that only records that have been archived (if archiving is enabled) are
+ * removed.
+ * Returns the number of deleted records or < 0 on failure.
+ */
+static int _purge_records(purge_type_t purge_type, mysql_conn_t *mysql_conn,
+			  char *cluster_name, char *sql_table, char *col_name,
+			  time_t period_end, uint32_t limit)
+{
+	char *query = NULL;
+	int rc;
+
+	switch (purge_type) {
+	case PURGE_TXN:
+		query = xstrdup_printf(
+			"delete from \"%s\" where "
+			"%s <= %ld && cluster='%s' order by %s asc LIMIT %u",
+			sql_table, col_name, period_end, cluster_name,
+			col_name, limit);
+		break;
+	case PURGE_USAGE:
+	case PURGE_CLUSTER_USAGE:
+		query = xstrdup_printf(
+			"delete from \"%s_%s\" where "
+			"%s <= %ld order by %s asc LIMIT %u",
+			cluster_name, sql_table, col_name,
+			period_end, col_name, limit);
+		break;
+	default:
+		query = xstrdup_printf(
+			"delete from \"%s_%s\" where "
+			"%s <= %ld && time_end != 0 order by %s asc LIMIT %u",
+			cluster_name, sql_table, col_name,
+			period_end, col_name, limit);
+		break;
+	}
+	DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
+
+	rc = mysql_db_delete_affected_rows(mysql_conn, query);
+	xfree(query);
+
+	return rc;
+}
+
 /* Archive and purge a table.
  *
  * Returns SLURM_ERROR on error and SLURM_SUCCESS on success.
@@ -5009,9 +5061,9 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 	uint16_t type, period;
 	time_t   last_submit = time(NULL);
 	time_t   curr_end    = 0, tmp_end = 0, record_start = 0;
-	char    *query = NULL, *sql_table = NULL,
-		*col_name = NULL;
-	uint32_t tmp_archive_period;
+	char    *sql_table = NULL, *col_name = NULL;
+	uint32_t tmp_archive_period, purge_cnt, purged;
+	uint64_t purged_total = 0;
 
 	switch (purge_type) {
 	case PURGE_EVENT:
@@ -5147,6 +5199,8 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 		log_flag(DB_ARCHIVE, "Purging %s_%s before %ld",
 			 cluster_name, sql_table, tmp_end);
 
+		purge_cnt = MAX_PURGE_LIMIT;
+
 		/* Do archive */
 		if (SLURMDB_PURGE_ARCHIVE_SET(purge_attr)) {
 			time_t start = 0;
@@ -5161,6 +5215,7 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				return SLURM_ERROR;
 			} else if (rc == SLURM_ERROR)
 				return rc;
+			purge_cnt = rc;
 
 			if (purge_type == PURGE_JOB) {
 				/* Archive associated data from hash tables */
@@ -5185,64 +5240,38 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 		}
 
 		/*
-		 * The purge query should have the same where clause as the
-		 * archive query. The order by is very important so we get
-		 * records in the same order as we do when archiving, since we
-		 * only want to delete records that have been archived (if
-		 * archiving is enabled).
-		 */
-		switch (purge_type) {
-		case PURGE_TXN:
-			query = xstrdup_printf(
-				"delete from \"%s\" where "
-				"%s <= %ld && cluster='%s' order by %s asc LIMIT %d",
-				sql_table, col_name, tmp_end, cluster_name,
-				col_name, MAX_PURGE_LIMIT);
-			break;
-		case PURGE_USAGE:
-		case PURGE_CLUSTER_USAGE:
-			query = xstrdup_printf(
-				"delete from \"%s_%s\" where "
-				"%s <= %ld order by %s asc LIMIT %d",
-				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
-			break;
-		default:
-			query = xstrdup_printf(
-				"delete from \"%s_%s\" where "
-				"%s <= %ld && time_end != 0 order by %s asc LIMIT %d",
-				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
-			break;
-		}
-		DB_DEBUG(DB_ARCHIVE, mysql_conn->conn, "query\n%s", query);
-
-		/*
-		 * Don't loop this query, just do it once, since we are only
-		 * archiving and purging MAX_PURGE_LIMIT rows at a time.
-		 * mysql_db_delete_affected_rows will return < 0 on failure or
-		 * 0 if no records are affected.
+		 * Remove what was just archived (or MAX_PURGE_LIMIT records
+		 * if not archiving) in small deletes, committing after each
+		 * one since a single large delete holds its locks long enough
+		 * to stall job inserts.
 		 */
-		if ((rc = mysql_db_delete_affected_rows(
-				mysql_conn, query)) > 0) {
-			/* Commit here every time since this could create a huge
-			 * transaction.
-			 */
-			if ((rc = mysql_db_commit(mysql_conn)))
+		purged = 0;
+		while (purged < purge_cnt) {
+			uint32_t limit = MIN(purge_cnt - purged,
+					     MAX_PURGE_DELETE);
+
+			if ((rc = _purge_records(purge_type, mysql_conn,
+						 cluster_name, sql_table,
+						 col_name, tmp_end,
+						 limit)) < 0) {
+				error("Couldn't remove old data from %s table",
+				      sql_table);
+				return SLURM_ERROR;
+			}
+			if (mysql_db_commit(mysql_conn)) {
 				error("Couldn't commit cluster (%s) purge",
 				      cluster_name);
+				return SLURM_ERROR;
+			}
+			purged += rc;
+			if (rc < limit)
+				break;
 		}
+		purged_total += purged;
 
-		xfree(query);
-		if (rc != SLURM_SUCCESS) {
-			error("Couldn't remove old data from %s table",
-			      sql_table);
-			return SLURM_ERROR;
-		} else if (mysql_db_commit(mysql_conn)) {
-			error("Couldn't commit cluster (%s) purge",
-			      cluster_name);
-			break;
-		}
+		log_flag(DB_ARCHIVE, "Purged %u records from %s_%s before %ld, %"PRIu64" so far",
+			 purged, cluster_name, sql_table, tmp_end,
+			 purged_total);
 	}
 
 	return SLURM_SUCCESS;
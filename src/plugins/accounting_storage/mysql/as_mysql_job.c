@@ -338,6 +338,7 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 	char *query = NULL;
 	int reinit = 0;
 	time_t begin_time, check_time, start_time, submit_time;
+	bool check_rollup;
 	uint32_t wckeyid = 0;
 	uint32_t job_state;
 	uint32_t array_task_id =
@@ -399,8 +400,16 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 	else
 		check_time = submit_time;
 
+	/*
+	 * Only hold rollup_lock to read and update global_last_rollup, not
+	 * across the queries below, since it is shared by every connection
+	 * and would otherwise serialize job starts of all clusters.
+	 */
 	slurm_mutex_lock(&rollup_lock);
-	if (check_time < global_last_rollup) {
+	check_rollup = (check_time < global_last_rollup);
+	slurm_mutex_unlock(&rollup_lock);
+
+	if (check_rollup) {
 		MYSQL_ROW row;
 
 		/* check to see if we are hearing about this time for the
@@ -417,7 +426,6 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 		if (!(result =
 		      mysql_db_query_ret(mysql_conn, query, 0))) {
 			xfree(query);
-			slurm_mutex_unlock(&rollup_lock);
 			return SLURM_ERROR;
 		}
 		xfree(query);
@@ -426,7 +434,6 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 			debug4("revieved an update for a "
 			       "job (%u) already known about",
 			       job_ptr->job_id);
-			slurm_mutex_unlock(&rollup_lock);
 			goto no_rollup_change;
 		}
 		mysql_free_result(result);
@@ -450,7 +457,9 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 			      slurm_ctime2(&check_time),
 			      job_ptr->job_id, mysql_conn->cluster_name);
 
-		global_last_rollup = check_time;
+		slurm_mutex_lock(&rollup_lock);
+		if (check_time < global_last_rollup)
+			global_last_rollup = check_time;
 		slurm_mutex_unlock(&rollup_lock);
 
 		/* If the times here are later than the daily_rollup
@@ -458,17 +467,21 @@ extern int as_mysql_job_start(mysql_conn_t *mysql_conn, job_record_t *job_ptr)
 		   are always shrunk down to the beginning of each
 		   time period.
 		*/
+		/*
+		 * Use least() as another connection may have moved the
+		 * rollup back further since rollup_lock was released.
+		 */
 		query = xstrdup_printf("update \"%s_%s\" set "
-				       "hourly_rollup=%ld, "
-				       "daily_rollup=%ld, monthly_rollup=%ld",
+				       "hourly_rollup=least(hourly_rollup, %ld), "
+				       "daily_rollup=least(daily_rollup, %ld), "
+				       "monthly_rollup=least(monthly_rollup, %ld)",
 				       mysql_conn->cluster_name,
 				       last_ran_table, check_time,
 				       check_time, check_time);
 		DB_DEBUG(DB_JOB, mysql_conn->conn, "query\n%s", query);
 		rc = mysql_db_query(mysql_conn, query);
 		xfree(query);
-	} else
-		slurm_mutex_unlock(&rollup_lock);
+	}
 
 no_rollup_change:
 
@@ -794,7 +807,7 @@ no_rollup_change:
 			   begin_time, job_ptr->db_index);
 
 		DB_DEBUG(DB_JOB, mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = mysql_db_query_deferred(mysql_conn, query);
 	}
 
 	xfree(query);
@@ -1244,7 +1257,7 @@ extern int as_mysql_job_complete(mysql_conn_t *mysql_conn,
 	xstrfmtcat(query, "where job_db_inx=%"PRIu64";", job_ptr->db_index);
 
 	DB_DEBUG(DB_JOB, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_query_deferred(mysql_conn, query);
 	xfree(query);
 
 	return rc;
@@ -1408,7 +1421,7 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 		xstrfmtcat(query, ", container='%s'", step_ptr->container);
 
 	DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_query_deferred(mysql_conn, query);
 	xfree(query);
 
 	return rc;
@@ -1660,7 +1673,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 		   step_ptr->job_ptr->db_index, step_ptr->step_id.step_id,
 		   step_ptr->step_id.step_het_comp);
 	DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_query_deferred(mysql_conn, query);
 	xfree(query);
 
 	/* set the energy for the entire job. */
@@ -1672,7 +1685,7 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			step_ptr->job_ptr->tres_alloc_str,
 			step_ptr->job_ptr->db_index);
 		DB_DEBUG(DB_STEP, mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+		rc = mysql_db_query_deferred(mysql_conn, query);
 		xfree(query);
 	}
 
@@ -1781,8 +1794,8 @@ extern int as_mysql_flush_jobs_on_cluster(
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	char *query = NULL;
-	char *id_char = NULL;
-	char *suspended_char = NULL;
+	char *id_char = NULL, *id_pos = NULL;
+	char *suspended_char = NULL, *suspended_pos = NULL;
 	size_t count;
 
 again:
@@ -1808,23 +1821,24 @@ again:
 		int state = slurm_atoul(row[1]);
 		if (state == JOB_SUSPENDED) {
 			if (suspended_char)
-				xstrfmtcat(suspended_char,
-					   ", %s", row[0]);
+				xstrfmtcatat(suspended_char, &suspended_pos,
+					     ", %s", row[0]);
 			else
-				xstrfmtcat(suspended_char, "job_db_inx in (%s",
-					   row[0]);
+				xstrfmtcatat(suspended_char, &suspended_pos,
+					     "job_db_inx in (%s", row[0]);
 		}
 
 		if (id_char)
-			xstrfmtcat(id_char, ", %s", row[0]);
+			xstrfmtcatat(id_char, &id_pos, ", %s", row[0]);
 		else
-			xstrfmtcat(id_char, "job_db_inx in (%s", row[0]);
+			xstrfmtcatat(id_char, &id_pos, "job_db_inx in (%s",
+				     row[0]);
 	}
 	count = mysql_num_rows(result);
 	mysql_free_result(result);
 
 	if (suspended_char) {
-		xstrfmtcat(suspended_char, ")");
+		xstrcatat(suspended_char, &suspended_pos, ")");
 		xstrfmtcat(query,
 			   "update \"%s_%s\" set "
 			   "time_suspended=%ld-time_suspended "
@@ -1843,9 +1857,10 @@ again:
 			   mysql_conn->cluster_name, suspend_table,
 			   event_time, suspended_char);
 		xfree(suspended_char);
+		suspended_pos = NULL;
 	}
 	if (id_char) {
-		xstrfmtcat(id_char, ")");
+		xstrcatat(id_char, &id_pos, ")");
 		xstrfmtcat(query,
 			   "update \"%s_%s\" set state=%d, "
 			   "time_end=%ld where %s;",
@@ -1857,6 +1872,7 @@ again:
 			   mysql_conn->cluster_name, step_table,
 			   JOB_CANCELLED, event_time, id_char);
 		xfree(id_char);
+		id_pos = NULL;
 	}
 
 	if (query) {
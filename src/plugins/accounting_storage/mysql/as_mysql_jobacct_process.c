@@ -281,6 +281,9 @@ static void _setup_job_cond_selected_steps(slurmdb_job_cond_t *job_cond,
 		char *job_ids = NULL, *sep = "";
 		char *array_job_ids = NULL, *array_task_ids = NULL;
 		char *het_job_ids = NULL, *het_job_offset = NULL;
+		char *job_ids_pos = NULL, *array_job_ids_pos = NULL;
+		char *array_task_ids_pos = NULL;
+		char *het_job_ids_pos = NULL, *het_job_offset_pos = NULL;
 
 		if (*extra)
 			xstrcat(*extra, " && (");
@@ -290,29 +293,26 @@ static void _setup_job_cond_selected_steps(slurmdb_job_cond_t *job_cond,
 		itr = list_iterator_create(job_cond->step_list);
 		while ((selected_step = list_next(itr))) {
 			if (selected_step->array_task_id != NO_VAL) {
-				if (array_task_ids)
-					xstrcat(array_task_ids, " ,");
-				xstrfmtcat(array_task_ids, "(%u, %u)",
-					   selected_step->step_id.job_id,
-					   selected_step->array_task_id);
+				xstrfmtcatat(array_task_ids,
+					     &array_task_ids_pos, "%s(%u, %u)",
+					     array_task_ids ? " ," : "",
+					     selected_step->step_id.job_id,
+					     selected_step->array_task_id);
 			} else if (selected_step->het_job_offset != NO_VAL) {
-				if (het_job_ids)
-					xstrcat(het_job_ids, " ,");
-				if (het_job_offset)
-					xstrcat(het_job_offset, " ,");
-				xstrfmtcat(het_job_ids, "%u",
-					   selected_step->step_id.job_id);
-				xstrfmtcat(het_job_offset, "%u",
-					   selected_step->het_job_offset);
+				xstrfmtcatat(het_job_ids, &het_job_ids_pos,
+					     "%s%u", het_job_ids ? " ," : "",
+					     selected_step->step_id.job_id);
+				xstrfmtcatat(het_job_offset,
+					     &het_job_offset_pos, "%s%u",
+					     het_job_offset ? " ," : "",
+					     selected_step->het_job_offset);
 			} else {
-				if (job_ids)
-					xstrcat(job_ids, " ,");
-				if (array_job_ids)
-					xstrcat(array_job_ids, " ,");
-				xstrfmtcat(job_ids, "%u",
-					   selected_step->step_id.job_id);
-				xstrfmtcat(array_job_ids, "%u",
-					   selected_step->step_id.job_id);
+				xstrfmtcatat(job_ids, &job_ids_pos, "%s%u",
+					     job_ids ? " ," : "",
+					     selected_step->step_id.job_id);
+				xstrfmtcatat(array_job_ids, &array_job_ids_pos,
+					     "%s%u", array_job_ids ? " ," : "",
+					     selected_step->step_id.job_id);
 			}
 		}
 		list_iterator_destroy(itr);
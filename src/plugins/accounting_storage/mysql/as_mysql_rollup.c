@@ -42,6 +42,7 @@
 #include "as_mysql_archive.h"
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 
 enum {
 	TIME_ALLOC,
@@ -139,14 +140,13 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
+/* Key local_id_usage_t items on their id in an xhash_t */
+static void _id_usage_key(void *item, const char **key, uint32_t *key_len)
 {
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
+	local_id_usage_t *loc = item;
 
-	if (loc->id == id)
-		return 1;
-	return 0;
+	*key = (const char *) &loc->id;
+	*key_len = sizeof(loc->id);
 }
 
 static void _remove_job_tres_time_from_cluster(List c_tres, List j_tres,
@@ -535,7 +535,7 @@ static void _setup_cluster_tres_usage(mysql_conn_t *mysql_conn,
 				      time_t curr_start, time_t curr_end,
 				      time_t now, time_t use_start,
 				      local_tres_usage_t *loc_tres,
-				      char **query)
+				      char **query, char **pos)
 {
 	char start_char[256], end_char[256];
 	uint64_t total_used;
@@ -650,36 +650,37 @@ static void _setup_cluster_tres_usage(mysql_conn_t *mysql_conn,
 	/*      slurm_ctime2(&loc_tres->start)); */
 	/* info("to %s", slurm_ctime2(&loc_tres->end)); */
 	if (*query)
-		xstrfmtcat(*query, ", (%ld, %ld, %ld, %u, %"PRIu64", "
-			   "%"PRIu64", %"PRIu64", %"PRIu64", "
-			   "%"PRIu64", %"PRIu64", %"PRIu64")",
-			   now, now, use_start, loc_tres->id,
-			   loc_tres->count,
-			   loc_tres->time_alloc,
-			   loc_tres->time_down,
-			   loc_tres->time_pd,
-			   loc_tres->time_idle,
-			   loc_tres->time_over,
-			   loc_tres->time_resv);
+		xstrfmtcatat(*query, pos,
+			     ", (%ld, %ld, %ld, %u, %"PRIu64", "
+			     "%"PRIu64", %"PRIu64", %"PRIu64", "
+			     "%"PRIu64", %"PRIu64", %"PRIu64")",
+			     now, now, use_start, loc_tres->id,
+			     loc_tres->count,
+			     loc_tres->time_alloc,
+			     loc_tres->time_down,
+			     loc_tres->time_pd,
+			     loc_tres->time_idle,
+			     loc_tres->time_over,
+			     loc_tres->time_resv);
 	else
-		xstrfmtcat(*query, "insert into \"%s_%s\" "
-			   "(creation_time, mod_time, "
-			   "time_start, id_tres, count, "
-			   "alloc_secs, down_secs, pdown_secs, "
-			   "idle_secs, over_secs, plan_secs) "
-			   "values (%ld, %ld, %ld, %u, %"PRIu64", "
-			   "%"PRIu64", %"PRIu64", %"PRIu64", "
-			   "%"PRIu64", %"PRIu64", %"PRIu64")",
-			   cluster_name, cluster_hour_table,
-			   now, now,
-			   use_start, loc_tres->id,
-			   loc_tres->count,
-			   loc_tres->time_alloc,
-			   loc_tres->time_down,
-			   loc_tres->time_pd,
-			   loc_tres->time_idle,
-			   loc_tres->time_over,
-			   loc_tres->time_resv);
+		xstrfmtcatat(*query, pos, "insert into \"%s_%s\" "
+			     "(creation_time, mod_time, "
+			     "time_start, id_tres, count, "
+			     "alloc_secs, down_secs, pdown_secs, "
+			     "idle_secs, over_secs, plan_secs) "
+			     "values (%ld, %ld, %ld, %u, %"PRIu64", "
+			     "%"PRIu64", %"PRIu64", %"PRIu64", "
+			     "%"PRIu64", %"PRIu64", %"PRIu64")",
+			     cluster_name, cluster_hour_table,
+			     now, now,
+			     use_start, loc_tres->id,
+			     loc_tres->count,
+			     loc_tres->time_alloc,
+			     loc_tres->time_down,
+			     loc_tres->time_pd,
+			     loc_tres->time_idle,
+			     loc_tres->time_over,
+			     loc_tres->time_resv);
 
 	return;
 }
@@ -690,7 +691,7 @@ static int _process_cluster_usage(mysql_conn_t *mysql_conn,
 				  time_t now, local_cluster_usage_t *c_usage)
 {
 	int rc = SLURM_SUCCESS;
-	char *query = NULL;
+	char *query = NULL, *pos = NULL;
 	list_itr_t *itr;
 	local_tres_usage_t *loc_tres;
 
@@ -703,23 +704,24 @@ static int _process_cluster_usage(mysql_conn_t *mysql_conn,
 	while ((loc_tres = list_next(itr))) {
 		_setup_cluster_tres_usage(mysql_conn, cluster_name,
 					  curr_start, curr_end, now,
-					  c_usage->start, loc_tres, &query);
+					  c_usage->start, loc_tres,
+					  &query, &pos);
 	}
 	list_iterator_destroy(itr);
 
 	if (!query)
 		return rc;
 
-	xstrfmtcat(query,
-		   " on duplicate key update "
-		   "mod_time=%ld, count=VALUES(count), "
-		   "alloc_secs=VALUES(alloc_secs), "
-		   "down_secs=VALUES(down_secs), "
-		   "pdown_secs=VALUES(pdown_secs), "
-		   "idle_secs=VALUES(idle_secs), "
-		   "over_secs=VALUES(over_secs), "
-		   "plan_secs=VALUES(plan_secs)",
-		   now);
+	xstrfmtcatat(query, &pos,
+		     " on duplicate key update "
+		     "mod_time=%ld, count=VALUES(count), "
+		     "alloc_secs=VALUES(alloc_secs), "
+		     "down_secs=VALUES(down_secs), "
+		     "pdown_secs=VALUES(pdown_secs), "
+		     "idle_secs=VALUES(idle_secs), "
+		     "over_secs=VALUES(over_secs), "
+		     "plan_secs=VALUES(plan_secs)",
+		     now);
 
 	/* Spacing out the inserts here instead of doing them
 	   all at once in the end proves to be faster.  Just FYI
@@ -737,7 +739,7 @@ static int _process_cluster_usage(mysql_conn_t *mysql_conn,
 static void _create_id_usage_insert(char *cluster_name, int type,
 				    time_t curr_start, time_t now,
 				    local_id_usage_t *id_usage,
-				    char **query)
+				    char **query, char **pos)
 {
 	local_tres_usage_t *loc_tres;
 	list_itr_t *itr;
@@ -745,6 +747,7 @@ static void _create_id_usage_insert(char *cluster_name, int type,
 	char *table = NULL, *id_name = NULL;
 
 	xassert(query);
+	xassert(pos);
 
 	switch (type) {
 	case ASSOC_TABLES:
@@ -770,27 +773,27 @@ static void _create_id_usage_insert(char *cluster_name, int type,
 	itr = list_iterator_create(id_usage->loc_tres);
 	while ((loc_tres = list_next(itr))) {
 		if (!first) {
-			xstrfmtcat(*query,
-				   ", (%ld, %ld, %u, %ld, %u, %"PRIu64")",
-				   now, now,
-				   id_usage->id, curr_start, loc_tres->id,
-				   loc_tres->time_alloc);
+			xstrfmtcatat(*query, pos,
+				     ", (%ld, %ld, %u, %ld, %u, %"PRIu64")",
+				     now, now,
+				     id_usage->id, curr_start, loc_tres->id,
+				     loc_tres->time_alloc);
 		} else {
-			xstrfmtcat(*query,
-				   "insert into \"%s_%s\" "
-				   "(creation_time, mod_time, id, "
-				   "time_start, id_tres, alloc_secs) "
-				   "values (%ld, %ld, %u, %ld, %u, %"PRIu64")",
-				   cluster_name, table, now, now,
-				   id_usage->id, curr_start, loc_tres->id,
-				   loc_tres->time_alloc);
+			xstrfmtcatat(*query, pos,
+				     "insert into \"%s_%s\" "
+				     "(creation_time, mod_time, id, "
+				     "time_start, id_tres, alloc_secs) "
+				     "values (%ld, %ld, %u, %ld, %u, %"PRIu64")",
+				     cluster_name, table, now, now,
+				     id_usage->id, curr_start, loc_tres->id,
+				     loc_tres->time_alloc);
 			first = 0;
 		}
 	}
 	list_iterator_destroy(itr);
-	xstrfmtcat(*query,
-		   " on duplicate key update mod_time=%ld, "
-		   "alloc_secs=VALUES(alloc_secs);", now);
+	xstrfmtcatat(*query, pos,
+		     " on duplicate key update mod_time=%ld, "
+		     "alloc_secs=VALUES(alloc_secs);", now);
 }
 
 static int _add_resv_usage_to_cluster(void *object, void *arg)
@@ -1259,7 +1262,7 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	time_t now = time(NULL);
 	time_t curr_start = start;
 	time_t curr_end = curr_start + add_sec;
-	char *query = NULL;
+	char *query = NULL, *pos = NULL;
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	list_itr_t *a_itr = NULL;
@@ -1270,6 +1273,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	List cluster_down_list = list_create(_destroy_local_cluster_usage);
 	List wckey_usage_list = list_create(_destroy_local_id_usage);
 	List resv_usage_list = list_create(_destroy_local_resv_usage);
+	/* Index into assoc/wckey_usage_list, the lists own the items */
+	xhash_t *assoc_usage_hash = xhash_init(_id_usage_key, NULL);
+	xhash_t *wckey_usage_hash = xhash_init(_id_usage_key, NULL);
 	uint16_t track_wckey = slurm_get_track_wckey();
 	local_cluster_usage_t *loc_c_usage = NULL;
 	local_cluster_usage_t *c_usage = NULL;
@@ -1488,6 +1494,7 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				a_usage = xmalloc(sizeof(local_id_usage_t));
 				a_usage->id = assoc_id;
 				list_append(assoc_usage_list, a_usage);
+				xhash_add(assoc_usage_hash, a_usage);
 				last_id = assoc_id;
 				/* a_usage->loc_tres is made later,
 				   don't do it here.
@@ -1500,10 +1507,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
+				w_usage = xhash_get(wckey_usage_hash,
+						    (char *) &wckey_id,
+						    sizeof(wckey_id));
 
 				if (!w_usage) {
 					w_usage = xmalloc(
@@ -1511,6 +1517,7 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 					w_usage->id = wckey_id;
 					list_append(wckey_usage_list,
 						    w_usage);
+					xhash_add(wckey_usage_hash, w_usage);
 					w_usage->loc_tres = list_create(
 						_destroy_local_tres_usage);
 				}
@@ -1721,17 +1728,19 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				tmp_itr = list_iterator_create(
 					r_usage->local_assocs);
 				while ((assoc = list_next(tmp_itr))) {
-					uint32_t associd = slurm_atoul(assoc);
+					int associd = slurm_atoul(assoc);
 					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
+					    !(a_usage = xhash_get(
+						      assoc_usage_hash,
+						      (char *) &associd,
+						      sizeof(associd)))) {
 						a_usage = xmalloc(
 							sizeof(local_id_usage_t));
 						a_usage->id = associd;
 						list_append(assoc_usage_list,
 							    a_usage);
+						xhash_add(assoc_usage_hash,
+							  a_usage);
 						a_usage->loc_tres = list_create(
 							_destroy_local_tres_usage);
 					}
@@ -1781,11 +1790,12 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			}
 		}
 
+		pos = NULL;
 		list_iterator_reset(a_itr);
 		while ((a_usage = list_next(a_itr)))
 			_create_id_usage_insert(cluster_name, ASSOC_TABLES,
 						curr_start, now,
-						a_usage, &query);
+						a_usage, &query, &pos);
 		if (query) {
 			DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s",
 			         query);
@@ -1800,11 +1810,12 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		if (!track_wckey)
 			goto end_loop;
 
+		pos = NULL;
 		list_iterator_reset(w_itr);
 		while ((w_usage = list_next(w_itr)))
 			_create_id_usage_insert(cluster_name, WCKEY_TABLES,
 						curr_start, now,
-						w_usage, &query);
+						w_usage, &query, &pos);
 		if (query) {
 			DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s",
 			         query);
@@ -1824,6 +1835,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		a_usage     = NULL;
 		w_usage     = NULL;
 
+		xhash_clear(assoc_usage_hash);
+		xhash_clear(wckey_usage_hash);
 		list_flush(assoc_usage_list);
 		list_flush(cluster_down_list);
 		list_flush(wckey_usage_list);
@@ -1846,6 +1859,8 @@ end_it:
 	if (r_itr)
 		list_iterator_destroy(r_itr);
 
+	xhash_free_ptr(&assoc_usage_hash);
+	xhash_free_ptr(&wckey_usage_hash);
 	FREE_NULL_LIST(assoc_usage_list);
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(wckey_usage_list);
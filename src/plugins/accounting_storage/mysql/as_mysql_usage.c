@@ -59,6 +59,162 @@ typedef struct {
 	time_t sent_start;
 } local_rollup_t;
 
+/*
+ * Results of recent usage queries, keyed on the query text. Entries for a
+ * cluster are dropped once a rollup rewrites any period they cover.
+ */
+#define USAGE_CACHE_MAX 128
+
+typedef struct {
+	char *cluster_name;
+	time_t end;		/* end of the queried period */
+	bool is_cluster;	/* recs are slurmdb_cluster_accounting_rec_t */
+	char *query;
+	List recs;
+} usage_cache_t;
+
+typedef struct {
+	char *cluster_name;
+	time_t start;
+} usage_cache_inval_t;
+
+static List usage_cache = NULL;	/* least recently used first */
+static pthread_mutex_t usage_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void _destroy_usage_cache(void *object)
+{
+	usage_cache_t *entry = object;
+
+	if (entry) {
+		xfree(entry->cluster_name);
+		xfree(entry->query);
+		FREE_NULL_LIST(entry->recs);
+		xfree(entry);
+	}
+}
+
+static int _find_usage_cache(void *x, void *key)
+{
+	usage_cache_t *entry = x;
+
+	return !xstrcmp(entry->query, key);
+}
+
+static int _find_usage_cache_stale(void *x, void *key)
+{
+	usage_cache_t *entry = x;
+	usage_cache_inval_t *inval = key;
+
+	if (inval->cluster_name &&
+	    xstrcmp(entry->cluster_name, inval->cluster_name))
+		return 0;
+
+	return (entry->end > inval->start);
+}
+
+/* Append copies of the records in src to dst */
+static void _copy_usage_recs(List dst, List src, bool is_cluster)
+{
+	list_itr_t *itr = list_iterator_create(src);
+	void *rec;
+
+	while ((rec = list_next(itr))) {
+		slurmdb_tres_rec_t *tres_rec;
+		void *copy;
+
+		if (is_cluster) {
+			slurmdb_cluster_accounting_rec_t *c_rec =
+				xmalloc(sizeof(*c_rec));
+			*c_rec = *(slurmdb_cluster_accounting_rec_t *) rec;
+			tres_rec = &c_rec->tres_rec;
+			copy = c_rec;
+		} else {
+			slurmdb_accounting_rec_t *a_rec =
+				xmalloc(sizeof(*a_rec));
+			*a_rec = *(slurmdb_accounting_rec_t *) rec;
+			tres_rec = &a_rec->tres_rec;
+			copy = a_rec;
+		}
+		tres_rec->name = xstrdup(tres_rec->name);
+		tres_rec->type = xstrdup(tres_rec->type);
+		list_append(dst, copy);
+	}
+	list_iterator_destroy(itr);
+}
+
+/* On a hit append copies of the cached records to recs and return true */
+static bool _usage_cache_get(char *query, List recs)
+{
+	usage_cache_t *entry = NULL;
+
+	slurm_mutex_lock(&usage_cache_lock);
+	if (usage_cache &&
+	    (entry = list_remove_first(usage_cache, _find_usage_cache,
+				       query))) {
+		_copy_usage_recs(recs, entry->recs, entry->is_cluster);
+		list_append(usage_cache, entry);
+	}
+	slurm_mutex_unlock(&usage_cache_lock);
+
+	return entry ? true : false;
+}
+
+static void _usage_cache_add(mysql_conn_t *mysql_conn, char *query,
+			     char *cluster_name, time_t end, bool is_cluster,
+			     List recs)
+{
+	usage_cache_t *entry;
+
+	/*
+	 * Read replica connections are the only ones opened without
+	 * rollback. What they return may predate the last rollup, so keep
+	 * it out of the cache.
+	 */
+	if (!(mysql_conn->flags & DB_CONN_FLAG_ROLLBACK))
+		return;
+
+	entry = xmalloc(sizeof(*entry));
+
+	entry->cluster_name = xstrdup(cluster_name);
+	entry->end = end;
+	entry->is_cluster = is_cluster;
+	entry->query = xstrdup(query);
+	entry->recs = list_create(is_cluster ?
+				  slurmdb_destroy_cluster_accounting_rec :
+				  slurmdb_destroy_accounting_rec);
+	_copy_usage_recs(entry->recs, recs, is_cluster);
+
+	slurm_mutex_lock(&usage_cache_lock);
+	if (!usage_cache)
+		usage_cache = list_create(_destroy_usage_cache);
+	(void) list_delete_all(usage_cache, _find_usage_cache, query);
+	while (list_count(usage_cache) >= USAGE_CACHE_MAX)
+		_destroy_usage_cache(list_pop(usage_cache));
+	list_append(usage_cache, entry);
+	slurm_mutex_unlock(&usage_cache_lock);
+}
+
+extern void as_mysql_usage_cache_invalidate(char *cluster_name, time_t start)
+{
+	usage_cache_inval_t inval = {
+		.cluster_name = cluster_name,
+		.start = start,
+	};
+
+	slurm_mutex_lock(&usage_cache_lock);
+	if (usage_cache)
+		(void) list_delete_all(usage_cache, _find_usage_cache_stale,
+				       &inval);
+	slurm_mutex_unlock(&usage_cache_lock);
+}
+
+extern void as_mysql_usage_cache_fini(void)
+{
+	slurm_mutex_lock(&usage_cache_lock);
+	FREE_NULL_LIST(usage_cache);
+	slurm_mutex_unlock(&usage_cache_lock);
+}
+
 static void *_cluster_rollup_usage(void *arg)
 {
 	local_rollup_t *local_rollup = (local_rollup_t *)arg;
@@ -81,6 +237,7 @@ static void *_cluster_rollup_usage(void *arg)
 	time_t day_end;
 	time_t month_start;
 	time_t month_end;
+	time_t rewrite_start = 0;
 	DEF_TIMERS;
 
 	char *update_req_inx[] = {
@@ -306,6 +463,7 @@ static void *_cluster_rollup_usage(void *arg)
 		END_TIMER3(timer_str, 5000000);
 		rollup_stats->time_total[DBD_ROLLUP_HOUR] += DELTA_TIMER;
 		rollup_stats->timestamp[DBD_ROLLUP_HOUR] = hour_end;
+		rewrite_start = hour_start;
 		if (rc != SLURM_SUCCESS)
 			goto end_it;
 	}
@@ -322,6 +480,8 @@ static void *_cluster_rollup_usage(void *arg)
 		END_TIMER3(timer_str, 5000000);
 		rollup_stats->time_total[DBD_ROLLUP_DAY] += DELTA_TIMER;
 		rollup_stats->timestamp[DBD_ROLLUP_DAY] = day_end;
+		if (!rewrite_start || (day_start < rewrite_start))
+			rewrite_start = day_start;
 		if (rc != SLURM_SUCCESS)
 			goto end_it;
 	}
@@ -338,6 +498,8 @@ static void *_cluster_rollup_usage(void *arg)
 		END_TIMER3(timer_str, 5000000);
 		rollup_stats->time_total[DBD_ROLLUP_MONTH] += DELTA_TIMER;
 		rollup_stats->timestamp[DBD_ROLLUP_MONTH] = month_end;
+		if (!rewrite_start || (month_start < rewrite_start))
+			rewrite_start = month_start;
 		if (rc != SLURM_SUCCESS)
 			goto end_it;
 	}
@@ -388,6 +550,9 @@ end_it:
 			error("Couldn't commit rollup of cluster %s",
 			      local_rollup->cluster_name);
 			rc = SLURM_ERROR;
+		} else if (rewrite_start) {
+			as_mysql_usage_cache_invalidate(
+				local_rollup->cluster_name, rewrite_start);
 		}
 	} else {
 		error("Cluster %s rollup failed", local_rollup->cluster_name);
@@ -421,6 +586,7 @@ static int _get_object_usage(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	char *query = NULL;
+	List new_list;
 	assoc_mgr_lock_t locks = { NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
 				   READ_LOCK, NO_LOCK, NO_LOCK };
 
@@ -474,16 +640,24 @@ static int _get_object_usage(mysql_conn_t *mysql_conn,
 	}
 	xfree(tmp);
 
+	if (!(*usage_list))
+		(*usage_list) = list_create(slurmdb_destroy_accounting_rec);
+
+	if (_usage_cache_get(query, *usage_list)) {
+		DB_DEBUG(DB_USAGE, mysql_conn->conn, "cached\n%s", query);
+		xfree(query);
+		return SLURM_SUCCESS;
+	}
+
 	DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s", query);
 	result = mysql_db_query_ret(mysql_conn, query, 0);
-	xfree(query);
 
-	if (!result)
+	if (!result) {
+		xfree(query);
 		return SLURM_ERROR;
+	}
 
-	if (!(*usage_list))
-		(*usage_list) = list_create(slurmdb_destroy_accounting_rec);
-
+	new_list = list_create(slurmdb_destroy_accounting_rec);
 	assoc_mgr_lock(&locks);
 	while ((row = mysql_fetch_row(result))) {
 		slurmdb_tres_rec_t *tres_rec;
@@ -504,12 +678,18 @@ static int _get_object_usage(mysql_conn_t *mysql_conn,
 		accounting_rec->period_start = slurm_atoul(row[USAGE_START]);
 		accounting_rec->alloc_secs = slurm_atoull(row[USAGE_ALLOC]);
 
-		list_append(*usage_list, accounting_rec);
+		list_append(new_list, accounting_rec);
 	}
 	assoc_mgr_unlock(&locks);
 
 	mysql_free_result(result);
 
+	_usage_cache_add(mysql_conn, query, cluster_name, end, false,
+			 new_list);
+	xfree(query);
+	list_transfer(*usage_list, new_list);
+	FREE_NULL_LIST(new_list);
+
 	return SLURM_SUCCESS;
 }
 
@@ -526,6 +706,7 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 	char *tmp = NULL;
 	char *my_usage_table = cluster_day_table;
 	char *query = NULL;
+	List new_list;
 	assoc_mgr_lock_t locks = { NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
 				   READ_LOCK, NO_LOCK, NO_LOCK };
 	char *cluster_req_inx[] = {
@@ -576,18 +757,25 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 		tmp, cluster_rec->name, my_usage_table, end, start);
 
 	xfree(tmp);
+
+	if (!cluster_rec->accounting_list)
+		cluster_rec->accounting_list =
+			list_create(slurmdb_destroy_cluster_accounting_rec);
+
+	if (_usage_cache_get(query, cluster_rec->accounting_list)) {
+		DB_DEBUG(DB_USAGE, mysql_conn->conn, "cached\n%s", query);
+		xfree(query);
+		return rc;
+	}
+
 	DB_DEBUG(DB_USAGE, mysql_conn->conn, "query\n%s", query);
 
 	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
 		xfree(query);
 		return SLURM_ERROR;
 	}
-	xfree(query);
-
-	if (!cluster_rec->accounting_list)
-		cluster_rec->accounting_list =
-			list_create(slurmdb_destroy_cluster_accounting_rec);
 
+	new_list = list_create(slurmdb_destroy_cluster_accounting_rec);
 	assoc_mgr_lock(&locks);
 	while ((row = mysql_fetch_row(result))) {
 		slurmdb_tres_rec_t *tres_rec;
@@ -612,11 +800,18 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 		accounting_rec->over_secs = slurm_atoull(row[CLUSTER_OCPU]);
 		accounting_rec->plan_secs = slurm_atoull(row[CLUSTER_PCPU]);
 		accounting_rec->period_start = slurm_atoul(row[CLUSTER_START]);
-		list_append(cluster_rec->accounting_list, accounting_rec);
+		list_append(new_list, accounting_rec);
 	}
 	assoc_mgr_unlock(&locks);
 
 	mysql_free_result(result);
+
+	_usage_cache_add(mysql_conn, query, cluster_rec->name, end, true,
+			 new_list);
+	xfree(query);
+	list_transfer(cluster_rec->accounting_list, new_list);
+	FREE_NULL_LIST(new_list);
+
 	return rc;
 }
 
@@ -57,6 +57,13 @@ extern int as_mysql_roll_usage(mysql_conn_t *mysql_conn,
 			       uint16_t archive_data,
 			       List *rollup_stats_list_in);
 
+/*
+ * Drop cached usage query results for cluster_name (all clusters if NULL)
+ * that cover any period ending after start.
+ */
+extern void as_mysql_usage_cache_invalidate(char *cluster_name, time_t start);
+extern void as_mysql_usage_cache_fini(void);
+
 /*
  * Set last_ran_table to event_time if it happened before the last rollup.
  */
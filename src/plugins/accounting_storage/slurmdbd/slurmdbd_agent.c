@@ -37,6 +37,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <dirent.h>
+
 #include "src/common/slurm_xlator.h"
 
 #include "src/common/fd.h"
@@ -47,7 +49,8 @@
 
 enum {
 	MAX_DBD_ACTION_DISCARD,
-	MAX_DBD_ACTION_EXIT
+	MAX_DBD_ACTION_EXIT,
+	MAX_DBD_ACTION_SPOOL
 };
 
 typedef struct {
@@ -61,6 +64,8 @@ slurm_persist_conn_t *slurmdbd_conn = NULL;
 #define DBD_MAGIC		0xDEAD3219
 #define DEBUG_PRINT_MAX_MSG_TYPES 10
 #define MAX_DBD_DEFAULT_ACTION MAX_DBD_ACTION_DISCARD
+#define SPOOL_SEGMENT_MSGS	1000
+#define SPOOL_PREFIX		"dbd.spool."
 
 static pthread_mutex_t agent_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
@@ -77,6 +82,18 @@ static pthread_cond_t  slurmdbd_cond = PTHREAD_COND_INITIALIZER;
 
 static int max_dbd_msg_action = MAX_DBD_DEFAULT_ACTION;
 
+/*
+ * With max_dbd_msg_action=spool, messages that do not fit in agent_list are
+ * appended to numbered segment files in StateSaveLocation. Segments
+ * spool_first .. spool_first + spool_segs - 1 exist, the last one is open
+ * for append on spool_fd. All protected by agent_lock.
+ */
+static int spool_fd = -1;
+static uint32_t spool_first = 0;
+static uint32_t spool_segs = 0;
+static uint32_t spool_tail_cnt = 0;
+static uint32_t spool_cnt = 0;
+
 static int _unpack_return_code(uint16_t rpc_version, buf_t *buffer)
 {
 	uint16_t msg_type = -1;
@@ -303,14 +320,13 @@ static buf_t *_load_dbd_rec(int fd)
 	return buffer;
 }
 
-static void _load_dbd_state(void)
+/* Append the messages saved in dbd_fname to agent_list, return the count */
+static int _load_dbd_file(char *dbd_fname)
 {
-	char *dbd_fname = NULL;
 	buf_t *buffer;
 	int fd, recovered = 0;
 	uint16_t rpc_version = 0;
 
-	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
 	fd = open(dbd_fname, O_RDONLY);
 	if (fd < 0) {
 		/* don't print an error message if there is no file */
@@ -377,9 +393,20 @@ static void _load_dbd_state(void)
 		}
 
 	end_it:
-		verbose("recovered %d pending RPCs", recovered);
+		verbose("recovered %d pending RPCs from %s",
+			recovered, dbd_fname);
 		(void) close(fd);
 	}
+
+	return recovered;
+}
+
+static void _load_dbd_state(void)
+{
+	char *dbd_fname = NULL;
+
+	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
+	(void) _load_dbd_file(dbd_fname);
 	xfree(dbd_fname);
 }
 
@@ -421,13 +448,42 @@ static int _save_dbd_rec(int fd, buf_t *buffer)
 	return SLURM_SUCCESS;
 }
 
+/* Return the message type packed at the start of buffer, 0 if none */
+static uint16_t _buf_msg_type(buf_t *buffer)
+{
+	uint16_t msg_type;
+	uint32_t offset = get_buf_offset(buffer);
+
+	if (offset < 2)
+		return 0;
+	set_buf_offset(buffer, 0);
+	(void) unpack16(&msg_type, buffer);	/* checked by offset */
+	set_buf_offset(buffer, offset);
+
+	return msg_type;
+}
+
+static int _save_dbd_ver(int fd)
+{
+	char curr_ver_str[10];
+	buf_t *buffer;
+	int rc;
+
+	snprintf(curr_ver_str, sizeof(curr_ver_str),
+		 "VER%d", SLURM_PROTOCOL_VERSION);
+	buffer = init_buf(strlen(curr_ver_str));
+	packstr(curr_ver_str, buffer);
+	rc = _save_dbd_rec(fd, buffer);
+	FREE_NULL_BUFFER(buffer);
+
+	return rc;
+}
+
 static void _save_dbd_state(void)
 {
 	char *dbd_fname = NULL;
 	buf_t *buffer;
 	int fd, rc, wrote = 0;
-	uint16_t msg_type;
-	uint32_t offset;
 
 	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
 	(void) unlink(dbd_fname);	/* clear save state */
@@ -435,14 +491,7 @@ static void _save_dbd_state(void)
 	if (fd < 0) {
 		error("Creating state save file %s", dbd_fname);
 	} else if (list_count(agent_list)) {
-		char curr_ver_str[10];
-		snprintf(curr_ver_str, sizeof(curr_ver_str),
-			 "VER%d", SLURM_PROTOCOL_VERSION);
-		buffer = init_buf(strlen(curr_ver_str));
-		packstr(curr_ver_str, buffer);
-		rc = _save_dbd_rec(fd, buffer);
-		FREE_NULL_BUFFER(buffer);
-		if (rc != SLURM_SUCCESS)
+		if ((rc = _save_dbd_ver(fd)) != SLURM_SUCCESS)
 			goto end_it;
 
 		while ((buffer = list_dequeue(agent_list))) {
@@ -452,15 +501,9 @@ static void _save_dbd_state(void)
 			 * deadlock unless they add the bogus cluster name to
 			 * the accounting system.
 			 */
-			offset = get_buf_offset(buffer);
-			if (offset < 2) {
-				FREE_NULL_BUFFER(buffer);
-				continue;
-			}
-			set_buf_offset(buffer, 0);
-			(void) unpack16(&msg_type, buffer);  /* checked by offset */
-			set_buf_offset(buffer, offset);
-			if (msg_type == DBD_REGISTER_CTLD) {
+			switch (_buf_msg_type(buffer)) {
+			case 0:
+			case DBD_REGISTER_CTLD:
 				FREE_NULL_BUFFER(buffer);
 				continue;
 			}
@@ -483,6 +526,133 @@ end_it:
 	xfree(dbd_fname);
 }
 
+static char *_spool_fname(uint32_t seq)
+{
+	return xstrdup_printf("%s/" SPOOL_PREFIX "%u",
+			      slurm_conf.state_save_location, seq);
+}
+
+/* Count the records in a saved message file, not counting the header */
+static uint32_t _spool_count_recs(char *fname)
+{
+	uint32_t msg_size, cnt = 0;
+	int fd;
+
+	if ((fd = open(fname, O_RDONLY)) < 0)
+		return 0;
+	while (read(fd, &msg_size, sizeof(msg_size)) == sizeof(msg_size)) {
+		if (lseek(fd, msg_size + sizeof(uint32_t), SEEK_CUR) < 0)
+			break;
+		cnt++;
+	}
+	(void) close(fd);
+
+	return cnt ? (cnt - 1) : 0;
+}
+
+static void _spool_close_tail(void)
+{
+	if (spool_fd < 0)
+		return;
+	if (fsync_and_close(spool_fd, "dbd.spool"))
+		error("error from fsync_and_close");
+	spool_fd = -1;
+}
+
+/* Find segments left by an earlier run, called with agent_lock held */
+static void _spool_recover(void)
+{
+	DIR *dir;
+	struct dirent *ent;
+	uint32_t seq, first = UINT32_MAX, last = 0;
+	char *end;
+
+	spool_fd = -1;
+	spool_first = spool_segs = spool_tail_cnt = spool_cnt = 0;
+
+	if (!(dir = opendir(slurm_conf.state_save_location)))
+		return;
+	while ((ent = readdir(dir))) {
+		if (xstrncmp(ent->d_name, SPOOL_PREFIX, strlen(SPOOL_PREFIX)))
+			continue;
+		seq = strtoul(ent->d_name + strlen(SPOOL_PREFIX), &end, 10);
+		if (*end)
+			continue;
+		first = MIN(first, seq);
+		last = MAX(last, seq);
+	}
+	closedir(dir);
+
+	if (first == UINT32_MAX)
+		return;
+
+	spool_first = first;
+	spool_segs = last - first + 1;
+	for (seq = first; seq <= last; seq++) {
+		char *fname = _spool_fname(seq);
+		spool_cnt += _spool_count_recs(fname);
+		xfree(fname);
+	}
+	verbose("found %u spooled RPCs in %u segments",
+		spool_cnt, spool_segs);
+}
+
+/* Append buffer to the spool tail, called with agent_lock held */
+static int _spool_append(buf_t *buffer)
+{
+	if ((spool_fd < 0) || (spool_tail_cnt >= SPOOL_SEGMENT_MSGS)) {
+		char *fname = _spool_fname(spool_first + spool_segs);
+
+		_spool_close_tail();
+		spool_fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+		if (spool_fd < 0) {
+			error("Creating spool file %s: %m", fname);
+			xfree(fname);
+			return SLURM_ERROR;
+		}
+		xfree(fname);
+		spool_segs++;
+		spool_tail_cnt = 0;
+		if (_save_dbd_ver(spool_fd) != SLURM_SUCCESS) {
+			_spool_close_tail();
+			return SLURM_ERROR;
+		}
+	}
+
+	if (_save_dbd_rec(spool_fd, buffer) != SLURM_SUCCESS)
+		return SLURM_ERROR;
+
+	spool_tail_cnt++;
+	spool_cnt++;
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Move the oldest spooled segments into agent_list while it has room for
+ * them, called with agent_lock held.
+ */
+static void _spool_drain(void)
+{
+	while (spool_segs &&
+	       ((list_count(agent_list) + SPOOL_SEGMENT_MSGS) <=
+		slurm_conf.max_dbd_msgs)) {
+		char *fname = _spool_fname(spool_first);
+		int loaded;
+
+		if (spool_segs == 1)
+			_spool_close_tail();
+		loaded = _load_dbd_file(fname);
+		(void) unlink(fname);
+		xfree(fname);
+
+		spool_first++;
+		spool_segs--;
+		spool_cnt -= MIN(spool_cnt, loaded);
+		if (!spool_segs)
+			spool_cnt = 0;
+	}
+}
+
 /*
  * Purge queued records from the agent queue
  */
@@ -520,6 +690,11 @@ static int _purge_agent_list_req(void *x, void *arg)
 static void _max_dbd_msg_action(uint32_t *msg_cnt)
 {
 	int purged = 0;
+
+	/* Nothing is dropped, overflow goes to the spool */
+	if (max_dbd_msg_action == MAX_DBD_ACTION_SPOOL)
+		return;
+
 	if (max_dbd_msg_action == MAX_DBD_ACTION_EXIT) {
 		if (*msg_cnt < slurm_conf.max_dbd_msgs)
 			return;
@@ -597,7 +772,7 @@ static int _get_my_list(void *x, void *arg)
 	buf_t *buffer = x;
 	foreach_get_my_list_t *args = arg;
 
-	args->msg_size += size_buf(buffer);
+	args->msg_size += get_buf_offset(buffer);
 	if (args->msg_size > MAX_MSG_SIZE)
 		return -1;
 	list_enqueue(args->my_list, buffer);
@@ -652,6 +827,8 @@ static void *_agent(void *x)
 		}
 
 		slurm_mutex_lock(&agent_lock);
+		if (spool_segs && (slurmdbd_conn->fd >= 0))
+			_spool_drain();
 		cnt = list_count(agent_list);
 		if ((cnt == 0) || (slurmdbd_conn->fd < 0) ||
 		    (fail_time && (difftime(time(NULL), fail_time) < 10))) {
@@ -773,6 +950,7 @@ static void *_agent(void *x)
 
 	slurm_mutex_lock(&agent_lock);
 	_save_dbd_state();
+	_spool_close_tail();
 
 	log_flag(AGENT, "slurmdbd agent ending with agent_count=%d",
 		 list_count(agent_list));
@@ -795,6 +973,7 @@ static void _create_agent(void)
 	if (agent_list == NULL) {
 		agent_list = list_create(slurmdbd_free_buffer);
 		_load_dbd_state();
+		_spool_recover();
 	}
 
 	if (agent_tid == 0) {
@@ -962,7 +1141,18 @@ extern int slurmdbd_agent_send(uint16_t rpc_version, persist_msg_t *req)
 	/* Handle action */
 	_max_dbd_msg_action(&cnt);
 
-	if (cnt < slurm_conf.max_dbd_msgs) {
+	if ((max_dbd_msg_action == MAX_DBD_ACTION_SPOOL) &&
+	    (spool_segs || (cnt >= slurm_conf.max_dbd_msgs)) &&
+	    (req->msg_type != DBD_REGISTER_CTLD)) {
+		/* Once anything is spooled the rest must follow it in order */
+		if (_spool_append(buffer) != SLURM_SUCCESS) {
+			error("unable to spool %s request, discarding it",
+			      slurmdbd_msg_type_2_str(req->msg_type, 1));
+			(slurmdbd_conn->trigger_callbacks.acct_full)();
+			rc = SLURM_ERROR;
+		}
+		FREE_NULL_BUFFER(buffer);
+	} else if (cnt < slurm_conf.max_dbd_msgs) {
 		list_enqueue(agent_list, buffer);
 	} else {
 		error("agent queue is full (%u), discarding %s:%u request",
@@ -990,7 +1180,7 @@ extern bool slurmdbd_conn_active(void)
 
 extern int slurmdbd_agent_queue_count(void)
 {
-	return list_count(agent_list);
+	return list_count(agent_list) + spool_cnt;
 }
 
 extern void slurmdbd_agent_config_setup(void)
@@ -1017,6 +1207,8 @@ extern void slurmdbd_agent_config_setup(void)
 			max_dbd_msg_action = MAX_DBD_ACTION_DISCARD;
 		else if (!xstrcasecmp(type, "exit"))
 			max_dbd_msg_action = MAX_DBD_ACTION_EXIT;
+		else if (!xstrcasecmp(type, "spool"))
+			max_dbd_msg_action = MAX_DBD_ACTION_SPOOL;
 		else
 			fatal("Unknown SlurmctldParameters option for max_dbd_msg_action '%s'",
 			      type);
@@ -67,11 +67,15 @@
 #include "src/slurmd/common/privileges.h"
 #include "hdf5_api.h"
 
-#define HDF5_CHUNK_SIZE 10
+/*
+ * Samples per chunk of each table. Larger chunks mean fewer, bigger writes
+ * to the file when sampling at a high frequency.
+ */
+#define HDF5_CHUNK_SIZE 128
 /* Compression level, a value of 0 through 9. Level 0 is faster but offers the
  * least compression; level 9 is slower but offers maximum compression.
- * A setting of -1 indicates that no compression is desired. */
-/* TODO: Make this configurable with a parameter */
+ * A setting of -1 indicates that no compression is desired.
+ * Default for ProfileHDF5Compress. */
 #define HDF5_COMPRESS 0
 
 /*
@@ -104,8 +108,10 @@ const char plugin_type[] = "acct_gather_profile/hdf5";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 typedef struct {
+	int compress;
 	char *dir;
 	uint32_t def;
+	char *local_dir;
 } slurm_hdf5_conf_t;
 
 typedef struct {
@@ -128,6 +134,8 @@ static slurm_hdf5_conf_t hdf5_conf;
 static uint32_t g_profile_running = ACCT_GATHER_PROFILE_NOT_SET;
 static stepd_step_rec_t *g_job = NULL;
 static time_t step_start_time;
+static char *profile_file_name = NULL;
+static char *local_file_name = NULL;
 
 static hid_t *groups = NULL;
 static size_t groups_len = 0;
@@ -138,6 +146,8 @@ static size_t   tables_cur_len = 0;
 static void _reset_slurm_profile_conf(void)
 {
 	xfree(hdf5_conf.dir);
+	xfree(hdf5_conf.local_dir);
+	hdf5_conf.compress = HDF5_COMPRESS;
 	hdf5_conf.def = ACCT_GATHER_PROFILE_NONE;
 }
 
@@ -222,6 +232,68 @@ static void _create_directories(void)
 	/* Do not xfree() hdf5_dir_rel (interior pointer to freed data). */
 }
 
+/*
+ * Move the node local profile file to ProfileHDF5Dir with one sequential
+ * copy, as the user, then remove the local file.
+ */
+static int _copy_local_file(void)
+{
+	struct priv_state sprivs = { 0 };
+	char buf[64 * 1024];
+	int in_fd = -1, out_fd = -1, rc = SLURM_SUCCESS;
+	ssize_t len;
+
+	if (drop_privileges(g_job, true, &sprivs, false) < 0) {
+		error("%s: Unable to drop privileges", __func__);
+		return SLURM_ERROR;
+	}
+
+	if ((in_fd = open(local_file_name, O_RDONLY | O_CLOEXEC)) < 0) {
+		error("%s: open(%s): %m", __func__, local_file_name);
+		rc = SLURM_ERROR;
+		goto end;
+	}
+	if ((out_fd = open(profile_file_name,
+			   O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			   0644)) < 0) {
+		error("%s: open(%s): %m", __func__, profile_file_name);
+		rc = SLURM_ERROR;
+		goto end;
+	}
+
+	while ((len = read(in_fd, buf, sizeof(buf))) > 0) {
+		safe_write(out_fd, buf, len);
+	}
+	if (len < 0) {
+		error("%s: read(%s): %m", __func__, local_file_name);
+		rc = SLURM_ERROR;
+		goto end;
+	}
+
+	log_flag(PROFILE, "PROFILE: copied %s to %s",
+		 local_file_name, profile_file_name);
+	goto end;
+
+rwfail:
+	error("%s: write(%s): %m", __func__, profile_file_name);
+	rc = SLURM_ERROR;
+end:
+	if (out_fd >= 0)
+		close(out_fd);
+	if (in_fd >= 0)
+		close(in_fd);
+	/* Keep the local copy if it could not be saved */
+	if ((rc == SLURM_SUCCESS) && (unlink(local_file_name) < 0))
+		error("%s: unlink(%s): %m", __func__, local_file_name);
+
+	if (reclaim_privileges(&sprivs) < 0) {
+		error("%s: Unable to reclaim privileges", __func__);
+		rc = SLURM_ERROR;
+	}
+
+	return rc;
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
@@ -243,6 +315,9 @@ extern int fini(void)
 	xfree(tables);
 	xfree(groups);
 	xfree(hdf5_conf.dir);
+	xfree(hdf5_conf.local_dir);
+	xfree(profile_file_name);
+	xfree(local_file_name);
 	return SLURM_SUCCESS;
 }
 
@@ -250,8 +325,10 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 					       int *full_options_cnt)
 {
 	s_p_options_t options[] = {
+		{"ProfileHDF5Compress", S_P_LONG},
 		{"ProfileHDF5Dir", S_P_STRING},
 		{"ProfileHDF5Default", S_P_STRING},
+		{"ProfileHDF5LocalDir", S_P_STRING},
 		{NULL} };
 
 	transfer_s_p_options(full_options, options, full_options_cnt);
@@ -261,9 +338,17 @@ extern void acct_gather_profile_p_conf_options(s_p_options_t **full_options,
 extern void acct_gather_profile_p_conf_set(s_p_hashtbl_t *tbl)
 {
 	char *tmp = NULL;
+	long compress;
 	_reset_slurm_profile_conf();
 	if (tbl) {
 		s_p_get_string(&hdf5_conf.dir, "ProfileHDF5Dir", tbl);
+		s_p_get_string(&hdf5_conf.local_dir, "ProfileHDF5LocalDir",
+			       tbl);
+		if (s_p_get_long(&compress, "ProfileHDF5Compress", tbl)) {
+			if ((compress < -1) || (compress > 9))
+				fatal("ProfileHDF5Compress must be between -1 and 9");
+			hdf5_conf.compress = compress;
+		}
 
 		if (s_p_get_string(&tmp, "ProfileHDF5Default", tbl)) {
 			hdf5_conf.def = acct_gather_profile_from_string(tmp);
@@ -309,7 +394,7 @@ extern int acct_gather_profile_p_node_step_start(stepd_step_rec_t* job)
 {
 	int rc = SLURM_SUCCESS;
 	struct priv_state sprivs = { 0 };
-	char *profile_file_name;
+	char *file_name;
 
 	xassert(running_in_slurmstepd());
 
@@ -332,6 +417,7 @@ extern int acct_gather_profile_p_node_step_start(stepd_step_rec_t* job)
 	 * Use a more user friendly string "batch" rather
 	 * then 4294967294.
 	 */
+	xfree(profile_file_name);
 	if (g_job->step_id.step_id == SLURM_BATCH_SCRIPT) {
 		profile_file_name = xstrdup_printf("%s/%s/%u_%s_%s.h5",
 						   hdf5_conf.dir,
@@ -347,30 +433,39 @@ extern int acct_gather_profile_p_node_step_start(stepd_step_rec_t* job)
 			g_job->node_name);
 	}
 
+	/*
+	 * With ProfileHDF5LocalDir the samples are written to node local
+	 * storage and the file is copied to ProfileHDF5Dir once at step end,
+	 * keeping the small periodic writes off the shared file system.
+	 */
+	xfree(local_file_name);
+	if (hdf5_conf.local_dir)
+		local_file_name = xstrdup_printf("%s/%s",
+						 hdf5_conf.local_dir,
+						 strrchr(profile_file_name,
+							 '/') + 1);
+	file_name = local_file_name ? local_file_name : profile_file_name;
+
 	log_flag(PROFILE, "PROFILE: node_step_start, opt=%s file=%s",
 		 acct_gather_profile_to_string(g_profile_running),
-		 profile_file_name);
+		 file_name);
 
 	if (drop_privileges(g_job, true, &sprivs, false) < 0) {
 		error("%s: Unable to drop privileges", __func__);
-		xfree(profile_file_name);
 		return SLURM_ERROR;
 	}
 
 	/*
 	 * Create a new file using the default properties
 	 */
-	file_id = H5Fcreate(profile_file_name, H5F_ACC_TRUNC, H5P_DEFAULT,
+	file_id = H5Fcreate(file_name, H5F_ACC_TRUNC, H5P_DEFAULT,
 			    H5P_DEFAULT);
 
 	if (reclaim_privileges(&sprivs) < 0) {
 		error("%s: Unable to reclaim privileges", __func__);
-		xfree(profile_file_name);
 		return SLURM_ERROR;
 	}
 
-	xfree(profile_file_name);
-
 	if (file_id < 1) {
 		info("PROFILE: Failed to create Node group");
 		return SLURM_ERROR;
@@ -454,6 +549,9 @@ extern int acct_gather_profile_p_node_step_end(void)
 	profile_fini();
 	file_id = -1;
 
+	if (local_file_name)
+		rc = _copy_local_file();
+
 	return rc;
 }
 
@@ -571,7 +669,7 @@ extern int acct_gather_profile_p_create_dataset(
 	if (parent < 0)
 		parent = gid_node; /* default parent is the node group */
 	table_id = H5PTcreate_fl(parent, name, dtype_id, HDF5_CHUNK_SIZE,
-	                         HDF5_COMPRESS);
+				 hdf5_conf.compress);
 	if (table_id < 0) {
 		error("PROFILE: Impossible to create the table %s", name);
 		H5Tclose(dtype_id);
@@ -646,6 +744,11 @@ extern void acct_gather_profile_p_conf_values(List *data)
 
 	xassert(*data);
 
+	key_pair = xmalloc(sizeof(config_key_pair_t));
+	key_pair->name = xstrdup("ProfileHDF5Compress");
+	key_pair->value = xstrdup_printf("%d", hdf5_conf.compress);
+	list_append(*data, key_pair);
+
 	key_pair = xmalloc(sizeof(config_key_pair_t));
 	key_pair->name = xstrdup("ProfileHDF5Dir");
 	key_pair->value = xstrdup(hdf5_conf.dir);
@@ -656,6 +759,11 @@ extern void acct_gather_profile_p_conf_values(List *data)
 	key_pair->value = xstrdup(acct_gather_profile_to_string(hdf5_conf.def));
 	list_append(*data, key_pair);
 
+	key_pair = xmalloc(sizeof(config_key_pair_t));
+	key_pair->name = xstrdup("ProfileHDF5LocalDir");
+	key_pair->value = xstrdup(hdf5_conf.local_dir);
+	list_append(*data, key_pair);
+
 	return;
 
 }
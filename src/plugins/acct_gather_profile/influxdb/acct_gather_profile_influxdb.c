@@ -69,6 +69,9 @@
 #include "src/interfaces/proctrack.h"
 
 #define DEFAULT_INFLUXDB_TIMEOUT 10
+#define INFLUXDB_BUF_SIZE (256 * 1024)
+#define INFLUXDB_MAX_BUF_SIZE (4 * 1024 * 1024)
+#define INFLUXDB_MAX_RETRY_DELAY 300
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -132,7 +135,13 @@ static uint32_t g_profile_running = ACCT_GATHER_PROFILE_NOT_SET;
 static stepd_step_rec_t *g_job = NULL;
 
 static char *datastr = NULL;
-static int datastrlen = 0;
+static char *datastr_pos = NULL;
+static size_t datastrlen = 0;
+
+static CURL *curl_handle = NULL;
+static char *url = NULL;
+static time_t retry_time = 0;
+static int retry_delay = 0;
 
 static table_t *tables = NULL;
 static size_t tables_max_len = 0;
@@ -193,52 +202,36 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to send data to influxdb */
-static int _send_data(const char *data)
+/*
+ * POST the buffered data to influxdb on the persistent handle.
+ * RET SLURM_SUCCESS, SLURM_ERROR if the data should be discarded, or EAGAIN
+ * if the server could not be reached or is overloaded and the data should be
+ * sent again later.
+ */
+static int _post_data(void)
 {
-	CURL *curl_handle = NULL;
 	CURLcode res;
 	struct http_response chunk;
 	int rc = SLURM_SUCCESS;
 	long response_code;
 	static int error_cnt = 0;
-	char *url = NULL;
-	size_t length;
-
-	debug3("%s %s called", plugin_type, __func__);
-
-	/*
-	 * Every compute node which is sampling data will try to establish a
-	 * different connection to the influxdb server. In order to reduce the
-	 * number of connections, every time a new sampled data comes in, it
-	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
-	 * try to open the connection and send this buffer, instead of opening
-	 * one per sample.
-	 */
-	if (data && ((datastrlen + strlen(data)) <= BUF_SIZE)) {
-		xstrcat(datastr, data);
-		length = strlen(data);
-		datastrlen += length;
-		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %d",
-			 plugin_type, __func__, length, datastrlen);
-		return rc;
-	}
 
 	DEF_TIMERS;
 	START_TIMER;
 
-	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
-		error("%s %s: curl_global_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_global_init;
-	} else if ((curl_handle = curl_easy_init()) == NULL) {
+	/*
+	 * The handle is kept for the life of the step so that libcurl can
+	 * reuse the connection to the server across flushes.
+	 */
+	if (!curl_handle && !(curl_handle = curl_easy_init())) {
 		error("%s %s: curl_easy_init: %m", plugin_type, __func__);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+		return EAGAIN;
 	}
 
-	xstrfmtcat(url, "%s/write?db=%s&rp=%s&precision=s", influxdb_conf.host,
-		   influxdb_conf.database, influxdb_conf.rt_policy);
+	if (!url)
+		xstrfmtcat(url, "%s/write?db=%s&rp=%s&precision=s",
+			   influxdb_conf.host, influxdb_conf.database,
+			   influxdb_conf.rt_policy);
 
 	chunk.message = xmalloc(1);
 	chunk.size = 0;
@@ -249,19 +242,20 @@ static int _send_data(const char *data)
 				 influxdb_conf.password);
 	curl_easy_setopt(curl_handle, CURLOPT_POST, 1);
 	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, datastr);
-	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, strlen(datastr));
+	curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, (long) datastrlen);
 	if (influxdb_conf.username)
 		curl_easy_setopt(curl_handle, CURLOPT_USERNAME,
 				 influxdb_conf.username);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, _write_callback);
 	curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk);
 	curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, influxdb_conf.timeout);
+	curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
 
 	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
 		if ((error_cnt++ % 100) == 0)
-			error("%s %s: curl_easy_perform failed to send data (discarded). Reason: %s",
+			error("%s %s: curl_easy_perform failed to send data (will retry). Reason: %s",
 			      plugin_type, __func__, curl_easy_strerror(res));
-		rc = SLURM_ERROR;
+		rc = EAGAIN;
 		goto cleanup;
 	}
 
@@ -284,7 +278,7 @@ static int _send_data(const char *data)
 		if (error_cnt > 0)
 			error_cnt = 0;
 	} else {
-		rc = SLURM_ERROR;
+		rc = (response_code >= 500) ? EAGAIN : SLURM_ERROR;
 		debug2("%s %s: data write failed, response code: %ld",
 		       plugin_type, __func__, response_code);
 		if (slurm_conf.debug_flags & DEBUG_FLAG_PROFILE) {
@@ -298,24 +292,65 @@ static int _send_data(const char *data)
 
 cleanup:
 	xfree(chunk.message);
-	xfree(url);
-cleanup_easy_init:
-	curl_easy_cleanup(curl_handle);
-cleanup_global_init:
-	curl_global_cleanup();
 
 	END_TIMER;
 	log_flag(PROFILE, "%s %s: took %s to send data",
 		 plugin_type, __func__, TIME_STR);
 
+	return rc;
+}
+
+/* Try to send data to influxdb */
+static int _send_data(const char *data)
+{
+	int rc = SLURM_SUCCESS;
+	time_t now = time(NULL);
+	size_t length;
+
+	debug3("%s %s called", plugin_type, __func__);
+
+	/*
+	 * Every compute node which is sampling data will try to establish a
+	 * different connection to the influxdb server. In order to reduce the
+	 * number of connections, every time a new sampled data comes in, it
+	 * is saved in the 'datastr' buffer. Once this buffer is full, then we
+	 * try to send it, instead of sending one request per sample. While
+	 * the server is unreachable the buffer keeps growing, up to a limit,
+	 * and is sent again with an increasing delay.
+	 */
 	if (data) {
-		datastr = xstrdup(data);
-		datastrlen = strlen(data);
-	} else {
-		datastr[0] = '\0';
-		datastrlen = 0;
+		length = strlen(data);
+		if ((datastrlen + length) > INFLUXDB_MAX_BUF_SIZE) {
+			log_flag(PROFILE, "%s %s: buffer limit reached, %zu bytes of data discarded",
+				 plugin_type, __func__, length);
+			return SLURM_ERROR;
+		}
+		xstrcatat(datastr, &datastr_pos, data);
+		datastrlen += length;
+		log_flag(PROFILE, "%s %s: %zu bytes of data added to buffer. New buffer size: %zu",
+			 plugin_type, __func__, length, datastrlen);
+		if ((datastrlen < INFLUXDB_BUF_SIZE) || (retry_time > now))
+			return rc;
+	}
+
+	if (!datastrlen)
+		return rc;
+
+	if ((rc = _post_data()) == EAGAIN) {
+		retry_delay = retry_delay ?
+			MIN(retry_delay * 2, INFLUXDB_MAX_RETRY_DELAY) : 1;
+		retry_time = now + retry_delay;
+		log_flag(PROFILE, "%s %s: %zu bytes of data kept, retrying in %d seconds",
+			 plugin_type, __func__, datastrlen, retry_delay);
+		return SLURM_ERROR;
 	}
 
+	retry_delay = 0;
+	retry_time = 0;
+	datastr_pos = datastr;
+	datastr[0] = '\0';
+	datastrlen = 0;
+
 	return rc;
 }
 
@@ -330,7 +365,13 @@ extern int init(void)
 	if (!running_in_slurmstepd())
 		return SLURM_SUCCESS;
 
-	datastr = xmalloc(BUF_SIZE);
+	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+		error("%s %s: curl_global_init: %m", plugin_type, __func__);
+		return SLURM_ERROR;
+	}
+
+	datastr = xmalloc(INFLUXDB_BUF_SIZE);
+	datastr_pos = datastr;
 	return SLURM_SUCCESS;
 }
 
@@ -339,6 +380,12 @@ extern int fini(void)
 	debug3("%s %s called", plugin_type, __func__);
 
 	_free_tables();
+	if (running_in_slurmstepd()) {
+		if (curl_handle)
+			curl_easy_cleanup(curl_handle);
+		curl_global_cleanup();
+	}
+	xfree(url);
 	xfree(datastr);
 	xfree(influxdb_conf.host);
 	xfree(influxdb_conf.database);
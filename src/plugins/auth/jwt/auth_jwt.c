@@ -36,6 +36,7 @@
 
 #include <jwt.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -46,6 +47,7 @@
 #include "src/common/slurm_xlator.h"
 
 #include "src/common/data.h"
+#include "src/common/macros.h"
 #include "src/common/pack.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/read_config.h"
@@ -110,6 +112,24 @@ static char *claim_field = NULL;
 static __thread char *thread_token = NULL;
 static __thread char *thread_username = NULL;
 
+/*
+ * Cache of tokens that have already passed signature verification.
+ * Clients commonly reuse one token for many requests, so remembering the
+ * username a token resolved to (until its "exp" claim) avoids repeating the
+ * signature check. Direct mapped by token hash: a collision simply evicts
+ * the older entry. The whole token is compared on lookup.
+ */
+#define TOKEN_CACHE_SIZE 256
+
+typedef struct {
+	char *token;
+	char *username;
+	time_t expiration;
+} token_cache_t;
+
+static token_cache_t token_cache[TOKEN_CACHE_SIZE];
+static pthread_mutex_t token_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /*
  * This plugin behaves differently than the others in that it needs to operate
  * asynchronously. If we're running in one of the daemons, it's presumed that
@@ -275,6 +295,13 @@ extern int init(void)
 
 extern int fini(void)
 {
+	slurm_mutex_lock(&token_cache_lock);
+	for (int i = 0; i < TOKEN_CACHE_SIZE; i++) {
+		xfree(token_cache[i].token);
+		xfree(token_cache[i].username);
+	}
+	slurm_mutex_unlock(&token_cache_lock);
+
 	xfree(claim_field);
 	FREE_NULL_DATA(jwks);
 	FREE_NULL_BUFFER(key);
@@ -338,6 +365,53 @@ static data_for_each_cmd_t _verify_rs256_jwt(data_t *d, void *arg)
 	return DATA_FOR_EACH_STOP;
 }
 
+static token_cache_t *_token_cache_slot(const char *token)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	for (const char *p = token; *p; p++) {
+		hash ^= (unsigned char) *p;
+		hash *= 16777619U;
+	}
+
+	return &token_cache[hash % TOKEN_CACHE_SIZE];
+}
+
+/* Returns xstrdup()ed username if token was previously verified or NULL */
+static char *_token_cache_get(const char *token)
+{
+	char *username = NULL;
+	token_cache_t *entry = _token_cache_slot(token);
+
+	slurm_mutex_lock(&token_cache_lock);
+	if (entry->token && !xstrcmp(entry->token, token)) {
+		if (entry->expiration >= time(NULL)) {
+			username = xstrdup(entry->username);
+		} else {
+			xfree(entry->token);
+			xfree(entry->username);
+		}
+	}
+	slurm_mutex_unlock(&token_cache_lock);
+
+	return username;
+}
+
+static void _token_cache_add(const char *token, const char *username,
+			     time_t expiration)
+{
+	token_cache_t *entry = _token_cache_slot(token);
+
+	slurm_mutex_lock(&token_cache_lock);
+	xfree(entry->token);
+	xfree(entry->username);
+	entry->token = xstrdup(token);
+	entry->username = xstrdup(username);
+	entry->expiration = expiration;
+	slurm_mutex_unlock(&token_cache_lock);
+}
+
 /*
  * Verify a credential to approve or deny authentication.
  *
@@ -349,6 +423,7 @@ extern int auth_p_verify(auth_token_t *cred, char *auth_info)
 	const char *alg;
 	jwt_t *unverified_jwt = NULL, *jwt = NULL;
 	char *username = NULL;
+	time_t expiration;
 
 	if (!cred)
 		return SLURM_ERROR;
@@ -367,6 +442,9 @@ extern int auth_p_verify(auth_token_t *cred, char *auth_info)
 		goto fail;
 	}
 
+	if ((username = _token_cache_get(cred->token)))
+		goto verified;
+
 	if ((rc = jwt_decode(&unverified_jwt, cred->token, NULL, 0))) {
 		error("%s: initial jwt_decode failure: %s",
 		      __func__, slurm_strerror(rc));
@@ -429,7 +507,7 @@ extern int auth_p_verify(auth_token_t *cred, char *auth_info)
 	 * check the expiration, and sort out the appropriate username
 	 */
 
-	if (jwt_get_grant_int(jwt, "exp") < time(NULL)) {
+	if ((expiration = jwt_get_grant_int(jwt, "exp")) < time(NULL)) {
 		error("%s: token expired", __func__);
 		goto fail;
 	}
@@ -450,6 +528,9 @@ extern int auth_p_verify(auth_token_t *cred, char *auth_info)
 	jwt_free(jwt);
 	jwt = NULL;
 
+	_token_cache_add(cred->token, username, expiration);
+
+verified:
 	if (!cred->username)
 		cred->username = username;
 	else if (!xstrcmp(cred->username, username)) {
@@ -225,8 +225,11 @@ extern void bb_clear_config(bb_config_t *config_ptr, bool fini)
 		for (i = 0; i < config_ptr->pool_cnt; i++)
 			config_ptr->pool_ptr[i].total_space = 0;
 	}
+	config_ptr->other_parallel = 0;
 	config_ptr->other_timeout = 0;
+	config_ptr->stage_in_parallel = 0;
 	config_ptr->stage_in_timeout = 0;
+	config_ptr->stage_out_parallel = 0;
 	config_ptr->stage_out_timeout = 0;
 	xfree(config_ptr->start_stage_in);
 	xfree(config_ptr->start_stage_out);
@@ -523,9 +526,12 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 		{"GetSysState", S_P_STRING},
 		{"GetSysStatus", S_P_STRING},
 		{"Granularity", S_P_STRING},
+		{"OtherParallel", S_P_UINT32},
 		{"OtherTimeout", S_P_UINT32},
 		{"Pools", S_P_STRING},
+		{"StageInParallel", S_P_UINT32},
 		{"StageInTimeout", S_P_UINT32},
+		{"StageOutParallel", S_P_UINT32},
 		{"StageOutTimeout", S_P_UINT32},
 		{"StartStageIn", S_P_STRING},
 		{"StartStageOut", S_P_STRING},
@@ -548,8 +554,11 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 	/* Set default configuration */
 	bb_clear_config(&state_ptr->bb_config, false);
 	state_ptr->bb_config.flags |= BB_FLAG_DISABLE_PERSISTENT;
+	state_ptr->bb_config.other_parallel = DEFAULT_STAGE_PARALLEL;
 	state_ptr->bb_config.other_timeout = DEFAULT_OTHER_TIMEOUT;
+	state_ptr->bb_config.stage_in_parallel = DEFAULT_STAGE_PARALLEL;
 	state_ptr->bb_config.stage_in_timeout = DEFAULT_STATE_IN_TIMEOUT;
+	state_ptr->bb_config.stage_out_parallel = DEFAULT_STAGE_PARALLEL;
 	state_ptr->bb_config.stage_out_timeout = DEFAULT_STATE_OUT_TIMEOUT;
 	state_ptr->bb_config.validate_timeout = DEFAULT_VALIDATE_TIMEOUT;
 
@@ -652,12 +661,34 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 		xfree(tmp);
 	}
 
+	(void) s_p_get_uint32(&state_ptr->bb_config.other_parallel,
+			     "OtherParallel", bb_hashtbl);
 	(void) s_p_get_uint32(&state_ptr->bb_config.other_timeout,
 			     "OtherTimeout", bb_hashtbl);
+	(void) s_p_get_uint32(&state_ptr->bb_config.stage_in_parallel,
+			    "StageInParallel", bb_hashtbl);
 	(void) s_p_get_uint32(&state_ptr->bb_config.stage_in_timeout,
 			    "StageInTimeout", bb_hashtbl);
+	(void) s_p_get_uint32(&state_ptr->bb_config.stage_out_parallel,
+			    "StageOutParallel", bb_hashtbl);
 	(void) s_p_get_uint32(&state_ptr->bb_config.stage_out_timeout,
 			    "StageOutTimeout", bb_hashtbl);
+	if (!state_ptr->bb_config.other_parallel) {
+		error("%s: Invalid OtherParallel=0, using default of %d",
+		      __func__, DEFAULT_STAGE_PARALLEL);
+		state_ptr->bb_config.other_parallel = DEFAULT_STAGE_PARALLEL;
+	}
+	if (!state_ptr->bb_config.stage_in_parallel) {
+		error("%s: Invalid StageInParallel=0, using default of %d",
+		      __func__, DEFAULT_STAGE_PARALLEL);
+		state_ptr->bb_config.stage_in_parallel = DEFAULT_STAGE_PARALLEL;
+	}
+	if (!state_ptr->bb_config.stage_out_parallel) {
+		error("%s: Invalid StageOutParallel=0, using default of %d",
+		      __func__, DEFAULT_STAGE_PARALLEL);
+		state_ptr->bb_config.stage_out_parallel =
+			DEFAULT_STAGE_PARALLEL;
+	}
 	s_p_get_string(&state_ptr->bb_config.start_stage_in, "StartStageIn",
 		       bb_hashtbl);
 	s_p_get_string(&state_ptr->bb_config.start_stage_out, "StartStageOut",
@@ -700,10 +731,16 @@ extern void bb_load_config(bb_state_t *state_ptr, char *plugin_type)
 			     state_ptr->bb_config.pool_ptr[i].name,
 			     state_ptr->bb_config.pool_ptr[i].total_space);
 		}
+		info("%s: OtherParallel:%u", __func__,
+		     state_ptr->bb_config.other_parallel);
 		info("%s: OtherTimeout:%u", __func__,
 		     state_ptr->bb_config.other_timeout);
+		info("%s: StageInParallel:%u", __func__,
+		     state_ptr->bb_config.stage_in_parallel);
 		info("%s: StageInTimeout:%u", __func__,
 		     state_ptr->bb_config.stage_in_timeout);
+		info("%s: StageOutParallel:%u", __func__,
+		     state_ptr->bb_config.stage_out_parallel);
 		info("%s: StageOutTimeout:%u", __func__,
 		     state_ptr->bb_config.stage_out_timeout);
 		info("%s: StartStageIn:%s",  __func__,
@@ -1103,6 +1140,46 @@ extern void bb_sleep(bb_state_t *state_ptr, int add_secs)
 	slurm_mutex_unlock(&state_ptr->term_mutex);
 }
 
+extern int bb_throttle_cnt(bb_throttle_t *throttle)
+{
+	int cnt;
+
+	slurm_mutex_lock(&throttle->mutex);
+	cnt = throttle->cnt;
+	slurm_mutex_unlock(&throttle->mutex);
+
+	return cnt;
+}
+
+extern bool bb_throttle_fini(bb_throttle_t *throttle, uint32_t limit)
+{
+	bool was_full;
+
+	slurm_mutex_lock(&throttle->mutex);
+	was_full = (throttle->cnt >= limit);
+	throttle->cnt--;
+	slurm_cond_broadcast(&throttle->cond);
+	slurm_mutex_unlock(&throttle->mutex);
+
+	return was_full;
+}
+
+extern void bb_throttle_incr(bb_throttle_t *throttle)
+{
+	slurm_mutex_lock(&throttle->mutex);
+	throttle->cnt++;
+	slurm_mutex_unlock(&throttle->mutex);
+}
+
+extern void bb_throttle_start(bb_throttle_t *throttle, uint32_t limit)
+{
+	slurm_mutex_lock(&throttle->mutex);
+	while (throttle->cnt >= limit)
+		slurm_cond_wait(&throttle->cond, &throttle->mutex);
+	throttle->cnt++;
+	slurm_mutex_unlock(&throttle->mutex);
+}
+
 
 /* Allocate a named burst buffer record for a specific user.
  * Return a pointer to that record.
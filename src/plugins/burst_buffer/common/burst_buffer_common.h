@@ -59,6 +59,9 @@
 #define DEFAULT_STATE_OUT_TIMEOUT	86400	/* 1 day */
 #define DEFAULT_VALIDATE_TIMEOUT	5	/* 5 seconds */
 
+/* Default limit of concurrent operations (scripts run) of each kind */
+#define DEFAULT_STAGE_PARALLEL		128
+
 /* Burst buffer configuration parameters */
 typedef struct bb_config {
 	uid_t   *allow_users;
@@ -76,8 +79,11 @@ typedef struct bb_config {
 					 * units are GB */
 	uint32_t pool_cnt;		/* Count of records in pool_ptr */
 	burst_buffer_pool_t *pool_ptr;	/* Type is defined in slurm.h */
+	uint32_t other_parallel;		/* Concurrent pre_run/teardown */
 	uint32_t other_timeout;
+	uint32_t stage_in_parallel;	/* Concurrent stage-in */
 	uint32_t stage_in_timeout;
+	uint32_t stage_out_parallel;	/* Concurrent stage-out */
 	uint32_t stage_out_timeout;
 	char    *start_stage_in;
 	char    *start_stage_out;
@@ -86,6 +92,19 @@ typedef struct bb_config {
 	uint32_t validate_timeout;
 } bb_config_t;
 
+/*
+ * Count of burst buffer operations of one kind currently in progress, used to
+ * bound how many scripts run at the same time (see *Parallel in bb_config_t).
+ */
+typedef struct {
+	pthread_cond_t cond;
+	int cnt;
+	pthread_mutex_t mutex;
+} bb_throttle_t;
+
+#define BB_THROTTLE_INITIALIZER \
+	{ PTHREAD_COND_INITIALIZER, 0, PTHREAD_MUTEX_INITIALIZER }
+
 /* Current burst buffer allocations (instances). Some of these will be job
  * specific (job_id != 0) and others persistent */
 #define BB_ALLOC_MAGIC		0xDEAD3448
@@ -376,6 +395,26 @@ extern void bb_set_use_time(bb_state_t *state_ptr);
 /* Sleep function, also handles termination signal */
 extern void bb_sleep(bb_state_t *state_ptr, int add_secs);
 
+/* Return the count of operations in progress for this throttle */
+extern int bb_throttle_cnt(bb_throttle_t *throttle);
+
+/*
+ * Operation complete, release its slot and wake up waiting threads.
+ * RET true if the throttle was full (limit reached) before this call, meaning
+ * that work held back for lack of a slot can be started now.
+ */
+extern bool bb_throttle_fini(bb_throttle_t *throttle, uint32_t limit);
+
+/*
+ * Count a new operation without waiting. The caller is responsible for
+ * checking bb_throttle_cnt() against the limit first, this is used where
+ * operations must be started in a specific (e.g. job priority) order.
+ */
+extern void bb_throttle_incr(bb_throttle_t *throttle);
+
+/* Wait until fewer than limit operations are in progress, then count this one */
+extern void bb_throttle_start(bb_throttle_t *throttle, uint32_t limit);
+
 /* Make claim against resource limit for a user
  * user_id IN - Owner of burst buffer
  * bb_size IN - Size of burst buffer
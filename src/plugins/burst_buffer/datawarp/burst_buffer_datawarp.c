@@ -118,6 +118,17 @@ const uint32_t plugin_version   = SLURM_VERSION_NUMBER;
 /* Most state information is in a common structure so that we can more
  * easily use common functions from multiple burst buffer plugins */
 static bb_state_t	bb_state;
+
+/*
+ * Limit the count of dw_wlm_cli operations running in parallel, per stage, so
+ * that many jobs starting or completing at once don't exhaust process or
+ * file limits. Stage-in is started in job priority order, so its count is
+ * tested before queuing rather than waited on (see bb_p_job_try_stage_in).
+ */
+static bb_throttle_t	pre_run_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t	stage_in_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t	stage_out_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t	teardown_throttle = BB_THROTTLE_INITIALIZER;
 static uint32_t		last_persistent_id = 1;
 
 /* These are defined here so when we link with something other than
@@ -261,12 +272,17 @@ static int	_queue_stage_out(job_record_t *job_ptr, bb_job_t *bb_job);
 static void	_queue_teardown(uint32_t job_id, uint32_t user_id, bool hurry);
 static void	_reset_buf_state(uint32_t user_id, uint32_t job_id, char *name,
 				 int new_state, uint64_t buf_size);
+static void *	_run_pre_run(void *x);
+static void *	_run_stage_in(void *x);
+static void *	_run_stage_out(void *x);
+static void *	_run_teardown(void *x);
 static void	_save_bb_state(void);
 static void	_set_assoc_mgr_ptrs(bb_alloc_t *bb_alloc);
 static void *	_start_pre_run(void *x);
 static void *	_start_stage_in(void *x);
 static void *	_start_stage_out(void *x);
 static void *	_start_teardown(void *x);
+static bool	_stage_in_saturated(void);
 static void	_test_config(void);
 static bool	_test_persistent_use_ready(bb_job_t *bb_job,
 					   job_record_t *job_ptr);
@@ -1313,6 +1329,7 @@ static int _queue_stage_in(job_record_t *job_ptr, bb_job_t *bb_job)
 	stage_args->args1   = setup_argv;
 	stage_args->args2   = data_in_argv;
 
+	bb_throttle_incr(&stage_in_throttle);
 	slurm_thread_create_detached(_start_stage_in, stage_args);
 
 	xfree(hash_dir);
@@ -1321,7 +1338,7 @@ static int _queue_stage_in(job_record_t *job_ptr, bb_job_t *bb_job)
 	return rc;
 }
 
-static void *_start_stage_in(void *x)
+static void *_run_stage_in(void *x)
 {
 	stage_args_t *stage_args = (stage_args_t *) x;
 	char **setup_argv, **size_argv, **data_in_argv;
@@ -1643,7 +1660,7 @@ static int _queue_stage_out(job_record_t *job_ptr, bb_job_t *bb_job)
 	return rc;
 }
 
-static void *_start_stage_out(void *x)
+static void *_run_stage_out(void *x)
 {
 	stage_args_t *stage_args = (stage_args_t *)x;
 	char **post_run_argv, **data_out_argv, *resp_msg = NULL, *op = NULL;
@@ -1893,7 +1910,7 @@ static void _queue_teardown(uint32_t job_id, uint32_t user_id, bool hurry)
 	xfree(job_script);
 }
 
-static void *_start_teardown(void *x)
+static void *_run_teardown(void *x)
 {
 	static uint32_t previous_job_id = 0;
 	stage_args_t *teardown_args = (stage_args_t *)x;
@@ -3348,6 +3365,59 @@ extern time_t bb_p_job_get_est_start(job_record_t *job_ptr)
 /*
  * Attempt to allocate resources and begin file staging for pending jobs.
  */
+static bool _stage_in_saturated(void)
+{
+	return (bb_throttle_cnt(&stage_in_throttle) >=
+		bb_state.bb_config.stage_in_parallel);
+}
+
+static void *_start_stage_in(void *x)
+{
+	(void) _run_stage_in(x);
+
+	/*
+	 * If stage-in was saturated, pending jobs were held back waiting for
+	 * this slot. Wake up the scheduler so that the next job in priority
+	 * order starts its stage-in now rather than at the next periodic pass.
+	 */
+	if (bb_throttle_fini(&stage_in_throttle,
+			     bb_state.bb_config.stage_in_parallel))
+		queue_job_scheduler();
+
+	return NULL;
+}
+
+static void *_start_stage_out(void *x)
+{
+	bb_throttle_start(&stage_out_throttle,
+			  bb_state.bb_config.stage_out_parallel);
+	(void) _run_stage_out(x);
+	(void) bb_throttle_fini(&stage_out_throttle,
+				bb_state.bb_config.stage_out_parallel);
+
+	return NULL;
+}
+
+static void *_start_teardown(void *x)
+{
+	bb_throttle_start(&teardown_throttle, bb_state.bb_config.other_parallel);
+	(void) _run_teardown(x);
+	(void) bb_throttle_fini(&teardown_throttle,
+				bb_state.bb_config.other_parallel);
+
+	return NULL;
+}
+
+static void *_start_pre_run(void *x)
+{
+	bb_throttle_start(&pre_run_throttle, bb_state.bb_config.other_parallel);
+	(void) _run_pre_run(x);
+	(void) bb_throttle_fini(&pre_run_throttle,
+				bb_state.bb_config.other_parallel);
+
+	return NULL;
+}
+
 extern int bb_p_job_try_stage_in(List job_queue)
 {
 	bb_job_queue_rec_t *job_rec;
@@ -3403,6 +3473,8 @@ extern int bb_p_job_try_stage_in(List job_queue)
 		bb_job = job_rec->bb_job;
 		if (bb_job->state >= BB_STATE_STAGING_IN)
 			continue;	/* Job was already allocated a buffer */
+		if (_stage_in_saturated())
+			break;		/* Resume once a stage-in completes */
 
 		rc = bb_test_size_limit(job_ptr, bb_job, &bb_state,
 					_queue_teardown);
@@ -3456,7 +3528,7 @@ extern int bb_p_job_test_stage_in(job_record_t *job_ptr, bool test_only)
 	} else if (bb_job->state < BB_STATE_STAGING_IN) {
 		/* Job buffer not allocated, create now if space available */
 		rc = -1;
-		if ((test_only == false) &&
+		if ((test_only == false) && !_stage_in_saturated() &&
 		    (bb_test_size_limit(job_ptr, bb_job, &bb_state,
 					_queue_teardown) == 0) &&
 		    (_alloc_job_bb(job_ptr, bb_job, false) == SLURM_SUCCESS)) {
@@ -3663,7 +3735,7 @@ static void _kill_job(job_record_t *job_ptr, bool hold_job)
 	deallocate_nodes(job_ptr, false, false, false);
 }
 
-static void *_start_pre_run(void *x)
+static void *_run_pre_run(void *x)
 {
 	/* Locks: read job */
 	slurmctld_lock_t job_read_lock = {
@@ -69,16 +69,6 @@
 #define DEFAULT_DIRECTIVE_STR "BB_LUA"
 /* Hold job if pre_run fails more times than MAX_RETRY_CNT */
 #define MAX_RETRY_CNT 2
-/*
- * Limit the number of burst buffers APIs allowed to run in parallel so that we
- * don't exceed process or system resource limits (such as number of processes
- * or max open files) when we run scripts through slurmscriptd. We limit this
- * per "stage" (stage in, pre run, stage out, teardown) so that if we hit the
- * maximum in stage in (for example) we won't block all jobs from completing.
- * We also do this so that if 1000+ jobs complete or get cancelled all at
- * once they won't all run teardown at the same time.
- */
-#define MAX_BURST_BUFFERS_PER_STAGE 128
 
 /*
  * These variables are required by the burst buffer plugin interface.  If they
@@ -203,55 +193,45 @@ static int lua_thread_cnt = 0;
 pthread_mutex_t lua_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /*
- * Count of burst buffer API calls in each stage.
- * These variables are protected by stage_cnt_mutex.
+ * Idle Lua states with the script already loaded. Calls take a state from
+ * here (or create one) and give it back when done, so concurrent calls each
+ * get their own state without loading the script on every call.
  */
-#define DEF_STAGE_THROTTLE \
-	static pthread_mutex_t stage_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;\
-	static pthread_cond_t stage_cnt_cond = PTHREAD_COND_INITIALIZER;\
-	static int stage_cnt = 0;
+#define MAX_IDLE_LUA_STATES 16
+typedef struct {
+	lua_State *L;
+	time_t load_time;
+} lua_pool_state_t;
+
+static List lua_state_pool = NULL;
+static pthread_mutex_t lua_state_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /*
- * stage throttle doesn't guarantee the order each thread will start. For
+ * Limit the number of burst buffers APIs allowed to run in parallel so that we
+ * don't exceed process or system resource limits (such as number of processes
+ * or max open files) when we run scripts through slurmscriptd. We limit this
+ * per "stage" (stage in, pre run, stage out, teardown) so that if we hit the
+ * maximum in stage in (for example) we won't block all jobs from completing.
+ * We also do this so that if 1000+ jobs complete or get cancelled all at
+ * once they won't all run teardown at the same time. The limits are
+ * StageInParallel, StageOutParallel and OtherParallel in burst_buffer.conf.
+ *
+ * The throttle doesn't guarantee the order each thread will start. For
  * stage_in we need to run burst_buffer.lua in job priority order so that
  * highest priority jobs can start as soon as possible. With this we only queue
- * up to MAX_BURST_BUFFERS_PER_STAGE _start_stage_in threads at once, so we
- * don't use stage throttle for stage_in.
- * This variable is protected by bb_state.bb_mutex.
+ * up to StageInParallel _start_stage_in threads at once, so we don't wait on
+ * stage_in_throttle but test its count before queuing.
  */
-static pthread_mutex_t stage_in_mutex = PTHREAD_MUTEX_INITIALIZER;
-static int stage_in_cnt = 0;
+static bb_throttle_t pre_run_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t stage_in_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t stage_out_throttle = BB_THROTTLE_INITIALIZER;
+static bb_throttle_t teardown_throttle = BB_THROTTLE_INITIALIZER;
 
 /* Function prototypes */
 static bb_job_t *_get_bb_job(job_record_t *job_ptr);
 static void _queue_teardown(uint32_t job_id, uint32_t user_id, bool hurry,
 			    uint32_t group_id);
 
-static int _get_stage_in_cnt(void)
-{
-	int cnt;
-
-	slurm_mutex_lock(&stage_in_mutex);
-	cnt = stage_in_cnt;
-	slurm_mutex_unlock(&stage_in_mutex);
-
-	return cnt;
-}
-
-static void _incr_stage_in_cnt(void)
-{
-	slurm_mutex_lock(&stage_in_mutex);
-	stage_in_cnt++;
-	slurm_mutex_unlock(&stage_in_mutex);
-}
-
-static void _decr_stage_in_cnt(void)
-{
-	slurm_mutex_lock(&stage_in_mutex);
-	stage_in_cnt--;
-	slurm_mutex_unlock(&stage_in_mutex);
-}
-
 static int _get_lua_thread_cnt(void)
 {
 	int cnt;
@@ -277,29 +257,6 @@ static void _decr_lua_thread_cnt(void)
 	slurm_mutex_unlock(&lua_thread_mutex);
 }
 
-static void _stage_throttle_start(pthread_mutex_t *mutex, pthread_cond_t *cond,
-				  int *cnt)
-{
-	slurm_mutex_lock(mutex);
-	while (1) {
-		if (*cnt < MAX_BURST_BUFFERS_PER_STAGE) {
-			*cnt = *cnt + 1;
-			break;
-		}
-		slurm_cond_wait(cond, mutex);
-	}
-	slurm_mutex_unlock(mutex);
-}
-
-static void _stage_throttle_fini(pthread_mutex_t *mutex, pthread_cond_t *cond,
-				 int *cnt)
-{
-	slurm_mutex_lock(mutex);
-	*cnt = *cnt - 1;
-	slurm_cond_broadcast(cond);
-	slurm_mutex_unlock(mutex);
-}
-
 static int _job_info_to_string(lua_State *L)
 {
 	job_info_t *job_info;
@@ -859,31 +816,73 @@ static int _handle_lua_return(lua_State *L, const char *lua_func,
 	return rc;
 }
 
+static void _lua_pool_state_free(void *x)
+{
+	lua_pool_state_t *state = x;
+
+	if (!state)
+		return;
+	if (state->L)
+		lua_close(state->L);
+	xfree(state);
+}
+
+static lua_pool_state_t *_lua_state_get(void)
+{
+	lua_pool_state_t *state = NULL;
+
+	slurm_mutex_lock(&lua_state_pool_mutex);
+	if (lua_state_pool)
+		state = list_pop(lua_state_pool);
+	slurm_mutex_unlock(&lua_state_pool_mutex);
+
+	if (!state)
+		state = xmalloc(sizeof(*state));
+
+	return state;
+}
+
+static void _lua_state_put(lua_pool_state_t *state)
+{
+	if (state->L) {
+		/* Drop anything a failed call left on the stack */
+		lua_settop(state->L, 0);
+		slurm_mutex_lock(&lua_state_pool_mutex);
+		if (lua_state_pool &&
+		    (list_count(lua_state_pool) < MAX_IDLE_LUA_STATES)) {
+			list_push(lua_state_pool, state);
+			state = NULL;
+		}
+		slurm_mutex_unlock(&lua_state_pool_mutex);
+	}
+
+	_lua_pool_state_free(state);
+}
+
 static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 			     char **argv, job_info_msg_t *job_info,
 			     char **resp_msg)
 {
 	/*
-	 * We don't make lua_State L or lua_script_last_loaded static.
-	 * If they were static, then only 1 thread could use them at a time.
-	 * This would be problematic for performance since these
-	 * calls can possibly last a long time. By not making them static it
-	 * means we can let these calls run in parallel, but it also means
-	 * we don't preserve the previous script. Therefore, we have to
-	 * reload the script every time even if the script hasn't changed.
-	 * Also, if there is ever a problem loading the script then we can't
-	 * fall back to the old script.
+	 * Each call needs a lua_State of its own so that calls, which can
+	 * last a long time, run in parallel. Take one from the pool of idle
+	 * states; slurm_lua_loadscript() only reloads the script if it
+	 * changed since that state loaded it, and keeps the previous script
+	 * if the new one fails to load.
 	 */
-	lua_State *L = NULL;
-	time_t lua_script_last_loaded = (time_t) 0;
+	lua_pool_state_t *state = _lua_state_get();
+	lua_State *L;
 	int rc, i;
 
-	rc = slurm_lua_loadscript(&L, "burst_buffer/lua",
+	rc = slurm_lua_loadscript(&state->L, "burst_buffer/lua",
 				  lua_script_path, req_fxns,
-				  &lua_script_last_loaded, _loadscript_extra);
+				  &state->load_time, _loadscript_extra);
 
-	if (rc != SLURM_SUCCESS)
+	if (rc != SLURM_SUCCESS) {
+		_lua_state_put(state);
 		return rc;
+	}
+	L = state->L;
 
 	/*
 	 * All lua script functions should have been verified during
@@ -893,7 +892,7 @@ static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 	if (lua_isnil(L, -1)) {
 		error("%s: Couldn't find function %s",
 		      __func__, func);
-		lua_close(L);
+		_lua_state_put(state);
 		return SLURM_ERROR;
 	}
 
@@ -917,7 +916,7 @@ static int _start_lua_script(char *func, uint32_t job_id, uint32_t argc,
 		rc = _handle_lua_return(L, func, job_id, resp_msg);
 	}
 	slurm_lua_stack_dump("burst_buffer/lua", "after lua_pcall, after returns have been popped", L);
-	lua_close(L);
+	_lua_state_put(state);
 
 	return rc;
 }
@@ -1565,8 +1564,9 @@ static void *_start_stage_out(void *x)
 	bb_job_t *bb_job = NULL;
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+
+	bb_throttle_start(&stage_out_throttle,
+			  bb_state.bb_config.stage_out_parallel);
 
 	argc = 4;
 	argv = xcalloc(argc + 1, sizeof(char *)); /* NULL-terminated */
@@ -1705,7 +1705,8 @@ static void *_start_stage_out(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	(void) bb_throttle_fini(&stage_out_throttle,
+				bb_state.bb_config.stage_out_parallel);
 	xfree(resp_msg);
 	xfree(stage_out_args->job_script);
 	xfree(stage_out_args);
@@ -2184,6 +2185,7 @@ extern int init(void)
         if ((rc = slurm_lua_init()) != SLURM_SUCCESS)
                 return rc;
 	lua_script_path = get_extra_conf_path("burst_buffer.lua");
+	lua_state_pool = list_create(_lua_pool_state_free);
 
 	if ((rc = serializer_g_init(MIME_TYPE_JSON_PLUGIN, NULL))) {
 		error("%s: unable to load JSON serializer: %s",
@@ -2252,6 +2254,10 @@ extern int fini(void)
 
 	slurm_mutex_destroy(&lua_thread_mutex);
 
+	slurm_mutex_lock(&lua_state_pool_mutex);
+	FREE_NULL_LIST(lua_state_pool);
+	slurm_mutex_unlock(&lua_state_pool_mutex);
+
 	slurm_lua_fini();
 	xfree(lua_script_path);
 
@@ -2995,8 +3001,8 @@ static void *_start_teardown(void *x)
 		NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+
+	bb_throttle_start(&teardown_throttle, bb_state.bb_config.other_parallel);
 
 	argc = 5;
 	argv = xcalloc(argc + 1, sizeof(char *)); /* NULL-terminated */
@@ -3116,7 +3122,8 @@ static void *_start_teardown(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	(void) bb_throttle_fini(&teardown_throttle,
+				bb_state.bb_config.other_parallel);
 	xfree(resp_msg);
 	xfree(teardown_args->job_script);
 	xfree(teardown_args);
@@ -3403,7 +3410,14 @@ static void *_start_stage_in(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_decr_stage_in_cnt();
+	/*
+	 * If stage-in was saturated, pending jobs were held back waiting for
+	 * this slot. Wake up the scheduler so that the next job in priority
+	 * order starts its stage-in now rather than at the next periodic pass.
+	 */
+	if (bb_throttle_fini(&stage_in_throttle,
+			     bb_state.bb_config.stage_in_parallel))
+		queue_job_scheduler();
 	xfree(resp_msg);
 	xfree(stage_in_args->job_script);
 	xfree(stage_in_args->pool);
@@ -3452,7 +3466,7 @@ static int _queue_stage_in(job_record_t *job_ptr, bb_job_t *bb_job)
 	bb_limit_add(job_ptr->user_id, bb_job->total_size, bb_job->job_pool,
 		     &bb_state, true);
 
-	_incr_stage_in_cnt();
+	bb_throttle_incr(&stage_in_throttle);
 	slurm_thread_create_detached(_start_stage_in, stage_in_args);
 
 	xfree(hash_dir);
@@ -3485,7 +3499,8 @@ static int _try_alloc_job_bb(void *x, void *arg)
 	else
 		rc = 0;
 
-	if (_get_stage_in_cnt() >= MAX_BURST_BUFFERS_PER_STAGE)
+	if (bb_throttle_cnt(&stage_in_throttle) >=
+	    bb_state.bb_config.stage_in_parallel)
 		return SLURM_ERROR; /* Break out of loop */
 
 	if (rc == 0) {
@@ -3570,7 +3585,8 @@ extern int bb_p_job_test_stage_in(job_record_t *job_ptr, bool test_only)
 	} else if (bb_job->state < BB_STATE_STAGING_IN) {
 		/* Job buffer not allocated, create now if space available */
 		rc = -1;
-		if (stage_in_cnt >= MAX_BURST_BUFFERS_PER_STAGE)
+		if (bb_throttle_cnt(&stage_in_throttle) >=
+		    bb_state.bb_config.stage_in_parallel)
 			goto fini;
 		if (test_only)
 			goto fini;
@@ -3712,8 +3728,8 @@ static void *_start_pre_run(void *x)
 	pre_run_args_t *pre_run_args = (pre_run_args_t *) x;
 	run_lua_args_t run_lua_args;
 	DEF_TIMERS;
-	DEF_STAGE_THROTTLE;
-	_stage_throttle_start(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+
+	bb_throttle_start(&pre_run_throttle, bb_state.bb_config.other_parallel);
 
 	argc = 4;
 	argv = xcalloc(argc + 1, sizeof (char *)); /* NULL-terminated */
@@ -3808,7 +3824,8 @@ static void *_start_pre_run(void *x)
 	unlock_slurmctld(job_write_lock);
 
 fini:
-	_stage_throttle_fini(&stage_cnt_mutex, &stage_cnt_cond, &stage_cnt);
+	(void) bb_throttle_fini(&pre_run_throttle,
+				bb_state.bb_config.other_parallel);
 	xfree(resp_msg);
 	xfree(pre_run_args->job_script);
 	xfree(pre_run_args);
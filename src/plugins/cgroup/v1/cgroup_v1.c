@@ -1490,6 +1490,16 @@ extern cgroup_acct_t *cgroup_p_task_get_acct_data(uint32_t taskid)
 	return stats;
 }
 
+extern int cgroup_p_signal(int signal)
+{
+	return ESLURM_NOT_SUPPORTED;
+}
+
+extern int cgroup_p_step_wait_empty(int timeout_ms)
+{
+	return ESLURM_NOT_SUPPORTED;
+}
+
 /* cgroup/v1 usec and ssec are provided in USER_HZ. */
 extern long int cgroup_p_get_acct_units(void)
 {
@@ -36,13 +36,16 @@
 
 #define _GNU_SOURCE
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/inotify.h>
 #include <poll.h>
+#include <signal.h>
 #include <unistd.h>
 
 #include "slurm/slurm.h"
@@ -51,6 +54,7 @@
 #include "src/common/bitstring.h"
 #include "src/common/list.h"
 #include "src/common/log.h"
+#include "src/common/timers.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -539,14 +543,13 @@ static int _find_pid_task(void *x, void *key)
 	return found;
 }
 
-static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+/* Return the "populated" value of cgroup.events, or -1 on error */
+static int _get_cg_populated(xcgroup_t *cg)
 {
-	char *cgroup_events = NULL, *events_content = NULL, *ptr;
-	int rc, fd, wd, populated = -1;
+	char *events_content = NULL, *ptr;
+	int populated = -1;
 	size_t sz;
-	struct pollfd pfd[1];
 
-	/* Check if cgroup is empty in the first place. */
 	if (common_cgroup_get_param(
 		    cg, "cgroup.events", &events_content, &sz) != SLURM_SUCCESS)
 		error("Cannot read %s/cgroup.events", cg->path);
@@ -559,68 +562,90 @@ static void _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
 		xfree(events_content);
 	}
 
-	if (populated < 0) {
+	if (populated < 0)
 		error("Cannot determine if %s is empty.", cg->path);
-		return;
-	} else if (populated == 0) //We're done
-		return;
+
+	return populated;
+}
+
+/*
+ * Wait up to timeout_ms for cg and its descendants to have no processes.
+ * Return the last "populated" value read: 0 if the cgroup became empty, 1 if
+ * it still has processes, or -1 if it could not be waited for.
+ */
+static int _wait_cgroup_empty(xcgroup_t *cg, int timeout_ms)
+{
+	char *cgroup_events = NULL;
+	char buf[sizeof(struct inotify_event) + NAME_MAX + 1];
+	int rc, fd, wd, populated;
+	struct pollfd pfd[1];
+	struct timeval tv = { 0 };
+
+	/* Check if cgroup is empty in the first place. */
+	if ((populated = _get_cg_populated(cg)) <= 0)
+		return populated;
 
 	/*
 	 * Cgroup is not empty, so wait for a while just monitoring any change
 	 * on cgroup.events. Changing populate from 1 to 0 is what we expect.
+	 * The file is read again once the watch is set, so that a change
+	 * right before it can't be missed. Other changes to the file (e.g.
+	 * "frozen") wake us too, so keep waiting for the rest of the timeout.
 	 */
 
 	xstrfmtcat(cgroup_events, "%s/cgroup.events", cg->path);
 
 	/* Initialize an inotify monitor */
-	fd = inotify_init();
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 	if (fd < 0) {
 		error("Cannot initialize inotify for checking cgroup events: %m");
-		return;
+		xfree(cgroup_events);
+		return -1;
 	}
 
 	/* Set the file and events we want to monitor. */
 	wd = inotify_add_watch(fd, cgroup_events, IN_MODIFY);
 	if (wd < 0) {
 		error("Cannot add watch events to %s: %m", cgroup_events);
+		populated = -1;
 		goto end_inotify;
 	}
 
-	/* Wait for new events. */
-	pfd[0].fd = fd;
-	pfd[0].events = POLLIN;
-	rc = poll(pfd, 1, timeout_ms);
+	(void) slurm_delta_tv(&tv);
+	while ((populated = _get_cg_populated(cg)) == 1) {
+		int wait_ms = timeout_ms - (slurm_delta_tv(&tv) / 1000);
 
-	/*
-	 * We don't really care about the event details, just check now if the
-	 * cg event file contains what we're looking for.
-	 */
-	if (rc < 0)
-		error("Error polling for event in %s: %m", cgroup_events);
-	else if (rc == 0)
-		error("Timeout waiting for %s to become empty.", cgroup_events);
-
-	/* Check if cgroup is empty again. */
-	if (common_cgroup_get_param(cg, "cgroup.events",
-				    &events_content, &sz) != SLURM_SUCCESS)
-		error("Cannot read %s/cgroup.events", cg->path);
+		if (wait_ms <= 0)
+			break;
 
-	if (events_content) {
-		if ((ptr = xstrstr(events_content, "populated"))) {
-			if (sscanf(ptr, "populated %u", &populated) != 1)
-				error("Cannot read populated counter from cgroup.events file.");
+		/* Wait for new events. */
+		pfd[0].fd = fd;
+		pfd[0].events = POLLIN;
+		rc = poll(pfd, 1, wait_ms);
+
+		if ((rc < 0) && (errno != EINTR)) {
+			error("Error polling for event in %s: %m",
+			      cgroup_events);
+			break;
 		}
-		xfree(events_content);
+
+		/*
+		 * We don't really care about the event details, just drain
+		 * them and check if the cg event file contains what we're
+		 * looking for.
+		 */
+		while (read(fd, buf, sizeof(buf)) > 0)
+			;
 	}
 
-	if (populated < 0)
-		error("Cannot determine if %s is empty.", cg->path);
-	else if (populated == 1)
+	if (populated == 1)
 		log_flag(CGROUP, "Cgroup %s is not empty.", cg->path);
 
 end_inotify:
 	close(fd);
 	xfree(cgroup_events);
+
+	return populated;
 }
 
 static int _init_stepd_system_scope(pid_t pid)
@@ -1387,6 +1412,37 @@ extern int cgroup_p_step_resume(void)
 				       "cgroup.freeze", "0");
 }
 
+/* Kill all the user processes of this step at once through cgroup.kill */
+extern int cgroup_p_signal(int signal)
+{
+	if (signal != SIGKILL)
+		return ESLURM_NOT_SUPPORTED;
+
+	/* This plugin is unloaded. */
+	if (!int_cg[CG_LEVEL_STEP_USER].path)
+		return SLURM_SUCCESS;
+
+	return common_cgroup_set_param(&int_cg[CG_LEVEL_STEP_USER],
+				       "cgroup.kill", "1");
+}
+
+/* Wait on cgroup.events until the user processes of this step are gone */
+extern int cgroup_p_step_wait_empty(int timeout_ms)
+{
+	/* This plugin is unloaded. */
+	if (!int_cg[CG_LEVEL_STEP_USER].path)
+		return SLURM_SUCCESS;
+
+	switch (_wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_USER], timeout_ms)) {
+	case 0:
+		return SLURM_SUCCESS;
+	case 1:
+		return SLURM_ERROR;
+	default:
+		return ESLURM_NOT_SUPPORTED;
+	}
+}
+
 /*
  * Destroy the step cgroup. We need to move out ourselves to the root of
  * the cgroup filesystem first.
@@ -1439,7 +1495,9 @@ extern int cgroup_p_step_destroy(cgroup_ctl_type_t ctl)
 		goto end;
 	}
 	/* Wait for this cgroup to be empty, 1 second */
-	_wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_SLURM], 1000);
+	if (_wait_cgroup_empty(&int_cg[CG_LEVEL_STEP_SLURM], 1000) == 1)
+		error("Timeout waiting for %s to become empty.",
+		      int_cg[CG_LEVEL_STEP_SLURM].path);
 
 	/* Remove any possible task directories first */
 	_all_tasks_destroy();
@@ -2138,6 +2196,22 @@ extern bool cgroup_p_has_feature(cgroup_ctl_feature_t f)
 		rc = stat(memsw_filepath, &st);
 		xfree(memsw_filepath);
 		return (rc == 0);
+	case CG_KILL_BUTTON:
+	{
+		static int kill_button = -1;
+		char *kill_filepath = NULL;
+
+		/* cgroup.kill exists in every non-root cgroup since 5.14 */
+		if (kill_button == -1) {
+			xstrfmtcat(kill_filepath, "%s/cgroup.kill",
+				   int_cg[CG_LEVEL_STEP_USER].path ?
+				   int_cg[CG_LEVEL_STEP_USER].path :
+				   int_cg[CG_LEVEL_ROOT].path);
+			kill_button = !stat(kill_filepath, &st);
+			xfree(kill_filepath);
+		}
+		return kill_button;
+	}
 	default:
 		break;
 	}
@@ -5225,6 +5225,34 @@ static const parser_t PARSER_ARRAY(STATS_MSG)[] = {
 	add_skip(rpc_dump_count), /* TODO: implement */
 	add_skip(rpc_dump_types), /* TODO: implement */
 	add_skip(rpc_dump_hostlist), /* TODO: implement */
+	add_skip(lock_stats_count), /* TODO: implement */
+	add_skip(lock_stats_name),
+	add_skip(lock_stats_acquired),
+	add_skip(lock_stats_wait_time),
+	add_skip(lock_stats_wait_max),
+	add_skip(lock_stats_hold_time),
+	add_skip(lock_stats_hold_max),
+	add_skip(lock_stats_hist_count),
+	add_skip(lock_stats_wait_hist),
+	add_skip(lock_stats_hold_hist),
+	add_skip(rpcq_count), /* TODO: implement */
+	add_skip(rpcq_type),
+	add_skip(rpcq_depth_limit),
+	add_skip(rpcq_depth),
+	add_skip(rpcq_rejected),
+	add_skip(rpc_cost_type_size),
+	add_skip(rpc_cost_type_id),
+	add_skip(rpc_cost_type_cpu_time),
+	add_skip(rpc_cost_type_lock_wait),
+	add_skip(rpc_cost_type_bytes),
+	add_skip(rpc_cost_user_size),
+	add_skip(rpc_cost_user_id),
+	add_skip(rpc_cost_user_cpu_time),
+	add_skip(rpc_cost_user_lock_wait),
+	add_skip(rpc_cost_user_bytes),
+	add_skip(schedule_adapt_interval), /* TODO: implement */
+	add_skip(schedule_adapt_depth),
+	add_skip(schedule_adapt_pressure),
 };
 #undef add_parse
 #undef add_cparse
@@ -6591,8 +6619,25 @@ extern void get_parsers(const parser_t **parsers_ptr, int *count_ptr)
 	*parsers_ptr = parsers;
 }
 
+/*
+ * Direct lookup of parsers by type, populated once by parsers_init(). Every
+ * caller must have called data_parser_p_new() which calls parsers_init() and
+ * takes parsers_lock after the table is populated.
+ */
+static const parser_t *parsers_by_type[DATA_PARSER_TYPE_MAX] = { 0 };
+static bool parsers_by_type_init = false;
+static pthread_mutex_t parsers_lock = PTHREAD_MUTEX_INITIALIZER;
+
 extern const parser_t *const find_parser_by_type(type_t type)
 {
+	if (parsers_by_type_init) {
+		if ((type > DATA_PARSER_TYPE_INVALID) &&
+		    (type < DATA_PARSER_TYPE_MAX))
+			return parsers_by_type[type];
+
+		return NULL;
+	}
+
 	for (int i = 0; i < ARRAY_SIZE(parsers); i++)
 		if (parsers[i].type == type)
 			return &parsers[i];
@@ -6602,11 +6647,24 @@ extern const parser_t *const find_parser_by_type(type_t type)
 
 extern void parsers_init(void)
 {
+	slurm_mutex_lock(&parsers_lock);
+	if (!parsers_by_type_init) {
+		/* walk in reverse to match first parser like linear search */
+		for (int i = ARRAY_SIZE(parsers) - 1; i >= 0; i--) {
+			xassert(parsers[i].type > DATA_PARSER_TYPE_INVALID);
+			xassert(parsers[i].type < DATA_PARSER_TYPE_MAX);
+			parsers_by_type[parsers[i].type] = &parsers[i];
+		}
+
 #ifndef NDEBUG
-	/* sanity check the parsers */
-	for (int i = 0; i < ARRAY_SIZE(parsers); i++)
-		check_parser(&parsers[i]);
+		/* sanity check the parsers */
+		for (int i = 0; i < ARRAY_SIZE(parsers); i++)
+			check_parser(&parsers[i]);
 #endif /* !NDEBUG */
+
+		parsers_by_type_init = true;
+	}
+	slurm_mutex_unlock(&parsers_lock);
 }
 
 #ifndef NDEBUG
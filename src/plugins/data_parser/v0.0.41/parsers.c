@@ -414,6 +414,9 @@ typedef struct {
 	uint32_t count;
 	uint64_t time;
 	uint64_t average_time;
+	uint64_t cpu_time;
+	uint64_t lock_wait;
+	uint64_t bytes_sent;
 } STATS_MSG_RPC_TYPE_t;
 
 typedef struct {
@@ -421,6 +424,9 @@ typedef struct {
 	uint32_t count;
 	uint64_t time;
 	uint64_t average_time;
+	uint64_t cpu_time;
+	uint64_t lock_wait;
+	uint64_t bytes_sent;
 } STATS_MSG_RPC_USER_t;
 
 typedef struct {
@@ -3028,6 +3034,15 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_TYPE)(const parser_t *const parser,
 			rpc.average_time = stats->rpc_type_time[i] /
 				stats->rpc_type_cnt[i];
 
+		for (int j = 0; j < stats->rpc_cost_type_size; j++) {
+			if (stats->rpc_cost_type_id[j] != rpc.id)
+				continue;
+			rpc.cpu_time = stats->rpc_cost_type_cpu_time[j];
+			rpc.lock_wait = stats->rpc_cost_type_lock_wait[j];
+			rpc.bytes_sent = stats->rpc_cost_type_bytes[j];
+			break;
+		}
+
 		rc = DUMP(STATS_MSG_RPC_TYPE, rpc, data_list_append(dst), args);
 	}
 
@@ -3061,6 +3076,15 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_USER)(const parser_t *const parser,
 			rpc.average_time = stats->rpc_user_time[i] /
 				stats->rpc_user_cnt[i];
 
+		for (int j = 0; j < stats->rpc_cost_user_size; j++) {
+			if (stats->rpc_cost_user_id[j] != rpc.id)
+				continue;
+			rpc.cpu_time = stats->rpc_cost_user_cpu_time[j];
+			rpc.lock_wait = stats->rpc_cost_user_lock_wait[j];
+			rpc.bytes_sent = stats->rpc_cost_user_bytes[j];
+			break;
+		}
+
 		rc = DUMP(STATS_MSG_RPC_USER, rpc, data_list_append(dst), args);
 	}
 
@@ -6822,6 +6846,34 @@ static const parser_t PARSER_ARRAY(STATS_MSG)[] = {
 	add_skip(rpc_dump_count), /* handled by STATS_MSG_RPCS_DUMP */
 	add_skip(rpc_dump_types), /* handled by STATS_MSG_RPCS_DUMP */
 	add_skip(rpc_dump_hostlist), /* handled by STATS_MSG_RPCS_DUMP */
+	add_skip(lock_stats_count), /* TODO: implement */
+	add_skip(lock_stats_name),
+	add_skip(lock_stats_acquired),
+	add_skip(lock_stats_wait_time),
+	add_skip(lock_stats_wait_max),
+	add_skip(lock_stats_hold_time),
+	add_skip(lock_stats_hold_max),
+	add_skip(lock_stats_hist_count),
+	add_skip(lock_stats_wait_hist),
+	add_skip(lock_stats_hold_hist),
+	add_skip(rpcq_count), /* TODO: implement */
+	add_skip(rpcq_type),
+	add_skip(rpcq_depth_limit),
+	add_skip(rpcq_depth),
+	add_skip(rpcq_rejected),
+	add_skip(rpc_cost_type_size), /* handled by STATS_MSG_RPCS_BY_TYPE */
+	add_skip(rpc_cost_type_id),
+	add_skip(rpc_cost_type_cpu_time),
+	add_skip(rpc_cost_type_lock_wait),
+	add_skip(rpc_cost_type_bytes),
+	add_skip(rpc_cost_user_size), /* handled by STATS_MSG_RPCS_BY_USER */
+	add_skip(rpc_cost_user_id),
+	add_skip(rpc_cost_user_cpu_time),
+	add_skip(rpc_cost_user_lock_wait),
+	add_skip(rpc_cost_user_bytes),
+	add_skip(schedule_adapt_interval), /* TODO: implement */
+	add_skip(schedule_adapt_depth),
+	add_skip(schedule_adapt_pressure),
 };
 #undef add_parse
 #undef add_cparse
@@ -8595,6 +8647,9 @@ static const parser_t PARSER_ARRAY(STATS_MSG_RPC_TYPE)[] = {
 	add_parse_req(UINT32, count, "count", "Number of RPCs received"),
 	add_parse_req(UINT64, time, "total_time", "Total time spent processing RPC in seconds"),
 	add_parse_req(UINT64_NO_VAL, average_time, "average_time", "Average time spent processing RPC in seconds"),
+	add_parse_req(UINT64, cpu_time, "cpu_time", "Total CPU time used processing RPC in microseconds"),
+	add_parse_req(UINT64, lock_wait, "lock_wait_time", "Total time spent waiting for slurmctld locks in microseconds"),
+	add_parse_req(UINT64, bytes_sent, "bytes_sent", "Total size of RPC replies in bytes"),
 };
 #undef add_parse_req
 #undef add_parse_req_overload
@@ -8609,6 +8664,9 @@ static const parser_t PARSER_ARRAY(STATS_MSG_RPC_USER)[] = {
 	add_parse_req(UINT32, count, "count", "Number of RPCs received"),
 	add_parse_req(UINT64, time, "total_time", "Total time spent processing RPC in seconds"),
 	add_parse_req(UINT64_NO_VAL, average_time, "average_time", "Average time spent processing RPC in seconds"),
+	add_parse_req(UINT64, cpu_time, "cpu_time", "Total CPU time used processing RPC in microseconds"),
+	add_parse_req(UINT64, lock_wait, "lock_wait_time", "Total time spent waiting for slurmctld locks in microseconds"),
+	add_parse_req(UINT64, bytes_sent, "bytes_sent", "Total size of RPC replies in bytes"),
 };
 #undef add_parse_req
 #undef add_parse_req_overload
@@ -9472,8 +9530,25 @@ extern void get_parsers(const parser_t **parsers_ptr, int *count_ptr)
 	*parsers_ptr = parsers;
 }
 
+/*
+ * Direct lookup of parsers by type, populated once by parsers_init(). Every
+ * caller must have called data_parser_p_new() which calls parsers_init() and
+ * takes parsers_lock after the table is populated.
+ */
+static const parser_t *parsers_by_type[DATA_PARSER_TYPE_MAX] = { 0 };
+static bool parsers_by_type_init = false;
+static pthread_mutex_t parsers_lock = PTHREAD_MUTEX_INITIALIZER;
+
 extern const parser_t *const find_parser_by_type(type_t type)
 {
+	if (parsers_by_type_init) {
+		if ((type > DATA_PARSER_TYPE_INVALID) &&
+		    (type < DATA_PARSER_TYPE_MAX))
+			return parsers_by_type[type];
+
+		return NULL;
+	}
+
 	for (int i = 0; i < ARRAY_SIZE(parsers); i++)
 		if (parsers[i].type == type)
 			return &parsers[i];
@@ -9483,11 +9558,24 @@ extern const parser_t *const find_parser_by_type(type_t type)
 
 extern void parsers_init(void)
 {
+	slurm_mutex_lock(&parsers_lock);
+	if (!parsers_by_type_init) {
+		/* walk in reverse to match first parser like linear search */
+		for (int i = ARRAY_SIZE(parsers) - 1; i >= 0; i--) {
+			xassert(parsers[i].type > DATA_PARSER_TYPE_INVALID);
+			xassert(parsers[i].type < DATA_PARSER_TYPE_MAX);
+			parsers_by_type[parsers[i].type] = &parsers[i];
+		}
+
 #ifndef NDEBUG
-	/* sanity check the parsers */
-	for (int i = 0; i < ARRAY_SIZE(parsers); i++)
-		check_parser(&parsers[i]);
+		/* sanity check the parsers */
+		for (int i = 0; i < ARRAY_SIZE(parsers); i++)
+			check_parser(&parsers[i]);
 #endif /* !NDEBUG */
+
+		parsers_by_type_init = true;
+	}
+	slurm_mutex_unlock(&parsers_lock);
 }
 
 #ifndef NDEBUG
@@ -108,6 +108,20 @@ static int gpumem_pos = -1;
 static int gpuutil_pos = -1;
 static pid_t init_pid = 0;
 
+/* Per device usage, sampled once for all processes of the step */
+typedef struct {
+	nvmlProcessInfo_t *procs;
+	unsigned int proc_cnt;
+	nvmlProcessUtilizationSample_t *util;
+	unsigned int util_cnt;
+	unsigned long long util_last_time;
+} dev_usage_t;
+
+static pthread_mutex_t dev_usage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static dev_usage_t *dev_usage = NULL;
+static unsigned int dev_usage_cnt = 0;
+static time_t dev_usage_time = 0;
+
 /*
  * Converts a cpu_set returned from the NVML API into a Slurm bitstr_t
  *
@@ -1554,14 +1568,13 @@ static char *_get_nvml_func_str(void *fname)
 	return "Graphics";
 }
 
+/* Append the "[Compute|Graphics]" processes of a device to its snapshot */
 static int _get_nvml_process_info(nvmlReturn_t (*get_proc)(nvmlDevice_t,
 							   unsigned int *,
 							   nvmlProcessInfo_t *),
-				  nvmlDevice_t device, pid_t pid,
-				  acct_gather_data_t *data)
+				  nvmlDevice_t device, dev_usage_t *usage)
 {
 	nvmlReturn_t rc;
-	nvmlProcessInfo_t *proc_info;
 	unsigned int proc_cnt = 0;
 
 	/*
@@ -1577,60 +1590,47 @@ static int _get_nvml_process_info(nvmlReturn_t (*get_proc)(nvmlDevice_t,
 		return SLURM_ERROR;
 	}
 
-	if (proc_cnt) {
-		proc_info = xcalloc(proc_cnt, sizeof(*proc_info));
-		rc = get_proc(device, &proc_cnt, proc_info);
-		if (rc != NVML_SUCCESS) {
-			if (rc == NVML_ERROR_INSUFFICIENT_SIZE) {
-				log_flag(JAG, "NVML: Failed to get %s running procs(%d): %s. New processes started in between calls, accounting not gathered during this interval",
-					 _get_nvml_func_str(get_proc),
-					 rc, nvmlErrorString(rc));
-			} else {
-				error("NVML: Failed to get %s running procs(%d): %s",
-				      _get_nvml_func_str(get_proc),
-				      rc, nvmlErrorString(rc));
-			}
-			xfree(proc_info);
-			return SLURM_ERROR;
-		}
-		for (int i = 0; i < proc_cnt; i++) {
-			if (proc_info[i].pid != pid)
-				continue;
-			/* Store MB usedGpuMemory is in bytes */
-			data[gpumem_pos].size_read += proc_info[i].usedGpuMemory;
-			break;
+	if (!proc_cnt)
+		return SLURM_SUCCESS;
+
+	xrecalloc(usage->procs, usage->proc_cnt + proc_cnt,
+		  sizeof(*usage->procs));
+	rc = get_proc(device, &proc_cnt, usage->procs + usage->proc_cnt);
+	if (rc != NVML_SUCCESS) {
+		if (rc == NVML_ERROR_INSUFFICIENT_SIZE) {
+			log_flag(JAG, "NVML: Failed to get %s running procs(%d): %s. New processes started in between calls, accounting not gathered during this interval",
+				 _get_nvml_func_str(get_proc),
+				 rc, nvmlErrorString(rc));
+		} else {
+			error("NVML: Failed to get %s running procs(%d): %s",
+			      _get_nvml_func_str(get_proc),
+			      rc, nvmlErrorString(rc));
 		}
-		xfree(proc_info);
-		log_flag(JAG, "pid %d has GPUUtil=%lu and MemMB=%lu",
-			 pid, data[gpuutil_pos].size_read,
-			 data[gpumem_pos].size_read / 1048576);
+		return SLURM_ERROR;
 	}
+	usage->proc_cnt += proc_cnt;
+
 	return SLURM_SUCCESS;
 }
 
-static int _get_gpumem(nvmlDevice_t device, pid_t pid, acct_gather_data_t *data)
+static void _get_gpumem(nvmlDevice_t device, dev_usage_t *usage)
 {
-	data[gpumem_pos].size_read = 0;
+	usage->proc_cnt = 0;
 
 	if (_get_nvml_process_info(nvmlDeviceGetComputeRunningProcesses, device,
-				   pid, data) != SLURM_SUCCESS)
-		return SLURM_ERROR;
-
-	if (_get_nvml_process_info(nvmlDeviceGetGraphicsRunningProcesses,
-				   device, pid, data) != SLURM_SUCCESS)
-		return SLURM_ERROR;
+				   usage) != SLURM_SUCCESS)
+		return;
 
-	return SLURM_SUCCESS;
+	(void) _get_nvml_process_info(nvmlDeviceGetGraphicsRunningProcesses,
+				      device, usage);
 }
 
-static int _get_gpuutil(nvmlDevice_t device, pid_t pid,
-			acct_gather_data_t *data)
+static void _get_gpuutil(nvmlDevice_t device, dev_usage_t *usage)
 {
 	nvmlReturn_t rc;
-	nvmlProcessUtilizationSample_t *proc_util;
 	unsigned int cnt = 0;
 
-	data[gpuutil_pos].size_read = 0;
+	usage->util_cnt = 0;
 
 	/*
 	 * Sending NULL will fill in cnt with the number of processes so we can
@@ -1638,25 +1638,23 @@ static int _get_gpuutil(nvmlDevice_t device, pid_t pid,
 	 * NVML_SUCCESS means no processes yet.
 	 */
 	rc = nvmlDeviceGetProcessUtilization(device, NULL, &cnt,
-					     data[gpuutil_pos].last_time);
+					     usage->util_last_time);
 	if (rc == NVML_SUCCESS || !cnt)
-		return SLURM_SUCCESS;
+		return;
 
 	if (rc != NVML_ERROR_INSUFFICIENT_SIZE) {
 		error("NVML: Failed to get process count for gpu utilization(%d): %s",
 		      rc, nvmlErrorString(rc));
-		return SLURM_ERROR;
+		return;
 	}
 
-	proc_util = xcalloc(cnt, sizeof(*proc_util));
-	rc = nvmlDeviceGetProcessUtilization(device, proc_util, &cnt,
-					     data[gpuutil_pos].last_time);
+	xrecalloc(usage->util, cnt, sizeof(*usage->util));
+	rc = nvmlDeviceGetProcessUtilization(device, usage->util, &cnt,
+					     usage->util_last_time);
 
 	if (rc == NVML_ERROR_NOT_FOUND) {
-		debug2("Couldn't find pid %d, probably hasn't started yet or has already finished",
-		       pid);
-		xfree(proc_util);
-		return SLURM_SUCCESS;
+		debug2("No processes found, probably not started yet or already finished");
+		return;
 #if HAVE_MIG_SUPPORT
 	} else if ((rc == NVML_ERROR_NOT_SUPPORTED) &&
 		   _nvml_is_device_mig(&device)) {
@@ -1666,24 +1664,61 @@ static int _get_gpuutil(nvmlDevice_t device, pid_t pid,
 		 * future and hopefully this will start working.
 		 */
 		debug2("On MIG-enabled GPUs, querying process utilization is not currently supported.");
+		return;
 #endif
 	} else if (rc != NVML_SUCCESS) {
 		error("NVML: Failed to get usage(%d): %s", rc,
 		      nvmlErrorString(rc));
-		xfree(proc_util);
-		return SLURM_ERROR;
+		return;
 	}
 
-	for (int i = 0; i < cnt; i++) {
-		if (proc_util[i].pid != pid)
-			continue;
-		data[gpuutil_pos].last_time = proc_util[i].timeStamp;
-		data[gpuutil_pos].size_read += proc_util[i].smUtil;
-		break;
+	usage->util_cnt = cnt;
+	for (int i = 0; i < cnt; i++)
+		usage->util_last_time = MAX(usage->util_last_time,
+					    usage->util[i].timeStamp);
+}
+
+/*
+ * Query the process lists and utilization of every device once per second.
+ * jobacct_gather asks for every process of the step in turn, and each of
+ * those lookups is then served from this snapshot rather than from a new
+ * chain of NVML calls per device.
+ */
+static void _refresh_dev_usage(bool track_gpumem, bool track_gpuutil)
+{
+	unsigned int device_count = 0;
+	time_t now = time(NULL);
+
+	if (dev_usage_time == now)
+		return;
+	dev_usage_time = now;
+
+	_nvml_init();
+	gpu_p_get_device_count(&device_count);
+
+	if (device_count != dev_usage_cnt) {
+		for (int i = device_count; i < dev_usage_cnt; i++) {
+			xfree(dev_usage[i].procs);
+			xfree(dev_usage[i].util);
+		}
+		xrecalloc(dev_usage, MAX(device_count, 1), sizeof(*dev_usage));
+		dev_usage_cnt = device_count;
 	}
-	xfree(proc_util);
 
-	return SLURM_SUCCESS;
+	for (int i = 0; i < device_count; i++) {
+		nvmlDevice_t device;
+
+		dev_usage[i].proc_cnt = 0;
+		dev_usage[i].util_cnt = 0;
+
+		if (!_nvml_get_handle(i, &device))
+			continue;
+
+		if (track_gpumem)
+			_get_gpumem(device, &dev_usage[i]);
+		if (track_gpuutil)
+			_get_gpuutil(device, &dev_usage[i]);
+	}
 }
 
 extern int init(void)
@@ -1701,6 +1736,13 @@ extern int fini(void)
 {
 	_nvml_shutdown();
 
+	for (int i = 0; i < dev_usage_cnt; i++) {
+		xfree(dev_usage[i].procs);
+		xfree(dev_usage[i].util);
+	}
+	xfree(dev_usage);
+	dev_usage_cnt = 0;
+
 	debug("%s: unloading %s", __func__, plugin_name);
 
 	return SLURM_SUCCESS;
@@ -1840,7 +1882,6 @@ extern int gpu_p_energy_read(uint32_t dv_ind, gpu_status_t *gpu)
 
 extern int gpu_p_usage_read(pid_t pid, acct_gather_data_t *data)
 {
-	unsigned int device_count = 0;
 	bool track_gpumem, track_gpuutil;
 
 	track_gpumem = (gpumem_pos != -1);
@@ -1851,25 +1892,38 @@ extern int gpu_p_usage_read(pid_t pid, acct_gather_data_t *data)
 		return SLURM_SUCCESS;
 	}
 
-	_nvml_init();
-	gpu_p_get_device_count(&device_count);
+	slurm_mutex_lock(&dev_usage_mutex);
+	_refresh_dev_usage(track_gpumem, track_gpuutil);
 
-	for (int i = 0; i < device_count; i++) {
-		nvmlDevice_t device;
+	if (track_gpumem)
+		data[gpumem_pos].size_read = 0;
+	if (track_gpuutil)
+		data[gpuutil_pos].size_read = 0;
 
-		if (!_nvml_get_handle(i, &device))
-			continue;
+	for (int i = 0; i < dev_usage_cnt; i++) {
+		dev_usage_t *usage = &dev_usage[i];
 
-		if (track_gpumem)
-			_get_gpumem(device, pid, data);
-		if (track_gpuutil)
-			_get_gpuutil(device, pid, data);
-
-		log_flag(JAG, "pid %d has GPUUtil=%lu and MemMB=%lu",
-			 pid,
-			 data[gpuutil_pos].size_read,
-			 data[gpumem_pos].size_read / 1048576);
+		/* Store MB usedGpuMemory is in bytes */
+		for (int j = 0; track_gpumem && (j < usage->proc_cnt); j++) {
+			if (usage->procs[j].pid != pid)
+				continue;
+			data[gpumem_pos].size_read +=
+				usage->procs[j].usedGpuMemory;
+		}
+		for (int j = 0; track_gpuutil && (j < usage->util_cnt); j++) {
+			if (usage->util[j].pid != pid)
+				continue;
+			data[gpuutil_pos].last_time = usage->util[j].timeStamp;
+			data[gpuutil_pos].size_read += usage->util[j].smUtil;
+			break;
+		}
 	}
+	slurm_mutex_unlock(&dev_usage_mutex);
+
+	log_flag(JAG, "pid %d has GPUUtil=%lu and MemMB=%lu",
+		 pid,
+		 track_gpuutil ? data[gpuutil_pos].size_read : 0,
+		 track_gpumem ? data[gpumem_pos].size_read / 1048576 : 0);
 
 	return SLURM_SUCCESS;
 }
@@ -186,6 +186,7 @@ int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned ch
     #endif
 
     #if defined(KeccakP1600times4_implementation) && !defined(KeccakP1600times4_isFallback)
+    if (KeccakP1600times4_IsAvailable()) {
     #if defined(KeccakP1600times4_K12ProcessLeaves_supported)
     ProcessLeaves( 4 )
     #elif defined(KeccakP1600times4_12rounds_FastLoop_supported)
@@ -193,6 +194,7 @@ int KangarooTwelve_Update(KangarooTwelve_Instance *ktInstance, const unsigned ch
     #else
     ParallelSpongeLoop( 4 )
     #endif
+    }
     #endif
 
     #if defined(KeccakP1600times2_implementation) && !defined(KeccakP1600times2_isFallback)
@@ -0,0 +1,258 @@
+/*
+The eXtended Keccak Code Package (XKCP)
+https://github.com/XKCP/XKCP
+
+The Keccak-p permutations, designed by Guido Bertoni, Joan Daemen, Michaël Peeters and Gilles Van Assche.
+
+Four interleaved Keccak-p[1600,12] instances processed with AVX2. The states
+are stored lane by lane, lane i of instance j being the 64-bit word at index
+4*i+j, so that one 256-bit register holds the same lane of all four instances.
+Only the permutation needs AVX2, it is compiled with a target attribute so
+that the plugin still loads on CPUs without it and the caller must check
+KeccakP1600times4_IsAvailable() first.
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+#include "k12-config.h"
+
+#ifdef XKCP_has_KeccakP1600times4
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include "KeccakP-1600-times4-SnP.h"
+
+static const uint64_t KeccakP1600RoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+int KeccakP1600times4_IsAvailable(void)
+{
+    static int available = -1;
+
+    if (available < 0) {
+        __builtin_cpu_init();
+        available = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return available;
+}
+
+void KeccakP1600times4_InitializeAll(void *states)
+{
+    memset(states, 0, KeccakP1600times4_statesSizeInBytes);
+}
+
+void KeccakP1600times4_AddBytes(void *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    unsigned char *s = (unsigned char *)states;
+    unsigned int i = 0;
+
+    if ((offset % 8) == 0) {
+        uint64_t *lanes = (uint64_t *)states;
+        for (; (i + 8) <= length; i += 8, offset += 8) {
+            uint64_t lane;
+            memcpy(&lane, data + i, 8);
+            lanes[(offset/8)*4 + instanceIndex] ^= lane;
+        }
+    }
+    for (; i < length; i++, offset++)
+        s[instanceIndex*8 + (offset/8)*4*8 + offset%8] ^= data[i];
+}
+
+void KeccakP1600times4_OverwriteWithZeroes(void *states, unsigned int instanceIndex, unsigned int byteCount)
+{
+    unsigned char *s = (unsigned char *)states;
+    unsigned int offset;
+
+    for (offset = 0; offset < byteCount; offset++)
+        s[instanceIndex*8 + (offset/8)*4*8 + offset%8] = 0;
+}
+
+void KeccakP1600times4_AddLanesAll(void *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    uint64_t *s = (uint64_t *)states;
+    unsigned int i, j;
+
+    for (j = 0; j < 4; j++) {
+        const unsigned char *d = data + j*laneOffset*8;
+        for (i = 0; i < laneCount; i++) {
+            uint64_t lane;
+            memcpy(&lane, d + i*8, 8);
+            s[4*i + j] ^= lane;
+        }
+    }
+}
+
+void KeccakP1600times4_ExtractBytes(const void *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    const unsigned char *s = (const unsigned char *)states;
+    unsigned int i;
+
+    for (i = 0; i < length; i++, offset++)
+        data[i] = s[instanceIndex*8 + (offset/8)*4*8 + offset%8];
+}
+
+void KeccakP1600times4_ExtractLanesAll(const void *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    const uint64_t *s = (const uint64_t *)states;
+    unsigned int i, j;
+
+    for (j = 0; j < 4; j++) {
+        unsigned char *d = data + j*laneOffset*8;
+        for (i = 0; i < laneCount; i++)
+            memcpy(d + i*8, &s[4*i + j], 8);
+    }
+}
+
+#define XOR(a, b) _mm256_xor_si256((a), (b))
+#define XOR5(a, b, c, d, e) XOR(XOR(XOR((a), (b)), XOR((c), (d))), (e))
+#define ANDNOT(a, b) _mm256_andnot_si256((a), (b))
+#define ROL(a, o) \
+    _mm256_or_si256(_mm256_slli_epi64((a), (o)), _mm256_srli_epi64((a), 64 - (o)))
+
+__attribute__((target("avx2")))
+void KeccakP1600times4_PermuteAll_12rounds(void *states)
+{
+    __m256i *S = (__m256i *)states;
+    __m256i A00, A01, A02, A03, A04, A05, A06, A07, A08, A09, A10, A11, A12,
+           A13, A14, A15, A16, A17, A18, A19, A20, A21, A22, A23, A24;
+    __m256i B00, B01, B02, B03, B04, B05, B06, B07, B08, B09, B10, B11, B12,
+           B13, B14, B15, B16, B17, B18, B19, B20, B21, B22, B23, B24;
+    __m256i C0, C1, C2, C3, C4, D0, D1, D2, D3, D4;
+    unsigned int round;
+
+    A00 = _mm256_load_si256(&S[0]);
+    A01 = _mm256_load_si256(&S[1]);
+    A02 = _mm256_load_si256(&S[2]);
+    A03 = _mm256_load_si256(&S[3]);
+    A04 = _mm256_load_si256(&S[4]);
+    A05 = _mm256_load_si256(&S[5]);
+    A06 = _mm256_load_si256(&S[6]);
+    A07 = _mm256_load_si256(&S[7]);
+    A08 = _mm256_load_si256(&S[8]);
+    A09 = _mm256_load_si256(&S[9]);
+    A10 = _mm256_load_si256(&S[10]);
+    A11 = _mm256_load_si256(&S[11]);
+    A12 = _mm256_load_si256(&S[12]);
+    A13 = _mm256_load_si256(&S[13]);
+    A14 = _mm256_load_si256(&S[14]);
+    A15 = _mm256_load_si256(&S[15]);
+    A16 = _mm256_load_si256(&S[16]);
+    A17 = _mm256_load_si256(&S[17]);
+    A18 = _mm256_load_si256(&S[18]);
+    A19 = _mm256_load_si256(&S[19]);
+    A20 = _mm256_load_si256(&S[20]);
+    A21 = _mm256_load_si256(&S[21]);
+    A22 = _mm256_load_si256(&S[22]);
+    A23 = _mm256_load_si256(&S[23]);
+    A24 = _mm256_load_si256(&S[24]);
+
+    for (round = 12; round < 24; round++) {
+        /* theta */
+        C0 = XOR5(A00, A05, A10, A15, A20);
+        C1 = XOR5(A01, A06, A11, A16, A21);
+        C2 = XOR5(A02, A07, A12, A17, A22);
+        C3 = XOR5(A03, A08, A13, A18, A23);
+        C4 = XOR5(A04, A09, A14, A19, A24);
+        D0 = XOR(C4, ROL(C1, 1));
+        D1 = XOR(C0, ROL(C2, 1));
+        D2 = XOR(C1, ROL(C3, 1));
+        D3 = XOR(C2, ROL(C4, 1));
+        D4 = XOR(C3, ROL(C0, 1));
+
+        /* theta, rho and pi */
+        B00 = XOR(A00, D0);
+        B10 = ROL(XOR(A01, D1), 1);
+        B20 = ROL(XOR(A02, D2), 62);
+        B05 = ROL(XOR(A03, D3), 28);
+        B15 = ROL(XOR(A04, D4), 27);
+        B16 = ROL(XOR(A05, D0), 36);
+        B01 = ROL(XOR(A06, D1), 44);
+        B11 = ROL(XOR(A07, D2), 6);
+        B21 = ROL(XOR(A08, D3), 55);
+        B06 = ROL(XOR(A09, D4), 20);
+        B07 = ROL(XOR(A10, D0), 3);
+        B17 = ROL(XOR(A11, D1), 10);
+        B02 = ROL(XOR(A12, D2), 43);
+        B12 = ROL(XOR(A13, D3), 25);
+        B22 = ROL(XOR(A14, D4), 39);
+        B23 = ROL(XOR(A15, D0), 41);
+        B08 = ROL(XOR(A16, D1), 45);
+        B18 = ROL(XOR(A17, D2), 15);
+        B03 = ROL(XOR(A18, D3), 21);
+        B13 = ROL(XOR(A19, D4), 8);
+        B14 = ROL(XOR(A20, D0), 18);
+        B24 = ROL(XOR(A21, D1), 2);
+        B09 = ROL(XOR(A22, D2), 61);
+        B19 = ROL(XOR(A23, D3), 56);
+        B04 = ROL(XOR(A24, D4), 14);
+
+        /* chi */
+        A00 = XOR(B00, ANDNOT(B01, B02));
+        A01 = XOR(B01, ANDNOT(B02, B03));
+        A02 = XOR(B02, ANDNOT(B03, B04));
+        A03 = XOR(B03, ANDNOT(B04, B00));
+        A04 = XOR(B04, ANDNOT(B00, B01));
+        A05 = XOR(B05, ANDNOT(B06, B07));
+        A06 = XOR(B06, ANDNOT(B07, B08));
+        A07 = XOR(B07, ANDNOT(B08, B09));
+        A08 = XOR(B08, ANDNOT(B09, B05));
+        A09 = XOR(B09, ANDNOT(B05, B06));
+        A10 = XOR(B10, ANDNOT(B11, B12));
+        A11 = XOR(B11, ANDNOT(B12, B13));
+        A12 = XOR(B12, ANDNOT(B13, B14));
+        A13 = XOR(B13, ANDNOT(B14, B10));
+        A14 = XOR(B14, ANDNOT(B10, B11));
+        A15 = XOR(B15, ANDNOT(B16, B17));
+        A16 = XOR(B16, ANDNOT(B17, B18));
+        A17 = XOR(B17, ANDNOT(B18, B19));
+        A18 = XOR(B18, ANDNOT(B19, B15));
+        A19 = XOR(B19, ANDNOT(B15, B16));
+        A20 = XOR(B20, ANDNOT(B21, B22));
+        A21 = XOR(B21, ANDNOT(B22, B23));
+        A22 = XOR(B22, ANDNOT(B23, B24));
+        A23 = XOR(B23, ANDNOT(B24, B20));
+        A24 = XOR(B24, ANDNOT(B20, B21));
+
+        /* iota */
+        A00 = XOR(A00, _mm256_set1_epi64x((long long)KeccakP1600RoundConstants[round]));
+    }
+
+    _mm256_store_si256(&S[0], A00);
+    _mm256_store_si256(&S[1], A01);
+    _mm256_store_si256(&S[2], A02);
+    _mm256_store_si256(&S[3], A03);
+    _mm256_store_si256(&S[4], A04);
+    _mm256_store_si256(&S[5], A05);
+    _mm256_store_si256(&S[6], A06);
+    _mm256_store_si256(&S[7], A07);
+    _mm256_store_si256(&S[8], A08);
+    _mm256_store_si256(&S[9], A09);
+    _mm256_store_si256(&S[10], A10);
+    _mm256_store_si256(&S[11], A11);
+    _mm256_store_si256(&S[12], A12);
+    _mm256_store_si256(&S[13], A13);
+    _mm256_store_si256(&S[14], A14);
+    _mm256_store_si256(&S[15], A15);
+    _mm256_store_si256(&S[16], A16);
+    _mm256_store_si256(&S[17], A17);
+    _mm256_store_si256(&S[18], A18);
+    _mm256_store_si256(&S[19], A19);
+    _mm256_store_si256(&S[20], A20);
+    _mm256_store_si256(&S[21], A21);
+    _mm256_store_si256(&S[22], A22);
+    _mm256_store_si256(&S[23], A23);
+    _mm256_store_si256(&S[24], A24);
+}
+
+#endif
@@ -40,8 +40,16 @@
 
 #include "src/interfaces/hash.h"
 #include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/xmalloc.h"
 
 #include "KangarooTwelve.h"
+#ifdef XKCP_has_KeccakP1600times4
+#include "KeccakP-1600-times4-SnP.h"
+#endif
+
+#define K12_CHUNK_SIZE 8192
+#define K12_RATE 168
 
 /*
  * These variables are required by the generic plugin interface.  If they
@@ -73,10 +81,25 @@ const char plugin_type[] = "hash/k12";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 const uint32_t plugin_id = HASH_PLUGIN_K12;
 
+#ifdef XKCP_has_KeccakP1600times4
+typedef struct {
+	const unsigned char *seg[3];	/* input, custom_str, right_encode */
+	size_t seg_len[3];
+	size_t offset;			/* bytes absorbed so far */
+	slurm_hash_t *hash;
+} k12_lane_t;
+#endif
+
 extern int init(void)
 {
 	debug("%s: %s loaded", __func__, plugin_name);
 
+#ifdef XKCP_has_KeccakP1600times4
+	if (KeccakP1600times4_IsAvailable())
+		debug("%s: using %s", __func__,
+		      KeccakP1600times4_implementation);
+#endif
+
 	return SLURM_SUCCESS;
 }
 
@@ -99,3 +122,149 @@ extern int hash_p_compute(char *input, int len, char *custom_str, int cs_len,
 
 	return (sizeof(hash->hash));
 }
+
+#ifdef XKCP_has_KeccakP1600times4
+/* K12 right_encode() of the customization string length */
+static size_t _right_encode(unsigned char *buf, size_t value)
+{
+	size_t n = 0;
+
+	for (size_t v = value; v && (n < sizeof(size_t)); v >>= 8)
+		n++;
+	for (size_t i = 1; i <= n; i++)
+		buf[i - 1] = (unsigned char) (value >> (8 * (n - i)));
+	buf[n] = (unsigned char) n;
+
+	return n + 1;
+}
+
+/*
+ * Absorb the next block of the lane input into instance inx. On the last
+ * block the final node padding is added and true is returned.
+ */
+static bool _absorb_block(void *states, int inx, k12_lane_t *lane)
+{
+	unsigned char block[K12_RATE];
+	size_t n = 0, off = lane->offset;
+
+	for (int i = 0; (i < 3) && (n < K12_RATE); i++) {
+		size_t cnt;
+
+		if (off >= lane->seg_len[i]) {
+			off -= lane->seg_len[i];
+			continue;
+		}
+		cnt = MIN(lane->seg_len[i] - off, K12_RATE - n);
+		memcpy(block + n, lane->seg[i] + off, cnt);
+		n += cnt;
+		off = 0;
+	}
+	lane->offset += n;
+
+	KeccakP1600times4_AddBytes(states, inx, block, 0, n);
+	if (n == K12_RATE)
+		return false;
+
+	/* '11': message hop, final node, then pad10*1 */
+	KeccakP1600times4_AddByte(states, inx, 0x07, n);
+	KeccakP1600times4_AddByte(states, inx, 0x80, K12_RATE - 1);
+	return true;
+}
+
+/*
+ * Hash the messages that fit in a single K12 chunk four at a time, each
+ * instance being refilled with the next message as soon as it is done.
+ * Messages needing the tree mode are left for KangarooTwelve().
+ */
+static void _compute_multi4(int cnt, char **inputs, int *lens,
+			    char *custom_str, int cs_len, slurm_hash_t *hashes,
+			    bool *done)
+{
+	ALIGN(KeccakP1600times4_statesAlignment) unsigned char
+		states[KeccakP1600times4_statesSizeInBytes];
+	unsigned char enc[sizeof(size_t) + 1];
+	size_t enc_len = _right_encode(enc, cs_len);
+	k12_lane_t lanes[4];
+	bool active[4] = { false };
+	int next = 0, running = 0;
+
+	KeccakP1600times4_InitializeAll(states);
+
+	while (true) {
+		bool last[4] = { false };
+
+		for (int i = 0; i < 4; i++) {
+			if (active[i])
+				continue;
+			while ((next < cnt) &&
+			       ((lens[next] + cs_len + enc_len) >
+				K12_CHUNK_SIZE))
+				next++;
+			if (next >= cnt)
+				break;
+
+			KeccakP1600times4_OverwriteWithZeroes(
+				states, i,
+				KeccakP1600times4_statesSizeInBytes / 4);
+			lanes[i].seg[0] = (unsigned char *) inputs[next];
+			lanes[i].seg_len[0] = lens[next];
+			lanes[i].seg[1] = (unsigned char *) custom_str;
+			lanes[i].seg_len[1] = cs_len;
+			lanes[i].seg[2] = enc;
+			lanes[i].seg_len[2] = enc_len;
+			lanes[i].offset = 0;
+			lanes[i].hash = &hashes[next];
+			done[next++] = true;
+			active[i] = true;
+			running++;
+		}
+
+		if (!running)
+			break;
+
+		for (int i = 0; i < 4; i++)
+			if (active[i])
+				last[i] = _absorb_block(states, i, &lanes[i]);
+
+		KeccakP1600times4_PermuteAll_12rounds(states);
+
+		for (int i = 0; i < 4; i++) {
+			if (!last[i])
+				continue;
+			KeccakP1600times4_ExtractBytes(
+				states, i, lanes[i].hash->hash, 0,
+				sizeof(lanes[i].hash->hash));
+			lanes[i].hash->type = HASH_PLUGIN_K12;
+			active[i] = false;
+			running--;
+		}
+	}
+}
+#endif
+
+extern int hash_p_compute_multi(int cnt, char **inputs, int *lens,
+				char *custom_str, int cs_len,
+				slurm_hash_t *hashes)
+{
+	bool *done = xcalloc(cnt, sizeof(*done));
+	int rc = cnt;
+
+#ifdef XKCP_has_KeccakP1600times4
+	if ((cnt > 1) && KeccakP1600times4_IsAvailable())
+		_compute_multi4(cnt, inputs, lens, custom_str, cs_len, hashes,
+				done);
+#endif
+
+	for (int i = 0; i < cnt; i++) {
+		if (done[i])
+			continue;
+		if (hash_p_compute(inputs[i], lens[i], custom_str, cs_len,
+				   &hashes[i]) < 0) {
+			rc = -1;
+			break;
+		}
+	}
+
+	xfree(done);
+	return rc;
+}
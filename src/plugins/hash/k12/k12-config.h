@@ -3,3 +3,8 @@
 #define XKCP_has_Sponge_Keccak
 #define XKCP_has_KangarooTwelve
 #define XKCP_has_KeccakP1600
+
+/* AVX2 times4 permutation, only used if the CPU supports it at run time */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XKCP_has_KeccakP1600times4
+#endif
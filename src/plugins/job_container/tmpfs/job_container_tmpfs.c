@@ -44,6 +44,7 @@
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sched.h>
 #include <fcntl.h>
 #include <sys/mount.h>
@@ -64,6 +65,12 @@
 
 #include "read_jcconf.h"
 
+/*
+ * Job directories being removed in the background are renamed to
+ * <basepath>/.deleting.<job_id>.<pid> first.
+ */
+#define DELETING_PREFIX ".deleting."
+
 static int _create_ns(uint32_t job_id, stepd_step_rec_t *step);
 static int _delete_ns(uint32_t job_id);
 
@@ -100,6 +107,70 @@ static int _find_step_in_list(step_loc_t *stepd, uint32_t *job_id)
 	return (stepd->step_id.job_id == *job_id);
 }
 
+static void _remove_dir(const char *path)
+{
+	int failures;
+
+	if ((failures = rmdir_recursive(path, true)))
+		error("%s: failed to remove %d files from %s",
+		      __func__, failures, path);
+}
+
+/*
+ * Remove path from a detached, low priority process so that the caller does
+ * not have to wait for it. The intermediate child is reaped here and the
+ * process doing the removal is reparented to init.
+ */
+static void _remove_dir_async(const char *path)
+{
+	pid_t pid;
+
+	if ((pid = fork()) < 0) {
+		error("%s: fork failed, removing %s now: %m", __func__, path);
+		_remove_dir(path);
+		return;
+	} else if (pid > 0) {
+		waitpid(pid, NULL, 0);
+		return;
+	}
+
+	log_reinit();
+	if ((pid = fork()) > 0)
+		_exit(0);
+
+	/* the grandchild, or this child if the second fork failed, removes it */
+	setsid();
+	closeall(0);
+	(void) setpriority(PRIO_PROCESS, 0, 19);
+	(void) rmdir_recursive(path, true);
+	_exit(0);
+}
+
+/*
+ * Get the job's directory out of the way and remove it in the background,
+ * so that the node does not stay completing while the user's files are
+ * deleted. Fall back to removing it here if it can't be renamed.
+ */
+static void _remove_job_mount(uint32_t job_id, const char *job_mount)
+{
+	char *deleting = NULL;
+
+	xstrfmtcat(deleting, "%s/%s%u.%d", jc_conf->basepath, DELETING_PREFIX,
+		   job_id, (int) getpid());
+
+	if (rename(job_mount, deleting)) {
+		log_flag(JOB_CONT, "%s: rename %s to %s failed, removing it now: %m",
+			 __func__, job_mount, deleting);
+		_remove_dir(job_mount);
+	} else {
+		log_flag(JOB_CONT, "%s: removing %s in the background",
+			 __func__, deleting);
+		_remove_dir_async(deleting);
+	}
+
+	xfree(deleting);
+}
+
 static bool _is_plugin_disabled(char *basepath)
 {
 	return ((!basepath) || (!xstrncasecmp(basepath, "none", 4)));
@@ -232,6 +303,17 @@ extern int container_p_restore(char *dir_name, bool recover)
 	}
 
 	while ((ep = readdir(dp))) {
+		/* Finish removals interrupted by a restart or reboot */
+		if (!xstrncmp(ep->d_name, DELETING_PREFIX,
+			      strlen(DELETING_PREFIX))) {
+			char *path = NULL;
+
+			xstrfmtcat(path, "%s/%s", jc_conf->basepath,
+				   ep->d_name);
+			_remove_dir_async(path);
+			xfree(path);
+			continue;
+		}
 		/* If possible, only check directories */
 		if ((ep->d_type == DT_DIR) || (ep->d_type == DT_UNKNOWN)) {
 			if (_restore_ns(steps, ep->d_name))
@@ -725,7 +807,7 @@ extern int container_p_join(uint32_t job_id, uid_t uid)
 static int _delete_ns(uint32_t job_id)
 {
 	char *job_mount = NULL, *ns_holder = NULL;
-	int rc = 0, failures = 0;
+	int rc = 0;
 
 	_create_paths(job_id, &job_mount, &ns_holder, NULL);
 
@@ -764,13 +846,14 @@ static int _delete_ns(uint32_t job_id)
 		}
 	}
 
-	if ((failures = rmdir_recursive(job_mount, false)))
-		error("%s: failed to remove %d files from %s",
-		      __func__, failures, job_mount);
+	/*
+	 * job_mount is bind mounted on itself, so the files are still there
+	 * once it is unmounted. It can only be renamed once it is not a mount
+	 * point anymore.
+	 */
 	if (umount2(job_mount, MNT_DETACH))
 		log_flag(JOB_CONT, "umount2: %s failed: %m", job_mount);
-	if (rmdir(job_mount))
-		error("rmdir %s failed: %m", job_mount);
+	_remove_job_mount(job_id, job_mount);
 
 	xfree(job_mount);
 	xfree(ns_holder);
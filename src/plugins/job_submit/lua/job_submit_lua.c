@@ -217,6 +217,22 @@ static int _job_rec_field_index(lua_State *L)
 	return slurm_lua_job_record_field(L, job_ptr, name);
 }
 
+/*
+ * Get fields of a slurm.jobs entry. The entry only holds the job_id, the
+ * job_record is looked up when a field is accessed.
+ */
+static int _jobs_global_field_index(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 2);
+	job_record_t *job_ptr;
+
+	lua_pushstring(L, "job_id");
+	lua_rawget(L, 1);
+	job_ptr = find_job_record((uint32_t) lua_tonumber(L, -1));
+
+	return slurm_lua_job_record_field(L, job_ptr, name);
+}
+
 static int _foreach_update_jobs_global(void *x, void *arg)
 {
 	char job_id_buf[11]; /* Big enough for a uint32_t */
@@ -224,25 +240,18 @@ static int _foreach_update_jobs_global(void *x, void *arg)
 	lua_State *st = arg;
 
 	/*
-	 * Create an empty table, with a metatable that looks up the
-	 * data for the individual job.
+	 * Create a table holding only the job_id, with the shared metatable
+	 * (on top of the stack) that looks up the rest of the job's data.
 	 */
 	lua_newtable(st);
-
-	lua_newtable(st);
-	lua_pushcfunction(st, _job_rec_field_index);
-	lua_setfield(st, -2, "__index");
-	/*
-	 * Store the job_record in the metatable, so the index
-	 * function knows which job it's getting data for.
-	 */
-	lua_pushlightuserdata(st, job_ptr);
-	lua_setfield(st, -2, "_job_rec_ptr");
+	lua_pushnumber(st, job_ptr->job_id);
+	lua_setfield(st, -2, "job_id");
+	lua_pushvalue(st, -2);
 	lua_setmetatable(st, -2);
 
 	/* Lua copies passed strings, so we can reuse the buffer. */
-	snprintf(job_id_buf, sizeof(job_id_buf), "%d", job_ptr->job_id);
-	lua_setfield(st, -2, job_id_buf);
+	snprintf(job_id_buf, sizeof(job_id_buf), "%u", job_ptr->job_id);
+	lua_setfield(st, -3, job_id_buf);
 
 	return 0;
 }
@@ -255,10 +264,16 @@ static void _update_jobs_global(lua_State *st)
 	}
 
 	lua_getglobal(st, "slurm");
+	lua_createtable(st, 0, list_count(job_list));
+
+	/* One metatable shared by all entries */
 	lua_newtable(st);
+	lua_pushcfunction(st, _jobs_global_field_index);
+	lua_setfield(st, -2, "__index");
 
 	list_for_each(job_list, _foreach_update_jobs_global, st);
 	last_lua_jobs_update = last_job_update;
+	lua_pop(st, 1);
 
 	lua_setfield(st, -2, "jobs");
 	lua_pop(st, 1);
@@ -143,6 +143,16 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 	return;
 }
 
+/*
+ * With JobAcctGatherParams=CgroupOnly all the usage comes from the task
+ * cgroup, which already accounts for every descendant.
+ */
+static void _no_offspring_data(List prec_list, jag_prec_t *ancestor,
+			       pid_t pid)
+{
+	return;
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
@@ -223,6 +233,11 @@ extern void jobacct_gather_p_poll_data(List task_list, uint64_t cont_id,
 		memset(&callbacks, 0, sizeof(jag_callbacks_t));
 		first = 0;
 		callbacks.prec_extra = _prec_extra;
+		if (xstrcasestr(slurm_conf.job_acct_gather_params,
+				"CgroupOnly")) {
+			callbacks.get_precs = jag_common_get_task_precs;
+			callbacks.get_offspring_data = _no_offspring_data;
+		}
 	}
 
 	jag_common_poll_data(task_list, cont_id, &callbacks, profile);
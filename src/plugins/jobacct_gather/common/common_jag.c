@@ -54,6 +54,7 @@
 #include "src/interfaces/acct_gather_energy.h"
 #include "src/interfaces/acct_gather_filesystem.h"
 #include "src/interfaces/acct_gather_interconnect.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/proctrack.h"
 
@@ -75,19 +76,41 @@ char **assoc_mgr_tres_name_array;
 static int cpunfo_frequency = 0;
 static long conv_units = 0;
 List prec_list = NULL;
+static xhash_t *prec_hash = NULL; /* pid -> record of prec_list */
 
 static int my_pagesize = 0;
 static int energy_profile = ENERGY_DATA_NODE_ENERGY_UP;
 
-static int _find_prec(void *x, void *key)
+static void _prec_hash_id(void *item, const char **key, uint32_t *key_len)
 {
-	jag_prec_t *prec = (jag_prec_t *) x;
-	pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = item;
 
-	if (prec->pid == pid)
-		return 1;
+	*key = (const char *) &prec->pid;
+	*key_len = sizeof(prec->pid);
+}
 
-	return 0;
+static jag_prec_t *_find_prec(pid_t pid)
+{
+	return xhash_get(prec_hash, (const char *) &pid, sizeof(pid));
+}
+
+/*
+ * Add a new record to prec_list, or replace in place the one we already have
+ * for this pid so that prec_hash stays valid.
+ */
+static void _store_prec(jag_prec_t *prec)
+{
+	jag_prec_t *old_prec;
+
+	if ((old_prec = _find_prec(prec->pid))) {
+		xfree(old_prec->tres_data);
+		memcpy(old_prec, prec, sizeof(*old_prec));
+		xfree(prec);
+		return;
+	}
+
+	list_append(prec_list, prec);
+	xhash_add(prec_hash, prec);
 }
 
 /* return weighted frequency in mhz */
@@ -519,11 +542,49 @@ void _set_smaps_file(char **proc_smaps_file, pid_t pid)
 		xstrfmtcat(*proc_smaps_file, "/proc/%d/smaps", pid);
 }
 
+static bool _gpu_acct_disabled(void)
+{
+	static int disable_gpu_acct = -1;
+
+	if (disable_gpu_acct == -1) {
+		if (xstrcasestr(slurm_conf.job_acct_gather_params,
+				"DisableGPUAcct")) {
+			disable_gpu_acct = 1;
+			log_flag(JAG, "GPU accounting disabled as JobAcctGatherParams=DisableGpuAcct is set.");
+		} else
+			disable_gpu_acct = 0;
+	}
+
+	return disable_gpu_acct;
+}
+
+static jag_prec_t *_create_prec(pid_t pid, int tres_count)
+{
+	jag_prec_t *prec = xmalloc(sizeof(*prec));
+
+	if (!tres_count) {
+		assoc_mgr_lock_t locks = {
+			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
+			READ_LOCK, NO_LOCK, NO_LOCK };
+		assoc_mgr_lock(&locks);
+		tres_count = g_tres_count;
+		assoc_mgr_unlock(&locks);
+	}
+
+	prec->pid = pid;
+	prec->tres_count = tres_count;
+	prec->tres_data = xcalloc(prec->tres_count,
+				  sizeof(acct_gather_data_t));
+
+	(void)_init_tres(prec, NULL);
+
+	return prec;
+}
+
 static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 {
 	static int no_share_data = -1;
 	static int use_pss = -1;
-	static int disable_gpu_acct = -1;
 	char *proc_file = NULL;
 	FILE *stat_fp = NULL;
 	FILE *io_fp = NULL;
@@ -542,15 +603,6 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 			use_pss = 0;
 	}
 
-	if (disable_gpu_acct == -1) {
-		if (xstrcasestr(slurm_conf.job_acct_gather_params,
-				"DisableGPUAcct")) {
-			disable_gpu_acct = 1;
-			log_flag(JAG, "GPU accounting disabled as JobAcctGatherParams=DisableGpuAcct is set.");
-		} else
-			disable_gpu_acct = 0;
-	}
-
 	xstrfmtcat(proc_file, "/proc/%u/stat", pid);
 	if (!(stat_fp = fopen(proc_file, "r")))
 		return;  /* Assume the process went away */
@@ -568,22 +620,7 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
 		error("%s: fcntl(%s): %m", __func__, proc_file);
 
-	prec = xmalloc(sizeof(*prec));
-
-	if (!tres_count) {
-		assoc_mgr_lock_t locks = {
-			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
-			READ_LOCK, NO_LOCK, NO_LOCK };
-		assoc_mgr_lock(&locks);
-		tres_count = g_tres_count;
-		assoc_mgr_unlock(&locks);
-	}
-
-	prec->tres_count = tres_count;
-	prec->tres_data = xcalloc(prec->tres_count,
-				  sizeof(acct_gather_data_t));
-
-	(void)_init_tres(prec, NULL);
+	prec = _create_prec(pid, tres_count);
 
 	if (!_get_process_data_line(fd, prec)) {
 		fclose(stat_fp);
@@ -592,7 +629,7 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 
 	fclose(stat_fp);
 
-	if (!disable_gpu_acct)
+	if (!_gpu_acct_disabled())
 		gpu_g_usage_read(pid, prec->tres_data);
 
 	/* Remove shared data from rss */
@@ -624,8 +661,7 @@ static void _handle_stats(pid_t pid, jag_callbacks_t *callbacks, int tres_count)
 		fclose(io_fp);
 	}
 
-	destroy_jag_prec(list_remove_first(prec_list, _find_prec, &prec->pid));
-	list_append(prec_list, prec);
+	_store_prec(prec);
 	xfree(proc_file);
 	return;
 
@@ -635,6 +671,22 @@ bail_out:
 	return;
 }
 
+/* update consumed energy even if pids do not exist */
+static void _update_energy_no_pids(struct jobacctinfo *jobacct)
+{
+	if (!jobacct)
+		return;
+
+	acct_gather_energy_g_get_sum(energy_profile, &jobacct->energy);
+	jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.consumed_energy;
+	jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.current_watts;
+	log_flag(JAG, "energy = %"PRIu64" watts = %u",
+		 jobacct->energy.consumed_energy,
+		 jobacct->energy.current_watts);
+}
+
 static List _get_precs(List task_list, uint64_t cont_id,
 		       jag_callbacks_t *callbacks)
 {
@@ -655,24 +707,47 @@ static List _get_precs(List task_list, uint64_t cont_id,
 		}
 		xfree(pids);
 	} else {
-		/* update consumed energy even if pids do not exist */
-		if (jobacct) {
-			acct_gather_energy_g_get_sum(energy_profile,
-						     &jobacct->energy);
-			jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
-				jobacct->energy.consumed_energy;
-			jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
-				jobacct->energy.current_watts;
-			log_flag(JAG, "energy = %"PRIu64" watts = %u",
-				 jobacct->energy.consumed_energy,
-				 jobacct->energy.current_watts);
-		}
+		_update_energy_no_pids(jobacct);
 		log_flag(JAG, "no pids in this container %"PRIu64, cont_id);
 	}
 
 	return prec_list;
 }
 
+extern List jag_common_get_task_precs(List task_list, uint64_t cont_id,
+				      jag_callbacks_t *callbacks)
+{
+	struct jobacctinfo *jobacct = NULL;
+	list_itr_t *itr;
+	jag_prec_t *prec;
+
+	xassert(task_list);
+
+	if (!list_count(task_list)) {
+		log_flag(JAG, "no tasks in this container %"PRIu64, cont_id);
+		return prec_list;
+	}
+
+	/*
+	 * One record per task, keyed on the task pid. The usage is filled in
+	 * by prec_extra() from the task's aggregated counters, so there is no
+	 * need to walk /proc for every process of the step.
+	 */
+	itr = list_iterator_create(task_list);
+	while ((jobacct = list_next(itr))) {
+		if (!(prec = _find_prec(jobacct->pid))) {
+			prec = _create_prec(jobacct->pid, jobacct->tres_count);
+			_store_prec(prec);
+		}
+
+		if (!_gpu_acct_disabled())
+			gpu_g_usage_read(prec->pid, prec->tres_data);
+	}
+	list_iterator_destroy(itr);
+
+	return prec_list;
+}
+
 static void _record_profile(struct jobacctinfo *jobacct)
 {
 	enum {
@@ -812,6 +887,7 @@ extern void jag_common_init(long plugin_units)
 	uint32_t profile_opt;
 
 	prec_list = list_create(destroy_jag_prec);
+	prec_hash = xhash_init(_prec_hash_id, NULL);
 
 	acct_gather_profile_g_get(ACCT_GATHER_PROFILE_RUNNING,
 				  &profile_opt);
@@ -832,6 +908,7 @@ extern void jag_common_init(long plugin_units)
 
 extern void jag_common_fini(void)
 {
+	xhash_free(prec_hash);
 	FREE_NULL_LIST(prec_list);
 }
 
@@ -875,31 +952,39 @@ static void _print_jag_prec(jag_prec_t *prec)
 	log_flag(JAG, "usec \t%f", prec->usec);
 }
 
-static int _list_find_prec_by_pid(void *x, void *key)
+static int _reset_tree(void *x, void *arg)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = x;
 
-        if (!j->visited && (j->pid == pid))
-                return 1;
-        return 0;
+	prec->visited = false;
+	prec->first_child = NULL;
+	prec->next_sibling = NULL;
+
+	return 0;
 }
 
-static int _list_find_prec_by_ppid(void *x, void *key)
+static int _link_to_parent(void *x, void *arg)
 {
-        jag_prec_t *j = (jag_prec_t *) x;
-        pid_t pid = *(pid_t *) key;
+	jag_prec_t *prec = x;
+	jag_prec_t *parent;
 
-        if (!j->visited && (j->ppid == pid))
-                return 1;
-        return 0;
+	if (!(parent = _find_prec(prec->ppid)) || (parent == prec))
+		return 0;
+
+	prec->next_sibling = parent->first_child;
+	parent->first_child = prec;
+
+	return 0;
 }
 
-static int _reset_visited(jag_prec_t *prec, void *empty)
+/*
+ * Link every record in prec_list to its parent so the offspring of a task can
+ * be walked without searching the whole list for each generation.
+ */
+static void _build_prec_tree(void)
 {
-	prec->visited = false;
-
-	return SLURM_SUCCESS;
+	(void) list_for_each(prec_list, _reset_tree, NULL);
+	(void) list_for_each(prec_list, _link_to_parent, NULL);
 }
 
 static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
@@ -976,31 +1061,37 @@ static void _aggregate_prec(jag_prec_t *prec, jag_prec_t *ancestor)
  */
 static void _get_offspring_data(List prec_list, jag_prec_t *ancestor, pid_t pid)
 {
-	jag_prec_t *prec = NULL;
-	jag_prec_t *prec_tmp = NULL;
-	List tmp_list = NULL;
-
-	/* reset all precs to be not visited */
-	(void)list_for_each(prec_list, (ListForF)_reset_visited, NULL);
+	jag_prec_t *prec = NULL, *child;
+	jag_prec_t **family;
+	int family_cnt = 0, family_size = 64;
 
 	/* See if we can find a prec from the given pid */
-	if (!(prec = list_find_first(prec_list, _list_find_prec_by_pid, &pid)))
+	if (!(prec = _find_prec(pid)))
 		return;
 
+	family = xcalloc(family_size, sizeof(*family));
 	prec->visited = true;
+	family[family_cnt++] = prec;
 
-	tmp_list = list_create(NULL);
-	list_append(tmp_list, prec);
-
-	while ((prec_tmp = list_dequeue(tmp_list))) {
-		while ((prec = list_find_first(prec_list,
-					      _list_find_prec_by_ppid,
-					       &(prec_tmp->pid)))) {
-			_aggregate_prec(prec, ancestor);
-			list_append(tmp_list, prec);
+	/* Breadth first walk, visited guards against pid reuse loops */
+	for (int i = 0; i < family_cnt; i++) {
+		for (child = family[i]->first_child; child;
+		     child = child->next_sibling) {
+			if (child->visited)
+				continue;
+			_aggregate_prec(child, ancestor);
+			if (family_cnt == family_size) {
+				family_size *= 2;
+				xrecalloc(family, family_size,
+					  sizeof(*family));
+			}
+			family[family_cnt++] = child;
 		}
 	}
-	FREE_NULL_LIST(tmp_list);
+
+	for (int i = 0; i < family_cnt; i++)
+		family[i]->visited = false;
+	xfree(family);
 
 	return;
 }
@@ -1043,6 +1134,7 @@ extern void jag_common_poll_data(List task_list, uint64_t cont_id,
 
 	(void)list_for_each(prec_list, (ListForF)_init_tres, NULL);
 	(*(callbacks->get_precs))(task_list, cont_id, callbacks);
+	_build_prec_tree();
 
 	if (!list_count(prec_list) || !task_list || !list_count(task_list))
 		goto finished;	/* We have no business being here! */
@@ -1051,8 +1143,7 @@ extern void jag_common_poll_data(List task_list, uint64_t cont_id,
 	while ((jobacct = list_next(itr))) {
 		double cpu_calc;
 		double last_total_cputime;
-		if (!(prec = list_find_first(prec_list, _find_prec,
-					     &jobacct->pid)))
+		if (!(prec = _find_prec(jobacct->pid)))
 			continue;
 		/*
 		 * We can't use the prec from the list as we need to keep it in
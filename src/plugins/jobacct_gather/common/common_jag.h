@@ -46,7 +46,9 @@
 typedef struct jag_prec {	/* process record */
 	bool	visited;
 	int	act_cpufreq;	/* actual average cpu frequency */
+	struct jag_prec *first_child; /* process tree, see _build_prec_tree */
 	int	last_cpu;	/* last cpu */
+	struct jag_prec *next_sibling;
 	pid_t	pid;
 	pid_t	ppid;
 	double  ssec; /* system cpu time: To normalize divide by system hertz */
@@ -68,6 +70,14 @@ extern void jag_common_init(long in_hertz);
 extern void jag_common_fini(void);
 extern void destroy_jag_prec(void *object);
 
+/*
+ * get_precs callback building one record per task in task_list instead of
+ * scanning /proc for every pid of the container. Meant to be used together
+ * with a prec_extra callback that fills in the task's usage.
+ */
+extern List jag_common_get_task_precs(List task_list, uint64_t cont_id,
+				      jag_callbacks_t *callbacks);
+
 extern void jag_common_poll_data(List task_list, uint64_t cont_id,
 				 jag_callbacks_t *callbacks, bool profile);
 
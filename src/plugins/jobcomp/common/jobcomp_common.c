@@ -39,9 +39,30 @@
 #include "src/common/fd.h"
 #include "src/common/id_util.h"
 #include "src/common/parse_time.h"
+#include "src/interfaces/serializer.h"
 #include "src/plugins/jobcomp/common/jobcomp_common.h"
 #include "src/slurmctld/slurmctld.h"
 
+typedef struct {
+	uint32_t job_id;
+	data_t *record;
+} serialize_rec_t;
+
+static pthread_mutex_t serialize_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t serialize_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t serialize_thread = 0;
+static list_t *serialize_list = NULL;
+static jobcomp_common_send_t serialize_send = NULL;
+static bool serialize_shutdown = false;
+
+static void _free_serialize_rec(void *x)
+{
+	serialize_rec_t *rec = x;
+
+	FREE_NULL_DATA(rec->record);
+	xfree(rec);
+}
+
 /*
  * Open jobcomp state file, or backup if necessary.
  *
@@ -398,3 +419,94 @@ extern data_t *jobcomp_common_job_record_to_data(job_record_t *job_ptr) {
 
 	return record;
 }
+
+static void *_serialize_agent(void *arg)
+{
+	serialize_rec_t *rec;
+	char *json;
+	int rc;
+
+	while (true) {
+		slurm_mutex_lock(&serialize_mutex);
+		while (!serialize_shutdown && !list_count(serialize_list))
+			slurm_cond_wait(&serialize_cond, &serialize_mutex);
+		rec = list_dequeue(serialize_list);
+		slurm_mutex_unlock(&serialize_mutex);
+
+		/* Queue is drained before exiting */
+		if (!rec)
+			break;
+
+		json = NULL;
+		if ((rc = serialize_g_data_to_string(&json, NULL, rec->record,
+						     MIME_TYPE_JSON,
+						     SER_FLAGS_COMPACT)))
+			error("%s: JobId=%u discarded, unable to serialize to JSON: %s",
+			      __func__, rec->job_id, slurm_strerror(rc));
+		else
+			serialize_send(rec->job_id, &json);
+
+		xfree(json);
+		_free_serialize_rec(rec);
+	}
+
+	return NULL;
+}
+
+extern void jobcomp_common_serializer_init(jobcomp_common_send_t send)
+{
+	xassert(send);
+
+	slurm_mutex_lock(&serialize_mutex);
+	if (!serialize_list) {
+		serialize_list = list_create(_free_serialize_rec);
+		serialize_send = send;
+		serialize_shutdown = false;
+		slurm_thread_create(&serialize_thread, _serialize_agent, NULL);
+	}
+	slurm_mutex_unlock(&serialize_mutex);
+}
+
+extern void jobcomp_common_serializer_fini(void)
+{
+	slurm_mutex_lock(&serialize_mutex);
+	if (!serialize_list) {
+		slurm_mutex_unlock(&serialize_mutex);
+		return;
+	}
+	serialize_shutdown = true;
+	slurm_cond_broadcast(&serialize_cond);
+	slurm_mutex_unlock(&serialize_mutex);
+
+	slurm_thread_join(serialize_thread);
+
+	slurm_mutex_lock(&serialize_mutex);
+	FREE_NULL_LIST(serialize_list);
+	serialize_send = NULL;
+	slurm_mutex_unlock(&serialize_mutex);
+}
+
+extern int jobcomp_common_serialize_async(job_record_t *job_ptr)
+{
+	serialize_rec_t *rec;
+	data_t *record;
+
+	if (!(record = jobcomp_common_job_record_to_data(job_ptr)))
+		return SLURM_ERROR;
+
+	rec = xmalloc(sizeof(*rec));
+	rec->job_id = job_ptr->job_id;
+	rec->record = record;
+
+	slurm_mutex_lock(&serialize_mutex);
+	if (!serialize_list || serialize_shutdown) {
+		slurm_mutex_unlock(&serialize_mutex);
+		_free_serialize_rec(rec);
+		return SLURM_ERROR;
+	}
+	list_enqueue(serialize_list, rec);
+	slurm_cond_signal(&serialize_cond);
+	slurm_mutex_unlock(&serialize_mutex);
+
+	return SLURM_SUCCESS;
+}
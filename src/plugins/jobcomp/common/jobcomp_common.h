@@ -43,4 +43,27 @@ extern buf_t *jobcomp_common_load_state_file(char *state_file);
 extern void jobcomp_common_write_state_file(buf_t *buffer, char *state_file);
 extern data_t *jobcomp_common_job_record_to_data(job_record_t *job_ptr);
 
+/*
+ * Called from the serializer thread with the compact JSON form of a completed
+ * job. The callee may take ownership of *json by setting it to NULL.
+ */
+typedef void (*jobcomp_common_send_t)(uint32_t job_id, char **json);
+
+/*
+ * Start a thread that serializes completed job records to JSON and hands
+ * them to send(), so that callers holding the job lock only pay for
+ * building the record.
+ */
+extern void jobcomp_common_serializer_init(jobcomp_common_send_t send);
+
+/* Serialize and send every queued record, then stop the thread */
+extern void jobcomp_common_serializer_fini(void);
+
+/*
+ * Build the completion record of a job and queue it for serialization.
+ * Caller must hold the job read lock.
+ * RET SLURM_SUCCESS or error
+ */
+extern int jobcomp_common_serialize_async(job_record_t *job_ptr);
+
 #endif
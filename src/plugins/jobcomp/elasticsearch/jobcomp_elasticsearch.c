@@ -101,6 +101,8 @@ const char plugin_type[] = "jobcomp/elasticsearch";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 #define INDEX_RETRY_INTERVAL 30
+#define BULK_MAX_JOBS 1000
+#define BULK_MAX_SIZE (5 * 1024 * 1024)	/* 5 MB */
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined. They will get
@@ -121,12 +123,25 @@ struct http_response {
 };
 
 struct job_node {
+	bool indexed;
 	time_t last_index_retry;
 	char * serialized_job;
 };
 
+/* Jobs sent together in one _bulk request */
+typedef struct {
+	char *body;
+	size_t body_len;
+	int item_cnt;
+	int job_cnt;
+	struct job_node **jobs;
+} bulk_batch_t;
+
 char *save_state_file = "elasticsearch_state";
 char *log_url = NULL;
+static char *bulk_url = NULL;
+static CURL *curl_handle = NULL;
+static struct curl_slist *bulk_headers = NULL;
 
 static pthread_cond_t location_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t location_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -188,15 +203,59 @@ static size_t _write_callback(void *contents, size_t size, size_t nmemb,
 	return realsize;
 }
 
-/* Try to index job into elasticsearch */
-static int _index_job(const char *jobcomp)
+/*
+ * Derive the _bulk endpoint from JobCompLoc, which names the document
+ * endpoint of the index (e.g. http://localhost:9200/slurm/_doc).
+ */
+static char *_get_bulk_url(const char *url)
+{
+	char *bulk_url = xstrdup(url);
+	int len;
+
+	while ((len = strlen(bulk_url)) && (bulk_url[len - 1] == '/'))
+		bulk_url[len - 1] = '\0';
+	if ((len = strlen(bulk_url)) > 5 &&
+	    !xstrcmp(bulk_url + len - 5, "/_doc"))
+		bulk_url[len - 5] = '\0';
+	xstrcat(bulk_url, "/_bulk");
+
+	return bulk_url;
+}
+
+static data_for_each_cmd_t _foreach_bulk_item(const data_t *data, void *arg)
+{
+	bulk_batch_t *batch = arg;
+	const data_t *op, *status;
+	int i = batch->item_cnt++;
+
+	if (i >= batch->job_cnt)
+		return DATA_FOR_EACH_STOP;
+
+	if (!(op = data_key_get_const(data, "index")) &&
+	    !(op = data_key_get_const(data, "create")))
+		return DATA_FOR_EACH_CONT;
+
+	/* HTTP 200 (OK) or 201 (Created) per indexed document */
+	if ((status = data_key_get_const(op, "status")) &&
+	    (data_get_type(status) == DATA_TYPE_INT_64) &&
+	    ((data_get_int(status) == 200) || (data_get_int(status) == 201)))
+		batch->jobs[i]->indexed = true;
+
+	return DATA_FOR_EACH_CONT;
+}
+
+/*
+ * Index a batch of jobs into elasticsearch with one _bulk request, marking
+ * each job accepted by the server as indexed.
+ */
+static int _index_bulk(bulk_batch_t *batch)
 {
-	CURL *curl_handle = NULL;
 	CURLcode res;
-	struct http_response chunk;
-	struct curl_slist *slist = NULL;
+	struct http_response chunk = { 0 };
+	long response_code = 0;
+	data_t *resp = NULL;
+	const data_t *errors, *items;
 	int rc = SLURM_SUCCESS;
-	char *token = NULL;
 
 	slurm_mutex_lock(&location_mutex);
 	if (log_url == NULL) {
@@ -205,34 +264,32 @@ static int _index_job(const char *jobcomp)
 		return SLURM_ERROR;
 	}
 
-	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
-		error("%s: curl_global_init: %m", plugin_type);
-		rc = SLURM_ERROR;
-		goto cleanup_global_init;
-	} else if ((curl_handle = curl_easy_init()) == NULL) {
+	if (!curl_handle && !(curl_handle = curl_easy_init())) {
 		error("%s: curl_easy_init: %m", plugin_type);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+		slurm_mutex_unlock(&location_mutex);
+		return SLURM_ERROR;
 	}
 
-	slist = curl_slist_append(slist, "Content-Type: " MIME_TYPE_JSON);
-
-	if (slist == NULL) {
+	if (!bulk_headers && !(bulk_headers = curl_slist_append(NULL,
+			"Content-Type: application/x-ndjson"))) {
 		error("%s: curl_slist_append: %m", plugin_type);
-		rc = SLURM_ERROR;
-		goto cleanup_easy_init;
+		slurm_mutex_unlock(&location_mutex);
+		return SLURM_ERROR;
 	}
 
 	chunk.message = xmalloc(1);
-	chunk.size = 0;
 
-	if (curl_easy_setopt(curl_handle, CURLOPT_URL, log_url) ||
+	/*
+	 * The handle is reused for every batch so that libcurl keeps the
+	 * connection to the server alive between requests.
+	 */
+	if (curl_easy_setopt(curl_handle, CURLOPT_URL, bulk_url) ||
 	    curl_easy_setopt(curl_handle, CURLOPT_POST, 1) ||
-	    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, jobcomp) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, batch->body) ||
 	    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE,
-			     strlen(jobcomp)) ||
-	    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, slist) ||
-	    curl_easy_setopt(curl_handle, CURLOPT_HEADER, 1) ||
+			     (long) batch->body_len) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, bulk_headers) ||
+	    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L) ||
 	    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION,
 			     _write_callback) ||
 	    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *) &chunk)) {
@@ -243,50 +300,50 @@ static int _index_job(const char *jobcomp)
 
 	if ((res = curl_easy_perform(curl_handle)) != CURLE_OK) {
 		log_flag(JOBCOMP, "Could not connect to: %s , reason: %s",
-			 log_url, curl_easy_strerror(res));
+			 bulk_url, curl_easy_strerror(res));
 		rc = SLURM_ERROR;
 		goto cleanup;
 	}
 
-	token = strtok(chunk.message, " ");
-	if (token == NULL) {
-		error("%s: Could not receive the HTTP response status code from %s",
-		      plugin_type, log_url);
+	if ((res = curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE,
+				     &response_code)) != CURLE_OK) {
+		error("%s: Could not receive the HTTP response status code from %s: %s",
+		      plugin_type, bulk_url, curl_easy_strerror(res));
 		rc = SLURM_ERROR;
 		goto cleanup;
 	}
-	token = strtok(NULL, " ");
 
-	/* HTTP 100 (Continue). */
-	if ((xstrcmp(token, "100") == 0)) {
-		(void)  strtok(NULL, " ");
-		token = strtok(NULL, " ");
+	if (response_code != 200) {
+		log_flag(JOBCOMP, "HTTP status code %ld received from %s",
+			 response_code, bulk_url);
+		log_flag(JOBCOMP, "HTTP response:\n%s", chunk.message);
+		rc = SLURM_ERROR;
+		goto cleanup;
 	}
 
-	/*
-	 * HTTP 200 (OK)	- request succeed.
-	 * HTTP 201 (Created)	- request succeed and resource created.
-	 */
-	if ((xstrcmp(token, "200") != 0) && (xstrcmp(token, "201") != 0)) {
-		log_flag(JOBCOMP, "HTTP status code %s received from %s",
-			 token, log_url);
-		log_flag(JOBCOMP, "HTTP response:\n%s", chunk.message);
+	/* Per document results are only needed if some of them failed */
+	if (serialize_g_string_to_data(&resp, chunk.message, chunk.size,
+				       MIME_TYPE_JSON) ||
+	    !(errors = data_key_get_const(resp, "errors")) ||
+	    !(items = data_key_get_const(resp, "items"))) {
+		error("%s: Unable to parse _bulk response from %s",
+		      plugin_type, bulk_url);
 		rc = SLURM_ERROR;
+		goto cleanup;
+	}
+
+	if (!data_get_bool(errors)) {
+		for (int i = 0; i < batch->job_cnt; i++)
+			batch->jobs[i]->indexed = true;
 	} else {
-		token = strtok((char *)jobcomp, ",");
-		(void)  strtok(token, ":");
-		token = strtok(NULL, ":");
-		log_flag(JOBCOMP, "Job with jobid %s indexed into elasticsearch",
-			 token);
+		log_flag(JOBCOMP, "HTTP response:\n%s", chunk.message);
+		(void) data_list_for_each_const(items, _foreach_bulk_item,
+						batch);
 	}
 
 cleanup:
-	curl_slist_free_all(slist);
+	FREE_NULL_DATA(resp);
 	xfree(chunk.message);
-cleanup_easy_init:
-	curl_easy_cleanup(curl_handle);
-cleanup_global_init:
-	curl_global_cleanup();
 	slurm_mutex_unlock(&location_mutex);
 	return rc;
 }
@@ -318,10 +375,17 @@ static int _save_state(void)
 	return rc;
 }
 
+static void _enqueue_job(uint32_t job_id, char **json)
+{
+	struct job_node *jnode = xmalloc(sizeof(struct job_node));
+
+	jnode->serialized_job = *json;
+	*json = NULL;
+	list_enqueue(jobslist, jnode);
+}
+
 extern int jobcomp_p_log_record(job_record_t *job_ptr)
 {
-	struct job_node *jnode = NULL;
-	data_t *record = NULL;
 	int rc;
 
 	if (list_count(jobslist) > MAX_JOBS) {
@@ -330,28 +394,92 @@ extern int jobcomp_p_log_record(job_record_t *job_ptr)
 		return SLURM_ERROR;
 	}
 
-	record = jobcomp_common_job_record_to_data(job_ptr);
-	jnode = xmalloc(sizeof(struct job_node));
-	if ((rc = serialize_g_data_to_string(&jnode->serialized_job, NULL,
-					     record, MIME_TYPE_JSON,
-					     SER_FLAGS_COMPACT))) {
-		xfree(jnode);
-		log_flag(JOBCOMP, "unable to serialize %pJ to JSON: %s",
+	if ((rc = jobcomp_common_serialize_async(job_ptr)))
+		log_flag(JOBCOMP, "unable to build record of %pJ: %s",
 			 job_ptr, slurm_strerror(rc));
-	} else {
-		list_enqueue(jobslist, jnode);
-	}
 
-	FREE_NULL_DATA(record);
 	return rc;
 }
 
-extern void *_process_jobs(void *x)
+static int _find_indexed(void *x, void *key)
+{
+	struct job_node *jnode = x;
+
+	return jnode->indexed;
+}
+
+/*
+ * Send every job due for (re)indexing in _bulk batches.
+ * RET number of jobs indexed
+ */
+static int _index_pending_jobs(int *fail_cnt, int *wait_retry_cnt)
 {
 	list_itr_t *iter;
-	struct job_node *jnode = NULL;
+	struct job_node *jnode;
+	bulk_batch_t batch = { 0 };
+	char *pos = NULL;
+	time_t now = time(NULL);
+	int success_cnt = 0;
+	bool more = true, first_pass = true;
+
+	batch.jobs = xcalloc(BULK_MAX_JOBS, sizeof(*batch.jobs));
+
+	while (more && !thread_shutdown) {
+		more = false;
+		batch.job_cnt = batch.item_cnt = 0;
+		batch.body_len = 0;
+		pos = NULL;
+		xfree(batch.body);
+
+		/* Only this thread removes jobs, so the pointers stay valid */
+		iter = list_iterator_create(jobslist);
+		while ((jnode = list_next(iter))) {
+			if (jnode->last_index_retry &&
+			    (difftime(now, jnode->last_index_retry) <
+			     INDEX_RETRY_INTERVAL)) {
+				if (first_pass)
+					(*wait_retry_cnt)++;
+				continue;
+			}
+			if ((batch.job_cnt >= BULK_MAX_JOBS) ||
+			    (batch.body_len >= BULK_MAX_SIZE)) {
+				more = true;
+				break;
+			}
+			xstrcatat(batch.body, &pos, "{\"index\":{}}\n");
+			xstrcatat(batch.body, &pos, jnode->serialized_job);
+			xstrcatat(batch.body, &pos, "\n");
+			batch.body_len = pos - batch.body;
+			batch.jobs[batch.job_cnt++] = jnode;
+		}
+		list_iterator_destroy(iter);
+		first_pass = false;
+
+		if (!batch.job_cnt)
+			break;
+
+		(void) _index_bulk(&batch);
+		for (int i = 0; i < batch.job_cnt; i++) {
+			if (batch.jobs[i]->indexed) {
+				success_cnt++;
+			} else {
+				batch.jobs[i]->last_index_retry = now;
+				(*fail_cnt)++;
+				more = false;
+			}
+		}
+		(void) list_delete_all(jobslist, _find_indexed, NULL);
+	}
+
+	xfree(batch.body);
+	xfree(batch.jobs);
+
+	return success_cnt;
+}
+
+extern void *_process_jobs(void *x)
+{
 	struct timespec ts = {0, 0};
-	time_t now;
 
 	/* Wait for jobcomp_p_set_location log_url setup. */
 	slurm_mutex_lock(&location_mutex);
@@ -362,30 +490,21 @@ extern void *_process_jobs(void *x)
 	while (!thread_shutdown) {
 		int success_cnt = 0, fail_cnt = 0, wait_retry_cnt = 0;
 		sleep(1);
-		iter = list_iterator_create(jobslist);
-		while ((jnode = (struct job_node *)list_next(iter)) &&
-		       !thread_shutdown) {
-			now = time(NULL);
-			if ((jnode->last_index_retry == 0) ||
-			    (difftime(now, jnode->last_index_retry) >=
-					INDEX_RETRY_INTERVAL)) {
-				if ((_index_job(jnode->serialized_job) ==
-				     SLURM_SUCCESS)) {
-					list_delete_item(iter);
-					success_cnt++;
-				} else {
-					jnode->last_index_retry = now;
-					fail_cnt++;
-				}
-			} else
-				wait_retry_cnt++;
-		}
-		list_iterator_destroy(iter);
+		success_cnt = _index_pending_jobs(&fail_cnt, &wait_retry_cnt);
 		if ((success_cnt || fail_cnt))
 			log_flag(JOBCOMP, "index success:%d fail:%d wait_retry:%d",
 				 success_cnt, fail_cnt,
 				 wait_retry_cnt);
 	}
+
+	slurm_mutex_lock(&location_mutex);
+	if (curl_handle)
+		curl_easy_cleanup(curl_handle);
+	curl_handle = NULL;
+	curl_slist_free_all(bulk_headers);
+	bulk_headers = NULL;
+	slurm_mutex_unlock(&location_mutex);
+
 	return NULL;
 }
 
@@ -410,23 +529,33 @@ extern int init(void)
 		return rc;
 	}
 
+	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+		error("%s: curl_global_init: %m", plugin_type);
+		return SLURM_ERROR;
+	}
+
 	jobslist = list_create(_jobslist_del);
 	slurm_thread_create(&job_handler_thread, _process_jobs, NULL);
 	slurm_mutex_lock(&pend_jobs_lock);
 	(void) _load_pending_jobs();
 	slurm_mutex_unlock(&pend_jobs_lock);
+	jobcomp_common_serializer_init(_enqueue_job);
 
 	return SLURM_SUCCESS;
 }
 
 extern int fini(void)
 {
+	/* Flush queued records into jobslist so they are saved below */
+	jobcomp_common_serializer_fini();
 	thread_shutdown = true;
 	slurm_thread_join(job_handler_thread);
 
 	_save_state();
 	FREE_NULL_LIST(jobslist);
 	xfree(log_url);
+	xfree(bulk_url);
+	curl_global_cleanup();
 	return SLURM_SUCCESS;
 }
 
@@ -448,6 +577,8 @@ extern int jobcomp_p_set_location(void)
 	if (log_url)
 		xfree(log_url);
 	log_url = xstrdup(location);
+	xfree(bulk_url);
+	bulk_url = _get_bulk_url(log_url);
 	slurm_cond_broadcast(&location_cond);
 	slurm_mutex_unlock(&location_mutex);
 
@@ -72,6 +72,11 @@ const char plugin_name[]       	= "Job completion logging Kafka plugin";
 const char plugin_type[]       	= "jobcomp/kafka";
 const uint32_t plugin_version	= SLURM_VERSION_NUMBER;
 
+static void _send_job_record(uint32_t job_id, char **json)
+{
+	jobcomp_kafka_message_produce(job_id, *json);
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
@@ -96,11 +101,14 @@ extern int init(void)
 	if ((rc = jobcomp_kafka_message_init()))
 		return rc;
 
+	jobcomp_common_serializer_init(_send_job_record);
+
 	return rc;
 }
 
 extern int fini(void)
 {
+	jobcomp_common_serializer_fini();
 	jobcomp_kafka_message_fini();
 	jobcomp_kafka_conf_fini();
 
@@ -126,33 +134,13 @@ extern int jobcomp_p_set_location(void)
 
 extern int jobcomp_p_log_record(job_record_t *job_ptr)
 {
-	int rc = SLURM_SUCCESS;
-	char *job_record_serialized = NULL;
-	data_t *job_record_data = NULL;
-
-	if (!(job_record_data = jobcomp_common_job_record_to_data(job_ptr))) {
+	if (jobcomp_common_serialize_async(job_ptr)) {
 		error("%s: unable to build data_t. %pJ discarded",
 		      plugin_type, job_ptr);
-		rc = SLURM_ERROR;
-		goto end;
+		return SLURM_ERROR;
 	}
 
-	if ((rc = serialize_g_data_to_string(&job_record_serialized,
-					     NULL,
-					     job_record_data,
-					     MIME_TYPE_JSON,
-					     SER_FLAGS_COMPACT))) {
-		error("%s: %pJ discarded, unable to serialize to JSON: %s",
-		      plugin_type, job_ptr, slurm_strerror(rc));
-		goto end;
-	}
-
-	jobcomp_kafka_message_produce(job_ptr->job_id, job_record_serialized);
-
-end:
-	xfree(job_record_serialized);
-	FREE_NULL_DATA(job_record_data);
-	return rc;
+	return SLURM_SUCCESS;
 }
 
 extern list_t *jobcomp_p_get_jobs(void *job_cond)
@@ -75,21 +75,34 @@ static int no_dup_keys = 0;
 #define VAL_INDEX(i) (i * 2 + 1)
 #define HASH(key) ( _hash(key) % hash_size)
 
+/*
+ * FNV-1a. Every character of the key affects the result, so keys that
+ * only differ in a rank number embedded in the middle of the key still
+ * spread over the buckets.
+ */
 inline static uint32_t
 _hash(char *key)
 {
-	int len, i;
-	uint32_t hash = 0;
-	uint8_t shift;
-
-	len = strlen(key);
-	for (i = 0; i < len; i ++) {
-		shift = (uint8_t)(hash >> 24);
-		hash = (hash << 8) | (uint32_t)(shift ^ (uint8_t)key[i]);
+	uint32_t hash = 2166136261U;
+
+	for (; *key; key++) {
+		hash ^= (uint8_t) *key;
+		hash *= 16777619U;
 	}
 	return hash;
 }
 
+/* make room for size more bytes in temp_kvs_buf, growing geometrically */
+static void
+_temp_kvs_reserve(uint32_t size)
+{
+	if (temp_kvs_cnt + size <= temp_kvs_size)
+		return;
+
+	temp_kvs_size = MAX(temp_kvs_size * 2, temp_kvs_cnt + size);
+	xrealloc(temp_kvs_buf, temp_kvs_size);
+}
+
 extern int
 temp_kvs_init(void)
 {
@@ -124,10 +137,7 @@ temp_kvs_init(void)
 		pack32(kvs_seq, buf);
 	}
 	size = get_buf_offset(buf);
-	if (temp_kvs_cnt + size > temp_kvs_size) {
-		temp_kvs_size += TEMP_KVS_SIZE_INC;
-		xrealloc(temp_kvs_buf, temp_kvs_size);
-	}
+	_temp_kvs_reserve(size);
 	memcpy(&temp_kvs_buf[temp_kvs_cnt], get_buf_data(buf), size);
 	temp_kvs_cnt += size;
 	FREE_NULL_BUFFER(buf);
@@ -147,14 +157,11 @@ temp_kvs_add(char *key, char *val)
 	if ( key == NULL || val == NULL )
 		return SLURM_SUCCESS;
 
-	buf = init_buf(PMI2_MAX_KEYLEN + PMI2_MAX_VALLEN + 2 * sizeof(uint32_t));
+	buf = init_buf(strlen(key) + strlen(val) + 2 + 2 * sizeof(uint32_t));
 	packstr(key, buf);
 	packstr(val, buf);
 	size = get_buf_offset(buf);
-	if (temp_kvs_cnt + size > temp_kvs_size) {
-		temp_kvs_size += TEMP_KVS_SIZE_INC;
-		xrealloc(temp_kvs_buf, temp_kvs_size);
-	}
+	_temp_kvs_reserve(size);
 	memcpy(&temp_kvs_buf[temp_kvs_cnt], get_buf_data(buf), size);
 	temp_kvs_cnt += size;
 	FREE_NULL_BUFFER(buf);
@@ -174,10 +181,7 @@ extern int temp_kvs_merge(buf_t *buf)
 	data = get_buf_data(buf);
 	offset = get_buf_offset(buf);
 
-	if (temp_kvs_cnt + size > temp_kvs_size) {
-		temp_kvs_size += size;
-		xrealloc(temp_kvs_buf, temp_kvs_size);
-	}
+	_temp_kvs_reserve(size);
 	memcpy(&temp_kvs_buf[temp_kvs_cnt], &data[offset], size);
 	temp_kvs_cnt += size;
 
@@ -319,6 +323,7 @@ kvs_clear(void)
 			xfree (bucket->pairs[KEY_INDEX(j)]);
 			xfree (bucket->pairs[VAL_INDEX(j)]);
 		}
+		xfree(bucket->pairs);
 	}
 	xfree(kvs_hash);
 
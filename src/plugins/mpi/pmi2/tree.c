@@ -201,12 +201,10 @@ static int _handle_kvs_fence_resp(int fd, buf_t *buf)
 	debug3("mpi/pmi2: buf length: %u", temp32);
 	/* put kvs into local hash */
 	while (remaining_buf(buf) > 0) {
-		safe_unpackstr_xmalloc(&key, &temp32, buf);
-		safe_unpackstr_xmalloc(&val, &temp32, buf);
+		/* kvs_put() copies them, point into buf instead */
+		safe_unpackmem_ptr(&key, &temp32, buf);
+		safe_unpackmem_ptr(&val, &temp32, buf);
 		kvs_put(key, val);
-		//temp32 = remaining_buf(buf);
-		xfree(key);
-		xfree(val);
 	}
 
 resp:
@@ -756,6 +756,10 @@ extern int pmixp_lib_fence(const pmix_proc_t procs[], size_t nprocs,
 		 * Practice shows the Tree algorithm has better performance
 		 * performance for fence with zero data. Only use the Ring
 		 * algorithm if there is data to collect.
+		 *
+		 * Every node must pick the same algorithm for a given fence,
+		 * so the choice can not depend on anything that differs
+		 * between nodes, such as the size of the local contribution.
 		 */
 		if (collect && (ndata > 0)) {
 			type = PMIXP_COLL_TYPE_FENCE_RING;
@@ -151,6 +151,10 @@ int pmixp_coll_contrib_local(pmixp_coll_t *coll, pmixp_coll_type_t type,
 	PMIXP_DEBUG("%p: %s seq=%d, size=%lu", coll, pmixp_coll_type2str(type),
 		    coll->seq, ndata);
 #endif
+	slurm_mutex_lock(&coll->lock);
+	gettimeofday(&coll->stats.start, NULL);
+	slurm_mutex_unlock(&coll->lock);
+
 	switch (type) {
 	case PMIXP_COLL_TYPE_FENCE_TREE:
 		ret = pmixp_coll_tree_local(coll, data, ndata,
@@ -232,6 +236,13 @@ void pmixp_coll_free(pmixp_coll_t *coll)
 #ifdef PMIXP_COLL_DEBUG
 	hostlist_destroy(coll->peers_hl);
 #endif
+	if (coll->stats.cnt) {
+		PMIXP_DEBUG("%p: %s: %u fences over %d nodes, avg %"PRIu64" usec, max %"PRIu64" usec, %"PRIu64" bytes delivered",
+			    coll, pmixp_coll_type2str(coll->type),
+			    coll->stats.cnt, coll->peers_cnt,
+			    coll->stats.usec_total / coll->stats.cnt,
+			    coll->stats.usec_max, coll->stats.bytes);
+	}
 	/* check for collective in a not-SYNC state - something went wrong */
 	switch(coll->type) {
 	case PMIXP_COLL_TYPE_FENCE_TREE:
@@ -261,6 +272,30 @@ void pmixp_coll_free(pmixp_coll_t *coll)
 	xfree(coll);
 }
 
+/*
+ * Account for the local delivery of a fence result. The time is measured
+ * from the local contribution, so it covers the whole wireup cost seen by
+ * the local processes. Must be called with coll->lock held.
+ */
+void pmixp_coll_stats_done(pmixp_coll_t *coll, size_t size)
+{
+	struct timeval now;
+	uint64_t usec;
+
+	gettimeofday(&now, NULL);
+	usec = (now.tv_sec - coll->stats.start.tv_sec) * USEC_IN_SEC +
+		now.tv_usec - coll->stats.start.tv_usec;
+
+	coll->stats.cnt++;
+	coll->stats.usec_total += usec;
+	coll->stats.usec_max = MAX(coll->stats.usec_max, usec);
+	coll->stats.bytes += size;
+
+	PMIXP_DEBUG("%p: %s seq=%u done: %d nodes, %lu bytes, %"PRIu64" usec",
+		    coll, pmixp_coll_type2str(coll->type), coll->seq,
+		    coll->peers_cnt, size, usec);
+}
+
 int pmixp_coll_belong_chk(const pmix_proc_t *procs, size_t nprocs)
 {
 	int i;
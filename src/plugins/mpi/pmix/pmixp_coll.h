@@ -283,6 +283,15 @@ typedef struct pmixp_coll_s {
 	/* timestamp for stale collectives detection */
 	time_t ts, ts_next;
 
+	/* fence timing statistics */
+	struct {
+		struct timeval start;
+		uint32_t cnt;
+		uint64_t usec_total;
+		uint64_t usec_max;
+		uint64_t bytes;
+	} stats;
+
 	/* coll states */
 	union {
 		pmixp_coll_tree_t tree;
@@ -343,6 +352,7 @@ int pmixp_coll_contrib_local(pmixp_coll_t *coll, pmixp_coll_type_t type,
 			     char *data, size_t ndata,
 			     void *cbfunc, void *cbdata);
 void pmixp_coll_free(pmixp_coll_t *coll);
+void pmixp_coll_stats_done(pmixp_coll_t *coll, size_t size);
 void pmixp_coll_localcb_nodata(pmixp_coll_t *coll, int status);
 int pmixp_coll_belong_chk(const pmix_proc_t *procs, size_t nprocs);
 void pmixp_coll_log(pmixp_coll_t *coll);
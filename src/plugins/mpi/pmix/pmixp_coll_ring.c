@@ -354,6 +354,7 @@ static void _invoke_callback(pmixp_coll_ring_ctx_t *coll_ctx)
 	cbdata->coll_ctx = coll_ctx;
 	cbdata->buf = coll_ctx->ring_buf;
 	cbdata->seq = coll_ctx->seq;
+	pmixp_coll_stats_done(coll, data_sz);
 	pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS,
 			       data, data_sz,
 			       coll->cbdata, _libpmix_cb, (void *)cbdata);
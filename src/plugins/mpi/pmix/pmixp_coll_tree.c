@@ -693,6 +693,7 @@ static int _progress_ufwd(pmixp_coll_t *coll)
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
 		tree->dfwd_cb_wait++;
+		pmixp_coll_stats_done(coll, size);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS,
 				       data, size, coll->cbdata,
 				       _libpmix_cb, (void*)cbdata);
@@ -783,6 +784,7 @@ static int _progress_ufwd_wpc(pmixp_coll_t *coll)
 		char *data = get_buf_data(tree->dfwd_buf) + tree->dfwd_offset;
 		size_t size = get_buf_offset(tree->dfwd_buf) -
 			tree->dfwd_offset;
+		pmixp_coll_stats_done(coll, size);
 		pmixp_lib_modex_invoke(coll->cbfunc, SLURM_SUCCESS, data, size,
 				       coll->cbdata, _libpmix_cb,
 				       (void *)cbdata);
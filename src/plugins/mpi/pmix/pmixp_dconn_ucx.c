@@ -424,7 +424,7 @@ static bool _ucx_progress()
 		}
 		events_observed++;
 
-		char *msg = xmalloc(info_tag.length);
+		char *msg = xmalloc_nz(info_tag.length);
 		pmixp_ucx_req_t *req = (pmixp_ucx_req_t*)
 				ucp_tag_msg_recv_nb(ucp_worker, (void*)msg,
 						    info_tag.length,
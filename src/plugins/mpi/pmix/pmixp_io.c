@@ -262,7 +262,7 @@ static inline int _rcvd_swithch_to_body(pmixp_io_engine_t *eng)
 	}
 	eng->rcvd_pay_size = eng->h.payload_size_cb(eng->rcvd_hdr_host);
 	if (0 != eng->rcvd_pay_size) {
-		eng->rcvd_payload = xmalloc(eng->rcvd_pay_size);
+		eng->rcvd_payload = xmalloc_nz(eng->rcvd_pay_size);
 	}
 	return 0;
 }
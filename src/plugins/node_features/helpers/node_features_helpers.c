@@ -718,13 +718,77 @@ extern int node_features_p_job_valid(char *job_features, list_t *feature_list)
 	return SLURM_SUCCESS;
 }
 
+/* Features of one node_set() request handled by the same helper program */
+typedef struct {
+	list_t *features;	/* plugin_feature_t, in requested order */
+	const char *helper;
+	int rc;
+	pthread_t tid;
+} helper_set_t;
+
+static void _helper_set_destroy(void *x)
+{
+	helper_set_t *set = x;
+
+	FREE_NULL_LIST(set->features);
+	xfree(set);
+}
+
+static int _cmp_helper_set(void *x, void *key)
+{
+	helper_set_t *set = x;
+	return !xstrcmp(set->helper, key);
+}
+
+static void *_helper_set_thread(void *arg)
+{
+	helper_set_t *set = arg;
+	plugin_feature_t *feature;
+	list_itr_t *itr = list_iterator_create(set->features);
+
+	while ((feature = list_next(itr))) {
+		if ((set->rc = _feature_set_state(feature)) != SLURM_SUCCESS)
+			break;
+	}
+	list_iterator_destroy(itr);
+
+	return NULL;
+}
+
+static int _foreach_helper_set_start(void *x, void *arg)
+{
+	helper_set_t *set = x;
+
+	slurm_thread_create(&set->tid, _helper_set_thread, set);
+
+	return 0;
+}
+
+static int _foreach_helper_set_join(void *x, void *arg)
+{
+	helper_set_t *set = x;
+	int *rc = arg;
+
+	slurm_thread_join(set->tid);
+	if (set->rc != SLURM_SUCCESS)
+		*rc = set->rc;
+
+	return 0;
+}
+
 extern int node_features_p_node_set(char *active_features)
 {
 	char *tmp, *saveptr;
 	char *input = NULL;
-	const plugin_feature_t *feature = NULL;
-	int rc = SLURM_ERROR;
+	plugin_feature_t *feature = NULL;
+	helper_set_t *set;
+	list_t *helper_sets = list_create(_helper_set_destroy);
+	int rc = SLURM_SUCCESS;
 
+	/*
+	 * Features handled by the same helper are set in the requested order,
+	 * different helpers (e.g. GPU and NUMA modes) are run concurrently.
+	 */
 	input = xstrdup(active_features);
 	for (tmp = strtok_r(input, ",", &saveptr); tmp;
 	     tmp = strtok_r(NULL, ",", &saveptr)) {
@@ -734,15 +798,31 @@ extern int node_features_p_node_set(char *active_features)
 			continue;
 		}
 
-		if (_feature_set_state(feature) != SLURM_SUCCESS) {
-			active_features[0] = '\0';
-			goto fini;
+		if (!(set = list_find_first(helper_sets, _cmp_helper_set,
+					    (void *) feature->helper))) {
+			set = xmalloc(sizeof(*set));
+			set->features = list_create(NULL);
+			set->helper = feature->helper;
+			list_append(helper_sets, set);
 		}
+		list_append(set->features, feature);
 	}
 
-	rc = SLURM_SUCCESS;
+	if (list_count(helper_sets) == 1) {
+		set = list_peek(helper_sets);
+		(void) _helper_set_thread(set);
+		rc = set->rc;
+	} else {
+		list_for_each(helper_sets, _foreach_helper_set_start, NULL);
+		list_for_each(helper_sets, _foreach_helper_set_join, &rc);
+	}
+
+	if (rc != SLURM_SUCCESS) {
+		active_features[0] = '\0';
+		rc = SLURM_ERROR;
+	}
 
-fini:
+	FREE_NULL_LIST(helper_sets);
 	xfree(input);
 	return rc;
 }
@@ -773,18 +853,26 @@ static int _foreach_check_duplicates(void *x, void *y)
 typedef struct {
 	char **avail_modes;
 	List all_current;
+	List helpers;
 } _foreach_modes_t;
 
 static int _foreach_helper_get_modes(void *x, void *y)
 {
 	char **avail_modes = ((_foreach_modes_t *)y)->avail_modes;
 	List all_current = ((_foreach_modes_t *)y)->all_current;
+	List helpers = ((_foreach_modes_t *)y)->helpers;
 	plugin_feature_t *feature = (plugin_feature_t *)x;
-
-	List current = _feature_get_state(feature);
+	List current;
 
 	xstrfmtcat(*avail_modes, "%s%s", (*avail_modes ? "," : ""), feature->name);
 
+	/* A helper reports all of its active features, only ask it once */
+	if (list_find_first(helpers, _cmp_str, (void *) feature->helper))
+		return 0;
+	list_append(helpers, (void *) feature->helper);
+
+	current = _feature_get_state(feature);
+
 	if (!current || list_is_empty(current)) {
 		FREE_NULL_LIST(current);
 		return 0;
@@ -814,11 +902,13 @@ extern void node_features_p_node_state(char **avail_modes, char **current_mode)
 
 	args.all_current = all_current;
 	args.avail_modes = avail_modes;
+	args.helpers = list_create(NULL);
 
 	/*
 	 * Call every helper with no args to get list of active features
 	 */
 	list_for_each(helper_features, _foreach_helper_get_modes, &args);
+	FREE_NULL_LIST(args.helpers);
 
 	filtered_modes = list_create(xfree_ptr);
 
@@ -47,6 +47,7 @@
 #include "src/interfaces/prep.h"
 #include "src/common/run_command.h"
 #include "src/common/spank.h"
+#include "src/common/timers.h"
 #include "src/common/track_script.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
@@ -63,6 +64,13 @@ extern slurmd_conf_t *conf __attribute__((weak_import));
 slurmd_conf_t *conf = NULL;
 #endif
 
+typedef struct {
+	run_command_args_t args;
+	char *cmd_argv[2];
+	int status;
+	pthread_t tid;
+} script_run_t;
+
 static char **_build_env(job_env_t *job_env, slurm_cred_t *cred,
 			 bool is_epilog);
 static int _run_spank_job_script(const char *mode, char **env, uint32_t job_id);
@@ -115,10 +123,16 @@ static int _run_subpath_command(void *x, void *arg)
 
 	xassert(run_command_args->script_argv);
 
+	DEF_TIMERS;
+
 	run_command_args->script_path = x;
 	run_command_args->script_argv[0] = x;
 
+	START_TIMER;
 	resp = run_command(run_command_args);
+	END_TIMER;
+	debug2("%s %s ran for %s", run_command_args->script_type,
+	       run_command_args->script_path, TIME_STR);
 
 	if (*run_command_args->status) {
 		if (WIFEXITED(*run_command_args->status))
@@ -147,6 +161,47 @@ static int _run_subpath_command(void *x, void *arg)
 	return rc;
 }
 
+static void *_run_subpath_thread(void *arg)
+{
+	script_run_t *run = arg;
+
+	(void) _run_subpath_command((void *) run->args.script_path,
+				    &run->args);
+
+	return NULL;
+}
+
+/*
+ * Run every script of path_list at the same time and wait for all of them.
+ * The status of the first failed script (in list order) is returned through
+ * args->status.
+ */
+static void _run_subpath_parallel(List path_list, run_command_args_t *args)
+{
+	int cnt = list_count(path_list), i = 0;
+	script_run_t *runs = xcalloc(cnt, sizeof(*runs));
+	list_itr_t *itr = list_iterator_create(path_list);
+	char *path;
+
+	while ((path = list_next(itr))) {
+		script_run_t *run = &runs[i++];
+
+		run->args = *args;
+		run->args.script_argv = run->cmd_argv;
+		run->args.script_path = path;
+		run->args.status = &run->status;
+		slurm_thread_create(&run->tid, _run_subpath_thread, run);
+	}
+	list_iterator_destroy(itr);
+
+	for (i = 0; i < cnt; i++) {
+		slurm_thread_join(runs[i].tid);
+		if (runs[i].status && !*args->status)
+			*args->status = runs[i].status;
+	}
+	xfree(runs);
+}
+
 extern int slurmd_script(job_env_t *job_env, slurm_cred_t *cred,
 			 bool is_epilog)
 {
@@ -194,8 +249,12 @@ extern int slurmd_script(job_env_t *job_env, slurm_cred_t *cred,
 		if (!(path_list = _script_list_create(path)))
 			return error("%s: Unable to create list of paths [%s]",
 				     name, path);
-		list_for_each(
-			path_list, _run_subpath_command, &run_command_args);
+		if ((slurm_conf.prolog_flags & PROLOG_FLAG_PARALLEL_SCRIPTS) &&
+		    (list_count(path_list) > 1))
+			_run_subpath_parallel(path_list, &run_command_args);
+		else
+			list_for_each(path_list, _run_subpath_command,
+				      &run_command_args);
 		FREE_NULL_LIST(path_list);
 		if (status)
 			rc = status;
@@ -159,6 +159,17 @@ static int _cmp_level_fs(const void *x,
 }
 
 
+/* Return true if siblings[0 .. count - 1] are already in _cmp_level_fs order */
+static bool _sorted_level_fs(slurmdb_assoc_rec_t **siblings, size_t count)
+{
+	for (size_t i = 1; i < count; i++) {
+		if (_cmp_level_fs(&siblings[i - 1], &siblings[i]) > 0)
+			return false;
+	}
+
+	return true;
+}
+
 /* Calculate LF = S / U for an association.
  *
  * U is usage_raw / parent's usage_raw.
@@ -343,8 +354,14 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 	for (i = 0; (assoc = siblings[i]); i++)
 		_calc_assoc_fs(assoc);
 
-	/* Sort children by level_fs */
-	qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
+	/*
+	 * Sort children by level_fs. Levels whose children are already in
+	 * order (e.g. single child, or all siblings without usage) are common
+	 * and only need the linear check.
+	 */
+	if (!_sorted_level_fs(siblings, i))
+		qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *),
+		      _cmp_level_fs);
 
 	/* Iterate through children in sorted order. If it's a user, calculate
 	 * fs_factor, otherwise recurse. */
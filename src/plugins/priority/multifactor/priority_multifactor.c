@@ -431,23 +431,21 @@ static int _set_children_usage_efctv(List children_list)
 /* job_ptr should already have the partition priority and such added here
  * before had we will be adding to it
  */
+/* NOTE: assoc_mgr association read lock must be held */
 static double _get_fairshare_priority(job_record_t *job_ptr)
 {
 	slurmdb_assoc_rec_t *job_assoc;
 	slurmdb_assoc_rec_t *fs_assoc = NULL;
 	double priority_fs = 0.0;
-	assoc_mgr_lock_t locks = { READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
-				   NO_LOCK, NO_LOCK, NO_LOCK };
+
+	xassert(verify_assoc_lock(ASSOC_LOCK, READ_LOCK));
 
 	if (!calc_fairshare)
 		return 0;
 
-	assoc_mgr_lock(&locks);
-
 	job_assoc = job_ptr->assoc_ptr;
 
 	if (!job_assoc) {
-		assoc_mgr_unlock(&locks);
 		error("Job %u has no association.  Unable to "
 		      "compute fairshare.", job_ptr->job_id);
 		return 0;
@@ -477,7 +475,6 @@ static double _get_fairshare_priority(job_record_t *job_ptr)
 			 fs_assoc->usage->usage_efctv,
 			 fs_assoc->usage->shares_norm, priority_fs);
 	}
-	assoc_mgr_unlock(&locks);
 
 	return priority_fs;
 }
@@ -1999,6 +1996,22 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 	if (!job_ptr->prio_factors) {
 		job_ptr->prio_factors =
 			xmalloc(sizeof(priority_factors_t));
+	} else if (weight_tres && job_ptr->prio_factors->priority_tres &&
+		   (job_ptr->prio_factors->tres_cnt == slurmctld_tres_cnt)) {
+		/*
+		 * Reuse the TRES arrays, this is called for every pending job
+		 * on each decay cycle.
+		 */
+		double *priority_tres = job_ptr->prio_factors->priority_tres;
+		double *tres_weights = job_ptr->prio_factors->tres_weights;
+
+		memset(job_ptr->prio_factors, 0, sizeof(priority_factors_t));
+		memset(priority_tres, 0, sizeof(double) * slurmctld_tres_cnt);
+		memcpy(tres_weights, weight_tres,
+		       sizeof(double) * slurmctld_tres_cnt);
+		job_ptr->prio_factors->priority_tres = priority_tres;
+		job_ptr->prio_factors->tres_weights = tres_weights;
+		job_ptr->prio_factors->tres_cnt = slurmctld_tres_cnt;
 	} else {
 		xfree(job_ptr->prio_factors->tres_weights);
 		xfree(job_ptr->prio_factors->priority_tres);
@@ -2022,11 +2035,6 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 			job_ptr->prio_factors->priority_age = 1.0;
 	}
 
-	if (job_ptr->assoc_ptr && weight_fs) {
-		job_ptr->prio_factors->priority_fs =
-			_get_fairshare_priority(job_ptr);
-	}
-
 	/* FIXME: this should work off the product of TRESBillingWeights */
 	if (weight_js && active_node_record_count && cluster_cpus) {
 		uint32_t cpu_cnt = 0, min_nodes = 1;
@@ -2109,6 +2117,11 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 	job_ptr->prio_factors->priority_site = job_ptr->site_factor;
 
 	assoc_mgr_lock(&locks);
+	if (job_ptr->assoc_ptr && weight_fs) {
+		job_ptr->prio_factors->priority_fs =
+			_get_fairshare_priority(job_ptr);
+	}
+
 	if (job_ptr->assoc_ptr && weight_assoc)
 		job_ptr->prio_factors->priority_assoc =
 			(flags & PRIORITY_FLAGS_NO_NORMAL_ASSOC) ?
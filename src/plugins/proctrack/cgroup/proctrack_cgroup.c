@@ -197,6 +197,13 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 	/* start by resuming in case of SIGKILL */
 	if (signal == SIGKILL) {
 		cgroup_g_step_resume();
+		/*
+		 * Kill all the user processes at once if the kernel allows it,
+		 * so that forking processes can't escape. The loop below still
+		 * takes care of anything else left in the step.
+		 */
+		if (cgroup_g_has_feature(CG_KILL_BUTTON))
+			cgroup_g_signal(SIGKILL);
 	}
 
 	for (i = 0 ; i<npids ; i++) {
@@ -258,7 +265,8 @@ extern int proctrack_p_wait(uint64_t cont_id)
 	int delay = 1;
 	time_t start = time(NULL), now;
 	pid_t *pids = NULL;
-	int npids = 0, rc;
+	int npids = 0, rc, wait_rc;
+	bool user_empty = false;
 
 	if (cont_id == 0 || cont_id == 1)
 		return SLURM_ERROR;
@@ -283,7 +291,21 @@ extern int proctrack_p_wait(uint64_t cont_id)
 		 * not killing slurmstepd processes (ourselves).
 		 */
 		proctrack_p_signal(cont_id, SIGKILL);
-		sleep(delay);
+		/*
+		 * Wake up as soon as the user processes are gone instead of
+		 * sleeping the whole delay, if the plugin can tell us. Once
+		 * they are gone, whatever is left is outside of the user
+		 * cgroup, so go back to sleeping.
+		 */
+		if (user_empty) {
+			sleep(delay);
+		} else {
+			wait_rc = cgroup_g_step_wait_empty(delay * 1000);
+			if (wait_rc == SLURM_SUCCESS)
+				user_empty = true;
+			else if (wait_rc != SLURM_ERROR)
+				sleep(delay);
+		}
 		if (delay < 32)
 			delay *= 2;
 		xfree(pids);
@@ -139,8 +139,31 @@ typedef struct {
 typedef struct {
 	node_space_map_t *node_space;
 	int *node_space_recs;
+	xhash_t *running_ends;	/* bf_running_end_t records */
 } node_space_handler_t;
 
+/*
+ * Nodes of running jobs sharing the same (resolution aligned) end time,
+ * reserved in the node_space table with a single _add_reservation() call.
+ */
+typedef struct {
+	time_t end_time;
+	bitstr_t *node_bitmap;
+} bf_running_end_t;
+
+/*
+ * Earliest start time found for pending jobs sharing the same request shape
+ * (see _bf_shape_key()) during one backfill cycle. Resources available in the
+ * node_space table only shrink as jobs are started or planned, so a shape
+ * that could not start before start_time can not start earlier for the next
+ * job of that shape either.
+ */
+typedef struct {
+	char *key;
+	bool no_start;		/* Unable to start within backfill window */
+	time_t start_time;
+} bf_shape_t;
+
 /*
  * HetJob scheduling structures
  * NOTE: An individial hetjob component can be submitted to multiple
@@ -201,6 +224,7 @@ static List deadlock_global_list;
 static bool bf_hetjob_immediate = false;
 static uint16_t bf_hetjob_prio = 0;
 static bool bf_one_resv_per_job = false;
+static bool bf_shape_cache = false;
 static uint32_t job_start_cnt = 0;
 static uint32_t job_test_cnt = 0;
 static int max_backfill_job_cnt = DEF_BF_MAX_JOB_TEST;
@@ -210,6 +234,7 @@ static int max_backfill_job_per_user = 0;
 static int max_backfill_job_per_user_part = 0;
 static int max_backfill_jobs_start = 0;
 static bool backfill_continue = false;
+static bool bf_yield_revalidate = false;
 static bool assoc_limit_stop = false;
 static int max_rpc_cnt = 0;
 static int yield_interval = YIELD_INTERVAL;
@@ -266,7 +291,7 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 static int  _try_sched(job_record_t *job_ptr, bitstr_t **avail_bitmap,
 		       uint32_t min_nodes, uint32_t max_nodes,
 		       uint32_t req_nodes, resv_exc_t *resv_exc_ptr);
-static int  _yield_locks(int64_t usec);
+static int  _yield_locks(int64_t usec, node_space_map_t *node_space);
 static void _bf_map_key_id(void *item, const char **key, uint32_t *key_len);
 static void _bf_map_free(void *item);
 
@@ -897,6 +922,11 @@ static void _load_config(void)
 		backfill_continue = false;
 	}
 
+	if (xstrcasestr(sched_params, "bf_yield_revalidate"))
+		bf_yield_revalidate = true;
+	else
+		bf_yield_revalidate = false;
+
 	if (xstrcasestr(sched_params, "assoc_limit_stop")) {
 		assoc_limit_stop = true;
 	} else {
@@ -955,6 +985,11 @@ static void _load_config(void)
 	else
 		bf_one_resv_per_job = false;
 
+	if (xstrcasestr(sched_params, "bf_shape_cache"))
+		bf_shape_cache = true;
+	else
+		bf_shape_cache = false;
+
 	if (xstrcasestr(sched_params, "bf_running_job_reserve"))
 		bf_running_job_reserve = true;
 	else
@@ -1138,11 +1173,28 @@ static int _clear_job_estimates(void *x, void *arg)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Remove nodes which are no longer available from every record of the
+ * node_space table so the reservations planned so far remain valid.
+ */
+static void _revalidate_node_space(node_space_map_t *node_space)
+{
+	bitstr_t *usable_bitmap = bit_copy(avail_node_bitmap);
+
+	bit_or(usable_bitmap, rs_node_bitmap);
+	for (int j = 0; ; ) {
+		bit_and(node_space[j].avail_bitmap, usable_bitmap);
+		if ((j = node_space[j].next) == 0)
+			break;
+	}
+	FREE_NULL_BITMAP(usable_bitmap);
+}
+
 /*
  * Return non-zero to break the backfill loop if change in job, node,
  * reservation or partition state or the backfill scheduler needs to be stopped.
  */
-static int _yield_locks(int64_t usec)
+static int _yield_locks(int64_t usec, node_space_map_t *node_space)
 {
 	slurmctld_lock_t all_locks = {
 		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
@@ -1176,15 +1228,32 @@ static int _yield_locks(int64_t usec)
 		load_config = true;
 	slurm_mutex_unlock(&config_lock);
 
-	if (((!backfill_continue) && ((last_job_update != job_update) ||
-	     (last_node_update != node_update))) ||
-	    (last_part_update != part_update) ||
+	if ((last_part_update != part_update) ||
 	    (slurm_conf.last_update != config_update) ||
 	    (last_resv_update != resv_update) ||
 	    stop_backfill || load_config)
 		return 1;
-	else
+
+	if (backfill_continue)
 		return 0;
+
+	if ((last_job_update == job_update) &&
+	    (last_node_update == node_update))
+		return 0;
+
+	if (!bf_yield_revalidate)
+		return 1;
+
+	/*
+	 * Queue entries are validated again as they are popped, and the
+	 * select plugin sees current node usage. Only nodes that went away
+	 * need to be dropped from the reservations planned so far.
+	 */
+	if (last_node_update != node_update)
+		_revalidate_node_space(node_space);
+	log_flag(BACKFILL, "job or node state changed during yield, continuing with revalidated node_space");
+
+	return 0;
 }
 
 /* Test if this job still has access to the specified partition. The job's
@@ -1475,6 +1544,26 @@ static int _bf_reserve_running(void *x, void *arg)
 
 	end_time = (end_time / backfill_resolution) * backfill_resolution;
 
+	if (!preemptable && !licenses && ns_h->running_ends) {
+		/*
+		 * Many running jobs tend to end in the same backfill
+		 * resolution slot. Merge their nodes and reserve them all at
+		 * once from _bf_reserve_running_ends().
+		 */
+		bf_running_end_t *running_end;
+
+		if (!(running_end = xhash_get(ns_h->running_ends,
+					      (char *) &end_time,
+					      sizeof(end_time)))) {
+			running_end = xmalloc(sizeof(*running_end));
+			running_end->end_time = end_time;
+			running_end->node_bitmap = bit_alloc(node_record_count);
+			xhash_add(ns_h->running_ends, running_end);
+		}
+		bit_or(running_end->node_bitmap, job_ptr->node_bitmap);
+		return SLURM_SUCCESS;
+	}
+
 	if (preemptable || !whole) {
 		/* Reservation only needed for licenses. */
 		tmp_bitmap = bit_alloc(node_record_count);
@@ -1499,6 +1588,141 @@ static int _bf_reserve_running(void *x, void *arg)
 	return SLURM_SUCCESS;
 }
 
+static void _bf_running_end_key_id(void *item, const char **key,
+				   uint32_t *key_len)
+{
+	bf_running_end_t *running_end = item;
+
+	*key = (char *) &running_end->end_time;
+	*key_len = sizeof(running_end->end_time);
+}
+
+static void _bf_running_end_free(void *item)
+{
+	bf_running_end_t *running_end = item;
+
+	if (!running_end)
+		return;
+
+	FREE_NULL_BITMAP(running_end->node_bitmap);
+	xfree(running_end);
+}
+
+static void _bf_shape_key_id(void *item, const char **key, uint32_t *key_len)
+{
+	bf_shape_t *shape = item;
+
+	*key = shape->key;
+	*key_len = strlen(shape->key);
+}
+
+static void _bf_shape_free(void *item)
+{
+	bf_shape_t *shape = item;
+
+	if (!shape)
+		return;
+
+	xfree(shape->key);
+	xfree(shape);
+}
+
+/*
+ * Build a key describing everything the backfill test of this job depends
+ * upon. Returns NULL for jobs with requests not worth or not safe to share
+ * results for (features, node lists, reservations, licenses, etc.).
+ * Caller must xfree() the return value.
+ */
+static char *_bf_shape_key(job_record_t *job_ptr, uint32_t min_nodes,
+			   uint32_t max_nodes, uint32_t req_nodes,
+			   uint32_t time_limit, uint32_t job_no_reserve)
+{
+	job_details_t *detail_ptr = job_ptr->details;
+	multi_core_data_t *mc_ptr = detail_ptr->mc_ptr;
+	char *key = NULL;
+
+	if (job_ptr->het_job_id || job_ptr->burst_buffer ||
+	    job_ptr->license_list || job_ptr->resv_name ||
+	    job_ptr->resv_ptr || job_ptr->resv_list || job_ptr->time_min ||
+	    (job_ptr->deadline && (job_ptr->deadline != NO_VAL)) ||
+	    detail_ptr->arbitrary_tpn || detail_ptr->exc_node_bitmap ||
+	    detail_ptr->feature_list_use || detail_ptr->features_use ||
+	    detail_ptr->job_size_bitmap || detail_ptr->prefer ||
+	    detail_ptr->req_node_bitmap)
+		return NULL;
+
+	xstrfmtcat(key, "%p:%p:%p:%u:%u:%s:%"PRIx64":%u:%u:%u:%u:%u",
+		   job_ptr->part_ptr, job_ptr->assoc_ptr, job_ptr->qos_ptr,
+		   job_ptr->user_id, job_ptr->group_id, job_ptr->mcs_label,
+		   job_ptr->bit_flags, min_nodes, max_nodes, req_nodes,
+		   time_limit, job_no_reserve);
+	xstrfmtcat(key, ":%u:%u:%u:%u:%u:%u:%u:%u:%u:%u:%u:%u:%"PRIu64":%u",
+		   detail_ptr->contiguous, detail_ptr->core_spec,
+		   detail_ptr->cpus_per_task, detail_ptr->max_cpus,
+		   detail_ptr->min_cpus, detail_ptr->ntasks_per_node,
+		   detail_ptr->ntasks_per_tres, detail_ptr->num_tasks,
+		   detail_ptr->overcommit, detail_ptr->plane_size,
+		   detail_ptr->pn_min_cpus, detail_ptr->share_res,
+		   detail_ptr->pn_min_memory, detail_ptr->pn_min_tmp_disk);
+	xstrfmtcat(key, ":%u:%u", detail_ptr->task_dist,
+		   detail_ptr->whole_node);
+	if (mc_ptr)
+		xstrfmtcat(key, ":%u:%u:%u:%u:%u:%u:%u:%u:%u",
+			   mc_ptr->boards_per_node, mc_ptr->sockets_per_board,
+			   mc_ptr->sockets_per_node, mc_ptr->cores_per_socket,
+			   mc_ptr->threads_per_core, mc_ptr->ntasks_per_board,
+			   mc_ptr->ntasks_per_socket, mc_ptr->ntasks_per_core,
+			   mc_ptr->plane_size);
+	xstrfmtcat(key, ":%s:%s:%s:%s:%s:%s:%s",
+		   job_ptr->cpus_per_tres, job_ptr->mem_per_tres,
+		   job_ptr->tres_bind, job_ptr->tres_per_job,
+		   job_ptr->tres_per_node, job_ptr->tres_per_socket,
+		   job_ptr->tres_per_task);
+
+	return key;
+}
+
+/*
+ * Record the earliest start time possible for jobs of this shape, or that
+ * they can not start at all if no_start is set. Consumes *shape_key.
+ */
+static void _bf_shape_set(xhash_t *shape_map, char **shape_key,
+			  time_t start_time, bool no_start)
+{
+	bf_shape_t *shape;
+
+	if (!*shape_key)
+		return;
+
+	if ((shape = xhash_get_str(shape_map, *shape_key))) {
+		xfree(*shape_key);
+	} else {
+		shape = xmalloc(sizeof(*shape));
+		shape->key = *shape_key;
+		*shape_key = NULL;
+		xhash_add(shape_map, shape);
+	}
+
+	if (no_start)
+		shape->no_start = true;
+	else if (start_time > shape->start_time)
+		shape->start_time = start_time;
+}
+
+static void _bf_reserve_running_ends(void *item, void *arg)
+{
+	bf_running_end_t *running_end = item;
+	node_space_handler_t *ns_h = arg;
+	job_record_t fake_job = { 0 };
+
+	if (*ns_h->node_space_recs >= bf_node_space_size)
+		return;
+
+	bit_not(running_end->node_bitmap);
+	_add_reservation(0, running_end->end_time, running_end->node_bitmap,
+			 &fake_job, ns_h->node_space, ns_h->node_space_recs);
+}
+
 static int _set_hetjob_details(void *x, void *arg)
 {
 	job_record_t *job_ptr = (job_record_t *) x;
@@ -1775,9 +1999,12 @@ static void _attempt_backfill(void)
 	time_t qos_blocked_until = 0, qos_part_blocked_until = 0;
 	time_t tmp_preempt_start_time = 0;
 	bool tmp_preempt_in_progress = false;
-	bitstr_t *tmp_bitmap = NULL;
+	bitstr_t *tmp_bitmap = NULL, *current_bitmap = NULL;
 	bool state_changed_break = false;
 	resv_exc_t resv_exc = { 0 };
+	xhash_t *shape_map = NULL;
+	char *shape_key = NULL;
+	bf_shape_t *shape;
 	/* QOS Read lock */
 	assoc_mgr_lock_t qos_read_lock = {
 		.qos = READ_LOCK,
@@ -1855,6 +2082,9 @@ static void _attempt_backfill(void)
 		node_space_handler_t node_space_handler;
 		node_space_handler.node_space = node_space;
 		node_space_handler.node_space_recs = &node_space_recs;
+		node_space_handler.running_ends =
+			xhash_init(_bf_running_end_key_id,
+				   _bf_running_end_free);
 
 		if (bf_licenses)
 			list_for_each(resv_list, _bf_reserve_resv_licenses,
@@ -1862,6 +2092,9 @@ static void _attempt_backfill(void)
 
 		list_for_each(job_list, _bf_reserve_running,
 			      &node_space_handler);
+		xhash_walk(node_space_handler.running_ends,
+			   _bf_reserve_running_ends, &node_space_handler);
+		xhash_free(node_space_handler.running_ends);
 	}
 
 	if (slurm_conf.debug_flags & DEBUG_FLAG_BACKFILL_MAP)
@@ -1876,6 +2109,13 @@ static void _attempt_backfill(void)
 
 	sort_job_queue(job_queue);
 
+	/*
+	 * Preemption makes the outcome depend on the priority of each job,
+	 * which is not part of the shape key.
+	 */
+	if (bf_shape_cache && !slurm_preemption_enabled())
+		shape_map = xhash_init(_bf_shape_key_id, _bf_shape_free);
+
 	/* Ignore nodes that have been set as available during this cycle. */
 	bit_clear_all(bf_ignore_node_bitmap);
 
@@ -1965,7 +2205,7 @@ static void _attempt_backfill(void)
 				     slurmctld_diag_stats.bf_last_depth,
 				     job_test_count, TIME_STR);
 			}
-			if (_yield_locks(yield_sleep)) {
+			if (_yield_locks(yield_sleep, node_space)) {
 				log_flag(BACKFILL, "system state changed, breaking out after testing %u(%d) jobs",
 					 slurmctld_diag_stats.bf_last_depth,
 					 job_test_count);
@@ -1973,6 +2213,13 @@ static void _attempt_backfill(void)
 				_set_bf_exit(BF_EXIT_STATE_CHANGED);
 				break;
 			}
+			/*
+			 * Jobs may have ended while locks were released,
+			 * making earlier start times possible again.
+			 */
+			if (shape_map)
+				xhash_clear(shape_map);
+
 			/* Reset backfill scheduling timers, resume testing */
 			sched_start = time(NULL);
 			gettimeofday(&start_tv, NULL);
@@ -2299,6 +2546,26 @@ next_task:
 			}
 		}
 
+		xfree(shape_key);
+		if (shape_map &&
+		    (shape_key = _bf_shape_key(job_ptr, min_nodes, max_nodes,
+					       req_nodes, time_limit,
+					       job_no_reserve)) &&
+		    (shape = xhash_get_str(shape_map, shape_key))) {
+			if (shape->no_start) {
+				log_flag(BACKFILL, "%pJ has the same shape as a job already found unable to start",
+					 job_ptr);
+				_set_job_time_limit(job_ptr, orig_time_limit);
+				job_ptr->start_time = orig_start_time;
+				continue;
+			}
+			if (shape->start_time > later_start) {
+				later_start = shape->start_time;
+				log_flag(BACKFILL, "%pJ has the same shape as a job unable to start before %ld",
+					 job_ptr, later_start);
+			}
+		}
+
  TRY_LATER:
 		if (slurmctld_config.shutdown_time ||
 		    (difftime(time(NULL), orig_sched_start) >=
@@ -2327,7 +2594,7 @@ next_task:
 				     slurmctld_diag_stats.bf_last_depth,
 				     job_test_count, test_time_count, TIME_STR);
 			}
-			if (_yield_locks(yield_sleep)) {
+			if (_yield_locks(yield_sleep, node_space)) {
 				log_flag(BACKFILL, "system state changed, breaking out after testing %u(%d) jobs",
 					 slurmctld_diag_stats.bf_last_depth,
 					 job_test_count);
@@ -2336,6 +2603,13 @@ next_task:
 				break;
 			}
 
+			/*
+			 * Jobs may have ended while locks were released,
+			 * making earlier start times possible again.
+			 */
+			if (shape_map)
+				xhash_clear(shape_map);
+
 			/* Reset backfill scheduling timers, resume testing */
 			sched_start = time(NULL);
 			gettimeofday(&start_tv, NULL);
@@ -2436,6 +2710,7 @@ next_task:
 			log_flag(BACKFILL, "%pJ start_res after current backfill window",
 				 job_ptr);
 			_set_job_time_limit(job_ptr, orig_time_limit);
+			_bf_shape_set(shape_map, &shape_key, 0, true);
 			continue;
 		}
 
@@ -2459,11 +2734,11 @@ next_task:
 			if ((node_space[j].end_time > start_res) &&
 			     node_space[j].next && (later_start == 0)) {
 				int tmp = node_space[j].next;
-				bitstr_t *next_bitmap = bit_copy(tmp_bitmap);
-				bitstr_t *current_bitmap =
-					bit_copy(avail_bitmap);
-				bit_and(next_bitmap,
-					node_space[tmp].avail_bitmap);
+
+				if (!current_bitmap)
+					current_bitmap =
+						bit_alloc(node_record_count);
+				bit_copybits(current_bitmap, avail_bitmap);
 				bit_and(current_bitmap,
 					node_space[j].avail_bitmap);
 				/*
@@ -2477,10 +2752,10 @@ next_task:
 				 * calling _try_sched (expensive function) would
 				 * be useless and would impact performance.
 				 */
-				if (!bit_super_set(next_bitmap, current_bitmap))
+				if (bit_overlap_and_not(tmp_bitmap,
+							node_space[tmp].avail_bitmap,
+							current_bitmap))
 					later_start = node_space[j].end_time;
-				FREE_NULL_BITMAP(next_bitmap);
-				FREE_NULL_BITMAP(current_bitmap);
 			}
 			if (node_space[j].end_time <= start_res)
 				;
@@ -2527,6 +2802,7 @@ next_task:
 
 			/* Job can not start until too far in the future */
 			_set_job_time_limit(job_ptr, orig_time_limit);
+			_bf_shape_set(shape_map, &shape_key, 0, true);
 			/*
 			 * Use orig_start_time if job can't
 			 * start in different partition it will be 0
@@ -2658,8 +2934,10 @@ next_task:
 				goto TRY_LATER;
 			}
 			job_ptr->start_time = orig_start_time;
+			_bf_shape_set(shape_map, &shape_key, 0, true);
 			continue;	/* not runable in this partition */
 		}
+		_bf_shape_set(shape_map, &shape_key, start_res, false);
 
 		if (start_res > job_ptr->start_time) {
 			job_ptr->start_time = start_res;
@@ -3176,8 +3454,11 @@ skip_start:
 		_het_job_start_test(node_space, 0);
 
 	FREE_NULL_BITMAP(avail_bitmap);
+	FREE_NULL_BITMAP(current_bitmap);
 	reservation_delete_resv_exc_parts(&resv_exc);
 	FREE_NULL_BITMAP(resv_bitmap);
+	xfree(shape_key);
+	xhash_free(shape_map);
 
 	for (i = 0; ; ) {
 		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
@@ -473,7 +473,7 @@ static int _compute_plane_dist(job_record_t *job_ptr,
 static void _block_sync_core_bitmap(job_record_t *job_ptr,
 				    const uint16_t cr_type)
 {
-	uint32_t c, s, i, j, b, z, csize, core_cnt;
+	uint32_t c, s, i, j, b, z, csize, core_cnt, sock_end;
 	int n, n_first, n_last;
 	uint16_t cpus, num_bits, vpus = 1;
 	uint16_t cpus_per_task = job_ptr->details->cpus_per_task;
@@ -604,17 +604,13 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 			sort_brds_core_cnt[b] = 0;
 		}
 		for (s = 0; s < nsockets_nb; s++) {
-			sockets_core_cnt[s] = 0;
 			sockets_used[s] = false;
 			b = s / sock_per_brd;
-			for (j = c + (s * ncores_nb);
-			     j < c + ((s+1) * ncores_nb); j++) {
-				if (bit_test(job_res->core_bitmap, j)) {
-					sockets_core_cnt[s]++;
-					boards_core_cnt[b]++;
-					sort_brds_core_cnt[b]++;
-				}
-			}
+			sockets_core_cnt[s] = bit_set_count_range(
+				job_res->core_bitmap, c + (s * ncores_nb),
+				c + ((s + 1) * ncores_nb));
+			boards_core_cnt[b] += sockets_core_cnt[s];
+			sort_brds_core_cnt[b] += sockets_core_cnt[s];
 		}
 
 		/* Sort boards in descending order of available core count */
@@ -784,9 +780,9 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 			         sockets_core_cnt[best_fit_location]);
 
 			sockets_used[best_fit_location] = true;
+			sock_end = c + ((best_fit_location + 1) * ncores_nb);
 			for (j = (c + (best_fit_location * ncores_nb));
-			     j < (c + ((best_fit_location + 1) * ncores_nb));
-			     j++ ) {
+			     j < sock_end; j++ ) {
 				/*
 				 * if no more CPUs to select
 				 * release remaining cores unless
@@ -794,14 +790,14 @@ static void _block_sync_core_bitmap(job_record_t *job_ptr,
 				 */
 				if (cpus == 0) {
 					if (alloc_sockets) {
-						bit_set(job_res->core_bitmap,
-							j);
-						core_cnt++;
+						bit_nset(job_res->core_bitmap,
+							 j, sock_end - 1);
+						core_cnt += sock_end - j;
 					} else {
-						bit_clear(job_res->core_bitmap,
-							  j);
+						bit_nclear(job_res->core_bitmap,
+							   j, sock_end - 1);
 					}
-					continue;
+					break;
 				}
 
 				/*
@@ -895,6 +891,7 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 	bitstr_t *core_map;
 	bool *sock_used, *sock_avoid;
 	bool alloc_cores = false, alloc_sockets = false;
+	bitoff_t next_core;
 	uint16_t ntasks_per_socket = INFINITE16;
 	uint16_t ntasks_per_core = INFINITE16;
 	int error_code = SLURM_SUCCESS;
@@ -974,10 +971,10 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 					  job_ptr->details->cpus_per_task;
 			cpus_cnt = xmalloc(sizeof(uint32_t) * sockets);
 			for (s = 0; s < sockets; s++) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					if (bit_test(core_map, j))
-						cpus_cnt[s] += vpus;
-				}
+				cpus_cnt[s] = vpus *
+					bit_set_count_range(core_map,
+							    sock_start[s],
+							    sock_end[s]);
 				total_cpus += cpus_cnt[s];
 			}
 			for (s = 0; s < sockets && total_cpus > cpus; s++) {
@@ -1002,10 +999,10 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 			cpus_per_task = job_ptr->details->cpus_per_task;
 			cpus_cnt = xmalloc(sizeof(uint32_t) * sockets);
 			for (s = 0; s < sockets; s++) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					if (bit_test(core_map, j))
-						cpus_cnt[s] += vpus;
-				}
+				cpus_cnt[s] = vpus *
+					bit_set_count_range(core_map,
+							    sock_start[s],
+							    sock_end[s]);
 				cpus_cnt[s] -= (cpus_cnt[s] % cpus_per_task);
 			}
 			tmp_cpt = cpus_per_task;
@@ -1047,19 +1044,21 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 		while (cpus > 0) {
 			uint16_t prev_cpus = cpus;
 			for (s = 0; s < sockets && cpus > 0; s++) {
-				if (sock_avoid[s])
+				if (sock_avoid[s] ||
+				    (sock_start[s] == sock_end[s]))
 					continue;
-				while (sock_start[s] < sock_end[s]) {
-					if (bit_test(core_map, sock_start[s])) {
-						sock_used[s] = true;
-						core_cnt++;
-						break;
-					} else
-						sock_start[s]++;
-				}
-				if (sock_start[s] == sock_end[s])
+				/* Skip to the next available core */
+				next_core = bit_ffs_from_bit(core_map,
+							     sock_start[s]);
+				if ((next_core == -1) ||
+				    (next_core >= sock_end[s])) {
 					/* this socket is unusable */
+					sock_start[s] = sock_end[s];
 					continue;
+				}
+				sock_start[s] = next_core;
+				sock_used[s] = true;
+				core_cnt++;
 				if (cpus < vpus)
 					cpus = 0;
 				else
@@ -1125,13 +1124,13 @@ static int _cyclic_sync_core_bitmap(job_record_t *job_ptr,
 			}
 			if ((node_ptr->tpc >= 1) &&
 			    (alloc_sockets || alloc_cores) && sock_used[s]) {
-				for (j = sock_start[s]; j < sock_end[s]; j++) {
-					/* Mark all cores as used */
-					if (alloc_sockets)
-						bit_set(core_map, j);
-					if (bit_test(core_map, j))
-						core_cnt++;
-				}
+				/* Mark all cores as used */
+				if (alloc_sockets)
+					bit_nset(core_map, sock_start[s],
+						 sock_end[s] - 1);
+				core_cnt += bit_set_count_range(core_map,
+								sock_start[s],
+								sock_end[s]);
 			}
 		}
 		if ((alloc_cores || alloc_sockets) && (node_ptr->tpc >= 1)) {
@@ -145,6 +145,15 @@ static void _handle_gres_exc_basic(resv_exc_t *resv_exc_ptr,
  * GRES of a given type model can be distributed over multiple topo structures,
  * so we need to OR the core_bitmap over all of them.
  */
+/* Return true if bitmap has any core set on socket sock */
+static bool _sock_has_core(bitstr_t *bitmap, int sock, uint16_t cores_per_sock)
+{
+	bitoff_t first = sock * cores_per_sock;
+	bitoff_t core = bit_ffs_from_bit(bitmap, first);
+
+	return ((core >= 0) && (core < (first + cores_per_sock)));
+}
+
 static sock_gres_t *_build_sock_gres_by_topo(
 	gres_state_t *gres_state_job,
 	gres_state_t *gres_state_node,
@@ -159,13 +168,14 @@ static sock_gres_t *_build_sock_gres_by_topo(
 	gres_job_state_t *gres_js = gres_state_job->gres_data;
 	gres_node_state_t *gres_ns = gres_state_node->gres_data;
 	gres_node_state_t *alt_gres_ns = NULL;
-	int i, j, s, c;
+	int i, s, c;
 	uint32_t tot_cores;
 	sock_gres_t *sock_gres;
 	int64_t add_gres;
 	uint64_t avail_gres, min_gres = 0;
 	bool match = false;
 	bool use_busy_dev = gres_use_busy_dev(gres_state_node, use_total_gres);
+	bool *sock_core_avail = NULL;
 
 	if (gres_ns->gres_cnt_avail == 0)
 		return NULL;
@@ -179,6 +189,18 @@ static sock_gres_t *_build_sock_gres_by_topo(
 	sock_gres->bits_by_sock = xcalloc(sockets, sizeof(bitstr_t *));
 	sock_gres->cnt_by_sock = xcalloc(sockets, sizeof(uint64_t));
 
+	/*
+	 * Sockets with available cores. Cores are only cleared below on sockets
+	 * whose cnt_by_sock is also cleared, so this stays valid for every
+	 * socket that still has GRES.
+	 */
+	if (core_bitmap) {
+		sock_core_avail = xcalloc(sockets, sizeof(bool));
+		for (s = 0; s < sockets; s++)
+			sock_core_avail[s] = _sock_has_core(core_bitmap, s,
+							    cores_per_sock);
+	}
+
 	for (i = 0; i < gres_ns->topo_cnt; i++) {
 		bool use_all_sockets = false;
 		if (gres_js->type_name &&
@@ -259,16 +281,8 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		    gres_ns->topo_core_bitmap[i]) {
 			use_all_sockets = true;
 			for (s = 0; s < sockets; s++) {
-				bool use_this_socket = false;
-				for (c = 0; c < cores_per_sock; c++) {
-					j = (s * cores_per_sock) + c;
-					if (bit_test(gres_ns->
-						     topo_core_bitmap[i], j)) {
-						use_this_socket = true;
-						break;
-					}
-				}
-				if (!use_this_socket) {
+				if (!_sock_has_core(gres_ns->topo_core_bitmap[i],
+						    s, cores_per_sock)) {
 					use_all_sockets = false;
 					break;
 				}
@@ -298,42 +312,30 @@ static sock_gres_t *_build_sock_gres_by_topo(
 
 		/* Constrained by core */
 		for (s = 0; ((s < sockets) && avail_gres); s++) {
-			if (enforce_binding && core_bitmap) {
-				for (c = 0; c < cores_per_sock; c++) {
-					j = (s * cores_per_sock) + c;
-					if (bit_test(core_bitmap, j))
-						break;
-				}
-				if (c >= cores_per_sock) {
-					/* No available cores on this socket */
-					continue;
-				}
+			if (enforce_binding && sock_core_avail &&
+			    !sock_core_avail[s]) {
+				/* No available cores on this socket */
+				continue;
 			}
-			for (c = 0; c < cores_per_sock; c++) {
-				j = (s * cores_per_sock) + c;
-				if (gres_ns->topo_core_bitmap[i] &&
-				    !bit_test(gres_ns->topo_core_bitmap[i],
-					      j))
-					continue;
-				if (!gres_ns->topo_gres_bitmap[i]) {
-					error("%s: topo_gres_bitmap NULL on node %s",
-					      __func__, node_name);
-					continue;
-				}
-				if (!sock_gres->bits_by_sock[s]) {
-					sock_gres->bits_by_sock[s] =
-						bit_copy(gres_ns->
-							 topo_gres_bitmap[i]);
-				} else {
-					bit_or(sock_gres->bits_by_sock[s],
-					       gres_ns->topo_gres_bitmap[i]);
-				}
-				sock_gres->cnt_by_sock[s] += avail_gres;
-				sock_gres->total_cnt += avail_gres;
-				avail_gres = 0;
-				match = true;
-				break;
+			if (!_sock_has_core(gres_ns->topo_core_bitmap[i], s,
+					    cores_per_sock))
+				continue;
+			if (!gres_ns->topo_gres_bitmap[i]) {
+				error("%s: topo_gres_bitmap NULL on node %s",
+				      __func__, node_name);
+				continue;
+			}
+			if (!sock_gres->bits_by_sock[s]) {
+				sock_gres->bits_by_sock[s] =
+					bit_copy(gres_ns->topo_gres_bitmap[i]);
+			} else {
+				bit_or(sock_gres->bits_by_sock[s],
+				       gres_ns->topo_gres_bitmap[i]);
 			}
+			sock_gres->cnt_by_sock[s] += avail_gres;
+			sock_gres->total_cnt += avail_gres;
+			avail_gres = 0;
+			match = true;
 		}
 	}
 
@@ -377,16 +379,11 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		int avail_sock = 0;
 		bool *avail_sock_flag = xcalloc(sockets, sizeof(bool));
 		for (s = 0; s < sockets; s++) {
-			if (sock_gres->cnt_by_sock[s] == 0)
+			if ((sock_gres->cnt_by_sock[s] == 0) ||
+			    !sock_core_avail[s])
 				continue;
-			for (c = 0; c < cores_per_sock; c++) {
-				i = (s * cores_per_sock) + c;
-				if (!bit_test(core_bitmap, i))
-					continue;
-				avail_sock++;
-				avail_sock_flag[s] = true;
-				break;
-			}
+			avail_sock++;
+			avail_sock_flag[s] = true;
 		}
 		while (avail_sock > s_p_n) {
 			int low_gres_sock_inx = -1;
@@ -431,19 +428,14 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		int best_sock_inx = -1;
 		bool *avail_sock_flag = xcalloc(sockets, sizeof(bool));
 		for (s = 0; s < sockets; s++) {
-			if (sock_gres->cnt_by_sock[s] == 0)
+			if ((sock_gres->cnt_by_sock[s] == 0) ||
+			    !sock_core_avail[s])
 				continue;
-			for (c = 0; c < cores_per_sock; c++) {
-				i = (s * cores_per_sock) + c;
-				if (!bit_test(core_bitmap, i))
-					continue;
-				avail_sock_flag[s] = true;
-				if ((best_sock_inx == -1) ||
-				    (sock_gres->cnt_by_sock[s] >
-				     sock_gres->cnt_by_sock[best_sock_inx])) {
-					best_sock_inx = s;
-				}
-				break;
+			avail_sock_flag[s] = true;
+			if ((best_sock_inx == -1) ||
+			    (sock_gres->cnt_by_sock[s] >
+			     sock_gres->cnt_by_sock[best_sock_inx])) {
+				best_sock_inx = s;
 			}
 		}
 		while ((best_sock_inx != -1) && (add_gres > 0)) {
@@ -470,6 +462,7 @@ static sock_gres_t *_build_sock_gres_by_topo(
 		xfree(avail_sock_flag);
 	}
 
+	xfree(sock_core_avail);
 	if (!match) {
 		gres_sock_delete(sock_gres);
 		sock_gres = NULL;
@@ -42,8 +42,14 @@
 #include "gres_select_util.h"
 #include "gres_sock_list.h"
 
+#include "src/common/workq.h"
 #include "src/slurmctld/licenses.h"
 
+/* Minimum count of nodes evaluated by each _get_res_avail() worker */
+#define RES_AVAIL_MIN_NODES 128
+/* Maximum count of node classes tracked by _get_res_avail_range() */
+#define RES_AVAIL_MAX_CLASSES 32
+
 typedef struct {
 	int action;
 	list_t *license_list;
@@ -54,7 +60,8 @@ typedef struct {
 } wrapper_rm_job_args_t;
 
 typedef struct {
-	List preemptee_candidates;
+	uint32_t *preemptee_ids;	/* sorted job IDs of preemptee_candidates */
+	int preemptee_id_cnt;
 	List cr_job_list;
 	node_use_record_t *future_usage;
 	part_res_record_t *future_part;
@@ -63,11 +70,50 @@ typedef struct {
 	bool *qos_preemptor;
 } cr_job_list_args_t;
 
+typedef struct {
+	avail_res_t **avail_res_array;
+	bitstr_t **core_map;
+	uint16_t cr_type;
+	job_record_t *job_ptr;
+	bitstr_t *node_map;
+	node_use_record_t *node_usage;
+	bitstr_t **part_core_map;
+	resv_exc_t *resv_exc_ptr;
+	uint32_t s_p_n;
+	bool test_only;
+	bool will_run;
+} res_avail_args_t;
+
+typedef struct {
+	res_avail_args_t *args;
+	int i_first;
+	int i_last;
+} res_avail_range_t;
+
+/*
+ * Nodes with identical hardware, memory use and available cores give the
+ * same _can_job_run_on_node() result for a job without GRES. Results are
+ * computed once per class and copied to the other nodes of the class.
+ */
+typedef struct {
+	uint64_t alloc_memory;
+	avail_res_t *avail_res;		/* result, NULL if node unusable */
+	bitstr_t *core_map_in;		/* core_map before evaluation */
+	bitstr_t *core_map_out;		/* core_map after evaluation */
+	uint32_t node_i;		/* index of first node of class */
+	bitstr_t *part_core_map;	/* part_core_map or NULL */
+} node_class_t;
+
 uint64_t def_cpu_per_gpu = 0;
 uint64_t def_mem_per_gpu = 0;
 bool preempt_strict_order = false;
 bool preempt_for_licenses = false;
 int preempt_reorder_cnt	= 1;
+int node_eval_threads = 0;
+
+static pthread_mutex_t res_avail_workq_lock = PTHREAD_MUTEX_INITIALIZER;
+static workq_t *res_avail_workq = NULL;
+static int res_avail_workq_threads = 0;
 
 /* Local functions */
 static avail_res_t *_allocate(job_record_t *job_ptr,
@@ -218,14 +264,6 @@ static int _cr_job_list_sort(void *x, void *y)
 	return (int) (job1_ptr->end_time - job2_ptr->end_time);
 }
 
-static int _find_job (void *x, void *key)
-{
-	job_record_t *job_ptr = (job_record_t *) x;
-	if (job_ptr == (job_record_t *) key)
-		return 1;
-	return 0;
-}
-
 static void _free_avail_res(avail_res_t *avail_res)
 {
 	if (!avail_res)
@@ -571,6 +609,176 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
 	return avail_res;
 }
 
+static avail_res_t *_dup_avail_res(avail_res_t *avail_res)
+{
+	avail_res_t *new_res;
+
+	if (!avail_res)
+		return NULL;
+
+	xassert(!avail_res->sock_gres_list);
+	new_res = xmalloc(sizeof(*new_res));
+	memcpy(new_res, avail_res, sizeof(*new_res));
+	if (avail_res->avail_cores_per_sock) {
+		new_res->avail_cores_per_sock =
+			xcalloc(avail_res->sock_cnt, sizeof(uint16_t));
+		memcpy(new_res->avail_cores_per_sock,
+		       avail_res->avail_cores_per_sock,
+		       avail_res->sock_cnt * sizeof(uint16_t));
+	}
+
+	return new_res;
+}
+
+/* Test if node node_i belongs to node class class_ptr */
+static bool _node_class_match(res_avail_args_t *args, node_class_t *class_ptr,
+			      uint32_t node_i)
+{
+	node_record_t *node_ptr = node_record_table_ptr[node_i];
+	node_record_t *class_node_ptr = node_record_table_ptr[class_ptr->node_i];
+	bitstr_t *part_core_map = NULL;
+
+	if ((node_ptr->cores != class_node_ptr->cores) ||
+	    (node_ptr->cpus != class_node_ptr->cpus) ||
+	    (node_ptr->mem_spec_limit != class_node_ptr->mem_spec_limit) ||
+	    (node_ptr->real_memory != class_node_ptr->real_memory) ||
+	    (node_ptr->threads != class_node_ptr->threads) ||
+	    (node_ptr->tot_cores != class_node_ptr->tot_cores) ||
+	    (node_ptr->tot_sockets != class_node_ptr->tot_sockets) ||
+	    (node_ptr->tpc != class_node_ptr->tpc) ||
+	    (args->node_usage[node_i].alloc_memory != class_ptr->alloc_memory))
+		return false;
+
+	if (args->part_core_map)
+		part_core_map = args->part_core_map[node_i];
+	if (!part_core_map != !class_ptr->part_core_map)
+		return false;
+	if (part_core_map &&
+	    (bit_equal(part_core_map, class_ptr->part_core_map) != 1))
+		return false;
+
+	return (bit_equal(args->core_map[node_i], class_ptr->core_map_in) == 1);
+}
+
+static void _free_node_classes(node_class_t *classes, int class_cnt)
+{
+	for (int c = 0; c < class_cnt; c++) {
+		_free_avail_res(classes[c].avail_res);
+		FREE_NULL_BITMAP(classes[c].core_map_in);
+		FREE_NULL_BITMAP(classes[c].core_map_out);
+		FREE_NULL_BITMAP(classes[c].part_core_map);
+	}
+}
+
+static void _get_res_avail_range(res_avail_args_t *args, int i_first,
+				 int i_last)
+{
+	node_class_t classes[RES_AVAIL_MAX_CLASSES];
+	int class_cnt = 0, c;
+	bool use_classes = !args->job_ptr->gres_list_req;
+
+	for (int i = i_first; i <= i_last; i++) {
+		node_record_t *node_ptr;
+		node_class_t *class_ptr = NULL;
+		bitstr_t *core_map_in = NULL;
+
+		if (!bit_test(args->node_map, i))
+			continue;
+
+		node_ptr = node_record_table_ptr[i];
+		if (!use_classes || !args->core_map[i] ||
+		    IS_NODE_COMPLETING(node_ptr)) {
+			args->avail_res_array[i] =
+				_can_job_run_on_node(
+					args->job_ptr, args->core_map, i,
+					args->s_p_n, args->node_usage,
+					args->cr_type, args->test_only,
+					args->will_run, args->part_core_map,
+					args->resv_exc_ptr);
+			continue;
+		}
+
+		for (c = 0; c < class_cnt; c++) {
+			if (_node_class_match(args, &classes[c], i)) {
+				class_ptr = &classes[c];
+				break;
+			}
+		}
+		if (class_ptr) {
+			log_flag(SELECT_TYPE, "Node:%s same resources as node %s",
+				 node_ptr->name,
+				 node_record_table_ptr[class_ptr->node_i]->name);
+			bit_copybits(args->core_map[i], class_ptr->core_map_out);
+			args->avail_res_array[i] =
+				_dup_avail_res(class_ptr->avail_res);
+			continue;
+		}
+
+		if (class_cnt < RES_AVAIL_MAX_CLASSES)
+			core_map_in = bit_copy(args->core_map[i]);
+		args->avail_res_array[i] =
+			_can_job_run_on_node(args->job_ptr, args->core_map, i,
+					     args->s_p_n, args->node_usage,
+					     args->cr_type, args->test_only,
+					     args->will_run,
+					     args->part_core_map,
+					     args->resv_exc_ptr);
+		if (!core_map_in)
+			continue;
+
+		class_ptr = &classes[class_cnt++];
+		class_ptr->alloc_memory = args->node_usage[i].alloc_memory;
+		class_ptr->avail_res =
+			_dup_avail_res(args->avail_res_array[i]);
+		class_ptr->core_map_in = core_map_in;
+		class_ptr->core_map_out = bit_copy(args->core_map[i]);
+		class_ptr->node_i = i;
+		if (args->part_core_map && args->part_core_map[i])
+			class_ptr->part_core_map =
+				bit_copy(args->part_core_map[i]);
+		else
+			class_ptr->part_core_map = NULL;
+	}
+
+	_free_node_classes(classes, class_cnt);
+}
+
+static void _get_res_avail_work(void *arg, int index)
+{
+	res_avail_range_t *range = &((res_avail_range_t *) arg)[index];
+
+	_get_res_avail_range(range->args, range->i_first, range->i_last);
+}
+
+/*
+ * Return the work queue used to evaluate nodes in parallel, or NULL if
+ * SchedulerParameters=node_eval_threads is not configured.
+ */
+static workq_t *_get_res_avail_workq(void)
+{
+	workq_t *workq;
+
+	slurm_mutex_lock(&res_avail_workq_lock);
+	if (res_avail_workq_threads != node_eval_threads) {
+		FREE_NULL_WORKQ(res_avail_workq);
+		if (node_eval_threads > 0)
+			res_avail_workq = new_workq(node_eval_threads);
+		res_avail_workq_threads = node_eval_threads;
+	}
+	workq = res_avail_workq;
+	slurm_mutex_unlock(&res_avail_workq_lock);
+
+	return workq;
+}
+
+extern void job_test_fini(void)
+{
+	slurm_mutex_lock(&res_avail_workq_lock);
+	FREE_NULL_WORKQ(res_avail_workq);
+	res_avail_workq_threads = 0;
+	slurm_mutex_unlock(&res_avail_workq_lock);
+}
+
 /*
  * Determine resource availability for pending job
  *
@@ -586,6 +794,14 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
  * resv_exc_ptr IN   - gres that can be included (gres_list_inc)
  *                     or excluded (gres_list_exc)
  *
+ * NOTE: With node_eval_threads configured, nodes are evaluated in ranges by
+ * the work queue threads and the calling thread. _can_job_run_on_node() only
+ * modifies the core_map, avail_res_array and sched_weight of the node it is
+ * evaluating.
+ * NOTE: For jobs without GRES, nodes are grouped in classes of identical
+ * configuration and availability (see node_class_t) so that each class is
+ * only evaluated once per range.
+ *
  * RET array of avail_res_t pointers, free using _free_avail_res_array()
  */
 static avail_res_t **_get_res_avail(job_record_t *job_ptr,
@@ -595,27 +811,58 @@ static avail_res_t **_get_res_avail(job_record_t *job_ptr,
 				    bool will_run, bitstr_t **part_core_map,
 				    resv_exc_t *resv_exc_ptr)
 {
-	int i, i_first, i_last;
-	avail_res_t **avail_res_array = NULL;
-	uint32_t s_p_n = _socks_per_node(job_ptr);
+	int i_first, i_last, node_cnt, range_cnt = 1;
+	res_avail_args_t args = {
+		.core_map = core_map,
+		.cr_type = cr_type,
+		.job_ptr = job_ptr,
+		.node_map = node_map,
+		.node_usage = node_usage,
+		.part_core_map = part_core_map,
+		.resv_exc_ptr = resv_exc_ptr,
+		.s_p_n = _socks_per_node(job_ptr),
+		.test_only = test_only,
+		.will_run = will_run,
+	};
+	res_avail_range_t *ranges;
+	workq_t *workq;
 
-	avail_res_array = xcalloc(node_record_count, sizeof(avail_res_t *));
+	args.avail_res_array = xcalloc(node_record_count,
+				       sizeof(avail_res_t *));
 	i_first = bit_ffs(node_map);
-	if (i_first != -1)
-		i_last = bit_fls(node_map);
-	else
-		i_last = -2;
-	for (i = i_first; i <= i_last; i++) {
-		if (bit_test(node_map, i))
-			avail_res_array[i] =
-				_can_job_run_on_node(
-					job_ptr, core_map, i,
-					s_p_n, node_usage,
-					cr_type, test_only, will_run,
-					part_core_map, resv_exc_ptr);
+	if (i_first == -1)
+		return args.avail_res_array;
+	i_last = bit_fls(node_map);
+
+	node_cnt = bit_set_count(node_map);
+	if ((node_cnt >= (2 * RES_AVAIL_MIN_NODES)) &&
+	    (workq = _get_res_avail_workq()))
+		range_cnt = MIN(node_cnt / RES_AVAIL_MIN_NODES,
+				node_eval_threads + 1);
+	if (range_cnt == 1) {
+		_get_res_avail_range(&args, i_first, i_last);
+		return args.avail_res_array;
 	}
 
-	return avail_res_array;
+	/*
+	 * Split the node index range evenly. The calling thread evaluates
+	 * the first range while the work queue handles the others.
+	 */
+	ranges = xcalloc(range_cnt, sizeof(*ranges));
+	for (int r = 0; r < range_cnt; r++) {
+		ranges[r].args = &args;
+		ranges[r].i_first = i_first +
+			(((int64_t) (i_last - i_first + 1) * r) / range_cnt);
+		ranges[r].i_last = i_first - 1 +
+			(((int64_t) (i_last - i_first + 1) * (r + 1)) /
+			 range_cnt);
+	}
+
+	workq_run_parallel(workq, range_cnt, _get_res_avail_work, ranges,
+			   __func__);
+	xfree(ranges);
+
+	return args.avail_res_array;
 }
 
 /* For a given job already past it's end time, guess when it will actually end.
@@ -693,11 +940,50 @@ static int _is_node_busy(part_res_record_t *p_ptr, uint32_t node_i,
 	return 0;
 }
 
-static bool _is_preemptable(job_record_t *job_ptr, List preemptee_candidates)
+static int _cmp_job_id(const void *x, const void *y)
+{
+	uint32_t id1 = *(uint32_t *) x;
+	uint32_t id2 = *(uint32_t *) y;
+
+	if (id1 < id2)
+		return -1;
+	return (id1 > id2);
+}
+
+/*
+ * Build a sorted array of the job IDs in preemptee_candidates so that
+ * _is_preemptable() does not need to walk the candidate list for every
+ * running job. Returns NULL if there are no candidates, xfree() the result.
+ */
+static uint32_t *_build_preemptee_ids(List preemptee_candidates, int *cnt)
+{
+	uint32_t *ids;
+	job_record_t *job_ptr;
+	list_itr_t *iter;
+	int i = 0;
+
+	*cnt = 0;
+	if (!preemptee_candidates || !list_count(preemptee_candidates))
+		return NULL;
+
+	ids = xcalloc(list_count(preemptee_candidates), sizeof(uint32_t));
+	iter = list_iterator_create(preemptee_candidates);
+	while ((job_ptr = list_next(iter)))
+		ids[i++] = job_ptr->job_id;
+	list_iterator_destroy(iter);
+	qsort(ids, i, sizeof(uint32_t), _cmp_job_id);
+	*cnt = i;
+
+	return ids;
+}
+
+static bool _is_preemptable(job_record_t *job_ptr, uint32_t *preemptee_ids,
+			    int preemptee_id_cnt)
 {
-	if (!preemptee_candidates)
+	if (!preemptee_ids)
 		return false;
-	if (list_find_first(preemptee_candidates, _find_job, job_ptr))
+	if (bsearch(&job_ptr->job_id, preemptee_ids, preemptee_id_cnt,
+		    sizeof(uint32_t), _cmp_job_id))
 		return true;
 	return false;
 }
@@ -2098,7 +2384,8 @@ static int _build_cr_job_list(void *x, void *arg)
 			return 0;
 		}
 	}
-	if (!_is_preemptable(job_ptr_preempt, args->preemptee_candidates)) {
+	if (!_is_preemptable(job_ptr_preempt, args->preemptee_ids,
+			     args->preemptee_id_cnt)) {
 		/* Queue job for later removal from data structures */
 		list_append(args->cr_job_list, tmp_job_ptr);
 	} else if (tmp_job_ptr == job_ptr_preempt) {
@@ -2226,7 +2513,6 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 	/* Build list of running and suspended jobs */
 	cr_job_list = list_create(NULL);
 	args = (cr_job_list_args_t) {
-		.preemptee_candidates = preemptee_candidates,
 		.cr_job_list = cr_job_list,
 		.future_usage = future_usage,
 		.future_part = future_part,
@@ -2234,7 +2520,10 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 		.orig_map = orig_map,
 		.qos_preemptor = &qos_preemptor,
 	};
+	args.preemptee_ids = _build_preemptee_ids(preemptee_candidates,
+						  &args.preemptee_id_cnt);
 	list_for_each(job_list, _build_cr_job_list, &args);
+	xfree(args.preemptee_ids);
 
 	/* Test with all preemptable jobs gone */
 	if (preemptee_candidates) {
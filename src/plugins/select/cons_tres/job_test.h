@@ -43,6 +43,7 @@ extern uint64_t def_mem_per_gpu;
 extern bool preempt_strict_order;
 extern bool preempt_for_licenses;
 extern int preempt_reorder_cnt;
+extern int node_eval_threads;
 
 /*
  * job_test - Given a specification of scheduling requirements,
@@ -82,4 +83,7 @@ extern int job_test(job_record_t *job_ptr, bitstr_t *bitmap,
 		    List *preemptee_job_list,
 		    resv_exc_t *resv_exc_ptr);
 
+/* Release resources used by job_test() */
+extern void job_test_fini(void);
+
 #endif /* !_CONS_TRES_JOB_TEST_H */
@@ -54,6 +54,7 @@
 
 #define _DEBUG 0	/* Enables module specific debugging */
 #define NODEINFO_MAGIC 0x8a5d
+#define MAX_NODE_EVAL_THREADS 64
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined.  They will get
@@ -224,6 +225,7 @@ extern int fini(void)
 	part_data_destroy_res(select_part_record);
 	select_part_record = NULL;
 	cr_fini_global_core_data();
+	job_test_fini();
 
 	return SLURM_SUCCESS;
 }
@@ -317,6 +319,18 @@ extern int select_p_node_init(void)
 	} else
 		bf_window_scale = 0;
 
+	if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+				   "node_eval_threads="))) {
+		node_eval_threads = atoi(tmp_ptr + 18);
+		if ((node_eval_threads < 0) ||
+		    (node_eval_threads > MAX_NODE_EVAL_THREADS)) {
+			error("Invalid SchedulerParameters node_eval_threads: %d",
+			      node_eval_threads);
+			node_eval_threads = 0;	/* Use default value */
+		}
+	} else
+		node_eval_threads = 0;
+
 	if (xstrcasestr(slurm_conf.sched_params, "spec_cores_first"))
 		spec_cores_first = true;
 	else
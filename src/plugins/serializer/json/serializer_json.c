@@ -36,11 +36,9 @@
 
 #include "config.h"
 
-#if HAVE_JSON_C_INC
-#include <json-c/json.h>
-#else
-#include <json/json.h>
-#endif
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
 
 #include "slurm/slurm.h"
 #include "src/common/slurm_xlator.h"
@@ -49,6 +47,7 @@
 #include "src/common/log.h"
 #include "src/common/read_config.h"
 #include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/interfaces/serializer.h"
 
@@ -86,8 +85,6 @@ const char *mime_types[] = {
 	NULL
 };
 
-static json_object *_data_to_json(const data_t *d);
-
 extern int serializer_p_init(void)
 {
 	log_flag(DATA, "loaded");
@@ -103,129 +100,627 @@ extern int serializer_p_fini(void)
 }
 
 
-static json_object *_try_parse(const char *src, size_t stringlen,
-			       struct json_tokener *tok)
+/*
+ * Input is parsed straight into data_t. Decoded strings go through one
+ * scratch buffer and numbers through a stack buffer, so the only
+ * allocations are the data_t nodes themselves.
+ *
+ * Like the json-c parser this replaces, it accepts trailing commas, C and
+ * C++ style comments, NaN and Infinity, and ignores anything after the
+ * first complete value.
+ */
+#define JSON_MAX_DEPTH 64
+
+typedef struct {
+	const char *start;
+	const char *pos;
+	const char *end;
+	const char *err;
+	char *buf;		/* scratch for decoded strings */
+	size_t buf_len;
+	size_t buf_size;
+	int depth;
+} json_parse_t;
+
+static int _parse_value(json_parse_t *p, data_t *d);
+
+static int _parse_fail(json_parse_t *p, const char *err)
+{
+	if (!p->err)
+		p->err = err;
+	return ESLURM_REST_FAIL_PARSING;
+}
+
+static void _skip_space(json_parse_t *p)
+{
+	while (p->pos < p->end) {
+		switch (*p->pos) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			p->pos++;
+			continue;
+		case '/':
+			if ((p->pos + 1) >= p->end)
+				return;
+			if (p->pos[1] == '/') {
+				p->pos += 2;
+				while ((p->pos < p->end) && (*p->pos != '\n'))
+					p->pos++;
+				continue;
+			} else if (p->pos[1] == '*') {
+				p->pos += 2;
+				while (((p->pos + 1) < p->end) &&
+				       ((p->pos[0] != '*') || (p->pos[1] != '/')))
+					p->pos++;
+				p->pos = MIN((p->pos + 2), p->end);
+				continue;
+			}
+			return;
+		default:
+			return;
+		}
+	}
+}
+
+static void _buf_append(json_parse_t *p, const char *src, size_t len)
+{
+	if ((p->buf_len + len + 1) > p->buf_size) {
+		p->buf_size = MAX((p->buf_size * 2), (p->buf_len + len + 1));
+		xrealloc_nz(p->buf, p->buf_size);
+	}
+	memcpy((p->buf + p->buf_len), src, len);
+	p->buf_len += len;
+}
+
+/* Find the next '"', '\\' or NUL, checking 8 bytes per step */
+static const char *_scan_string(const char *pos, const char *end)
+{
+#define HAS_BYTE(v, c) \
+	((((v) ^ ((c) * 0x0101010101010101ULL)) - 0x0101010101010101ULL) & \
+	 ~((v) ^ ((c) * 0x0101010101010101ULL)) & 0x8080808080808080ULL)
+
+	while ((end - pos) >= (ssize_t) sizeof(uint64_t)) {
+		uint64_t v;
+
+		memcpy(&v, pos, sizeof(v));
+		if (HAS_BYTE(v, '"') || HAS_BYTE(v, '\\') || HAS_BYTE(v, 0))
+			break;
+		pos += sizeof(v);
+	}
+#undef HAS_BYTE
+
+	while ((pos < end) && (*pos != '"') && (*pos != '\\') && *pos)
+		pos++;
+
+	return pos;
+}
+
+static int _parse_hex4(json_parse_t *p, uint32_t *value)
+{
+	*value = 0;
+
+	if ((p->end - p->pos) < 4)
+		return _parse_fail(p, "truncated \\u escape");
+
+	for (int i = 0; i < 4; i++) {
+		char c = *p->pos++;
+
+		*value <<= 4;
+		if ((c >= '0') && (c <= '9'))
+			*value |= c - '0';
+		else if ((c >= 'a') && (c <= 'f'))
+			*value |= c - 'a' + 10;
+		else if ((c >= 'A') && (c <= 'F'))
+			*value |= c - 'A' + 10;
+		else
+			return _parse_fail(p, "invalid \\u escape");
+	}
+
+	return SLURM_SUCCESS;
+}
+
+static int _parse_unicode(json_parse_t *p)
+{
+	uint32_t cp, low;
+	char utf8[4];
+	int len;
+
+	if (_parse_hex4(p, &cp))
+		return ESLURM_REST_FAIL_PARSING;
+
+	if ((cp >= 0xd800) && (cp <= 0xdbff) && ((p->end - p->pos) >= 6) &&
+	    (p->pos[0] == '\\') && (p->pos[1] == 'u')) {
+		const char *save = p->pos;
+
+		p->pos += 2;
+		if (_parse_hex4(p, &low))
+			return ESLURM_REST_FAIL_PARSING;
+		if ((low >= 0xdc00) && (low <= 0xdfff))
+			cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+		else
+			p->pos = save;
+	}
+
+	/* unpaired surrogates become U+FFFD */
+	if ((cp >= 0xd800) && (cp <= 0xdfff))
+		cp = 0xfffd;
+
+	if (!cp)
+		return _parse_fail(p, "NUL in string");
+
+	if (cp < 0x80) {
+		utf8[0] = cp;
+		len = 1;
+	} else if (cp < 0x800) {
+		utf8[0] = 0xc0 | (cp >> 6);
+		utf8[1] = 0x80 | (cp & 0x3f);
+		len = 2;
+	} else if (cp < 0x10000) {
+		utf8[0] = 0xe0 | (cp >> 12);
+		utf8[1] = 0x80 | ((cp >> 6) & 0x3f);
+		utf8[2] = 0x80 | (cp & 0x3f);
+		len = 3;
+	} else {
+		utf8[0] = 0xf0 | (cp >> 18);
+		utf8[1] = 0x80 | ((cp >> 12) & 0x3f);
+		utf8[2] = 0x80 | ((cp >> 6) & 0x3f);
+		utf8[3] = 0x80 | (cp & 0x3f);
+		len = 4;
+	}
+
+	_buf_append(p, utf8, len);
+	return SLURM_SUCCESS;
+}
+
+/* Decode string at p->pos (after the opening quote) into p->buf */
+static int _parse_string(json_parse_t *p)
+{
+	p->buf_len = 0;
+
+	while (true) {
+		const char *run = p->pos;
+		char c;
+
+		p->pos = _scan_string(p->pos, p->end);
+		_buf_append(p, run, (p->pos - run));
+
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated string");
+
+		c = *p->pos++;
+		if (c == '"')
+			break;
+		else if (!c)
+			return _parse_fail(p, "NUL in string");
+
+		/* backslash escape */
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated string");
+
+		switch ((c = *p->pos++)) {
+		case '"':
+		case '\\':
+		case '/':
+			_buf_append(p, &c, 1);
+			break;
+		case 'b':
+			_buf_append(p, "\b", 1);
+			break;
+		case 'f':
+			_buf_append(p, "\f", 1);
+			break;
+		case 'n':
+			_buf_append(p, "\n", 1);
+			break;
+		case 'r':
+			_buf_append(p, "\r", 1);
+			break;
+		case 't':
+			_buf_append(p, "\t", 1);
+			break;
+		case 'u':
+			if (_parse_unicode(p))
+				return ESLURM_REST_FAIL_PARSING;
+			break;
+		default:
+			return _parse_fail(p, "invalid escape");
+		}
+	}
+
+	_buf_append(p, "", 0);
+	p->buf[p->buf_len] = '\0';
+	return SLURM_SUCCESS;
+}
+
+static bool _match_word(json_parse_t *p, const char *word)
 {
-	json_object *jobj = json_tokener_parse_ex(tok, src, stringlen);
+	size_t len = strlen(word);
 
-	if (jobj == NULL) {
-		enum json_tokener_error jerr = json_tokener_get_error(tok);
-		error("%s: JSON parsing error %zu bytes: %s",
-		      __func__, stringlen, json_tokener_error_desc(jerr));
-		return NULL;
+	if (((size_t) (p->end - p->pos) < len) || strncmp(p->pos, word, len))
+		return false;
+
+	p->pos += len;
+	return true;
+}
+
+static int _parse_number(json_parse_t *p, data_t *d)
+{
+	char num[64], *end = NULL;
+	size_t len = 0;
+	bool is_float = false;
+
+	while (((p->pos + len) < p->end) && (len < (sizeof(num) - 1))) {
+		char c = p->pos[len];
+
+		if ((c == '.') || (c == 'e') || (c == 'E'))
+			is_float = true;
+		else if (!isdigit((unsigned char) c) && (c != '-') && (c != '+'))
+			break;
+		num[len++] = c;
 	}
-	if (tok->char_offset < stringlen)
-		log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
-		     __func__, (stringlen - tok->char_offset));
+	num[len] = '\0';
+
+	if (!len)
+		return _parse_fail(p, "unexpected character");
+
+	if (!is_float) {
+		int64_t value;
 
-	return jobj;
+		errno = 0;
+		value = strtoll(num, &end, 10);
+		if (!errno && (end == (num + len))) {
+			data_set_int(d, value);
+			p->pos += len;
+			return SLURM_SUCCESS;
+		}
+	}
+
+	/* float or an integer too large for int64_t */
+	errno = 0;
+	data_set_float(d, strtod(num, &end));
+	if (end != (num + len))
+		return _parse_fail(p, "invalid number");
+
+	p->pos += len;
+	return SLURM_SUCCESS;
+}
+
+static int _parse_list(json_parse_t *p, data_t *d)
+{
+	data_set_list(d);
+
+	while (true) {
+		_skip_space(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated list");
+		if (*p->pos == ']') {
+			p->pos++;
+			return SLURM_SUCCESS;
+		}
+
+		if (_parse_value(p, data_list_append(d)))
+			return ESLURM_REST_FAIL_PARSING;
+
+		_skip_space(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated list");
+		if (*p->pos == ',')
+			p->pos++;
+		else if (*p->pos != ']')
+			return _parse_fail(p, "expected ',' or ']'");
+	}
 }
 
-static data_t *_json_to_data(json_object *jobj, data_t *d)
+static int _parse_dict(json_parse_t *p, data_t *d)
 {
-	size_t arraylen = 0;
+	data_set_dict(d);
 
-	if (!d)
-		d = data_new();
+	while (true) {
+		data_t *child;
 
-	switch (json_object_get_type(jobj)) {
-	case json_type_null:
+		_skip_space(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated dictionary");
+		if (*p->pos == '}') {
+			p->pos++;
+			return SLURM_SUCCESS;
+		}
+		if (*p->pos != '"')
+			return _parse_fail(p, "expected key");
+
+		p->pos++;
+		if (_parse_string(p))
+			return ESLURM_REST_FAIL_PARSING;
+		/* the key is copied before p->buf is reused for the value */
+		child = data_key_set(d, p->buf);
+
+		_skip_space(p);
+		if ((p->pos >= p->end) || (*p->pos != ':'))
+			return _parse_fail(p, "expected ':'");
+		p->pos++;
+
+		if (_parse_value(p, child))
+			return ESLURM_REST_FAIL_PARSING;
+
+		_skip_space(p);
+		if (p->pos >= p->end)
+			return _parse_fail(p, "unterminated dictionary");
+		if (*p->pos == ',')
+			p->pos++;
+		else if (*p->pos != '}')
+			return _parse_fail(p, "expected ',' or '}'");
+	}
+}
+
+static int _parse_value(json_parse_t *p, data_t *d)
+{
+	int rc;
+
+	_skip_space(p);
+	if (p->pos >= p->end)
+		return _parse_fail(p, "unexpected end of input");
+
+	switch (*p->pos) {
+	case '{':
+	case '[':
+		if (++p->depth > JSON_MAX_DEPTH)
+			return _parse_fail(p, "nested too deeply");
+		if (*p->pos++ == '{')
+			rc = _parse_dict(p, d);
+		else
+			rc = _parse_list(p, d);
+		p->depth--;
+		return rc;
+	case '"':
+		p->pos++;
+		if (_parse_string(p))
+			return ESLURM_REST_FAIL_PARSING;
+		data_set_string(d, p->buf);
+		return SLURM_SUCCESS;
+	}
+
+	if (_match_word(p, "true"))
+		data_set_bool(d, true);
+	else if (_match_word(p, "false"))
+		data_set_bool(d, false);
+	else if (_match_word(p, "null"))
 		data_set_null(d);
-		break;
-	case json_type_boolean:
-		data_set_bool(d, json_object_get_boolean(jobj));
-		break;
-	case json_type_double:
-		data_set_float(d, json_object_get_double(jobj));
-		break;
-	case json_type_int:
-		data_set_int(d, json_object_get_int64(jobj));
-		break;
-	case json_type_object:
-		data_set_dict(d);
-		/* warning: json_object_object_foreach is an evil macro */
-		json_object_object_foreach(jobj, key, val) {
-			_json_to_data(val, data_key_set(d, key));
+	else if (_match_word(p, "NaN"))
+		data_set_float(d, NAN);
+	else if (_match_word(p, "Infinity"))
+		data_set_float(d, INFINITY);
+	else if (_match_word(p, "-Infinity"))
+		data_set_float(d, -INFINITY);
+	else
+		return _parse_number(p, d);
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Output is written straight from the data_t tree into one growing string
+ * instead of going through a json-c object tree first. The format matches
+ * what json_object_to_json_string_ext() produced for the same flags.
+ */
+typedef struct {
+	char *str;
+	size_t len;
+	size_t size;
+	bool pretty;
+} json_out_t;
+
+static void _out_mem(json_out_t *out, const char *src, size_t len)
+{
+	if ((out->len + len + 1) > out->size) {
+		out->size = MAX((out->size * 2), (out->len + len + 1));
+		xrealloc_nz(out->str, out->size);
+	}
+	memcpy((out->str + out->len), src, len);
+	out->len += len;
+	out->str[out->len] = '\0';
+}
+
+#define _out_str(out, s) _out_mem(out, s, strlen(s))
+
+static void _out_indent(json_out_t *out, int depth)
+{
+	static const char spaces[] = "                                ";
+
+	if (!out->pretty)
+		return;
+
+	for (int i = (depth * 2); i > 0; i -= (sizeof(spaces) - 1))
+		_out_mem(out, spaces, MIN(i, (sizeof(spaces) - 1)));
+}
+
+static void _out_escaped(json_out_t *out, const char *str)
+{
+	const char *start = str;
+
+	_out_mem(out, "\"", 1);
+	for (; *str; str++) {
+		const unsigned char c = *str;
+		char esc[7];
+
+		if ((c >= 0x20) && (c != '"') && (c != '\\') && (c != '/'))
+			continue;
+
+		_out_mem(out, start, (str - start));
+		start = str + 1;
+
+		switch (c) {
+		case '"':
+			_out_mem(out, "\\\"", 2);
+			break;
+		case '\\':
+			_out_mem(out, "\\\\", 2);
+			break;
+		case '/':
+			_out_mem(out, "\\/", 2);
+			break;
+		case '\b':
+			_out_mem(out, "\\b", 2);
+			break;
+		case '\f':
+			_out_mem(out, "\\f", 2);
+			break;
+		case '\n':
+			_out_mem(out, "\\n", 2);
+			break;
+		case '\r':
+			_out_mem(out, "\\r", 2);
+			break;
+		case '\t':
+			_out_mem(out, "\\t", 2);
+			break;
+		default:
+			snprintf(esc, sizeof(esc), "\\u%04x", c);
+			_out_mem(out, esc, 6);
 		}
-		break;
-	case json_type_array:
-		arraylen = json_object_array_length(jobj);
-		data_set_list(d);
-		for (size_t i = 0; i < arraylen; i++)
-			_json_to_data(json_object_array_get_idx(jobj, i),
-				      data_list_append(d));
-		break;
-	case json_type_string:
-		data_set_string(d, json_object_get_string(jobj));
-		break;
-	default:
-		fatal_abort("%s: unknown JSON type", __func__);
-	};
+	}
+	_out_mem(out, start, (str - start));
+	_out_mem(out, "\"", 1);
+}
 
-	return d;
+static void _out_float(json_out_t *out, double value)
+{
+	char buf[64];
+	int len;
+
+	if (isnan(value)) {
+		_out_str(out, "NaN");
+		return;
+	} else if (isinf(value)) {
+		_out_str(out, ((value < 0) ? "-Infinity" : "Infinity"));
+		return;
+	}
+
+	len = snprintf(buf, sizeof(buf), "%.17g", value);
+
+	/* keep it recognizable as a float as json-c does */
+	if (!strpbrk(buf, ".eE") && ((len + 2) < sizeof(buf))) {
+		buf[len++] = '.';
+		buf[len++] = '0';
+		buf[len] = '\0';
+	}
+
+	_out_mem(out, buf, len);
+}
+
+static void _data_to_json(json_out_t *out, const data_t *d, int depth);
+
+typedef struct {
+	json_out_t *out;
+	int depth;
+	bool first;
+} json_foreach_t;
+
+/* Start the next member of a dict or list */
+static void _out_separator(json_foreach_t *args)
+{
+	if (!args->first) {
+		_out_mem(args->out, ",", 1);
+		if (args->out->pretty)
+			_out_mem(args->out, "\n", 1);
+	}
+	args->first = false;
+
+	_out_indent(args->out, (args->depth + 1));
+}
+
+/* Close a dict or list opened with _out_open() */
+static void _out_close(json_foreach_t *args, const char *end)
+{
+	if (args->out->pretty) {
+		if (!args->first)
+			_out_mem(args->out, "\n", 1);
+		_out_indent(args->out, args->depth);
+	}
+	_out_mem(args->out, end, 1);
+}
+
+static void _out_open(json_foreach_t *args, const char *start)
+{
+	_out_mem(args->out, start, 1);
+	if (args->out->pretty)
+		_out_mem(args->out, "\n", 1);
 }
 
 static data_for_each_cmd_t _convert_dict_json(const char *key,
 					      const data_t *data,
 					      void *arg)
 {
-	json_object *jobj = arg;
-	json_object *jobject = _data_to_json(data);
+	json_foreach_t *args = arg;
+
+	_out_separator(args);
+	_out_escaped(args->out, key);
+	if (args->out->pretty)
+		_out_mem(args->out, ": ", 2);
+	else
+		_out_mem(args->out, ":", 1);
+	_data_to_json(args->out, data, (args->depth + 1));
 
-	json_object_object_add(jobj, key, jobject);
 	return DATA_FOR_EACH_CONT;
 }
 
 static data_for_each_cmd_t _convert_list_json(const data_t *data, void *arg)
 {
-	json_object *jobj = arg;
-	json_object *jarray = _data_to_json(data);
+	json_foreach_t *args = arg;
+
+	_out_separator(args);
+	_data_to_json(args->out, data, (args->depth + 1));
 
-	json_object_array_add(jobj, jarray);
 	return DATA_FOR_EACH_CONT;
 }
 
-static json_object *_data_to_json(const data_t *d)
+static void _data_to_json(json_out_t *out, const data_t *d, int depth)
 {
-	if (!d)
-		return NULL;
+	char buf[32];
+	json_foreach_t args = {
+		.out = out,
+		.depth = depth,
+		.first = true,
+	};
+
+	if (!d) {
+		_out_str(out, "null");
+		return;
+	}
 
 	switch (data_get_type(d)) {
 	case DATA_TYPE_NULL:
-		return NULL;
+		_out_str(out, "null");
 		break;
 	case DATA_TYPE_BOOL:
-		return json_object_new_boolean(data_get_bool(d));
+		_out_str(out, (data_get_bool(d) ? "true" : "false"));
 		break;
 	case DATA_TYPE_FLOAT:
-		return json_object_new_double(data_get_float(d));
+		_out_float(out, data_get_float(d));
 		break;
 	case DATA_TYPE_INT_64:
-		return json_object_new_int64(data_get_int(d));
+		_out_mem(out, buf, snprintf(buf, sizeof(buf), "%"PRId64,
+					    data_get_int(d)));
 		break;
 	case DATA_TYPE_DICT:
-	{
-		json_object *jobj = json_object_new_object();
-		if (data_dict_for_each_const(d, _convert_dict_json, jobj) < 0)
+		_out_open(&args, "{");
+		if (data_dict_for_each_const(d, _convert_dict_json, &args) < 0)
 			error("%s: unexpected error calling _convert_dict_json()",
 			      __func__);
-		return jobj;
-	}
+		_out_close(&args, "}");
+		break;
 	case DATA_TYPE_LIST:
-	{
-		json_object *jobj = json_object_new_array();
-		if (data_list_for_each_const(d, _convert_list_json, jobj) < 0)
+		_out_open(&args, "[");
+		if (data_list_for_each_const(d, _convert_list_json, &args) < 0)
 			error("%s: unexpected error calling _convert_list_json()",
 			      __func__);
-		return jobj;
-	}
+		_out_close(&args, "]");
+		break;
 	case DATA_TYPE_STRING:
 	{
 		const char *str = data_get_string_const(d);
-		if (str)
-			return json_object_new_string(str);
-		else
-			return json_object_new_string("");
+		_out_escaped(out, (str ? str : ""));
 		break;
 	}
 	default:
@@ -237,65 +732,56 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
-	struct json_object *jobj = _data_to_json(src);
-	int jflags = 0;
+	json_out_t out = {
+		.size = 4096,
+	};
 
 	/* can't be pretty and compact at the same time! */
 	xassert((flags & (SER_FLAGS_PRETTY | SER_FLAGS_COMPACT)) !=
 		(SER_FLAGS_PRETTY | SER_FLAGS_COMPACT));
 
-	switch (flags) {
-	case SER_FLAGS_PRETTY:
-		jflags = JSON_C_TO_STRING_SPACED | JSON_C_TO_STRING_PRETTY;
-		break;
-	case SER_FLAGS_COMPACT: /* fallthrough */
-	default:
-		jflags = JSON_C_TO_STRING_PLAIN;
-	}
+	out.pretty = (flags == SER_FLAGS_PRETTY);
+	out.str = xmalloc_nz(out.size);
+	out.str[0] = '\0';
+
+	_data_to_json(&out, src, 0);
 
-	/* string will die with jobj */
-	*dest = xstrdup(json_object_to_json_string_ext(jobj, jflags));
+	*dest = out.str;
 	if (length) {
 		/* add 1 for \0 */
-		*length = strlen(*dest) + 1;
+		*length = out.len + 1;
 	}
 
-	/* put is equiv to free() */
-	json_object_put(jobj);
-
 	return SLURM_SUCCESS;
 }
 
 extern int serialize_p_string_to_data(data_t **dest, const char *src,
 				      size_t length)
 {
-	json_object *jobj = NULL;
 	data_t *data = NULL;
-	struct json_tokener *tok = json_tokener_new();
+	json_parse_t p = {
+		.start = src,
+		.pos = src,
+		.end = (src + length),
+	};
 	int rc;
 
-	if (!tok)
-		return ENOMEM;
-
 	if (!src)
 		return ESLURM_DATA_PTR_NULL;
 
-	/* json-c has hard limit of 32 bits */
-	if (length >= INT32_MAX) {
-		error("%s: unable to parse JSON: too large",
-		      __func__);
-		return ESLURM_DATA_TOO_LARGE;
+	data = data_new();
+	if ((rc = _parse_value(&p, data))) {
+		error("%s: JSON parsing error at byte %zu of %zu: %s",
+		      __func__, (size_t) (p.pos - p.start), length, p.err);
+		FREE_NULL_DATA(data);
+	} else {
+		_skip_space(&p);
+		if (p.pos < p.end)
+			log_flag(DATA, "%s: Extra %zu characters after JSON string detected",
+				 __func__, (size_t) (p.end - p.pos));
 	}
 
-	jobj = _try_parse(src, length, tok);
-	if (jobj) {
-		data = _json_to_data(jobj, NULL);
-		json_object_put(jobj);
-		rc = SLURM_SUCCESS;
-	} else
-		rc = ESLURM_REST_FAIL_PARSING;
-
-	json_tokener_free(tok);
+	xfree(p.buf);
 
 	*dest = data;
 	return rc;
@@ -109,6 +109,9 @@ typedef enum {
 	YAML_PARSE_LIST,
 } yaml_parse_mode_t;
 
+/* Common prefix of all of the YAML 1.1 core schema tags */
+#define YAML_TAG_PREFIX "tag:yaml.org,2002:"
+
 /* Map of suffix to local data_t type */
 static const struct {
 	data_type_t type;
@@ -226,8 +229,13 @@ static data_type_t _yaml_tag_to_type(yaml_event_t *event, const char *source)
 
 	log_flag_hex(DATA, tag, strlen(tag), "%s: scalar tag", source);
 
+	/* Only compare the suffix as every known tag shares the prefix */
+	if (strncmp(tag, YAML_TAG_PREFIX, strlen(YAML_TAG_PREFIX)))
+		return DATA_TYPE_NONE;
+	tag += strlen(YAML_TAG_PREFIX);
+
 	for (int i = 0; i < ARRAY_SIZE(tags); ++i)
-		if (!xstrcmp(tags[i].tag, tag))
+		if (!strcmp(tags[i].suffix, tag))
 			return tags[i].type;
 
 	return DATA_TYPE_NONE;
@@ -250,7 +258,7 @@ static parse_state_t _on_parse_scalar(int depth, yaml_parser_t *parser,
 	tag = _yaml_tag_to_type(event, __func__);
 	data_set_string(dst, value);
 
-	if ((tag != DATA_TYPE_NONE) &&
+	if ((tag != DATA_TYPE_NONE) && (tag != DATA_TYPE_STRING) &&
 	    (data_convert_type(dst, tag) != tag)) {
 		*rc = ESLURM_DATA_CONV_FAILED;
 		return PARSE_FAIL;
@@ -378,7 +386,8 @@ static parse_state_t _yaml_to_data(int depth, yaml_parser_t *parser,
 	return PARSE_CONTINUE;
 }
 
-static int _parse_yaml(const char *buffer, yaml_parser_t *parser, data_t *data)
+static int _parse_yaml(const char *buffer, size_t length, yaml_parser_t *parser,
+		       data_t *data)
 {
 	const unsigned char *buf = (const unsigned char *) buffer;
 	int rc = SLURM_SUCCESS;
@@ -393,7 +402,7 @@ static int _parse_yaml(const char *buffer, yaml_parser_t *parser, data_t *data)
 		return SLURM_ERROR;
 	}
 
-	yaml_parser_set_input_string(parser, buf, strlen(buffer));
+	yaml_parser_set_input_string(parser, buf, length);
 
 	(void) _yaml_to_data(0, parser, data, &rc);
 
@@ -517,8 +526,12 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 		return SLURM_SUCCESS;
 	case DATA_TYPE_FLOAT:
 	{
-		char *buffer = xstrdup_printf("%lf", data_get_float(d));
-		if (buffer == NULL) {
+		/* %lf of +/-DBL_MAX needs 317 characters */
+		char buffer[512];
+		int len = snprintf(buffer, sizeof(buffer), "%lf",
+				   data_get_float(d));
+
+		if ((len < 0) || (len >= sizeof(buffer))) {
 			error("%s: unable to print double to string: %m",
 			      __func__);
 			return SLURM_ERROR;
@@ -526,13 +539,9 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 
 		if (!yaml_scalar_event_initialize(
 			    &event, NULL, (yaml_char_t *)YAML_FLOAT_TAG,
-			    (yaml_char_t *)buffer, strlen(buffer), 0, 0,
-			    YAML_ANY_SCALAR_STYLE)) {
-			xfree(buffer);
+			    (yaml_char_t *)buffer, len, 0, 0,
+			    YAML_ANY_SCALAR_STYLE))
 			_yaml_emitter_error;
-		}
-
-		xfree(buffer);
 
 		if (!yaml_emitter_emit(emitter, &event))
 			_yaml_emitter_error;
@@ -541,22 +550,15 @@ static int _data_to_yaml(const data_t *d, yaml_emitter_t *emitter)
 	}
 	case DATA_TYPE_INT_64:
 	{
-		char *buffer = xstrdup_printf("%"PRId64, data_get_int(d));
-		if (buffer == NULL) {
-			error("%s: unable to print int to string: %m",
-			      __func__);
-			return SLURM_ERROR;
-		}
+		char buffer[32];
+		int len = snprintf(buffer, sizeof(buffer), "%"PRId64,
+				   data_get_int(d));
 
 		if (!yaml_scalar_event_initialize(
 			    &event, NULL, (yaml_char_t *)YAML_INT_TAG,
-			    (yaml_char_t *)buffer, strlen(buffer), 0, 0,
-			    YAML_ANY_SCALAR_STYLE)) {
-			xfree(buffer);
+			    (yaml_char_t *)buffer, len, 0, 0,
+			    YAML_ANY_SCALAR_STYLE))
 			_yaml_emitter_error;
-		}
-
-		xfree(buffer);
 
 		if (!yaml_emitter_emit(emitter, &event))
 			_yaml_emitter_error;
@@ -710,12 +712,13 @@ extern int serialize_p_data_to_string(char **dest, size_t *length,
 				      const data_t *src,
 				      serializer_flags_t flags)
 {
-	yaml_emitter_t emitter;
-	buf_t *buf = init_buf(0);
+	yaml_emitter_t emitter = { 0 };
+	buf_t *buf = init_buf(BUF_SIZE);
 
 	if (_dump_yaml(src, &emitter, buf, flags)) {
 		error("%s: dump yaml failed", __func__);
 
+		yaml_emitter_delete(&emitter);
 		FREE_NULL_BUFFER(buf);
 		return ESLURM_DATA_CONV_FAILED;
 	}
@@ -737,7 +740,7 @@ extern int serialize_p_string_to_data(data_t **dest, const char *src,
 				      size_t length)
 {
 	data_t *data;
-	yaml_parser_t parser;
+	yaml_parser_t parser = { 0 };
 
 	/* string must be NULL terminated */
 	if (!length || (src[length] && (strnlen(src, length) >= length)))
@@ -745,7 +748,8 @@ extern int serialize_p_string_to_data(data_t **dest, const char *src,
 
 	data = data_new();
 
-	if (_parse_yaml(src, &parser, data)) {
+	if (_parse_yaml(src, strnlen(src, length), &parser, data)) {
+		yaml_parser_delete(&parser);
 		FREE_NULL_DATA(data);
 		return ESLURM_DATA_CONV_FAILED;
 	}
@@ -229,6 +229,15 @@ extern bool slingshot_rest_connect(slingshot_rest_conn_t *conn)
 	CURL_SETOPT(conn->handle, CURLOPT_READFUNCTION, _read_function);
 	CURL_SETOPT(conn->handle, CURLOPT_FOLLOWLOCATION, 0);
 
+	/*
+	 * The handle keeps its connection open between requests; probe it
+	 * while idle so that it is still usable at the next burst of jobs
+	 * instead of having to reconnect (and redo the TLS handshake).
+	 */
+	CURL_SETOPT(conn->handle, CURLOPT_TCP_KEEPALIVE, 1L);
+	CURL_SETOPT(conn->handle, CURLOPT_TCP_KEEPIDLE, 60L);
+	CURL_SETOPT(conn->handle, CURLOPT_TCP_KEEPINTVL, 30L);
+
 #if CURL_TRACE
 	CURL_SETOPT(conn->handle, CURLOPT_DEBUGFUNCTION, _libcurl_trace);
 	CURL_SETOPT(conn->handle, CURLOPT_VERBOSE, 1L);
@@ -266,9 +275,12 @@ static bool _rest_request(slingshot_rest_conn_t *conn, long *status,
 {
 	CURLcode ret;
 
-	/* Reset received data buffer */
+	/*
+	 * Reset received data buffer, _rest_data_received() keeps it NUL
+	 * terminated
+	 */
 	if (conn->data != NULL && conn->datasiz > 0)
-		memset(conn->data, 0, conn->datasiz);
+		conn->data[0] = '\0';
 	conn->datalen = 0;
 
 	/* Issue the request */
@@ -338,6 +350,20 @@ again:
 		error("curl_slist_append failed to append Content-Type: %m");
 		goto err;
 	}
+	/*
+	 * Don't let libcurl send "Expect: 100-continue" for larger POST/PATCH
+	 * bodies, which costs an extra round trip (or a 1 second wait if the
+	 * server doesn't answer it) on every such request.
+	 */
+	if (req) {
+		struct curl_slist *tmp = curl_slist_append(headers, "Expect:");
+
+		if (!tmp) {
+			error("curl_slist_append failed to append Expect: %m");
+			goto err;
+		}
+		headers = tmp;
+	}
 	if (!_get_auth_header(conn, &headers, use_cache))
 		goto err;
 
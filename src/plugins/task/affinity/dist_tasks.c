@@ -107,6 +107,11 @@ static void _task_layout_display_masks(launch_tasks_request_msg_t *req,
 {
 	int i;
 	char *str = NULL;
+
+	/* formatting every task's mask is not free, only do it if logged */
+	if (get_log_level() < LOG_LEVEL_DEBUG3)
+		return;
+
 	for(i = 0; i < maxtasks; i++) {
 		str = (char *)bit_fmt_hexmask(masks[i]);
 		debug3("_task_layout_display_masks jobid [%u:%d] %s",
@@ -138,25 +143,39 @@ static void _lllp_free_masks(const uint32_t maxtasks, bitstr_t **masks)
 static void _match_masks_to_ldom(const uint32_t maxtasks, bitstr_t **masks)
 {
 	uint32_t i, b, size;
+	uint16_t *cpu_ldom;
+	bitstr_t *ldoms;
 
 	if (!masks || !masks[0])
 		return;
 	size = bit_size(masks[0]);
-	for(i = 0; i < maxtasks; i++) {
+
+	/* look up every CPU's NUMA node once instead of per task and CPU */
+	cpu_ldom = xcalloc(size, sizeof(uint16_t));
+	for (b = 0; b < size; b++)
+		cpu_ldom[b] = slurm_get_numa_node(b);
+	ldoms = bit_alloc(MAX(numa_max_node() + 1, 1));
+
+	for (i = 0; i < maxtasks; i++) {
+		if (!masks[i])
+			continue;
+		/* collect the NUMA nodes this mask touches... */
+		bit_clear_all(ldoms);
 		for (b = 0; b < size; b++) {
-			if (bit_test(masks[i], b)) {
-				/* get the NUMA node for this CPU, and then
-				 * set all CPUs in the mask that exist in
-				 * the same CPU */
-				int c;
-				uint16_t nnid = slurm_get_numa_node(b);
-				for (c = 0; c < size; c++) {
-					if (slurm_get_numa_node(c) == nnid)
-						bit_set(masks[i], c);
-				}
-			}
+			if (bit_test(masks[i], b) &&
+			    (cpu_ldom[b] < bit_size(ldoms)))
+				bit_set(ldoms, cpu_ldom[b]);
+		}
+		/* ...and set all CPUs that exist in the same NUMA nodes */
+		for (b = 0; b < size; b++) {
+			if ((cpu_ldom[b] < bit_size(ldoms)) &&
+			    bit_test(ldoms, cpu_ldom[b]))
+				bit_set(masks[i], b);
 		}
 	}
+
+	FREE_NULL_BITMAP(ldoms);
+	xfree(cpu_ldom);
 }
 #endif
 
@@ -265,7 +284,7 @@ static int _validate_map(launch_tasks_request_msg_t *req, char *avail_mask,
 static int _validate_mask(launch_tasks_request_msg_t *req, char *avail_mask,
 			  char **err_msg)
 {
-	char *new_mask = NULL, *save_ptr = NULL, *tok;
+	char *new_mask = NULL, *new_mask_pos = NULL, *save_ptr = NULL, *tok;
 	cpu_set_t avail_cpus, task_cpus;
 	bool superset = true;
 	int rc = SLURM_SUCCESS;
@@ -320,8 +339,8 @@ static int _validate_mask(launch_tasks_request_msg_t *req, char *avail_mask,
 		}
 		task_cpuset_to_str(&task_cpus, mask_str);
 		if (new_mask)
-			xstrcat(new_mask, ",");
-		xstrcat(new_mask, mask_str);
+			xstrcatat(new_mask, &new_mask_pos, ",");
+		xstrcatat(new_mask, &new_mask_pos, mask_str);
 		tok = strtok_r(NULL, ",", &save_ptr);
 	}
 
@@ -47,6 +47,8 @@ block_record_t *block_record_table = NULL;
 uint16_t bblock_node_cnt = 0;
 bitstr_t *block_levels = NULL;
 int block_record_cnt = 0;
+int *node_bblock_inx = NULL;
+int node_bblock_inx_cnt = 0;
 
 static s_p_hashtbl_t *conf_hashtbl = NULL;
 
@@ -213,6 +215,35 @@ extern void block_record_table_destroy(void)
 	}
 	xfree(block_record_table);
 	block_record_cnt = 0;
+	xfree(node_bblock_inx);
+	node_bblock_inx_cnt = 0;
+}
+
+/*
+ * Map every node to the index of the bblock containing it. This lets
+ * eval_nodes_block() count available nodes and CPUs per bblock with a single
+ * pass over the node map. Only possible if no node is in more than one bblock.
+ */
+static void _build_node_bblock_inx(bool bblocks_overlap)
+{
+	block_record_t *block_ptr = block_record_table;
+
+	if (bblocks_overlap) {
+		debug("%s: bblocks share nodes, per-bblock counters disabled",
+		      __func__);
+		return;
+	}
+
+	node_bblock_inx_cnt = node_record_count;
+	node_bblock_inx = xcalloc(node_bblock_inx_cnt, sizeof(int));
+	for (int i = 0; i < node_bblock_inx_cnt; i++)
+		node_bblock_inx[i] = -1;
+
+	for (int i = 0; i < block_record_cnt; i++, block_ptr++) {
+		for (int j = 0; (j = bit_ffs_from_bit(block_ptr->node_bitmap,
+						      j)) >= 0; j++)
+			node_bblock_inx[j] = i;
+	}
 }
 
 extern void block_record_validate(void)
@@ -222,6 +253,7 @@ extern void block_record_validate(void)
 	block_record_t *block_ptr, *prior_ptr;
 	hostlist_t *invalid_hl = NULL;
 	char *buf;
+	bool bblocks_overlap = false;
 
 	block_record_table_destroy();
 
@@ -259,6 +291,9 @@ extern void block_record_validate(void)
 				      ptr->nodes, ptr->block_name);
 			}
 			if (blocks_nodes_bitmap) {
+				if (bit_overlap_any(blocks_nodes_bitmap,
+						    block_ptr->node_bitmap))
+					bblocks_overlap = true;
 				bit_or(blocks_nodes_bitmap,
 				       block_ptr->node_bitmap);
 			} else {
@@ -294,6 +329,8 @@ extern void block_record_validate(void)
 	} else
 		fatal("blocks contain no nodes");
 
+	_build_node_bblock_inx(bblocks_overlap);
+
 	if (invalid_hl) {
 		buf = hostlist_ranged_string_xmalloc(invalid_hl);
 		warning("Invalid hostnames in block configuration: %s", buf);
@@ -52,6 +52,9 @@ extern block_record_t *block_record_table;  /* ptr to block records */
 extern uint16_t bblock_node_cnt;
 extern bitstr_t *block_levels;
 extern int block_record_cnt;
+extern int *node_bblock_inx;	/* node index to bblock index, -1 if none,
+				 * NULL if bblocks share nodes */
+extern int node_bblock_inx_cnt;
 
 /* Free all memory associated with block_record_table structure */
 extern void block_record_table_destroy(void);
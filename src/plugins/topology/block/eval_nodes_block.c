@@ -118,6 +118,25 @@ static void _choose_best_bblock(bitstr_t *bblock_required,
 	}
 }
 
+/* Build bitmap of the available nodes on block block_inx */
+static bitstr_t *_block_node_bitmap(int block_inx, int bblock_per_block,
+				    bitstr_t *node_map)
+{
+	bitstr_t *node_bitmap = NULL;
+	int first = block_inx * bblock_per_block;
+	int last = MIN(first + bblock_per_block, block_record_cnt);
+
+	for (int i = first; i < last; i++) {
+		if (node_bitmap)
+			bit_or(node_bitmap, block_record_table[i].node_bitmap);
+		else
+			node_bitmap = bit_copy(block_record_table[i].node_bitmap);
+	}
+	bit_and(node_bitmap, node_map);
+
+	return node_bitmap;
+}
+
 extern int eval_nodes_block(topology_eval_t *topo_eval)
 {
 	uint32_t *block_cpu_cnt = NULL;	/* total CPUs on block */
@@ -132,6 +151,8 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 	bitstr_t *best_nodes_bitmap = NULL;	/* required+low prio nodes */
 	bitstr_t *bblock_bitmap = NULL;
 	int *bblock_block_inx = NULL;
+	uint32_t *bblock_avail_cnt = NULL;	/* available nodes on bblock */
+	uint32_t *bblock_cpu_cnt = NULL;	/* available CPUs on bblock */
 	bitstr_t *bblock_required = NULL;
 	int i, j, rc = SLURM_SUCCESS;
 	int best_cpu_cnt, best_node_cnt, req_node_cnt = 0;
@@ -311,48 +332,80 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 	bblock_required = bit_alloc(block_record_cnt);
 	bblock_block_inx = xcalloc(block_record_cnt, sizeof(int));
 
+	if (node_bblock_inx) {
+		/*
+		 * bblocks are disjoint: count available nodes and CPUs of every
+		 * bblock with one pass over node_map, block and llblock totals
+		 * are then sums of bblock totals.
+		 */
+		bblock_avail_cnt = xcalloc(block_record_cnt, sizeof(uint32_t));
+		bblock_cpu_cnt = xcalloc(block_record_cnt, sizeof(uint32_t));
+		for (i = 0; (i = bit_ffs_from_bit(topo_eval->node_map, i)) >= 0;
+		     i++) {
+			int bblock_inx;
+			if (i >= node_bblock_inx_cnt)
+				break;
+			if ((bblock_inx = node_bblock_inx[i]) < 0)
+				continue;
+			bblock_avail_cnt[bblock_inx]++;
+			bblock_cpu_cnt[bblock_inx] +=
+				avail_res_array[i]->avail_cpus;
+		}
+	}
+
 	for (i = 0, block_ptr = block_record_table; i < block_record_cnt;
 	     i++, block_ptr++) {
 		int block_inx = i / bblock_per_block;
-		if (block_node_bitmap[block_inx])
-			bit_or(block_node_bitmap[block_inx],
-			       block_ptr->node_bitmap);
-		else
-			block_node_bitmap[block_inx] =
-				bit_copy(block_ptr->node_bitmap);
 		bblock_block_inx[i] = block_inx;
+		if (bblock_avail_cnt) {
+			block_node_cnt[block_inx] += bblock_avail_cnt[i];
+			block_cpu_cnt[block_inx] += bblock_cpu_cnt[i];
+		}
 		if (nodes_on_llblock) {
 			int llblock_inx = i / bblock_per_llblock;
-			nodes_on_llblock[llblock_inx] +=
-				bit_overlap(block_ptr->node_bitmap,
-					    topo_eval->node_map);
+			if (bblock_avail_cnt)
+				nodes_on_llblock[llblock_inx] +=
+					bblock_avail_cnt[i];
+			else
+				nodes_on_llblock[llblock_inx] +=
+					bit_overlap(block_ptr->node_bitmap,
+						    topo_eval->node_map);
 		}
 	}
 
 	for (i = 0; i < block_cnt; i++) {
-		uint32_t block_cpus = 0;
-		bit_and(block_node_bitmap[i], topo_eval->node_map);
-		if (!nodes_on_llblock) {
+		if (!bblock_avail_cnt) {
+			uint32_t block_cpus = 0;
+			block_node_bitmap[i] =
+				_block_node_bitmap(i, bblock_per_block,
+						   topo_eval->node_map);
 			block_node_cnt[i] = bit_set_count(block_node_bitmap[i]);
-		} else {
+			/*
+			 * Count total CPUs of the intersection of
+			 * topo_eval->node_map and block_node_bitmap.
+			 */
+			for (j = 0;
+			     (node_ptr = next_node_bitmap(block_node_bitmap[i],
+							  &j));
+			     j++)
+				block_cpus += avail_res_array[j]->avail_cpus;
+			block_cpu_cnt[i] = block_cpus;
+		}
+		if (nodes_on_llblock) {
 			int llblock_per_block = (bblock_per_block /
 						 bblock_per_llblock);
 			int offset = i * llblock_per_block;
 			qsort(&nodes_on_llblock[offset], llblock_per_block,
 			      sizeof(int), _cmp_bblock);
+			block_node_cnt[i] = 0;
 			for (j = 0; j < max_llblock; j++)
 				block_node_cnt[i] +=
 					nodes_on_llblock[offset + j];
 		}
-		/*
-		 * Count total CPUs of the intersection of topo_eval->node_map
-		 * and block_node_bitmap.
-		 */
-		for (j = 0; (node_ptr = next_node_bitmap(block_node_bitmap[i],
-							 &j));
-		     j++)
-			block_cpus += avail_res_array[j]->avail_cpus;
-		block_cpu_cnt[i] = block_cpus;
+		if (req_nodes_bitmap && !block_node_bitmap[i])
+			block_node_bitmap[i] =
+				_block_node_bitmap(i, bblock_per_block,
+						   topo_eval->node_map);
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, block_node_bitmap[i])) {
 			if (block_inx == -1) {
@@ -364,6 +417,10 @@ extern int eval_nodes_block(topology_eval_t *topo_eval)
 					     min_nodes, req_nodes) ||
 		    (rem_cpus > block_cpu_cnt[i]))
 			continue;
+		if (!req_nodes_bitmap && !block_node_bitmap[i])
+			block_node_bitmap[i] =
+				_block_node_bitmap(i, bblock_per_block,
+						   topo_eval->node_map);
 		if (!req_nodes_bitmap &&
 		    (nw = list_find_first(node_weight_list,
 					  eval_nodes_topo_node_find,
@@ -766,6 +823,8 @@ fini:
 	}
 	xfree(block_node_cnt);
 	xfree(nodes_on_bblock);
+	xfree(bblock_avail_cnt);
+	xfree(bblock_cpu_cnt);
 	xfree(nodes_on_llblock);
 	FREE_NULL_BITMAP(bblock_required);
 	return rc;
@@ -232,6 +232,45 @@ static int *_set_span(int total,  uint16_t tree_width)
 	return span;
 }
 
+/*
+ * Pick the narrowest fanout for this hop that still reaches all nodes in the
+ * same number of hops as tree_width would. This spreads the nodes evenly over
+ * the tree instead of loading the sender with tree_width children when fewer
+ * would do, without adding forwarding latency.
+ * IN total      - total number of nodes to send to
+ * IN tree_width - maximum width of the tree on each hop
+ * RET width to use for this hop
+ */
+static uint16_t _balanced_tree_width(int total, uint16_t tree_width)
+{
+	uint64_t reach = 0, hop_cnt = 1;
+	int depth = 0;
+	uint16_t width;
+
+	if ((total <= tree_width) || (tree_width <= 2))
+		return tree_width;
+
+	/* Hops needed at full width: tree_width + tree_width^2 + ... */
+	while (reach < total) {
+		hop_cnt *= tree_width;
+		reach += hop_cnt;
+		depth++;
+	}
+
+	for (width = 2; width < tree_width; width++) {
+		reach = 0;
+		hop_cnt = 1;
+		for (int i = 0; (i < depth) && (reach < total); i++) {
+			hop_cnt *= width;
+			reach += hop_cnt;
+		}
+		if (reach >= total)
+			break;
+	}
+
+	return width;
+}
+
 extern int common_topo_split_hostlist_treewidth(hostlist_t *hl,
 						hostlist_t ***sp_hl,
 						int *count, uint16_t tree_width)
@@ -251,6 +290,7 @@ extern int common_topo_split_hostlist_treewidth(hostlist_t *hl,
 		tree_width = slurm_conf.tree_width;
 
 	host_count = hostlist_count(hl);
+	tree_width = _balanced_tree_width(host_count, tree_width);
 	span = _set_span(host_count, tree_width);
 	*sp_hl = xcalloc(MIN(tree_width, host_count), sizeof(hostlist_t *));
 
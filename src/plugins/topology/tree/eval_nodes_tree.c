@@ -740,6 +740,68 @@ fini:
 }
 
 /* Allocate resources to job using a minimal leaf switch count */
+/*
+ * Identify the nodes of node_map under each switch along with their count and
+ * available CPUs. Only leaf switches are intersected with node_map, higher
+ * level switches are built from the results of their children, summing the
+ * CPU counts when children do not share nodes.
+ */
+static void _build_switch_avail(bitstr_t *node_map,
+				avail_res_t **avail_res_array,
+				bitstr_t **switch_node_bitmap,
+				int *switch_node_cnt, uint32_t *switch_cpu_cnt)
+{
+	switch_record_t *switch_ptr;
+	node_record_t *node_ptr;
+
+	for (int level = 0; level <= switch_levels; level++) {
+		for (int i = 0; i < switch_record_cnt; i++) {
+			switch_ptr = &switch_record_table[i];
+			if (switch_ptr->level != level)
+				continue;
+
+			if (!level || !switch_ptr->num_switches) {
+				switch_node_bitmap[i] =
+					bit_copy(switch_ptr->node_bitmap);
+				bit_and(switch_node_bitmap[i], node_map);
+			} else {
+				switch_node_bitmap[i] = bit_alloc(
+					bit_size(switch_ptr->node_bitmap));
+				for (int c = 0; c < switch_ptr->num_switches;
+				     c++) {
+					int child = switch_ptr->switch_index[c];
+					bit_or(switch_node_bitmap[i],
+					       switch_node_bitmap[child]);
+				}
+			}
+			switch_node_cnt[i] =
+				bit_set_count(switch_node_bitmap[i]);
+
+			if (level && switch_ptr->num_switches &&
+			    switch_children_disjoint) {
+				for (int c = 0; c < switch_ptr->num_switches;
+				     c++) {
+					int child = switch_ptr->switch_index[c];
+					switch_cpu_cnt[i] +=
+						switch_cpu_cnt[child];
+				}
+				continue;
+			}
+
+			/*
+			 * Count total CPUs of the intersection of node_map and
+			 * switch_node_bitmap.
+			 */
+			for (int j = 0;
+			     (node_ptr = next_node_bitmap(switch_node_bitmap[i],
+							  &j));
+			     j++)
+				switch_cpu_cnt[i] +=
+					avail_res_array[j]->avail_cpus;
+		}
+	}
+}
+
 static int _eval_nodes_topo(topology_eval_t *topo_eval)
 {
 	uint32_t *switch_cpu_cnt = NULL;	/* total CPUs on switch */
@@ -894,21 +956,10 @@ static int _eval_nodes_topo(topology_eval_t *topo_eval)
 	switch_required    = xcalloc(switch_record_cnt, sizeof(int));
 	req_switch_required = xcalloc(switch_record_cnt, sizeof(int));
 
+	_build_switch_avail(topo_eval->node_map, avail_res_array,
+			    switch_node_bitmap, switch_node_cnt, switch_cpu_cnt);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
-		uint32_t switch_cpus = 0;
-		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
-		bit_and(switch_node_bitmap[i], topo_eval->node_map);
-		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
-		/*
-		 * Count total CPUs of the intersection of node_map and
-		 * switch_node_bitmap.
-		 */
-		for (j = 0; (node_ptr = next_node_bitmap(switch_node_bitmap[i],
-							 &j));
-		     j++)
-			switch_cpus += avail_res_array[j]->avail_cpus;
-		switch_cpu_cnt[i] = switch_cpus;
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, switch_node_bitmap[i])) {
 			switch_required[i] = 1;
@@ -49,6 +49,7 @@ typedef struct slurm_conf_switches {
 switch_record_t *switch_record_table = NULL;
 int switch_record_cnt = 0;
 int switch_levels = 0; /* number of switch levels */
+bool switch_children_disjoint = false;
 
 static s_p_hashtbl_t *conf_hashtbl = NULL;
 
@@ -524,6 +525,28 @@ extern void switch_record_validate(void)
 		}
 	}
 
+	/*
+	 * Children share nodes if their node counts add up to more than
+	 * their parent's
+	 */
+	switch_children_disjoint = true;
+	for (i = 0; i < switch_record_cnt; i++) {
+		int child_node_cnt = 0;
+
+		if (switch_record_table[i].level == 0)
+			continue;
+		for (j = 0; j < switch_record_table[i].num_switches; j++) {
+			uint16_t child = switch_record_table[i].switch_index[j];
+			child_node_cnt += bit_set_count(
+				switch_record_table[child].node_bitmap);
+		}
+		if (child_node_cnt !=
+		    bit_set_count(switch_record_table[i].node_bitmap)) {
+			switch_children_disjoint = false;
+			break;
+		}
+	}
+
 	for (i = 0; i < switch_record_cnt; i++) {
 		switch_record_table[i].switches_dist = xcalloc(
 			switch_record_cnt, sizeof(uint32_t));
@@ -64,6 +64,8 @@ typedef struct {
 extern switch_record_t *switch_record_table;  /* ptr to switch records */
 extern int switch_record_cnt;		/* size of switch_record_table */
 extern int switch_levels;               /* number of switch levels     */
+extern bool switch_children_disjoint;	/* no nodes shared between direct
+					 * descendants of any switch */
 
 /* Free all memory associated with switch_record_table structure */
 extern void switch_record_table_destroy(void);
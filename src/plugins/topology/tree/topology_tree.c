@@ -144,14 +144,46 @@ extern int topology_p_eval_nodes(topology_eval_t *topo_eval)
 	return common_topo_choose_nodes(topo_eval);
 }
 
+static void _rank_switch_nodes(int sw, int *switch_rank, bool *ranked)
+{
+	if (ranked[sw])
+		return;
+	ranked[sw] = true;
+
+	if (switch_record_table[sw].level != 0) {
+		/*
+		 * Visit children in configuration order so leaf switches
+		 * sharing a parent (e.g. a dragonfly group) get adjacent ranks.
+		 */
+		for (int i = 0; i < switch_record_table[sw].num_switches; i++)
+			_rank_switch_nodes(switch_record_table[sw].
+					   switch_index[i],
+					   switch_rank, ranked);
+		return;
+	}
+
+	for (int n = 0; n < node_record_count; n++) {
+		if (!bit_test(switch_record_table[sw].node_bitmap, n))
+			continue;
+		node_record_table_ptr[n]->node_rank = *switch_rank;
+		debug("node=%s rank=%d",
+		      node_record_table_ptr[n]->name, *switch_rank);
+	}
+
+	(*switch_rank)++;
+}
+
 /*
  * When TopologyParam=SwitchAsNodeRank is set, this plugin assigns a unique
- * node_rank for all nodes belonging to the same leaf switch.
+ * node_rank for all nodes belonging to the same leaf switch. Leaf switches are
+ * ranked in a depth-first walk of the switch hierarchy, so that node indexes
+ * (and node bitmaps) which are contiguous are also close in the network.
  */
 extern bool topology_p_generate_node_ranking(void)
 {
 	/* By default, node_rank is 0, so start at 1 */
 	int switch_rank = 1;
+	bool *is_child, *ranked;
 
 	if (!xstrcasestr(slurm_conf.topology_param, "SwitchAsNodeRank"))
 		return false;
@@ -162,22 +194,28 @@ extern bool topology_p_generate_node_ranking(void)
 	if (switch_record_cnt == 0)
 		return false;
 
+	is_child = xcalloc(switch_record_cnt, sizeof(bool));
+	ranked = xcalloc(switch_record_cnt, sizeof(bool));
 	for (int sw = 0; sw < switch_record_cnt; sw++) {
-		/* skip if not a leaf switch */
-		if (switch_record_table[sw].level != 0)
-			continue;
-
-		for (int n = 0; n < node_record_count; n++) {
-			if (!bit_test(switch_record_table[sw].node_bitmap, n))
-				continue;
-			node_record_table_ptr[n]->node_rank = switch_rank;
-			debug("node=%s rank=%d",
-			      node_record_table_ptr[n]->name, switch_rank);
-		}
+		for (int i = 0; i < switch_record_table[sw].num_switches; i++)
+			is_child[switch_record_table[sw].switch_index[i]] =
+				true;
+	}
 
-		switch_rank++;
+	/* Walk down from every root switch */
+	for (int sw = 0; sw < switch_record_cnt; sw++) {
+		if (!is_child[sw])
+			_rank_switch_nodes(sw, &switch_rank, ranked);
+	}
+	/* Any leaf switch not reached from a root */
+	for (int sw = 0; sw < switch_record_cnt; sw++) {
+		if (switch_record_table[sw].level == 0)
+			_rank_switch_nodes(sw, &switch_rank, ranked);
 	}
 
+	xfree(is_child);
+	xfree(ranked);
+
 	/* Discard the temporary topology since it is using node bitmaps */
 	switch_record_table_destroy();
 
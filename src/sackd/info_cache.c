@@ -0,0 +1,447 @@
+/*****************************************************************************\
+ *  info_cache.c
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "src/common/conmgr.h"
+#include "src/common/fd.h"
+#include "src/common/list.h"
+#include "src/common/log.h"
+#include "src/common/pack.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_api.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/sackd/info_cache.h"
+
+/*
+ * One cached controller response. Responses are kept in packed form, exactly
+ * as slurmctld sent them, so they can be handed to clients without being
+ * repacked. The entry mutex is held while refreshing so that concurrent
+ * clients wait on a single controller RPC instead of each sending their own.
+ */
+typedef struct {
+	uint16_t msg_type;
+	uint16_t show_flags;
+	pthread_mutex_t mutex;
+	time_t fetched;		/* when last confirmed with slurmctld */
+	time_t last_update;	/* timestamp of the cached data */
+	buf_t *data;		/* packed response body */
+} cache_entry_t;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static list_t *cache_list = NULL;
+static int cache_ttl = 0;
+
+/*
+ * Set when no partition is hidden or restricted by AllowGroups, in which case
+ * what slurmctld sends does not depend on the requesting user.
+ */
+static bool parts_uniform = false;
+
+static void _free_entry(void *x)
+{
+	cache_entry_t *entry = x;
+
+	slurm_mutex_destroy(&entry->mutex);
+	FREE_NULL_BUFFER(entry->data);
+	xfree(entry);
+}
+
+static cache_entry_t *_get_entry(uint16_t msg_type, uint16_t show_flags)
+{
+	cache_entry_t *entry = NULL;
+	list_itr_t *itr;
+
+	slurm_mutex_lock(&cache_lock);
+	itr = list_iterator_create(cache_list);
+	while ((entry = list_next(itr))) {
+		if ((entry->msg_type == msg_type) &&
+		    (entry->show_flags == show_flags))
+			break;
+	}
+	list_iterator_destroy(itr);
+
+	if (!entry) {
+		entry = xmalloc(sizeof(*entry));
+		entry->msg_type = msg_type;
+		entry->show_flags = show_flags;
+		slurm_mutex_init(&entry->mutex);
+		list_append(cache_list, entry);
+	}
+	slurm_mutex_unlock(&cache_lock);
+
+	return entry;
+}
+
+static void _set_parts_uniform(partition_info_msg_t *parts)
+{
+	bool uniform = true;
+
+	for (int i = 0; i < parts->record_count; i++) {
+		partition_info_t *part = &parts->partition_array[i];
+
+		if ((part->flags & PART_FLAG_HIDDEN) ||
+		    (part->allow_groups &&
+		     xstrcasecmp(part->allow_groups, "ALL"))) {
+			uniform = false;
+			break;
+		}
+	}
+
+	if (uniform != parts_uniform)
+		debug("%s: partition visibility is %s", __func__,
+		      (uniform ? "uniform" : "per user"));
+	parts_uniform = uniform;
+}
+
+/* Send the request to each controller in turn, keeping the packed reply */
+static int _send_recv_controller(slurm_msg_t *req, slurm_msg_t *resp)
+{
+	int rc = SLURM_COMMUNICATIONS_CONNECTION_ERROR;
+
+	for (int i = 0; i < slurm_conf.control_cnt; i++) {
+		int fd;
+
+		if ((fd = slurm_open_controller_conn_spec(i, NULL)) < 0)
+			continue;
+
+		slurm_msg_t_init(resp);
+		resp->flags = SLURM_MSG_KEEP_BUFFER;
+		if (slurm_send_node_msg(fd, req) < 0)
+			rc = errno;
+		else
+			rc = slurm_receive_msg(fd, resp, 0);
+		(void) close(fd);
+
+		if (rc) {
+			FREE_NULL_BUFFER(resp->buffer);
+			continue;
+		}
+		if (resp->auth_cred)
+			auth_g_destroy(resp->auth_cred);
+		resp->auth_cred = NULL;
+
+		if ((resp->msg_type == RESPONSE_SLURM_RC) &&
+		    ((((return_code_msg_t *) resp->data)->return_code ==
+		      ESLURM_IN_STANDBY_MODE) ||
+		     (((return_code_msg_t *) resp->data)->return_code ==
+		      ESLURM_IN_STANDBY_USE_BACKUP))) {
+			slurm_free_msg_members(resp);
+			rc = SLURM_COMMUNICATIONS_CONNECTION_ERROR;
+			continue;
+		}
+
+		return SLURM_SUCCESS;
+	}
+
+	return rc;
+}
+
+/* Refresh entry from slurmctld if older than the TTL, entry mutex held */
+static int _refresh_entry(cache_entry_t *entry, time_t now)
+{
+	slurm_msg_t req, resp;
+	job_info_request_msg_t job_req = { 0 };
+	node_info_request_msg_t node_req = { 0 };
+	part_info_request_msg_t part_req = { 0 };
+	uint32_t len;
+	int rc;
+
+	if (entry->data && ((now - entry->fetched) < cache_ttl))
+		return SLURM_SUCCESS;
+
+	slurm_msg_t_init(&req);
+	slurm_msg_set_r_uid(&req, SLURM_AUTH_UID_ANY);
+	req.msg_type = entry->msg_type;
+
+	switch (entry->msg_type) {
+	case REQUEST_JOB_INFO:
+		job_req.last_update = entry->last_update;
+		job_req.show_flags = entry->show_flags;
+		req.data = &job_req;
+		break;
+	case REQUEST_NODE_INFO:
+		node_req.last_update = entry->last_update;
+		node_req.show_flags = entry->show_flags;
+		req.data = &node_req;
+		break;
+	case REQUEST_PARTITION_INFO:
+		part_req.last_update = entry->last_update;
+		part_req.show_flags = entry->show_flags;
+		req.data = &part_req;
+		break;
+	default:
+		return SLURM_ERROR;
+	}
+
+	if ((rc = _send_recv_controller(&req, &resp))) {
+		error("%s: %s failed: %s", __func__,
+		      rpc_num2string(entry->msg_type), slurm_strerror(rc));
+		return rc;
+	}
+
+	switch (resp.msg_type) {
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp.data)->return_code;
+		if ((rc == SLURM_NO_CHANGE_IN_DATA) && entry->data) {
+			entry->fetched = now;
+			rc = SLURM_SUCCESS;
+		} else if (!rc) {
+			rc = SLURM_UNEXPECTED_MSG_ERROR;
+		}
+		goto cleanup;
+	case RESPONSE_JOB_INFO:
+		entry->last_update =
+			((job_info_msg_t *) resp.data)->last_update;
+		break;
+	case RESPONSE_NODE_INFO:
+		entry->last_update =
+			((node_info_msg_t *) resp.data)->last_update;
+		break;
+	case RESPONSE_PARTITION_INFO:
+		entry->last_update =
+			((partition_info_msg_t *) resp.data)->last_update;
+		if (entry->show_flags == SHOW_ALL)
+			_set_parts_uniform(resp.data);
+		break;
+	default:
+		rc = SLURM_UNEXPECTED_MSG_ERROR;
+		goto cleanup;
+	}
+
+	len = size_buf(resp.buffer) - resp.body_offset;
+	FREE_NULL_BUFFER(entry->data);
+	entry->data = init_buf(len);
+	memcpy(get_buf_data(entry->data),
+	       (get_buf_data(resp.buffer) + resp.body_offset), len);
+	set_buf_offset(entry->data, len);
+	entry->fetched = now;
+
+	log_flag(NET, "%s: cached %s show_flags=0x%x size=%u",
+		 __func__, rpc_num2string(resp.msg_type),
+		 entry->show_flags, len);
+
+cleanup:
+	slurm_free_msg_members(&resp);
+	return rc;
+}
+
+/*
+ * Only hand out data that slurmctld would have sent to any user. sackd talks
+ * to slurmctld as SlurmUser, so anything subject to PrivateData or partition
+ * visibility has to go to slurmctld directly from the client.
+ */
+static bool _cacheable(uint16_t msg_type, uint16_t show_flags, time_t now)
+{
+	uint16_t private = 0;
+	cache_entry_t *parts;
+
+	switch (msg_type) {
+	case REQUEST_JOB_INFO:
+		private = PRIVATE_DATA_JOBS;
+		break;
+	case REQUEST_NODE_INFO:
+		private = PRIVATE_DATA_NODES;
+		break;
+	case REQUEST_PARTITION_INFO:
+		private = PRIVATE_DATA_PARTITIONS;
+		break;
+	default:
+		return false;
+	}
+
+	if (slurm_conf.private_data & private)
+		return false;
+	if (show_flags & SHOW_ALL)
+		return true;
+
+	parts = _get_entry(REQUEST_PARTITION_INFO, SHOW_ALL);
+	slurm_mutex_lock(&parts->mutex);
+	if (_refresh_entry(parts, now))
+		parts_uniform = false;
+	slurm_mutex_unlock(&parts->mutex);
+
+	return parts_uniform;
+}
+
+static int _send_rc(conmgr_fd_t *con, slurm_msg_t *msg, int rc)
+{
+	slurm_msg_t resp_msg;
+	return_code_msg_t rc_msg = {
+		.return_code = rc,
+	};
+
+	response_init(&resp_msg, msg, RESPONSE_SLURM_RC, &rc_msg);
+	return conmgr_queue_write_msg(con, &resp_msg);
+}
+
+static int _on_info_msg(conmgr_fd_t *con, slurm_msg_t *msg, void *arg)
+{
+	cache_entry_t *entry;
+	slurm_msg_t resp_msg;
+	time_t last_update, now = time(NULL);
+	uint16_t show_flags, resp_type;
+	int rc;
+
+	if (!msg->auth_ids_set) {
+		error("%s: [%s] rejecting %s RPC with missing user auth",
+		      __func__, conmgr_fd_get_name(con),
+		      rpc_num2string(msg->msg_type));
+		rc = _send_rc(con, msg, SLURM_PROTOCOL_AUTHENTICATION_ERROR);
+		goto end;
+	}
+
+	switch (msg->msg_type) {
+	case REQUEST_JOB_INFO:
+	{
+		job_info_request_msg_t *req = msg->data;
+		if (req->job_ids) {
+			rc = _send_rc(con, msg, ESLURM_NOT_SUPPORTED);
+			goto end;
+		}
+		last_update = req->last_update;
+		show_flags = req->show_flags;
+		resp_type = RESPONSE_JOB_INFO;
+		break;
+	}
+	case REQUEST_NODE_INFO:
+	{
+		node_info_request_msg_t *req = msg->data;
+		last_update = req->last_update;
+		show_flags = req->show_flags;
+		resp_type = RESPONSE_NODE_INFO;
+		break;
+	}
+	case REQUEST_PARTITION_INFO:
+	{
+		part_info_request_msg_t *req = msg->data;
+		last_update = req->last_update;
+		show_flags = req->show_flags;
+		resp_type = RESPONSE_PARTITION_INFO;
+		break;
+	}
+	default:
+		error("%s: [%s] unexpected message %s",
+		      __func__, conmgr_fd_get_name(con),
+		      rpc_num2string(msg->msg_type));
+		rc = _send_rc(con, msg, ESLURM_NOT_SUPPORTED);
+		goto end;
+	}
+
+	/* Cached data is packed for our own protocol version only */
+	if ((msg->protocol_version != SLURM_PROTOCOL_VERSION) ||
+	    !_cacheable(msg->msg_type, show_flags, now)) {
+		rc = _send_rc(con, msg, ESLURM_NOT_SUPPORTED);
+		goto end;
+	}
+
+	entry = _get_entry(msg->msg_type, show_flags);
+	slurm_mutex_lock(&entry->mutex);
+	if ((rc = _refresh_entry(entry, now))) {
+		slurm_mutex_unlock(&entry->mutex);
+		rc = _send_rc(con, msg, rc);
+		goto end;
+	}
+
+	if (last_update >= entry->last_update) {
+		slurm_mutex_unlock(&entry->mutex);
+		rc = _send_rc(con, msg, SLURM_NO_CHANGE_IN_DATA);
+		goto end;
+	}
+
+	response_init(&resp_msg, msg, resp_type, entry->data);
+	rc = conmgr_queue_write_msg(con, &resp_msg);
+	slurm_mutex_unlock(&entry->mutex);
+
+end:
+	slurm_free_msg(msg);
+	conmgr_queue_close_fd(con);
+	return rc;
+}
+
+extern void info_cache_init(int ttl)
+{
+	conmgr_events_t events = { .on_msg = _on_info_msg };
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+		.sun_path = SACKD_INFO_SOCKET,
+	};
+	mode_t mask;
+	int fd, rc;
+
+	cache_ttl = ttl;
+	cache_list = list_create(_free_entry);
+
+	if ((mkdir("/run/slurm", 0755) < 0) && (errno != EEXIST))
+		fatal("%s: failed to create /run/slurm: %m", __func__);
+	if (unlink(addr.sun_path) && (errno != ENOENT))
+		fatal("%s: failed to remove %s: %m", __func__, addr.sun_path);
+
+	if ((fd = socket(AF_UNIX, (SOCK_STREAM | SOCK_CLOEXEC), 0)) < 0)
+		fatal("%s: socket() failed: %m", __func__);
+
+	/* any local user may connect, auth is checked per RPC */
+	mask = umask(0);
+	if (bind(fd, (const struct sockaddr *) &addr, sizeof(addr)))
+		fatal("%s: [%s] Unable to bind UNIX socket: %m",
+		      __func__, addr.sun_path);
+	umask(mask);
+
+	if (listen(fd, SLURM_DEFAULT_LISTEN_BACKLOG))
+		fatal("%s: [%s] unable to listen(): %m",
+		      __func__, addr.sun_path);
+
+	if ((rc = conmgr_process_fd_unix_listen(CON_TYPE_RPC, fd, events,
+						(const slurm_addr_t *) &addr,
+						sizeof(addr), addr.sun_path,
+						NULL)))
+		fatal("%s: conmgr refused fd %d: %s",
+		      __func__, fd, slurm_strerror(rc));
+
+	info("serving cached job, node and partition info on %s with ttl=%ds",
+	     addr.sun_path, ttl);
+}
+
+extern void info_cache_fini(void)
+{
+	FREE_NULL_LIST(cache_list);
+}
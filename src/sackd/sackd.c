@@ -55,8 +55,12 @@
 #include "src/interfaces/auth.h"
 #include "src/interfaces/hash.h"
 
+#include "src/sackd/info_cache.h"
+
 decl_static_data(usage_txt);
 
+#define DEFAULT_INFO_CACHE_TTL 2
+
 static bool daemonize = true;
 static bool original = true;
 static bool reconfig = false;
@@ -65,6 +69,7 @@ static bool under_systemd = false;
 static char *conf_file = NULL;
 static char *conf_server = NULL;
 static char *dir = "/run/slurm/conf";
+static int info_cache_ttl = 0;
 
 static char **main_argv = NULL;
 static int listen_fd = -1;
@@ -85,11 +90,13 @@ static void _parse_args(int argc, char **argv)
 	enum {
 		LONG_OPT_ENUM_START = 0x100,
 		LONG_OPT_CONF_SERVER,
+		LONG_OPT_INFO_CACHE,
 		LONG_OPT_SYSTEMD,
 	};
 
 	static struct option long_options[] = {
 		{"conf-server", required_argument, 0, LONG_OPT_CONF_SERVER},
+		{"info-cache", optional_argument, 0, LONG_OPT_INFO_CACHE},
 		{"systemd", no_argument, 0, LONG_OPT_SYSTEMD},
 		{NULL, no_argument, 0, 'v'},
 		{NULL, 0, 0, 0}
@@ -120,6 +127,11 @@ static void _parse_args(int argc, char **argv)
 			xfree(conf_server);
 			conf_server = xstrdup(optarg);
 			break;
+		case LONG_OPT_INFO_CACHE:
+			info_cache_ttl = DEFAULT_INFO_CACHE_TTL;
+			if (optarg && ((info_cache_ttl = atoi(optarg)) <= 0))
+				fatal("Invalid --info-cache ttl: %s", optarg);
+			break;
 		case LONG_OPT_SYSTEMD:
 			under_systemd = true;
 			break;
@@ -420,6 +432,9 @@ extern int main(int argc, char **argv)
 	if (registered)
 		_listen_for_reconf();
 
+	if (info_cache_ttl)
+		info_cache_init(info_cache_ttl);
+
 	if (!original)
 		_notify_parent_of_success();
 	else if (under_systemd)
@@ -435,6 +450,7 @@ extern int main(int argc, char **argv)
 		_try_to_reconfig();
 	}
 
+	info_cache_fini();
 	xfree(conf_file);
 	xfree(conf_server);
 	return 0;
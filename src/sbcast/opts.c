@@ -61,6 +61,7 @@
 #define OPT_LONG_SEND_LIBS 0x103
 #define OPT_LONG_AUTOCOMP  0x104
 #define OPT_LONG_TREE_WIDTH 0x105
+#define OPT_LONG_PIPELINE  0x106
 
 
 /* getopt_long options, integers but not characters */
@@ -88,6 +89,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"force",     no_argument,       0, 'f'},
 		{"jobid",     required_argument, 0, 'j'},
 		{"send-libs", optional_argument, 0, OPT_LONG_SEND_LIBS},
+		{"pipeline",  required_argument, 0, OPT_LONG_PIPELINE},
 		{"preserve",  no_argument,       0, 'p'},
 		{"size",      required_argument, 0, 's'},
 		{"timeout",   required_argument, 0, 't'},
@@ -123,6 +125,9 @@ extern void parse_command_line(int argc, char **argv)
 	if (getenv("SBCAST_FORCE"))
 		params.flags |= BCAST_FLAG_FORCE;
 
+	if ((env_val = getenv("SBCAST_PIPELINE")))
+		params.pipeline = atoi(env_val);
+
 	if (getenv("SBCAST_PRESERVE"))
 		params.flags |= BCAST_FLAG_PRESERVE;
 
@@ -176,6 +181,9 @@ extern void parse_command_line(int argc, char **argv)
 		case (int)'j':
 			params.selected_step = slurm_parse_step_str(optarg);
 			break;
+		case OPT_LONG_PIPELINE:
+			params.pipeline = atoi(optarg);
+			break;
 		case (int)'p':
 			params.flags |= BCAST_FLAG_PRESERVE;
 			break;
@@ -294,6 +302,7 @@ static void _print_options( void )
 	info("force      = %s",
 	     (params.flags & BCAST_FLAG_FORCE) ? "true" : "false");
 	info("treewidth     = %d", params.tree_width);
+	info("pipeline   = %d", params.pipeline);
 	info("preserve   = %s",
 	     (params.flags & BCAST_FLAG_PRESERVE) ? "true" : "false");
 	info("send_libs  = %s",
@@ -320,6 +329,7 @@ Usage: sbcast [OPTIONS] SOURCE DEST\n\
   -f, --force           replace destination file as required\n\
   --treewidth=num       specify message treewidth\n\
   -j, --jobid=#[+#][.#] specify job ID with optional hetjob offset and/or step ID\n\
+  --pipeline=num        blocks of the file in flight at once\n\
   -p, --preserve        preserve modes and times of source file\n\
   --send-libs[=yes|no]  autodetect and broadcast executable's shared objects\n\
   -s, --size=num        block size in bytes (rounded off)\n\
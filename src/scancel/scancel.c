@@ -73,6 +73,7 @@ static void _filter_job_records(void);
 static void _load_job_records (void);
 static int  _multi_cluster(List clusters);
 static int  _proc_cluster(void);
+static int  _signal_jobs_by_filter(int *rc);
 static int  _signal_job_by_str(void);
 static int  _verify_job_ids(void);
 
@@ -144,15 +145,14 @@ _multi_cluster(List clusters)
 static int
 _proc_cluster(void)
 {
-	int rc, rc2;
+	int rc = 0, rc2;
+	bool filter = false;
 
 	if (has_default_opt() && !has_job_steps()) {
 		rc = _signal_job_by_str();
 		return rc;
 	}
 
-	_load_job_records();
-	rc = _verify_job_ids();
 	if ((opt.account) ||
 	    (opt.job_name) ||
 	    (opt.nodelist) ||
@@ -162,8 +162,16 @@ _proc_cluster(void)
 	    (opt.state != JOB_END) ||
 	    (opt.user_name) ||
 	    (opt.wckey)) {
-		_filter_job_records();
+		filter = true;
+		if (!opt.job_cnt && !opt.interactive && !opt.sibling &&
+		    (_signal_jobs_by_filter(&rc) == SLURM_SUCCESS))
+			return rc;
 	}
+
+	_load_job_records();
+	rc = _verify_job_ids();
+	if (filter)
+		_filter_job_records();
 	rc2 = _cancel_jobs();
 	rc = MAX(rc, rc2);
 	slurm_free_job_info_msg(job_buffer_ptr);
@@ -713,23 +721,15 @@ static void _add_delay(void)
 	return;
 }
 
-static void *
-_cancel_job_id (void *ci)
+/* Build the KILL_* flags for a job signal request from the options */
+static uint16_t _get_kill_flags(char **job_type)
 {
-	int error_code = SLURM_SUCCESS, i;
-	job_cancel_info_t *cancel_info = (job_cancel_info_t *)ci;
-	bool sig_set = true;
 	uint16_t flags = 0;
-	char *job_type = "";
-	DEF_TIMERS;
 
-	if (cancel_info->sig == NO_VAL16) {
-		cancel_info->sig = SIGKILL;
-		sig_set = false;
-	}
+	*job_type = "";
 	if (opt.batch) {
 		flags |= KILL_JOB_BATCH;
-		job_type = "batch ";
+		*job_type = "batch ";
 	}
 
 	/*
@@ -745,11 +745,30 @@ _cancel_job_id (void *ci)
 
 	if (opt.full) {
 		flags |= KILL_FULL_JOB;
-		job_type = "full ";
+		*job_type = "full ";
 	}
 	if (opt.hurry)
 		flags |= KILL_HURRY;
 
+	return flags;
+}
+
+static void *
+_cancel_job_id (void *ci)
+{
+	int error_code = SLURM_SUCCESS, i;
+	job_cancel_info_t *cancel_info = (job_cancel_info_t *)ci;
+	bool sig_set = true;
+	uint16_t flags = 0;
+	char *job_type = "";
+	DEF_TIMERS;
+
+	if (cancel_info->sig == NO_VAL16) {
+		cancel_info->sig = SIGKILL;
+		sig_set = false;
+	}
+	flags = _get_kill_flags(&job_type);
+
 	if (!cancel_info->job_id_str) {
 		if (cancel_info->array_job_id &&
 		    (cancel_info->array_task_id == INFINITE)) {
@@ -980,3 +999,83 @@ static int _signal_job_by_str(void)
 
 	return rc;
 }
+
+/*
+ * Signal all jobs matching the filter options with a single REQUEST_KILL_JOBS
+ * RPC, letting slurmctld select the jobs rather than loading every job record
+ * here and sending one RPC per job.
+ * RET SLURM_SUCCESS if the request was handled, otherwise the caller should
+ *	fall back to filtering the job records itself (e.g. older slurmctld or
+ *	federated cluster).
+ */
+static int _signal_jobs_by_filter(int *rc)
+{
+	kill_jobs_msg_t kill_msg = { 0 };
+	kill_jobs_resp_msg_t *kill_resp = NULL;
+	char *job_type = "";
+	bool sig_set = true;
+
+	/* If nodelist contains a '/', treat it as a file name */
+	if (opt.nodelist && strchr(opt.nodelist, '/')) {
+		char *reallist = slurm_read_hostfile(opt.nodelist, NO_VAL);
+		if (reallist) {
+			xfree(opt.nodelist);
+			opt.nodelist = reallist;
+		}
+	}
+
+	kill_msg.account = opt.account;
+	kill_msg.flags = _get_kill_flags(&job_type);
+	kill_msg.job_name = opt.job_name;
+	kill_msg.nodelist = opt.nodelist;
+	kill_msg.partition = opt.partition;
+	kill_msg.qos = opt.qos;
+	kill_msg.reservation = opt.reservation;
+	kill_msg.signal = opt.signal;
+	if (kill_msg.signal == NO_VAL16) {
+		kill_msg.signal = SIGKILL;
+		sig_set = false;
+	}
+	kill_msg.state = opt.state;
+	kill_msg.user_id = opt.user_name ? opt.user_id : NO_VAL;
+	kill_msg.wckey = opt.wckey;
+
+	if (slurm_kill_jobs(&kill_msg, &kill_resp)) {
+		debug("%s: slurm_kill_jobs: %s, filtering jobs locally",
+		      __func__, slurm_strerror(slurm_get_errno()));
+		return SLURM_ERROR;
+	}
+
+	if (!kill_resp->jobs_cnt && (opt.verbose > 0))
+		error("No active jobs match ALL job filters");
+
+	for (int i = 0; i < kill_resp->jobs_cnt; i++) {
+		kill_jobs_resp_job_t *job_resp = &kill_resp->job_responses[i];
+		int error_code = job_resp->error_code;
+
+		if (!sig_set)
+			verbose("Terminating %sjob %s", job_type,
+				job_resp->job_id_str);
+		else
+			verbose("Signal %u to %sjob %s", kill_msg.signal,
+				job_type, job_resp->job_id_str);
+
+		if (!error_code)
+			continue;
+		if ((opt.verbose > 0) ||
+		    ((error_code != ESLURM_ALREADY_DONE) &&
+		     (error_code != ESLURM_INVALID_JOB_ID))) {
+			error("Kill job error on job id %s: %s",
+			      job_resp->job_id_str, slurm_strerror(error_code));
+		}
+		if (((error_code == ESLURM_ALREADY_DONE) ||
+		     (error_code == ESLURM_INVALID_JOB_ID)) &&
+		    (kill_msg.signal == SIGKILL))
+			continue;	/* Ignore error if job done */
+		*rc = MAX(*rc, error_code);
+	}
+
+	slurm_free_kill_jobs_response_msg(kill_resp);
+
+	return SLURM_SUCCESS;
+}
@@ -35,6 +35,9 @@
 \*****************************************************************************/
 
 #include <limits.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "slurm/slurm.h"
 
@@ -42,6 +45,7 @@
 #include "src/common/cpu_frequency.h"
 #include "src/common/env.h"
 #include "src/common/net.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_opt.h"
 #include "src/common/slurm_protocol_defs.h"
@@ -56,6 +60,11 @@
 /* max number of seconds to delay while waiting for job */
 #define MAX_DELAY 60
 
+/* file in root directory holding the job environment of the warm allocation */
+#define WARM_ALLOC_FILE "warm_allocation"
+/* min number of seconds left in a warm allocation for it to be reused */
+#define WARM_ALLOC_MIN_REMAINING 60
+
 typedef struct {
 	const char *var;
 	int type;
@@ -196,6 +205,9 @@ static void _script_env(void)
 		_set_env_args(state, "SCRUN_GROUP_ID", "%u", state.group_id);
 	}
 	_set_env(state, "SCRUN_ROOT", state.root_dir);
+	if (state.warm_allocation)
+		_set_env(state, "SCRUN_WARM_ALLOCATION",
+			 (state.existing_allocation ? "reused" : "new"));
 	_set_env(state, "SCRUN_ROOTFS_PATH", state.root_path);
 	_set_env(state, "SCRUN_SUBMISSION_ROOTFS_PATH", state.root_path);
 
@@ -393,6 +405,140 @@ static uint32_t _setup_listener(void)
 	return port;
 }
 
+static bool _warm_allocation_requested(void)
+{
+	const char *val = getenv("SCRUN_WARM_ALLOCATION");
+
+	return (val && val[0] && xstrcmp(val, "0"));
+}
+
+static char *_warm_alloc_path(void)
+{
+	char *path;
+
+	read_lock_state();
+	path = xstrdup_printf("%s/%s", state.root_dir, WARM_ALLOC_FILE);
+	unlock_state();
+
+	return path;
+}
+
+/*
+ * Save the job environment of the newly allocated (and ready) job so the
+ * next containers can be launched as steps in it instead of waiting on a
+ * new allocation.
+ */
+static void _save_warm_allocation(void)
+{
+	char *path = _warm_alloc_path();
+	char *tmp = xstrdup_printf("%s.%d", path, getpid());
+	const char **env;
+	int rc, cnt = 0;
+
+	read_lock_state();
+	env = xcalloc((envcount(state.job_env) + 1), sizeof(*env));
+	for (int i = 0; state.job_env && state.job_env[i]; i++) {
+		/* skip variables specific to this container */
+		if (!xstrncmp(state.job_env[i], "SCRUN_", 6) ||
+		    !xstrncmp(state.job_env[i], "SLURM_PTY_", 10))
+			continue;
+		env[cnt++] = state.job_env[i];
+	}
+
+	rc = env_array_to_file(tmp, env, false);
+	unlock_state();
+
+	if (rc || (rename(tmp, path) && (rc = errno))) {
+		error("%s: unable to save warm allocation to %s: %s",
+		      __func__, path, slurm_strerror(rc));
+		(void) unlink(tmp);
+	} else {
+		debug("%s: saved warm allocation to %s", __func__, path);
+	}
+
+	xfree(env);
+	xfree(tmp);
+	xfree(path);
+}
+
+/*
+ * Look for the warm allocation left by a previous container.
+ * RET job info if the allocation is still usable or NULL
+ */
+static job_info_msg_t *_load_warm_allocation(void)
+{
+	char *path = _warm_alloc_path();
+	job_info_msg_t *jobs = NULL;
+	slurm_selected_step_t id = { 0 };
+	char **env = NULL, *data, *end;
+	const char *job_id_str;
+	buf_t *buf;
+	time_t now = time(NULL);
+	int rc;
+
+	if (!(buf = create_mmap_buf(path))) {
+		debug("%s: no warm allocation in %s", __func__, path);
+		goto done;
+	}
+
+	data = get_buf_data(buf);
+	end = data + size_buf(buf);
+	if (!size_buf(buf) || end[-1]) {
+		error("%s: ignoring invalid warm allocation in %s",
+		      __func__, path);
+		goto stale;
+	}
+
+	env = env_array_create();
+	for (; data < end; data += strlen(data) + 1) {
+		char *value, *name;
+
+		if (!(value = xstrchr(data, '=')))
+			continue;
+		name = xstrndup(data, (value - data));
+		env_array_overwrite(&env, name, (value + 1));
+		xfree(name);
+	}
+
+	if (!(job_id_str = getenvp(env, "SLURM_JOB_ID")) ||
+	    unfmt_job_id_string(job_id_str, &id))
+		goto stale;
+
+	if ((rc = slurm_load_job(&jobs, id.step_id.job_id, 0)) || !jobs ||
+	    (jobs->record_count <= 0)) {
+		debug("%s: warm JobId=%u not found",
+		      __func__, id.step_id.job_id);
+		goto stale;
+	}
+
+	if (!IS_JOB_RUNNING(jobs->job_array) ||
+	    (jobs->job_array->end_time &&
+	     (jobs->job_array->end_time <= (now + WARM_ALLOC_MIN_REMAINING)))) {
+		debug("%s: warm JobId=%u is no longer usable",
+		      __func__, id.step_id.job_id);
+		goto stale;
+	}
+
+	write_lock_state();
+	state.jobid = id.step_id.job_id;
+	state.existing_allocation = true;
+	state.warm_allocation = true;
+	SWAP(state.job_env, env);
+	unlock_state();
+	goto done;
+
+stale:
+	/* let the next container start a new warm allocation */
+	(void) unlink(path);
+	slurm_free_job_info_msg(jobs);
+	jobs = NULL;
+done:
+	env_array_free(env);
+	FREE_NULL_BUFFER(buf);
+	xfree(path);
+	return jobs;
+}
+
 static void _pending_callback(uint32_t job_id)
 {
 	info("waiting on pending job allocation %u", job_id);
@@ -405,12 +551,13 @@ extern void check_allocation(conmgr_fd_t *con, conmgr_work_type_t type,
 {
 	/* there must be only 1 thread that will call this at any one time */
 	static long delay = 1;
-	bool bail = false;
+	bool bail = false, warm_allocation;
 	int rc, job_id;
 
 	read_lock_state();
 	bail = (state.status != CONTAINER_ST_CREATING);
 	job_id = state.jobid;
+	warm_allocation = state.warm_allocation;
 	unlock_state();
 
 	if (bail) {
@@ -471,6 +618,9 @@ extern void check_allocation(conmgr_fd_t *con, conmgr_work_type_t type,
 			unlock_state();
 		}
 
+		if (warm_allocation)
+			_save_warm_allocation();
+
 		if ((rc = _stage_in())) {
 			stop_anchor(rc);
 		} else {
@@ -558,6 +708,7 @@ static void _alloc_job(void)
 
 	write_lock_state();
 	state.jobid = alloc->job_id;
+	state.warm_allocation = _warm_allocation_requested();
 
 	/* take job env (if any) for srun calls later */
 	SWAP(state.job_env, alloc->environment);
@@ -595,7 +746,7 @@ extern void get_allocation(conmgr_fd_t *con, conmgr_work_type_t type,
 			   conmgr_work_status_t status, const char *tag,
 			   void *arg)
 {
-	int rc;
+	int rc = SLURM_SUCCESS;
 	job_info_msg_t *jobs = NULL;
 	int job_id;
 	char *job_id_str = getenv("SLURM_JOB_ID");
@@ -622,6 +773,14 @@ extern void get_allocation(conmgr_fd_t *con, conmgr_work_type_t type,
 		unlock_state();
 
 		debug("Running under existing JobId=%u", job_id);
+	} else if (_warm_allocation_requested() &&
+		   (jobs = _load_warm_allocation())) {
+		read_lock_state();
+		job_id = state.jobid;
+		unlock_state();
+
+		existing_allocation = true;
+		debug("Running under warm allocation JobId=%u", job_id);
 	} else {
 		_alloc_job();
 
@@ -631,7 +790,8 @@ extern void get_allocation(conmgr_fd_t *con, conmgr_work_type_t type,
 	}
 
 	/* alloc response is too sparse. get full job info */
-	rc = slurm_load_job(&jobs, job_id, 0);
+	if (!jobs)
+		rc = slurm_load_job(&jobs, job_id, 0);
 	if (rc || !jobs || (jobs->record_count <= 0)) {
 		/* job not found or already died ? */
 		if ((rc == SLURM_ERROR) && errno)
@@ -407,7 +407,7 @@ static void _finish_job(conmgr_fd_t *con, conmgr_work_type_t type,
 			void *arg)
 {
 	int jobid, rc;
-	bool existing_allocation;
+	bool existing_allocation, warm_allocation;
 
 	xassert(!arg);
 
@@ -418,9 +418,10 @@ static void _finish_job(conmgr_fd_t *con, conmgr_work_type_t type,
 	jobid = state.jobid;
 	rc = state.srun_rc;
 	existing_allocation = state.existing_allocation;
+	warm_allocation = state.warm_allocation;
 	unlock_state();
 
-	if (existing_allocation) {
+	if (existing_allocation || warm_allocation) {
 		debug("%s: skipping slurm_complete_job(jobId=%u)",
 		      __func__, jobid);
 		goto done;
@@ -955,15 +956,33 @@ static int _start(conmgr_fd_t *con, slurm_msg_t *req_msg)
 
 static int _kill_job(conmgr_fd_t *con, int signal)
 {
-	int rc = SLURM_SUCCESS, jobid;
+	int rc = SLURM_SUCCESS, jobid, srun_pid;
+	bool warm_allocation;
 	container_state_msg_status_t status;
 
 	read_lock_state();
 	jobid = state.jobid;
 	status = state.status;
+	srun_pid = state.srun_pid;
+	warm_allocation = state.warm_allocation;
 	unlock_state();
 
-	if (jobid && (status <= CONTAINER_ST_STOPPING)) {
+	if (warm_allocation && (srun_pid > 0) &&
+	    (status <= CONTAINER_ST_STOPPING)) {
+		/*
+		 * Other containers may be running in the same allocation so
+		 * only signal our step through srun. srun can not catch
+		 * SIGKILL but terminates the step on SIGTERM.
+		 */
+		int sig = (signal == SIGKILL) ? SIGTERM : signal;
+
+		if (kill(srun_pid, sig))
+			rc = errno;
+
+		debug("%s: [%s] kill(srun[%d], Signal[%d]=%s) = %s",
+		      __func__, (con ? conmgr_fd_get_name(con) : "self"),
+		      srun_pid, sig, strsignal(sig), slurm_strerror(rc));
+	} else if (jobid && (status <= CONTAINER_ST_STOPPING)) {
 		rc = slurm_kill_job(jobid, signal, KILL_FULL_JOB);
 
 		debug("%s: [%s] slurm_kill_job(JobID=%d, Signal[%d]=%s, 0) = %s",
@@ -78,6 +78,7 @@ typedef struct {
 	char *pid_file; /* full path for pid file */
 	int pid_file_fd; /* file descriptor for pid file */
 	bool existing_allocation; /* running an existing job allocation */
+	bool warm_allocation; /* job allocation shared with later containers */
 	uint32_t jobid; /* assigned jobID */
 	bool job_completed; /* has job been completed */
 	bool staged_out; /* stage out done */
@@ -61,6 +61,8 @@ stats_info_response_msg_t *buf;
 uint32_t *rpc_type_ave_time = NULL, *rpc_user_ave_time = NULL;
 
 static int  _print_stats(void);
+static void _print_lock_hist(const char *label, uint64_t *hist);
+static void _print_rpc_cost(void);
 static void _sort_rpc(void);
 
 stats_info_request_msg_t req;
@@ -154,6 +156,13 @@ static int _print_stats(void)
 		       ((buf->req_time - buf->req_time_start) / 60)));
 	}
 	printf("\tLast queue length: %u\n", buf->schedule_queue_len);
+	if (buf->schedule_adapt_interval || buf->schedule_adapt_depth) {
+		printf("\tAdaptive interval: %u\n",
+		       buf->schedule_adapt_interval);
+		printf("\tAdaptive depth: %u\n", buf->schedule_adapt_depth);
+		printf("\tAdaptive pressure: %u%%\n",
+		       buf->schedule_adapt_pressure);
+	}
 
 	printf("\nMain scheduler exit:\n");
 
@@ -258,9 +267,123 @@ static int _print_stats(void)
 		       buf->rpc_dump_hostlist[i]);
 	}
 
+	if (buf->lock_stats_count)
+		printf("\nLock statistics (microseconds)\n");
+	for (i = 0; i < buf->lock_stats_count; i++) {
+		uint32_t hist_inx = i * buf->lock_stats_hist_count;
+
+		if (!buf->lock_stats_acquired[i])
+			continue;
+
+		printf("\t%-20s count:%-8"PRIu64" wait_max:%-8"PRIu64
+		       " wait_total:%"PRIu64"",
+		       buf->lock_stats_name[i], buf->lock_stats_acquired[i],
+		       buf->lock_stats_wait_max[i],
+		       buf->lock_stats_wait_time[i]);
+		if (buf->lock_stats_hold_time[i])
+			printf(" hold_max:%-8"PRIu64" hold_total:%"PRIu64"",
+			       buf->lock_stats_hold_max[i],
+			       buf->lock_stats_hold_time[i]);
+		printf("\n");
+
+		_print_lock_hist("wait", &buf->lock_stats_wait_hist[hist_inx]);
+		if (buf->lock_stats_hold_time[i])
+			_print_lock_hist("hold",
+					 &buf->lock_stats_hold_hist[hist_inx]);
+	}
+
+	if (buf->rpcq_count)
+		printf("\nRPC queues\n");
+	for (i = 0; i < buf->rpcq_count; i++) {
+		printf("\t%-40s depth:%-6u",
+		       rpc_num2string(buf->rpcq_type[i]),
+		       buf->rpcq_depth[i]);
+		if (buf->rpcq_depth_limit[i] != NO_VAL)
+			printf(" limit:%-6u", buf->rpcq_depth_limit[i]);
+		printf(" rejected:%"PRIu64"\n", buf->rpcq_rejected[i]);
+	}
+
+	_print_rpc_cost();
+
 	return 0;
 }
 
+/* Return indexes of values[] ordered from the largest value down */
+static int *_sort_by_value(uint64_t *values, uint32_t cnt)
+{
+	int *order = xcalloc(cnt, sizeof(*order));
+
+	for (int i = 0; i < cnt; i++)
+		order[i] = i;
+	for (int i = 0; i < cnt; i++) {
+		for (int j = i + 1; j < cnt; j++) {
+			if (values[order[i]] >= values[order[j]])
+				continue;
+			SWAP(order[i], order[j]);
+		}
+	}
+
+	return order;
+}
+
+/* Print CPU time, lock wait and reply bytes per RPC, most CPU first */
+static void _print_rpc_cost(void)
+{
+	int *order;
+
+	if (buf->rpc_cost_type_size) {
+		printf("\nRemote Procedure Call cost by message type (microseconds, bytes)\n");
+		order = _sort_by_value(buf->rpc_cost_type_cpu_time,
+				       buf->rpc_cost_type_size);
+		for (int k = 0; k < buf->rpc_cost_type_size; k++) {
+			int i = order[k];
+
+			printf("\t%-40s(%5u) cpu_time:%-10"PRIu64
+			       " lock_wait:%-10"PRIu64" bytes_sent:%"PRIu64"\n",
+			       rpc_num2string(buf->rpc_cost_type_id[i]),
+			       buf->rpc_cost_type_id[i],
+			       buf->rpc_cost_type_cpu_time[i],
+			       buf->rpc_cost_type_lock_wait[i],
+			       buf->rpc_cost_type_bytes[i]);
+		}
+		xfree(order);
+	}
+
+	if (buf->rpc_cost_user_size) {
+		printf("\nRemote Procedure Call cost by user (microseconds, bytes)\n");
+		order = _sort_by_value(buf->rpc_cost_user_cpu_time,
+				       buf->rpc_cost_user_size);
+		for (int k = 0; k < buf->rpc_cost_user_size; k++) {
+			int i = order[k];
+			char *user = uid_to_string(buf->rpc_cost_user_id[i]);
+
+			printf("\t%-16s(%8u) cpu_time:%-10"PRIu64
+			       " lock_wait:%-10"PRIu64" bytes_sent:%"PRIu64"\n",
+			       user, buf->rpc_cost_user_id[i],
+			       buf->rpc_cost_user_cpu_time[i],
+			       buf->rpc_cost_user_lock_wait[i],
+			       buf->rpc_cost_user_bytes[i]);
+			xfree(user);
+		}
+		xfree(order);
+	}
+}
+
+/* Print one lock histogram, bucket i counting durations < 10^(i+1) usec */
+static void _print_lock_hist(const char *label, uint64_t *hist)
+{
+	uint64_t bound = 10;
+
+	printf("\t\t%s:", label);
+	for (int i = 0; i < buf->lock_stats_hist_count; i++, bound *= 10) {
+		if (i == (buf->lock_stats_hist_count - 1))
+			printf(" >=%"PRIu64"us:%"PRIu64, (bound / 10), hist[i]);
+		else
+			printf(" <%"PRIu64"us:%"PRIu64, bound, hist[i]);
+	}
+	printf("\n");
+}
+
 static void _sort_rpc(void)
 {
 	int i, j;
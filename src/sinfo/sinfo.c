@@ -1023,7 +1023,7 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 		sinfo_ptr->max_cpus_per_node = sinfo_ptr->part_info->
 					       max_cpus_per_node;
 		sinfo_ptr->version    = node_ptr->version;
-	} else if (hostlist_find(sinfo_ptr->nodes, node_ptr->name) != -1) {
+	} else if (xhash_get_str(sinfo_ptr->node_hash, node_ptr->name)) {
 		/* we already have this node in this record,
 		 * just return, don't duplicate */
 		return;
@@ -1074,8 +1074,8 @@ static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr)
 			sinfo_ptr->max_free_mem = node_ptr->free_mem;
 	}
 
-	if (hostlist_find(sinfo_ptr->nodes, node_ptr->name) == -1)
-		hostlist_push_host(sinfo_ptr->nodes, node_ptr->name);
+	hostlist_push_host(sinfo_ptr->nodes, node_ptr->name);
+	xhash_add(sinfo_ptr->node_hash, node_ptr);
 	if ((params.match_flags & MATCH_FLAG_NODE_ADDR) &&
 	    (hostlist_find(sinfo_ptr->node_addr, node_ptr->node_addr) == -1))
 		hostlist_push_host(sinfo_ptr->node_addr, node_ptr->node_addr);
@@ -1146,6 +1146,15 @@ static int _insert_node_ptr(List sinfo_list, uint16_t part_num,
 	return rc;
 }
 
+static void _node_hash_identity(void *item, const char **key,
+				uint32_t *key_len)
+{
+	node_info_t *node_ptr = item;
+
+	*key = node_ptr->name;
+	*key_len = strlen(node_ptr->name);
+}
+
 /*
  * _create_sinfo - create an sinfo record for the given node and partition
  * sinfo_list IN/OUT - table of accumulated sinfo records
@@ -1163,6 +1172,7 @@ static sinfo_data_t *_create_sinfo(partition_info_t* part_ptr,
 	sinfo_ptr->part_info = part_ptr;
 	sinfo_ptr->part_inx = part_inx;
 	sinfo_ptr->nodes     = hostlist_create(NULL);
+	sinfo_ptr->node_hash = xhash_init(_node_hash_identity, NULL);
 	sinfo_ptr->node_addr = hostlist_create(NULL);
 	sinfo_ptr->hostnames = hostlist_create(NULL);
 
@@ -1191,6 +1201,7 @@ static void _sinfo_list_delete(void *data)
 	sinfo_data_t *sinfo_ptr = data;
 
 	hostlist_destroy(sinfo_ptr->nodes);
+	xhash_free(sinfo_ptr->node_hash);
 	hostlist_destroy(sinfo_ptr->node_addr);
 	hostlist_destroy(sinfo_ptr->hostnames);
 	xfree(sinfo_ptr);
@@ -56,6 +56,7 @@
 #include "src/common/log.h"
 #include "src/common/macros.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/slurmdb_defs.h"
 
@@ -112,6 +113,7 @@ typedef struct {
 	hostlist_t *hostnames;
 	hostlist_t *node_addr;
 	hostlist_t *nodes;
+	xhash_t *node_hash;	/* node_info_t in nodes, by name */
 
 	/* part_info contains partition, avail, max_time, job_size,
 	 * root, share/oversubscribe, groups, priority */
@@ -1436,11 +1436,12 @@ static acct_policy_tres_usage_t _validate_tres_usage_limits(
 	for (i = 0; i < g_tres_count; i++) {
 		(*tres_pos) = i;
 
-		if ((admin_limit_set &&
+		/* Most TRES have no limit, test that first */
+		if ((tres_limit_array[i] == INFINITE64) ||
+		    (admin_limit_set &&
 		     admin_limit_set[i] == ADMIN_SET_LIMIT) ||
 		    (out_tres_limit_array &&
-		     out_tres_limit_array[i] != INFINITE64) ||
-		    (tres_limit_array[i] == INFINITE64))
+		     out_tres_limit_array[i] != INFINITE64))
 			continue;
 
 		if (out_tres_limit_set && out_tres_limit_array)
@@ -3801,12 +3802,24 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 	assoc_ptr = job_ptr->assoc_ptr;
 	while (assoc_ptr) {
 		for (i = 0; i < slurmctld_tres_cnt; i++) {
-			tres_usage_mins[i] =
-				(uint64_t)(assoc_ptr->usage->usage_tres_raw[i]
-					   / 60);
-			tres_run_mins[i] =
-				assoc_ptr->usage->grp_used_tres_run_secs[i] /
-				60;
+			/*
+			 * The minute counters are only looked at for TRES
+			 * with a GrpTRESMins or GrpTRESRunMins limit on this
+			 * association, don't convert the rest. Most
+			 * associations in the chain have no such limit.
+			 */
+			if ((assoc_ptr->grp_tres_mins_ctld[i] == INFINITE64) &&
+			    (assoc_ptr->grp_tres_run_mins_ctld[i] ==
+			     INFINITE64)) {
+				tres_usage_mins[i] = 0;
+				tres_run_mins[i] = 0;
+			} else {
+				tres_usage_mins[i] = (uint64_t)
+					(assoc_ptr->usage->usage_tres_raw[i] /
+					 60);
+				tres_run_mins[i] = assoc_ptr->usage->
+					grp_used_tres_run_secs[i] / 60;
+			}
 
 			/*
 			 * Clear usage if factor is 0 so that jobs can run.
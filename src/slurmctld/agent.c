@@ -55,6 +55,9 @@
  *  communicated with up to AGENT_THREAD_COUNT. A special watchdog thread
  *  sends SIGLARM to any threads that have been active (in DSH_ACTIVE state)
  *  for more than MessageTimeout seconds.
+ *  Queued requests that kill jobs are started ahead of other queued work,
+ *  and queued node probes (ping, health check, etc.) of the same type are
+ *  merged into one request.
  *  The agent responds to slurmctld via a function call or an RPC as required.
  *  For example, informing slurmctld that some node is not responding.
  *
@@ -81,6 +84,7 @@
 #include "src/common/env.h"
 #include "src/common/fd.h"
 #include "src/common/forward.h"
+#include "src/common/job_trace.h"
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
@@ -159,6 +163,7 @@ typedef struct {
 	void **msg_args_pptr;		/* RPC data to be used */
 	uint16_t msg_flags;		/* Flags to be added to msg*/
 	uint16_t protocol_version;	/* if set, use this version */
+	msg_auth_share_t *auth_share;	/* credential shared by all threads */
 } agent_info_t;
 
 typedef struct {
@@ -174,6 +179,7 @@ typedef struct {
 	void *msg_args_ptr;		/* ptr to RPC data to be used */
 	uint16_t msg_flags;		/* Flags to be added to msg*/
 	uint16_t protocol_version;	/* if set, use this version */
+	msg_auth_share_t *auth_share;	/* credential shared by all threads */
 } task_info_t;
 
 typedef struct {
@@ -395,6 +401,7 @@ cleanup:
 	_purge_agent_args(agent_arg_ptr);
 
 	if (agent_info_ptr) {
+		slurm_msg_auth_share_destroy(agent_info_ptr->auth_share);
 		xfree(agent_info_ptr->thread_struct);
 		xfree(agent_info_ptr);
 	}
@@ -474,6 +481,13 @@ static agent_info_t *_make_agent_info(agent_arg_t *agent_arg_ptr)
 	if (!agent_info_ptr->thread_count)
 		return agent_info_ptr;
 
+	/*
+	 * Every thread (and every branch of a message tree) sends to a
+	 * distinct node, so one credential serves the whole broadcast.
+	 */
+	if (!agent_arg_ptr->addr)
+		agent_info_ptr->auth_share = slurm_msg_auth_share_create();
+
 	xassert(agent_arg_ptr->node_count ==
 		hostlist_count(agent_arg_ptr->hostlist));
 
@@ -572,6 +586,7 @@ static task_info_t *_make_task_data(agent_info_t *agent_info_ptr, int inx)
 	task_info_ptr->msg_args_ptr      = *agent_info_ptr->msg_args_pptr;
 	task_info_ptr->msg_flags = agent_info_ptr->msg_flags;
 	task_info_ptr->protocol_version  = agent_info_ptr->protocol_version;
+	task_info_ptr->auth_share        = agent_info_ptr->auth_share;
 
 	return task_info_ptr;
 }
@@ -952,6 +967,7 @@ static void *_thread_per_group_rpc(void *args)
 	slurmctld_lock_t node_write_lock = {
 		NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
 	uint32_t job_id;
+	job_trace_span_t span;
 
 	xassert(args != NULL);
 	xsignal(SIGUSR1, _sig_handler);
@@ -977,6 +993,7 @@ static void *_thread_per_group_rpc(void *args)
 	slurm_mutex_unlock(thread_mutex_ptr);
 
 	/* send request message */
+	job_trace_start(&span);
 	slurm_msg_t_init(&msg);
 
 	if (task_ptr->protocol_version)
@@ -986,6 +1003,7 @@ static void *_thread_per_group_rpc(void *args)
 	msg.data     = task_ptr->msg_args_ptr;
 	slurm_msg_set_r_uid(&msg, task_ptr->r_uid);
 	msg.flags |= task_ptr->msg_flags;
+	msg.auth_share = task_ptr->auth_share;
 
 	if (thread_ptr->nodename)
 		log_flag(AGENT, "%s: sending %s to %s", __func__,
@@ -1260,6 +1278,12 @@ static void *_thread_per_group_rpc(void *args)
 	list_iterator_destroy(itr);
 
 cleanup:
+	if (msg_type == REQUEST_BATCH_JOB_LAUNCH) {
+		batch_job_launch_msg_t *launch_msg_ptr =
+			task_ptr->msg_args_ptr;
+		job_trace_end(&span, launch_msg_ptr->job_id,
+			      "agent_batch_launch");
+	}
 	if (!ret_list && (msg_type == REQUEST_SIGNAL_TASKS)) {
 		job_record_t *job_ptr;
 		signal_tasks_msg_t *msg_ptr =
@@ -1791,6 +1815,61 @@ static void _agent_defer(void)
 	unlock_slurmctld(job_write_lock);
 }
 
+/* Requests that release resources go ahead of anything else queued */
+static bool _is_urgent_request(agent_arg_t *agent_arg_ptr)
+{
+	return ((agent_arg_ptr->msg_type == REQUEST_KILL_TIMELIMIT) ||
+		(agent_arg_ptr->msg_type == REQUEST_KILL_PREEMPTED) ||
+		(agent_arg_ptr->msg_type == REQUEST_TERMINATE_JOB) ||
+		(agent_arg_ptr->msg_type == REQUEST_ABORT_JOB));
+}
+
+static int _find_urgent_request(void *x, void *key)
+{
+	queued_request_t *queued_req_ptr = x;
+
+	if (!queued_req_ptr->last_attempt &&
+	    _is_urgent_request(queued_req_ptr->agent_arg_ptr))
+		return 1;
+
+	return 0;
+}
+
+/*
+ * Return true if the request is a node status probe that carries no data
+ * and can be merged into another queued probe of the same type.
+ */
+static bool _is_mergeable_request(agent_arg_t *agent_arg_ptr)
+{
+	if (agent_arg_ptr->msg_args || agent_arg_ptr->addr)
+		return false;
+
+	return ((agent_arg_ptr->msg_type == REQUEST_PING) ||
+		(agent_arg_ptr->msg_type == REQUEST_HEALTH_CHECK) ||
+		(agent_arg_ptr->msg_type == REQUEST_ACCT_GATHER_UPDATE) ||
+		(agent_arg_ptr->msg_type == REQUEST_NODE_REGISTRATION_STATUS));
+}
+
+static int _find_mergeable_request(void *x, void *key)
+{
+	queued_request_t *queued_req_ptr = x;
+	agent_arg_t *queued = queued_req_ptr->agent_arg_ptr;
+	agent_arg_t *agent_arg_ptr = key;
+
+	if (queued_req_ptr->last_attempt || !_is_mergeable_request(queued))
+		return 0;
+
+	if ((queued->msg_type != agent_arg_ptr->msg_type) ||
+	    (queued->protocol_version != agent_arg_ptr->protocol_version) ||
+	    (queued->msg_flags != agent_arg_ptr->msg_flags) ||
+	    (queued->retry != agent_arg_ptr->retry) ||
+	    (queued->r_uid_set != agent_arg_ptr->r_uid_set) ||
+	    (queued->r_uid != agent_arg_ptr->r_uid))
+		return 0;
+
+	return 1;
+}
+
 static int _find_request(void *x, void *key)
 {
 	queued_request_t *queued_req_ptr = x;
@@ -1853,7 +1932,13 @@ next:
 	}
 
 	if (retry_list) {
-		/* first try to find a new (never tried) record */
+		/* first try to find a new (never tried) kill request */
+		queued_req_ptr = list_remove_first(retry_list,
+						   _find_urgent_request, NULL);
+	}
+
+	if (retry_list && (queued_req_ptr == NULL)) {
+		/* then try to find any new (never tried) record */
 		double key = 0;
 
 		queued_req_ptr = list_remove_first(retry_list, _find_request,
@@ -1941,11 +2026,43 @@ void agent_queue_request(agent_arg_t *agent_arg_ptr)
 		list_append(defer_list, (void *)queued_req_ptr);
 		slurm_mutex_unlock(&defer_mutex);
 	} else {
+		queued_request_t *merge_req_ptr = NULL;
+
 		slurm_mutex_lock(&retry_mutex);
 		if (retry_list == NULL)
 			retry_list = list_create(_list_delete_retry);
-		list_append(retry_list, (void *)queued_req_ptr);
+		if (_is_mergeable_request(agent_arg_ptr))
+			merge_req_ptr = list_find_first(retry_list,
+							_find_mergeable_request,
+							agent_arg_ptr);
+		if (merge_req_ptr) {
+			/*
+			 * An identical probe is still waiting for an agent,
+			 * add our nodes to it rather than queue a second one.
+			 */
+			agent_arg_t *merge_arg_ptr =
+				merge_req_ptr->agent_arg_ptr;
+
+			hostlist_push_list(merge_arg_ptr->hostlist,
+					   agent_arg_ptr->hostlist);
+			hostlist_uniq(merge_arg_ptr->hostlist);
+			merge_arg_ptr->node_count =
+				hostlist_count(merge_arg_ptr->hostlist);
+			log_flag(AGENT, "%s: merged %s into queued request for %u nodes",
+				 __func__,
+				 rpc_num2string(agent_arg_ptr->msg_type),
+				 merge_arg_ptr->node_count);
+		} else {
+			list_append(retry_list, (void *)queued_req_ptr);
+		}
 		slurm_mutex_unlock(&retry_mutex);
+
+		if (merge_req_ptr) {
+			_purge_agent_args(agent_arg_ptr);
+			xfree(queued_req_ptr);
+			/* the merged request's agent will never run */
+			ping_end();
+		}
 	}
 	/* now process the request in a separate pthread
 	 * (if we can create another pthread to do so) */
@@ -40,6 +40,7 @@
 #include "config.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <pthread.h>
 #include <signal.h>
@@ -72,6 +73,7 @@
 
 #define _DEBUG		0
 #define SHUTDOWN_WAIT	2	/* Time to wait for primary server shutdown */
+#define PREFETCH_INTERVAL 60	/* Seconds between state file prefetches */
 
 static int          _background_process_msg(slurm_msg_t * msg);
 static void *       _background_rpc_mgr(void *no_data);
@@ -108,6 +110,18 @@ static int		shutdown_timeout = 0;
  * Static list of signals to block in this process
  * *Must be zero-terminated*
  */
+/*
+ * State files read by read_slurm_conf(2) on takeover. Keeping them in the
+ * page cache means the takeover doesn't wait on StateSaveLocation reads.
+ */
+static const char *prefetch_files[] = {
+	"assoc_mgr_state", "assoc_usage", "fed_mgr_state", "job_state",
+	"node_state", "part_state", "qos_usage", "resv_state",
+	"trigger_state",
+};
+static time_t prefetch_mtime[ARRAY_SIZE(prefetch_files)];
+static off_t prefetch_size[ARRAY_SIZE(prefetch_files)];
+
 static int backup_sigarray[] = {
 	SIGINT,  SIGTERM, SIGCHLD, SIGUSR1,
 	SIGUSR2, SIGTSTP, SIGXCPU, SIGQUIT,
@@ -118,10 +132,53 @@ static int backup_sigarray[] = {
  * run_backup - this is the backup controller, it should run in standby
  *	mode, assuming control when the primary controller stops responding
  */
+/*
+ * Read every state file that changed since the last pass, so that the
+ * primary's latest state is cached locally when we have to take over.
+ */
+static void _prefetch_state_files(void)
+{
+	static char buf[64 * 1024];
+
+	for (int i = 0; i < ARRAY_SIZE(prefetch_files); i++) {
+		char *file = NULL;
+		struct stat st;
+		ssize_t len;
+		int fd;
+
+		xstrfmtcat(file, "%s/%s", slurm_conf.state_save_location,
+			   prefetch_files[i]);
+		if ((fd = open(file, O_RDONLY | O_CLOEXEC)) < 0) {
+			xfree(file);
+			continue;
+		}
+		if (fstat(fd, &st) ||
+		    ((st.st_mtime == prefetch_mtime[i]) &&
+		     (st.st_size == prefetch_size[i]))) {
+			close(fd);
+			xfree(file);
+			continue;
+		}
+
+		(void) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		while (((len = read(fd, buf, sizeof(buf))) > 0) ||
+		       ((len < 0) && (errno == EINTR)))
+			;
+		if (len == 0) {
+			prefetch_mtime[i] = st.st_mtime;
+			prefetch_size[i] = st.st_size;
+		}
+		debug2("%s: read %s (%"PRIu64" bytes)",
+		       __func__, file, (uint64_t) st.st_size);
+		close(fd);
+		xfree(file);
+	}
+}
+
 void run_backup(void)
 {
 	int i;
-	time_t last_ping = 0;
+	time_t last_ping = 0, last_prefetch = 0;
 	slurmctld_lock_t config_read_lock = {
 		READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 	slurmctld_lock_t config_write_lock = {
@@ -170,6 +227,11 @@ void run_backup(void)
 	/* repeatedly ping ControlMachine */
 	while (slurmctld_config.shutdown_time == 0) {
 		sleep(1);
+		if (!takeover &&
+		    ((time(NULL) - last_prefetch) >= PREFETCH_INTERVAL)) {
+			_prefetch_state_files();
+			last_prefetch = time(NULL);
+		}
 		/* Lock of slurm_conf below not important */
 		if (slurm_conf.slurmctld_timeout && (takeover == false) &&
 		    ((time(NULL) - last_ping) <
@@ -47,6 +47,9 @@
 #include <errno.h>
 #include <getopt.h>
 #include <grp.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 #include <poll.h>
 #include <pthread.h>
 #include <signal.h>
@@ -67,6 +70,7 @@
 #include "src/common/hostlist.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/openmetrics.h"
 #include "src/common/pack.h"
 #include "src/common/proc_args.h"
 #include "src/common/read_config.h"
@@ -213,6 +217,7 @@ static int      job_sched_cnt = 0;
 static int main_argc = 0;
 static char **main_argv = NULL;
 static uint32_t max_server_threads = MAX_SERVER_THREADS;
+static int metrics_fd = -1;
 static time_t	next_stats_reset = 0;
 static int	new_nice = 0;
 static bool original = true;
@@ -235,6 +240,17 @@ static pthread_mutex_t shutdown_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t shutdown_cond = PTHREAD_COND_INITIALIZER;
 static bool under_systemd = false;
 
+/*
+ * Pool of reusable connection service threads, used instead of creating a
+ * detached thread for every accepted RPC. The number of connections in
+ * flight is still bounded by max_server_threads.
+ */
+#define SRVCN_IDLE_TIMEOUT 60	/* seconds before an idle thread exits */
+static list_t *srvcn_queue = NULL;
+static pthread_mutex_t srvcn_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t srvcn_cond = PTHREAD_COND_INITIALIZER;
+static int srvcn_idle = 0;
+
 /*
  * Static list of signals to block in this process
  * *Must be zero-terminated*
@@ -260,6 +276,7 @@ static void         _create_clustername_file(void);
 static void _flush_rpcs(void);
 static void         _get_fed_updates();
 static void         _init_config(void);
+static void _init_metrics(void);
 static void         _init_pidfile(void);
 static int          _init_tres(void);
 static void         _kill_old_slurmctld(void);
@@ -274,6 +291,8 @@ static void         _restore_job_dependencies(void);
 static void         _run_primary_prog(bool primary_on);
 static void         _send_future_cloud_to_db();
 static void *       _service_connection(void *arg);
+static void _srvcn_queue_conn(int *newsockfd);
+static void _srvcn_wake_all(void);
 static void         _set_work_dir(void);
 static int          _shutdown_backup_controller(void);
 static void *       _slurmctld_background(void *no_data);
@@ -532,6 +551,7 @@ int main(int argc, char **argv)
 		fatal("Failed to initialize switch plugin");
 
 	agent_init();
+	_init_metrics();
 
 	if (original && under_systemd)
 		xsystemd_change_mainpid(getpid());
@@ -990,6 +1010,30 @@ static void  _init_config(void)
 	slurmctld_config.thread_id_rpc     = (pthread_t) 0;
 }
 
+/*
+ * Serve the statistics in OpenMetrics format if
+ * SlurmctldParameters=metrics_port is set. The listening socket is inherited
+ * across reconfigure like the RPC ports, so changing the port needs a restart.
+ */
+static void _init_metrics(void)
+{
+	uint16_t port;
+
+	if (getenv("SLURMCTLD_RECONF_METRICS_FD")) {
+		metrics_fd = atoi(getenv("SLURMCTLD_RECONF_METRICS_FD"));
+	} else if (!(port = openmetrics_parse_port(
+			     slurm_conf.slurmctld_params))) {
+		return;
+	} else if ((metrics_fd = slurm_init_msg_engine_port(port)) < 0) {
+		error("%s: unable to listen on metrics port %hu: %m",
+		      __func__, port);
+		return;
+	}
+
+	if (openmetrics_listen(metrics_fd, dump_all_metrics))
+		metrics_fd = -1;
+}
+
 static int _try_to_reconfig(void)
 {
 	extern char **environ;
@@ -1022,6 +1066,11 @@ static int _try_to_reconfig(void)
 		setenvf(&child_env, "SLURMCTLD_RECONF_LISTEN_FDS", "%s", ports);
 		xfree(ports);
 	}
+	if (metrics_fd != -1) {
+		setenvf(&child_env, "SLURMCTLD_RECONF_METRICS_FD", "%d",
+			metrics_fd);
+		fd_set_noclose_on_exec(metrics_fd);
+	}
 	for (int i = 0; i < 3; i++)
 		fd_set_noclose_on_exec(i);
 	if (!daemonize && !under_systemd) {
@@ -1088,6 +1137,8 @@ start_child:
 			continue;
 		if (fd == pidfd)
 			continue;
+		if (fd == metrics_fd)
+			continue;
 		for (int i = 0; i < listen_nports; i++) {
 			if (fd == listen_fds[i].fd) {
 				match = true;
@@ -1365,11 +1416,13 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 			slurmctld_diag_stats.proc_req_raw++;
 			_service_connection(newsockfd);
 		} else {
-			slurm_thread_create_detached(_service_connection,
-						     newsockfd);
+			_srvcn_queue_conn(newsockfd);
 		}
 	}
 
+	/* let idle service threads notice shutdown_time */
+	_srvcn_wake_all();
+
 	/* leave ports open */
 	if (reconfig)
 		return NULL;
@@ -1440,6 +1493,67 @@ cleanup:
 	return NULL;
 }
 
+/* Run queued connections until idle for too long or shutdown */
+static void *_srvcn_thread(void *no_data)
+{
+	int *newsockfd;
+
+	slurm_mutex_lock(&srvcn_mutex);
+	while (1) {
+		if (!(newsockfd = list_dequeue(srvcn_queue))) {
+			struct timespec ts = {
+				.tv_sec = time(NULL) + SRVCN_IDLE_TIMEOUT,
+			};
+			int rc;
+
+			if (slurmctld_config.shutdown_time)
+				break;
+
+			srvcn_idle++;
+			rc = pthread_cond_timedwait(&srvcn_cond, &srvcn_mutex,
+						    &ts);
+			srvcn_idle--;
+
+			if ((rc == ETIMEDOUT) && list_is_empty(srvcn_queue))
+				break;
+			continue;
+		}
+		slurm_mutex_unlock(&srvcn_mutex);
+
+		_service_connection(newsockfd);
+
+		slurm_mutex_lock(&srvcn_mutex);
+	}
+	slurm_mutex_unlock(&srvcn_mutex);
+
+	return NULL;
+}
+
+/*
+ * Hand an accepted connection to an idle service thread, starting a new one
+ * only when all existing threads are busy.
+ */
+static void _srvcn_queue_conn(int *newsockfd)
+{
+	slurm_mutex_lock(&srvcn_mutex);
+	if (!srvcn_queue)
+		srvcn_queue = list_create(NULL);
+	list_enqueue(srvcn_queue, newsockfd);
+
+	if (list_count(srvcn_queue) > srvcn_idle)
+		slurm_thread_create_detached(_srvcn_thread, NULL);
+	else
+		slurm_cond_signal(&srvcn_cond);
+	slurm_mutex_unlock(&srvcn_mutex);
+}
+
+static void _srvcn_wake_all(void)
+{
+	slurm_mutex_lock(&srvcn_mutex);
+	slurm_cond_broadcast(&srvcn_cond);
+	slurm_mutex_unlock(&srvcn_mutex);
+}
+
 /* Increment slurmctld_config.server_thread_count and don't return
  * until its value is no larger than MAX_SERVER_THREADS,
  * RET true unless shutdown in progress */
@@ -2018,6 +2132,7 @@ static void *_slurmctld_background(void *no_data)
 	static time_t last_node_acct;
 	static time_t last_ctld_bu_ping;
 	static time_t last_uid_update;
+	static time_t last_malloc_trim;
 	time_t now;
 	int no_resp_msg_interval, ping_interval, purge_job_interval;
 	DEF_TIMERS;
@@ -2063,7 +2178,7 @@ static void *_slurmctld_background(void *no_data)
 	last_purge_job_time = last_trigger = last_health_check_time = now;
 	last_timelimit_time = last_assert_primary_time = now;
 	last_no_resp_msg_time = last_resv_time = last_ctld_bu_ping = now;
-	last_uid_update = now;
+	last_uid_update = last_malloc_trim = now;
 	last_acct_gather_node_time = last_ext_sensors_time = now;
 	last_config_list_update_time = now;
 
@@ -2111,6 +2226,8 @@ static void *_slurmctld_background(void *no_data)
 			 * and restore them to service */
 			ping_interval = 100;	/* 100 seconds */
 		}
+		/* Each ping_nodes() call covers one slice of the nodes */
+		ping_interval = MAX(ping_interval / get_ping_slices(), 1);
 
 		if (!last_ping_node_time) {
 			last_ping_node_time = now + (time_t)MIN_CHECKIN_TIME -
@@ -2373,6 +2490,20 @@ static void *_slurmctld_background(void *no_data)
 			assoc_mgr_set_missing_uids();
 		}
 
+#if defined(__GLIBC__)
+		if (difftime(now, last_malloc_trim) >= PERIODIC_MALLOC_TRIM) {
+			/*
+			 * Short lived RPC allocations spread over many malloc
+			 * arenas leave freed pages behind that glibc does not
+			 * return on its own. Give them back so the RSS does
+			 * not creep up over a long uptime.
+			 */
+			now = time(NULL);
+			last_malloc_trim = now;
+			(void) malloc_trim(0);
+		}
+#endif
+
 		END_TIMER2(__func__);
 	}
 
@@ -107,6 +107,11 @@ static pthread_t origin_dep_thread_id = (pthread_t) 0;
 static pthread_cond_t origin_dep_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t origin_dep_update_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static List lazy_sib_job_list = NULL;
+static pthread_mutex_t lazy_sib_mutex = PTHREAD_MUTEX_INITIALIZER;
+static time_t fed_params_update = 0;
+static int sibling_submit_delay = 0;
+
 typedef struct {
 	buf_t *buffer;
 	uint32_t   job_id;
@@ -169,6 +174,8 @@ typedef struct {
 } reconcile_sib_t;
 
 /* Local Prototypes */
+static void _add_lazy_sib_job(uint32_t job_id);
+static bool _defer_sibling_submit(job_record_t *job_ptr, bool alloc_only);
 static int _is_fed_job(job_record_t *job_ptr, uint32_t *origin_id);
 static uint64_t _get_all_sibling_bits();
 static int _validate_cluster_features(char *spec_features,
@@ -2786,6 +2793,18 @@ static void _add_missing_fed_job_info()
 			     job_ptr);
 			add_fed_job_info(job_ptr);
 		}
+
+		/*
+		 * Deferred sibling submissions are not saved in the state,
+		 * pick up pending origin jobs that never reached a sibling.
+		 */
+		if (fed_mgr_cluster_rec &&
+		    (origin_id == fed_mgr_cluster_rec->fed.id) &&
+		    IS_JOB_PENDING(job_ptr) && !IS_JOB_REVOKED(job_ptr) &&
+		    !(job_ptr->fed_details->siblings_active &
+		      ~FED_SIBLING_BIT(origin_id)) &&
+		    _defer_sibling_submit(job_ptr, false))
+			_add_lazy_sib_job(job_ptr->job_id);
 	}
 	list_iterator_destroy(job_itr);
 	unlock_slurmctld(job_read_lock);
@@ -2986,6 +3005,10 @@ extern int fed_mgr_fini(void)
 
 	FREE_NULL_LIST(fed_job_update_list);
 
+	slurm_mutex_lock(&lazy_sib_mutex);
+	FREE_NULL_LIST(lazy_sib_job_list);
+	slurm_mutex_unlock(&lazy_sib_mutex);
+
 	return SLURM_SUCCESS;
 }
 
@@ -3896,6 +3919,122 @@ static int _prepare_submit_siblings(job_record_t *job_ptr, uint64_t dest_sibs)
 	return rc;
 }
 
+/*
+ * Return the FederationParameters=sibling_submit_delay value in seconds, or 0
+ * if new jobs are to be submitted to their siblings right away.
+ */
+static int _get_sibling_submit_delay(void)
+{
+	char *tmp_ptr;
+
+	if (fed_params_update == slurm_conf.last_update)
+		return sibling_submit_delay;
+	fed_params_update = slurm_conf.last_update;
+
+	sibling_submit_delay = 0;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.fed_params,
+				   "sibling_submit_delay="))) {
+		sibling_submit_delay = atoi(tmp_ptr + 21);
+		if (sibling_submit_delay < 0) {
+			error("Invalid FederationParameters sibling_submit_delay: %d",
+			      sibling_submit_delay);
+			sibling_submit_delay = 0;
+		}
+	}
+
+	return sibling_submit_delay;
+}
+
+/*
+ * Test if the sibling jobs of a new origin job can wait. Only jobs that can
+ * run on this cluster and have other viable siblings are deferred, everything
+ * else keeps the regular submit-everywhere behavior.
+ */
+static bool _defer_sibling_submit(job_record_t *job_ptr, bool alloc_only)
+{
+	uint64_t self_bit = FED_SIBLING_BIT(fed_mgr_cluster_rec->fed.id);
+	uint64_t viable = job_ptr->fed_details->siblings_viable;
+
+	if (alloc_only || !_get_sibling_submit_delay())
+		return false;
+
+	return ((viable & self_bit) && (viable & ~self_bit));
+}
+
+static void _add_lazy_sib_job(uint32_t job_id)
+{
+	uint32_t *job_id_ptr = xmalloc(sizeof(*job_id_ptr));
+
+	*job_id_ptr = job_id;
+
+	slurm_mutex_lock(&lazy_sib_mutex);
+	if (!lazy_sib_job_list)
+		lazy_sib_job_list = list_create(xfree_ptr);
+	list_append(lazy_sib_job_list, job_id_ptr);
+	slurm_mutex_unlock(&lazy_sib_mutex);
+}
+
+/* Return 1 to remove the job from lazy_sib_job_list */
+static int _submit_lazy_sib_job(void *x, void *arg)
+{
+	uint32_t job_id = *(uint32_t *) x;
+	time_t now = *(time_t *) arg;
+	job_record_t *job_ptr;
+	fed_job_info_t *job_info;
+
+	if (!(job_ptr = find_job_record(job_id)) || !job_ptr->fed_details ||
+	    !job_ptr->details)
+		return 1;
+
+	/*
+	 * Jobs that started, were locked by a sibling or were held meanwhile
+	 * don't need deferred siblings. Held and dependent jobs get their
+	 * siblings from fed_mgr_job_requeue() once released.
+	 */
+	if (!IS_JOB_PENDING(job_ptr) || IS_JOB_REVOKED(job_ptr) ||
+	    job_ptr->fed_details->cluster_lock ||
+	    (job_ptr->priority == 0) || (job_ptr->bit_flags & JOB_DEPENDENT))
+		return 1;
+
+	if ((job_ptr->details->submit_time + sibling_submit_delay) > now)
+		return 0;
+
+	log_flag(FEDR, "%pJ still pending after %d seconds, submitting to siblings",
+		 job_ptr, sibling_submit_delay);
+	_prepare_submit_siblings(job_ptr,
+				 job_ptr->fed_details->siblings_viable);
+
+	slurm_mutex_lock(&fed_job_list_mutex);
+	if ((job_info = _find_fed_job_info(job_ptr->job_id)))
+		job_info->siblings_active =
+			job_ptr->fed_details->siblings_active;
+	slurm_mutex_unlock(&fed_job_list_mutex);
+
+	return 1;
+}
+
+/*
+ * Submit sibling jobs of origin jobs that have been deferred by
+ * FederationParameters=sibling_submit_delay and are still pending locally.
+ */
+extern void fed_mgr_submit_lazy_siblings(void)
+{
+	time_t now = time(NULL);
+
+	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
+	xassert(verify_lock(FED_LOCK, READ_LOCK));
+
+	if (!fed_mgr_fed_rec || !fed_mgr_cluster_rec)
+		return;
+
+	slurm_mutex_lock(&lazy_sib_mutex);
+	if (lazy_sib_job_list && list_count(lazy_sib_job_list)) {
+		(void) _get_sibling_submit_delay();
+		list_delete_all(lazy_sib_job_list, _submit_lazy_sib_job, &now);
+	}
+	slurm_mutex_unlock(&lazy_sib_mutex);
+}
+
 static uint64_t _get_all_sibling_bits()
 {
 	list_itr_t *itr;
@@ -4362,7 +4501,11 @@ extern int fed_mgr_job_allocate(slurm_msg_t *msg, job_desc_msg_t *job_desc,
 	job_ptr->fed_details->siblings_active = job_desc->fed_siblings_active;
 	update_job_fed_details(job_ptr);
 
-	if (!job_held && _submit_sibling_jobs(
+	if (!job_held && _defer_sibling_submit(job_ptr, alloc_only)) {
+		log_flag(FEDR, "deferring sibling submission of %pJ for %d seconds",
+			 job_ptr, sibling_submit_delay);
+		_add_lazy_sib_job(job_ptr->job_id);
+	} else if (!job_held && _submit_sibling_jobs(
 				job_desc, msg, alloc_only,
 				job_ptr->fed_details->siblings_viable,
 				job_ptr->start_protocol_ver))
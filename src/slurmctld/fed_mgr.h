@@ -97,6 +97,7 @@ extern bool      fed_mgr_sibs_synced(void);
 extern int       fed_mgr_state_save(char *state_save_location);
 extern void      fed_mgr_test_remote_dependencies(void);
 extern int       fed_mgr_state_save(char *state_save_location);
+extern void      fed_mgr_submit_lazy_siblings(void);
 extern int       fed_mgr_submit_remote_dependencies(job_record_t *job_ptr,
 						    bool send_all_sibs,
 						    bool clear_dependencies);
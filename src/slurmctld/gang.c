@@ -357,7 +357,6 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 {
 	job_resources_t *job_res = job_ptr->job_resrcs;
 	int count;
-	bitstr_t *job_map;
 	uint16_t job_gr_type;
 
 	if ((p_ptr->active_resmap == NULL) || (p_ptr->jobs_active == 0))
@@ -370,12 +369,9 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 	}
 
 	/* job_gr_type == GS_NODE || job_gr_type == GS_CPU */
-	job_map = bit_copy(job_res->node_bitmap);
-	bit_and(job_map, p_ptr->active_resmap);
 	/* any set bits indicate contention for the same resource */
-	count = bit_set_count(job_map);
+	count = bit_overlap(job_res->node_bitmap, p_ptr->active_resmap);
 	log_flag(GANG, "gang: %s: %d bits conflict", __func__, count);
-	FREE_NULL_BITMAP(job_map);
 	if (count == 0)
 		return 1;
 	if (job_gr_type == GS_CPU) {
@@ -1376,26 +1372,30 @@ static void _build_active_row(struct gs_part *p_ptr)
  */
 static void _cycle_job_list(struct gs_part *p_ptr)
 {
-	int i, j;
-	struct gs_job *j_ptr;
+	int i, j, k;
+	struct gs_job *j_ptr, **active_list;
 	uint16_t preempt_mode;
 
 	log_flag(GANG, "gang: entering %s", __func__);
-	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE */
-	for (i = 0; i < p_ptr->num_jobs; i++) {
-		while (p_ptr->job_list[i]->row_state == GS_ACTIVE) {
-			/* move this job to the back row and "deactivate" it */
-			j_ptr = p_ptr->job_list[i];
-			j_ptr->row_state = GS_NO_ACTIVE;
-			for (j = i; j+1 < p_ptr->num_jobs; j++) {
-				p_ptr->job_list[j] = p_ptr->job_list[j+1];
-			}
-			p_ptr->job_list[j] = j_ptr;
+	/*
+	 * re-prioritize the job_list and set all row_states to GS_NO_ACTIVE:
+	 * move the active jobs to the back of the list, preserving their
+	 * order among each other, in a single pass
+	 */
+	active_list = xcalloc(p_ptr->num_jobs, sizeof(struct gs_job *));
+	for (i = 0, j = 0, k = 0; i < p_ptr->num_jobs; i++) {
+		j_ptr = p_ptr->job_list[i];
+		if (j_ptr->row_state == GS_ACTIVE) {
+			active_list[k++] = j_ptr;
+		} else {
+			p_ptr->job_list[j++] = j_ptr;
 		}
-		if (p_ptr->job_list[i]->row_state == GS_FILLER)
-			p_ptr->job_list[i]->row_state = GS_NO_ACTIVE;
-
+		j_ptr->row_state = GS_NO_ACTIVE;
 	}
+	if (k)
+		memcpy(&p_ptr->job_list[j], active_list,
+		       k * sizeof(struct gs_job *));
+	xfree(active_list);
 	log_flag(GANG, "gang: %s reordered job list:", __func__);
 	/* Rebuild the active row. */
 	_build_active_row(p_ptr);
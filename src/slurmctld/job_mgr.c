@@ -123,6 +123,15 @@
 #define JOB_ARRAY_HASH_INX(_job_id, _task_id)		\
 	((_job_id + _task_id) % hash_table_size)
 
+/*
+ * Striped locks over the job_hash and job_array_hash_j buckets. These let
+ * job_id_exists() probe the tables without the JOB lock. Modifications must
+ * still be done while holding the JOB write lock.
+ */
+#define JOB_HASH_SHARD_CNT	64
+#define JOB_HASH_SHARD(_job_id)	\
+	(&job_hash_shard[JOB_HASH_INX(_job_id) % JOB_HASH_SHARD_CNT])
+
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define JOB_STATE_VERSION     "PROTOCOL_VERSION"
 
@@ -159,6 +168,22 @@ typedef struct {
 	int rc;
 } job_overlap_args_t;
 
+/*
+ * Packed copy of every job in job_list for one show_flags/protocol_version
+ * pair, used by pack_all_jobs() when SchedulerParameters=job_info_cache.
+ */
+typedef struct {
+	buf_t *buffer;		/* concatenated pack_job() output */
+	job_record_t **jobs;	/* jobs in the order packed */
+	uint32_t jobs_cnt;
+	uint32_t job_list_gen;	/* job_list_gen when packed */
+	time_t last_update;	/* last_job_update when packed */
+	uint32_t *offset;	/* start of each job in buffer, jobs_cnt + 1 */
+	time_t pack_time;
+	uint16_t protocol_version;
+	uint16_t show_flags;
+} job_info_cache_t;
+
 typedef struct {
 	int node_index;
 	int node_count;
@@ -184,6 +209,8 @@ List purge_files_list = NULL;	/* job files to delete */
 /* Local variables */
 static int      bf_min_age_reserve = 0;
 static uint32_t delay_boot = 0;
+static uint32_t fast_lane_time = 0;
+static char *fast_lane_parts = NULL;
 static uint32_t highest_prio = 0;
 static uint32_t lowest_prio  = TOP_PRIORITY;
 static int      hash_table_size = 0;
@@ -191,9 +218,21 @@ static int      job_count = 0;		/* job's in the system */
 static uint32_t job_id_sequence = 0;	/* first job_id to assign new job */
 static struct   job_record **job_hash = NULL;
 static struct   job_record **job_array_hash_j = NULL;
+static struct   job_record **job_name_hash = NULL;
 static struct   job_record **job_array_hash_t = NULL;
+static struct {
+	pthread_rwlock_t lock;
+	uint32_t busy;		/* job records of this shard being moved */
+} job_hash_shard[JOB_HASH_SHARD_CNT];
+#define JOB_INFO_CACHE_CNT	4
+static job_info_cache_t job_info_cache[JOB_INFO_CACHE_CNT];
+static bool     job_info_cache_enabled = false;
+static pthread_mutex_t job_info_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t job_list_gen = 0;	/* bumped on job record create/free */
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
+static slurm_hash_t last_job_state_hash = { .type = HASH_PLUGIN_K12 };
+static uint32_t last_job_state_id_seq = 0;
 static uint32_t max_array_size = NO_VAL;
 static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
@@ -201,6 +240,7 @@ static bool     validate_cfgd_licenses = true;
 
 /* Local functions */
 static void _add_job_hash(job_record_t *job_ptr);
+static void _add_job_name_hash(job_record_t *job_ptr);
 static void _add_job_array_hash(job_record_t *job_ptr);
 static void _handle_requeue_limit(job_record_t *job_ptr, const char *caller);
 static void _clear_job_gres_details(job_record_t *job_ptr);
@@ -224,6 +264,9 @@ static void _dump_job_fed_details(job_fed_details_t *fed_details_ptr,
 static job_fed_details_t *_dup_job_fed_details(job_fed_details_t *src);
 static void _get_batch_job_dir_ids(List batch_dirs);
 static bool _get_whole_hetjob(void);
+static bool _hide_job_user_rec(job_record_t *job_ptr, slurmdb_user_rec_t *user,
+			       uint16_t show_flags);
+static void _job_blob_release(char *file_name, char *tag);
 static void _job_array_comp(job_record_t *job_ptr, bool was_running,
 			    bool requeue);
 static int  _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
@@ -252,6 +295,7 @@ static int  _read_data_array_from_file(int fd, char *file_name, char ***data,
 				       uint32_t *size, job_record_t *job_ptr);
 static void _remove_defunct_batch_dirs(List batch_dirs);
 static void _remove_job_hash(job_record_t *job_ptr, job_hash_type_t type);
+static void _remove_job_name_hash(job_record_t *job_ptr);
 static void _resp_array_add(resp_array_struct_t **resp, job_record_t *job_ptr,
 			    uint32_t rc, char *err_msg);
 static void _resp_array_add_id(resp_array_struct_t **resp, uint32_t job_id,
@@ -284,6 +328,8 @@ static bool _validate_min_mem_partition(job_desc_msg_t *job_desc_msg,
 					List part_list);
 static bool _valid_pn_min_mem(job_desc_msg_t * job_desc_msg,
 			      part_record_t *part_ptr);
+static int  _write_buf_to_file(char *file_name, mode_t mode, char *data,
+			       uint32_t size, char *blob_tag);
 static int  _write_data_array_to_file(char *file_name, char **data,
 				      uint32_t size);
 
@@ -654,12 +700,15 @@ static job_record_t *_create_job_record(uint32_t num_jobs, bool list_add)
 			      __func__, slurm_conf.max_job_cnt);
 		}
 		job_count += num_jobs;
+		job_list_gen++;
+		job_state_epoch++;
 		last_job_update = time(NULL);
 		list_append(job_list, job_ptr);
 	}
 
 	job_ptr->magic = JOB_MAGIC;
 	job_ptr->array_task_id = NO_VAL;
+	job_ptr->job_name_inx = NO_VAL;
 	job_ptr->details = detail_ptr;
 	job_ptr->prio_factors = xmalloc(sizeof(priority_factors_t));
 	job_ptr->site_factor = NICE_OFFSET;
@@ -679,10 +728,34 @@ static job_record_t *_create_job_record(uint32_t num_jobs, bool list_add)
  * _delete_job_details - delete a job's detail record and clear it's pointer
  * IN job_entry - pointer to job_record to clear the record of
  */
-static void _delete_job_details(job_record_t *job_entry)
+/*
+ * Release argv and env_sup of a job's details. These may be shared with other
+ * tasks of the same job array, in which case only the last reference frees
+ * them.
+ */
+static void _free_job_details_args(job_details_t *details)
 {
-	int i;
+	if (details->args_ref_cnt && (--(*details->args_ref_cnt) > 0)) {
+		details->args_ref_cnt = NULL;
+		details->argv = NULL;
+		details->argc = 0;
+		details->env_sup = NULL;
+		details->env_cnt = 0;
+		return;
+	}
+	xfree(details->args_ref_cnt);
+	for (int i = 0; i < details->argc; i++)
+		xfree(details->argv[i]);
+	xfree(details->argv);
+	details->argc = 0;
+	for (int i = 0; i < details->env_cnt; i++)
+		xfree(details->env_sup[i]);
+	xfree(details->env_sup);
+	details->env_cnt = 0;
+}
 
+static void _delete_job_details(job_record_t *job_entry)
+{
 	if (job_entry->details == NULL)
 		return;
 
@@ -700,18 +773,13 @@ static void _delete_job_details(job_record_t *job_entry)
 	}
 
 	xfree(job_entry->details->acctg_freq);
-	for (i=0; i<job_entry->details->argc; i++)
-		xfree(job_entry->details->argv[i]);
-	xfree(job_entry->details->argv);
+	_free_job_details_args(job_entry->details);
 	xfree(job_entry->details->cpu_bind);
 	free_cron_entry(job_entry->details->crontab_entry);
 	FREE_NULL_LIST(job_entry->details->depend_list);
 	xfree(job_entry->details->dependency);
 	xfree(job_entry->details->orig_dependency);
 	xfree(job_entry->details->env_hash);
-	for (i=0; i<job_entry->details->env_cnt; i++)
-		xfree(job_entry->details->env_sup[i]);
-	xfree(job_entry->details->env_sup);
 	xfree(job_entry->details->std_err);
 	FREE_NULL_BITMAP(job_entry->details->exc_node_bitmap);
 	xfree(job_entry->details->exc_nodes);
@@ -768,6 +836,7 @@ extern void delete_job_desc_files(uint32_t job_id)
 				continue;
 			xstrfmtcat(file_name, "%s/%s", dir_name,
 				   dir_ent->d_name);
+			_job_blob_release(file_name, dir_ent->d_name);
 			(void) unlink(file_name);
 			xfree(file_name);
 		}
@@ -883,6 +952,9 @@ int dump_all_job_state(void)
 	time_t last_state_file_time;
 	static time_t last_job_state_size_check = 0;
 	uint32_t jobs_start, jobs_end, jobs_count;
+	slurm_hash_t job_state_hash = { .type = HASH_PLUGIN_K12 };
+	bool have_hash = false;
+	uint32_t id_sequence = job_id_sequence;
 	DEF_TIMERS;
 
 	START_TIMER;
@@ -915,10 +987,10 @@ int dump_all_job_state(void)
 	 * This is needed so that the job id remains persistent even after
 	 * slurmctld is restarted.
 	 */
-	pack32( job_id_sequence, buffer);
+	pack32(id_sequence, buffer);
 
 	debug3("Writing job id %u to header record of job_state file",
-	       job_id_sequence);
+	       id_sequence);
 
 	/* write individual job records */
 	lock_slurmctld(job_read_lock);
@@ -927,6 +999,10 @@ int dump_all_job_state(void)
 	jobs_start = get_buf_offset(buffer);
 	list_for_each_ro(job_list, job_mgr_dump_job_state, buffer);
 	jobs_end = get_buf_offset(buffer);
+	if (hash_g_compute(&get_buf_data(buffer)[jobs_start],
+			   (jobs_end - jobs_start), NULL, 0,
+			   &job_state_hash) > 0)
+		have_hash = true;
 	if ((difftime(now, last_job_state_size_check) > 60) &&
 	    (jobs_count = list_count(job_list))) {
 		uint64_t ave_job_size = jobs_end - jobs_start;
@@ -957,6 +1033,26 @@ int dump_all_job_state(void)
 	xstrcat(new_file, "/job_state.new");
 	unlock_slurmctld(job_read_lock);
 
+	/*
+	 * Periodic checkpoints and many RPCs request a save even when no
+	 * persistent job field changed. Skip rewriting an identical job_state
+	 * file, but only if the file on disk is still the one we last wrote.
+	 */
+	if (have_hash && last_file_write_time &&
+	    (last_file_write_time == last_state_file_time) &&
+	    (last_job_state_id_seq == id_sequence) &&
+	    !memcmp(job_state_hash.hash, last_job_state_hash.hash,
+		    sizeof(job_state_hash.hash))) {
+		debug2("%s: job records unchanged since %ld, skipping write",
+		       __func__, (long) last_file_write_time);
+		xfree(old_file);
+		xfree(reg_file);
+		xfree(new_file);
+		FREE_NULL_BUFFER(buffer);
+		END_TIMER2(__func__);
+		return error_code;
+	}
+
 	if (stat(reg_file, &stat_buf) == 0) {
 		static time_t last_mtime = (time_t) 0;
 		int delta_t = difftime(stat_buf.st_mtime, last_mtime);
@@ -1013,6 +1109,13 @@ int dump_all_job_state(void)
 			       new_file, reg_file);
 		(void) unlink(new_file);
 		last_file_write_time = now;
+		if (have_hash) {
+			last_job_state_hash = job_state_hash;
+			last_job_state_id_seq = id_sequence;
+		} else {
+			memset(last_job_state_hash.hash, 0,
+			       sizeof(last_job_state_hash.hash));
+		}
 	}
 	xfree(old_file);
 	xfree(reg_file);
@@ -1298,7 +1401,12 @@ extern int load_all_job_state(void)
 			buffer, NULL, protocol_version);
 		if (error_code != SLURM_SUCCESS)
 			goto unpack_error;
-		job_cnt++;
+		/*
+		 * The decoded records now own their data, so drop what has
+		 * been unpacked to avoid holding the whole file resident too.
+		 */
+		if (!(++job_cnt % 1024))
+			release_mmap_buf_processed(buffer);
 	}
 	debug3("Set job_id_sequence to %u", job_id_sequence);
 
@@ -2425,6 +2533,8 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 
 	_add_job_hash(job_ptr);
 	_add_job_array_hash(job_ptr);
+	if (!job_ptr_out)
+		_add_job_name_hash(job_ptr);
 
 	memset(&assoc_rec, 0, sizeof(assoc_rec));
 
@@ -2699,7 +2809,6 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	uint8_t open_mode, overcommit, prolog_running;
 	uint8_t share_res, whole_node, features_use = 0;
 	time_t begin_time, accrue_time = 0, submit_time;
-	int i;
 	List depend_list = NULL;
 	multi_core_data_t *mc_ptr;
 	cron_entry_t *crontab_entry = NULL;
@@ -2799,18 +2908,13 @@ static int _load_job_details(job_record_t *job_ptr, buf_t *buffer,
 	/* free any left-over detail data */
 	xfree(job_ptr->details->acctg_freq);
 	xfree(job_ptr->details->arbitrary_tpn);
-	for (i=0; i<job_ptr->details->argc; i++)
-		xfree(job_ptr->details->argv[i]);
-	xfree(job_ptr->details->argv);
+	_free_job_details_args(job_ptr->details);
 	xfree(job_ptr->details->cpu_bind);
 	FREE_NULL_LIST(job_ptr->details->depend_list);
 	xfree(job_ptr->details->dependency);
 	xfree(job_ptr->details->orig_dependency);
 	xfree(job_ptr->details->std_err);
 	xfree(job_ptr->details->env_hash);
-	for (i=0; i<job_ptr->details->env_cnt; i++)
-		xfree(job_ptr->details->env_sup[i]);
-	xfree(job_ptr->details->env_sup);
 	xfree(job_ptr->details->exc_nodes);
 	xfree(job_ptr->details->features);
 	xfree(job_ptr->details->cluster_features);
@@ -2947,9 +3051,107 @@ static void _add_job_hash(job_record_t *job_ptr)
 {
 	int inx;
 
+	slurm_rwlock_wrlock(&JOB_HASH_SHARD(job_ptr->job_id)->lock);
 	inx = JOB_HASH_INX(job_ptr->job_id);
 	job_ptr->job_next = job_hash[inx];
 	job_hash[inx] = job_ptr;
+	slurm_rwlock_unlock(&JOB_HASH_SHARD(job_ptr->job_id)->lock);
+}
+
+static uint32_t _job_name_hash_inx(uid_t user_id, const char *name)
+{
+	uint32_t hash = 2166136261u ^ user_id;
+
+	/* FNV-1a, jobs without a name share one slot per user */
+	for (const char *p = name; p && *p; p++) {
+		hash ^= (uint8_t) *p;
+		hash *= 16777619u;
+	}
+
+	return hash % hash_table_size;
+}
+
+/*
+ * Add a job to the user/name hash table, or move it to the right entry after
+ * its name changed. Singleton dependencies use this to find a user's jobs of
+ * a given name.
+ */
+static void _add_job_name_hash(job_record_t *job_ptr)
+{
+	uint32_t inx;
+
+	if (!job_name_hash)
+		return;
+
+	_remove_job_name_hash(job_ptr);
+
+	inx = _job_name_hash_inx(job_ptr->user_id, job_ptr->name);
+	job_ptr->job_name_inx = inx;
+	job_ptr->job_name_next = job_name_hash[inx];
+	job_name_hash[inx] = job_ptr;
+}
+
+static void _remove_job_name_hash(job_record_t *job_ptr)
+{
+	job_record_t **job_pptr;
+
+	if (!job_name_hash || (job_ptr->job_name_inx == NO_VAL))
+		return;
+
+	job_pptr = &job_name_hash[job_ptr->job_name_inx];
+	while (*job_pptr && (*job_pptr != job_ptr))
+		job_pptr = &(*job_pptr)->job_name_next;
+
+	if (*job_pptr)
+		*job_pptr = job_ptr->job_name_next;
+	else
+		error("%s: %pJ missing from user/name hash table",
+		      __func__, job_ptr);
+
+	job_ptr->job_name_next = NULL;
+	job_ptr->job_name_inx = NO_VAL;
+}
+
+extern job_record_t *find_user_job_by_name(uid_t user_id, char *name,
+					   ListFindF f, void *key)
+{
+	uint32_t inx[2];
+	int cnt = 1;
+
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+
+	if (!job_name_hash || !name)
+		return list_find_first(job_list, f, key);
+
+	/* Jobs without a name match any name */
+	inx[0] = _job_name_hash_inx(user_id, name);
+	inx[1] = _job_name_hash_inx(user_id, NULL);
+	if (inx[1] != inx[0])
+		cnt = 2;
+
+	for (int i = 0; i < cnt; i++) {
+		for (job_record_t *job_ptr = job_name_hash[inx[i]]; job_ptr;
+		     job_ptr = job_ptr->job_name_next) {
+			if ((job_ptr->user_id == user_id) && f(job_ptr, key))
+				return job_ptr;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Mark a job id as in transit between hash entries so that a concurrent
+ * job_id_exists() does not report it missing while its record is unlinked.
+ */
+static void _job_hash_shard_busy(uint32_t job_id, bool busy)
+{
+	slurm_rwlock_wrlock(&JOB_HASH_SHARD(job_id)->lock);
+	if (busy)
+		JOB_HASH_SHARD(job_id)->busy++;
+	else
+		JOB_HASH_SHARD(job_id)->busy--;
+	slurm_rwlock_unlock(&JOB_HASH_SHARD(job_id)->lock);
 }
 
 /* _remove_job_hash - remove a job hash entry for given job record, job_id must
@@ -2961,14 +3163,17 @@ static void _add_job_hash(job_record_t *job_ptr)
 static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 {
 	job_record_t *job_ptr, **job_pptr;
+	pthread_rwlock_t *shard_lock = NULL;
 
 	xassert(job_entry);
 
 	switch (type) {
 	case JOB_HASH_JOB:
+		shard_lock = &JOB_HASH_SHARD(job_entry->job_id)->lock;
 		job_pptr = &job_hash[JOB_HASH_INX(job_entry->job_id)];
 		break;
 	case JOB_HASH_ARRAY_JOB:
+		shard_lock = &JOB_HASH_SHARD(job_entry->array_job_id)->lock;
 		job_pptr = &job_array_hash_j[
 			JOB_HASH_INX(job_entry->array_job_id)];
 		break;
@@ -2982,6 +3187,9 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 		return;
 	}
 
+	if (shard_lock)
+		slurm_rwlock_wrlock(shard_lock);
+
 	while ((job_pptr != NULL) && (*job_pptr != NULL) &&
 	       ((job_ptr = *job_pptr) != job_entry)) {
 		xassert(job_ptr->magic == JOB_MAGIC);
@@ -2999,6 +3207,8 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 	}
 
 	if (job_pptr == NULL || *job_pptr == NULL) {
+		if (shard_lock)
+			slurm_rwlock_unlock(shard_lock);
 		if (job_entry->job_id == NO_VAL)
 			return;
 
@@ -3035,6 +3245,9 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 		job_entry->job_array_next_t = NULL;
 		break;
 	}
+
+	if (shard_lock)
+		slurm_rwlock_unlock(shard_lock);
 }
 
 /* _add_job_array_hash - add a job hash entry for given job record,
@@ -3049,9 +3262,11 @@ void _add_job_array_hash(job_record_t *job_ptr)
 	if (job_ptr->array_task_id == NO_VAL)
 		return;	/* Not a job array */
 
+	slurm_rwlock_wrlock(&JOB_HASH_SHARD(job_ptr->array_job_id)->lock);
 	inx = JOB_HASH_INX(job_ptr->array_job_id);
 	job_ptr->job_array_next_j = job_array_hash_j[inx];
 	job_array_hash_j[inx] = job_ptr;
+	slurm_rwlock_unlock(&JOB_HASH_SHARD(job_ptr->array_job_id)->lock);
 
 	inx = JOB_ARRAY_HASH_INX(job_ptr->array_job_id,job_ptr->array_task_id);
 	job_ptr->job_array_next_t = job_array_hash_t[inx];
@@ -3368,6 +3583,48 @@ extern job_record_t *find_job_record(uint32_t job_id)
 	return NULL;
 }
 
+/*
+ * job_id_exists - test if a job record or job array with the given job_id
+ *	exists. Unlike find_job_record(), this does not require the JOB lock,
+ *	so RPCs can reject unknown job ids without contending for it.
+ * IN job_id - requested job's id
+ * RET false only if no such record existed at the time of the call
+ */
+extern bool job_id_exists(uint32_t job_id)
+{
+	job_record_t *job_ptr;
+	bool found = false;
+	int inx;
+
+	if (!job_hash)
+		return true;	/* Not yet initialized, let caller decide */
+
+	slurm_rwlock_rdlock(&JOB_HASH_SHARD(job_id)->lock);
+	if (JOB_HASH_SHARD(job_id)->busy) {
+		found = true;
+		goto fini;
+	}
+
+	inx = JOB_HASH_INX(job_id);
+	for (job_ptr = job_hash[inx]; job_ptr; job_ptr = job_ptr->job_next) {
+		if (job_ptr->job_id == job_id) {
+			found = true;
+			goto fini;
+		}
+	}
+	for (job_ptr = job_array_hash_j[inx]; job_ptr;
+	     job_ptr = job_ptr->job_array_next_j) {
+		if (job_ptr->array_job_id == job_id) {
+			found = true;
+			goto fini;
+		}
+	}
+
+fini:
+	slurm_rwlock_unlock(&JOB_HASH_SHARD(job_id)->lock);
+	return found;
+}
+
 /* rebuild a job's partition name list based upon the contents of its
  *	part_ptr_list */
 static void _rebuild_part_name_list(job_record_t *job_ptr)
@@ -4359,12 +4616,16 @@ extern void rehash_jobs(void)
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
 	if (job_hash == NULL) {
+		for (int i = 0; i < JOB_HASH_SHARD_CNT; i++)
+			slurm_rwlock_init(&job_hash_shard[i].lock);
 		hash_table_size = slurm_conf.max_job_cnt;
 		job_hash = xcalloc(hash_table_size, sizeof(job_record_t *));
 		job_array_hash_j = xcalloc(hash_table_size,
 					   sizeof(job_record_t *));
 		job_array_hash_t = xcalloc(hash_table_size,
 					   sizeof(job_record_t *));
+		job_name_hash = xcalloc(hash_table_size,
+					sizeof(job_record_t *));
 	} else if (hash_table_size < (slurm_conf.max_job_cnt / 2)) {
 		/* If the MaxJobCount grows by too much, the hash table will
 		 * be ineffective without rebuilding. We don't presently bother
@@ -4392,6 +4653,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 
 	job_ptr_pend = _create_job_record(0, true);
 
+	_job_hash_shard_busy(job_ptr->job_id, true);
 	_remove_job_hash(job_ptr, JOB_HASH_JOB);
 	job_ptr_pend->job_id = job_ptr->job_id;
 	if (_set_job_id(job_ptr) != SLURM_SUCCESS)
@@ -4415,6 +4677,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	job_ptr_pend->details  = save_details;
 	job_ptr_pend->db_flags = 0;
 	job_ptr_pend->step_list = save_step_list;
+	job_ptr_pend->step_hash = NULL;
 	job_ptr_pend->db_index = save_db_index;
 
 	job_ptr_pend->prio_factors = save_prio_factors;
@@ -4489,6 +4752,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	_add_job_hash(job_ptr);		/* Sets job_next */
 	_add_job_hash(job_ptr_pend);	/* Sets job_next */
 	_add_job_array_hash(job_ptr);
+	_job_hash_shard_busy(job_ptr_pend->job_id, false);
 	job_ptr_pend->job_resrcs = NULL;
 
 	job_ptr_pend->id = copy_identity(job_ptr->id);
@@ -4498,6 +4762,9 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	job_ptr_pend->mail_user = xstrdup(job_ptr->mail_user);
 	job_ptr_pend->mcs_label = xstrdup(job_ptr->mcs_label);
 	job_ptr_pend->name = xstrdup(job_ptr->name);
+	job_ptr_pend->job_name_next = NULL;
+	job_ptr_pend->job_name_inx = NO_VAL;
+	_add_job_name_hash(job_ptr_pend);
 	job_ptr_pend->network = xstrdup(job_ptr->network);
 	job_ptr_pend->node_bitmap = NULL;
 	job_ptr_pend->node_bitmap_cg = NULL;
@@ -4572,13 +4839,17 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	details_new->preempt_start_time = 0;
 
 	details_new->acctg_freq = xstrdup(job_details->acctg_freq);
-	if (job_details->argc) {
-		details_new->argv =
-			xcalloc((job_details->argc + 1), sizeof(char *));
-		for (i = 0; i < job_details->argc; i++) {
-			details_new->argv[i] = xstrdup(job_details->argv[i]);
-		}
+	/*
+	 * argv and env_sup are never modified after submission, so every task
+	 * split off the meta record references the same arrays rather than
+	 * holding its own copy.
+	 */
+	if (!job_details->args_ref_cnt) {
+		job_details->args_ref_cnt = xmalloc(sizeof(uint32_t));
+		*job_details->args_ref_cnt = 1;
 	}
+	(*job_details->args_ref_cnt)++;
+	details_new->args_ref_cnt = job_details->args_ref_cnt;
 	details_new->cpu_bind = xstrdup(job_details->cpu_bind);
 	details_new->cpu_bind_type = job_details->cpu_bind_type;
 	details_new->cpu_freq_min = job_details->cpu_freq_min;
@@ -4587,14 +4858,6 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	details_new->depend_list = depended_list_copy(job_details->depend_list);
 	details_new->dependency = xstrdup(job_details->dependency);
 	details_new->orig_dependency = xstrdup(job_details->orig_dependency);
-	if (job_details->env_cnt) {
-		details_new->env_sup =
-			xcalloc((job_details->env_cnt + 1), sizeof(char *));
-		for (i = 0; i < job_details->env_cnt; i++) {
-			details_new->env_sup[i] =
-				xstrdup(job_details->env_sup[i]);
-		}
-	}
 	if (job_details->exc_node_bitmap) {
 		details_new->exc_node_bitmap =
 			bit_copy(job_details->exc_node_bitmap);
@@ -4984,6 +5247,44 @@ static inline bool _has_deadline(job_record_t *job_ptr)
 	return false;
 }
 
+/*
+ * Test if a batch job qualifies for SchedulerParameters=fast_lane_time: a
+ * single task on a single CPU with a time limit no larger than the lane's,
+ * submitted to one of the fast_lane_partitions (any partition if unset).
+ */
+static bool _fast_lane_job(job_record_t *job_ptr)
+{
+	job_details_t *detail_ptr = job_ptr->details;
+	char *tmp, *tok, *save_ptr = NULL;
+	bool match = false;
+
+	if (!fast_lane_time || !job_ptr->batch_flag || !detail_ptr ||
+	    !job_ptr->part_ptr || job_ptr->part_ptr_list ||
+	    (job_ptr->time_limit == NO_VAL) ||
+	    (job_ptr->time_limit == INFINITE) ||
+	    (job_ptr->time_limit > fast_lane_time))
+		return false;
+
+	if ((detail_ptr->min_nodes > 1) || (detail_ptr->max_nodes > 1) ||
+	    (detail_ptr->min_cpus > 1) ||
+	    ((detail_ptr->num_tasks != NO_VAL) && (detail_ptr->num_tasks > 1)))
+		return false;
+
+	if (!fast_lane_parts)
+		return true;
+
+	tmp = xstrdup(fast_lane_parts);
+	tok = strtok_r(tmp, ":", &save_ptr);
+	while (tok && !match) {
+		if (!xstrcmp(tok, job_ptr->part_ptr->name))
+			match = true;
+		tok = strtok_r(NULL, ":", &save_ptr);
+	}
+	xfree(tmp);
+
+	return match;
+}
+
 /*
  * job_allocate - create job_records for the supplied job specification and
  *	allocate nodes for it.
@@ -5018,7 +5319,7 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 	job_record_t *job_ptr;
 	time_t now = time(NULL);
 	bool held_user = false;
-	bool defer_this = false;
+	bool defer_this = false, fast_lane = false;
 
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
@@ -5060,6 +5361,22 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 			ignore_prefer_val = true;
 		else
 			ignore_prefer_val = false;
+
+		fast_lane_time = 0;
+		if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+					   "fast_lane_time="))) {
+			int lane_time = atoi(tmp_ptr + 15);
+			if (lane_time > 0)
+				fast_lane_time = lane_time;
+		}
+		xfree(fast_lane_parts);
+		if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+					   "fast_lane_partitions="))) {
+			char *tmp_comma;
+			fast_lane_parts = xstrdup(tmp_ptr + 21);
+			if ((tmp_comma = xstrstr(fast_lane_parts, ",")))
+				*tmp_comma = '\0';
+		}
 	}
 
 	if (job_desc->array_bitmap)
@@ -5125,6 +5442,15 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 
 	defer_this = defer_sched || (defer_batch && job_ptr->batch_flag);
 
+	/*
+	 * Tiny batch jobs in a fast lane are allocated and launched right
+	 * away instead of waiting for the next scheduling cycle.
+	 */
+	fast_lane = !allocate && !will_run && !job_desc->array_bitmap &&
+		_fast_lane_job(job_ptr);
+	if (fast_lane)
+		defer_this = false;
+
 	if (independent && (!too_fragmented) && !defer_this)
 		top_prio = _top_priority(job_ptr, job_desc->het_job_offset);
 	else
@@ -5189,8 +5515,8 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 	 * fed jobs need to go to the siblings first so don't attempt to
 	 * schedule the job now.
 	 */
-	test_only = will_run || job_ptr->deadline || (allocate == 0) ||
-		job_ptr->fed_details;
+	test_only = will_run || job_ptr->deadline ||
+		((allocate == 0) && !fast_lane) || job_ptr->fed_details;
 
 	no_alloc = test_only || too_fragmented || _has_deadline(job_ptr) ||
 		(!top_prio) || (!independent) || !avail_front_end(job_ptr) ||
@@ -5313,6 +5639,14 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 		rebuild_job_part_list(job_ptr);
 	}
 
+	if (fast_lane && IS_JOB_RUNNING(job_ptr)) {
+		sched_info("Allocate %pJ NodeList=%s #CPUs=%u Partition=%s (fast lane)",
+			   job_ptr, job_ptr->nodes, job_ptr->total_cpus,
+			   job_ptr->part_ptr->name);
+		if (!IS_JOB_CONFIGURING(job_ptr))
+			launch_job(job_ptr);
+	}
+
 	return SLURM_SUCCESS;
 }
 
@@ -6004,6 +6338,171 @@ endit:
 	return rc;
 }
 
+typedef struct {
+	kill_jobs_msg_t *kill_msg;
+	bitstr_t *node_bitmap;
+	slurmdb_user_rec_t *user_rec;
+	bool valid_operator;
+	list_t *job_id_list;
+} foreach_kill_jobs_args_t;
+
+/* Return true if job_ptr matches all filters of a REQUEST_KILL_JOBS */
+static bool _kill_jobs_match(job_record_t *job_ptr,
+			     foreach_kill_jobs_args_t *args)
+{
+	kill_jobs_msg_t *msg = args->kill_msg;
+	uint32_t job_base_state = job_ptr->job_state & JOB_STATE_BASE;
+
+	if ((job_base_state != JOB_PENDING) &&
+	    (job_base_state != JOB_RUNNING) &&
+	    (job_base_state != JOB_SUSPENDED))
+		return false;
+	if ((msg->state != JOB_END) && (job_base_state != msg->state))
+		return false;
+	if ((msg->user_id != NO_VAL) && (job_ptr->user_id != msg->user_id))
+		return false;
+	if (msg->account && xstrcmp(job_ptr->account, msg->account))
+		return false;
+	if (msg->job_name && xstrcmp(job_ptr->name, msg->job_name))
+		return false;
+	if (msg->partition && xstrcmp(job_ptr->partition, msg->partition))
+		return false;
+	if (msg->qos && (!job_ptr->qos_ptr ||
+			 xstrcmp(job_ptr->qos_ptr->name, msg->qos)))
+		return false;
+	if (msg->reservation && xstrcmp(job_ptr->resv_name, msg->reservation))
+		return false;
+	if (args->node_bitmap &&
+	    (!job_ptr->node_bitmap ||
+	     !bit_overlap_any(job_ptr->node_bitmap, args->node_bitmap)))
+		return false;
+	if (msg->wckey) {
+		char *job_key = job_ptr->wckey;
+
+		/*
+		 * A wckey that begins with '*' was applied by default. When
+		 * the filter does not begin with a '*', match all wckeys with
+		 * the same name, default or not.
+		 */
+		if ((msg->wckey[0] != '*') && job_key && (job_key[0] == '*'))
+			job_key++;
+		if (xstrcmp(job_key, msg->wckey))
+			return false;
+	}
+	if (!args->valid_operator &&
+	    _hide_job_user_rec(job_ptr, args->user_rec, 0))
+		return false;
+
+	return true;
+}
+
+static int _foreach_kill_jobs_match(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	foreach_kill_jobs_args_t *args = arg;
+	char *job_id_str = NULL;
+
+	if (!_kill_jobs_match(job_ptr, args))
+		return 0;
+
+	/*
+	 * Signaling the HetJob leader affects all of its components, so skip
+	 * any component whose leader also matches.
+	 */
+	if (job_ptr->het_job_id && job_ptr->het_job_offset) {
+		job_record_t *het_leader = find_job_record(job_ptr->het_job_id);
+
+		if (het_leader && _kill_jobs_match(het_leader, args))
+			return 0;
+	}
+
+	if (job_ptr->array_recs && job_ptr->array_recs->task_id_bitmap &&
+	    (bit_set_count(job_ptr->array_recs->task_id_bitmap) > 0)) {
+		char *tasks = bit_fmt_full(job_ptr->array_recs->task_id_bitmap);
+		xstrfmtcat(job_id_str, "%u_[%s]", job_ptr->array_job_id, tasks);
+		xfree(tasks);
+	} else if (job_ptr->array_task_id != NO_VAL) {
+		xstrfmtcat(job_id_str, "%u_%u", job_ptr->array_job_id,
+			   job_ptr->array_task_id);
+	} else {
+		xstrfmtcat(job_id_str, "%u", job_ptr->job_id);
+	}
+	list_append(args->job_id_list, job_id_str);
+
+	return 0;
+}
+
+/*
+ * job_mgr_signal_jobs - signal every job matching the filters of a
+ *	REQUEST_KILL_JOBS message
+ * IN kill_msg - filters, signal and KILL_JOB_* flags to apply
+ * IN auth_uid - uid of requesting user
+ * OUT resp_pptr - per job result, caller must free with
+ *	slurm_free_kill_jobs_response_msg()
+ * RET 0 on success, otherwise ESLURM error code
+ * global: job_list - pointer global job list
+ * NOTE: Caller must hold the same locks as for job_str_signal()
+ */
+extern int job_mgr_signal_jobs(kill_jobs_msg_t *kill_msg, uid_t auth_uid,
+			       kill_jobs_resp_msg_t **resp_pptr)
+{
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .qos = READ_LOCK,
+				   .user = READ_LOCK };
+	slurmdb_user_rec_t user_rec = { 0 };
+	foreach_kill_jobs_args_t args = {
+		.kill_msg = kill_msg,
+		.user_rec = &user_rec,
+	};
+	kill_jobs_resp_msg_t *resp;
+	list_itr_t *iter;
+	char *job_id_str;
+	int i = 0;
+
+	*resp_pptr = NULL;
+
+	if (kill_msg->nodelist &&
+	    node_name2bitmap(kill_msg->nodelist, false, &args.node_bitmap)) {
+		FREE_NULL_BITMAP(args.node_bitmap);
+		return ESLURM_INVALID_NODE_NAME;
+	}
+
+	args.job_id_list = list_create(xfree_ptr);
+
+	assoc_mgr_lock(&locks);
+	user_rec.uid = auth_uid;
+	assoc_mgr_fill_in_user(acct_db_conn, &user_rec, accounting_enforce,
+			       NULL, true);
+	args.valid_operator = validate_operator_user_rec(&user_rec);
+	list_for_each_ro(job_list, _foreach_kill_jobs_match, &args);
+	assoc_mgr_unlock(&locks);
+
+	/*
+	 * Signal outside of the assoc_mgr locks, job_str_signal() may need to
+	 * acquire them itself.
+	 */
+	resp = xmalloc(sizeof(*resp));
+	resp->jobs_cnt = list_count(args.job_id_list);
+	resp->job_responses = xcalloc(resp->jobs_cnt,
+				      sizeof(*resp->job_responses));
+	iter = list_iterator_create(args.job_id_list);
+	while ((job_id_str = list_next(iter))) {
+		kill_jobs_resp_job_t *job_resp = &resp->job_responses[i++];
+
+		job_resp->error_code = job_str_signal(job_id_str,
+						      kill_msg->signal,
+						      kill_msg->flags,
+						      auth_uid, false);
+		job_resp->job_id_str = list_remove(iter);
+	}
+	list_iterator_destroy(iter);
+
+	FREE_NULL_LIST(args.job_id_list);
+	FREE_NULL_BITMAP(args.node_bitmap);
+	*resp_pptr = resp;
+
+	return SLURM_SUCCESS;
+}
+
 static void _signal_batch_job(job_record_t *job_ptr, uint16_t signal,
 			      uint16_t flags)
 {
@@ -7391,12 +7890,7 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 		FREE_NULL_BITMAP(old_exc_bitmap);
 	}
 	if (exc_bitmap && req_bitmap) {
-		bitstr_t *tmp_bitmap = NULL;
-		bitoff_t first_set;
-		tmp_bitmap = bit_copy(exc_bitmap);
-		bit_and(tmp_bitmap, req_bitmap);
-		first_set = bit_ffs(tmp_bitmap);
-		FREE_NULL_BITMAP(tmp_bitmap);
+		bitoff_t first_set = bit_overlap_ffs(exc_bitmap, req_bitmap);
 		if (first_set != -1) {
 			info("Job's required and excluded node lists overlap");
 			error_code = ESLURM_INVALID_NODE_NAME;
@@ -7983,7 +8477,7 @@ fini:
 static int
 _copy_job_desc_to_file(job_desc_msg_t * job_desc, uint32_t job_id)
 {
-	int error_code = 0, hash;
+	int error_code = 0, hash, rc;
 	char *dir_name, *file_name;
 	DEF_TIMERS;
 
@@ -8000,13 +8494,23 @@ _copy_job_desc_to_file(job_desc_msg_t * job_desc, uint32_t job_id)
 	 * of files possible in a directory on some file system types (e.g.
 	 * up to 64k files on a FAT32 file system). */
 	hash = job_id % 10;
-	dir_name = xstrdup_printf("%s/hash.%d",
-	                          slurm_conf.state_save_location, hash);
-	(void) mkdir(dir_name, 0700);
+	dir_name = xstrdup_printf("%s/hash.%d/job.%u",
+				  slurm_conf.state_save_location, hash, job_id);
 
-	/* Create job_id specific directory */
-	xstrfmtcat(dir_name, "/job.%u", job_id);
-	if (mkdir(dir_name, 0700)) {
+	/*
+	 * Create job_id specific directory. The hash directory nearly always
+	 * exists already, so only create it when the first mkdir() says it is
+	 * missing rather than paying for an extra mkdir() on every submission.
+	 */
+	if ((rc = mkdir(dir_name, 0700)) && (errno == ENOENT)) {
+		char *hash_dir = xstrdup_printf("%s/hash.%d",
+						slurm_conf.state_save_location,
+						hash);
+		(void) mkdir(hash_dir, 0700);
+		xfree(hash_dir);
+		rc = mkdir(dir_name, 0700);
+	}
+	if (rc) {
 		if (!slurmctld_primary && (errno == EEXIST)) {
 			error("Apparent duplicate JobId=%u. Two primary slurmctld daemons might currently be active",
 			      job_id);
@@ -8026,7 +8530,10 @@ _copy_job_desc_to_file(job_desc_msg_t * job_desc, uint32_t job_id)
 	if (error_code == 0) {
 		/* Create script file */
 		file_name = xstrdup_printf("%s/script", dir_name);
-		error_code = write_data_to_file(file_name, job_desc->script);
+		error_code = _write_buf_to_file(file_name, 0700,
+						job_desc->script,
+						strlen(job_desc->script) + 1,
+						"script");
 		xfree(file_name);
 	}
 
@@ -8059,52 +8566,157 @@ static bool _dup_job_file_test(uint32_t job_id)
 }
 
 /*
- * Create file with specified name and write the supplied data array to it
+ * Build the path of the shared copy of a job file with the given contents.
+ * IN tag - kind of job file ("environment" or "script")
+ * IN data - file contents
+ * IN size - number of bytes in data
+ * RET xmalloc()'d path or NULL if the contents could not be hashed
+ */
+static char *_job_blob_path(const char *tag, char *data, uint32_t size)
+{
+	slurm_hash_t hash = { .type = HASH_PLUGIN_K12 };
+	char *hex, *path;
+
+	if (hash_g_compute(data, size, NULL, 0, &hash) <= 0)
+		return NULL;
+
+	hex = xstring_bytes2hex(hash.hash, sizeof(hash.hash), NULL);
+	path = xstrdup_printf("%s/blob/%s.%s", slurm_conf.state_save_location,
+			      tag, hex);
+	xfree(hex);
+	return path;
+}
+
+/*
+ * Register file_name as the shared copy of its contents so later jobs with
+ * identical contents can hard link to it rather than writing their own.
+ */
+static void _job_blob_add(char *file_name, char *blob_path)
+{
+	char *blob_dir;
+
+	if (!link(file_name, blob_path) || (errno != ENOENT))
+		return;
+
+	blob_dir = xstrdup_printf("%s/blob", slurm_conf.state_save_location);
+	(void) mkdir(blob_dir, 0700);
+	xfree(blob_dir);
+	(void) link(file_name, blob_path);
+}
+
+/*
+ * Drop the shared copy of a job file once the job being purged holds the
+ * only other link to it. Called before file_name is unlinked.
+ */
+static void _job_blob_release(char *file_name, char *tag)
+{
+	char *blob_path;
+	struct stat sbuf;
+	buf_t *buf;
+
+	if (stat(file_name, &sbuf) || (sbuf.st_nlink != 2))
+		return;
+	if (!(buf = create_mmap_buf(file_name)))
+		return;
+
+	blob_path = _job_blob_path(tag, get_buf_data(buf), size_buf(buf));
+	FREE_NULL_BUFFER(buf);
+	if (!blob_path)
+		return;
+
+	/*
+	 * A submission racing with this may have linked to the blob since
+	 * the stat() above. Its own link keeps the data, it just will not be
+	 * found for sharing by later jobs.
+	 */
+	(void) unlink(file_name);
+	if (!stat(blob_path, &sbuf) && (sbuf.st_nlink == 1))
+		(void) unlink(blob_path);
+	xfree(blob_path);
+}
+
+/*
+ * Create file with specified name and write the supplied buffer to it
  * IN file_name - file to create and write to
- * IN data - array of pointers to strings (e.g. env)
- * IN size - number of elements in data
+ * IN mode - file mode passed to creat()
+ * IN data - data to write
+ * IN size - number of bytes in data
+ * IN blob_tag - if set and SlurmctldParameters=dedup_batch_files is
+ *	configured, hard link file_name to an existing file with identical
+ *	contents instead of writing it
  */
-static int
-_write_data_array_to_file(char *file_name, char **data, uint32_t size)
+static int _write_buf_to_file(char *file_name, mode_t mode, char *data,
+			      uint32_t size, char *blob_tag)
 {
-	int fd, i, pos, nwrite, amount;
+	char *blob_path = NULL;
+	int fd;
+
+	if (blob_tag &&
+	    xstrcasestr(slurm_conf.slurmctld_params, "dedup_batch_files") &&
+	    (blob_path = _job_blob_path(blob_tag, data, size)) &&
+	    !link(blob_path, file_name)) {
+		xfree(blob_path);
+		return SLURM_SUCCESS;
+	}
 
-	fd = creat(file_name, 0600);
+	fd = creat(file_name, mode);
 	if (fd < 0) {
 		error("Error creating file %s, %m", file_name);
+		xfree(blob_path);
 		return ESLURM_WRITING_TO_FILE;
 	}
 
-	amount = write(fd, &size, sizeof(uint32_t));
-	if (amount < sizeof(uint32_t)) {
-		error("Error writing file %s, %m", file_name);
-		close(fd);
-		return ESLURM_WRITING_TO_FILE;
+	safe_write(fd, data, size);
+	close(fd);
+
+	if (blob_path) {
+		_job_blob_add(file_name, blob_path);
+		xfree(blob_path);
 	}
+	return SLURM_SUCCESS;
 
-	if (data == NULL) {
-		close(fd);
-		return SLURM_SUCCESS;
+rwfail:
+	error("Error writing file %s, %m", file_name);
+	close(fd);
+	xfree(blob_path);
+	return ESLURM_WRITING_TO_FILE;
+}
+
+/*
+ * Create file with specified name and write the supplied data array to it
+ * IN file_name - file to create and write to
+ * IN data - array of pointers to strings (e.g. env)
+ * IN size - number of elements in data
+ *
+ * The record count and all strings are assembled in memory first so the
+ * file is written with a single write() instead of one per string.
+ */
+static int
+_write_data_array_to_file(char *file_name, char **data, uint32_t size)
+{
+	uint32_t i, len, offset, total = sizeof(uint32_t);
+	char *buf;
+	int rc;
+
+	if (data) {
+		for (i = 0; i < size; i++)
+			total += strlen(data[i]) + 1;
 	}
 
-	for (i = 0; i < size; i++) {
-		nwrite = strlen(data[i]) + 1;
-		pos = 0;
-		while (nwrite > 0) {
-			amount = write(fd, &data[i][pos], nwrite);
-			if ((amount < 0) && (errno != EINTR)) {
-				error("Error writing file %s, %m",
-				      file_name);
-				close(fd);
-				return ESLURM_WRITING_TO_FILE;
-			}
-			nwrite -= amount;
-			pos    += amount;
+	buf = xmalloc(total);
+	memcpy(buf, &size, sizeof(uint32_t));
+	offset = sizeof(uint32_t);
+	if (data) {
+		for (i = 0; i < size; i++) {
+			len = strlen(data[i]) + 1;
+			memcpy(buf + offset, data[i], len);
+			offset += len;
 		}
 	}
 
-	close(fd);
-	return SLURM_SUCCESS;
+	rc = _write_buf_to_file(file_name, 0600, buf, total, "environment");
+	xfree(buf);
+	return rc;
 }
 
 /*
@@ -8114,33 +8726,13 @@ _write_data_array_to_file(char *file_name, char **data, uint32_t size)
  */
 extern int write_data_to_file(char *file_name, char *data)
 {
-	int fd, pos, nwrite, amount;
-
 	if (data == NULL) {
 		(void) unlink(file_name);
 		return SLURM_SUCCESS;
 	}
 
-	fd = creat(file_name, 0700);
-	if (fd < 0) {
-		error("Error creating file %s, %m", file_name);
-		return ESLURM_WRITING_TO_FILE;
-	}
-
-	nwrite = strlen(data) + 1;
-	pos = 0;
-	while (nwrite > 0) {
-		amount = write(fd, &data[pos], nwrite);
-		if ((amount < 0) && (errno != EINTR)) {
-			error("Error writing file %s, %m", file_name);
-			close(fd);
-			return ESLURM_WRITING_TO_FILE;
-		}
-		nwrite -= amount;
-		pos    += amount;
-	}
-	close(fd);
-	return SLURM_SUCCESS;
+	return _write_buf_to_file(file_name, 0700, data, strlen(data) + 1,
+				  NULL);
 }
 
 /*
@@ -8573,6 +9165,7 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 
 	job_ptr->user_id    = (uid_t) job_desc->user_id;
 	job_ptr->group_id   = (gid_t) job_desc->group_id;
+	_add_job_name_hash(job_ptr);
 	/* skip copy, just take ownership */
 	job_ptr->id = job_desc->id;
 	job_desc->id = NULL;
@@ -9152,6 +9745,10 @@ extern void job_config_fini(job_record_t *job_ptr)
 	 */
 	if (slurm_conf.prolog_flags & PROLOG_FLAG_ALLOC)
 		launch_prolog(job_ptr);
+
+	/* Steps waiting for nodes to boot can be retried now */
+	if (!job_ptr->details || !job_ptr->details->prolog_running)
+		wake_all_pending_steps(job_ptr);
 }
 
 /*
@@ -9877,6 +10474,8 @@ extern void free_null_array_recs(job_record_t *job_ptr)
 
 static void _delete_job_common(job_record_t *job_ptr)
 {
+	_remove_job_name_hash(job_ptr);
+
 	if (!job_ptr->job_id)
 		return;
 
@@ -9904,6 +10503,8 @@ extern void job_mgr_list_delete_job(void *job_entry)
 	xassert (job_ptr->magic == JOB_MAGIC);
 	job_ptr->magic = 0;	/* make sure we don't delete record twice */
 
+	job_list_gen++;
+	job_state_epoch++;
 	_delete_job_common(job_ptr);
 
 	if (job_ptr->array_recs) {
@@ -9982,6 +10583,7 @@ extern void job_mgr_list_delete_job(void *job_entry)
 	xfree(job_ptr->spank_job_env);
 	xfree(job_ptr->state_desc);
 	FREE_NULL_LIST(job_ptr->step_list);
+	xhash_free(job_ptr->step_hash);
 	xfree(job_ptr->system_comment);
 	xfree(job_ptr->tres_alloc_cnt);
 	xfree(job_ptr->tres_alloc_str);
@@ -10169,30 +10771,40 @@ static bool _hide_job_user_rec(job_record_t *job_ptr, slurmdb_user_rec_t *user,
 	return false;
 }
 
-static int _pack_job(void *object, void *arg)
+/* Determine if a job should be left out of a pack_all_jobs() response */
+static bool _hide_job_pack(job_record_t *job_ptr,
+			   _foreach_pack_job_info_t *pack_info)
 {
-	job_record_t *job_ptr = (job_record_t *)object;
-	_foreach_pack_job_info_t *pack_info = (_foreach_pack_job_info_t *)arg;
-
-	xassert (job_ptr->magic == JOB_MAGIC);
-
 	if ((pack_info->filter_uid != NO_VAL) &&
 	    (pack_info->filter_uid != job_ptr->user_id))
-		return SLURM_SUCCESS;
+		return true;
 
 	if (!(pack_info->show_flags & SHOW_ALL) && IS_JOB_REVOKED(job_ptr))
-		return SLURM_SUCCESS;
+		return true;
 
 	if (!pack_info->privileged) {
 		if (((pack_info->show_flags & SHOW_ALL) == 0) &&
 		    _all_parts_hidden(job_ptr, pack_info->visible_parts))
-			return SLURM_SUCCESS;
+			return true;
 
 		if (_hide_job_user_rec(job_ptr, &pack_info->user_rec,
 				       pack_info->show_flags))
-			return SLURM_SUCCESS;
+			return true;
 	}
 
+	return false;
+}
+
+static int _pack_job(void *object, void *arg)
+{
+	job_record_t *job_ptr = (job_record_t *)object;
+	_foreach_pack_job_info_t *pack_info = (_foreach_pack_job_info_t *)arg;
+
+	xassert (job_ptr->magic == JOB_MAGIC);
+
+	if (_hide_job_pack(job_ptr, pack_info))
+		return SLURM_SUCCESS;
+
 	pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
 		 pack_info->protocol_version, pack_info->uid,
 		 pack_info->has_qos_lock);
@@ -10208,10 +10820,30 @@ static int _foreach_pack_jobid(void *object, void *arg)
 	uint32_t job_id = *(uint32_t *)object;
 	_foreach_pack_job_info_t *info = (_foreach_pack_job_info_t *)arg;
 
-	if (!(job_ptr = find_job_record(job_id)))
+	job_ptr = find_job_record(job_id);
+
+	/* Match pack_one_job(): a leader brings its components along */
+	if (job_ptr && job_ptr->het_job_list) {
+		list_for_each_ro(job_ptr->het_job_list, _pack_job, info);
 		return SLURM_SUCCESS;
+	}
 
-	return _pack_job(job_ptr, info);
+	if (job_ptr)
+		(void) _pack_job(job_ptr, info);
+
+	if (job_ptr && (job_ptr->array_task_id == NO_VAL) &&
+	    !job_ptr->array_recs)
+		return SLURM_SUCCESS;
+
+	/* Either the job is not found or it is a job array */
+	for (job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)]; job_ptr;
+	     job_ptr = job_ptr->job_array_next_j) {
+		if ((job_ptr->array_job_id == job_id) &&
+		    (job_ptr->job_id != job_id))
+			(void) _pack_job(job_ptr, info);
+	}
+
+	return SLURM_SUCCESS;
 }
 
 /*
@@ -10390,6 +11022,117 @@ extern int dump_job_state(const uint32_t filter_jobs_count,
 	return args.rc;
 }
 
+static void _job_info_cache_purge(job_info_cache_t *cache)
+{
+	FREE_NULL_BUFFER(cache->buffer);
+	xfree(cache->jobs);
+	xfree(cache->offset);
+	memset(cache, 0, sizeof(*cache));
+}
+
+static int _job_info_cache_pack(void *object, void *arg)
+{
+	job_record_t *job_ptr = object;
+	job_info_cache_t *cache = arg;
+
+	xassert(job_ptr->magic == JOB_MAGIC);
+
+	cache->jobs[cache->jobs_cnt] = job_ptr;
+	cache->offset[cache->jobs_cnt] = get_buf_offset(cache->buffer);
+	cache->jobs_cnt++;
+	pack_job(job_ptr, cache->show_flags, cache->buffer,
+		 cache->protocol_version, 0, true);
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Find or build the cached pack of all jobs for the given show_flags and
+ * protocol_version. pack_job() reports expected start times relative to the
+ * current time, so a cache entry is only reused within the second it was
+ * built and while no job record has been created, freed or modified.
+ * Caller must hold job_info_cache_lock, the JOB read lock and the QOS read
+ * lock.
+ */
+static job_info_cache_t *_job_info_cache_get(uint16_t show_flags,
+					     uint16_t protocol_version)
+{
+	job_info_cache_t *cache = NULL, *oldest = &job_info_cache[0];
+	time_t now = time(NULL);
+	int jobs_cnt;
+
+	for (int i = 0; i < JOB_INFO_CACHE_CNT; i++) {
+		job_info_cache_t *entry = &job_info_cache[i];
+
+		if ((entry->show_flags == show_flags) &&
+		    (entry->protocol_version == protocol_version) &&
+		    entry->buffer) {
+			cache = entry;
+			break;
+		}
+		if (entry->pack_time < oldest->pack_time)
+			oldest = entry;
+	}
+
+	if (cache && (cache->pack_time == now) &&
+	    (cache->last_update == last_job_update) &&
+	    (cache->job_list_gen == job_list_gen))
+		return cache;
+
+	if (!cache)
+		cache = oldest;
+	_job_info_cache_purge(cache);
+
+	jobs_cnt = list_count(job_list);
+	cache->buffer = init_buf(BUF_SIZE);
+	cache->jobs = xcalloc(jobs_cnt + 1, sizeof(*cache->jobs));
+	cache->offset = xcalloc(jobs_cnt + 1, sizeof(*cache->offset));
+	cache->show_flags = show_flags;
+	cache->protocol_version = protocol_version;
+	list_for_each_ro(job_list, _job_info_cache_pack, cache);
+	cache->offset[cache->jobs_cnt] = get_buf_offset(cache->buffer);
+	cache->job_list_gen = job_list_gen;
+	cache->last_update = last_job_update;
+	cache->pack_time = now;
+
+	return cache;
+}
+
+/* Append cached job records [first, last) to the response buffer */
+static void _job_info_cache_copy(job_info_cache_t *cache, uint32_t first,
+				 uint32_t last, buf_t *buffer)
+{
+	uint32_t len = cache->offset[last] - cache->offset[first];
+
+	if (!len || try_grow_buf_remaining(buffer, len))
+		return;
+
+	memcpy(&get_buf_data(buffer)[get_buf_offset(buffer)],
+	       &get_buf_data(cache->buffer)[cache->offset[first]], len);
+	set_buf_offset(buffer, get_buf_offset(buffer) + len);
+}
+
+/* Fill the pack_all_jobs() response from the cache, applying its filters */
+static void _pack_all_jobs_cached(_foreach_pack_job_info_t *pack_info)
+{
+	job_info_cache_t *cache;
+	uint32_t first = 0;
+
+	slurm_mutex_lock(&job_info_cache_lock);
+	cache = _job_info_cache_get(pack_info->show_flags,
+				    pack_info->protocol_version);
+	for (uint32_t i = 0; i < cache->jobs_cnt; i++) {
+		if (!_hide_job_pack(cache->jobs[i], pack_info)) {
+			pack_info->jobs_packed++;
+			continue;
+		}
+		_job_info_cache_copy(cache, first, i, pack_info->buffer);
+		first = i + 1;
+	}
+	_job_info_cache_copy(cache, first, cache->jobs_cnt, pack_info->buffer);
+	slurm_mutex_unlock(&job_info_cache_lock);
+}
+
 /*
  * pack_all_jobs - dump all job information for all jobs in
  *	machine independent form (for network transmission)
@@ -10403,6 +11146,7 @@ extern int dump_job_state(const uint32_t filter_jobs_count,
 extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 			    uint16_t protocol_version)
 {
+	static time_t sched_update = 0;
 	uint32_t tmp_offset;
 	_foreach_pack_job_info_t pack_info = {
 		.buffer = _pack_init_job_info(protocol_version),
@@ -10417,13 +11161,25 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .user = READ_LOCK,
 				   .qos = READ_LOCK };
 
+	xassert(verify_lock(CONF_LOCK, READ_LOCK));
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+
+	if (sched_update != slurm_conf.last_update) {
+		sched_update = slurm_conf.last_update;
+		job_info_cache_enabled = xstrcasestr(slurm_conf.sched_params,
+						     "job_info_cache");
+	}
+
 	assoc_mgr_lock(&locks);
 	assoc_mgr_fill_in_user(acct_db_conn, &pack_info.user_rec,
 			       accounting_enforce, NULL, true);
 	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
 	pack_info.visible_parts = build_visible_parts(
 		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
-	list_for_each_ro(job_list, _pack_job, &pack_info);
+	if (job_info_cache_enabled)
+		_pack_all_jobs_cached(&pack_info);
+	else
+		list_for_each_ro(job_list, _pack_job, &pack_info);
 	assoc_mgr_unlock(&locks);
 
 	/* put the real record count in the message body header */
@@ -10441,7 +11197,8 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
  * pack_spec_jobs - dump job information for specified jobs in
  *	machine independent form (for network transmission)
  * IN show_flags - job filtering options
- * IN job_ids - list of job_ids to pack
+ * IN job_ids - list of job_ids to pack, as with pack_one_job() a
+ *	heterogeneous job leader or job array ID packs all of its records
  * IN uid - uid of user making request (for partition filtering)
  * IN filter_uid - pack only jobs belonging to this user if not NO_VAL
  * OUT buffer
@@ -11273,6 +12030,7 @@ void purge_old_job(void)
 	}
 	list_iterator_destroy(job_iterator);
 	fed_mgr_test_remote_dependencies();
+	fed_mgr_submit_lazy_siblings();
 
 	i = list_delete_all(job_list, &_list_find_job_old, "");
 	if (i) {
@@ -13702,6 +14460,8 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 		} else {
 			xfree(job_ptr->name);
 			job_ptr->name = xstrdup(job_desc->name);
+			_add_job_name_hash(job_ptr);
+			job_state_epoch++;	/* singleton dependencies */
 
 			sched_info("%s: setting name to %s for %pJ",
 				   __func__, job_ptr->name, job_ptr);
@@ -16023,9 +16783,13 @@ void job_fini (void)
 	xfree(job_hash);
 	xfree(job_array_hash_j);
 	xfree(job_array_hash_t);
+	xfree(job_name_hash);
+	for (int i = 0; i < JOB_INFO_CACHE_CNT; i++)
+		_job_info_cache_purge(&job_info_cache[i]);
 	FREE_NULL_LIST(purge_files_list);
 	FREE_NULL_BITMAP(requeue_exit);
 	FREE_NULL_BITMAP(requeue_exit_hold);
+	xfree(fast_lane_parts);
 }
 
 /* Record the start of one job array task */
@@ -58,6 +58,7 @@
 #include "src/common/env.h"
 #include "src/common/group_cache.h"
 #include "src/common/job_features.h"
+#include "src/common/job_trace.h"
 #include "src/common/list.h"
 #include "src/common/macros.h"
 #include "src/common/strlcpy.h"
@@ -99,6 +100,8 @@
 #  define CORRESPOND_ARRAY_TASK_CNT 10
 #endif
 #define BUILD_TIMEOUT 2000000	/* Max build_job_queue() run time in usec */
+#define SCHED_ADAPT_MAX_INTERVAL 5000000	/* Max sched_adaptive pause, usec */
+#define SCHED_ADAPT_RPC_CNT 150	/* RPC backlog to advise max_rpc_cnt at */
 #define MAX_FAILED_RESV 10
 
 static batch_job_launch_msg_t *_build_launch_job_msg(job_record_t *job_ptr,
@@ -131,6 +134,9 @@ static uint32_t max_array_size = NO_VAL;
 static bool bf_hetjob_immediate = false;
 static uint16_t bf_hetjob_prio = 0;
 static int sched_min_interval = 2;
+static bool sched_adaptive = false;
+static int sched_adapt_interval = 0;	/* usec, set with sched_adaptive */
+static int sched_adapt_depth = 0;	/* set with sched_adaptive */
 
 static int bb_array_stage_cnt = 10;
 extern diag_stats_t slurmctld_diag_stats;
@@ -140,6 +146,11 @@ typedef struct {
 	bool cleared;
 } _failed_part_t;
 
+typedef struct {
+	uint64_t key;	/* reservation, partition tier and priority */
+	job_queue_rec_t *job_rec;
+} job_sort_ent_t;
+
 static int _find_singleton_job (void *x, void *key)
 {
 	job_record_t *qjob_ptr = (job_record_t *) x;
@@ -174,9 +185,10 @@ static int _find_singleton_job (void *x, void *key)
 /*
  * Calculate how busy the system is by figuring out how busy each node is.
  */
+static double sys_usage_per = 0.0;
+
 static double _get_system_usage(void)
 {
-	static double sys_usage_per = 0.0;
 	static time_t last_idle_update = 0;
 
 	if (last_idle_update < last_node_update) {
@@ -419,6 +431,95 @@ extern void job_queue_rec_resv_list(job_queue_rec_t *job_queue_rec)
 	job_ptr->resv_id = job_ptr->resv_ptr->resv_id;
 }
 
+/*
+ * Split task task_id out of a pending job array for burst buffer staging.
+ * IN job_ptr - job array meta record
+ * IN task_id - first pending task of job_ptr
+ */
+static void _split_bb_array_task(job_record_t *job_ptr, int task_id)
+{
+	job_record_t *new_job_ptr;
+	int pend_cnt;
+
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= bb_array_stage_cnt)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = task_id;
+		(void) job_array_post_sched(job_ptr);
+		if (job_ptr->details && job_ptr->details->dependency &&
+		    job_ptr->details->depend_list)
+			fed_mgr_submit_remote_dependencies(job_ptr, false,
+							   false);
+		return;
+	}
+	job_ptr->array_task_id = task_id;
+	new_job_ptr = job_array_split(job_ptr);
+	debug("%s: Split out %pJ for burst buffer use",
+	      __func__, job_ptr);
+	job_state_set(new_job_ptr, JOB_PENDING);
+	new_job_ptr->start_time = (time_t) 0;
+	/*
+	 * Do NOT clear db_index here, it is handled when task_id_str
+	 * is created elsewhere.
+	 */
+	(void) bb_g_job_validate2(job_ptr, NULL);
+}
+
+/*
+ * Split task task_id out of a pending job array with an aftercorr dependency.
+ * IN job_ptr - job array meta record
+ * IN task_id - first pending task of job_ptr
+ */
+static void _split_correspond_array_task(job_record_t *job_ptr, int task_id)
+{
+	job_record_t *new_job_ptr;
+	depend_spec_t *dep_ptr;
+	list_itr_t *depend_iter;
+	int pend_cnt, dep_corr = 0;
+
+	if ((job_ptr->details == NULL) ||
+	    (job_ptr->details->depend_list == NULL) ||
+	    (list_count(job_ptr->details->depend_list) == 0))
+		return;
+	depend_iter = list_iterator_create(job_ptr->details->depend_list);
+	while ((dep_ptr = list_next(depend_iter))) {
+		if (dep_ptr->depend_type == SLURM_DEPEND_AFTER_CORRESPOND) {
+			dep_corr = 1;
+			break;
+		}
+	}
+	list_iterator_destroy(depend_iter);
+	if (!dep_corr)
+		return;
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= correspond_after_task_cnt)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = task_id;
+		(void) job_array_post_sched(job_ptr);
+		if (job_ptr->details && job_ptr->details->dependency &&
+		    job_ptr->details->depend_list)
+			fed_mgr_submit_remote_dependencies(job_ptr, false,
+							   false);
+		return;
+	}
+	job_ptr->array_task_id = task_id;
+	new_job_ptr = job_array_split(job_ptr);
+	info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
+	     __func__, job_ptr);
+	job_state_set(new_job_ptr, JOB_PENDING);
+	new_job_ptr->start_time = (time_t) 0;
+	/*
+	 * Do NOT clear db_index here, it is handled when task_id_str
+	 * is created elsewhere.
+	 */
+}
+
 /*
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs,
@@ -431,11 +532,10 @@ extern List build_job_queue(bool clear_start, bool backfill)
 {
 	static time_t last_log_time = 0;
 	List job_queue;
-	list_itr_t *depend_iter, *job_iterator, *part_iterator;
-	job_record_t *job_ptr = NULL, *new_job_ptr;
+	list_itr_t *job_iterator, *part_iterator;
+	job_record_t *job_ptr = NULL;
 	part_record_t *part_ptr;
-	depend_spec_t *dep_ptr;
-	int i, pend_cnt, dep_corr;
+	int i;
 	struct timeval start_tv = {0, 0};
 	int tested_jobs = 0;
 	int job_part_pairs = 0;
@@ -447,7 +547,9 @@ extern List build_job_queue(bool clear_start, bool backfill)
 
 	/*
 	 * Create individual job records for job arrays that need burst buffer
-	 * staging
+	 * staging or have depend_type == SLURM_DEPEND_AFTER_CORRESPOND.
+	 * Both are handled in one pass over job_list, a split out meta record
+	 * is appended to job_list and so is visited again later in this pass.
 	 *
 	 * NOTE: You can not use list_for_each for these loops here because
 	 * job_array_post_sched and job_array_split could eventually call
@@ -458,94 +560,19 @@ extern List build_job_queue(bool clear_start, bool backfill)
 	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->burst_buffer || !job_ptr->array_recs ||
+		if (!IS_JOB_PENDING(job_ptr) || !job_ptr->array_recs ||
 		    !job_ptr->array_recs->task_id_bitmap ||
 		    (job_ptr->array_task_id != NO_VAL))
 			continue;
 
 		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
 			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= bb_array_stage_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			if (job_ptr->details && job_ptr->details->dependency &&
-			    job_ptr->details->depend_list)
-				fed_mgr_submit_remote_dependencies(job_ptr,
-								   false,
-								   false);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		debug("%s: Split out %pJ for burst buffer use",
-		      __func__, job_ptr);
-		job_state_set(new_job_ptr, JOB_PENDING);
-		new_job_ptr->start_time = (time_t) 0;
-		/*
-		 * Do NOT clear db_index here, it is handled when task_id_str
-		 * is created elsewhere.
-		 */
-		(void) bb_g_job_validate2(job_ptr, NULL);
-	}
+		if (job_ptr->burst_buffer)
+			_split_bb_array_task(job_ptr, i);
 
-	/* Create individual job records for job arrays with
-	 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
-	list_iterator_reset(job_iterator);
-	while ((job_ptr = list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		if ((job_ptr->details == NULL) ||
-		    (job_ptr->details->depend_list == NULL) ||
-		    (list_count(job_ptr->details->depend_list) == 0))
-			continue;
-		depend_iter = list_iterator_create(
-			job_ptr->details->depend_list);
-		dep_corr = 0;
-		while ((dep_ptr = list_next(depend_iter))) {
-			if (dep_ptr->depend_type ==
-			    SLURM_DEPEND_AFTER_CORRESPOND) {
-				dep_corr = 1;
-				break;
-			}
-		}
-		if (!dep_corr)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= correspond_after_task_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			if (job_ptr->details && job_ptr->details->dependency &&
-			    job_ptr->details->depend_list)
-				fed_mgr_submit_remote_dependencies(job_ptr,
-								   false,
-								   false);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
-		     __func__, job_ptr);
-		job_state_set(new_job_ptr, JOB_PENDING);
-		new_job_ptr->start_time = (time_t) 0;
-		/*
-		 * Do NOT clear db_index here, it is handled when task_id_str
-		 * is created elsewhere.
-		 */
+		/* Still the meta record if it was not split above */
+		if (job_ptr->array_task_id == NO_VAL)
+			_split_correspond_array_task(job_ptr, i);
 	}
 
 	list_iterator_reset(job_iterator);
@@ -741,6 +768,58 @@ static int _failed_partition(part_record_t *part_ptr,
 	return -1;
 }
 
+/*
+ * With SchedulerParameters=sched_adaptive, pick the pause between main
+ * scheduling cycles and their depth from the recent cycle cost, the wait for
+ * the job write lock and the RPC backlog. The cycle holds the job write lock
+ * throughout, so it gets a smaller share of the time as RPCs queue up behind
+ * it: from half of it when idle down to a tenth at max_rpc_cnt.
+ */
+static void _sched_adapt(long cycle_usec, long lock_wait_usec, int rpc_limit,
+			 int def_job_limit)
+{
+	static double cycle_avg = 0.0, wait_avg = 0.0;
+	double pressure, duty, interval;
+	int rpc_cnt;
+
+	if (!cycle_avg) {
+		cycle_avg = cycle_usec;
+		wait_avg = lock_wait_usec;
+	} else {
+		cycle_avg = (0.75 * cycle_avg) + (0.25 * cycle_usec);
+		wait_avg = (0.75 * wait_avg) + (0.25 * lock_wait_usec);
+	}
+
+	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
+	rpc_cnt = slurmctld_config.server_thread_count;
+	slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
+
+	pressure = (double) rpc_cnt / rpc_limit;
+	/* Waiting for the lock means RPCs are holding it */
+	if ((wait_avg + cycle_avg) > 0)
+		pressure = MAX(pressure, wait_avg / (wait_avg + cycle_avg));
+	pressure = MIN(pressure, 1.0);
+
+	duty = 0.5 - (0.4 * pressure);
+	interval = cycle_avg * ((1.0 / duty) - 1.0);
+	interval = MIN(interval, SCHED_ADAPT_MAX_INTERVAL);
+
+	slurm_mutex_lock(&sched_mutex);
+	sched_adapt_interval = interval;
+	slurm_mutex_unlock(&sched_mutex);
+
+	/* Test fewer jobs per cycle under pressure, down to a quarter */
+	sched_adapt_depth = MAX(1, def_job_limit * (1.0 - (0.75 * pressure)));
+
+	slurmctld_diag_stats.schedule_adapt_interval = interval;
+	slurmctld_diag_stats.schedule_adapt_depth = sched_adapt_depth;
+	slurmctld_diag_stats.schedule_adapt_pressure = pressure * 100;
+
+	sched_debug2("%s: cycle %.0f usec, lock wait %.0f usec, %d RPCs, pressure %.2f, interval %.0f usec, depth %d",
+		     __func__, cycle_avg, wait_avg, rpc_cnt, pressure,
+		     interval, sched_adapt_depth);
+}
+
 static void _do_diag_stats(long delta_t)
 {
 	if (delta_t > slurmctld_diag_stats.schedule_cycle_max)
@@ -796,7 +875,7 @@ static void *_sched_agent(void *args)
 {
 	long delta_t;
 	struct timeval now;
-	int job_cnt;
+	int job_cnt, min_interval;
 	bool full_queue;
 
 #if HAVE_SYS_PRCTL_H
@@ -817,14 +896,16 @@ static void *_sched_agent(void *args)
 			delta_t  = (now.tv_sec  - sched_last.tv_sec) *
 				   USEC_IN_SEC;
 			delta_t +=  now.tv_usec - sched_last.tv_usec;
+			min_interval = MAX(sched_min_interval,
+					   sched_adapt_interval);
 
-			if (sched_requests && delta_t > sched_min_interval ) {
+			if (sched_requests && delta_t > min_interval) {
 				break;
 			} else if (sched_requests) {
 				struct timespec ts = {0, 0};
 				int64_t nsec;
 
-				nsec = sched_min_interval + sched_last.tv_usec;
+				nsec = min_interval + sched_last.tv_usec;
 				nsec *= NSEC_IN_USEC;
 				nsec += NSEC_IN_USEC;
 				ts.tv_sec = sched_last.tv_sec +
@@ -949,13 +1030,29 @@ extern void fill_array_reasons(job_record_t *job_ptr,
 static job_queue_rec_t *_create_job_queue_rec(job_queue_req_t *job_queue_req)
 {
 	job_queue_rec_t *job_queue_rec = xmalloc(sizeof(*job_queue_rec));
-	job_queue_rec->array_task_id = job_queue_req->job_ptr->array_task_id;
-	job_queue_rec->job_id   = job_queue_req->job_ptr->job_id;
-	job_queue_rec->job_ptr  = job_queue_req->job_ptr;
+	job_record_t *job_ptr = job_queue_req->job_ptr;
+
+	job_queue_rec->array_task_id = job_ptr->array_task_id;
+	job_queue_rec->job_id   = job_ptr->job_id;
+	job_queue_rec->job_ptr  = job_ptr;
 	job_queue_rec->part_ptr = job_queue_req->part_ptr;
 	job_queue_rec->priority = job_queue_req->prio;
 	job_queue_rec->resv_ptr = job_queue_req->resv_ptr;
 
+	job_queue_rec->has_resv = (job_ptr->resv_id != 0) ||
+		job_queue_rec->resv_ptr;
+	job_queue_rec->het_job_id = job_ptr->het_job_id;
+	if (job_queue_rec->array_task_id == NO_VAL)
+		job_queue_rec->sort_job_id = job_queue_rec->job_id;
+	else
+		job_queue_rec->sort_job_id = job_ptr->array_job_id;
+	if (job_ptr->part_ptr_list && job_ptr->priority_array)
+		job_queue_rec->sort_prio = job_queue_rec->priority;
+	else
+		job_queue_rec->sort_prio = job_ptr->priority;
+	if (job_ptr->details)
+		job_queue_rec->submit_time = job_ptr->details->submit_time;
+
 	return job_queue_rec;
 }
 
@@ -1040,6 +1137,8 @@ static int _schedule(bool full_queue)
 	static int defer_rpc_cnt = 0;
 	static bool reduce_completing_frag = false;
 	time_t now, last_job_sched_start, sched_start;
+	struct timeval lock_tv = { 0 };
+	int lock_wait, job_limit;
 	job_record_t *reject_array_job = NULL;
 	part_record_t *reject_array_part = NULL;
 	slurmctld_resv_t *reject_array_resv = NULL;
@@ -1257,6 +1356,19 @@ static int _schedule(bool full_queue)
 			sched_min_interval = 2;
 		}
 
+		if (xstrcasestr(slurm_conf.sched_params, "sched_adaptive")) {
+			sched_adaptive = true;
+		} else if (sched_adaptive) {
+			sched_adaptive = false;
+			slurm_mutex_lock(&sched_mutex);
+			sched_adapt_interval = 0;
+			slurm_mutex_unlock(&sched_mutex);
+			sched_adapt_depth = 0;
+			slurmctld_diag_stats.schedule_adapt_interval = 0;
+			slurmctld_diag_stats.schedule_adapt_depth = 0;
+			slurmctld_diag_stats.schedule_adapt_pressure = 0;
+		}
+
 		if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
 					   "sched_max_job_start="))) {
 			sched_max_job_start = atoi(tmp_ptr + 20);
@@ -1288,7 +1400,10 @@ static int _schedule(bool full_queue)
 		goto out;
 	}
 
+	(void) slurm_delta_tv(&lock_tv);
 	lock_slurmctld(job_write_lock);
+	lock_wait = slurm_delta_tv(&lock_tv);
+	job_limit = sched_adapt_depth ? sched_adapt_depth : def_job_limit;
 	now = time(NULL);
 	sched_start = now;
 	last_job_sched_start = now;
@@ -1302,9 +1417,7 @@ static int _schedule(bool full_queue)
 			    (job_ptr->state_reason != WAIT_RESOURCES) &&
 			    (job_ptr->state_reason != WAIT_NODE_NOT_AVAIL))
 				continue;
-			job_ptr->state_reason = WAIT_FRONT_END;
-			xfree(job_ptr->state_desc);
-			last_job_update = now;
+			job_state_set_reason(job_ptr, WAIT_FRONT_END, NULL);
 		}
 		list_iterator_destroy(job_iterator);
 
@@ -1417,9 +1530,8 @@ static int _schedule(bool full_queue)
 			}
 
 			if (!avail_front_end(job_ptr)) {
-				job_ptr->state_reason = WAIT_FRONT_END;
-				xfree(job_ptr->state_desc);
-				last_job_update = now;
+				job_state_set_reason(job_ptr, WAIT_FRONT_END,
+						     NULL);
 				continue;
 			}
 			if (!_job_runnable_test1(job_ptr, false))
@@ -1460,9 +1572,8 @@ next_part:
 			job_ptr->priority = job_queue_rec->priority;
 
 			if (!avail_front_end(job_ptr)) {
-				job_ptr->state_reason = WAIT_FRONT_END;
-				xfree(job_ptr->state_desc);
-				last_job_update = now;
+				job_state_set_reason(job_ptr, WAIT_FRONT_END,
+						     NULL);
 				xfree(job_queue_rec);
 				continue;
 			}
@@ -1563,7 +1674,7 @@ next_task:
 				continue;
 			}
 		}
-		if (!full_queue && (job_depth++ > def_job_limit)) {
+		if (!full_queue && (job_depth++ > job_limit)) {
 			sched_debug("already tested %u jobs, breaking out",
 				    job_depth);
 			_set_schedule_exit(SCHEDULE_EXIT_MAX_DEPTH);
@@ -1606,9 +1717,8 @@ next_task:
 				}
 			}
 			if (found_resv) {
-				job_ptr->state_reason = WAIT_PRIORITY;
-				xfree(job_ptr->state_desc);
-				last_job_update = now;
+				job_state_set_reason(job_ptr, WAIT_PRIORITY,
+						     NULL);
 				sched_debug3("%pJ. State=PENDING. Reason=Priority. Priority=%u. Resv=%s.",
 					     job_ptr,
 					     job_ptr->priority,
@@ -1634,9 +1744,8 @@ next_task:
 						    job_ptr->state_reason),
 					    job_ptr->state_desc,
 					    job_ptr->priority);
-				job_ptr->state_reason = WAIT_PRIORITY;
-				xfree(job_ptr->state_desc);
-				last_job_update = now;
+				job_state_set_reason(job_ptr, WAIT_PRIORITY,
+						     NULL);
 			} else {
 				/*
 				 * Log job can not run even though we are not
@@ -1649,7 +1758,6 @@ next_task:
 					     job_ptr->state_desc,
 					     job_ptr->priority);
 			}
-			last_job_update = now;
 
 			continue;
 		} else if (wait_on_resv &&
@@ -1736,10 +1844,8 @@ next_task:
 			 * Too many nodes DRAIN, DOWN, or
 			 * reserved for jobs in higher priority partition
 			 */
-			job_ptr->state_reason = WAIT_RESOURCES;
-			xfree(job_ptr->state_desc);
-			job_ptr->state_desc = xstrdup("Nodes required for job are DOWN, DRAINED or reserved for jobs in higher priority partitions");
-			last_job_update = now;
+			job_state_set_reason(job_ptr, WAIT_RESOURCES,
+					     "Nodes required for job are DOWN, DRAINED or reserved for jobs in higher priority partitions");
 			sched_debug3("%pJ. State=%s. Reason=%s. Priority=%u. Partition=%s.",
 				     job_ptr,
 				     job_state_string(job_ptr->job_state),
@@ -1862,9 +1968,7 @@ skip_start:
 					     job_ptr->priority);
 			}
 		} else if (error_code == ESLURM_FED_JOB_LOCK) {
-			job_ptr->state_reason = WAIT_FED_JOB_LOCK;
-			xfree(job_ptr->state_desc);
-			last_job_update = now;
+			job_state_set_reason(job_ptr, WAIT_FED_JOB_LOCK, NULL);
 			sched_debug3("%pJ. State=%s. Reason=%s. Priority=%u. Partition=%s. Couldn't get federation job lock.",
 				     job_ptr,
 				     job_state_string(job_ptr->job_state),
@@ -2026,7 +2130,7 @@ fail_this_part:	if (fail_by_part) {
 	xfree(sched_part_ptr);
 	xfree(sched_part_jobs);
 	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
-	if ((slurmctld_config.server_thread_count >= 150) &&
+	if ((slurmctld_config.server_thread_count >= SCHED_ADAPT_RPC_CNT) &&
 	    (defer_rpc_cnt == 0)) {
 		sched_info("%d pending RPCs at cycle end, consider configuring max_rpc_cnt",
 			   slurmctld_config.server_thread_count);
@@ -2036,18 +2140,78 @@ fail_this_part:	if (fail_by_part) {
 	END_TIMER2(__func__);
 
 	_do_diag_stats(DELTA_TIMER);
+	if (sched_adaptive)
+		_sched_adapt(DELTA_TIMER, lock_wait,
+			     (defer_rpc_cnt ? defer_rpc_cnt :
+			      SCHED_ADAPT_RPC_CNT), def_job_limit);
 
 out:
 	return job_cnt;
 }
 
+/* Order job_sort_ent_t by decreasing key, then as sort_job_queue2() would */
+static int _sort_job_ent(const void *x, const void *y)
+{
+	const job_sort_ent_t *ent1 = x;
+	const job_sort_ent_t *ent2 = y;
+
+	if (ent1->key > ent2->key)
+		return -1;
+	if (ent1->key < ent2->key)
+		return 1;
+
+	return sort_job_queue2((void *) &ent1->job_rec,
+			       (void *) &ent2->job_rec);
+}
+
 /*
  * sort_job_queue - sort job_queue in descending priority order
  * IN/OUT job_queue - sorted job queue
  */
 extern void sort_job_queue(List job_queue)
 {
-	list_sort(job_queue, sort_job_queue2);
+	job_sort_ent_t *ents;
+	job_queue_rec_t *job_rec;
+	int i, cnt;
+
+	/*
+	 * Preemption and hetjob priorities make the ordering depend on the
+	 * pair of records compared, so no single key can be built for them.
+	 */
+	if (slurm_preemption_enabled() || bf_hetjob_prio ||
+	    ((cnt = list_count(job_queue)) < 2)) {
+		list_sort(job_queue, sort_job_queue2);
+		return;
+	}
+
+	/*
+	 * Sort a contiguous array of the leading sort keys rather than having
+	 * every comparison dereference two queue records.
+	 */
+	ents = xcalloc(cnt, sizeof(*ents));
+	for (i = 0; (i < cnt) && (job_rec = list_pop(job_queue)); i++) {
+		if (!job_rec->part_ptr) {
+			/* No tier to compare, must use sort_job_queue2() */
+			list_push(job_queue, job_rec);
+			break;
+		}
+		ents[i].key = ((uint64_t) job_rec->has_resv << 48) |
+			((uint64_t) job_rec->part_ptr->priority_tier << 32) |
+			job_rec->sort_prio;
+		ents[i].job_rec = job_rec;
+	}
+	if (i < cnt) {
+		while (i--)
+			list_push(job_queue, ents[i].job_rec);
+		xfree(ents);
+		list_sort(job_queue, sort_job_queue2);
+		return;
+	}
+
+	qsort(ents, cnt, sizeof(*ents), _sort_job_ent);
+	for (i = 0; i < cnt; i++)
+		list_append(job_queue, ents[i].job_rec);
+	xfree(ents);
 }
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
@@ -2058,10 +2222,9 @@ extern int sort_job_queue2(void *x, void *y)
 	job_queue_rec_t *job_rec1 = *(job_queue_rec_t **) x;
 	job_queue_rec_t *job_rec2 = *(job_queue_rec_t **) y;
 	het_job_details_t *details = NULL;
-	bool has_resv1, has_resv2;
+	bool has_resv1, has_resv2, het1, het2;
 	static time_t config_update = 0;
 	static bool preemption_enabled = true;
-	uint32_t job_id1, job_id2;
 	uint32_t p1, p2;
 
 	/* The following block of code is designed to minimize run time in
@@ -2077,29 +2240,21 @@ extern int sort_job_queue2(void *x, void *y)
 			return 1;
 	}
 
-	if (bf_hetjob_prio && job_rec1->job_ptr->het_job_id &&
-	    (job_rec1->job_ptr->het_job_id !=
-	     job_rec2->job_ptr->het_job_id)) {
-		if ((details = job_rec1->job_ptr->het_details))
-			has_resv1 = details->any_resv;
-		else
-			has_resv1 = (job_rec1->job_ptr->resv_id != 0) ||
-				job_rec1->resv_ptr;
-	} else
-		has_resv1 = (job_rec1->job_ptr->resv_id != 0) ||
-			job_rec1->resv_ptr;
-
-	if (bf_hetjob_prio && job_rec2->job_ptr->het_job_id &&
-	    (job_rec2->job_ptr->het_job_id !=
-	     job_rec1->job_ptr->het_job_id)) {
-		if ((details = job_rec2->job_ptr->het_details))
-			has_resv2 = details->any_resv;
-		else
-			has_resv2 = (job_rec2->job_ptr->resv_id != 0) ||
-				job_rec2->resv_ptr;
-	} else
-		has_resv2 = (job_rec2->job_ptr->resv_id != 0) ||
-			job_rec2->resv_ptr;
+	/* Sort hetjob components by their hetjob's values */
+	het1 = bf_hetjob_prio && job_rec1->het_job_id &&
+		(job_rec1->het_job_id != job_rec2->het_job_id);
+	het2 = bf_hetjob_prio && job_rec2->het_job_id &&
+		(job_rec2->het_job_id != job_rec1->het_job_id);
+
+	if (het1 && (details = job_rec1->job_ptr->het_details))
+		has_resv1 = details->any_resv;
+	else
+		has_resv1 = job_rec1->has_resv;
+
+	if (het2 && (details = job_rec2->job_ptr->het_details))
+		has_resv2 = details->any_resv;
+	else
+		has_resv2 = job_rec2->has_resv;
 
 	if (has_resv1 && !has_resv2)
 		return -1;
@@ -2107,24 +2262,14 @@ extern int sort_job_queue2(void *x, void *y)
 		return 1;
 
 	if (job_rec1->part_ptr && job_rec2->part_ptr) {
-		if (bf_hetjob_prio && job_rec1->job_ptr->het_job_id &&
-		    (job_rec1->job_ptr->het_job_id !=
-		     job_rec2->job_ptr->het_job_id)) {
-			if ((details = job_rec1->job_ptr->het_details))
-				p1 = details->priority_tier;
-			else
-				p1 = job_rec1->part_ptr->priority_tier;
-		} else
+		if (het1 && (details = job_rec1->job_ptr->het_details))
+			p1 = details->priority_tier;
+		else
 			p1 = job_rec1->part_ptr->priority_tier;
 
-		if (bf_hetjob_prio && job_rec2->job_ptr->het_job_id &&
-		    (job_rec2->job_ptr->het_job_id !=
-		     job_rec1->job_ptr->het_job_id)) {
-			if ((details = job_rec2->job_ptr->het_details))
-				p2 = details->priority_tier;
-			else
-				p2 = job_rec2->part_ptr->priority_tier;
-		} else
+		if (het2 && (details = job_rec2->job_ptr->het_details))
+			p2 = details->priority_tier;
+		else
 			p2 = job_rec2->part_ptr->priority_tier;
 
 		if (p1 < p2)
@@ -2133,45 +2278,15 @@ extern int sort_job_queue2(void *x, void *y)
 			return -1;
 	}
 
-	if (bf_hetjob_prio && job_rec1->job_ptr->het_job_id &&
-	    (job_rec1->job_ptr->het_job_id !=
-	     job_rec2->job_ptr->het_job_id)) {
-		if ((details = job_rec1->job_ptr->het_details))
-			p1 = details->priority;
-		else {
-			if (job_rec1->job_ptr->part_ptr_list &&
-			    job_rec1->job_ptr->priority_array)
-				p1 = job_rec1->priority;
-			else
-				p1 = job_rec1->job_ptr->priority;
-		}
-	} else {
-		if (job_rec1->job_ptr->part_ptr_list &&
-		    job_rec1->job_ptr->priority_array)
-			p1 = job_rec1->priority;
-		else
-			p1 = job_rec1->job_ptr->priority;
-	}
-
-	if (bf_hetjob_prio && job_rec2->job_ptr->het_job_id &&
-	    (job_rec2->job_ptr->het_job_id !=
-	     job_rec1->job_ptr->het_job_id)) {
-		if ((details = job_rec2->job_ptr->het_details))
-			p2 = details->priority;
-		else {
-			if (job_rec2->job_ptr->part_ptr_list &&
-			    job_rec2->job_ptr->priority_array)
-				p2 = job_rec2->priority;
-			else
-				p2 = job_rec2->job_ptr->priority;
-		}
-	} else {
-		if (job_rec2->job_ptr->part_ptr_list &&
-		    job_rec2->job_ptr->priority_array)
-			p2 = job_rec2->priority;
-		else
-			p2 = job_rec2->job_ptr->priority;
-	}
+	if (het1 && (details = job_rec1->job_ptr->het_details))
+		p1 = details->priority;
+	else
+		p1 = job_rec1->sort_prio;
+
+	if (het2 && (details = job_rec2->job_ptr->het_details))
+		p2 = details->priority;
+	else
+		p2 = job_rec2->sort_prio;
 
 	if (p1 < p2)
 		return 1;
@@ -2179,27 +2294,17 @@ extern int sort_job_queue2(void *x, void *y)
 		return -1;
 
 	/* If the priorities are the same sort by submission time */
-	if (job_rec1->job_ptr->details && job_rec2->job_ptr->details) {
-		if (job_rec1->job_ptr->details->submit_time >
-		    job_rec2->job_ptr->details->submit_time)
+	if (job_rec1->submit_time && job_rec2->submit_time) {
+		if (job_rec1->submit_time > job_rec2->submit_time)
 			return 1;
-		if (job_rec2->job_ptr->details->submit_time >
-		    job_rec1->job_ptr->details->submit_time)
+		if (job_rec2->submit_time > job_rec1->submit_time)
 			return -1;
 	}
 
 	/* If the submission times are the same sort by increasing job id's */
-	if (job_rec1->array_task_id == NO_VAL)
-		job_id1 = job_rec1->job_id;
-	else
-		job_id1 = job_rec1->job_ptr->array_job_id;
-	if (job_rec2->array_task_id == NO_VAL)
-		job_id2 = job_rec2->job_id;
-	else
-		job_id2 = job_rec2->job_ptr->array_job_id;
-	if (job_id1 > job_id2)
+	if (job_rec1->sort_job_id > job_rec2->sort_job_id)
 		return 1;
-	else if (job_id1 < job_id2)
+	else if (job_rec1->sort_job_id < job_rec2->sort_job_id)
 		return -1;
 
 	/* If job IDs match compare task IDs */
@@ -2620,6 +2725,7 @@ extern void launch_job(job_record_t *job_ptr)
 	uint16_t protocol_version = NO_VAL16;
 	agent_arg_t *agent_arg_ptr;
 	job_record_t *launch_job_ptr;
+	job_trace_span_t span;
 #ifdef HAVE_FRONT_END
 	front_end_record_t *front_end_ptr;
 #else
@@ -2632,6 +2738,8 @@ extern void launch_job(job_record_t *job_ptr)
 	if (job_ptr->total_cpus == 0)
 		return;
 
+	job_trace_start(&span);
+
 	launch_job_ptr = _het_job_ready(job_ptr);
 	if (!launch_job_ptr)
 		return;
@@ -2669,6 +2777,7 @@ extern void launch_job(job_record_t *job_ptr)
 
 	/* Launch the RPC via agent */
 	agent_queue_request(agent_arg_ptr);
+	job_trace_end(&span, job_ptr->job_id, "ctld_launch");
 }
 
 /*
@@ -3025,6 +3134,7 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 	bool is_complete, is_completed, is_pending;
 	bool or_satisfied = false, and_failed = false, or_flag = false,
 	     has_unfulfilled = false, changed = false;
+	bool cacheable = !fed_mgr_fed_rec;
 
 	if ((job_ptr->details == NULL) ||
 	    (job_ptr->details->depend_list == NULL) ||
@@ -3035,6 +3145,18 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 		return NO_DEPEND;
 	}
 
+	/*
+	 * Nothing this job waits on can have changed since it was last found
+	 * waiting on local jobs, so the answer is the same.
+	 */
+	if (job_ptr->details->depend_epoch == job_state_epoch) {
+		job_ptr->bit_flags |= JOB_DEPENDENT;
+		acct_policy_remove_accrue_time(job_ptr, false);
+		if (was_changed)
+			*was_changed = changed;
+		return LOCAL_DEPEND;
+	}
+
 	depend_iter = list_iterator_create(job_ptr->details->depend_list);
 	while ((dep_ptr = list_next(depend_iter))) {
 		bool clear_dep = false, failure = false;
@@ -3042,6 +3164,14 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 
 		remote = (dep_ptr->depend_flags & SLURM_FLAGS_REMOTE) ?
 			true : false;
+
+		/*
+		 * Time based and burst buffer dependencies can be satisfied
+		 * without any job changing state.
+		 */
+		if (dep_ptr->depend_time || remote ||
+		    (dep_ptr->depend_type == SLURM_DEPEND_BURST_BUFFER))
+			cacheable = false;
 		/*
 		 * If the job id is for a cluster that's not in the federation
 		 * (it's likely the cluster left the federation), then set
@@ -3074,8 +3204,10 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 		djob_ptr = dep_ptr->job_ptr;
 		if ((dep_ptr->depend_type == SLURM_DEPEND_SINGLETON) &&
 		    job_ptr->name) {
-			if (list_find_first(job_list, _find_singleton_job,
-					    job_ptr) ||
+			if (find_user_job_by_name(job_ptr->user_id,
+						  job_ptr->name,
+						  _find_singleton_job,
+						  job_ptr) ||
 			    !fed_mgr_is_singleton_satisfied(job_ptr,
 							    dep_ptr, true)) {
 				/* Still depends */
@@ -3168,6 +3300,11 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 				REMOTE_DEPEND;
 	}
 
+	if (cacheable && (results == LOCAL_DEPEND))
+		job_ptr->details->depend_epoch = job_state_epoch;
+	else
+		job_ptr->details->depend_epoch = 0;
+
 	if (was_changed)
 		*was_changed = changed;
 	return results;
@@ -3636,6 +3773,7 @@ extern bool update_job_dependency_list(job_record_t *job_ptr,
 	xassert(job_ptr->details->depend_list);
 
 	job_depend_list = job_ptr->details->depend_list;
+	job_ptr->details->depend_epoch = 0;
 
 	itr = list_iterator_create(new_depend_list);
 	while ((dep_ptr = list_next(itr))) {
@@ -3791,6 +3929,7 @@ extern int update_job_dependency(job_record_t *job_ptr, char *new_depend)
 
 	/* Clear dependencies on NULL, "0", or empty dependency input */
 	job_ptr->details->expanding_jobid = 0;
+	job_ptr->details->depend_epoch = 0;
 	if ((new_depend == NULL) || (new_depend[0] == '\0') ||
 	    ((new_depend[0] == '0') && (new_depend[1] == '\0'))) {
 		xfree(job_ptr->details->dependency);
@@ -4246,6 +4385,50 @@ next_part:
 	return rc;
 }
 
+/*
+ * Answer a will-run request for a pending job from the backfill scheduler's
+ * latest plan, the same data squeue --start reports. Only needs read locks.
+ */
+extern int job_start_data_planned(job_record_t *job_ptr,
+				  will_run_response_msg_t **resp)
+{
+	will_run_response_msg_t *resp_data;
+
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+
+	if (job_ptr == NULL)
+		return ESLURM_INVALID_JOB_ID;
+
+	/* See job_start_data() for why IS_JOB_PENDING is not used here */
+	if ((job_ptr->details == NULL) || (job_ptr->job_state != JOB_PENDING))
+		return ESLURM_DISABLED;
+
+	/*
+	 * The plan carries no preemptee list, so fall back to a full test
+	 * whenever preemption could change the answer.
+	 */
+	if (!job_ptr->start_time || !job_ptr->sched_nodes ||
+	    !job_ptr->part_ptr || slurm_preemption_enabled())
+		return ESLURM_NOT_SUPPORTED;
+
+	resp_data = xmalloc(sizeof(will_run_response_msg_t));
+	resp_data->job_id = job_ptr->job_id;
+	resp_data->proc_cnt = MAX(job_ptr->total_cpus,
+				  job_ptr->details->min_cpus);
+	resp_data->start_time = MAX(job_ptr->start_time, time(NULL));
+	if (job_ptr->details->begin_time)
+		resp_data->start_time = MAX(resp_data->start_time,
+					    job_ptr->details->begin_time);
+	resp_data->node_list = xstrdup(job_ptr->sched_nodes);
+	resp_data->part_name = xstrdup(job_ptr->part_ptr->name);
+	/* Last value computed by a full test, avoids touching node data */
+	resp_data->sys_usage_per = sys_usage_per;
+
+	*resp = resp_data;
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * epilog_slurmctld - execute the epilog_slurmctld for a job that has just
  *	terminated.
@@ -4626,6 +4809,9 @@ extern void prolog_running_decr(job_record_t *job_ptr)
 			launch_job(job_ptr);
 		}
 	}
+
+	/* Steps rejected while the prolog was running can be retried now */
+	wake_all_pending_steps(job_ptr);
 }
 
 /*
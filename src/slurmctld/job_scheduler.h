@@ -56,6 +56,16 @@ typedef struct job_queue_rec {
 					 * in without requesting */
 	bool use_prefer; /* This is a separate queue record to evaluate the
 			    job's prefer constraint. */
+
+	/*
+	 * Sort keys copied from the job record when the queue is built so
+	 * sort_job_queue2() does not have to chase job_ptr and its details.
+	 */
+	bool has_resv;			/* Job requested or can use a resv */
+	uint32_t het_job_id;		/* Hetjob leader ID, or 0 */
+	uint32_t sort_job_id;		/* Job ID, or array_job_id for tasks */
+	uint32_t sort_prio;		/* Priority ordering this record */
+	time_t submit_time;		/* Submit time, 0 if no details */
 } job_queue_rec_t;
 
 /* Use as return values for test_job_dependency. */
@@ -165,6 +175,15 @@ extern bool job_is_completing(bitstr_t *eff_cg_bitmap);
 extern int job_start_data(job_record_t *job_ptr,
 			  will_run_response_msg_t **resp);
 
+/*
+ * Build a will-run response for a pending job from the start time and nodes
+ * planned by the last backfill cycle. Caller must hold the job read lock.
+ * RET SLURM_SUCCESS, or an error code if no usable plan exists and
+ * job_start_data() must be used instead. Caller must free response message.
+ */
+extern int job_start_data_planned(job_record_t *job_ptr,
+				  will_run_response_msg_t **resp);
+
 /*
  * launch_job - send an RPC to a slurmd to initiate a batch job
  * IN job_ptr - pointer to job that will be initiated
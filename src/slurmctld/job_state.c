@@ -35,9 +35,12 @@
 \*****************************************************************************/
 
 #include "src/common/macros.h"
+#include "src/common/xstring.h"
 
 #include "src/slurmctld/slurmctld.h"
 
+uint64_t job_state_epoch = 1;
+
 #ifndef NDEBUG
 
 #define T(x) { x, XSTRINGIFY(x) }
@@ -117,6 +120,7 @@ extern void job_state_set(job_record_t *job_ptr, uint32_t state)
 	_log_job_state_change(job_ptr, state);
 
 	job_ptr->job_state = state;
+	job_state_epoch++;
 }
 
 extern void job_state_set_flag(job_record_t *job_ptr, uint32_t flag)
@@ -131,6 +135,7 @@ extern void job_state_set_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	job_ptr->job_state = job_state;
+	job_state_epoch++;
 }
 
 extern void job_state_unset_flag(job_record_t *job_ptr, uint32_t flag)
@@ -145,4 +150,20 @@ extern void job_state_unset_flag(job_record_t *job_ptr, uint32_t flag)
 	_log_job_state_change(job_ptr, job_state);
 
 	job_ptr->job_state = job_state;
+	job_state_epoch++;
+}
+
+extern bool job_state_set_reason(job_record_t *job_ptr, uint32_t reason,
+				 const char *desc)
+{
+	if ((job_ptr->state_reason == reason) &&
+	    !xstrcmp(job_ptr->state_desc, desc))
+		return false;
+
+	job_ptr->state_reason = reason;
+	xfree(job_ptr->state_desc);
+	job_ptr->state_desc = xstrdup(desc);
+	last_job_update = time(NULL);
+
+	return true;
 }
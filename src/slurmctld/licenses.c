@@ -1312,13 +1312,23 @@ extern bool slurm_bf_licenses_avail(bf_licenses_t *licenses,
 extern bool slurm_bf_licenses_equal(bf_licenses_t *a, bf_licenses_t *b)
 {
 	bf_license_t *entry_a, *entry_b;
-	list_itr_t *iter;
+	list_itr_t *iter, *iter_b;
 	bool equivalent = true;
 
+	/*
+	 * Both lists are normally copies of the same initial list, so walk
+	 * them in step and only search b when the entries are out of order.
+	 * There is only one entry per name not bound to a reservation, so the
+	 * positional match is the one list_find_first() would return.
+	 */
 	iter = list_iterator_create(a);
+	iter_b = list_iterator_create(b);
 	while ((entry_a = list_next(iter))) {
-		entry_b = list_find_first(b, _bf_licenses_find_rec,
-					  entry_a->name);
+		entry_b = list_next(iter_b);
+		if (!entry_b || entry_b->resv_ptr ||
+		    xstrcmp(entry_a->name, entry_b->name))
+			entry_b = list_find_first(b, _bf_licenses_find_rec,
+						  entry_a->name);
 
 		if (!entry_b || (entry_a->remaining != entry_b->remaining) ||
 		    (entry_a->resv_ptr != entry_b->resv_ptr)) {
@@ -1326,6 +1336,7 @@ extern bool slurm_bf_licenses_equal(bf_licenses_t *a, bf_licenses_t *b)
 			break;
 		}
 	}
+	list_iterator_destroy(iter_b);
 	list_iterator_destroy(iter);
 
 	return equivalent;
@@ -41,13 +41,31 @@
 #include <pthread.h>
 #include <string.h>
 #include <sys/types.h>
+#include <time.h>
 
+#include "src/common/assoc_mgr.h"
+#include "src/common/openmetrics.h"
+#include "src/common/pack.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
+#define LOCK_TYPE_CNT 5
+/* Bucket i counts durations below 10^(i+1) usec, the last one is unbounded */
+#define LOCK_STATS_HIST_CNT 7
+
+typedef struct {
+	uint64_t acquired;
+	uint64_t wait_hist[LOCK_STATS_HIST_CNT];
+	uint64_t wait_max;
+	uint64_t wait_time;
+	uint64_t hold_hist[LOCK_STATS_HIST_CNT];
+	uint64_t hold_max;
+	uint64_t hold_time;
+} lock_stats_t;
+
 static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-static pthread_rwlock_t slurmctld_locks[5] = {
+static pthread_rwlock_t slurmctld_locks[LOCK_TYPE_CNT] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
@@ -55,6 +73,19 @@ static pthread_rwlock_t slurmctld_locks[5] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 };
 
+static const char *lock_type_names[LOCK_TYPE_CNT] = {
+	"config", "job", "node", "partition", "federation"
+};
+
+static pthread_mutex_t lock_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Indexed by lock_datatype_t and (lock_level_t - 1) */
+static lock_stats_t lock_stats[LOCK_TYPE_CNT][2];
+/* Time each write lock was acquired, protected by that write lock */
+static struct timespec write_lock_start[LOCK_TYPE_CNT];
+
+/* usec this thread has waited for slurmctld locks, for per-RPC accounting */
+static __thread uint64_t thread_lock_wait = 0;
+
 #ifndef NDEBUG
 /*
  * Used to protect against double-locking within a single thread. Calling
@@ -102,41 +133,112 @@ static bool _clear_locks(slurmctld_lock_t lock_levels)
 	return true;
 }
 
+/*
+ * lock_slurmctld() must always be called before assoc_mgr_lock(). Taking them
+ * in the reverse order can deadlock against another thread that follows the
+ * documented order, so verify this thread holds no assoc_mgr locks.
+ */
+static bool _assoc_mgr_unlocked(void)
+{
+	for (int i = 0; i < ASSOC_MGR_ENTITY_COUNT; i++) {
+		if (!verify_assoc_unlock(i))
+			return false;
+	}
+
+	return true;
+}
+
 extern bool verify_lock(lock_datatype_t datatype, lock_level_t level)
 {
 	return (((lock_level_t *) &thread_locks)[datatype] >= level);
 }
 #endif
 
-/* lock_slurmctld - Issue the required lock requests in a well defined order */
-extern void lock_slurmctld(slurmctld_lock_t lock_levels)
+static uint64_t _usec_diff(struct timespec *start, struct timespec *end)
 {
-	xassert(_store_locks(lock_levels));
+	int64_t usec = ((int64_t) (end->tv_sec - start->tv_sec) * USEC_IN_SEC) +
+		       ((end->tv_nsec - start->tv_nsec) / NSEC_IN_USEC);
+
+	return (usec > 0) ? usec : 0;
+}
+
+static void _hist_add(uint64_t *hist, uint64_t usec)
+{
+	int i = 0;
+
+	for (uint64_t bound = 10; (i < (LOCK_STATS_HIST_CNT - 1)) &&
+				  (usec >= bound); bound *= 10)
+		i++;
+	hist[i]++;
+}
 
-	if (lock_levels.conf == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[CONF_LOCK]);
-	else if (lock_levels.conf == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[CONF_LOCK]);
+static void _lock(lock_datatype_t datatype, lock_level_t level)
+{
+	struct timespec start, end;
+	lock_stats_t *stats;
+	uint64_t usec;
+
+	if (level == NO_LOCK)
+		return;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (level == READ_LOCK)
+		slurm_rwlock_rdlock(&slurmctld_locks[datatype]);
+	else
+		slurm_rwlock_wrlock(&slurmctld_locks[datatype]);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if (level == WRITE_LOCK)
+		write_lock_start[datatype] = end;
+
+	usec = _usec_diff(&start, &end);
+	thread_lock_wait += usec;
+	stats = &lock_stats[datatype][level - 1];
+	slurm_mutex_lock(&lock_stats_mutex);
+	stats->acquired++;
+	stats->wait_time += usec;
+	stats->wait_max = MAX(stats->wait_max, usec);
+	_hist_add(stats->wait_hist, usec);
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
 
-	if (lock_levels.job == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[JOB_LOCK]);
-	else if (lock_levels.job == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[JOB_LOCK]);
+static void _unlock(lock_datatype_t datatype, lock_level_t level)
+{
+	if (level == NO_LOCK)
+		return;
+
+	/*
+	 * Only writers are tracked for hold time, as the many concurrent
+	 * readers would each need their own acquisition timestamp.
+	 */
+	if (level == WRITE_LOCK) {
+		lock_stats_t *stats = &lock_stats[datatype][level - 1];
+		struct timespec end;
+		uint64_t usec;
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		usec = _usec_diff(&write_lock_start[datatype], &end);
+		slurm_mutex_lock(&lock_stats_mutex);
+		stats->hold_time += usec;
+		stats->hold_max = MAX(stats->hold_max, usec);
+		_hist_add(stats->hold_hist, usec);
+		slurm_mutex_unlock(&lock_stats_mutex);
+	}
 
-	if (lock_levels.node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[NODE_LOCK]);
-	else if (lock_levels.node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[NODE_LOCK]);
+	slurm_rwlock_unlock(&slurmctld_locks[datatype]);
+}
 
-	if (lock_levels.part == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[PART_LOCK]);
-	else if (lock_levels.part == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[PART_LOCK]);
+/* lock_slurmctld - Issue the required lock requests in a well defined order */
+extern void lock_slurmctld(slurmctld_lock_t lock_levels)
+{
+	xassert(_assoc_mgr_unlocked());
+	xassert(_store_locks(lock_levels));
 
-	if (lock_levels.fed == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[FED_LOCK]);
-	else if (lock_levels.fed == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[FED_LOCK]);
+	_lock(CONF_LOCK, lock_levels.conf);
+	_lock(JOB_LOCK, lock_levels.job);
+	_lock(NODE_LOCK, lock_levels.node);
+	_lock(PART_LOCK, lock_levels.part);
+	_lock(FED_LOCK, lock_levels.fed);
 }
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
@@ -145,20 +247,108 @@ extern void unlock_slurmctld(slurmctld_lock_t lock_levels)
 {
 	xassert(_clear_locks(lock_levels));
 
-	if (lock_levels.fed)
-		slurm_rwlock_unlock(&slurmctld_locks[FED_LOCK]);
+	_unlock(FED_LOCK, lock_levels.fed);
+	_unlock(PART_LOCK, lock_levels.part);
+	_unlock(NODE_LOCK, lock_levels.node);
+	_unlock(JOB_LOCK, lock_levels.job);
+	_unlock(CONF_LOCK, lock_levels.conf);
+}
 
-	if (lock_levels.part)
-		slurm_rwlock_unlock(&slurmctld_locks[PART_LOCK]);
+/* pack_lock_stats - pack lock wait and hold statistics into a buffer */
+extern void pack_lock_stats(buf_t *buffer, uint16_t protocol_version)
+{
+	uint32_t cnt = LOCK_TYPE_CNT * 2, hist_cnt = cnt * LOCK_STATS_HIST_CNT;
+	char *names[LOCK_TYPE_CNT * 2];
+	uint64_t acquired[LOCK_TYPE_CNT * 2];
+	uint64_t wait_time[LOCK_TYPE_CNT * 2], wait_max[LOCK_TYPE_CNT * 2];
+	uint64_t hold_time[LOCK_TYPE_CNT * 2], hold_max[LOCK_TYPE_CNT * 2];
+	uint64_t wait_hist[LOCK_TYPE_CNT * 2 * LOCK_STATS_HIST_CNT];
+	uint64_t hold_hist[LOCK_TYPE_CNT * 2 * LOCK_STATS_HIST_CNT];
+
+	if (protocol_version < SLURM_24_08_PROTOCOL_VERSION)
+		return;
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	for (int i = 0; i < cnt; i++) {
+		lock_stats_t *stats = &lock_stats[i / 2][i % 2];
+
+		names[i] = xstrdup_printf("%s_%s", lock_type_names[i / 2],
+					  ((i % 2) ? "write" : "read"));
+		acquired[i] = stats->acquired;
+		wait_time[i] = stats->wait_time;
+		wait_max[i] = stats->wait_max;
+		hold_time[i] = stats->hold_time;
+		hold_max[i] = stats->hold_max;
+		memcpy(&wait_hist[i * LOCK_STATS_HIST_CNT], stats->wait_hist,
+		       sizeof(stats->wait_hist));
+		memcpy(&hold_hist[i * LOCK_STATS_HIST_CNT], stats->hold_hist,
+		       sizeof(stats->hold_hist));
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+
+	packstr_array(names, cnt, buffer);
+	pack64_array(acquired, cnt, buffer);
+	pack64_array(wait_time, cnt, buffer);
+	pack64_array(wait_max, cnt, buffer);
+	pack64_array(hold_time, cnt, buffer);
+	pack64_array(hold_max, cnt, buffer);
+	pack32(LOCK_STATS_HIST_CNT, buffer);
+	pack64_array(wait_hist, hist_cnt, buffer);
+	pack64_array(hold_hist, hist_cnt, buffer);
+
+	for (int i = 0; i < cnt; i++)
+		xfree(names[i]);
+}
 
-	if (lock_levels.node)
-		slurm_rwlock_unlock(&slurmctld_locks[NODE_LOCK]);
+static void _lock_metric(char **out, char **pos, const char *name,
+			 const char *help, uint64_t *values)
+{
+	char *labels = NULL;
+
+	openmetrics_family(out, pos, name, OPENMETRICS_COUNTER, help);
+	for (int i = 0; i < LOCK_TYPE_CNT * 2; i++) {
+		xstrfmtcat(labels, "lock=\"%s\",mode=\"%s\"",
+			   lock_type_names[i / 2],
+			   ((i % 2) ? "write" : "read"));
+		openmetrics_sample(out, pos, name, OPENMETRICS_COUNTER, labels,
+				   values[i]);
+		xfree(labels);
+	}
+}
 
-	if (lock_levels.job)
-		slurm_rwlock_unlock(&slurmctld_locks[JOB_LOCK]);
+extern void lock_stats_metrics(char **out, char **pos)
+{
+	uint64_t acquired[LOCK_TYPE_CNT * 2];
+	uint64_t wait_time[LOCK_TYPE_CNT * 2], hold_time[LOCK_TYPE_CNT * 2];
+
+	slurm_mutex_lock(&lock_stats_mutex);
+	for (int i = 0; i < LOCK_TYPE_CNT * 2; i++) {
+		acquired[i] = lock_stats[i / 2][i % 2].acquired;
+		wait_time[i] = lock_stats[i / 2][i % 2].wait_time;
+		hold_time[i] = lock_stats[i / 2][i % 2].hold_time;
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+
+	_lock_metric(out, pos, "slurmctld_lock_acquired",
+		     "Number of times each slurmctld lock was acquired",
+		     acquired);
+	_lock_metric(out, pos, "slurmctld_lock_wait_microseconds",
+		     "Time spent waiting for each slurmctld lock", wait_time);
+	_lock_metric(out, pos, "slurmctld_lock_hold_microseconds",
+		     "Time each slurmctld lock was held", hold_time);
+}
 
-	if (lock_levels.conf)
-		slurm_rwlock_unlock(&slurmctld_locks[CONF_LOCK]);
+extern uint64_t lock_thread_wait_time(void)
+{
+	return thread_lock_wait;
+}
+
+/* reset_lock_stats - clear lock wait and hold statistics */
+extern void reset_lock_stats(void)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	memset(lock_stats, 0, sizeof(lock_stats));
+	slurm_mutex_unlock(&lock_stats_mutex);
 }
 
 /*
@@ -93,6 +93,8 @@
 
 #include <stdbool.h>
 
+#include "src/common/pack.h"
+
 /* levels of locking required for each data structure */
 typedef enum {
 	NO_LOCK,
@@ -130,6 +132,21 @@ extern void unlock_slurmctld (slurmctld_lock_t lock_levels);
 
 extern int report_locks_set(void);
 
+/* pack_lock_stats - pack lock wait and hold statistics into a buffer */
+extern void pack_lock_stats(buf_t *buffer, uint16_t protocol_version);
+
+/* lock_stats_metrics - append lock statistics in OpenMetrics format */
+extern void lock_stats_metrics(char **out, char **pos);
+
+/*
+ * lock_thread_wait_time - usec the calling thread has spent waiting for
+ *	slurmctld locks since it started
+ */
+extern uint64_t lock_thread_wait_time(void);
+
+/* reset_lock_stats - clear lock wait and hold statistics */
+extern void reset_lock_stats(void);
+
 /* un/lock semaphore used for saving state of slurmctld */
 extern void lock_state_files ( void );
 extern void unlock_state_files ( void );
@@ -70,6 +70,7 @@
 #include "src/interfaces/auth.h"
 #include "src/interfaces/ext_sensors.h"
 #include "src/interfaces/gres.h"
+#include "src/interfaces/hash.h"
 #include "src/interfaces/mcs.h"
 #include "src/interfaces/node_features.h"
 #include "src/interfaces/select.h"
@@ -2655,6 +2656,8 @@ static int _update_node_gres(char *node_names, char *gres)
 				if (rc == SLURM_SUCCESS)
 					rc = rc2;
 			}
+			memset(&node_ptr->gres_reg_hash, 0,
+			       sizeof(node_ptr->gres_reg_hash));
 			gres_node_state_log(node_ptr->gres_list,
 					    node_ptr->name);
 		}
@@ -2942,6 +2945,35 @@ static void _split_node_config(node_record_t *node_ptr,
 	config_ptr->tot_sockets = reg_msg->sockets;
 }
 
+/*
+ * Fingerprint the GRES data of a registration message together with the node
+ * state it is validated against.
+ * RET true on success, false if no fingerprint could be computed
+ */
+static bool _gres_reg_hash(node_record_t *node_ptr,
+			   slurm_node_registration_status_msg_t *reg_msg,
+			   slurm_hash_t *hash)
+{
+	char *ctx = NULL;
+	int len;
+
+	if (!reg_msg->gres_info)
+		return false;
+
+	xstrfmtcat(ctx, "%s|%s|%u|%u|%u|%d",
+		   node_ptr->config_ptr->gres, node_ptr->gres,
+		   reg_msg->threads, reg_msg->cores, reg_msg->sockets,
+		   (slurm_conf.conf_flags & CTL_CONF_OR) ? 1 : 0);
+	memset(hash, 0, sizeof(*hash));
+	hash->type = HASH_PLUGIN_DEFAULT;
+	len = hash_g_compute(get_buf_data(reg_msg->gres_info),
+			     size_buf(reg_msg->gres_info), ctx, strlen(ctx),
+			     hash);
+	xfree(ctx);
+
+	return (len > 0);
+}
+
 /*
  * validate_node_specs - validate the node's specifications as valid,
  *	if not set state to down, in any case update last_response
@@ -2965,6 +2997,7 @@ extern int validate_node_specs(slurm_msg_t *slurm_msg, bool *newly_up)
 	int sockets1, sockets2;	/* total sockets on node */
 	int cores1, cores2;	/* total cores on node */
 	int threads1, threads2;	/* total threads on node */
+	slurm_hash_t gres_hash;
 	static time_t sched_update = 0;
 	static double conf_node_reg_mem_percent = -1;
 
@@ -3072,10 +3105,21 @@ extern int validate_node_specs(slurm_msg_t *slurm_msg, bool *newly_up)
 	sockets1 = reg_msg->sockets;
 	cores1   = sockets1 * reg_msg->cores;
 	threads1 = cores1   * reg_msg->threads;
-	if (gres_node_config_unpack(reg_msg->gres_info,
-				    node_ptr->name) != SLURM_SUCCESS) {
+	/*
+	 * Skip re-parsing and re-validating GRES if the node reported the
+	 * same GRES configuration as in its last successful registration.
+	 */
+	if (node_ptr->gres_list &&
+	    _gres_reg_hash(node_ptr, reg_msg, &gres_hash) &&
+	    !memcmp(&gres_hash, &node_ptr->gres_reg_hash, sizeof(gres_hash))) {
+		log_flag(GRES, "%s: node %s GRES configuration unchanged",
+			 __func__, node_ptr->name);
+	} else if (gres_node_config_unpack(reg_msg->gres_info,
+					   node_ptr->name) != SLURM_SUCCESS) {
 		error_code = SLURM_ERROR;
 		xstrcat(reason_down, "Could not unpack gres data");
+		memset(&node_ptr->gres_reg_hash, 0,
+		       sizeof(node_ptr->gres_reg_hash));
 	} else if (gres_node_config_validate(
 				node_ptr->name, config_ptr->gres,
 				&node_ptr->gres, &node_ptr->gres_list,
@@ -3086,6 +3130,12 @@ extern int validate_node_specs(slurm_msg_t *slurm_msg, bool *newly_up)
 		   != SLURM_SUCCESS) {
 		error_code = EINVAL;
 		/* reason_down set in function above */
+		memset(&node_ptr->gres_reg_hash, 0,
+		       sizeof(node_ptr->gres_reg_hash));
+	} else if (!_gres_reg_hash(node_ptr, reg_msg,
+				   &node_ptr->gres_reg_hash)) {
+		memset(&node_ptr->gres_reg_hash, 0,
+		       sizeof(node_ptr->gres_reg_hash));
 	}
 	gres_node_state_log(node_ptr->gres_list, node_ptr->name);
 
@@ -1246,15 +1246,13 @@ static int _get_req_features(struct node_set *node_set_ptr, int node_set_size,
 				    (prev_node_set_ptr->flags &
 				     NODE_SET_REBOOT))
 					continue;
+				if (bit_super_set(node_set_ptr[i].my_bitmap,
+						  feat_ptr->node_bitmap_active))
+					continue; /* No inactive nodes */
 				inactive_bitmap =
 					bit_copy(node_set_ptr[i].my_bitmap);
 				bit_and_not(inactive_bitmap,
 					    feat_ptr->node_bitmap_active);
-				if (bit_ffs(inactive_bitmap) == -1) {
-					/* No inactive nodes (require reboot) */
-					FREE_NULL_BITMAP(inactive_bitmap);
-					continue;
-				}
 				sort_again = true;
 				if (bit_equal(prev_node_set_ptr->my_bitmap,
 					      inactive_bitmap)) {
@@ -1718,6 +1716,12 @@ static int _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 				if (!bit_test(node_set_ptr[i].feature_bits, j))
 					continue;
 				feature_found = true;
+				if (avail_bitmap &&
+				    !(node_set_ptr[i].flags & NODE_SET_REBOOT)) {
+					bit_or(avail_bitmap,
+					       node_set_ptr[i].my_bitmap);
+					continue;
+				}
 				node_set_map =
 					bit_copy(node_set_ptr[i].my_bitmap);
 
@@ -2598,19 +2602,17 @@ extern int select_nodes(job_record_t *job_ptr, bool test_only,
 			/* Too many nodes requested */
 			debug3("%s: %pJ not runnable with present config",
 			       __func__, job_ptr);
-			job_ptr->state_reason = WAIT_PART_NODE_LIMIT;
-			xfree(job_ptr->state_desc);
-			last_job_update = now;
+			job_state_set_reason(job_ptr, WAIT_PART_NODE_LIMIT,
+					     NULL);
 
 		/* Non-fatal errors for job below */
 		} else if (error_code == ESLURM_NODE_NOT_AVAIL) {
 			/* Required nodes are down or drained */
 			char *node_str = NULL, *unavail_node = NULL;
+			char *desc = NULL;
 			bitstr_t *unavail_bitmap;
 			debug3("%s: %pJ required nodes not avail",
 			       __func__, job_ptr);
-			job_ptr->state_reason = WAIT_NODE_NOT_AVAIL;
-			xfree(job_ptr->state_desc);
 			unavail_bitmap = bit_copy(avail_node_bitmap);
 			filter_by_node_owner(job_ptr, unavail_bitmap);
 			bit_not(unavail_bitmap);
@@ -2626,30 +2628,28 @@ extern int select_nodes(job_record_t *job_ptr, bool test_only,
 			}
 			FREE_NULL_BITMAP(unavail_bitmap);
 			if (node_str) {
-				xstrfmtcat(job_ptr->state_desc,
+				xstrfmtcat(desc,
 					   "ReqNodeNotAvail, "
 					   "UnavailableNodes:%s",
 					   node_str);
 			} else {
-				xstrfmtcat(job_ptr->state_desc,
+				xstrfmtcat(desc,
 					   "ReqNodeNotAvail, May be reserved "
 					   "for other job");
 			}
 			xfree(unavail_node);
-			last_job_update = now;
+			job_state_set_reason(job_ptr, WAIT_NODE_NOT_AVAIL,
+					     desc);
+			xfree(desc);
 		} else if (error_code == ESLURM_RESERVATION_MAINT) {
 			error_code = ESLURM_RESERVATION_BUSY;	/* All reserved */
-			job_ptr->state_reason = WAIT_NODE_NOT_AVAIL;
-			xfree(job_ptr->state_desc);
-			xstrfmtcat(job_ptr->state_desc,
-				   "ReqNodeNotAvail, Reserved for maintenance");
+			job_state_set_reason(job_ptr, WAIT_NODE_NOT_AVAIL,
+					     "ReqNodeNotAvail, Reserved for maintenance");
 		} else if ((error_code == ESLURM_RESERVATION_NOT_USABLE) ||
 			   (error_code == ESLURM_RESERVATION_BUSY)) {
-			job_ptr->state_reason = WAIT_RESERVATION;
-			xfree(job_ptr->state_desc);
+			job_state_set_reason(job_ptr, WAIT_RESERVATION, NULL);
 		} else if (error_code == ESLURM_LICENSES_UNAVAILABLE) {
-			job_ptr->state_reason = WAIT_LICENSES;
-			xfree(job_ptr->state_desc);
+			job_state_set_reason(job_ptr, WAIT_LICENSES, NULL);
 		} else if ((job_ptr->state_reason == WAIT_HELD) &&
 			   (job_ptr->priority == 0)) {
 			/* Held by select plugin due to some failure */
@@ -2662,11 +2662,9 @@ extern int select_nodes(job_record_t *job_ptr, bool test_only,
 			 * future. FIXME: This is a kludge and this assumption
 			 * may be wrong.
 			 */
-			job_ptr->state_reason = FAIL_CONSTRAINTS;
-			xfree(job_ptr->state_desc);
+			job_state_set_reason(job_ptr, FAIL_CONSTRAINTS, NULL);
 		} else {
-			job_ptr->state_reason = WAIT_RESOURCES;
-			xfree(job_ptr->state_desc);
+			job_state_set_reason(job_ptr, WAIT_RESOURCES, NULL);
 		}
 		goto cleanup;
 	}
@@ -3543,10 +3541,8 @@ static int _build_node_list(job_record_t *job_ptr,
 			return ESLURM_REQUESTED_NODE_CONFIG_UNAVAILABLE;
 		}
 		if (resv_overlap && bit_ffs(usable_node_mask) < 0) {
-			job_ptr->state_reason = WAIT_NODE_NOT_AVAIL;
-			xfree(job_ptr->state_desc);
-			xstrfmtcat(job_ptr->state_desc,
-				   "ReqNodeNotAvail, Reserved for maintenance");
+			job_state_set_reason(job_ptr, WAIT_NODE_NOT_AVAIL,
+					     "ReqNodeNotAvail, Reserved for maintenance");
 			FREE_NULL_BITMAP(usable_node_mask);
 			return ESLURM_RESERVATION_BUSY; /* All reserved */
 		}
@@ -4107,6 +4103,33 @@ static int _nodes_in_sets(bitstr_t *req_bitmap,
 	return error_code;
 }
 
+typedef struct {
+	job_record_t *job_ptr;
+	int node_inx;
+} foreach_node_details_t;
+
+static int _build_node_detail(const char *node_name, void *arg)
+{
+	foreach_node_details_t *args = arg;
+	job_record_t *job_ptr = args->job_ptr;
+
+	if (find_node_record((char *) node_name)) {
+		args->node_inx++;
+	} else {
+		error("Invalid node %s in %pJ", node_name, job_ptr);
+	}
+	if (!job_ptr->batch_host && !job_ptr->batch_features) {
+		/*
+		 * Do not select until launch_job() as node features
+		 * might be changed by node_features plugin between
+		 * allocation time (now) and launch.
+		 */
+		job_ptr->batch_host = xstrdup(node_name);
+	}
+
+	return 0;
+}
+
 /*
  * build_node_details - sets addresses for allocated nodes
  * IN job_ptr - pointer to a job record
@@ -4115,9 +4138,9 @@ static int _nodes_in_sets(bitstr_t *req_bitmap,
 extern void build_node_details(job_record_t *job_ptr, bool new_alloc)
 {
 	hostlist_t *host_list = NULL;
-	node_record_t *node_ptr;
-	char *this_node_name;
-	int node_inx = 0;
+	foreach_node_details_t args = {
+		.job_ptr = job_ptr,
+	};
 
 	if ((job_ptr->node_bitmap == NULL) || (job_ptr->nodes == NULL)) {
 		/* No nodes allocated, we're done... */
@@ -4149,27 +4172,11 @@ extern void build_node_details(job_record_t *job_ptr, bool new_alloc)
 	xfree(job_ptr->batch_host);
 #endif
 
-	while ((this_node_name = hostlist_shift(host_list))) {
-		if ((node_ptr = find_node_record(this_node_name))) {
-			node_inx++;
-		} else {
-			error("Invalid node %s in %pJ",
-			      this_node_name, job_ptr);
-		}
-		if (!job_ptr->batch_host && !job_ptr->batch_features) {
-			/*
-			 * Do not select until launch_job() as node features
-			 * might be changed by node_features plugin between
-			 * allocation time (now) and launch.
-			 */
-			job_ptr->batch_host = xstrdup(this_node_name);
-		}
-		free(this_node_name);
-	}
+	(void) hostlist_for_each_host(host_list, 0, _build_node_detail, &args);
 	hostlist_destroy(host_list);
-	if (job_ptr->node_cnt != node_inx) {
+	if (job_ptr->node_cnt != args.node_inx) {
 		error("Node count mismatch for %pJ (%u,%u)",
-		      job_ptr, job_ptr->node_cnt, node_inx);
+		      job_ptr, job_ptr->node_cnt, args.node_inx);
 	}
 }
 
@@ -40,11 +40,13 @@
 #include "config.h"
 
 #include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
 #include "src/common/hostlist.h"
 #include "src/common/read_config.h"
+#include "src/common/xstring.h"
 
 #include "src/interfaces/select.h"
 
@@ -59,6 +61,9 @@
 /* Log an error for ping that takes more than 100 seconds to complete */
 #define PING_TIMEOUT 100
 
+/* Upper limit of SlurmctldParameters=ping_slices */
+#define MAX_PING_SLICES 60
+
 static pthread_mutex_t lock_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int ping_count = 0;
 static time_t ping_start = 0;
@@ -125,6 +130,30 @@ void ping_end (void)
 	slurm_mutex_unlock(&lock_mutex);
 }
 
+extern int get_ping_slices(void)
+{
+	static time_t last_update = 0;
+	static int ping_slices = 1;
+	char *tmp_ptr;
+
+	if (last_update == slurm_conf.last_update)
+		return ping_slices;
+
+	ping_slices = 1;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "ping_slices="))) {
+		ping_slices = atoi(tmp_ptr + 12);
+		if ((ping_slices < 1) || (ping_slices > MAX_PING_SLICES)) {
+			error("Invalid SlurmctldParameters ping_slices=%d, using 1",
+			      ping_slices);
+			ping_slices = 1;
+		}
+	}
+	last_update = slurm_conf.last_update;
+
+	return ping_slices;
+}
+
 /*
  * ping_nodes - check that all nodes and daemons are alive,
  *	get nodes in UNKNOWN state to register
@@ -141,6 +170,8 @@ void ping_nodes (void)
 	time_t now = time(NULL), still_live_time, node_dead_time;
 	static time_t last_ping_time = (time_t) 0;
 	static time_t last_ping_timeout = (time_t) 0;
+	static int ping_slice = 0;	/* slice of nodes to ping this call */
+	int ping_slices = get_ping_slices();
 	hostlist_t *down_hostlist = NULL;
 	char *host_str = NULL;
 	agent_arg_t *ping_agent_args = NULL;
@@ -182,17 +213,27 @@ void ping_nodes (void)
 		node_dead_time = last_ping_time - last_ping_timeout;
 	}
 	still_live_time = now - (slurm_conf.slurmd_timeout / 3);
-	last_ping_time  = now;
-	last_ping_timeout = slurm_conf.slurmd_timeout;
 
-	if (max_reg_threads == 0) {
-		max_reg_threads = MAX(slurm_conf.tree_width, 1);
-		max_reg_threads = MIN(max_reg_threads, 50);
+	if (ping_slice >= ping_slices)
+		ping_slice = 0;
+
+	/*
+	 * With ping_slices each call only pings one slice of the nodes, the
+	 * timeout and registration window advance once per full cycle.
+	 */
+	if (!ping_slice) {
+		last_ping_time  = now;
+		last_ping_timeout = slurm_conf.slurmd_timeout;
+
+		if (max_reg_threads == 0) {
+			max_reg_threads = MAX(slurm_conf.tree_width, 1);
+			max_reg_threads = MIN(max_reg_threads, 50);
+		}
+		reg_offset += max_reg_threads;
+		if ((reg_offset > active_node_record_count) &&
+		    (reg_offset >= (max_reg_threads * MAX_REG_FREQUENCY)))
+			reg_offset = 0;
 	}
-	reg_offset += max_reg_threads;
-	if ((reg_offset > active_node_record_count) &&
-	    (reg_offset >= (max_reg_threads * MAX_REG_FREQUENCY)))
-		reg_offset = 0;
 
 #ifdef HAVE_FRONT_END
 	for (i = 0, front_end_ptr = front_end_nodes;
@@ -297,6 +338,12 @@ void ping_nodes (void)
 			continue;
 		}
 
+		/* Nodes that still need to register are never deferred */
+		if ((ping_slices > 1) && !restart_flag &&
+		    !IS_NODE_UNKNOWN(node_ptr) && node_ptr->boot_time &&
+		    ((node_ptr->index % ping_slices) != ping_slice))
+			continue;
+
 		/* Request a node registration if its state is UNKNOWN or
 		 * on a periodic basis (about every MAX_REG_FREQUENCY ping,
 		 * this mechanism avoids an additional (per node) timer or
@@ -338,6 +385,7 @@ void ping_nodes (void)
 		if (PACK_FANOUT_ADDRS(node_ptr))
 			ping_agent_args->msg_flags |= SLURM_PACK_ADDRS;
 	}
+	ping_slice++;
 #endif
 
 	restart_flag = false;
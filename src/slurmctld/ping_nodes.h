@@ -71,4 +71,12 @@ extern void ping_end (void);
  */
 extern void ping_nodes (void);
 
+/*
+ * get_ping_slices - number of slices the node table is split into for
+ *	pinging, from SlurmctldParameters=ping_slices. ping_nodes() must be
+ *	called this many times more often to cover every node once per
+ *	ping interval.
+ */
+extern int get_ping_slices(void);
+
 #endif /* !_HAVE_PING_NODES_H */
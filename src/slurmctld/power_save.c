@@ -100,6 +100,7 @@ uint16_t slurmd_timeout;
 static bool idle_on_node_suspend = false;
 static uint16_t power_save_interval = 10;
 static uint16_t power_save_min_interval = 0;
+static uint32_t resume_chunk_size = 0;	/* nodes per ResumeProgram, 0=all */
 
 List resume_job_list = NULL;
 
@@ -128,6 +129,8 @@ static void  _clear_power_config(void);
 static void  _do_failed_nodes(char *hosts);
 static void  _do_power_work(time_t now);
 static void  _do_resume(char *host, char *json);
+static void  _do_resume_nodes(bitstr_t *wake_node_bitmap,
+			      data_t *resume_json_data);
 static void  _do_suspend(char *host);
 static int   _init_power_config(void);
 static void *_power_save_thread(void *arg);
@@ -662,23 +665,7 @@ static void _do_power_work(time_t now)
 	}
 
 	if (wake_node_bitmap) {
-		char *nodes, *json = NULL;
-		nodes = bitmap2node_name(wake_node_bitmap);
-
-		data_set_string(data_key_set(resume_json_data,
-					     "all_nodes_resume"),
-				nodes);
-		if (serialize_g_data_to_string(&json, NULL, resume_json_data,
-					       MIME_TYPE_JSON,
-					       SER_FLAGS_COMPACT))
-			error("failed to generate json for resume job/node list");
-
-		if (nodes)
-			_do_resume(nodes, json);
-		else
-			error("power_save: bitmap2nodename");
-		xfree(nodes);
-		xfree(json);
+		_do_resume_nodes(wake_node_bitmap, resume_json_data);
 		FREE_NULL_BITMAP(wake_node_bitmap);
 		nodes_updated = true;
 	}
@@ -738,6 +725,61 @@ static void _do_resume(char *host, char *json)
 	log_flag(POWER, "power_save: waking nodes %s", host);
 }
 
+/*
+ * Run ResumeProgram for every node in wake_node_bitmap. With
+ * power_save_resume_chunk set, each chunk of nodes gets its own
+ * ResumeProgram, which slurmscriptd runs concurrently.
+ */
+static void _do_resume_nodes(bitstr_t *wake_node_bitmap,
+			     data_t *resume_json_data)
+{
+	bitstr_t *chunk_bitmap = NULL;
+	int i = 0;
+
+	while (true) {
+		bitstr_t *run_bitmap = wake_node_bitmap;
+		char *nodes, *json = NULL;
+
+		if (resume_chunk_size) {
+			uint32_t cnt = 0;
+
+			if (!chunk_bitmap)
+				chunk_bitmap = bit_alloc(node_record_count);
+			else
+				bit_clear_all(chunk_bitmap);
+			for (; (cnt < resume_chunk_size) &&
+			     next_node_bitmap(wake_node_bitmap, &i); i++) {
+				bit_set(chunk_bitmap, i);
+				cnt++;
+			}
+			if (!cnt)
+				break;
+			run_bitmap = chunk_bitmap;
+		}
+
+		nodes = bitmap2node_name(run_bitmap);
+		data_set_string(data_key_set(resume_json_data,
+					     "all_nodes_resume"),
+				nodes);
+		if (serialize_g_data_to_string(&json, NULL, resume_json_data,
+					       MIME_TYPE_JSON,
+					       SER_FLAGS_COMPACT))
+			error("failed to generate json for resume job/node list");
+
+		if (nodes)
+			_do_resume(nodes, json);
+		else
+			error("power_save: bitmap2nodename");
+		xfree(nodes);
+		xfree(json);
+
+		if (!resume_chunk_size)
+			break;
+	}
+
+	FREE_NULL_BITMAP(chunk_bitmap);
+}
+
 static void _do_suspend(char *host)
 {
 	slurmscriptd_run_power(suspend_prog, host, NULL, 0, "suspendprog",
@@ -953,6 +995,13 @@ static int _init_power_config(void)
 			strtol(tmp_ptr + strlen("power_save_min_interval="),
 			       NULL, 10);
 	}
+	resume_chunk_size = 0;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "power_save_resume_chunk="))) {
+		resume_chunk_size =
+			strtoul(tmp_ptr + strlen("power_save_resume_chunk="),
+				NULL, 10);
+	}
 
 	power_save_set_timeouts(&partition_suspend_time_set);
 
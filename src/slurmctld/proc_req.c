@@ -60,8 +60,10 @@
 #include "src/common/group_cache.h"
 #include "src/common/hostlist.h"
 #include "src/common/id_util.h"
+#include "src/common/job_trace.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/openmetrics.h"
 #include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_persist_conn.h"
@@ -101,6 +103,7 @@
 #include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
+#include "src/slurmctld/rpc_queue.h"
 #include "src/slurmctld/sackd_mgr.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/slurmscriptd.h"
@@ -118,7 +121,20 @@ static uint32_t rpc_user_id[RPC_USER_SIZE] = { 0 };
 static uint32_t rpc_user_cnt[RPC_USER_SIZE] = { 0 };
 static uint64_t rpc_user_time[RPC_USER_SIZE] = { 0 };
 
+/* Cost of the RPCs, indexed like rpc_type_id[] and rpc_user_id[] */
+typedef struct {
+	uint64_t cpu_time;	/* usec of thread CPU time */
+	uint64_t lock_wait;	/* usec waiting for slurmctld locks */
+	uint64_t bytes_sent;	/* bytes of the replies */
+} rpc_cost_t;
+static rpc_cost_t rpc_type_cost[RPC_TYPE_SIZE];
+static rpc_cost_t rpc_user_cost[RPC_USER_SIZE];
+
+/* Snapshot of this thread's counters taken by record_rpc_start() */
+static __thread rpc_cost_t rpc_start;
+
 static bool do_post_rpc_node_registration = false;
+static bool do_post_rpc_epilog_complete = false;
 
 bool running_configless = false;
 static pthread_rwlock_t configless_lock = PTHREAD_RWLOCK_INITIALIZER;
@@ -164,8 +180,37 @@ typedef struct {
 	list_t *step_list;
 } find_job_by_container_id_args_t;
 
+static void _get_rpc_cost(rpc_cost_t *cost)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	cost->cpu_time = (ts.tv_sec * USEC_IN_SEC) + (ts.tv_nsec / NSEC_IN_USEC);
+	cost->lock_wait = lock_thread_wait_time();
+	cost->bytes_sent = slurm_thread_bytes_sent();
+}
+
+static void _add_rpc_cost(rpc_cost_t *total, rpc_cost_t *cost)
+{
+	total->cpu_time += cost->cpu_time;
+	total->lock_wait += cost->lock_wait;
+	total->bytes_sent += cost->bytes_sent;
+}
+
+extern void record_rpc_start(void)
+{
+	_get_rpc_cost(&rpc_start);
+}
+
 extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 {
+	rpc_cost_t cost;
+
+	_get_rpc_cost(&cost);
+	cost.cpu_time -= rpc_start.cpu_time;
+	cost.lock_wait -= rpc_start.lock_wait;
+	cost.bytes_sent -= rpc_start.bytes_sent;
+
 	slurm_mutex_lock(&rpc_mutex);
 	for (int i = 0; i < RPC_TYPE_SIZE; i++) {
 		if (rpc_type_id[i] == 0)
@@ -174,6 +219,7 @@ extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 			continue;
 		rpc_type_cnt[i]++;
 		rpc_type_time[i] += delta;
+		_add_rpc_cost(&rpc_type_cost[i], &cost);
 		break;
 	}
 	for (int i = 0; i < RPC_USER_SIZE; i++) {
@@ -183,6 +229,7 @@ extern void record_rpc_stats(slurm_msg_t *msg, long delta)
 			continue;
 		rpc_user_cnt[i]++;
 		rpc_user_time[i] += delta;
+		_add_rpc_cost(&rpc_user_cost[i], &cost);
 		break;
 	}
 	slurm_mutex_unlock(&rpc_mutex);
@@ -1570,6 +1617,13 @@ static void _slurm_rpc_dump_job_single(slurm_msg_t *msg)
 		READ_LOCK, READ_LOCK, NO_LOCK, READ_LOCK, READ_LOCK };
 
 	START_TIMER;
+	/* Reject unknown job ids without waiting on the job lock */
+	if (!job_id_exists(job_id_msg->job_id)) {
+		END_TIMER2(__func__);
+		slurm_send_rc_msg(msg, ESLURM_INVALID_JOB_ID);
+		return;
+	}
+
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 		lock_slurmctld(job_read_lock);
 	buffer = pack_one_job(job_id_msg->job_id, job_id_msg->show_flags,
@@ -1610,6 +1664,7 @@ static void _slurm_rpc_get_shares(slurm_msg_t *msg)
 static void _slurm_rpc_get_priority_factors(slurm_msg_t *msg)
 {
 	DEF_TIMERS;
+	buf_t *buffer;
 	priority_factors_response_msg_t resp_msg;
 	slurm_msg_t response_msg;
 	/* Read lock on jobs, nodes, and partitions */
@@ -1629,11 +1684,20 @@ static void _slurm_rpc_get_priority_factors(slurm_msg_t *msg)
 
 	resp_msg.priority_factors_list = priority_g_get_priority_factors_list(
 		msg->auth_uid);
-	response_init(&response_msg, msg, RESPONSE_PRIORITY_FACTORS, &resp_msg);
-	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	/*
+	 * The list references job records, so pack it while still locked but
+	 * don't hold the job read lock while writing to the client.
+	 */
+	buffer = init_buf(BUF_SIZE);
+	pack_priority_factors_response_msg(&resp_msg, buffer,
+					   msg->protocol_version);
 	assoc_mgr_unlock(&qos_read_locks);
 	unlock_slurmctld(job_read_lock);
 	FREE_NULL_LIST(resp_msg.priority_factors_list);
+
+	response_init(&response_msg, msg, RESPONSE_PRIORITY_FACTORS, buffer);
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	FREE_NULL_BUFFER(buffer);
 	END_TIMER2(__func__);
 	debug2("%s %s", __func__, TIME_STR);
 }
@@ -1851,13 +1915,48 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t *msg)
 	}
 }
 
+/*
+ * Run the scheduler and save state after epilog completion. When processed
+ * from the RPC queue this runs once per batch of MESSAGE_EPILOG_COMPLETE.
+ */
+static void _epilog_complete_schedule(void)
+{
+	static time_t config_update = 0;
+	static bool defer_sched = false;
+
+	if (config_update != slurm_conf.last_update) {
+		defer_sched = (xstrcasestr(slurm_conf.sched_params, "defer"));
+		config_update = slurm_conf.last_update;
+	}
+
+	/*
+	 * In defer mode, avoid triggering the scheduler logic
+	 * for every epilog complete message.
+	 * As one epilog message is sent from every node of each
+	 * job at termination, the number of simultaneous schedule
+	 * calls can be very high for large machine or large number
+	 * of managed jobs.
+	 */
+	if (!LOTS_OF_AGENTS && !defer_sched)
+		schedule(false);	/* Has own locking */
+	else
+		queue_job_scheduler();
+	schedule_node_save();		/* Has own locking */
+	schedule_job_save();		/* Has own locking */
+}
+
+static void _slurm_post_rpc_epilog_complete(void)
+{
+	if (do_post_rpc_epilog_complete)
+		_epilog_complete_schedule();
+	do_post_rpc_epilog_complete = false;
+}
+
 /* _slurm_rpc_epilog_complete - process RPC noting the completion of
  * the epilog denoting the completion of a job it its entirety */
 static void _slurm_rpc_epilog_complete(slurm_msg_t *msg)
 {
 	static int active_rpc_cnt = 0;
-	static time_t config_update = 0;
-	static bool defer_sched = false;
 	DEF_TIMERS;
 	/* Locks: Read configuration, write job, write node */
 	slurmctld_lock_t job_write_lock = {
@@ -1876,12 +1975,6 @@ static void _slurm_rpc_epilog_complete(slurm_msg_t *msg)
 	/* Only throttle on non-composite messages, the lock should
 	 * already be set earlier. */
 	if (!(msg->flags & CTLD_QUEUE_PROCESSING)) {
-		if (config_update != slurm_conf.last_update) {
-			defer_sched = (xstrcasestr(slurm_conf.sched_params,
-						   "defer"));
-			config_update = slurm_conf.last_update;
-		}
-
 		_throttle_start(&active_rpc_cnt);
 		lock_slurmctld(job_write_lock);
 	}
@@ -1911,21 +2004,11 @@ static void _slurm_rpc_epilog_complete(slurm_msg_t *msg)
 	END_TIMER2(__func__);
 
 	/* Functions below provide their own locking */
-	if (!(msg->flags & CTLD_QUEUE_PROCESSING) && run_scheduler) {
-		/*
-		 * In defer mode, avoid triggering the scheduler logic
-		 * for every epilog complete message.
-		 * As one epilog message is sent from every node of each
-		 * job at termination, the number of simultaneous schedule
-		 * calls can be very high for large machine or large number
-		 * of managed jobs.
-		 */
-		if (!LOTS_OF_AGENTS && !defer_sched)
-			schedule(false);	/* Has own locking */
+	if (run_scheduler) {
+		if (msg->flags & CTLD_QUEUE_PROCESSING)
+			do_post_rpc_epilog_complete = true;
 		else
-			queue_job_scheduler();
-		schedule_node_save();		/* Has own locking */
-		schedule_job_save();		/* Has own locking */
+			_epilog_complete_schedule();
 	}
 
 	/* NOTE: RPC has no response */
@@ -2567,6 +2650,19 @@ static void _slurm_rpc_job_will_run(slurm_msg_t *msg)
 		slurm_get_ip_str(&resp_addr, job_desc_msg->resp_host,
 				 INET6_ADDRSTRLEN);
 		dump_job_desc(job_desc_msg);
+		if ((error_code == SLURM_SUCCESS) &&
+		    (job_desc_msg->job_id != NO_VAL)) {
+			/* Try the backfill plan first, under read locks */
+			lock_slurmctld(job_read_lock);
+			job_ptr = find_job_record(job_desc_msg->job_id);
+			if (job_start_data_planned(job_ptr, &resp) ==
+			    SLURM_SUCCESS) {
+				unlock_slurmctld(job_read_lock);
+				END_TIMER2(__func__);
+				goto send_reply;
+			}
+			unlock_slurmctld(job_read_lock);
+		}
 		if (error_code == SLURM_SUCCESS) {
 			lock_slurmctld(job_write_lock);
 			if (job_desc_msg->job_id == NO_VAL) {
@@ -3648,7 +3744,9 @@ static void _slurm_rpc_submit_batch_job(slurm_msg_t *msg)
 		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
 	char *err_msg = NULL, *job_submit_user_msg = NULL;
 	bool reject_job = false;
+	job_trace_span_t span;
 
+	job_trace_start(&span);
 	START_TIMER;
 	if (slurmctld_config.submissions_disabled) {
 		info("Submissions disabled on system");
@@ -3779,6 +3877,7 @@ send_msg:
 		response_init(&response_msg, msg, RESPONSE_SUBMIT_BATCH_JOB,
 			      &submit_msg);
 		slurm_send_node_msg(msg->conn_fd, &response_msg);
+		job_trace_end(&span, job_id, "ctld_submit");
 
 		schedule_job_save();	/* Has own locks */
 		schedule_node_save();	/* Has own locks */
@@ -3788,6 +3887,159 @@ send_msg:
 	xfree(job_submit_user_msg);
 }
 
+/*
+ * Validate and create one job of a REQUEST_SUBMIT_BATCH_JOB_LIST, filling in
+ * its response. Follows _slurm_rpc_submit_batch_job().
+ * Caller must hold the job and node write locks.
+ * RET SLURM_SUCCESS if the job was created
+ */
+static int _submit_batch_job_locked(slurm_msg_t *msg,
+				    job_desc_msg_t *job_desc_msg,
+				    submit_response_msg_t *resp)
+{
+	int error_code;
+	job_record_t *job_ptr = NULL;
+	char *err_msg = NULL;
+	bool reject_job = false;
+
+	if ((error_code = _valid_id("REQUEST_SUBMIT_BATCH_JOB_LIST",
+				    job_desc_msg, msg->auth_uid,
+				    msg->auth_gid, msg->protocol_version)))
+		goto reject;
+
+	_set_hostname(msg, &job_desc_msg->alloc_node);
+	_set_identity(msg, &job_desc_msg->id);
+
+	if ((job_desc_msg->alloc_node == NULL) ||
+	    (job_desc_msg->alloc_node[0] == '\0')) {
+		error("REQUEST_SUBMIT_BATCH_JOB_LIST lacks alloc_node from uid=%u",
+		      msg->auth_uid);
+		error_code = ESLURM_INVALID_NODE_NAME;
+		goto reject;
+	}
+
+	dump_job_desc(job_desc_msg);
+
+	job_desc_msg->het_job_offset = NO_VAL;
+	error_code = validate_job_create_req(job_desc_msg, msg->auth_uid,
+					     &err_msg);
+	/* err_msg is only set by job_submit_g_submit() here */
+	resp->job_submit_user_msg = err_msg;
+	err_msg = NULL;
+	if (error_code)
+		goto reject;
+
+	if (fed_mgr_fed_rec) {
+		if (fed_mgr_job_allocate(msg, job_desc_msg, false,
+					 &resp->job_id, &error_code, &err_msg))
+			reject_job = true;
+	} else {
+		error_code = job_allocate(job_desc_msg,
+					  job_desc_msg->immediate,
+					  false, NULL, 0, msg->auth_uid, false,
+					  &job_ptr, &err_msg,
+					  msg->protocol_version);
+		if (!job_ptr ||
+		    (error_code && job_ptr->job_state == JOB_FAILED))
+			reject_job = true;
+		else
+			resp->job_id = job_ptr->job_id;
+
+		if (job_desc_msg->immediate &&
+		    (error_code != SLURM_SUCCESS)) {
+			error_code = ESLURM_CAN_NOT_START_IMMEDIATELY;
+			reject_job = true;
+		}
+	}
+
+	if (!reject_job) {
+		resp->error_code = error_code;
+		xfree(err_msg);
+		return SLURM_SUCCESS;
+	}
+
+reject:
+	/* Keep the job submit plugin message ahead of any later error */
+	if (err_msg) {
+		if (resp->job_submit_user_msg)
+			xstrfmtcat(resp->job_submit_user_msg, "\n%s", err_msg);
+		else
+			resp->job_submit_user_msg = err_msg;
+		err_msg = NULL;
+	}
+	resp->job_id = 0;
+	resp->error_code = error_code ? error_code : SLURM_ERROR;
+
+	return resp->error_code;
+}
+
+/*
+ * _slurm_rpc_submit_batch_job_list - process RPC to submit several
+ *	independent batch jobs under one lock acquisition
+ */
+static void _slurm_rpc_submit_batch_job_list(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	DEF_TIMERS;
+	list_t *job_req_list = msg->data;
+	list_t *resp_list = NULL;
+	list_itr_t *iter;
+	job_desc_msg_t *job_desc_msg;
+	slurm_msg_t response_msg;
+	int job_cnt, submit_cnt = 0;
+	/* Locks: Read config, write job, write node, read partition, read
+	 * federation */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+
+	START_TIMER;
+	if (slurmctld_config.submissions_disabled) {
+		info("Submissions disabled on system");
+		slurm_send_rc_msg(msg, ESLURM_SUBMISSIONS_DISABLED);
+		return;
+	}
+
+	if (!job_req_list || !(job_cnt = list_count(job_req_list))) {
+		info("REQUEST_SUBMIT_BATCH_JOB_LIST from uid=%u with empty job list",
+		     msg->auth_uid);
+		slurm_send_rc_msg(msg, SLURM_ERROR);
+		return;
+	}
+
+	resp_list = list_create((ListDelF)
+				slurm_free_submit_response_response_msg);
+
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	iter = list_iterator_create(job_req_list);
+	while ((job_desc_msg = list_next(iter))) {
+		submit_response_msg_t *resp = xmalloc(sizeof(*resp));
+
+		resp->step_id = SLURM_BATCH_SCRIPT;
+		list_append(resp_list, resp);
+		if (!_submit_batch_job_locked(msg, job_desc_msg, resp))
+			submit_cnt++;
+	}
+	list_iterator_destroy(iter);
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+
+	END_TIMER2(__func__);
+	info("%s: submitted %d of %d jobs from uid=%u %s",
+	     __func__, submit_cnt, job_cnt, msg->auth_uid, TIME_STR);
+
+	response_init(&response_msg, msg, RESPONSE_SUBMIT_BATCH_JOB_LIST,
+		      resp_list);
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	FREE_NULL_LIST(resp_list);
+
+	if (submit_cnt) {
+		schedule_job_save();	/* Has own locks */
+		schedule_node_save();	/* Has own locks */
+		queue_job_scheduler();
+	}
+}
+
 /* _slurm_rpc_submit_batch_het_job - process RPC to submit a batch hetjob */
 static void _slurm_rpc_submit_batch_het_job(slurm_msg_t *msg)
 {
@@ -5704,9 +5956,129 @@ static void _clear_rpc_stats(void)
 	memset(rpc_user_cnt, 0, sizeof(rpc_user_cnt));
 	memset(rpc_user_id, 0, sizeof(rpc_user_id));
 	memset(rpc_user_time, 0, sizeof(rpc_user_time));
+	memset(rpc_type_cost, 0, sizeof(rpc_type_cost));
+	memset(rpc_user_cost, 0, sizeof(rpc_user_cost));
+	slurm_mutex_unlock(&rpc_mutex);
+}
+
+/* Pack the per type and per user RPC cost, appended after the RPC queues */
+static void _pack_rpc_cost_stats(buf_t *buffer, uint16_t protocol_version)
+{
+	uint64_t cpu[MAX(RPC_TYPE_SIZE, RPC_USER_SIZE)];
+	uint64_t lock_wait[MAX(RPC_TYPE_SIZE, RPC_USER_SIZE)];
+	uint64_t bytes[MAX(RPC_TYPE_SIZE, RPC_USER_SIZE)];
+	uint32_t i;
+
+	if (protocol_version < SLURM_24_08_PROTOCOL_VERSION)
+		return;
+
+	slurm_mutex_lock(&rpc_mutex);
+
+	for (i = 0; (i < RPC_TYPE_SIZE) && rpc_type_id[i]; i++) {
+		cpu[i] = rpc_type_cost[i].cpu_time;
+		lock_wait[i] = rpc_type_cost[i].lock_wait;
+		bytes[i] = rpc_type_cost[i].bytes_sent;
+	}
+	pack16_array(rpc_type_id, i, buffer);
+	pack64_array(cpu, i, buffer);
+	pack64_array(lock_wait, i, buffer);
+	pack64_array(bytes, i, buffer);
+
+	/* rpc_user_id[0] is root, later entries are assigned in order */
+	for (i = 0; (i < RPC_USER_SIZE) && (!i || rpc_user_id[i]); i++) {
+		cpu[i] = rpc_user_cost[i].cpu_time;
+		lock_wait[i] = rpc_user_cost[i].lock_wait;
+		bytes[i] = rpc_user_cost[i].bytes_sent;
+	}
+	pack32_array(rpc_user_id, i, buffer);
+	pack64_array(cpu, i, buffer);
+	pack64_array(lock_wait, i, buffer);
+	pack64_array(bytes, i, buffer);
+
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
+/* Pack the sched_adaptive main scheduler pacing, appended after RPC cost */
+static void _pack_sched_adapt_stats(buf_t *buffer, uint16_t protocol_version)
+{
+	if (protocol_version < SLURM_24_08_PROTOCOL_VERSION)
+		return;
+
+	pack32(slurmctld_diag_stats.schedule_adapt_interval, buffer);
+	pack32(slurmctld_diag_stats.schedule_adapt_depth, buffer);
+	pack32(slurmctld_diag_stats.schedule_adapt_pressure, buffer);
+}
+
+static void _rpc_metric(char **out, char **pos, const char *name,
+			const char *help, char **labels, uint64_t *values,
+			uint32_t cnt)
+{
+	openmetrics_family(out, pos, name, OPENMETRICS_COUNTER, help);
+	for (int i = 0; i < cnt; i++)
+		openmetrics_sample(out, pos, name, OPENMETRICS_COUNTER,
+				   labels[i], values[i]);
+}
+
+extern void rpc_stats_metrics(char **out, char **pos)
+{
+	char *type_labels[RPC_TYPE_SIZE], *user_labels[RPC_USER_SIZE];
+	uint64_t type_cnt[RPC_TYPE_SIZE], type_time[RPC_TYPE_SIZE];
+	uint64_t type_cpu[RPC_TYPE_SIZE], type_lock[RPC_TYPE_SIZE];
+	uint64_t type_bytes[RPC_TYPE_SIZE];
+	uint64_t user_cnt[RPC_USER_SIZE], user_time[RPC_USER_SIZE];
+	uint32_t type_size, user_size;
+
+	slurm_mutex_lock(&rpc_mutex);
+	for (type_size = 0; (type_size < RPC_TYPE_SIZE) &&
+			    rpc_type_id[type_size]; type_size++) {
+		type_labels[type_size] =
+			xstrdup_printf("type=\"%s\"",
+				       rpc_num2string(rpc_type_id[type_size]));
+		type_cnt[type_size] = rpc_type_cnt[type_size];
+		type_time[type_size] = rpc_type_time[type_size];
+		type_cpu[type_size] = rpc_type_cost[type_size].cpu_time;
+		type_lock[type_size] = rpc_type_cost[type_size].lock_wait;
+		type_bytes[type_size] = rpc_type_cost[type_size].bytes_sent;
+	}
+	/* rpc_user_id[0] is root, later entries are assigned in order */
+	for (user_size = 0; (user_size < RPC_USER_SIZE) &&
+			    (!user_size || rpc_user_id[user_size]);
+	     user_size++) {
+		user_labels[user_size] =
+			xstrdup_printf("uid=\"%u\"", rpc_user_id[user_size]);
+		user_cnt[user_size] = rpc_user_cnt[user_size];
+		user_time[user_size] = rpc_user_time[user_size];
+	}
+	slurm_mutex_unlock(&rpc_mutex);
+
+	_rpc_metric(out, pos, "slurmctld_rpc",
+		    "Number of RPCs processed by message type",
+		    type_labels, type_cnt, type_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_microseconds",
+		    "Time spent processing RPCs by message type",
+		    type_labels, type_time, type_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_cpu_microseconds",
+		    "CPU time spent processing RPCs by message type",
+		    type_labels, type_cpu, type_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_lock_wait_microseconds",
+		    "Time RPCs waited for slurmctld locks by message type",
+		    type_labels, type_lock, type_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_reply_bytes",
+		    "Bytes sent in replies to RPCs by message type",
+		    type_labels, type_bytes, type_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_user",
+		    "Number of RPCs processed by user",
+		    user_labels, user_cnt, user_size);
+	_rpc_metric(out, pos, "slurmctld_rpc_user_microseconds",
+		    "Time spent processing RPCs by user",
+		    user_labels, user_time, user_size);
+
+	for (int i = 0; i < type_size; i++)
+		xfree(type_labels[i]);
+	for (int i = 0; i < user_size; i++)
+		xfree(user_labels[i]);
+}
+
 static void _pack_rpc_stats(buf_t *buffer, uint16_t protocol_version)
 {
 	uint32_t i;
@@ -5777,12 +6149,18 @@ static void _slurm_rpc_dump_stats(slurm_msg_t *msg)
 	if (request_msg->command_id == STAT_COMMAND_RESET) {
 		reset_stats(1);
 		_clear_rpc_stats();
+		reset_lock_stats();
+		rpc_queue_reset_stats();
 		slurm_send_rc_msg(msg, SLURM_SUCCESS);
 		return;
 	}
 
 	buffer = pack_all_stat(msg->protocol_version);
 	_pack_rpc_stats(buffer, msg->protocol_version);
+	pack_lock_stats(buffer, msg->protocol_version);
+	rpc_queue_pack_stats(buffer, msg->protocol_version);
+	_pack_rpc_cost_stats(buffer, msg->protocol_version);
+	_pack_sched_adapt_stats(buffer, msg->protocol_version);
 
 	response_init(&response_msg, msg, RESPONSE_STATS_INFO, buffer);
 
@@ -5911,6 +6289,60 @@ static void _slurm_rpc_kill_job(slurm_msg_t *msg)
 	END_TIMER2(__func__);
 }
 
+static void _slurm_rpc_kill_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	DEF_TIMERS;
+	kill_jobs_msg_t *kill = msg->data;
+	kill_jobs_resp_msg_t *kill_resp = NULL;
+	slurm_msg_t response_msg;
+	slurmctld_lock_t lock = {READ_LOCK, WRITE_LOCK,
+				 WRITE_LOCK, NO_LOCK, READ_LOCK };
+	int rc;
+
+	/*
+	 * Federated jobs may need to be routed to their origin cluster one at
+	 * a time, leave those to the client.
+	 */
+	if (fed_mgr_fed_rec) {
+		slurm_send_rc_msg(msg, ESLURM_NOT_SUPPORTED);
+		return;
+	}
+
+	START_TIMER;
+	info("%s: REQUEST_KILL_JOBS uid %u", __func__, msg->auth_uid);
+
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(lock);
+	rc = job_mgr_signal_jobs(kill, msg->auth_uid, &kill_resp);
+	unlock_slurmctld(lock);
+	_throttle_fini(&active_rpc_cnt);
+	END_TIMER2(__func__);
+
+	if (rc != SLURM_SUCCESS) {
+		info("%s: job_mgr_signal_jobs() uid=%u sig=%d returned: %s",
+		     __func__, msg->auth_uid, kill->signal, slurm_strerror(rc));
+		slurm_send_rc_msg(msg, rc);
+		return;
+	}
+
+	for (int i = 0; i < kill_resp->jobs_cnt; i++) {
+		kill_jobs_resp_job_t *job_resp = &kill_resp->job_responses[i];
+
+		if (job_resp->error_code == SLURM_SUCCESS)
+			slurmctld_diag_stats.jobs_canceled++;
+		else if (job_resp->error_code != ESLURM_ALREADY_DONE)
+			info("%s: job_str_signal() uid=%u JobId=%s sig=%d returned: %s",
+			     __func__, msg->auth_uid, job_resp->job_id_str,
+			     kill->signal,
+			     slurm_strerror(job_resp->error_code));
+	}
+
+	response_init(&response_msg, msg, RESPONSE_KILL_JOBS, kill_resp);
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	slurm_free_kill_jobs_response_msg(kill_resp);
+}
+
 /* _slurm_rpc_assoc_mgr_info()
  *
  * Pack the assoc_mgr lists and return it back to the caller.
@@ -5965,6 +6397,7 @@ static int _process_persist_conn(void *arg, persist_msg_t *persist_msg,
 		if (msg.msg_type == ACCOUNTING_UPDATE_MSG) {
 			DEF_TIMERS;
 			START_TIMER;
+			record_rpc_start();
 			_slurm_rpc_accounting_update_msg(&msg);
 			END_TIMER;
 			record_rpc_stats(&msg, DELTA_TIMER);
@@ -6587,6 +7020,13 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 	},{
 		.msg_type = MESSAGE_EPILOG_COMPLETE,
 		.func = _slurm_rpc_epilog_complete,
+		.post_func = _slurm_post_rpc_epilog_complete,
+		.queue_enabled = true,
+		.locks = {
+			.conf = READ_LOCK,
+			.job = WRITE_LOCK,
+			.node = WRITE_LOCK,
+		},
 	},{
 		.msg_type = REQUEST_CANCEL_JOB_STEP,
 		.func = _slurm_rpc_job_step_kill,
@@ -6689,6 +7129,9 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 	},{
 		.msg_type = REQUEST_SUBMIT_BATCH_HET_JOB,
 		.func = _slurm_rpc_submit_batch_het_job,
+	},{
+		.msg_type = REQUEST_SUBMIT_BATCH_JOB_LIST,
+		.func = _slurm_rpc_submit_batch_job_list,
 	},{
 		.msg_type = REQUEST_UPDATE_FRONT_END,
 		.func = _slurm_rpc_update_front_end,
@@ -6824,6 +7267,9 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 	},{
 		.msg_type = REQUEST_KILL_JOB,
 		.func = _slurm_rpc_kill_job,
+	},{
+		.msg_type = REQUEST_KILL_JOBS,
+		.func = _slurm_rpc_kill_jobs,
 	},{
 		.msg_type = REQUEST_ASSOC_MGR_INFO,
 		.func = _slurm_rpc_assoc_mgr_info,
@@ -6880,6 +7326,7 @@ void slurmctld_req(slurm_msg_t *msg)
 	/* Debug the protocol layer.
 	 */
 	START_TIMER;
+	record_rpc_start();
 	if (slurm_conf.debug_flags & DEBUG_FLAG_PROTOCOL) {
 		char *p = rpc_num2string(msg->msg_type);
 		if (msg->conn) {
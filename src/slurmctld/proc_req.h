@@ -62,6 +62,10 @@ typedef struct {
 	pthread_mutex_t mutex;
 
 	List work;
+
+	/* Adaptive queue depth limit, see rpc_queue_max_wait */
+	uint32_t depth_limit;
+	uint64_t rejected;
 } slurmctld_rpc_t;
 
 extern slurmctld_rpc_t slurmctld_rpcs[];
@@ -72,11 +76,20 @@ extern slurmctld_rpc_t slurmctld_rpcs[];
  */
 void slurmctld_req(slurm_msg_t *msg);
 
+/*
+ * Snapshot the calling thread's CPU time, lock wait and bytes sent before
+ * processing an rpc, to be charged to it by record_rpc_stats().
+ */
+extern void record_rpc_start(void);
+
 /*
  * Update slurmctld stats structure with time spent processing an rpc.
  */
 extern void record_rpc_stats(slurm_msg_t *msg, long delta);
 
+/* Append the RPC statistics in OpenMetrics format */
+extern void rpc_stats_metrics(char **out, char **pos);
+
 /* Copy an array of type char **, xmalloc() the array and xstrdup() the
  * strings in the array */
 extern char **xduparray(uint32_t size, char ** array);
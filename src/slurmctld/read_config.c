@@ -94,6 +94,18 @@
 
 #define FEATURE_MAGIC	0x34dfd8b5
 
+/* Job count at which _sync_jobs_to_conf() rebuilds node bitmaps in parallel */
+#define SYNC_BITMAPS_MIN_JOBS	1024
+#define SYNC_BITMAPS_MAX_THREADS	16
+
+typedef struct {
+	job_record_t **jobs;
+	int job_cnt;
+	bool *job_fail;
+	int offset;
+	int stride;
+} sync_bitmaps_args_t;
+
 /* Global variables */
 List active_feature_list;	/* list of currently active features_records */
 List avail_feature_list;	/* list of available features_records */
@@ -209,7 +221,8 @@ static int _sort_nodes_by_rank(const void *a, const void *b)
 	else if (n1->node_rank > n2->node_rank)
 		return 1;
 
-	return 0;
+	/* Keep nodes of equal rank (e.g. same leaf switch) in name order */
+	return strnatcmp(n1->name, n2->name);
 }
 
 /*
@@ -1251,6 +1264,130 @@ static int _sync_detail_bitmaps(job_record_t *job_ptr)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Rebuild a job's node bitmaps from its node name strings.
+ * Only touches the job record itself, so it is safe to run for different jobs
+ * in parallel.
+ * RET true if the job must be failed due to invalid node names
+ */
+static bool _sync_job_bitmaps(job_record_t *job_ptr)
+{
+	bool job_fail = false;
+
+	/*
+	 * This resets the req/exc node bitmaps, so even if the job is
+	 * finished it still needs to happen just in case the job is
+	 * requeued.
+	 */
+	if (_sync_detail_bitmaps(job_ptr)) {
+		job_fail = true;
+		if (job_ptr->details) {
+			/*
+			 * job can't be requeued because either
+			 * req_nodes or exc_nodes can't be satisfied.
+			 */
+			job_ptr->details->requeue = false;
+		}
+	}
+
+	if (IS_JOB_COMPLETED(job_ptr))
+		return job_fail;
+
+	FREE_NULL_BITMAP(job_ptr->node_bitmap_cg);
+	if (job_ptr->nodes_completing &&
+	    node_name2bitmap(job_ptr->nodes_completing,
+			     false,  &job_ptr->node_bitmap_cg)) {
+		error("Invalid nodes (%s) for %pJ",
+		      job_ptr->nodes_completing, job_ptr);
+		job_fail = true;
+	}
+	FREE_NULL_BITMAP(job_ptr->node_bitmap);
+	if (job_ptr->nodes &&
+	    node_name2bitmap(job_ptr->nodes, false,
+			     &job_ptr->node_bitmap) && !job_fail) {
+		error("Invalid nodes (%s) for %pJ",
+		      job_ptr->nodes, job_ptr);
+		job_fail = true;
+	}
+	FREE_NULL_BITMAP(job_ptr->node_bitmap_pr);
+#ifndef HAVE_FRONT_END
+	if (job_ptr->nodes_pr &&
+	    node_name2bitmap(job_ptr->nodes_pr,
+			     false,  &job_ptr->node_bitmap_pr)) {
+		error("Invalid nodes (%s) for %pJ",
+		      job_ptr->nodes_pr, job_ptr);
+		job_fail = true;
+	}
+#endif
+
+	return job_fail;
+}
+
+static void *_sync_job_bitmaps_thread(void *arg)
+{
+	sync_bitmaps_args_t *args = arg;
+
+	for (int i = args->offset; i < args->job_cnt; i += args->stride)
+		args->job_fail[i] = _sync_job_bitmaps(args->jobs[i]);
+
+	return NULL;
+}
+
+/*
+ * Rebuild node bitmaps for all jobs using several threads.
+ * Converting node name strings to bitmaps dominates _sync_jobs_to_conf() with
+ * many jobs, and only reads the node table, so it can be done in parallel
+ * before the serial pass.
+ * RET xmalloc()'d array of _sync_job_bitmaps() results in job_list order, or
+ *     NULL if there are too few jobs or CPUs to bother
+ */
+static bool *_sync_all_job_bitmaps(void)
+{
+	sync_bitmaps_args_t *args;
+	pthread_t *tids;
+	job_record_t **jobs;
+	bool *job_fail;
+	list_itr_t *job_iterator;
+	job_record_t *job_ptr;
+	int job_cnt, thread_cnt, i = 0;
+
+	if ((job_cnt = list_count(job_list)) < SYNC_BITMAPS_MIN_JOBS)
+		return NULL;
+	thread_cnt = MIN(sysconf(_SC_NPROCESSORS_ONLN),
+			 SYNC_BITMAPS_MAX_THREADS);
+	if (thread_cnt < 2)
+		return NULL;
+
+	jobs = xcalloc(job_cnt, sizeof(*jobs));
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator)) && (i < job_cnt))
+		jobs[i++] = job_ptr;
+	list_iterator_destroy(job_iterator);
+	job_cnt = i;
+
+	job_fail = xcalloc(job_cnt, sizeof(*job_fail));
+	args = xcalloc(thread_cnt, sizeof(*args));
+	tids = xcalloc(thread_cnt, sizeof(*tids));
+	for (i = 0; i < thread_cnt; i++) {
+		args[i].jobs = jobs;
+		args[i].job_cnt = job_cnt;
+		args[i].job_fail = job_fail;
+		args[i].offset = i;
+		args[i].stride = thread_cnt;
+		slurm_thread_create(&tids[i], _sync_job_bitmaps_thread,
+				    &args[i]);
+	}
+	for (i = 0; i < thread_cnt; i++)
+		slurm_thread_join(tids[i]);
+	debug("%s: rebuilt node bitmaps of %d jobs with %d threads",
+	      __func__, job_cnt, thread_cnt);
+
+	xfree(tids);
+	xfree(args);
+	xfree(jobs);
+	return job_fail;
+}
+
 /*
  * _sync_jobs_to_conf - Sync current slurm.conf configuration for existing jobs.
  *	This should be called after rebuilding node, part, and gres information,
@@ -1264,35 +1401,26 @@ void _sync_jobs_to_conf(void)
 	job_record_t *job_ptr;
 	part_record_t *part_ptr;
 	List part_ptr_list = NULL;
-	bool job_fail = false;
+	bool job_fail = false, *bitmap_fail;
 	time_t now = time(NULL);
 	bool gang_flag = false;
+	int job_inx = 0;
 
 	xassert(job_list);
 
 	if (slurm_conf.preempt_mode & PREEMPT_MODE_GANG)
 		gang_flag = true;
 
+	bitmap_fail = _sync_all_job_bitmaps();
+
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
 		xassert (job_ptr->magic == JOB_MAGIC);
-		job_fail = false;
 
-		/*
-		 * This resets the req/exc node bitmaps, so even if the job is
-		 * finished it still needs to happen just in case the job is
-		 * requeued.
-		 */
-		if (_sync_detail_bitmaps(job_ptr)) {
-			job_fail = true;
-			if (job_ptr->details) {
-				/*
-				 * job can't be requeued because either
-				 * req_nodes or exc_nodes can't be satisfied.
-				 */
-				job_ptr->details->requeue = false;
-			}
-		}
+		if (bitmap_fail)
+			job_fail = bitmap_fail[job_inx++];
+		else
+			job_fail = _sync_job_bitmaps(job_ptr);
 
 		/*
 		 * While the job is completed at this point there is code in
@@ -1340,32 +1468,6 @@ void _sync_jobs_to_conf(void)
 		if (IS_JOB_COMPLETED(job_ptr))
 			continue;
 
-		FREE_NULL_BITMAP(job_ptr->node_bitmap_cg);
-		if (job_ptr->nodes_completing &&
-		    node_name2bitmap(job_ptr->nodes_completing,
-				     false,  &job_ptr->node_bitmap_cg)) {
-			error("Invalid nodes (%s) for %pJ",
-			      job_ptr->nodes_completing, job_ptr);
-			job_fail = true;
-		}
-		FREE_NULL_BITMAP(job_ptr->node_bitmap);
-		if (job_ptr->nodes &&
-		    node_name2bitmap(job_ptr->nodes, false,
-				     &job_ptr->node_bitmap) && !job_fail) {
-			error("Invalid nodes (%s) for %pJ",
-			      job_ptr->nodes, job_ptr);
-			job_fail = true;
-		}
-		FREE_NULL_BITMAP(job_ptr->node_bitmap_pr);
-#ifndef HAVE_FRONT_END
-		if (job_ptr->nodes_pr &&
-		    node_name2bitmap(job_ptr->nodes_pr,
-				     false,  &job_ptr->node_bitmap_pr)) {
-			error("Invalid nodes (%s) for %pJ",
-			      job_ptr->nodes_pr, job_ptr);
-			job_fail = true;
-		}
-#endif
 		if (reset_node_bitmap(job_ptr))
 			job_fail = true;
 		if (!job_fail &&
@@ -1465,6 +1567,7 @@ void _sync_jobs_to_conf(void)
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	xfree(bitmap_fail);
 
 	last_job_update = now;
 }
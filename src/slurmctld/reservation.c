@@ -39,6 +39,7 @@
 
 #include "config.h"
 
+#include <ctype.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <signal.h>
@@ -125,6 +126,34 @@ List      resv_list = (List) NULL;
 static List magnetic_resv_list = NULL;
 uint32_t  top_suffix = 0;
 
+/*
+ * Time summary of resv_list used by job_test_resv() to skip the list walk
+ * for jobs ending before every reservation starts, see _resv_times_after()
+ */
+typedef struct {
+	int cnt;		/* list_count(resv_list) when built */
+	bool has_float;		/* a RESERVE_FLAG_TIME_FLOAT resv exists */
+	uint32_t max_boot;	/* largest boot_time */
+	time_t min_end;		/* earliest end_time */
+	time_t min_start;	/* earliest start_time_first */
+	time_t update;		/* last_resv_update when built */
+} resv_times_t;
+static resv_times_t resv_times = { .cnt = -1 };
+
+/*
+ * Earliest time at which job_resv_check() has time based work to do (a
+ * reservation starting, ending or reaching its PURGE_COMP idle limit) and
+ * the record update times it was computed from. Passes before that time
+ * with no job, node or reservation change have nothing to do.
+ */
+typedef struct {
+	time_t job_update;	/* last_job_update of last pass */
+	time_t next_event;	/* next time based reservation event */
+	time_t node_update;	/* last_node_update of last pass */
+	time_t resv_update;	/* last_resv_update of last pass */
+} resv_check_time_t;
+static resv_check_time_t resv_check_time = { 0 };
+
 /*
  * the two following structs enable to build a
  * planning of a constraint evolution over time
@@ -2721,9 +2750,8 @@ static int _delete_resv_internal(slurmctld_resv_t *resv_ptr)
 static bitstr_t *_get_update_node_bitmap(slurmctld_resv_t *resv_ptr,
 					 char *node_list)
 {
-	char *last = NULL, *tmp, *tok, *node_name;
-	node_record_t *node_ptr;
-	bitstr_t *node_bitmap = NULL;
+	char *last = NULL, *tmp, *tok;
+	bitstr_t *node_bitmap = NULL, *tok_bitmap = NULL;
 	hostlist_t *hl = NULL;
 
 	tmp = xstrdup(node_list);
@@ -2753,26 +2781,23 @@ static bitstr_t *_get_update_node_bitmap(slurmctld_resv_t *resv_ptr,
 
 		/* Create hostlist to handle ranges i.e. tux[0-10] */
 		hl = hostlist_create(tok);
-		while ((node_name = hostlist_shift(hl))) {
-			node_ptr = find_node_record(node_name);
-			if (!node_ptr) {
-				info("Reservation %s request has bad node name given (%s)",
-				     resv_ptr->name, node_name);
-				free(node_name);
-				FREE_NULL_BITMAP(node_bitmap);
-				break;
-			}
-			free(node_name);
-
+		if (hostlist_count(hl) <= 0) {
+			/* nothing to add or remove */
+		} else if (hostlist2bitmap(hl, false, &tok_bitmap)) {
+			info("Reservation %s request has bad node name given (%s)",
+			     resv_ptr->name, tok);
+			FREE_NULL_BITMAP(node_bitmap);
+		} else {
 			if (!node_bitmap)
 				node_bitmap = bit_copy(resv_ptr->node_bitmap);
 
 			if (plus)
-				bit_set(node_bitmap, node_ptr->index);
+				bit_or(node_bitmap, tok_bitmap);
 			else if (minus)
-				bit_clear(node_bitmap, node_ptr->index);
+				bit_and_not(node_bitmap, tok_bitmap);
 		}
-		hostlist_destroy(hl);
+		FREE_NULL_BITMAP(tok_bitmap);
+		FREE_NULL_HOSTLIST(hl);
 
 		if (!node_bitmap)
 			break;
@@ -4719,6 +4744,23 @@ static void _validate_node_choice(slurmctld_resv_t *resv_ptr)
 	_free_resv_select_members(&resv_select);
 }
 
+/*
+ * Return true if assoc_list contains any explicitly allowed association
+ * (",<id>," rather than ",-<id>,"), in a single pass over the string.
+ */
+static bool _assoc_list_has_allowed(char *assoc_list)
+{
+	char *tmp = assoc_list;
+
+	while ((tmp = xstrchr(tmp, ','))) {
+		tmp++;
+		if (isdigit((int) *tmp))
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * Validate if the user has access to this reservation.
  */
@@ -4741,16 +4783,7 @@ static bool _validate_user_access(slurmctld_resv_t *resv_ptr,
 				return 0;
 		}
 
-		if (xstrstr(resv_ptr->assoc_list, ",1") ||
-		    xstrstr(resv_ptr->assoc_list, ",2") ||
-		    xstrstr(resv_ptr->assoc_list, ",3") ||
-		    xstrstr(resv_ptr->assoc_list, ",4") ||
-		    xstrstr(resv_ptr->assoc_list, ",5") ||
-		    xstrstr(resv_ptr->assoc_list, ",6") ||
-		    xstrstr(resv_ptr->assoc_list, ",7") ||
-		    xstrstr(resv_ptr->assoc_list, ",8") ||
-		    xstrstr(resv_ptr->assoc_list, ",9") ||
-		    xstrstr(resv_ptr->assoc_list, ",0")) {
+		if (_assoc_list_has_allowed(resv_ptr->assoc_list)) {
 			if (!_match_user_assoc(resv_ptr->assoc_list,
 					       user_assoc_list,
 					       false))
@@ -6090,10 +6123,11 @@ static bitstr_t *_pick_node_cnt(resv_desc_msg_t *resv_desc_ptr,
 				continue;
 			if (job_ptr->end_time < resv_desc_ptr->start_time)
 				continue;
-			tmp_bitmap = bit_copy(orig_bitmap);
-			bit_and(tmp_bitmap, job_ptr->node_bitmap);
-			if (bit_set_count(tmp_bitmap) > 0)
+			if (bit_overlap_any(orig_bitmap, job_ptr->node_bitmap)) {
+				tmp_bitmap = bit_copy(orig_bitmap);
+				bit_and(tmp_bitmap, job_ptr->node_bitmap);
 				bit_or(resv_select->node_bitmap, tmp_bitmap);
+			}
 			total_node_cnt = bit_set_count(
 				resv_select->node_bitmap);
 			if (total_node_cnt >= node_cnt) {
@@ -6207,16 +6241,7 @@ static int _valid_job_access_resv(job_record_t *job_ptr,
 				assoc = assoc->usage->parent_assoc_ptr;
 			}
 		}
-		if (xstrstr(resv_ptr->assoc_list, ",1") ||
-		    xstrstr(resv_ptr->assoc_list, ",2") ||
-		    xstrstr(resv_ptr->assoc_list, ",3") ||
-		    xstrstr(resv_ptr->assoc_list, ",4") ||
-		    xstrstr(resv_ptr->assoc_list, ",5") ||
-		    xstrstr(resv_ptr->assoc_list, ",6") ||
-		    xstrstr(resv_ptr->assoc_list, ",7") ||
-		    xstrstr(resv_ptr->assoc_list, ",8") ||
-		    xstrstr(resv_ptr->assoc_list, ",9") ||
-		    xstrstr(resv_ptr->assoc_list, ",0")) {
+		if (_assoc_list_has_allowed(resv_ptr->assoc_list)) {
 			assoc = job_ptr->assoc_ptr;
 			while (assoc) {
 				snprintf(tmp_char, sizeof(tmp_char), ",%u,",
@@ -6829,6 +6854,55 @@ static void _get_rel_start_end(slurmctld_resv_t *resv_ptr, time_t now,
 	}
 }
 
+/*
+ * Return true if a job ending at job_end_time ends before every reservation
+ * in resv_list starts, in which case none of them can affect it.
+ *
+ * The summary is rebuilt when last_resv_update changes. Since that only has
+ * one second granularity, it is not trusted (and false returned) while
+ * last_resv_update is the current second. Floating reservations and
+ * reservations that need advancing disable the shortcut.
+ */
+static bool _resv_times_after(time_t job_end_time, bool reboot, time_t now)
+{
+	slurmctld_resv_t *resv_ptr;
+	list_itr_t *iter;
+
+	if (last_resv_update >= now)
+		return false;
+
+	if ((resv_times.update != last_resv_update) ||
+	    (resv_times.cnt != list_count(resv_list))) {
+		resv_times = (resv_times_t) {
+			.cnt = list_count(resv_list),
+			.min_end = INFINITE,
+			.min_start = INFINITE,
+			.update = last_resv_update,
+		};
+		iter = list_iterator_create(resv_list);
+		while ((resv_ptr = list_next(iter))) {
+			if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
+				resv_times.has_float = true;
+				break;
+			}
+			resv_times.max_boot = MAX(resv_times.max_boot,
+						  resv_ptr->boot_time);
+			resv_times.min_end = MIN(resv_times.min_end,
+						 resv_ptr->end_time);
+			resv_times.min_start = MIN(resv_times.min_start,
+						   resv_ptr->start_time_first);
+		}
+		list_iterator_destroy(iter);
+	}
+
+	if (resv_times.has_float || (resv_times.min_end <= now))
+		return false;
+	if (reboot)
+		job_end_time += resv_times.max_boot;
+
+	return (job_end_time <= resv_times.min_start);
+}
+
 /*
  * Determine how many watts the specified job is prevented from using
  * due to reservations
@@ -7060,10 +7134,12 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	 * run and get it's required nodes (if any)
 	 */
 	for (i = 0; ; i++) {
+		bool skip_resv = _resv_times_after(job_end_time, reboot, now);
+
 		lic_resv_time = (time_t) 0;
 
 		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = list_next(iter))) {
+		while (!skip_resv && (resv_ptr = list_next(iter))) {
 			_get_rel_start_end(
 				resv_ptr, now, &start_relative, &end_relative);
 
@@ -7481,6 +7557,28 @@ static int _resv_list_reset_cnt(void *x, void *arg)
 	return 0;
 }
 
+/* Update next_event with the next time based event of a reservation */
+static void _resv_next_event(slurmctld_resv_t *resv_ptr, time_t now,
+			     time_t *next_event)
+{
+	time_t event = *next_event;
+
+	if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT)
+		event = now;
+	else if (resv_ptr->start_time > now)
+		event = MIN(event, resv_ptr->start_time);
+	if (resv_ptr->end_time >= now)
+		event = MIN(event, resv_ptr->end_time + 1);
+	else
+		event = now;	/* waiting on prolog/epilog completion */
+	if ((resv_ptr->flags & RESERVE_FLAG_PURGE_COMP) &&
+	    resv_ptr->idle_start_time)
+		event = MIN(event, resv_ptr->idle_start_time +
+				   resv_ptr->purge_comp_time);
+
+	*next_event = event;
+}
+
 /* Finish scan of all jobs for valid reservations
  *
  * Purge vestigial reservation records.
@@ -7492,10 +7590,17 @@ extern void job_resv_check(void)
 	list_itr_t *iter;
 	slurmctld_resv_t *resv_ptr;
 	time_t now = time(NULL);
+	time_t next_event = INFINITE;
 
 	if (!resv_list)
 		return;
 
+	if ((now < resv_check_time.next_event) &&
+	    (last_job_update == resv_check_time.job_update) &&
+	    (last_node_update == resv_check_time.node_update) &&
+	    (last_resv_update == resv_check_time.resv_update))
+		return;
+
 	list_for_each(resv_list, _resv_list_reset_cnt, NULL);
 	list_for_each(job_list, _job_resv_check, NULL);
 
@@ -7564,12 +7669,16 @@ extern void job_resv_check(void)
 		    (resv_ptr->duration && (resv_ptr->duration != NO_VAL) &&
 		     (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT))) {
 			_validate_node_choice(resv_ptr);
+			_resv_next_event(resv_ptr, now, &next_event);
 			continue;
 		}
 		if (!(resv_ptr->ctld_flags & RESV_CTLD_PROLOG) ||
-		    !(resv_ptr->ctld_flags & RESV_CTLD_EPILOG))
+		    !(resv_ptr->ctld_flags & RESV_CTLD_EPILOG)) {
+			next_event = now;
 			continue;
+		}
 		(void)_advance_resv_time(resv_ptr);
+		_resv_next_event(resv_ptr, now, &next_event);
 		if ((!resv_ptr->job_run_cnt ||
 		     (resv_ptr->flags & RESERVE_FLAG_FLEX)) &&
 		    !(resv_ptr->flags & RESERVE_REOCCURRING)) {
@@ -7588,6 +7697,11 @@ extern void job_resv_check(void)
 		}
 	}
 	list_iterator_destroy(iter);
+
+	resv_check_time.job_update = last_job_update;
+	resv_check_time.next_event = next_event;
+	resv_check_time.node_update = last_node_update;
+	resv_check_time.resv_update = last_resv_update;
 }
 
 /*
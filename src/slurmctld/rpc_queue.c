@@ -44,6 +44,7 @@
 
 #include "src/common/list.h"
 #include "src/common/macros.h"
+#include "src/common/pack.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/xmalloc.h"
@@ -52,15 +53,45 @@
 #include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/proc_req.h"
+#include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/state_save.h"
 
+#define RPC_QUEUE_DEPTH_MAX 1024
+#define RPC_QUEUE_DEPTH_MIN 16
+
 bool enabled = true;
 
+/*
+ * SlurmctldParameters=rpc_queue_max_wait=<msec>. When set, the number of
+ * messages a queue accepts from regular users shrinks by half each time its
+ * worker waits longer than this for the slurmctld locks, and grows by one
+ * after each shorter wait (AIMD). Zero disables the limit.
+ */
+static uint32_t max_wait_usec = 0;
+
+/* Adjust q->depth_limit for the time just spent waiting on q->locks */
+static void _adjust_depth_limit(slurmctld_rpc_t *q, long wait_usec)
+{
+	if (!max_wait_usec)
+		return;
+
+	slurm_mutex_lock(&q->mutex);
+	if (wait_usec > max_wait_usec) {
+		q->depth_limit = MAX((q->depth_limit / 2), RPC_QUEUE_DEPTH_MIN);
+		log_flag(PROTOCOL, "%s(%s): lock wait %ldus, depth limit reduced to %u",
+			 __func__, q->msg_name, wait_usec, q->depth_limit);
+	} else if (q->depth_limit < RPC_QUEUE_DEPTH_MAX) {
+		q->depth_limit++;
+	}
+	slurm_mutex_unlock(&q->mutex);
+}
+
 static void *_rpc_queue_worker(void *arg)
 {
 	slurmctld_rpc_t *q = (slurmctld_rpc_t *) arg;
 	slurm_msg_t *msg;
 	int processed = 0;
+	DEF_TIMERS;
 
 #if HAVE_SYS_PRCTL_H
 	char *name = xstrdup_printf("rpcq-%u", q->msg_type);
@@ -127,10 +158,14 @@ static void *_rpc_queue_worker(void *arg)
 			slurm_mutex_unlock(&q->mutex);
 			log_flag(PROTOCOL, "%s(%s): woke up",
 				 __func__, q->msg_name);
+
+			START_TIMER;
 			lock_slurmctld(q->locks);
+			END_TIMER;
+			_adjust_depth_limit(q, DELTA_TIMER);
 		} else {
-			DEF_TIMERS;
 			START_TIMER;
+			record_rpc_start();
 
 			msg->flags |= CTLD_QUEUE_PROCESSING;
 			q->func(msg);
@@ -149,6 +184,8 @@ static void *_rpc_queue_worker(void *arg)
 
 extern void rpc_queue_init(void)
 {
+	char *tmp_ptr;
+
 	if (!xstrcasestr(slurm_conf.slurmctld_params, "enable_rpc_queue")) {
 		enabled = false;
 		return;
@@ -156,6 +193,10 @@ extern void rpc_queue_init(void)
 
 	error("enabled experimental rpc queuing system");
 
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "rpc_queue_max_wait=")))
+		max_wait_usec = atoi(tmp_ptr + 19) * 1000;
+
 	for (slurmctld_rpc_t *q = slurmctld_rpcs; q->msg_type; q++) {
 		if (!q->queue_enabled)
 			continue;
@@ -165,6 +206,8 @@ extern void rpc_queue_init(void)
 		slurm_cond_init(&q->cond, NULL);
 		slurm_mutex_init(&q->mutex);
 		q->shutdown = false;
+		q->depth_limit = RPC_QUEUE_DEPTH_MAX;
+		q->rejected = 0;
 
 		log_flag(PROTOCOL, "%s: starting queue for %s",
 			 __func__, q->msg_name);
@@ -210,8 +253,27 @@ extern bool rpc_enqueue(slurm_msg_t *msg)
 			if (!q->queue_enabled)
 				break;
 
-			list_enqueue(q->work, msg);
 			slurm_mutex_lock(&q->mutex);
+			/*
+			 * Shed load from regular users while the queue is
+			 * backed up. SlurmUser/root traffic (node
+			 * registrations, job completions) is always queued.
+			 */
+			if (max_wait_usec &&
+			    (list_count(q->work) >= q->depth_limit) &&
+			    !validate_slurm_user(msg->auth_uid)) {
+				q->rejected++;
+				slurm_mutex_unlock(&q->mutex);
+
+				slurm_send_rc_msg(msg,
+					SLURMCTLD_COMMUNICATIONS_BACKOFF);
+				if ((msg->conn_fd >= 0) &&
+				    (close(msg->conn_fd) < 0))
+					error("close(%d): %m", msg->conn_fd);
+				slurm_free_msg(msg);
+				return true;
+			}
+			list_enqueue(q->work, msg);
 			slurm_cond_signal(&q->cond);
 			slurm_mutex_unlock(&q->mutex);
 			return true;
@@ -221,3 +283,63 @@ extern bool rpc_enqueue(slurm_msg_t *msg)
 	/* RPC does not have a dedicated queue */
 	return false;
 }
+
+extern void rpc_queue_pack_stats(buf_t *buffer, uint16_t protocol_version)
+{
+	uint32_t count = 0, i = 0;
+	uint16_t *types;
+	uint32_t *limits, *depths;
+	uint64_t *rejected;
+
+	if (protocol_version < SLURM_24_08_PROTOCOL_VERSION)
+		return;
+
+	if (enabled) {
+		for (slurmctld_rpc_t *q = slurmctld_rpcs; q->msg_type; q++)
+			if (q->queue_enabled)
+				count++;
+	}
+
+	types = xcalloc(count, sizeof(*types));
+	limits = xcalloc(count, sizeof(*limits));
+	depths = xcalloc(count, sizeof(*depths));
+	rejected = xcalloc(count, sizeof(*rejected));
+
+	for (slurmctld_rpc_t *q = slurmctld_rpcs; count && q->msg_type; q++) {
+		if (!q->queue_enabled)
+			continue;
+
+		slurm_mutex_lock(&q->mutex);
+		types[i] = q->msg_type;
+		limits[i] = max_wait_usec ? q->depth_limit : NO_VAL;
+		depths[i] = list_count(q->work);
+		rejected[i] = q->rejected;
+		slurm_mutex_unlock(&q->mutex);
+		i++;
+	}
+
+	pack16_array(types, count, buffer);
+	pack32_array(limits, count, buffer);
+	pack32_array(depths, count, buffer);
+	pack64_array(rejected, count, buffer);
+
+	xfree(types);
+	xfree(limits);
+	xfree(depths);
+	xfree(rejected);
+}
+
+extern void rpc_queue_reset_stats(void)
+{
+	if (!enabled)
+		return;
+
+	for (slurmctld_rpc_t *q = slurmctld_rpcs; q->msg_type; q++) {
+		if (!q->queue_enabled)
+			continue;
+
+		slurm_mutex_lock(&q->mutex);
+		q->rejected = 0;
+		slurm_mutex_unlock(&q->mutex);
+	}
+}
@@ -43,4 +43,10 @@ extern void rpc_queue_shutdown(void);
 
 extern bool rpc_enqueue(slurm_msg_t *msg);
 
+/* Pack per queue depth limit and rejection counts for REQUEST_STATS_INFO */
+extern void rpc_queue_pack_stats(buf_t *buffer, uint16_t protocol_version);
+
+/* Clear per queue rejection counts */
+extern void rpc_queue_reset_stats(void);
+
 #endif
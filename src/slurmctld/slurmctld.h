@@ -66,6 +66,7 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/timers.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 
 #include "src/interfaces/cred.h"
@@ -121,6 +122,11 @@
 #define PERIODIC_NODE_ACCT 300
 #endif
 
+/* Release free heap memory back to the OS every PERIODIC_MALLOC_TRIM seconds */
+#ifndef PERIODIC_MALLOC_TRIM
+#define PERIODIC_MALLOC_TRIM 600
+#endif
+
 /* Seconds to wait for backup controller response to REQUEST_CONTROL RPC */
 #ifndef CONTROL_TIMEOUT
 #define CONTROL_TIMEOUT 30	/* seconds */
@@ -187,6 +193,9 @@ typedef struct diag_stats {
 	uint32_t schedule_cycle_depth;
 	uint32_t schedule_exit[SCHEDULE_EXIT_COUNT];
 	uint32_t schedule_queue_len;
+	uint32_t schedule_adapt_interval;	/* usec, with sched_adaptive */
+	uint32_t schedule_adapt_depth;
+	uint32_t schedule_adapt_pressure;	/* percent */
 
 	uint32_t jobs_submitted;
 	uint32_t jobs_started;
@@ -572,6 +581,9 @@ typedef struct {
 					 * node for arbitrary distribution */
 	uint32_t argc;			/* count of argv elements */
 	char **argv;			/* arguments for a batch job script */
+	uint32_t *args_ref_cnt;		/* references to argv and env_sup
+					 * when shared by job array tasks,
+					 * NULL if owned by this record */
 	time_t begin_time;		/* start at this time (srun --begin),
 					 * resets to time first eligible
 					 * (all dependencies satisfied) */
@@ -594,6 +606,9 @@ typedef struct {
 					 * scrontab) */
 	uint16_t orig_cpus_per_task;	/* requested value of cpus_per_task */
 	List depend_list;		/* list of job_ptr:state pairs */
+	uint64_t depend_epoch;		/* job_state_epoch when depend_list
+					 * was last found still waiting on
+					 * local jobs, 0 if not cached */
 	char *dependency;		/* wait for other jobs */
 	char *orig_dependency;		/* original value (for archiving) */
 	uint16_t env_cnt;		/* size of env_sup (see below) */
@@ -818,6 +833,10 @@ struct job_record {
 	job_record_t *job_next;		/* next entry with same hash index */
 	job_record_t *job_array_next_j;	/* job array linked list by job_id */
 	job_record_t *job_array_next_t;	/* job array linked list by task_id */
+	job_record_t *job_name_next;	/* next entry with same user/name hash
+					 * index */
+	uint32_t job_name_inx;		/* user/name hash index, NO_VAL if not
+					 * in the user/name hash table */
 	job_record_t *job_preempt_comp; /* het job preempt component */
 	job_resources_t *job_resrcs;	/* details of allocated cores */
 	uint32_t job_state;		/* state of the job */
@@ -927,6 +946,8 @@ struct job_record {
 					 * priority or resources, only stored in
 					 * the database. */
 	List step_list;			/* list of job's steps */
+	xhash_t *step_hash;		/* index of step_list by step ID,
+					 * see find_step_record() */
 	time_t suspend_time;		/* time job last suspended or resumed */
 	char *system_comment;		/* slurmctld's arbitrary comment */
 	time_t time_last_active;	/* time of last job activity */
@@ -1286,6 +1307,12 @@ extern List depended_list_copy(List depend_list_src);
  */
 extern int drain_nodes ( char *nodes, char *reason, uint32_t reason_uid );
 
+/*
+ * Bumped whenever any job changes state, or a job record is created, freed or
+ * renamed. Lets callers tell that no job they might depend on has changed.
+ */
+extern uint64_t job_state_epoch;
+
 /*
  * Set job state
  * IN job_ptr - Job to update
@@ -1307,6 +1334,20 @@ extern void job_state_set_flag(job_record_t *job_ptr, uint32_t flag);
  */
 extern void job_state_unset_flag(job_record_t *job_ptr, uint32_t flag);
 
+/*
+ * Set the reason a job is not running and its optional description.
+ * Nothing is done when the job already has this reason and description, so
+ * that scheduling passes repeating the same verdict neither reallocate the
+ * description nor bump last_job_update, which would make every client
+ * polling job info receive a full response.
+ * IN job_ptr - Job to update
+ * IN reason - reason from enum job_state_reason
+ * IN desc - description, copied, or NULL
+ * RET true if the reason or description changed
+ */
+extern bool job_state_set_reason(job_record_t *job_ptr, uint32_t reason,
+				 const char *desc);
+
 /* dump_all_job_state - save the state of all jobs to file
  * RET 0 or error code */
 extern int dump_all_job_state ( void );
@@ -1388,6 +1429,27 @@ extern job_record_t *find_het_job_record(uint32_t job_id, uint32_t het_job_id);
  */
 extern job_record_t *find_job_record(uint32_t job_id);
 
+/*
+ * find_user_job_by_name - find a job of the given user with the given name
+ *	(or without a name) for which f returns non-zero, using the user/name
+ *	hash table rather than scanning job_list
+ * IN user_id - owner of the jobs to test
+ * IN name - job name, if NULL all of the user's jobs are tested
+ * IN f - test function, as used with list_find_first()
+ * IN key - passed to f
+ * RET pointer to the first matching job record, NULL if none
+ */
+extern job_record_t *find_user_job_by_name(uid_t user_id, char *name,
+					   ListFindF f, void *key);
+
+/*
+ * job_id_exists - test if a job record or job array with the given job_id
+ *	exists without requiring the JOB lock
+ * IN job_id - requested job's id
+ * RET false only if no such record existed at the time of the call
+ */
+extern bool job_id_exists(uint32_t job_id);
+
 /*
  * find_first_node_record - find a record for first node in the bitmap
  * IN node_bitmap
@@ -1735,6 +1797,18 @@ extern int het_job_signal(job_record_t *het_job_leader, uint16_t signal,
 extern int job_str_signal(char *job_id_str, uint16_t signal, uint16_t flags,
 			  uid_t uid, bool preempt);
 
+/*
+ * job_mgr_signal_jobs - signal every job matching the filters of a
+ *	REQUEST_KILL_JOBS message
+ * IN kill_msg - filters, signal and KILL_JOB_* flags to apply
+ * IN auth_uid - uid of requesting user
+ * OUT resp_pptr - per job result, caller must free with
+ *	slurm_free_kill_jobs_response_msg()
+ * RET 0 on success, otherwise ESLURM error code
+ */
+extern int job_mgr_signal_jobs(kill_jobs_msg_t *kill_msg, uid_t auth_uid,
+			       kill_jobs_resp_msg_t **resp_pptr);
+
 /*
  * job_suspend/job_suspend2 - perform some suspend/resume operation
  * NB job_suspend  - Uses the job_id field and ignores job_id_str
@@ -2116,6 +2190,9 @@ extern buf_t *pack_all_nodes(uint16_t show_flags, uid_t uid,
 /* Pack all scheduling statistics */
 extern buf_t *pack_all_stat(uint16_t protocol_version);
 
+/* Dump all scheduling statistics in OpenMetrics format, see openmetrics.h */
+extern void dump_all_metrics(char **out, char **pos);
+
 /*
  * pack_ctld_job_step_info_response_msg - packs job step info
  * IN step_id - specific id or NO_VAL/NO_VAL for all
@@ -2794,6 +2871,13 @@ extern int validate_nodes_via_front_end(
 		slurm_node_registration_status_msg_t *reg_msg,
 		uint16_t protocol_version, bool *newly_up);
 
+/*
+ * wake_all_pending_steps - signal every srun waiting on a pending step of
+ *	this job to retry now, e.g. once the job's prolog has completed
+ * IN job_ptr - pointer to job record
+ */
+extern void wake_all_pending_steps(job_record_t *job_ptr);
+
 /*
  * validate_slurm_user - validate that the uid is authorized to see
  *      privileged data (either user root or SlurmUser)
@@ -139,6 +139,11 @@ static pthread_mutex_t powersave_script_count_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t powersave_script_cond = PTHREAD_COND_INITIALIZER;
 static int powersave_script_count = 0;
 static bool powersave_wait_called = false;
+/* Per script type limit of concurrently running scripts, 0 is unlimited */
+static int script_type_limit = 0;
+static int script_type_running[SLURMSCRIPTD_RESV + 1];
+static pthread_mutex_t script_type_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t script_type_cond = PTHREAD_COND_INITIALIZER;
 
 
 /* Function definitions: */
@@ -701,6 +706,41 @@ static int _run_bb_script(run_script_msg_t *script_msg,
 	return status;
 }
 
+/*
+ * Wait until fewer than script_type_limit scripts of this type are running.
+ * Each type is limited on its own so that a backlog of one type (e.g. slow
+ * burst buffer stage-in) does not hold back scripts of the other types.
+ * Power save scripts are never limited since they are already throttled by
+ * ResumeRate/SuspendRate and must run even while slurmctld shuts down.
+ */
+static void _script_type_slot_get(script_type_t type)
+{
+	if (!script_type_limit || (type == SLURMSCRIPTD_POWER) ||
+	    (type > SLURMSCRIPTD_RESV))
+		return;
+
+	slurm_mutex_lock(&script_type_mutex);
+	if (script_type_running[type] >= script_type_limit)
+		log_flag(SCRIPT, "%s: %d scripts of type %d running, waiting",
+			 __func__, script_type_running[type], type);
+	while (script_type_running[type] >= script_type_limit)
+		slurm_cond_wait(&script_type_cond, &script_type_mutex);
+	script_type_running[type]++;
+	slurm_mutex_unlock(&script_type_mutex);
+}
+
+static void _script_type_slot_put(script_type_t type)
+{
+	if (!script_type_limit || (type == SLURMSCRIPTD_POWER) ||
+	    (type > SLURMSCRIPTD_RESV))
+		return;
+
+	slurm_mutex_lock(&script_type_mutex);
+	script_type_running[type]--;
+	slurm_cond_broadcast(&script_type_cond);
+	slurm_mutex_unlock(&script_type_mutex);
+}
+
 static int _handle_shutdown(slurmscriptd_msg_t *recv_msg)
 {
 	log_flag(SCRIPT, "Handling %s", rpc_num2string(recv_msg->msg_type));
@@ -740,6 +780,8 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 		 script_msg->argc,
 		 recv_msg->key);
 
+	_script_type_slot_get(script_msg->script_type);
+
 	switch (script_msg->script_type) {
 	case SLURMSCRIPTD_BB_LUA:
 		status = _run_bb_script(script_msg,
@@ -789,6 +831,8 @@ static int _handle_run_script(slurmscriptd_msg_t *recv_msg)
 		break;
 	}
 
+	_script_type_slot_put(script_msg->script_type);
+
 	/* Send response */
 	rc = _respond_to_slurmctld(recv_msg->key, script_msg->job_id,
 				   resp_msg, script_msg->script_name,
@@ -1465,6 +1509,7 @@ extern int slurmscriptd_init(int argc, char **argv)
 		char *proc_name = "slurmscriptd";
 		char *log_prefix;
 		char *failed_plugin = NULL;
+		char *tmp_ptr;
 
 		/*
 		 * Since running_in_slurmctld() is called before we fork()'d,
@@ -1547,6 +1592,16 @@ extern int slurmscriptd_init(int argc, char **argv)
 
 		debug("Initialization successful");
 
+		if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+					   "script_type_limit="))) {
+			int tmp_val = strtol(tmp_ptr + 18, NULL, 10);
+			if (tmp_val >= 0)
+				script_type_limit = tmp_val;
+			else
+				error("SlurmctldParameters option script_type_limit=%d out of range, ignored",
+				      tmp_val);
+		}
+
 		slurm_mutex_init(&powersave_script_count_mutex);
 		slurm_mutex_init(&write_mutex);
 		_slurmscriptd_mainloop();
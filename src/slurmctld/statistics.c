@@ -39,8 +39,11 @@
 #include <stdio.h>
 
 #include "src/slurmctld/agent.h"
+#include "src/slurmctld/locks.h"
+#include "src/slurmctld/proc_req.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/common/list.h"
+#include "src/common/openmetrics.h"
 #include "src/common/pack.h"
 #include "src/common/xstring.h"
 #include "src/common/slurmdbd_defs.h"
@@ -185,6 +188,147 @@ extern buf_t *pack_all_stat(uint16_t protocol_version)
 	return buffer;
 }
 
+static const char *schedule_exit_names[SCHEDULE_EXIT_COUNT] = {
+	"end", "max_depth", "max_job_start", "licenses", "max_rpc_cnt",
+	"max_sched_time"
+};
+
+static const char *bf_exit_names[BF_EXIT_COUNT] = {
+	"end", "max_job_start", "max_job_test", "state_changed", "table_limit",
+	"max_time"
+};
+
+static void _exit_metric(char **out, char **pos, const char *name,
+			 const char *help, const char **names,
+			 uint32_t *values, int cnt)
+{
+	char *labels = NULL;
+
+	openmetrics_family(out, pos, name, OPENMETRICS_COUNTER, help);
+	for (int i = 0; i < cnt; i++) {
+		xstrfmtcat(labels, "reason=\"%s\"", names[i]);
+		openmetrics_sample(out, pos, name, OPENMETRICS_COUNTER, labels,
+				   values[i]);
+		xfree(labels);
+	}
+}
+
+/*
+ * Dump all scheduling statistics in OpenMetrics format. No slurmctld locks
+ * are taken, the counters are read the same way pack_all_stat() does.
+ */
+extern void dump_all_metrics(char **out, char **pos)
+{
+	int slurmdbd_queue_size = 0;
+	uint32_t server_thread_count;
+
+	if (acct_storage_g_get_data(acct_db_conn, ACCT_STORAGE_INFO_AGENT_COUNT,
+				    &slurmdbd_queue_size) != SLURM_SUCCESS)
+		slurmdbd_queue_size = 0;
+
+	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
+	server_thread_count = slurmctld_config.server_thread_count;
+	slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
+
+	openmetrics_metric(out, pos, "slurmctld_server_threads",
+			   OPENMETRICS_GAUGE,
+			   "Number of active RPC server threads",
+			   server_thread_count);
+	openmetrics_metric(out, pos, "slurmctld_agent_queue_size",
+			   OPENMETRICS_GAUGE,
+			   "Number of agent requests waiting to be sent",
+			   retry_list_size());
+	openmetrics_metric(out, pos, "slurmctld_agents", OPENMETRICS_GAUGE,
+			   "Number of active agents", get_agent_count());
+	openmetrics_metric(out, pos, "slurmctld_agent_threads",
+			   OPENMETRICS_GAUGE,
+			   "Number of threads used by the active agents",
+			   get_agent_thread_count());
+	openmetrics_metric(out, pos, "slurmctld_dbd_agent_queue_size",
+			   OPENMETRICS_GAUGE,
+			   "Number of messages waiting to be sent to slurmdbd",
+			   slurmdbd_queue_size);
+
+	openmetrics_metric(out, pos, "slurmctld_jobs_submitted",
+			   OPENMETRICS_COUNTER, "Number of jobs submitted",
+			   slurmctld_diag_stats.jobs_submitted);
+	openmetrics_metric(out, pos, "slurmctld_jobs_started",
+			   OPENMETRICS_COUNTER, "Number of jobs started",
+			   slurmctld_diag_stats.jobs_started);
+	openmetrics_metric(out, pos, "slurmctld_jobs_completed",
+			   OPENMETRICS_COUNTER, "Number of jobs completed",
+			   slurmctld_diag_stats.jobs_completed);
+	openmetrics_metric(out, pos, "slurmctld_jobs_canceled",
+			   OPENMETRICS_COUNTER, "Number of jobs canceled",
+			   slurmctld_diag_stats.jobs_canceled);
+	openmetrics_metric(out, pos, "slurmctld_jobs_failed",
+			   OPENMETRICS_COUNTER, "Number of jobs failed",
+			   slurmctld_diag_stats.jobs_failed);
+	openmetrics_metric(out, pos, "slurmctld_jobs_pending",
+			   OPENMETRICS_GAUGE, "Number of pending jobs",
+			   slurmctld_diag_stats.jobs_pending);
+	openmetrics_metric(out, pos, "slurmctld_jobs_running",
+			   OPENMETRICS_GAUGE, "Number of running jobs",
+			   slurmctld_diag_stats.jobs_running);
+
+	openmetrics_metric(out, pos, "slurmctld_schedule_cycles",
+			   OPENMETRICS_COUNTER,
+			   "Number of main scheduler cycles",
+			   slurmctld_diag_stats.schedule_cycle_counter);
+	openmetrics_metric(out, pos, "slurmctld_schedule_cycle_microseconds",
+			   OPENMETRICS_COUNTER,
+			   "Time spent in main scheduler cycles",
+			   slurmctld_diag_stats.schedule_cycle_sum);
+	openmetrics_metric(out, pos,
+			   "slurmctld_schedule_cycle_last_microseconds",
+			   OPENMETRICS_GAUGE,
+			   "Duration of the last main scheduler cycle",
+			   slurmctld_diag_stats.schedule_cycle_last);
+	openmetrics_metric(out, pos, "slurmctld_schedule_queue_length",
+			   OPENMETRICS_GAUGE,
+			   "Length of the last main scheduler job queue",
+			   slurmctld_diag_stats.schedule_queue_len);
+	_exit_metric(out, pos, "slurmctld_schedule_exit",
+		     "Main scheduler cycles ended by reason",
+		     schedule_exit_names, slurmctld_diag_stats.schedule_exit,
+		     SCHEDULE_EXIT_COUNT);
+
+	openmetrics_metric(out, pos, "slurmctld_backfill_active",
+			   OPENMETRICS_GAUGE,
+			   "Whether a backfill cycle is running",
+			   slurmctld_diag_stats.bf_active);
+	openmetrics_metric(out, pos, "slurmctld_backfill_cycles",
+			   OPENMETRICS_COUNTER, "Number of backfill cycles",
+			   slurmctld_diag_stats.bf_cycle_counter);
+	openmetrics_metric(out, pos, "slurmctld_backfill_cycle_microseconds",
+			   OPENMETRICS_COUNTER,
+			   "Time spent in backfill cycles",
+			   slurmctld_diag_stats.bf_cycle_sum);
+	openmetrics_metric(out, pos,
+			   "slurmctld_backfill_cycle_last_microseconds",
+			   OPENMETRICS_GAUGE,
+			   "Duration of the last backfill cycle",
+			   slurmctld_diag_stats.bf_cycle_last);
+	openmetrics_metric(out, pos, "slurmctld_backfill_queue_length",
+			   OPENMETRICS_GAUGE,
+			   "Length of the last backfill job queue",
+			   slurmctld_diag_stats.bf_queue_len);
+	openmetrics_metric(out, pos, "slurmctld_backfill_last_depth",
+			   OPENMETRICS_GAUGE,
+			   "Jobs considered in the last backfill cycle",
+			   slurmctld_diag_stats.bf_last_depth);
+	openmetrics_metric(out, pos, "slurmctld_backfilled_jobs",
+			   OPENMETRICS_COUNTER,
+			   "Number of jobs started by backfill",
+			   slurmctld_diag_stats.backfilled_jobs);
+	_exit_metric(out, pos, "slurmctld_backfill_exit",
+		     "Backfill cycles ended by reason", bf_exit_names,
+		     slurmctld_diag_stats.bf_exit, BF_EXIT_COUNT);
+
+	lock_stats_metrics(out, pos);
+	rpc_stats_metrics(out, pos);
+}
+
 /* Reset all scheduling statistics
  * level IN - clear backfilled_jobs count if set */
 extern void reset_stats(int level)
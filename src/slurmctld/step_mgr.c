@@ -327,6 +327,37 @@ static void _internal_step_complete(step_record_t *step_ptr, int remaining)
 	/* step_ptr->state = JOB_COMPLETE; */
 }
 
+/* The step_het_comp and step_id fields of slurm_step_id_t are adjacent */
+#define STEP_HASH_KEY(_step_id) ((const char *) &(_step_id)->step_het_comp)
+#define STEP_HASH_KEY_LEN (sizeof(uint32_t) * 2)
+#define STEP_HASH_MIN_CNT 64
+
+static void _step_hash_id(void *item, const char **key, uint32_t *key_len)
+{
+	step_record_t *step_ptr = item;
+
+	*key = STEP_HASH_KEY(&step_ptr->step_id);
+	*key_len = STEP_HASH_KEY_LEN;
+}
+
+/* Remove step_ptr from its job's step_hash, if indexed */
+static void _step_hash_remove(step_record_t *step_ptr)
+{
+	job_record_t *job_ptr = step_ptr->job_ptr;
+	step_record_t *hash_ptr;
+
+	if (!job_ptr || !job_ptr->step_hash)
+		return;
+
+	hash_ptr = xhash_get(job_ptr->step_hash,
+			     STEP_HASH_KEY(&step_ptr->step_id),
+			     STEP_HASH_KEY_LEN);
+	if (hash_ptr == step_ptr)
+		xhash_pop(job_ptr->step_hash,
+			  STEP_HASH_KEY(&step_ptr->step_id),
+			  STEP_HASH_KEY_LEN);
+}
+
 /*
  * _find_step_id - Find specific step_id entry in the step list,
  *		   see common/list.h for documentation
@@ -451,6 +482,8 @@ extern void free_step_record(void *x)
 	step_record_t *step_ptr = (step_record_t *) x;
 	xassert(step_ptr);
 	xassert(step_ptr->magic == STEP_MAGIC);
+
+	_step_hash_remove(step_ptr);
 /*
  * FIXME: If job step record is preserved after completion,
  * the switch_g_job_step_complete() must be called upon completion
@@ -588,10 +621,37 @@ dump_step_desc(job_step_create_request_msg_t *step_spec)
  */
 step_record_t *find_step_record(job_record_t *job_ptr, slurm_step_id_t *step_id)
 {
+	step_record_t *step_ptr;
+
 	if (job_ptr == NULL)
 		return NULL;
 
-	return list_find_first(job_ptr->step_list, _find_step_id, step_id);
+	/*
+	 * Wildcard and pending step lookups, and jobs with few steps, just
+	 * walk the list. Otherwise steps are added to the index on the first
+	 * exact match and removed again in free_step_record().
+	 */
+	if ((step_id->step_id == NO_VAL) ||
+	    (step_id->step_id == SLURM_PENDING_STEP) ||
+	    (list_count(job_ptr->step_list) < STEP_HASH_MIN_CNT))
+		return list_find_first(job_ptr->step_list, _find_step_id,
+				       step_id);
+
+	if (job_ptr->step_hash &&
+	    (step_ptr = xhash_get(job_ptr->step_hash, STEP_HASH_KEY(step_id),
+				  STEP_HASH_KEY_LEN)) &&
+	    (step_ptr->step_id.job_id == step_id->job_id))
+		return step_ptr;
+
+	step_ptr = list_find_first(job_ptr->step_list, _find_step_id, step_id);
+	if (step_ptr &&
+	    (step_ptr->step_id.step_het_comp == step_id->step_het_comp)) {
+		if (!job_ptr->step_hash)
+			job_ptr->step_hash = xhash_init(_step_hash_id, NULL);
+		xhash_add(job_ptr->step_hash, step_ptr);
+	}
+
+	return step_ptr;
 }
 
 
@@ -829,6 +889,18 @@ static void _wake_pending_steps(job_record_t *job_ptr)
 	list_delete_all(job_ptr->step_list, _wake_steps, &args);
 }
 
+extern void wake_all_pending_steps(job_record_t *job_ptr)
+{
+	wake_steps_args_t args = {
+		.config_start_count = INT_MAX,
+	};
+
+	if (!IS_JOB_RUNNING(job_ptr) || !job_ptr->step_list)
+		return;
+
+	list_delete_all(job_ptr->step_list, _wake_steps, &args);
+}
+
 /* Pick nodes to be allocated to a job step. If a CPU count is also specified,
  * then select nodes with a sufficient CPU count.
  * IN job_ptr - job to contain step allocation
@@ -928,10 +1000,16 @@ static bitstr_t *_pick_step_nodes_cpus(job_record_t *job_ptr,
 	return NULL;
 }
 
+typedef struct {
+	bitstr_t *busy;
+	bitstr_t *nodes_avail;
+} mark_busy_nodes_args_t;
+
 static int _mark_busy_nodes(void *x, void *arg)
 {
 	step_record_t *step_ptr = (step_record_t *) x;
-	bitstr_t *busy = (bitstr_t *) arg;
+	mark_busy_nodes_args_t *args = arg;
+	bitstr_t *busy = args->busy;
 
 	if (step_ptr->state < JOB_RUNNING)
 		return 0;
@@ -962,6 +1040,13 @@ static int _mark_busy_nodes(void *x, void *arg)
 		xfree(temp);
 	}
 
+	/*
+	 * Once every available node is busy the remaining steps can't change
+	 * the result. Jobs running many small steps get here quickly.
+	 */
+	if (bit_super_set(args->nodes_avail, busy))
+		return -1;
+
 	return 0;
 }
 
@@ -1493,8 +1578,14 @@ static bitstr_t *_pick_step_nodes(job_record_t *job_ptr,
 		bit_and_not(nodes_avail, relative_nodes);
 		FREE_NULL_BITMAP(relative_nodes);
 	} else {
+		mark_busy_nodes_args_t busy_args = {
+			.nodes_avail = nodes_avail,
+		};
+
 		nodes_idle = bit_alloc (bit_size (nodes_avail) );
-		list_for_each(job_ptr->step_list, _mark_busy_nodes, nodes_idle);
+		busy_args.busy = nodes_idle;
+		list_for_each(job_ptr->step_list, _mark_busy_nodes,
+			      &busy_args);
 		bit_not(nodes_idle);
 		bit_and(nodes_idle, nodes_avail);
 	}
@@ -3245,8 +3336,11 @@ extern int step_create(job_step_create_request_msg_t *step_specs,
 	     !IS_JOB_CONFIGURING(job_ptr)))
 		return ESLURM_ALREADY_DONE;
 
-	if (job_ptr->details->prolog_running)
+	if (job_ptr->details->prolog_running) {
+		/* Woken by prolog_running_decr() instead of srun polling */
+		_build_pending_step(job_ptr, step_specs);
 		return ESLURM_PROLOG_RUNNING;
+	}
 
 	if (step_specs->flags & SSF_INTERACTIVE) {
 		debug("%s: interactive step requested", __func__);
@@ -4493,8 +4587,9 @@ extern void step_set_alloc_tres(step_record_t *step_ptr, uint32_t node_count,
 		else
 			cpu_count = (uint64_t)step_ptr->cpu_count;
 
-		for (int i = 0; i < bit_set_count(step_ptr->step_node_bitmap);
-		     i++)
+		int step_node_cnt = bit_set_count(step_ptr->step_node_bitmap);
+
+		for (int i = 0; i < step_node_cnt; i++)
 			mem_count += step_ptr->memory_allocated[i];
 
 		tmp_tres_str = gres_ctld_gres_2_tres_str(
@@ -4921,6 +5016,7 @@ extern int load_step_state(job_record_t *job_ptr, buf_t *buffer,
 		goto unpack_error;
 
 	/* set new values */
+	_step_hash_remove(step_ptr);
 	memcpy(&step_ptr->step_id, &step_id, sizeof(step_ptr->step_id));
 
 	step_ptr->container = container;
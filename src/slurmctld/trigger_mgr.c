@@ -97,6 +97,20 @@ static bool trigger_pri_dbd_res_op = false;
 static bool trigger_pri_db_fail = false;
 static bool trigger_pri_db_res_op = false;
 
+/*
+ * TRIGGER_TYPE_* events pending in this trigger_process() pass. Triggers
+ * that match none of them are not evaluated at all.
+ */
+static uint32_t trigger_events = 0;
+
+/* Idle nodes computed in this trigger_process() pass */
+static bitstr_t *trigger_idle_node_bitmap = NULL;
+static time_t trigger_idle_min_time = 0;
+
+/* Trigger types tested on every pass, regardless of pending events */
+#define TRIGGER_TYPE_POLLED (TRIGGER_TYPE_FINI | TRIGGER_TYPE_IDLE | \
+			     TRIGGER_TYPE_TIME)
+
 /* Current trigger pull states (saved and restored) */
 uint8_t ctld_failure = 0;
 uint8_t bu_ctld_failure = 0;
@@ -1049,7 +1063,7 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_DOWN) {
+	if (trig_in->trig_type & trigger_events & TRIGGER_TYPE_DOWN) {
 		if (_front_end_job_test(trigger_down_front_end_bitmap,
 					job_ptr)) {
 			log_flag(TRIGGERS, "trigger[%u] for job %u down",
@@ -1061,7 +1075,7 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_DOWN) {
+	if (trig_in->trig_type & trigger_events & TRIGGER_TYPE_DOWN) {
 		if (trigger_down_nodes_bitmap &&
 		    bit_overlap_any(job_ptr->node_bitmap,
 				    trigger_down_nodes_bitmap)) {
@@ -1074,7 +1088,7 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_FAIL) {
+	if (trig_in->trig_type & trigger_events & TRIGGER_TYPE_FAIL) {
 		if (trigger_fail_nodes_bitmap &&
 		    bit_overlap_any(job_ptr->node_bitmap,
 				    trigger_fail_nodes_bitmap)) {
@@ -1087,7 +1101,7 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_UP) {
+	if (trig_in->trig_type & trigger_events & TRIGGER_TYPE_UP) {
 		if (trigger_up_nodes_bitmap &&
 		    bit_overlap_any(job_ptr->node_bitmap,
 				    trigger_up_nodes_bitmap)) {
@@ -1245,14 +1259,23 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 		time_t min_idle = now - (trig_in->trig_time - 0x8000);
 		int i;
 		node_record_t *node_ptr;
-		bitstr_t *trigger_idle_node_bitmap;
 
-		trigger_idle_node_bitmap = bit_alloc(node_record_count);
-		for (i = 0; (node_ptr = next_node(&i)); i++) {
-			if (!IS_NODE_IDLE(node_ptr) ||
-			    (node_ptr->last_busy > min_idle))
-				continue;
-			bit_set(trigger_idle_node_bitmap, node_ptr->index);
+		/* Triggers with the same offset share the bitmap */
+		if (!trigger_idle_node_bitmap ||
+		    (trigger_idle_min_time != min_idle)) {
+			if (!trigger_idle_node_bitmap)
+				trigger_idle_node_bitmap =
+					bit_alloc(node_record_count);
+			else
+				bit_clear_all(trigger_idle_node_bitmap);
+			trigger_idle_min_time = min_idle;
+			for (i = 0; (node_ptr = next_node(&i)); i++) {
+				if (!IS_NODE_IDLE(node_ptr) ||
+				    (node_ptr->last_busy > min_idle))
+					continue;
+				bit_set(trigger_idle_node_bitmap,
+					node_ptr->index);
+			}
 		}
 		if (trig_in->nodes_bitmap == NULL) {    /* all nodes */
 			xfree(trig_in->res_id);
@@ -1268,7 +1291,6 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 					  trig_in->nodes_bitmap);
 			trig_in->state = 1;
 		}
-		FREE_NULL_BITMAP(trigger_idle_node_bitmap);
 		if (trig_in->state == 1) {
 			trig_in->trig_time = now;
 			log_flag(TRIGGERS, "trigger[%u] for node %s idle",
@@ -1564,6 +1586,60 @@ static void _trigger_run_program(trig_mgr_info_t *trig_in)
 		xfree(args[i]);
 }
 
+static bool _bitmap_set(bitstr_t *bitmap)
+{
+	return (bitmap && (bit_ffs(bitmap) != -1));
+}
+
+/* Build the mask of events that occurred since the last pass */
+static uint32_t _get_trigger_events(void)
+{
+	uint32_t events = TRIGGER_TYPE_POLLED;
+
+	if (_bitmap_set(trigger_down_nodes_bitmap) ||
+	    _bitmap_set(trigger_down_front_end_bitmap))
+		events |= TRIGGER_TYPE_DOWN;
+	if (_bitmap_set(trigger_up_nodes_bitmap) ||
+	    _bitmap_set(trigger_up_front_end_bitmap))
+		events |= TRIGGER_TYPE_UP;
+	if (_bitmap_set(trigger_drained_nodes_bitmap))
+		events |= TRIGGER_TYPE_DRAINED;
+	if (_bitmap_set(trigger_fail_nodes_bitmap))
+		events |= TRIGGER_TYPE_FAIL;
+	if (_bitmap_set(trigger_draining_nodes_bitmap))
+		events |= TRIGGER_TYPE_DRAINING;
+	if (_bitmap_set(trigger_resume_nodes_bitmap))
+		events |= TRIGGER_TYPE_RESUME;
+	if (trigger_node_reconfig)
+		events |= TRIGGER_TYPE_RECONFIG;
+	if (trigger_bb_error)
+		events |= TRIGGER_TYPE_BURST_BUFFER;
+	if (trigger_pri_ctld_fail)
+		events |= TRIGGER_TYPE_PRI_CTLD_FAIL;
+	if (trigger_pri_ctld_res_op)
+		events |= TRIGGER_TYPE_PRI_CTLD_RES_OP;
+	if (trigger_pri_ctld_res_ctrl)
+		events |= TRIGGER_TYPE_PRI_CTLD_RES_CTRL;
+	if (trigger_pri_ctld_acct_buffer_full)
+		events |= TRIGGER_TYPE_PRI_CTLD_ACCT_FULL;
+	if (trigger_bu_ctld_fail)
+		events |= TRIGGER_TYPE_BU_CTLD_FAIL;
+	if (trigger_bu_ctld_res_op)
+		events |= TRIGGER_TYPE_BU_CTLD_RES_OP;
+	if (trigger_bu_ctld_as_ctrl)
+		events |= TRIGGER_TYPE_BU_CTLD_AS_CTRL;
+	if (trigger_pri_dbd_fail)
+		events |= TRIGGER_TYPE_PRI_DBD_FAIL;
+	if (trigger_pri_dbd_res_op)
+		events |= TRIGGER_TYPE_PRI_DBD_RES_OP;
+	if (trigger_pri_db_fail)
+		events |= TRIGGER_TYPE_PRI_DB_FAIL;
+	if (trigger_pri_db_res_op)
+		events |= TRIGGER_TYPE_PRI_DB_RES_OP;
+
+	return events;
+}
+
 static void _clear_event_triggers(void)
 {
 	if (trigger_down_front_end_bitmap)
@@ -1580,6 +1656,7 @@ static void _clear_event_triggers(void)
 		bit_clear_all(trigger_draining_nodes_bitmap);
 	if (trigger_resume_nodes_bitmap)
 		bit_clear_all(trigger_resume_nodes_bitmap);
+	FREE_NULL_BITMAP(trigger_idle_node_bitmap);
 	trigger_node_reconfig = false;
 	trigger_bb_error = false;
 	trigger_pri_ctld_fail = false;
@@ -1635,9 +1712,17 @@ extern void trigger_process(void)
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 
+	trigger_events = _get_trigger_events();
 	trig_iter = list_iterator_create(trigger_list);
 	while ((trig_in = list_next(trig_iter))) {
-		if (trig_in->state == 0) {
+		/*
+		 * Job triggers are always tested so that triggers of purged
+		 * jobs get cleaned up, their node tests are skipped unless
+		 * such an event is pending.
+		 */
+		if ((trig_in->state == 0) &&
+		    ((trig_in->res_type == TRIGGER_RES_TYPE_JOB) ||
+		     (trig_in->trig_type & trigger_events))) {
 			if (trig_in->res_type == TRIGGER_RES_TYPE_OTHER)
 				_trigger_other_event(trig_in, now);
 			else if (trig_in->res_type == TRIGGER_RES_TYPE_JOB)
@@ -57,6 +57,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/inotify.h>
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -76,6 +77,7 @@
 #include "src/interfaces/gres.h"
 #include "src/common/group_cache.h"
 #include "src/common/hostlist.h"
+#include "src/common/job_trace.h"
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
@@ -157,6 +159,13 @@ typedef struct {
 	char *pos;
 } foreach_libdir_args_t;
 
+typedef struct {
+	char *base;			/* shared object file name */
+	file_bcast_info_t *key;
+	char *match;			/* path of an identical copy */
+	file_bcast_msg_t *req;
+} so_probe_args_t;
+
 static void _delay_rpc(int host_inx, int host_cnt, int usec_per_rpc);
 static void _free_job_env(job_env_t *env_ptr);
 static bool _is_batch_job_finished(uint32_t job_id);
@@ -194,6 +203,8 @@ static void _rpc_reboot(slurm_msg_t *msg);
 static void _rpc_pid2jid(slurm_msg_t *msg);
 static void _rpc_file_bcast(slurm_msg_t *msg);
 static void _file_bcast_cleanup(void);
+static int _file_bcast_probe_so(file_bcast_msg_t *req,
+				file_bcast_info_t *key);
 static int  _file_bcast_register_file(slurm_msg_t *msg,
 				      sbcast_cred_arg_t *cred_arg,
 				      file_bcast_info_t *key);
@@ -224,6 +235,8 @@ static sbcast_cred_arg_t *_valid_sbcast_cred(file_bcast_msg_t *req,
 					     gid_t req_gid,
 					     uint16_t protocol_version);
 static void _wait_state_completed(uint32_t jobid, int max_delay);
+static int  _stepd_watch_init(void);
+static void _stepd_watch_wait(int fd, int timeout_ms);
 static uid_t _get_job_uid(uint32_t jobid);
 
 static int  _add_starting_step(uint16_t type, void *req);
@@ -248,6 +261,16 @@ static list_t *waiters = NULL;
 static time_t startup = 0;		/* daemon startup time */
 static time_t last_slurmctld_msg = 0;
 
+typedef struct {
+	int to_stepd;		/* write end of the slurmstepd's stdin */
+	int to_slurmd;		/* read end of the slurmstepd's stdout */
+} stepd_pool_t;
+
+/* Pre-started slurmstepds, see SlurmdParameters=stepd_pool */
+static pthread_mutex_t stepd_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static list_t *stepd_pool = NULL;
+static bool stepd_pool_refilling = false;
+
 static pthread_mutex_t job_limits_mutex = PTHREAD_MUTEX_INITIALIZER;
 static list_t *job_limits_list = NULL;
 static bool job_limits_loaded = false;
@@ -401,6 +424,7 @@ slurmd_req(slurm_msg_t *msg)
 		_rpc_step_complete(msg);
 		break;
 	case REQUEST_JOB_STEP_STAT:
+	case REQUEST_JOB_STEP_STAT_REDUCED:
 		_rpc_stat_jobacct(msg);
 		break;
 	case REQUEST_JOB_STEP_PIDS:
@@ -667,6 +691,279 @@ fail:
 }
 
 
+/*
+ * Runs in the first child of slurmd. Fork again and exec the slurmstepd in
+ * the grandchild, with to_stepd as its stdin and to_slurmd as its stdout.
+ * type and req are only used to name the SLURMSTEPD_MEMCHECK log files.
+ */
+static void _exec_slurmstepd(uint16_t type, void *req, int *to_stepd,
+			     int *to_slurmd)
+{
+#if (SLURMSTEPD_MEMCHECK == 1)
+	/* memcheck test of slurmstepd, option #1 */
+	char *const argv[3] = {"memcheck",
+			       (char *)conf->stepd_loc, NULL};
+#elif (SLURMSTEPD_MEMCHECK == 2)
+	/* valgrind test of slurmstepd, option #2 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[13] = {"valgrind", "--tool=memcheck",
+				"--error-limit=no",
+				"--leak-check=summary",
+				"--show-reachable=yes",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				"--track-origins=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = SLURM_BATCH_SCRIPT;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#elif (SLURMSTEPD_MEMCHECK == 3)
+	/* valgrind/drd test of slurmstepd, option #3 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[10] = {"valgrind", "--tool=drd",
+				"--error-limit=no",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = SLURM_BATCH_SCRIPT;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#elif (SLURMSTEPD_MEMCHECK == 4)
+	/* valgrind/helgrind test of slurmstepd, option #4 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[10] = {"valgrind", "--tool=helgrind",
+				"--error-limit=no",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = SLURM_BATCH_SCRIPT;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#else
+	/* no memory checking, default */
+	char *const argv[2] = { (char *)conf->stepd_loc, NULL};
+#endif
+	int i;
+	int failed = 0;
+	pid_t pid;
+
+	/*
+	 * Child forks and exits
+	 */
+	if (setsid() < 0) {
+		error("%s: setsid: %m", __func__);
+		failed = 1;
+	}
+	if ((pid = fork()) < 0) {
+		error("%s: Unable to fork grandchild: %m", __func__);
+		failed = 2;
+	} else if (pid > 0) { /* child */
+		_exit(0);
+	}
+
+	/*
+	 * Just in case we (or someone we are linking to)
+	 * opened a file and didn't do a close on exec.  This
+	 * is needed mostly to protect us against libs we link
+	 * to that don't set the flag as we should already be
+	 * setting it for those that we open.  The number 256
+	 * is an arbitrary number based off test7.9.
+	 */
+	for (i=3; i<256; i++) {
+		(void) fcntl(i, F_SETFD, FD_CLOEXEC);
+	}
+
+	/*
+	 * Grandchild exec's the slurmstepd
+	 *
+	 * If the slurmd is being shutdown/restarted before
+	 * the pipe happens the old conf->lfd could be reused
+	 * and if we close it the dup2 below will fail.
+	 */
+	if ((to_stepd[0] != conf->lfd)
+	    && (to_slurmd[1] != conf->lfd))
+		close(conf->lfd);
+
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in grandchild: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+
+	(void) close(STDIN_FILENO); /* ignore return */
+	if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
+		error("dup2 over STDIN_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_close_on_exec(to_stepd[0]);
+	(void) close(STDOUT_FILENO); /* ignore return */
+	if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
+		error("dup2 over STDOUT_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_close_on_exec(to_slurmd[1]);
+	(void) close(STDERR_FILENO); /* ignore return */
+	if (dup2(devnull, STDERR_FILENO) == -1) {
+		error("dup2 /dev/null to STDERR_FILENO: %m");
+		_exit(1);
+	}
+	fd_set_noclose_on_exec(STDERR_FILENO);
+	log_fini();
+	if (!failed) {
+		execvp(argv[0], argv);
+		error("exec of slurmstepd failed: %m");
+	}
+	_exit(2);
+}
+
+static void _stepd_pool_free(void *x)
+{
+	stepd_pool_t *stepd = x;
+
+	(void) close(stepd->to_stepd);
+	(void) close(stepd->to_slurmd);
+	xfree(stepd);
+}
+
+/* Start a slurmstepd that waits for its initialization data */
+static stepd_pool_t *_stepd_pool_spawn(void)
+{
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	stepd_pool_t *stepd;
+	pid_t pid;
+
+	if (pipe(to_stepd) < 0) {
+		error("%s: pipe failed: %m", __func__);
+		return NULL;
+	}
+	if (pipe(to_slurmd) < 0) {
+		error("%s: pipe failed: %m", __func__);
+		close(to_stepd[0]);
+		close(to_stepd[1]);
+		return NULL;
+	}
+
+	if ((pid = fork()) < 0) {
+		error("%s: fork: %m", __func__);
+		close(to_stepd[0]);
+		close(to_stepd[1]);
+		close(to_slurmd[0]);
+		close(to_slurmd[1]);
+		return NULL;
+	} else if (pid == 0) {
+		_exec_slurmstepd(0, NULL, to_stepd, to_slurmd);
+	}
+
+	if (close(to_stepd[0]) < 0)
+		error("Unable to close read to_stepd in parent: %m");
+	if (close(to_slurmd[1]) < 0)
+		error("Unable to close write to_slurmd in parent: %m");
+
+	/* The child exits as soon as it has forked the slurmstepd */
+	if (waitpid(pid, NULL, 0) < 0)
+		error("Unable to reap slurmd child process");
+
+	/* Keep other children of slurmd from holding the pipes open */
+	fd_set_close_on_exec(to_stepd[1]);
+	fd_set_close_on_exec(to_slurmd[0]);
+
+	stepd = xmalloc(sizeof(*stepd));
+	stepd->to_stepd = to_stepd[1];
+	stepd->to_slurmd = to_slurmd[0];
+
+	return stepd;
+}
+
+static void *_stepd_pool_refill(void *arg)
+{
+	stepd_pool_t *stepd;
+
+	while (true) {
+		slurm_mutex_lock(&stepd_pool_mutex);
+		if (!stepd_pool)
+			stepd_pool = list_create(_stepd_pool_free);
+		if (list_count(stepd_pool) >= conf->stepd_pool)
+			break;
+		slurm_mutex_unlock(&stepd_pool_mutex);
+
+		stepd = _stepd_pool_spawn();
+
+		slurm_mutex_lock(&stepd_pool_mutex);
+		if (!stepd)
+			break;
+		list_append(stepd_pool, stepd);
+		slurm_mutex_unlock(&stepd_pool_mutex);
+	}
+	stepd_pool_refilling = false;
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	return NULL;
+}
+
+/*
+ * Take a pre-started slurmstepd from the pool and start refilling the pool
+ * in the background.
+ * OUT to_stepd - write end of the slurmstepd's stdin
+ * OUT to_slurmd - read end of the slurmstepd's stdout
+ * RET true if a slurmstepd was taken from the pool
+ */
+static bool _stepd_pool_get(int *to_stepd, int *to_slurmd)
+{
+	stepd_pool_t *stepd = NULL;
+
+	/* The memcheck wrappers need the step id on the command line */
+	if (SLURMSTEPD_MEMCHECK || !conf->stepd_pool)
+		return false;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	if (stepd_pool)
+		stepd = list_pop(stepd_pool);
+	if (!stepd_pool_refilling) {
+		stepd_pool_refilling = true;
+		slurm_thread_create_detached(_stepd_pool_refill, NULL);
+	}
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	if (!stepd)
+		return false;
+
+	*to_stepd = stepd->to_stepd;
+	*to_slurmd = stepd->to_slurmd;
+	xfree(stepd);
+
+	return true;
+}
+
 /*
  * Fork and exec the slurmstepd, then send the slurmstepd its
  * initialization data.  Then wait for slurmstepd to send an "ok"
@@ -677,26 +974,37 @@ fail:
  * Note that this code forks twice and it is the grandchild that
  * becomes the slurmstepd process, so the slurmstepd's parent process
  * will be init, not slurmd.
+ *
+ * With SlurmdParameters=stepd_pool an already started slurmstepd is
+ * used instead, if one is available.
  */
 static int
 _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 		      hostlist_t *step_hset, uint16_t protocol_version)
 {
-	pid_t pid;
+	pid_t pid = 0;
 	int to_stepd[2] = {-1, -1};
 	int to_slurmd[2] = {-1, -1};
-
-	if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
-		error("%s: pipe failed: %m", __func__);
-		return SLURM_ERROR;
-	}
+	int rc = SLURM_SUCCESS;
+	bool pooled;
+#if (SLURMSTEPD_MEMCHECK == 0)
+	int i;
+	time_t start_time = time(NULL);
+#endif
 
 	if (_add_starting_step(type, req)) {
 		error("%s: failed in _add_starting_step: %m", __func__);
 		return SLURM_ERROR;
 	}
 
-	if ((pid = fork()) < 0) {
+again:
+	if ((pooled = _stepd_pool_get(&to_stepd[1], &to_slurmd[0]))) {
+		debug3("%s: using pre-started slurmstepd", __func__);
+	} else if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
+		error("%s: pipe failed: %m", __func__);
+		_remove_starting_step(type, req);
+		return SLURM_ERROR;
+	} else if ((pid = fork()) < 0) {
 		error("%s: fork: %m", __func__);
 		close(to_stepd[0]);
 		close(to_stepd[1]);
@@ -704,12 +1012,9 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 		close(to_slurmd[1]);
 		_remove_starting_step(type, req);
 		return SLURM_ERROR;
-	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
-#if (SLURMSTEPD_MEMCHECK == 0)
-		int i;
-		time_t start_time = time(NULL);
-#endif
+	} else if (pid == 0) {
+		_exec_slurmstepd(type, req, to_stepd, to_slurmd);
+	} else {
 		/*
 		 * Parent sends initialization data to the slurmstepd
 		 * over the to_stepd pipe, and waits for the return code
@@ -719,202 +1024,66 @@ _forkexec_slurmstepd(uint16_t type, void *req, slurm_addr_t *cli,
 			error("Unable to close read to_stepd in parent: %m");
 		if (close(to_slurmd[1]) < 0)
 			error("Unable to close write to_slurmd in parent: %m");
+	}
 
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
+	if ((rc = _send_slurmstepd_init(to_stepd[1], type,
+					req, cli, step_hset,
+					protocol_version)) != 0) {
+		if (pooled) {
+			/* Pooled slurmstepd went away, start a new one */
+			error("Unable to init pre-started slurmstepd, starting a new one");
+			(void) close(to_stepd[1]);
+			(void) close(to_slurmd[0]);
+			to_stepd[1] = to_slurmd[0] = -1;
+			goto again;
 		}
+		error("Unable to init slurmstepd");
+		goto done;
+	}
 
-		/* If running under valgrind/memcheck, this pipe doesn't work
-		 * correctly so just skip it. */
+	/* If running under valgrind/memcheck, this pipe doesn't work
+	 * correctly so just skip it. */
 #if (SLURMSTEPD_MEMCHECK == 0)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				warning("slurmstepd startup took %d sec, possible file system problem or full memory",
-					delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d: %s",
-				      rc, slurm_strerror(rc));
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
-#endif
-	done:
-		if (_remove_starting_step(type, req))
-			error("Error cleaning up starting_step list");
-
-		/* Reap child */
-		if (waitpid(pid, NULL, 0) < 0)
-			error("Unable to reap slurmd child process");
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in parent: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-		return rc;
+	i = read(to_slurmd[0], &rc, sizeof(int));
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
 	} else {
-#if (SLURMSTEPD_MEMCHECK == 1)
-		/* memcheck test of slurmstepd, option #1 */
-		char *const argv[3] = {"memcheck",
-				       (char *)conf->stepd_loc, NULL};
-#elif (SLURMSTEPD_MEMCHECK == 2)
-		/* valgrind test of slurmstepd, option #2 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[13] = {"valgrind", "--tool=memcheck",
-					"--error-limit=no",
-					"--leak-check=summary",
-					"--show-reachable=yes",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					"--track-origins=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = SLURM_BATCH_SCRIPT;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
-		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#elif (SLURMSTEPD_MEMCHECK == 3)
-		/* valgrind/drd test of slurmstepd, option #3 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[10] = {"valgrind", "--tool=drd",
-					"--error-limit=no",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = SLURM_BATCH_SCRIPT;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
-		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#elif (SLURMSTEPD_MEMCHECK == 4)
-		/* valgrind/helgrind test of slurmstepd, option #4 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[10] = {"valgrind", "--tool=helgrind",
-					"--error-limit=no",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = SLURM_BATCH_SCRIPT;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->step_id.job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->step_id.step_id;
-		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#else
-		/* no memory checking, default */
-		char *const argv[2] = { (char *)conf->stepd_loc, NULL};
-#endif
-		int i;
-		int failed = 0;
-
-		/*
-		 * Child forks and exits
-		 */
-		if (setsid() < 0) {
-			error("%s: setsid: %m", __func__);
-			failed = 1;
-		}
-		if ((pid = fork()) < 0) {
-			error("%s: Unable to fork grandchild: %m", __func__);
-			failed = 2;
-		} else if (pid > 0) { /* child */
-			_exit(0);
-		}
-
-		/*
-		 * Just in case we (or someone we are linking to)
-		 * opened a file and didn't do a close on exec.  This
-		 * is needed mostly to protect us against libs we link
-		 * to that don't set the flag as we should already be
-		 * setting it for those that we open.  The number 256
-		 * is an arbitrary number based off test7.9.
-		 */
-		for (i=3; i<256; i++) {
-			(void) fcntl(i, F_SETFD, FD_CLOEXEC);
-		}
-
-		/*
-		 * Grandchild exec's the slurmstepd
-		 *
-		 * If the slurmd is being shutdown/restarted before
-		 * the pipe happens the old conf->lfd could be reused
-		 * and if we close it the dup2 below will fail.
-		 */
-		if ((to_stepd[0] != conf->lfd)
-		    && (to_slurmd[1] != conf->lfd))
-			close(conf->lfd);
-
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in grandchild: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-
-		(void) close(STDIN_FILENO); /* ignore return */
-		if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
-			error("dup2 over STDIN_FILENO: %m");
-			_exit(1);
-		}
-		fd_set_close_on_exec(to_stepd[0]);
-		(void) close(STDOUT_FILENO); /* ignore return */
-		if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
-			error("dup2 over STDOUT_FILENO: %m");
-			_exit(1);
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			warning("slurmstepd startup took %d sec, possible file system problem or full memory",
+				delta_time);
 		}
-		fd_set_close_on_exec(to_slurmd[1]);
-		(void) close(STDERR_FILENO); /* ignore return */
-		if (dup2(devnull, STDERR_FILENO) == -1) {
-			error("dup2 /dev/null to STDERR_FILENO: %m");
-			_exit(1);
-		}
-		fd_set_noclose_on_exec(STDERR_FILENO);
-		log_fini();
-		if (!failed) {
-			execvp(argv[0], argv);
-			error("exec of slurmstepd failed: %m");
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d: %s",
+			      rc, slurm_strerror(rc));
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd[1], &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
 		}
-		_exit(2);
 	}
+#endif
+done:
+	if (_remove_starting_step(type, req))
+		error("Error cleaning up starting_step list");
+
+	/* Reap child, a pooled slurmstepd's child was reaped already */
+	if (pid && (waitpid(pid, NULL, 0) < 0))
+		error("Unable to reap slurmd child process");
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in parent: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+	return rc;
 }
 
 static void _setup_x11_display(uint32_t job_id, uint32_t step_id_in,
@@ -2373,7 +2542,9 @@ static void _rpc_batch_job(slurm_msg_t *msg)
 	slurm_addr_t *cli = &msg->orig_addr;
 	uid_t batch_uid = SLURM_AUTH_NOBODY;
 	gid_t batch_gid = SLURM_AUTH_NOBODY;
+	job_trace_span_t launch_span, prolog_span;
 
+	job_trace_start(&launch_span);
 	if (!_slurm_authorized_user(msg->auth_uid)) {
 		error("Security violation, batch launch RPC from uid %u",
 		      msg->auth_uid);
@@ -2486,7 +2657,9 @@ static void _rpc_batch_job(slurm_msg_t *msg)
 	 	 * Run job prolog on this node
 	 	 */
 
+		job_trace_start(&prolog_span);
 		rc = _run_prolog(&job_env, req->cred, true);
+		job_trace_end(&prolog_span, req->job_id, "slurmd_prolog");
 		_free_job_env(&job_env);
 		if (rc) {
 			int term_sig = 0, exit_status = 0;
@@ -2530,6 +2703,7 @@ static void _rpc_batch_job(slurm_msg_t *msg)
 	rc = _forkexec_slurmstepd(LAUNCH_BATCH_JOB, (void *)req, cli,
 				  NULL, SLURM_PROTOCOL_VERSION);
 	debug3("_rpc_batch_job: return from _forkexec_slurmstepd: %d", rc);
+	job_trace_end(&launch_span, req->job_id, "slurmd_batch_launch");
 
 	_launch_complete_add(req->job_id, true);
 
@@ -3147,6 +3321,36 @@ _enforce_job_mem_limit(void)
 	xfree(job_mem_info_ptr);
 }
 
+/*
+ * Delay by a per-node offset within window_ms derived from the node name, so
+ * nodes with adjacent names do not send back to back.
+ */
+static void _node_jitter_delay(uint32_t window_ms, const char *what)
+{
+	uint32_t hash = 2166136261U, delay_ms;
+
+	if (!window_ms)
+		return;
+
+	slurm_mutex_lock(&conf->config_mutex);
+	for (char *p = conf->node_name; p && *p; p++)
+		hash = (hash ^ (unsigned char) *p) * 16777619U;
+	slurm_mutex_unlock(&conf->config_mutex);
+
+	delay_ms = hash % window_ms;
+	debug2("%s: delaying %s by %ums", __func__, what, delay_ms);
+	usleep(delay_ms * 1000);
+}
+
+/*
+ * SlurmdParameters=reg_jitter=<sec>. slurmctld requests registration from
+ * every node at once when it (re)starts. Spread the replies over the window.
+ */
+static void _reg_jitter_delay(void)
+{
+	_node_jitter_delay(conf->reg_jitter * 1000, "registration");
+}
+
 static void _rpc_ping(slurm_msg_t *msg)
 {
 	int        rc = SLURM_SUCCESS;
@@ -3179,8 +3383,8 @@ static void _rpc_ping(slurm_msg_t *msg)
 	} else {
 		slurm_msg_t resp_msg;
 		ping_slurmd_resp_msg_t ping_resp;
-		get_cpu_load(&ping_resp.cpu_load);
-		get_free_mem(&ping_resp.free_mem);
+		get_cpu_load_free_mem(&ping_resp.cpu_load,
+				      &ping_resp.free_mem);
 		slurm_msg_t_copy(&resp_msg, msg);
 		resp_msg.msg_type = RESPONSE_PING_SLURMD;
 		resp_msg.data     = &ping_resp;
@@ -3194,6 +3398,7 @@ static void _rpc_ping(slurm_msg_t *msg)
 
 		if (msg->msg_type == REQUEST_NODE_REGISTRATION_STATUS) {
 			get_reg_resp = true;
+			_reg_jitter_delay();
 			send_registration_msg(SLURM_SUCCESS);
 		}
 	}
@@ -3290,6 +3495,7 @@ static void _rpc_acct_gather_energy(slurm_msg_t *msg)
 	static bool first_msg = true;
 	static uint32_t req_cnt = 0;
 	static pthread_mutex_t req_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_mutex_t energy_poll_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 	if (!_slurm_authorized_user(msg->auth_uid)) {
 		error("Security violation, acct_gather_update RPC from uid %u",
@@ -3346,19 +3552,35 @@ static void _rpc_acct_gather_energy(slurm_msg_t *msg)
 			goto fini;
 		}
 
-		/* If we polled later than delta seconds then force a
-		   new poll.
-		*/
-		if ((now - last_poll) > req->delta)
-			data_type = ENERGY_DATA_JOULES_TASK;
-
 		memset(&acct_msg, 0, sizeof(acct_msg));
 		acct_msg.sensor_cnt = sensor_cnt;
 		acct_msg.energy = acct_gather_energy_alloc(acct_msg.sensor_cnt);
 
-		acct_gather_energy_g_get_data(req->context_id,
-					      data_type,
-					      acct_msg.energy);
+		/* If we polled later than delta seconds then force a
+		   new poll.
+		*/
+		if ((now - last_poll) > req->delta) {
+			/*
+			 * Every step on the node asks at about the same
+			 * time. Let one of them poll the sensors (slow and
+			 * serialized on the BMC for IPMI) and the others
+			 * reuse that reading.
+			 */
+			slurm_mutex_lock(&energy_poll_mutex);
+			acct_gather_energy_g_get_data(req->context_id,
+						      ENERGY_DATA_LAST_POLL,
+						      &last_poll);
+			if ((time(NULL) - last_poll) > req->delta)
+				data_type = ENERGY_DATA_JOULES_TASK;
+			acct_gather_energy_g_get_data(req->context_id,
+						      data_type,
+						      acct_msg.energy);
+			slurm_mutex_unlock(&energy_poll_mutex);
+		} else {
+			acct_gather_energy_g_get_data(req->context_id,
+						      data_type,
+						      acct_msg.energy);
+		}
 
 		slurm_msg_t_copy(&resp_msg, msg);
 		resp_msg.msg_type = RESPONSE_ACCT_GATHER_ENERGY;
@@ -3610,6 +3832,59 @@ static void _rpc_daemon_status(slurm_msg_t *msg)
 	slurm_free_slurmd_status(resp);
 }
 
+/*
+ * Fold the RESPONSE_JOB_STEP_STAT replies of the nodes this slurmd forwarded
+ * the request to into its own reply. Only errors are left in ret_list, so
+ * the reply travelling up the tree no longer grows with the node count.
+ */
+static void _reduce_step_stat(job_step_stat_t *resp, list_t *ret_list)
+{
+	hostlist_t *hl;
+	list_itr_t *itr;
+	ret_data_info_t *ret_data_info;
+	job_step_pids_t *pids = resp->step_pids;
+
+	if (!ret_list || !list_count(ret_list))
+		return;
+
+	hl = hostlist_create(pids->node_name);
+	itr = list_iterator_create(ret_list);
+	while ((ret_data_info = list_next(itr))) {
+		job_step_stat_t *stat = ret_data_info->data;
+
+		if ((ret_data_info->type != RESPONSE_JOB_STEP_STAT) || !stat)
+			continue;
+
+		if (!resp->jobacct) {
+			resp->jobacct = stat->jobacct;
+			stat->jobacct = NULL;
+		} else {
+			jobacctinfo_aggregate(resp->jobacct, stat->jobacct);
+		}
+		resp->num_tasks += stat->num_tasks;
+
+		if (stat->step_pids) {
+			job_step_pids_t *from = stat->step_pids;
+
+			hostlist_push(hl, from->node_name);
+			if (from->pid_cnt) {
+				xrecalloc(pids->pid, (pids->pid_cnt +
+						      from->pid_cnt),
+					  sizeof(*pids->pid));
+				memcpy(&pids->pid[pids->pid_cnt], from->pid,
+				       (from->pid_cnt * sizeof(*pids->pid)));
+				pids->pid_cnt += from->pid_cnt;
+			}
+		}
+		list_delete_item(itr);
+	}
+	list_iterator_destroy(itr);
+
+	xfree(pids->node_name);
+	pids->node_name = hostlist_ranged_string_xmalloc(hl);
+	hostlist_destroy(hl);
+}
+
 static void _rpc_stat_jobacct(slurm_msg_t *msg)
 {
 	slurm_step_id_t *req = msg->data;
@@ -3676,6 +3951,11 @@ static void _rpc_stat_jobacct(slurm_msg_t *msg)
 
 	close(fd);
 
+	if (msg->msg_type == REQUEST_JOB_STEP_STAT_REDUCED) {
+		forward_wait(&resp_msg);
+		_reduce_step_stat(resp, resp_msg.ret_list);
+	}
+
 	resp_msg.msg_type     = RESPONSE_JOB_STEP_STAT;
 	resp_msg.data         = resp;
 
@@ -4218,6 +4498,14 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 	}
 	key.fname = req->fname;
 
+	if (req->flags & FILE_BCAST_PROBE) {
+		if (req->flags & FILE_BCAST_SO)
+			rc = _file_bcast_probe_so(req, &key);
+		else
+			rc = SLURM_ERROR;
+		goto done;
+	}
+
 	if (req->block_no == 1) {
 		info("sbcast req_uid=%u job_id=%u fname=%s block_no=%u",
 		     key.uid, key.job_id, key.fname, req->block_no);
@@ -4251,10 +4539,15 @@ static void _rpc_file_bcast(slurm_msg_t *msg)
 		goto done;
 	}
 
+	/*
+	 * Write at the block's own offset, sbcast --pipeline may have several
+	 * blocks of the same file in flight.
+	 */
 	offset = 0;
 	while (req->block_len - offset) {
-		inx = write(file_info->fd, &req->block[offset],
-			    (req->block_len - offset));
+		inx = pwrite(file_info->fd, &req->block[offset],
+			     (req->block_len - offset),
+			     (req->block_offset + offset));
 		if (inx == -1) {
 			if ((errno == EINTR) || (errno == EAGAIN))
 				continue;
@@ -4301,6 +4594,88 @@ done:
 	slurm_send_rc_msg(msg, rc);
 }
 
+/*
+ * A complete copy of a shared object has the size and modification time of
+ * the source file, set by sbcast on the last block. Must have read lock.
+ */
+static bool _so_copy_matches(char *path, file_bcast_msg_t *req,
+			     file_bcast_info_t *key)
+{
+	file_bcast_info_t path_key = *key;
+	struct stat st;
+
+	path_key.fname = path;
+	if (_bcast_lookup_file(&path_key))
+		return false;	/* still being transferred */
+
+	if (lstat(path, &st) || !S_ISREG(st.st_mode))
+		return false;
+
+	return ((st.st_uid == key->uid) &&
+		((uint64_t) st.st_size == req->file_size) &&
+		(st.st_mtime == req->mtime));
+}
+
+static int _find_so_copy(void *x, void *arg)
+{
+	libdir_rec_t *l = x;
+	so_probe_args_t *args = arg;
+	char *path;
+
+	if ((l->uid != args->key->uid) || (l->job_id != args->key->job_id))
+		return 0;
+
+	path = xstrdup_printf("%s/%s", l->directory, args->base);
+	if (xstrcmp(path, args->req->fname) &&
+	    _so_copy_matches(path, args->req, args->key)) {
+		args->match = path;
+		return 1;
+	}
+	xfree(path);
+
+	return 0;
+}
+
+/*
+ * Answer a FILE_BCAST_PROBE for a shared object. If this job already received
+ * an identical copy for another executable, link it into this executable's
+ * library directory so that sbcast can skip sending it to this node.
+ *
+ * RET SLURM_SUCCESS if the shared object is in place, ENOENT otherwise
+ */
+static int _file_bcast_probe_so(file_bcast_msg_t *req, file_bcast_info_t *key)
+{
+	so_probe_args_t args = {
+		.base = xbasename(req->fname),
+		.key = key,
+		.req = req,
+	};
+	int rc = ENOENT;
+
+	slurm_rwlock_rdlock(&file_bcast_lock);
+	if (_so_copy_matches(req->fname, req, key)) {
+		slurm_rwlock_unlock(&file_bcast_lock);
+		return SLURM_SUCCESS;
+	}
+	(void) list_find_first(bcast_libdir_list, _find_so_copy, &args);
+	slurm_rwlock_unlock(&file_bcast_lock);
+
+	if (!args.match)
+		return rc;
+
+	if (link(args.match, req->fname)) {
+		debug("sbcast: uid:%u can't link `%s` to `%s`: %m",
+		      key->uid, args.match, req->fname);
+	} else {
+		debug("sbcast: uid:%u reused `%s` for `%s`",
+		      key->uid, args.match, req->fname);
+		rc = SLURM_SUCCESS;
+	}
+	xfree(args.match);
+
+	return rc;
+}
+
 static int _file_bcast_register_file(slurm_msg_t *msg,
 				     sbcast_cred_arg_t *cred_arg,
 				     file_bcast_info_t *key)
@@ -4738,17 +5113,76 @@ _job_still_running(uint32_t job_id)
 static void
 _wait_state_completed(uint32_t jobid, int max_delay)
 {
-	int i;
-
-	for (i=0; i<max_delay; i++) {
-		if (_steps_completed_now(jobid))
+	struct timeval tv = { 0 };
+	int fd, elapsed_ms;
+	bool completed;
+
+	fd = _stepd_watch_init();
+	(void) slurm_delta_tv(&tv);
+	while (!(completed = _steps_completed_now(jobid))) {
+		elapsed_ms = slurm_delta_tv(&tv) / 1000;
+		if (elapsed_ms >= (max_delay * 1000))
 			break;
-		sleep(1);
+		_stepd_watch_wait(fd, MIN(1000, (max_delay * 1000) -
+					      elapsed_ms));
 	}
-	if (i >= max_delay)
+	if (fd >= 0)
+		close(fd);
+	if (!completed)
 		error("timed out waiting for job %u to complete", jobid);
 }
 
+/*
+ * Watch the spool directory for removed files. A slurmstepd unlinks its
+ * domain socket there as the last step of its shutdown, which is the point
+ * where _job_still_running() and _steps_completed_now() stop counting it.
+ * Returns an inotify file descriptor, or -1 to fall back to plain polling.
+ */
+static int _stepd_watch_init(void)
+{
+	int fd;
+
+	if ((fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+		debug("%s: inotify_init1: %m", __func__);
+		return -1;
+	}
+	if (inotify_add_watch(fd, conf->spooldir, IN_DELETE) < 0) {
+		debug("%s: inotify_add_watch(%s): %m",
+		      __func__, conf->spooldir);
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/*
+ * Sleep for up to timeout_ms, returning early if a file was removed from the
+ * spool directory. A slurmstepd killed before it could unlink its socket
+ * generates no event, so callers still bound every wait.
+ */
+static void _stepd_watch_wait(int fd, int timeout_ms)
+{
+	char buf[sizeof(struct inotify_event) + NAME_MAX + 1];
+	struct pollfd pfd;
+
+	if (timeout_ms <= 0)
+		return;
+	if (fd < 0) {
+		usleep(timeout_ms * 1000);
+		return;
+	}
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	if ((poll(&pfd, 1, timeout_ms) < 0) && (errno != EINTR))
+		error("%s: poll: %m", __func__);
+
+	/* Only the wakeup matters, the caller checks the steps again */
+	while (read(fd, buf, sizeof(buf)) > 0)
+		;
+}
+
 static bool
 _steps_completed_now(uint32_t jobid)
 {
@@ -4800,6 +5234,13 @@ static int _epilog_complete(uint32_t jobid, int rc)
 	req.return_code = rc;
 	req.node_name = conf->node_name;
 
+	/*
+	 * SlurmdParameters=epilog_jitter=<msec>. All nodes of a job finish
+	 * their epilog at about the same time, spread the messages so a large
+	 * job does not open a connection per node to slurmctld at once.
+	 */
+	_node_jitter_delay(conf->epilog_jitter, "epilog complete");
+
 	msg.msg_type = MESSAGE_EPILOG_COMPLETE;
 	msg.data = &req;
 
@@ -5181,6 +5622,8 @@ _rpc_terminate_job(slurm_msg_t *msg)
 	int		delay;
 	int		node_id = 0;
 	job_env_t       job_env;
+	struct timeval  tv = { 0 };
+	int             kill_usec, epilog_usec = 0;
 
 	debug("%s: uid = %u %ps", __func__, msg->auth_uid, &req->step_id);
 	/*
@@ -5353,6 +5796,7 @@ _rpc_terminate_job(slurm_msg_t *msg)
 	/*
 	 *  Check for corpses
 	 */
+	(void) slurm_delta_tv(&tv);
 	delay = MAX(slurm_conf.kill_wait, 5);
 	if (!_pause_for_job_completion (req->step_id.job_id, req->nodes, delay) &&
 	    _terminate_all_steps(req->step_id.job_id, true) ) {
@@ -5361,6 +5805,7 @@ _rpc_terminate_job(slurm_msg_t *msg)
 		 */
 		_pause_for_job_completion (req->step_id.job_id, req->nodes, 0);
 	}
+	kill_usec = slurm_delta_tv(&tv);
 
 	/*
 	 *  Begin expiration period for cached information about job.
@@ -5395,7 +5840,10 @@ _rpc_terminate_job(slurm_msg_t *msg)
 	job_env.uid = req->job_uid;
 	job_env.gid = req->job_gid;
 
+	tv.tv_sec = 0;
+	(void) slurm_delta_tv(&tv);
 	rc = _run_epilog(&job_env, req->cred);
+	epilog_usec = slurm_delta_tv(&tv);
 	_free_job_env(&job_env);
 
 	if (rc) {
@@ -5412,7 +5860,12 @@ _rpc_terminate_job(slurm_msg_t *msg)
 	_launch_complete_rm(req->step_id.job_id);
 
 done:
+	tv.tv_sec = 0;
+	(void) slurm_delta_tv(&tv);
 	_wait_state_completed(req->step_id.job_id, 5);
+	debug("%s: JobId=%u teardown: kill %d usec, epilog %d usec, step exit %d usec",
+	      __func__, req->step_id.job_id, kill_usec, epilog_usec,
+	      slurm_delta_tv(&tv));
 	_waiter_complete(req->step_id.job_id);
 	_sync_messages_kill(req);
 
@@ -5550,48 +6003,43 @@ static void _waiter_complete(uint32_t jobid)
 static bool
 _pause_for_job_completion (uint32_t job_id, char *nodes, int max_time)
 {
-	int sec = 0;
-	int pause = 1;
+	/*
+	 * The job will usually finish up within the first .02 sec. If not,
+	 * gradually increase the wait until we get to a second. Removal of a
+	 * step's socket ends the wait early, so the delays only matter when
+	 * no such event arrives.
+	 */
+	static const int pause_ms[] = { 20, 50, 100, 500, 1000 };
+	struct timeval tv = { 0 };
+	int fd, inx = 0, wait_ms, elapsed_ms, kill_ms = 0;
 	bool rc = false;
-	int count = 0;
 
-	while ((sec < max_time) || (max_time == 0)) {
-		rc = _job_still_running (job_id);
-		if (!rc)
+	fd = _stepd_watch_init();
+	(void) slurm_delta_tv(&tv);
+	while ((rc = _job_still_running(job_id))) {
+		elapsed_ms = slurm_delta_tv(&tv) / 1000;
+		if (max_time && (elapsed_ms >= (max_time * 1000)))
 			break;
-		if ((max_time == 0) && (sec > 1)) {
+
+		wait_ms = pause_ms[inx];
+		if (inx < ((int) ARRAY_SIZE(pause_ms) - 1))
+			inx++;
+		/* Reduce logging frequency about unkillable tasks */
+		if (elapsed_ms > 10000)
+			wait_ms = 10000;
+
+		if (!max_time && (elapsed_ms > 1000) &&
+		    ((elapsed_ms - kill_ms) >= wait_ms)) {
 			_terminate_all_steps(job_id, true);
-		}
-		if (sec > 10) {
-			/* Reduce logging frequency about unkillable tasks */
-			if (max_time)
-				pause = MIN((max_time - sec), 10);
-			else
-				pause = 10;
+			kill_ms = elapsed_ms;
 		}
 
-		/*
-		 * The job will usually finish up within the first .02 sec.  If
-		 * not gradually increase the sleep until we get to a second.
-		 */
-		if (count == 0) {
-			usleep(20000);
-			count++;
-		} else if (count == 1) {
-			usleep(50000);
-			count++;
-		} else if (count == 2) {
-			usleep(100000);
-			count++;
-		} else if (count == 3) {
-			usleep(500000);
-			count++;
-			sec = 1;
-		} else {
-			sleep(pause);
-			sec += pause;
-		}
+		if (max_time)
+			wait_ms = MIN(wait_ms, (max_time * 1000) - elapsed_ms);
+		_stepd_watch_wait(fd, wait_ms);
 	}
+	if (fd >= 0)
+		close(fd);
 
 	/*
 	 * Return true if job is NOT running
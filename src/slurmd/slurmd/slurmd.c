@@ -129,6 +129,9 @@
 decl_static_data(usage_txt);
 
 #define MAX_THREADS		256
+#define MAX_EPILOG_JITTER	10000	/* milliseconds */
+#define MAX_REG_JITTER		300	/* seconds */
+#define MAX_STEPD_POOL		64
 
 #define _free_and_set(__dst, __src)		\
 	do {					\
@@ -832,8 +835,7 @@ _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 	msg->real_memory = conf->physical_memory_size;
 	msg->tmp_disk    = conf->tmp_disk_space;
 	msg->hash_val = slurm_conf.hash_val;
-	get_cpu_load(&msg->cpu_load);
-	get_free_mem(&msg->free_mem);
+	get_cpu_load_free_mem(&msg->cpu_load, &msg->free_mem);
 
 	gres_info = init_buf(1024);
 	if (gres_node_config_pack(gres_info) != SLURM_SUCCESS)
@@ -948,7 +950,7 @@ _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 static void
 _read_config(void)
 {
-	char *bcast_address;
+	char *bcast_address, *tmp_ptr;
 	slurm_conf_t *cf = NULL;
 	int cc;
 	bool cgroup_mem_confinement = false;
@@ -1212,6 +1214,36 @@ _read_config(void)
 	if (cc != -1)
 		conf->acct_freq_task = cc;
 
+	conf->epilog_jitter = 0;
+	if ((tmp_ptr = xstrcasestr(cf->slurmd_params, "epilog_jitter="))) {
+		cc = atoi(tmp_ptr + 14);
+		if ((cc < 0) || (cc > MAX_EPILOG_JITTER))
+			error("Invalid SlurmdParameters epilog_jitter:%d, ignoring",
+			      cc);
+		else
+			conf->epilog_jitter = cc;
+	}
+
+	conf->reg_jitter = 0;
+	if ((tmp_ptr = xstrcasestr(cf->slurmd_params, "reg_jitter="))) {
+		cc = atoi(tmp_ptr + 11);
+		if ((cc < 0) || (cc > MAX_REG_JITTER))
+			error("Invalid SlurmdParameters reg_jitter:%d, ignoring",
+			      cc);
+		else
+			conf->reg_jitter = cc;
+	}
+
+	conf->stepd_pool = 0;
+	if ((tmp_ptr = xstrcasestr(cf->slurmd_params, "stepd_pool="))) {
+		cc = atoi(tmp_ptr + 11);
+		if ((cc < 0) || (cc > MAX_STEPD_POOL))
+			error("Invalid SlurmdParameters stepd_pool:%d, ignoring",
+			      cc);
+		else
+			conf->stepd_pool = cc;
+	}
+
 	if (cf->control_addr == NULL)
 		fatal("Unable to establish controller machine");
 	if (cf->slurmctld_port == 0)
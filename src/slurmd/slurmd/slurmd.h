@@ -140,6 +140,12 @@ typedef struct slurmd_config {
 
 	pthread_mutex_t config_mutex;	/* lock for slurmd_config access   */
 	uint16_t        acct_freq_task;
+	uint16_t	epilog_jitter;	/* max msec to delay epilog complete
+					 * messages, 0 to disable */
+	uint16_t	reg_jitter;	/* max seconds to delay requested
+					 * registrations, 0 to disable */
+	uint16_t	stepd_pool;	/* number of slurmstepd to start
+					 * ahead of launch, 0 to disable */
 
 	list_t *starting_steps;		/* steps that are starting but cannot
 					   receive RPCs yet */
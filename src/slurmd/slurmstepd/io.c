@@ -56,6 +56,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -94,6 +95,7 @@ struct io_operations client_ops = {
 };
 
 #define CLIENT_IO_MAGIC 0x10102
+#define CLIENT_WRITE_IOV 64	/* Messages gathered per client write */
 struct client_io_info {
 	int                   magic;
 	stepd_step_rec_t *step; /* pointer back to step data */
@@ -426,13 +428,20 @@ _client_read(eio_obj_t *obj, List objs)
 
 /*
  * Write outgoing packed messages to the client socket.
+ *
+ * Each message carries at most MAX_MSG_LEN bytes of payload, so instead of
+ * one write() per message gather up to CLIENT_WRITE_IOV of the queued
+ * messages into a single writev().
  */
 static int
 _client_write(eio_obj_t *obj, List objs)
 {
 	struct client_io_info *client = (struct client_io_info *) obj->arg;
-	void *buf;
-	int n;
+	struct iovec iov[CLIENT_WRITE_IOV];
+	struct io_buf *msg;
+	list_itr_t *itr;
+	int iovcnt = 0;
+	ssize_t n;
 
 	xassert(client->magic == CLIENT_IO_MAGIC);
 
@@ -455,13 +464,25 @@ _client_write(eio_obj_t *obj, List objs)
 
 	debug5("  client->out_remaining = %d", client->out_remaining);
 
+	iov[iovcnt].iov_base = client->out_msg->data +
+		(client->out_msg->length - client->out_remaining);
+	iov[iovcnt].iov_len = client->out_remaining;
+	iovcnt++;
+
+	/* Queued messages are only dequeued once fully written below */
+	itr = list_iterator_create(client->msg_queue);
+	while ((iovcnt < CLIENT_WRITE_IOV) && (msg = list_next(itr))) {
+		iov[iovcnt].iov_base = msg->data;
+		iov[iovcnt].iov_len = msg->length;
+		iovcnt++;
+	}
+	list_iterator_destroy(itr);
+
 	/*
-	 * Write message to socket.
+	 * Write messages to socket.
 	 */
-	buf = client->out_msg->data +
-		(client->out_msg->length - client->out_remaining);
 again:
-	if ((n = write(obj->fd, buf, client->out_remaining)) < 0) {
+	if ((n = writev(obj->fd, iov, iovcnt)) < 0) {
 		if (errno == EINTR) {
 			goto again;
 		} else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
@@ -474,17 +495,22 @@ again:
 			return SLURM_SUCCESS;
 		}
 	}
-	if (n < client->out_remaining) {
-		error("Only wrote %d of %d bytes to socket",
-		      n, client->out_remaining);
-	} else
-		debug5("Wrote %d bytes to socket", n);
-	client->out_remaining -= n;
-	if (client->out_remaining > 0)
-		return SLURM_SUCCESS;
+	debug5("Wrote %zd bytes in %d messages to socket", n, iovcnt);
+
+	while (n > 0) {
+		if (n < client->out_remaining) {
+			client->out_remaining -= n;
+			break;
+		}
 
-	_free_outgoing_msg(client->out_msg, client->step);
-	client->out_msg = NULL;
+		n -= client->out_remaining;
+		_free_outgoing_msg(client->out_msg, client->step);
+		client->out_msg = NULL;
+
+		if (!n || !(client->out_msg = list_dequeue(client->msg_queue)))
+			break;
+		client->out_remaining = client->out_msg->length;
+	}
 
 	return SLURM_SUCCESS;
 }
@@ -507,6 +533,71 @@ _local_file_writable(eio_obj_t *obj)
 }
 
 
+/*
+ * Without labels the payloads can go to the file as they are, so gather
+ * client->out_msg and the data messages queued behind it into a single
+ * writev() instead of issuing one small write per message. A zero-length
+ * (eof) message ends the batch and is handled by the next call.
+ */
+static int _local_file_write_batch(eio_obj_t *obj)
+{
+	struct client_io_info *client = (struct client_io_info *) obj->arg;
+	struct iovec iov[CLIENT_WRITE_IOV];
+	struct io_buf *msg;
+	list_itr_t *itr;
+	io_hdr_t header;
+	buf_t *header_tmp_buf;
+	int hdr_size = io_hdr_packed_size();
+	int iovcnt = 0;
+	ssize_t n;
+
+	iov[iovcnt].iov_base = client->out_msg->data +
+		(client->out_msg->length - client->out_remaining);
+	iov[iovcnt].iov_len = client->out_remaining;
+	iovcnt++;
+
+	itr = list_iterator_create(client->msg_queue);
+	while ((iovcnt < CLIENT_WRITE_IOV) && (msg = list_next(itr))) {
+		header_tmp_buf = create_buf(msg->data, msg->length);
+		io_hdr_unpack(&header, header_tmp_buf);
+		header_tmp_buf->head = NULL;
+		FREE_NULL_BUFFER(header_tmp_buf);
+		if (header.length == 0)
+			break;
+
+		iov[iovcnt].iov_base = msg->data + hdr_size;
+		iov[iovcnt].iov_len = msg->length - hdr_size;
+		iovcnt++;
+	}
+	list_iterator_destroy(itr);
+
+again:
+	if ((n = writev(obj->fd, iov, iovcnt)) < 0) {
+		if ((errno == EINTR) || (errno == EAGAIN) ||
+		    (errno == EWOULDBLOCK))
+			goto again;
+		client->out_eof = true;
+		_free_all_outgoing_msgs(client->msg_queue, client->step);
+		return SLURM_ERROR;
+	}
+
+	/* Release the messages fully written, they are in queue order */
+	while (n >= client->out_remaining) {
+		n -= client->out_remaining;
+		_free_outgoing_msg(client->out_msg, client->step);
+		client->out_msg = NULL;
+
+		if (--iovcnt == 0)
+			break;
+		client->out_msg = list_dequeue(client->msg_queue);
+		client->out_remaining = client->out_msg->length - hdr_size;
+	}
+	if (client->out_msg)
+		client->out_remaining -= n;
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * The slurmstepd writes I/O to a file, possibly adding a label.
  */
@@ -557,6 +648,9 @@ _local_file_write(eio_obj_t *obj, List objs)
 		return SLURM_SUCCESS;
 	}
 
+	if (!client->labelio)
+		return _local_file_write_batch(obj);
+
 	/* Write the message to the file. */
 	buf = client->out_msg->data +
 		(client->out_msg->length - client->out_remaining);
@@ -82,6 +82,7 @@
 #include "src/common/fd.h"
 #include "src/common/forward.h"
 #include "src/common/hostlist.h"
+#include "src/common/job_trace.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
 #include "src/common/reverse_tree.h"
@@ -1289,7 +1290,9 @@ job_manager(stepd_step_rec_t *step)
 	int  rc = SLURM_SUCCESS;
 	bool io_initialized = false;
 	char *oom_val_str;
+	job_trace_span_t span;
 
+	job_trace_start(&span);
 	debug3("Entered job_manager for %ps pid=%d",
 	       &step->step_id, step->jmgr_pid);
 
@@ -1411,6 +1414,8 @@ job_manager(stepd_step_rec_t *step)
 	if ((rc != SLURM_SUCCESS) || !io_initialized)
 		goto fail3;
 
+	job_trace_end(&span, step->step_id.job_id,
+		      step->batch ? "stepd_batch_exec" : "stepd_task_exec");
 	io_close_task_fds(step);
 
 	/* Attach slurmstepd to system cgroups, if configured */
@@ -1820,6 +1825,8 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 	jobacct_id_t jobacct_id;
 	List exec_wait_list = NULL;
 	uint32_t node_offset = 0, task_offset = 0;
+	struct timeval fork_tv = { 0 }, setup_tv = { 0 }, release_tv = { 0 };
+	int fork_usec, setup_usec, release_usec;
 
 	if (step->het_job_node_offset != NO_VAL)
 		node_offset = step->het_job_node_offset;
@@ -1952,6 +1959,7 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 	 * Fork all of the task processes.
 	 */
 	verbose("starting %u tasks", step->node_tasks);
+	(void) slurm_delta_tv(&fork_tv);
 	for (i = 0; i < step->node_tasks; i++) {
 		char time_stamp[256];
 		pid_t pid;
@@ -2045,6 +2053,8 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 	 * All tasks are now forked and running as the user, but
 	 * will wait for our signal before calling exec.
 	 */
+	fork_usec = slurm_delta_tv(&fork_tv);
+	(void) slurm_delta_tv(&setup_tv);
 
 	/*
 	 * Reclaim privileges
@@ -2126,12 +2136,18 @@ _fork_all_tasks(stepd_step_rec_t *step, bool *io_initialized)
 		}
 	}
 //	jobacct_gather_set_proctrack_container_id(step->cont_id);
+	setup_usec = slurm_delta_tv(&setup_tv);
 
 	/*
 	 * Now it's ok to unblock the tasks, so they may call exec.
 	 */
+	(void) slurm_delta_tv(&release_tv);
 	list_for_each (exec_wait_list, (ListForF) exec_wait_signal, step);
 	FREE_NULL_LIST (exec_wait_list);
+	release_usec = slurm_delta_tv(&release_tv);
+
+	debug("%s: %u tasks: fork usec=%d setup usec=%d release usec=%d",
+	      __func__, step->node_tasks, fork_usec, setup_usec, release_usec);
 
 	for (i = 0; i < step->node_tasks; i++) {
 		/*
@@ -306,7 +306,14 @@ static slurmd_conf_t *_read_slurmd_conf_lite(int fd)
 		confl = local_conf;
 	}
 
-	safe_read(fd, &len, sizeof(int));
+	/*
+	 * A slurmstepd pre-started by slurmd (SlurmdParameters=stepd_pool)
+	 * gets EOF here if slurmd exits without using it.
+	 */
+	if (!(rc = read(fd, &len, sizeof(int))))
+		_exit(0);
+	else if (rc != sizeof(int))
+		goto rwfail;
 
 	buffer = init_buf(len);
 	safe_read(fd, buffer->head, len);
@@ -1103,11 +1103,39 @@ static int _get_instances(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 	return rc;
 }
 
+/*
+ * Same wire format as slurmdbd_pack_list_msg() for DBD_GOT_JOBS, but free each
+ * job record as soon as it is packed so that a large result is not held in
+ * memory twice (as records and as packed buffer) at the same time.
+ * job_list is emptied.
+ */
+static void _pack_jobs_consume(List job_list, uint16_t rpc_version,
+			       buf_t *buffer)
+{
+	uint32_t header_position = get_buf_offset(buffer);
+	uint32_t rc = SLURM_SUCCESS;
+	slurmdb_job_rec_t *job;
+
+	pack32(list_count(job_list), buffer);
+	while ((job = list_pop(job_list))) {
+		slurmdb_pack_job_rec(job, rpc_version, buffer);
+		slurmdb_destroy_job_rec(job);
+		if (get_buf_offset(buffer) > REASONABLE_BUF_SIZE) {
+			error("%s: size limit exceeded", __func__);
+			set_buf_offset(buffer, header_position);
+			pack32(NO_VAL, buffer);
+			rc = ESLURM_RESULT_TOO_LARGE;
+			break;
+		}
+	}
+	pack32(rc, buffer);
+}
+
 static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			  buf_t **out_buffer)
 {
 	dbd_cond_msg_t *cond_msg = msg->data;
-	dbd_list_msg_t list_msg = { NULL };
+	List job_list;
 	slurmdb_job_cond_t *job_cond = cond_msg->cond;
 	int rc = SLURM_SUCCESS;
 
@@ -1148,17 +1176,17 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 		}
 	}
 
-	list_msg.my_list = jobacct_storage_g_get_jobs_cond(
+	job_list = jobacct_storage_g_get_jobs_cond(
 		slurmdbd_conn->db_conn, slurmdbd_conn->conn->auth_uid,
 		job_cond);
 
 	if (!errno) {
-		if (!list_msg.my_list)
-			list_msg.my_list = list_create(NULL);
+		if (!job_list)
+			job_list = list_create(NULL);
 		*out_buffer = init_buf(1024);
 		pack16((uint16_t) DBD_GOT_JOBS, *out_buffer);
-		slurmdbd_pack_list_msg(&list_msg, slurmdbd_conn->conn->version,
-				       DBD_GOT_JOBS, *out_buffer);
+		_pack_jobs_consume(job_list, slurmdbd_conn->conn->version,
+				   *out_buffer);
 	} else {
 		*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
 							errno,
@@ -1167,7 +1195,7 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 		rc = SLURM_ERROR;
 	}
 
-	FREE_NULL_LIST(list_msg.my_list);
+	FREE_NULL_LIST(job_list);
 
 	return rc;
 }
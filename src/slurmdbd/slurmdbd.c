@@ -57,6 +57,7 @@
 #include "src/common/fd.h"
 #include "src/common/log.h"
 #include "src/common/proc_args.h"
+#include "src/common/openmetrics.h"
 #include "src/common/read_config.h"
 #include "src/interfaces/accounting_storage.h"
 #include "src/interfaces/auth.h"
@@ -109,6 +110,7 @@ static void  _commit_handler_cancel(void);
 static void *_commit_handler(void *no_data);
 static void  _daemonize(void);
 static void  _init_config(void);
+static void  _init_metrics(void);
 static void  _init_pidfile(void);
 static void  _kill_old_slurmdbd(void);
 static void  _parse_commandline(int argc, char **argv);
@@ -185,6 +187,8 @@ int main(int argc, char **argv)
 	/* Create attached thread for signal handling */
 	slurm_thread_create(&signal_handler_thread, _signal_handler, NULL);
 
+	_init_metrics();
+
 	registered_clusters = list_create(NULL);
 
 	slurm_thread_create(&commit_handler_thread, _commit_handler, NULL);
@@ -424,6 +428,126 @@ extern void init_dbd_stats(void)
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
+static const char *rollup_names[DBD_ROLLUP_COUNT] = {
+	"hour", "day", "month"
+};
+
+/* Dump the RPC and rollup statistics in OpenMetrics format */
+static void _dump_metrics(char **out, char **pos)
+{
+	char *cnt = NULL, *cnt_pos = NULL, *usec = NULL, *usec_pos = NULL;
+	char *labels = NULL;
+	slurmdb_rpc_obj_t *rpc_obj;
+	slurmdb_rollup_stats_t *rollup_stats;
+	list_itr_t *itr;
+
+	slurm_mutex_lock(&rpc_mutex);
+
+	openmetrics_metric(out, pos, "slurmdbd_stats_start_seconds",
+			   OPENMETRICS_GAUGE,
+			   "Time statistics collection started",
+			   rpc_stats.time_start);
+
+	itr = list_iterator_create(rpc_stats.rpc_list);
+	while ((rpc_obj = list_next(itr))) {
+		xstrfmtcat(labels, "type=\"%s\"",
+			   slurmdbd_msg_type_2_str(rpc_obj->id, 1));
+		openmetrics_sample(&cnt, &cnt_pos, "slurmdbd_rpc",
+				   OPENMETRICS_COUNTER, labels, rpc_obj->cnt);
+		openmetrics_sample(&usec, &usec_pos,
+				   "slurmdbd_rpc_microseconds",
+				   OPENMETRICS_COUNTER, labels, rpc_obj->time);
+		xfree(labels);
+	}
+	list_iterator_destroy(itr);
+	openmetrics_family(out, pos, "slurmdbd_rpc", OPENMETRICS_COUNTER,
+			   "Number of RPCs processed by message type");
+	if (cnt)
+		xstrcatat(*out, pos, cnt);
+	openmetrics_family(out, pos, "slurmdbd_rpc_microseconds",
+			   OPENMETRICS_COUNTER,
+			   "Time spent processing RPCs by message type");
+	if (usec)
+		xstrcatat(*out, pos, usec);
+	xfree(cnt);
+	xfree(usec);
+	cnt_pos = usec_pos = NULL;
+
+	itr = list_iterator_create(rpc_stats.user_list);
+	while ((rpc_obj = list_next(itr))) {
+		xstrfmtcat(labels, "uid=\"%u\"", rpc_obj->id);
+		openmetrics_sample(&cnt, &cnt_pos, "slurmdbd_rpc_user",
+				   OPENMETRICS_COUNTER, labels, rpc_obj->cnt);
+		openmetrics_sample(&usec, &usec_pos,
+				   "slurmdbd_rpc_user_microseconds",
+				   OPENMETRICS_COUNTER, labels, rpc_obj->time);
+		xfree(labels);
+	}
+	list_iterator_destroy(itr);
+	openmetrics_family(out, pos, "slurmdbd_rpc_user", OPENMETRICS_COUNTER,
+			   "Number of RPCs processed by user");
+	if (cnt)
+		xstrcatat(*out, pos, cnt);
+	openmetrics_family(out, pos, "slurmdbd_rpc_user_microseconds",
+			   OPENMETRICS_COUNTER,
+			   "Time spent processing RPCs by user");
+	if (usec)
+		xstrcatat(*out, pos, usec);
+	xfree(cnt);
+	xfree(usec);
+	cnt_pos = usec_pos = NULL;
+
+	itr = list_iterator_create(rpc_stats.rollup_stats);
+	while ((rollup_stats = list_next(itr))) {
+		for (int i = 0; i < DBD_ROLLUP_COUNT; i++) {
+			xstrfmtcat(labels, "cluster=\"%s\",period=\"%s\"",
+				   rollup_stats->cluster_name,
+				   rollup_names[i]);
+			openmetrics_sample(&cnt, &cnt_pos, "slurmdbd_rollup",
+					   OPENMETRICS_COUNTER, labels,
+					   rollup_stats->count[i]);
+			openmetrics_sample(&usec, &usec_pos,
+					   "slurmdbd_rollup_microseconds",
+					   OPENMETRICS_COUNTER, labels,
+					   rollup_stats->time_total[i]);
+			xfree(labels);
+		}
+	}
+	list_iterator_destroy(itr);
+
+	slurm_mutex_unlock(&rpc_mutex);
+
+	openmetrics_family(out, pos, "slurmdbd_rollup", OPENMETRICS_COUNTER,
+			   "Number of usage rollups by cluster and period");
+	if (cnt)
+		xstrcatat(*out, pos, cnt);
+	openmetrics_family(out, pos, "slurmdbd_rollup_microseconds",
+			   OPENMETRICS_COUNTER,
+			   "Time spent in usage rollups by cluster and period");
+	if (usec)
+		xstrcatat(*out, pos, usec);
+	xfree(cnt);
+	xfree(usec);
+}
+
+/* Serve the statistics in OpenMetrics format if Parameters=metrics_port */
+static void _init_metrics(void)
+{
+	uint16_t port;
+	int fd;
+
+	if (!(port = openmetrics_parse_port(slurmdbd_conf->parameters)))
+		return;
+
+	if ((fd = slurm_init_msg_engine_port(port)) < 0) {
+		error("%s: unable to listen on metrics port %hu: %m",
+		      __func__, port);
+		return;
+	}
+
+	(void) openmetrics_listen(fd, _dump_metrics);
+}
+
 /* Reset some of the processes resource limits to the hard limits */
 static void  _init_config(void)
 {
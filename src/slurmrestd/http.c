@@ -701,12 +701,6 @@ static int _on_message_complete(http_parser *parser)
 	if ((rc = _on_message_complete_request(parser, method, request)))
 		return rc;
 
-	if (request->keep_alive) {
-		//TODO: implement keep alive correctly
-		log_flag(NET, "%s: [%s] keep alive not currently implemented",
-			 __func__, conmgr_fd_get_name(request->context->con));
-	}
-
 	if (!request->connection_close) {
 		/*
 		 * Create a new HTTP request to allow persistent connections to
@@ -729,6 +723,13 @@ static int _on_message_complete(http_parser *parser)
 		request->context->request = NULL;
 		_free_request_t(request);
 		parser->data = NULL;
+
+		/*
+		 * Client may have already pipelined more requests in the same
+		 * buffer. Stop the parser here as there is no request to parse
+		 * them into and no connection to respond on.
+		 */
+		http_parser_pause(parser, 1);
 	}
 
 	return 0;
@@ -798,6 +799,14 @@ extern int parse_http(conmgr_fd_t *con, void *x)
 		 __func__, conmgr_fd_get_name(con), bytes_parsed,
 		 bytes_incoming);
 
+	if (!context->request &&
+	    (HTTP_PARSER_ERRNO(parser) == HPE_PAUSED)) {
+		log_flag(NET, "%s: [%s] discarding %zu bytes after connection close",
+			 __func__, conmgr_fd_get_name(con),
+			 (bytes_incoming - bytes_parsed));
+		bytes_parsed = bytes_incoming;
+	}
+
 	if (bytes_parsed > 0)
 		conmgr_fd_mark_consumed_in_buffer(con, bytes_parsed);
 	else if (parser->http_errno) {
@@ -2248,7 +2248,8 @@ extern int wrap_openapi_ctxt_callback(const char *context_id,
 				      int tag, data_t *resp, void *auth,
 				      data_parser_t *parser,
 				      const openapi_path_binding_t *op_path,
-				      const openapi_resp_meta_t *plugin_meta)
+				      const openapi_resp_meta_t *plugin_meta,
+				      time_t *update_time)
 {
 	int rc;
 	openapi_ctxt_t ctxt = {
@@ -2258,6 +2259,7 @@ extern int wrap_openapi_ctxt_callback(const char *context_id,
 		.query = query,
 		.resp = resp,
 		.tag = tag,
+		.if_none_match = *update_time,
 	};
 	openapi_resp_meta_t query_meta = {{0}};
 	openapi_ctxt_handler_t callback = op_path->callback;
@@ -2305,6 +2307,8 @@ extern int wrap_openapi_ctxt_callback(const char *context_id,
 	if (!rc)
 		rc = ctxt.rc;
 
+	*update_time = ctxt.last_update;
+
 	FREE_NULL_LIST(ctxt.errors);
 	FREE_NULL_LIST(ctxt.warnings);
 	FREE_NULL_DATA_PARSER(ctxt.parser);
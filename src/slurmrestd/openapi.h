@@ -63,6 +63,10 @@ typedef struct {
 	data_t *resp;
 	data_t *parent_path;
 	int tag;
+	/* update time sent by client in If-None-Match or 0 */
+	time_t if_none_match;
+	/* update time of response to send as ETag or 0 for none */
+	time_t last_update;
 } openapi_ctxt_t;
 
 /*
@@ -205,14 +209,19 @@ extern void destroy_openapi(void);
  */
 extern void *openapi_get_db_conn(void *ctxt);
 
-/* Wraps ctxt callback to apply standardised response schema */
+/*
+ * Wraps ctxt callback to apply standardised response schema
+ * IN/OUT update_time - IN: update time from client's If-None-Match or 0
+ *	OUT: update time of response to send as ETag or 0
+ */
 extern int wrap_openapi_ctxt_callback(const char *context_id,
 				      http_request_method_t method,
 				      data_t *parameters, data_t *query,
 				      int tag, data_t *resp, void *auth,
 				      data_parser_t *parser,
 				      const openapi_path_binding_t *op_path,
-				      const openapi_resp_meta_t *plugin_meta);
+				      const openapi_resp_meta_t *plugin_meta,
+				      time_t *update_time);
 
 /*
  * Macro to make a single response dumping easy
@@ -601,6 +601,43 @@ static int _resolve_mime(on_http_request_args_t *args, const char **read_mime,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Extract update time from If-None-Match header (RFC#7232 Section:3.2)
+ * containing ETags previously sent by _call_handler().
+ * RET newest update time found or 0 if none
+ */
+static time_t _parse_if_none_match(on_http_request_args_t *args)
+{
+	const char *header = find_http_header(args->headers, "If-None-Match");
+	char *buffer, *token, *save_ptr = NULL;
+	time_t update_time = 0;
+
+	if (!header || (args->method != HTTP_REQUEST_GET))
+		return 0;
+
+	buffer = xstrdup(header);
+	token = strtok_r(buffer, ",", &save_ptr);
+	while (token) {
+		long long value;
+
+		xstrtrim(token);
+		if (!xstrncmp(token, "W/", 2))
+			token += 2;
+
+		if ((sscanf(token, "\"%lld\"", &value) == 1) &&
+		    (value > update_time))
+			update_time = value;
+
+		token = strtok_r(NULL, ",", &save_ptr);
+	}
+	xfree(buffer);
+
+	debug4("%s: [%s] If-None-Match: %s resolved to update_time=%ld",
+	       __func__, _name(args), header, update_time);
+
+	return update_time;
+}
+
 static int _call_handler(on_http_request_args_t *args, data_t *params,
 			 data_t *query, openapi_handler_t callback,
 			 const openapi_path_binding_t *op_path,
@@ -610,8 +647,13 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 {
 	int rc;
 	data_t *resp = data_new();
-	char *body = NULL;
+	char *body = NULL, *etag = NULL;
 	http_status_code_t e;
+	time_t update_time = 0;
+	http_header_entry_t etag_header = {
+		.name = "ETag",
+	};
+	list_t *headers = list_create(NULL);
 
 	if (callback) {
 		xassert(!op_path);
@@ -627,10 +669,23 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 		       __func__, _name(args), (uintptr_t) op_path->callback,
 		       callback_tag, args->path);
 
+		update_time = _parse_if_none_match(args);
+
 		rc = wrap_openapi_ctxt_callback(_name(args), args->method,
 						params, query, callback_tag,
 						resp, args->context->auth,
-						parser, op_path, meta);
+						parser, op_path, meta,
+						&update_time);
+	}
+
+	/*
+	 * Weak ETag as the response meta differs per client but the data
+	 * only changes when slurmctld's update time changes
+	 */
+	if (update_time) {
+		etag = xstrdup_printf("W/\"%ld\"", update_time);
+		etag_header.value = etag;
+		list_append(headers, &etag_header);
 	}
 
 	/*
@@ -639,7 +694,8 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	 */
 	FREE_NULL_REST_AUTH(args->context->auth);
 
-	if (data_get_type(resp) != DATA_TYPE_NULL) {
+	if ((rc != SLURM_NO_CHANGE_IN_DATA) &&
+	    (data_get_type(resp) != DATA_TYPE_NULL)) {
 		int rc2;
 		serializer_flags_t sflags = SER_FLAGS_PRETTY;
 
@@ -664,6 +720,7 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 		 */
 		send_http_response_args_t send_args = {
 			.con = args->context->con,
+			.headers = headers,
 			.http_major = args->http_major,
 			.http_minor = args->http_minor,
 			.status_code = HTTP_STATUS_CODE_REDIRECT_NOT_MODIFIED,
@@ -688,6 +745,7 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	} else {
 		send_http_response_args_t send_args = {
 			.con = args->context->con,
+			.headers = headers,
 			.http_major = args->http_major,
 			.http_minor = args->http_minor,
 			.status_code = HTTP_STATUS_CODE_SUCCESS_OK,
@@ -711,6 +769,8 @@ static int _call_handler(on_http_request_args_t *args, data_t *params,
 	       get_http_status_code_string(e));
 
 	xfree(body);
+	xfree(etag);
+	FREE_NULL_LIST(headers);
 	FREE_NULL_DATA(resp);
 
 	return rc;
@@ -54,6 +54,7 @@
 #include "slurm/slurmdb.h"
 
 #include "src/common/data.h"
+#include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/interfaces/auth.h"
 #include "src/common/uid.h"
@@ -95,9 +96,14 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
 extern int slurm_rest_auth_p_apply(rest_auth_context_t *context);
 
+/* Max number of idle slurmdbd connections kept for reuse */
+#define MAX_POOLED_DB_CONNS 16
+
 static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
 /* protected by lock */
 static bool become_user = false;
+/* protected by lock: list of pooled_db_conn_t */
+static list_t *db_conn_pool = NULL;
 
 #define MAGIC 0xd11abee2
 typedef struct {
@@ -105,6 +111,76 @@ typedef struct {
 	void *db_conn;
 } plugin_data_t;
 
+typedef struct {
+	char *user_name; /* user that opened the connection */
+	void *db_conn;
+} pooled_db_conn_t;
+
+static void _free_pooled_db_conn(void *x)
+{
+	pooled_db_conn_t *pooled = x;
+
+	slurmdb_connection_close(&pooled->db_conn);
+	xfree(pooled->user_name);
+	xfree(pooled);
+}
+
+static int _match_pooled_db_conn(void *x, void *key)
+{
+	pooled_db_conn_t *pooled = x;
+
+	return !xstrcmp(pooled->user_name, key);
+}
+
+/* Take idle connection opened by the same user or NULL if none */
+static void *_pool_get_db_conn(const char *user_name)
+{
+	pooled_db_conn_t *pooled;
+	void *db_conn = NULL;
+
+	slurm_mutex_lock(&lock);
+	if (db_conn_pool &&
+	    (pooled = list_remove_first(db_conn_pool, _match_pooled_db_conn,
+					(void *) user_name))) {
+		db_conn = pooled->db_conn;
+		xfree(pooled->user_name);
+		xfree(pooled);
+	}
+	slurm_mutex_unlock(&lock);
+
+	return db_conn;
+}
+
+/*
+ * Return connection to pool for reuse by the same user
+ * RET true if connection was pooled or false if caller must close it
+ */
+static bool _pool_put_db_conn(const char *user_name, void *db_conn)
+{
+	pooled_db_conn_t *pooled;
+
+	/* rollback anything left uncommitted by the last request */
+	if (!user_name || slurmdb_connection_commit(db_conn, false))
+		return false;
+
+	slurm_mutex_lock(&lock);
+	if (!db_conn_pool)
+		db_conn_pool = list_create(_free_pooled_db_conn);
+
+	if (list_count(db_conn_pool) >= MAX_POOLED_DB_CONNS) {
+		slurm_mutex_unlock(&lock);
+		return false;
+	}
+
+	pooled = xmalloc(sizeof(*pooled));
+	pooled->user_name = xstrdup(user_name);
+	pooled->db_conn = db_conn;
+	list_append(db_conn_pool, pooled);
+	slurm_mutex_unlock(&lock);
+
+	return true;
+}
+
 extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 {
 	plugin_data_t *data = context->plugin_data;
@@ -117,6 +193,9 @@ extern void *slurm_rest_auth_p_get_db_conn(rest_auth_context_t *context)
 	if (data->db_conn)
 		return data->db_conn;
 
+	if ((data->db_conn = _pool_get_db_conn(context->user_name)))
+		return data->db_conn;
+
 	errno = 0;
 	data->db_conn = slurmdb_connection_get(NULL);
 
@@ -351,7 +430,8 @@ extern void slurm_rest_auth_p_free(rest_auth_context_t *context)
 	xassert(context->plugin_id == plugin_id);
 	data->magic = ~MAGIC;
 
-	if (data->db_conn)
+	if (data->db_conn &&
+	    !_pool_put_db_conn(context->user_name, data->db_conn))
 		slurmdb_connection_close(&data->db_conn);
 
 	xfree(context->plugin_data);
@@ -378,5 +458,9 @@ extern void slurm_rest_auth_p_init(bool bu)
 
 extern void slurm_rest_auth_p_fini(void)
 {
+	slurm_mutex_lock(&lock);
+	FREE_NULL_LIST(db_conn_pool);
+	slurm_mutex_unlock(&lock);
+
 	debug5("%s: REST local auth deactivated", __func__);
 }
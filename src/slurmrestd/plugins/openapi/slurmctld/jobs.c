@@ -89,8 +89,19 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 	if (!query.show_flags)
 		query.show_flags = SHOW_ALL | SHOW_DETAIL;
 
-	rc = slurm_load_jobs(query.update_time, &job_info_ptr,
-			     query.show_flags);
+	/* conditional GET via If-None-Match */
+	if (!query.update_time && ctxt->if_none_match) {
+		rc = slurm_load_jobs(ctxt->if_none_match, &job_info_ptr,
+				     query.show_flags);
+
+		if (rc == SLURM_NO_CHANGE_IN_DATA) {
+			ctxt->last_update = ctxt->if_none_match;
+			return rc;
+		}
+	} else {
+		rc = slurm_load_jobs(query.update_time, &job_info_ptr,
+				     query.show_flags);
+	}
 
 	if (rc == SLURM_NO_CHANGE_IN_DATA) {
 		char ts[32] = {0};
@@ -106,6 +117,7 @@ extern int op_handler_jobs(openapi_ctxt_t *ctxt)
 		resp.last_backfill = job_info_ptr->last_backfill;
 		resp.last_update = job_info_ptr->last_update;
 		resp.jobs = job_info_ptr;
+		ctxt->last_update = job_info_ptr->last_update;
 	}
 
 	DATA_DUMP(ctxt->parser, OPENAPI_JOB_INFO_RESP, resp, ctxt->resp);
@@ -63,18 +63,26 @@ extern int op_handler_partitions(openapi_ctxt_t *ctxt)
 		goto done;
 	}
 
+	/* conditional GET via If-None-Match */
+	if (!query.update_time && ctxt->if_none_match)
+		query.update_time = ctxt->if_none_match;
+
 	errno = 0;
 	if ((rc = slurm_load_partitions(query.update_time, &part_info_ptr,
 					query.show_flags))) {
 		if ((rc == SLURM_ERROR) && errno)
 			rc = errno;
 
+		if (rc == SLURM_NO_CHANGE_IN_DATA)
+			ctxt->last_update = query.update_time;
+
 		goto done;
 	}
 
 	if (part_info_ptr) {
 		resp.last_update = part_info_ptr->last_update;
 		resp.partitions = part_info_ptr;
+		ctxt->last_update = part_info_ptr->last_update;
 	}
 
 	DATA_DUMP(ctxt->parser, OPENAPI_PARTITION_RESP, resp, ctxt->resp);
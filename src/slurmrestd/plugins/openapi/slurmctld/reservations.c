@@ -65,11 +65,20 @@ extern int op_handler_reservations(openapi_ctxt_t *ctxt)
 		goto done;
 	}
 
+	/* conditional GET via If-None-Match */
+	if (!query.update_time && ctxt->if_none_match)
+		query.update_time = ctxt->if_none_match;
+
 	errno = 0;
 	if ((rc = slurm_load_reservations(query.update_time, &res_info_ptr))) {
 		if (rc == SLURM_ERROR)
 			rc = errno;
 
+		if (rc == SLURM_NO_CHANGE_IN_DATA) {
+			ctxt->last_update = query.update_time;
+			goto done;
+		}
+
 		resp_error(ctxt, rc, "slurm_load_reservations()",
 			   "Unable to query reservations");
 
@@ -79,6 +88,7 @@ extern int op_handler_reservations(openapi_ctxt_t *ctxt)
 	if (res_info_ptr) {
 		resp.last_update = res_info_ptr->last_update;
 		resp.reservations = res_info_ptr;
+		ctxt->last_update = res_info_ptr->last_update;
 	}
 
 	DATA_DUMP(ctxt->parser, OPENAPI_RESERVATION_RESP, resp, ctxt->resp);
@@ -283,6 +283,71 @@ cleanup:
 	return rc;
 }
 
+static int _cmp_uint32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+/* Sort (job_id, index) pairs by job_id, then by position in the response */
+static int _cmp_job_idx(const void *a, const void *b)
+{
+	const uint32_t *x = a, *y = b;
+	int rc = _cmp_uint32(&x[0], &y[0]);
+
+	if (!rc)
+		rc = _cmp_uint32(&x[1], &y[1]);
+	return rc;
+}
+
+/*
+ * Load only the jobs named with --jobs rather than every job in the system.
+ * An array or heterogeneous job ID brings all of its records, so a request
+ * naming both an array and one of its tasks gets that task twice; drop the
+ * repeat the same way federated loads drop duplicates, by zeroing its ID.
+ */
+static int _load_job_list(job_info_msg_t **job_pptr, uint16_t show_flags)
+{
+	job_state_args_t args = { 0 };
+	uint32_t *seen;
+	int cnt = 0, rc;
+
+	args.job_ids_count = list_count(params.job_list);
+	args.job_ids = xcalloc(args.job_ids_count, sizeof(*args.job_ids));
+	if (list_for_each_ro(params.job_list, _foreach_add_job, &args) < 0)
+		fatal("list job_ids should not fail");
+
+	qsort(args.job_ids, args.job_ids_count, sizeof(*args.job_ids),
+	      _cmp_uint32);
+	for (int i = 0; i < args.job_ids_count; i++) {
+		if (!cnt || (args.job_ids[i] != args.job_ids[cnt - 1]))
+			args.job_ids[cnt++] = args.job_ids[i];
+	}
+
+	rc = slurm_load_job_list(job_pptr, cnt, args.job_ids, show_flags);
+	xfree(args.job_ids);
+
+	if (rc || (show_flags & SHOW_SIBLING) ||
+	    ((*job_pptr)->record_count < 2))
+		return rc;
+
+	seen = xcalloc(((*job_pptr)->record_count * 2), sizeof(*seen));
+	for (int i = 0; i < (*job_pptr)->record_count; i++) {
+		seen[i * 2] = (*job_pptr)->job_array[i].job_id;
+		seen[(i * 2) + 1] = i;
+	}
+	qsort(seen, (*job_pptr)->record_count, (sizeof(*seen) * 2),
+	      _cmp_job_idx);
+	for (int i = 1; i < (*job_pptr)->record_count; i++) {
+		if (seen[i * 2] && (seen[i * 2] == seen[(i - 1) * 2]))
+			(*job_pptr)->job_array[seen[(i * 2) + 1]].job_id = 0;
+	}
+	xfree(seen);
+
+	return rc;
+}
+
 /* _print_job - print the specified job's information */
 static int _print_job(bool clear_old, bool log_cluster_name, int argc,
 		      char **argv)
@@ -312,6 +377,8 @@ static int _print_job(bool clear_old, bool log_cluster_name, int argc,
 			error_code = slurm_load_job(
 				&new_job_ptr, params.job_id,
 				show_flags);
+		} else if (params.job_list && list_count(params.job_list)) {
+			error_code = _load_job_list(&new_job_ptr, show_flags);
 		} else if (params.user_id) {
 			error_code = slurm_load_job_user(&new_job_ptr,
 							 params.user_id,
@@ -334,6 +401,8 @@ static int _print_job(bool clear_old, bool log_cluster_name, int argc,
 	} else if (params.job_id) {
 		error_code = slurm_load_job(&new_job_ptr, params.job_id,
 					    show_flags);
+	} else if (params.job_list && list_count(params.job_list)) {
+		error_code = _load_job_list(&new_job_ptr, show_flags);
 	} else if (params.user_id) {
 		error_code = slurm_load_job_user(&new_job_ptr, params.user_id,
 						 show_flags);
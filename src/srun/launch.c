@@ -136,38 +136,43 @@ static char *_hostset_to_string(hostset_t *hs)
 static char *_task_ids_to_host_list(int ntasks, uint32_t *taskids,
 				    srun_job_t *my_srun_job)
 {
-	int i, task_cnt = 0;
+	int i, j;
+	hostlist_t *hl;
 	hostset_t *hs;
-	char *hosts;
+	bitstr_t *task_bitmap;
+	char *host, *hosts;
 	slurm_step_layout_t *sl;
 
 	if ((sl = launch_common_get_slurm_step_layout(my_srun_job)) == NULL)
 		return (xstrdup("Unknown"));
 
 	/*
-	 * If overhead of determining the hostlist is too high then srun
-	 * communications will timeout and fail, so return "Unknown" instead.
-	 *
-	 * See slurm_step_layout_host_id() in src/common/slurm_step_layout.c
-	 * for details.
+	 * Walk the layout once rather than searching it for every task, as
+	 * slurm_step_layout_host_name() would, so the cost stays linear in the
+	 * step's task count.
 	 */
-	for (i = 0; i < sl->node_cnt; i++) {
-		task_cnt += sl->tasks[i];
-	}
-	if (task_cnt > 100000)
-		return (xstrdup("Unknown"));
-
-	hs = hostset_create(NULL);
+	task_bitmap = bit_alloc(sl->task_cnt);
 	for (i = 0; i < ntasks; i++) {
-		char *host = slurm_step_layout_host_name(sl, taskids[i]);
-		if (host) {
-			hostset_insert(hs, host);
-			free(host);
-		} else {
+		if (taskids[i] < sl->task_cnt)
+			bit_set(task_bitmap, taskids[i]);
+		else
 			error("Could not identify host name for task %u",
 			      taskids[i]);
+	}
+
+	hl = hostlist_create(sl->node_list);
+	hs = hostset_create(NULL);
+	for (i = 0; (i < sl->node_cnt) && (host = hostlist_shift(hl)); i++) {
+		for (j = 0; j < sl->tasks[i]; j++) {
+			if (bit_test(task_bitmap, sl->tids[i][j])) {
+				hostset_insert(hs, host);
+				break;
+			}
 		}
+		free(host);
 	}
+	hostlist_destroy(hl);
+	FREE_NULL_BITMAP(task_bitmap);
 
 	hosts = _hostset_to_string(hs);
 	hostset_destroy(hs);
@@ -288,6 +293,7 @@ static void _task_start(launch_tasks_response_msg_t *msg)
 	uint32_t local_task_id, global_task_id;
 	int i;
 	task_state_t *task_state;
+	char *host_name = NULL;
 
 	if (msg->count_of_pids) {
 		verbose("Node %s, %d tasks started",
@@ -315,7 +321,11 @@ static void _task_start(launch_tasks_response_msg_t *msg)
 			continue;
 		}
 		table = &MPIR_proctable[global_task_id];
-		table->host_name = _mpir_get_host_name(msg->node_name);
+		/* all tasks of this node share one copy of the name */
+		if (!host_name)
+			host_name = mpir_add_name(
+				_mpir_get_host_name(msg->node_name));
+		table->host_name = host_name;
 		/* table->executable_name set in mpir_set_executable_names() */
 		table->pid = msg->local_pids[i];
 		if (!task_state) {
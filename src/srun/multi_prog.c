@@ -54,6 +54,7 @@
 #include <unistd.h>
 
 #include "src/common/bitstring.h"
+#include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
@@ -64,16 +65,33 @@
 #include "multi_prog.h"
 #include "opt.h"
 
+/*
+ * Strings referenced by MPIR_proctable entries. Host and executable names are
+ * shared by all the tasks using them instead of being copied per task.
+ */
+static list_t *mpir_names = NULL;
+
+extern char *mpir_add_name(char *name)
+{
+	xassert(mpir_names);
+	list_append(mpir_names, name);
+
+	return name;
+}
+
 static void
 _set_range(int low_num, int high_num, char *exec_name, bool ignore_duplicates)
 {
 	int i;
+	char *name = NULL;
 
 	for (i = low_num; i <= high_num; i++) {
 		MPIR_PROCDESC *tv;
 		tv = &MPIR_proctable[i];
 		if (tv->executable_name == NULL) {
-			tv->executable_name = xstrdup(exec_name);
+			if (!name)
+				name = mpir_add_name(xstrdup(exec_name));
+			tv->executable_name = name;
 		} else if (!ignore_duplicates) {
 			error("duplicate configuration for task %d ignored",
 			      i);
@@ -199,17 +217,14 @@ mpir_init(int num_tasks)
 		error("Unable to initialize MPIR_proctable: %m");
 		exit(error_exit);
 	}
+	if (!mpir_names)
+		mpir_names = list_create(xfree_ptr);
 }
 
 extern void
 mpir_cleanup(void)
 {
-	int i;
-
-	for (i = 0; i < MPIR_proctable_size; i++) {
-		xfree(MPIR_proctable[i].host_name);
-		xfree(MPIR_proctable[i].executable_name);
-	}
+	FREE_NULL_LIST(mpir_names);
 	xfree(MPIR_proctable);
 }
 
@@ -218,12 +233,13 @@ extern void mpir_set_executable_names(const char *executable_name,
 				      uint32_t task_count)
 {
 	int i;
+	char *name = mpir_add_name(xstrdup(executable_name));
 
 	if (task_offset == NO_VAL)
 		task_offset = 0;
 	xassert((task_offset + task_count) <= MPIR_proctable_size);
 	for (i = task_offset; i < (task_offset + task_count); i++) {
-		MPIR_proctable[i].executable_name = xstrdup(executable_name);
+		MPIR_proctable[i].executable_name = name;
 		// info("NAME[%d]:%s", i, executable_name);
 	}
 }
@@ -46,6 +46,12 @@
  * configuration file
  */
 extern void mpir_cleanup(void);
+
+/*
+ * Record a string that MPIR_proctable entries may share. Takes ownership of
+ * name, which is xfree()'d by mpir_cleanup(). Returns name.
+ */
+extern char *mpir_add_name(char *name);
 extern void mpir_dump_proctable(void);
 extern void mpir_init(int num_tasks);
 extern void mpir_set_executable_names(const char *executable_name,
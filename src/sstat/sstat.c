@@ -121,9 +121,15 @@ int _do_stat(slurm_step_id_t *step_id, char *nodelist,
 	char *ave_usage_tmp = NULL;
 
 	debug("requesting info for %ps", step_id);
-	if ((rc = slurm_job_step_stat(step_id,
-				      nodelist, use_protocol_ver,
-				      &step_stat_response)) != SLURM_SUCCESS) {
+	/* Per node records are only needed to print pids by node */
+	if (params.pid_format)
+		rc = slurm_job_step_stat(step_id, nodelist, use_protocol_ver,
+					 &step_stat_response);
+	else
+		rc = slurm_job_step_stat_reduced(step_id, nodelist,
+						 use_protocol_ver,
+						 &step_stat_response);
+	if (rc != SLURM_SUCCESS) {
 		if (rc == ESLURM_INVALID_JOB_ID) {
 			debug("%ps has already completed",
 			      step_id);
@@ -170,7 +176,8 @@ int _do_stat(slurm_step_id_t *step_id, char *nodelist,
 			print_fields(&step);
 			xfree(step.pid_str);
 		} else {
-			hostlist_push_host(hl, step_stat->step_pids->node_name);
+			/* reduced records carry a hostlist expression */
+			hostlist_push(hl, step_stat->step_pids->node_name);
 			ntasks += step_stat->num_tasks;
 			if (step_stat->jobacct) {
 				if (!assoc_mgr_tres_list &&
@@ -331,6 +331,112 @@ START_TEST(test_bit_ffs_from_bit)
 }
 END_TEST
 
+START_TEST(test_fused_overlap)
+{
+	int sizes[] = { 1, 63, 64, 65, 130, 1000 };
+
+	srand(7);
+	for (int s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++) {
+		int size = sizes[s], first = -1, count = 0;
+		bitstr_t *bs1 = bit_alloc(size);
+		bitstr_t *bs2 = bit_alloc(size);
+		bitstr_t *bs3 = bit_alloc(size);
+
+		/* Set bits past the end of the last word as well */
+		bit_not(bs3);
+		for (int i = 0; i < size; i++) {
+			if ((rand() % 4) == 0)
+				bit_set(bs1, i);
+			if (rand() & 1)
+				bit_set(bs2, i);
+			if (rand() & 1)
+				bit_clear(bs3, i);
+		}
+		for (int i = 0; i < size; i++) {
+			if (bit_test(bs1, i) && bit_test(bs2, i) &&
+			    (first == -1))
+				first = i;
+			if (bit_test(bs1, i) && bit_test(bs2, i) &&
+			    !bit_test(bs3, i))
+				count++;
+		}
+		ck_assert_int_eq(bit_overlap_ffs(bs1, bs2), first);
+		ck_assert_int_eq(bit_overlap_and_not(bs1, bs2, bs3), count);
+
+		bit_clear_all(bs1);
+		ck_assert_int_eq(bit_overlap_ffs(bs1, bs2), -1);
+		ck_assert_int_eq(bit_overlap_and_not(bs1, bs2, bs3), 0);
+		bit_set(bs1, size - 1);
+		bit_set(bs2, size - 1);
+		ck_assert_int_eq(bit_overlap_ffs(bs1, bs2), size - 1);
+
+		bit_free(bs1);
+		bit_free(bs2);
+		bit_free(bs3);
+	}
+}
+END_TEST
+
+START_TEST(test_word_kernels)
+{
+	/* Sizes around word and unrolled loop boundaries */
+	int sizes[] = { 1, 63, 64, 65, 255, 256, 257, 1000, 4097 };
+
+	srand(42);
+	for (int s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++) {
+		int size = sizes[s], count = 0, overlap = 0, range = 0;
+		bitstr_t *bs1 = bit_alloc(size);
+		bitstr_t *bs2 = bit_alloc(size);
+		bitstr_t *bs3;
+
+		for (int i = 0; i < size; i++) {
+			if (rand() & 1)
+				bit_set(bs1, i);
+			if (rand() & 1)
+				bit_set(bs2, i);
+		}
+		for (int i = 0; i < size; i++) {
+			if (bit_test(bs1, i))
+				count++;
+			if (bit_test(bs1, i) && bit_test(bs2, i))
+				overlap++;
+			if ((i >= (size / 3)) && bit_test(bs1, i))
+				range++;
+		}
+		ck_assert_int_eq(bit_set_count(bs1), count);
+		ck_assert_int_eq(bit_overlap(bs1, bs2), overlap);
+		ck_assert_int_eq(bit_overlap_any(bs1, bs2), (overlap > 0));
+		ck_assert_int_eq(bit_set_count_range(bs1, (size / 3), size),
+				 range);
+
+		bs3 = bit_copy(bs1);
+		bit_and(bs3, bs2);
+		for (int i = 0; i < size; i++)
+			ck_assert_int_eq(bit_test(bs3, i),
+					 (bit_test(bs1, i) && bit_test(bs2, i)));
+		bit_copybits(bs3, bs1);
+		bit_or(bs3, bs2);
+		for (int i = 0; i < size; i++)
+			ck_assert_int_eq(bit_test(bs3, i),
+					 (bit_test(bs1, i) || bit_test(bs2, i)));
+		bit_copybits(bs3, bs1);
+		bit_and_not(bs3, bs2);
+		for (int i = 0; i < size; i++)
+			ck_assert_int_eq(bit_test(bs3, i),
+					 (bit_test(bs1, i) && !bit_test(bs2, i)));
+		bit_copybits(bs3, bs1);
+		bit_or_not(bs3, bs2);
+		for (int i = 0; i < size; i++)
+			ck_assert_int_eq(bit_test(bs3, i),
+					 (bit_test(bs1, i) || !bit_test(bs2, i)));
+
+		bit_free(bs1);
+		bit_free(bs2);
+		bit_free(bs3);
+	}
+}
+END_TEST
+
 int main(void)
 {
 	int number_failed;
@@ -353,6 +459,8 @@ int main(void)
 	tcase_add_test(tc_core, test_bit_overlap);
 	tcase_add_test(tc_core, test_bit_set_count_range);
 	tcase_add_test(tc_core, test_bit_ffs_from_bit);
+	tcase_add_test(tc_core, test_word_kernels);
+	tcase_add_test(tc_core, test_fused_overlap);
 
 	suite_add_tcase(s, tc_core);
 
@@ -0,0 +1,400 @@
+/*****************************************************************************\
+ *  common-bench.c - microbenchmarks for commonly used library routines
+ *****************************************************************************
+ *  Copyright (C) SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Results are written to stdout as one JSON object per line so they can be
+ * collected and compared between builds:
+ *
+ *   {"name":"bit_set_count","size":100000,"iterations":1000,"usec":1234,
+ *    "ns_per_op":1234.0}
+ *
+ * The number of iterations of every benchmark is multiplied by the optional
+ * SLURM_BENCH_SCALE environment variable (default 1).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "slurm/slurm.h"
+
+#include "src/common/bitstring.h"
+#include "src/common/data.h"
+#include "src/common/hostlist.h"
+#include "src/common/log.h"
+#include "src/common/pack.h"
+#include "src/common/read_config.h"
+#include "src/common/timers.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/interfaces/serializer.h"
+
+#define BITMAP_SIZE 100000
+#define HOSTLIST_RANGES 10000
+#define PACK_RECORDS 100000
+#define DATA_ENTRIES 10000
+
+static int scale = 1;
+static volatile uint64_t sink = 0;
+
+static void _report(const char *name, int size, int iterations, long usec)
+{
+	printf("{\"name\":\"%s\",\"size\":%d,\"iterations\":%d,\"usec\":%ld,\"ns_per_op\":%.1f}\n",
+	       name, size, iterations, usec,
+	       ((double) usec * 1000) / (iterations ? iterations : 1));
+	fflush(stdout);
+}
+
+static void _bench_bitstring(void)
+{
+	DEF_TIMERS;
+	bitstr_t *b1 = bit_alloc(BITMAP_SIZE);
+	bitstr_t *b2 = bit_alloc(BITMAP_SIZE);
+	char *str;
+	int iterations = 1000 * scale;
+
+	/* every third node of b1, every other node of b2 */
+	for (int i = 0; i < BITMAP_SIZE; i += 3)
+		bit_set(b1, i);
+	for (int i = 0; i < BITMAP_SIZE; i += 2)
+		bit_set(b2, i);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++)
+		sink += bit_set_count(b1);
+	END_TIMER;
+	_report("bit_set_count", BITMAP_SIZE, iterations, DELTA_TIMER);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++)
+		sink += bit_overlap(b1, b2);
+	END_TIMER;
+	_report("bit_overlap", BITMAP_SIZE, iterations, DELTA_TIMER);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		bitstr_t *tmp = bit_copy(b1);
+		bit_and(tmp, b2);
+		bit_or(tmp, b1);
+		FREE_NULL_BITMAP(tmp);
+	}
+	END_TIMER;
+	_report("bit_copy_and_or", BITMAP_SIZE, iterations, DELTA_TIMER);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++)
+		sink += bit_ffs(b1) + bit_fls(b1);
+	END_TIMER;
+	_report("bit_ffs_fls", BITMAP_SIZE, iterations, DELTA_TIMER);
+
+	iterations = 10 * scale;
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		str = bit_fmt_full(b1);
+		sink += strlen(str);
+		xfree(str);
+	}
+	END_TIMER;
+	_report("bit_fmt_full", BITMAP_SIZE, iterations, DELTA_TIMER);
+
+	str = bit_fmt_full(b1);
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		bitstr_t *tmp = bit_alloc(BITMAP_SIZE);
+		bit_unfmt(tmp, str);
+		FREE_NULL_BITMAP(tmp);
+	}
+	END_TIMER;
+	_report("bit_unfmt", BITMAP_SIZE, iterations, DELTA_TIMER);
+	xfree(str);
+
+	FREE_NULL_BITMAP(b1);
+	FREE_NULL_BITMAP(b2);
+}
+
+static void _bench_hostlist(void)
+{
+	DEF_TIMERS;
+	hostlist_t *hl;
+	char *ranges = NULL, *pos = NULL, *str;
+	int iterations = 10 * scale;
+
+	/* node[0-1],node[3-4],... gives HOSTLIST_RANGES separate ranges */
+	for (int i = 0; i < HOSTLIST_RANGES; i++)
+		xstrfmtcatat(ranges, &pos, "%snode[%d-%d]", (i ? "," : ""),
+			     i * 3, (i * 3) + 1);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		hl = hostlist_create(ranges);
+		sink += hostlist_count(hl);
+		FREE_NULL_HOSTLIST(hl);
+	}
+	END_TIMER;
+	_report("hostlist_create", HOSTLIST_RANGES, iterations, DELTA_TIMER);
+
+	hl = hostlist_create(ranges);
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		str = hostlist_ranged_string_xmalloc(hl);
+		sink += strlen(str);
+		xfree(str);
+	}
+	END_TIMER;
+	_report("hostlist_ranged_string", HOSTLIST_RANGES, iterations,
+		DELTA_TIMER);
+
+	iterations = 1000 * scale;
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		char name[32];
+		snprintf(name, sizeof(name), "node%d",
+			 ((i * 7919) % HOSTLIST_RANGES) * 3);
+		sink += hostlist_find(hl, name);
+	}
+	END_TIMER;
+	_report("hostlist_find", HOSTLIST_RANGES, iterations, DELTA_TIMER);
+
+	iterations = 10 * scale;
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		hostlist_t *copy = hostlist_copy(hl);
+		hostlist_uniq(copy);
+		FREE_NULL_HOSTLIST(copy);
+	}
+	END_TIMER;
+	_report("hostlist_copy_uniq", HOSTLIST_RANGES, iterations, DELTA_TIMER);
+
+	FREE_NULL_HOSTLIST(hl);
+	xfree(ranges);
+}
+
+static void _bench_pack(void)
+{
+	DEF_TIMERS;
+	buf_t *buffer;
+	char *str = "compute-node-with-a-typical-name";
+	int iterations = 10 * scale;
+	uint32_t size = 0;
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		buffer = init_buf(BUF_SIZE);
+		for (int j = 0; j < PACK_RECORDS; j++) {
+			pack32(j, buffer);
+			pack64(j, buffer);
+			packstr(str, buffer);
+		}
+		size = get_buf_offset(buffer);
+		FREE_NULL_BUFFER(buffer);
+	}
+	END_TIMER;
+	_report("pack_records", PACK_RECORDS, iterations * PACK_RECORDS,
+		DELTA_TIMER);
+
+	buffer = init_buf(size);
+	for (int j = 0; j < PACK_RECORDS; j++) {
+		pack32(j, buffer);
+		pack64(j, buffer);
+		packstr(str, buffer);
+	}
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		set_buf_offset(buffer, 0);
+		for (int j = 0; j < PACK_RECORDS; j++) {
+			uint32_t u32, len;
+			uint64_t u64;
+			char *tmp = NULL;
+
+			if (unpack32(&u32, buffer) || unpack64(&u64, buffer) ||
+			    unpackstr_xmalloc(&tmp, &len, buffer))
+				fatal("%s: unpack failed", __func__);
+			sink += u32 + u64 + len;
+			xfree(tmp);
+		}
+	}
+	END_TIMER;
+	_report("unpack_records", PACK_RECORDS, iterations * PACK_RECORDS,
+		DELTA_TIMER);
+
+	FREE_NULL_BUFFER(buffer);
+}
+
+static data_t *_build_data_tree(void)
+{
+	data_t *d = data_set_list(data_new());
+
+	for (int i = 0; i < DATA_ENTRIES; i++) {
+		data_t *job = data_set_dict(data_list_append(d));
+
+		data_set_int(data_key_set(job, "job_id"), i);
+		data_set_string(data_key_set(job, "name"), "benchmark");
+		data_set_string_fmt(data_key_set(job, "nodes"), "node[%d-%d]",
+				    i, i + 16);
+		data_set_float(data_key_set(job, "priority"), i * 0.5);
+		data_set_bool(data_key_set(job, "requeue"), (i % 2));
+		data_set_list(data_key_set(job, "flags"));
+	}
+
+	return d;
+}
+
+static void _bench_data(bool have_json)
+{
+	DEF_TIMERS;
+	data_t *d;
+	char *json = NULL;
+	size_t len = 0;
+	int iterations = 10 * scale;
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		d = _build_data_tree();
+		FREE_NULL_DATA(d);
+	}
+	END_TIMER;
+	_report("data_tree_build", DATA_ENTRIES, iterations, DELTA_TIMER);
+
+	d = _build_data_tree();
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		data_t *copy = data_copy(NULL, d);
+		sink += data_check_match(d, copy, false);
+		FREE_NULL_DATA(copy);
+	}
+	END_TIMER;
+	_report("data_tree_copy_match", DATA_ENTRIES, iterations, DELTA_TIMER);
+
+	if (!have_json) {
+		FREE_NULL_DATA(d);
+		return;
+	}
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		xfree(json);
+		if (serialize_g_data_to_string(&json, &len, d, MIME_TYPE_JSON,
+					       SER_FLAGS_COMPACT))
+			fatal("%s: serialize_g_data_to_string() failed",
+			      __func__);
+	}
+	END_TIMER;
+	_report("json_serialize", DATA_ENTRIES, iterations, DELTA_TIMER);
+
+	START_TIMER;
+	for (int i = 0; i < iterations; i++) {
+		data_t *parsed = NULL;
+
+		if (serialize_g_string_to_data(&parsed, json, len,
+					       MIME_TYPE_JSON))
+			fatal("%s: serialize_g_string_to_data() failed",
+			      __func__);
+		FREE_NULL_DATA(parsed);
+	}
+	END_TIMER;
+	_report("json_parse", DATA_ENTRIES, iterations, DELTA_TIMER);
+
+	xfree(json);
+	FREE_NULL_DATA(d);
+}
+
+/*
+ * Load the JSON serializer with a mock slurm.conf, as done by
+ * serializer-test. Only possible once Slurm has been installed.
+ */
+static bool _load_json(void)
+{
+	int fd;
+	char *conf_file = xstrdup("slurm_bench.conf-XXXXXX");
+	const char conf[] =
+		"ClusterName=slurm_bench\n"
+		"PluginDir=" SLURM_PREFIX "/lib/slurm/\n"
+		"SlurmctldHost=slurm_bench\n";
+	bool rc = false;
+
+	/* slurm_conf_init() is fatal if PluginDir does not exist */
+	if (access(SLURM_PREFIX "/lib/slurm/", R_OK)) {
+		info("Slurm not installed, skipping json benchmarks");
+		xfree(conf_file);
+		return false;
+	}
+
+	if ((fd = mkstemp(conf_file)) < 0) {
+		error("error creating %s", conf_file);
+		xfree(conf_file);
+		return false;
+	}
+
+	if (write(fd, conf, sizeof(conf)) < sizeof(conf))
+		error("error writing %s", conf_file);
+	else if (slurm_conf_init(conf_file))
+		error("slurm_conf_init() failed");
+	else if (serializer_g_init(MIME_TYPE_JSON_PLUGIN, NULL))
+		info("JSON serializer not available, skipping json benchmarks");
+	else
+		rc = true;
+
+	unlink(conf_file);
+	xfree(conf_file);
+	close(fd);
+	return rc;
+}
+
+int main(int argc, char **argv)
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	char *scale_env = getenv("SLURM_BENCH_SCALE");
+	bool have_json;
+
+	if (scale_env && (atoi(scale_env) > 0))
+		scale = atoi(scale_env);
+
+	log_opts.stderr_level = LOG_LEVEL_INFO;
+	log_init("common-bench", log_opts, 0, NULL);
+
+	have_json = _load_json();
+
+	_bench_bitstring();
+	_bench_hostlist();
+	_bench_pack();
+	_bench_data(have_json);
+
+	if (have_json)
+		serializer_g_fini();
+	log_fini();
+	return EXIT_SUCCESS;
+}